@@ -662,6 +662,71 @@ bool dds_stream_write_keyBE (dds_ostreamBE_t *os, enum dds_cdr_key_serialization
 DDS_EXPORT bool dds_stream_extract_key_from_data (dds_istream_t *is, dds_ostream_t *os, const struct dds_cdrstream_allocator *allocator, const struct dds_cdrstream_desc *desc)
   ddsrt_attribute_warn_unused_result ddsrt_nonnull_all;
 
+/**
+ * @brief Value of a member read directly from serialized data
+ * @component cdr_serializer
+ *
+ * Integers, booleans, enums and bitmasks are in @p v.u, zero-extended, with the bit
+ * pattern of floating-point numbers. Strings refer to the serialized data and are
+ * not necessarily followed by a 0.
+ */
+struct dds_cdrstream_member_value {
+  bool present; /**< false if not in the data (the member then has its default value) */
+  union {
+    uint64_t u;
+    struct { const char *s; uint32_t len; } str;
+  } v;
+};
+
+/**
+ * @brief Looks up a member that can be read by @ref dds_stream_extract_members
+ * @component cdr_serializer
+ *
+ * Members are identified by their offset in the sample, including the offsets of any
+ * enclosing structs. Only primitive types, enums, bitmasks and strings that are not
+ * optional or external and not in a mutable type are supported.
+ *
+ * @param desc    CDR stream descriptor for the sample type
+ * @param offset  offset of the member in the sample
+ * @returns       the instruction of the member, NULL if not found or not supported
+ */
+DDS_EXPORT const uint32_t *dds_stream_find_member (const struct dds_cdrstream_desc *desc, uint32_t offset)
+  ddsrt_nonnull_all;
+
+/**
+ * @brief Locates a member given its position in each of the enclosing structs
+ * @component cdr_serializer
+ *
+ * Positions are in declaration order with the members of a base type counted first,
+ * which is the order in which they appear in the type object.
+ *
+ * @param desc     CDR stream descriptor for the sample type
+ * @param depth    number of entries in @p indices
+ * @param indices  position of the member in the top-level struct, followed by the
+ *                 positions in the struct-typed members leading to it
+ * @param offset   receives the offset of the member in the sample
+ * @returns the instruction for the member, or NULL under the same conditions as
+ *          @ref dds_stream_find_member
+ */
+DDS_EXPORT const uint32_t *dds_stream_find_member_by_index (const struct dds_cdrstream_desc *desc, uint32_t depth, const uint32_t *indices, uint32_t *offset)
+  ddsrt_nonnull_all;
+
+/**
+ * @brief Reads the values of some members from serialized sample data
+ * @component cdr_serializer
+ *
+ * Only the requested members are read, everything else is skipped without allocating
+ * memory. Stops once all members have been read.
+ *
+ * @param is       input stream containing normalized serialized sample data
+ * @param desc     CDR stream descriptor for the sample type
+ * @param n        number of members
+ * @param offsets  distinct member offsets, each accepted by @ref dds_stream_find_member
+ * @param values   receives the values of the members
+ */
+DDS_EXPORT void dds_stream_extract_members (dds_istream_t *is, const struct dds_cdrstream_desc *desc, uint32_t n, const uint32_t *offsets, struct dds_cdrstream_member_value *values)
+  ddsrt_nonnull_all;
+
 /**
  * @brief Convert serialized key data to another key serialization form.
  * @component cdr_serializer
@@ -7063,6 +7063,334 @@ static const uint32_t *dds_stream_extract_key_from_data_skip_adr (dds_istream_t
   return ops;
 }
 
+/*******************************************************************************************
+ **
+ **  Reading individual members directly from serialized data, for content filters.
+ **
+ *******************************************************************************************/
+
+static bool member_type_supported (uint32_t insn)
+{
+  if (op_type_optional (insn) || op_type_external (insn))
+    return false;
+  switch (DDS_OP_TYPE (insn))
+  {
+    case DDS_SOP_VAL_BLN: case DDS_SOP_VAL_1BY: case DDS_SOP_VAL_2BY: case DDS_SOP_VAL_4BY: case DDS_SOP_VAL_8BY:
+    case DDS_SOP_VAL_ENU: case DDS_SOP_VAL_BMK: case DDS_SOP_VAL_STR: case DDS_SOP_VAL_BST:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static const uint32_t *dds_stream_find_member_impl (const uint32_t *ops, uint32_t base, uint32_t offset)
+{
+  uint32_t insn;
+  if (DDS_OP (*ops) == DDS_OP_DLC)
+    ops++;
+  else if (DDS_OP (*ops) == DDS_OP_PLC)
+    return NULL; /* members of mutable types may be anywhere in the data */
+  while ((insn = *ops) != DDS_OP_RTS)
+  {
+    switch (DDS_OP (insn))
+    {
+      case DDS_OP_ADR:
+        if (DDS_OP_TYPE (insn) != DDS_SOP_VAL_EXT)
+        {
+          if (base + ops[1] == offset)
+            return member_type_supported (insn) ? ops : NULL;
+          ops = dds_stream_skip_adr_insns (insn, ops);
+        }
+        else
+        {
+          const uint32_t jmp = DDS_OP_ADR_JMP (ops[2]);
+          if (!op_type_optional (insn) && !op_type_external (insn))
+          {
+            const uint32_t *m = dds_stream_find_member_impl (ops + DDS_OP_ADR_JSR (ops[2]), base + ops[1], offset);
+            if (m != NULL)
+              return m;
+          }
+          ops += jmp ? jmp : 3;
+        }
+        break;
+      case DDS_OP_JSR: {
+        const uint32_t *m = dds_stream_find_member_impl (ops + DDS_OP_JUMP (insn), base, offset);
+        if (m != NULL)
+          return m;
+        ops++;
+        break;
+      }
+      default:
+        return NULL;
+    }
+  }
+  return NULL;
+}
+
+const uint32_t *dds_stream_find_member (const struct dds_cdrstream_desc *desc, uint32_t offset)
+{
+  return dds_stream_find_member_impl (desc->ops.ops, 0, offset);
+}
+
+/* Locates the member at position *index in the struct, counting the members of the base
+   type first; *index is decremented for each member skipped */
+static const uint32_t *dds_stream_find_member_by_index_impl (const uint32_t *ops, uint32_t base, uint32_t *index, uint32_t *offset)
+{
+  uint32_t insn;
+  if (DDS_OP (*ops) == DDS_OP_DLC)
+    ops++;
+  else if (DDS_OP (*ops) == DDS_OP_PLC)
+    return NULL;
+  while ((insn = *ops) != DDS_OP_RTS)
+  {
+    switch (DDS_OP (insn))
+    {
+      case DDS_OP_ADR:
+        if (DDS_OP_TYPE (insn) == DDS_SOP_VAL_EXT && (DDS_OP_FLAGS (insn) & DDS_OP_FLAG_BASE))
+        {
+          const uint32_t *m = dds_stream_find_member_by_index_impl (ops + DDS_OP_ADR_JSR (ops[2]), base + ops[1], index, offset);
+          if (m != NULL)
+            return m;
+        }
+        else if (*index == 0)
+        {
+          *offset = base + ops[1];
+          return ops;
+        }
+        else
+        {
+          (*index)--;
+        }
+        if (DDS_OP_TYPE (insn) != DDS_SOP_VAL_EXT)
+          ops = dds_stream_skip_adr_insns (insn, ops);
+        else
+        {
+          const uint32_t jmp = DDS_OP_ADR_JMP (ops[2]);
+          ops += jmp ? jmp : 3;
+        }
+        break;
+      case DDS_OP_JSR: {
+        const uint32_t *m = dds_stream_find_member_by_index_impl (ops + DDS_OP_JUMP (insn), base, index, offset);
+        if (m != NULL)
+          return m;
+        ops++;
+        break;
+      }
+      default:
+        return NULL;
+    }
+  }
+  return NULL;
+}
+
+const uint32_t *dds_stream_find_member_by_index (const struct dds_cdrstream_desc *desc, uint32_t depth, const uint32_t *indices, uint32_t *offset)
+{
+  const uint32_t *ops = desc->ops.ops;
+  uint32_t base = 0;
+  for (uint32_t d = 0; d < depth; d++)
+  {
+    uint32_t index = indices[d], moff;
+    const uint32_t *m = dds_stream_find_member_by_index_impl (ops, base, &index, &moff);
+    if (m == NULL)
+      return NULL;
+    if (d + 1 == depth)
+    {
+      *offset = moff;
+      return member_type_supported (*m) ? m : NULL;
+    }
+    if (DDS_OP_TYPE (*m) != DDS_SOP_VAL_EXT || op_type_optional (*m) || op_type_external (*m))
+      return NULL;
+    ops = m + DDS_OP_ADR_JSR (m[2]);
+    base = moff;
+  }
+  return NULL;
+}
+
+struct extract_members {
+  uint32_t n;
+  const uint32_t *offsets;
+  struct dds_cdrstream_member_value *values;
+  uint32_t remaining;
+};
+
+/* base = UINT32_MAX means none of the members encountered can be one of those requested */
+#define EXTRACT_MEMBERS_NO_MATCH UINT32_MAX
+
+static const uint32_t *dds_stream_extract_members_impl (dds_istream_t *is, const uint32_t *ops, uint32_t base, struct extract_members *em);
+
+static void dds_stream_extract_member_value (dds_istream_t *is, const uint32_t *ops, struct dds_cdrstream_member_value *value)
+{
+  const uint32_t insn = *ops;
+  value->present = true;
+  switch (DDS_OP_TYPE (insn))
+  {
+    case DDS_SOP_VAL_BLN: case DDS_SOP_VAL_1BY: value->v.u = dds_is_get1 (is); break;
+    case DDS_SOP_VAL_2BY: value->v.u = dds_is_get2 (is); break;
+    case DDS_SOP_VAL_4BY: value->v.u = dds_is_get4 (is); break;
+    case DDS_SOP_VAL_8BY: value->v.u = dds_is_get8 (is); break;
+    case DDS_SOP_VAL_ENU:
+      switch (DDS_OP_TYPE_SZ (insn))
+      {
+        case 1: value->v.u = dds_stream_enum_value_from_image (ops, dds_is_get1 (is)); break;
+        case 2: value->v.u = dds_stream_enum_value_from_image (ops, dds_is_get2 (is)); break;
+        default: value->v.u = dds_is_get4 (is); break;
+      }
+      break;
+    case DDS_SOP_VAL_BMK:
+      switch (DDS_OP_TYPE_SZ (insn))
+      {
+        case 1: value->v.u = dds_is_get1 (is); break;
+        case 2: value->v.u = dds_is_get2 (is); break;
+        case 4: value->v.u = dds_is_get4 (is); break;
+        default: value->v.u = dds_is_get8 (is); break;
+      }
+      break;
+    case DDS_SOP_VAL_STR: case DDS_SOP_VAL_BST: {
+      /* normalized data: length includes the terminating 0 and is at least 1 */
+      const uint32_t len = dds_is_get4 (is);
+      value->v.str.s = (const char *) is->m_buffer + is->m_index;
+      value->v.str.len = len - 1;
+      is->m_index += len;
+      break;
+    }
+    default:
+      abort (); /* rejected by dds_stream_find_member */
+      break;
+  }
+}
+
+static const uint32_t *dds_stream_extract_members_adr (uint32_t insn, dds_istream_t *is, const uint32_t *ops, uint32_t base, struct extract_members *em)
+{
+  const enum dds_stream_typecode type = DDS_OP_TYPE (insn);
+  uint32_t param_len = 0;
+  dds_istream_t is1 = *is;
+  if (op_type_optional (insn))
+  {
+    /* same as for key extraction: none of the requested members can be inside it */
+    if (!stream_is_member_present (&is1, &param_len) || is->m_xcdr_version == DDSI_RTPS_CDR_ENC_VERSION_1)
+    {
+      is->m_index = is1.m_index + param_len;
+      return dds_stream_skip_adr_insns (insn, ops);
+    }
+    base = EXTRACT_MEMBERS_NO_MATCH;
+  }
+  else if (op_type_external (insn))
+  {
+    base = EXTRACT_MEMBERS_NO_MATCH;
+  }
+
+  if (type == DDS_SOP_VAL_EXT)
+  {
+    const uint32_t *jsr_ops = ops + DDS_OP_ADR_JSR (ops[2]);
+    const uint32_t jmp = DDS_OP_ADR_JMP (ops[2]);
+    if (op_type_base (insn) && jsr_ops[0] == DDS_OP_DLC)
+      jsr_ops++;
+    (void) dds_stream_extract_members_impl (&is1, jsr_ops, base == EXTRACT_MEMBERS_NO_MATCH ? base : base + ops[1], em);
+    ops += jmp ? jmp : 3;
+  }
+  else
+  {
+    uint32_t i = 0;
+    if (base != EXTRACT_MEMBERS_NO_MATCH)
+    {
+      const uint32_t offset = base + ops[1];
+      while (i < em->n && em->offsets[i] != offset)
+        i++;
+    }
+    if (i < em->n && base != EXTRACT_MEMBERS_NO_MATCH)
+    {
+      dds_stream_extract_member_value (&is1, ops, &em->values[i]);
+      em->remaining--;
+      ops = dds_stream_skip_adr_insns (insn, ops);
+    }
+    else
+    {
+      ops = dds_stream_extract_key_from_data_skip_adr (&is1, ops, type, false);
+    }
+  }
+  is->m_index = is1.m_index;
+  return ops;
+}
+
+static const uint32_t *dds_stream_extract_members_delimited (dds_istream_t *is, const uint32_t *ops, uint32_t base, struct extract_members *em)
+{
+  uint32_t delimited_offs = is->m_index, insn, delimited_sz = is->m_size - is->m_index;
+  ops++; // skip DLC op
+  while ((insn = *ops) != DDS_OP_RTS && em->remaining > 0)
+  {
+    switch (DDS_OP (insn))
+    {
+      case DDS_SOP_ADR:
+        /* members not in the data keep their default value */
+        if (is->m_index - delimited_offs < delimited_sz)
+          ops = dds_stream_extract_members_adr (insn, is, ops, base, em);
+        else
+          ops = dds_stream_skip_adr_insns (insn, ops);
+        break;
+      case DDS_SOP_JSR:
+        (void) dds_stream_extract_members_impl (is, ops + DDS_OP_JUMP (insn), base, em);
+        ops++;
+        break;
+      case DDS_SOP_RTS: case DDS_SOP_JEQ: case DDS_SOP_JEQ4: case DDS_SOP_KOF: case DDS_SOP_DLC: case DDS_SOP_PLC: case DDS_SOP_PLM: case DDS_SOP_MID:
+        abort ();
+        break;
+    }
+  }
+  return ops;
+}
+
+static const uint32_t *dds_stream_extract_members_impl (dds_istream_t *is, const uint32_t *ops, uint32_t base, struct extract_members *em)
+{
+  uint32_t insn;
+  while ((insn = *ops) != DDS_OP_RTS && em->remaining > 0)
+  {
+    switch (DDS_OP (insn))
+    {
+      case DDS_SOP_ADR:
+        ops = dds_stream_extract_members_adr (insn, is, ops, base, em);
+        break;
+      case DDS_SOP_JSR:
+        (void) dds_stream_extract_members_impl (is, ops + DDS_OP_JUMP (insn), base, em);
+        ops++;
+        break;
+      case DDS_SOP_RTS: case DDS_SOP_JEQ: case DDS_SOP_JEQ4: case DDS_SOP_KOF: case DDS_SOP_PLM: case DDS_SOP_MID:
+        abort ();
+        break;
+      case DDS_SOP_DLC: {
+        dds_istream_t is1 = *is;
+        if (is->m_xcdr_version == DDSI_RTPS_CDR_ENC_VERSION_2)
+        {
+          uint32_t delimited_sz = dds_is_get4 (is);
+          is1.m_size = is->m_index + delimited_sz;
+          is1.m_index = is->m_index;
+          is->m_index += delimited_sz;
+        }
+        ops = dds_stream_extract_members_delimited (&is1, ops, base, em);
+        if (is->m_xcdr_version == DDSI_RTPS_CDR_ENC_VERSION_1)
+          is->m_index = is1.m_index;
+        break;
+      }
+      case DDS_SOP_PLC:
+        ops = dds_stream_extract_key_from_data_skip_plc (is, ops + 1);
+        break;
+    }
+  }
+  return ops;
+}
+
+void dds_stream_extract_members (dds_istream_t *is, const struct dds_cdrstream_desc *desc, uint32_t n, const uint32_t *offsets, struct dds_cdrstream_member_value *values)
+{
+  struct extract_members em = { .n = n, .offsets = offsets, .values = values, .remaining = n };
+  for (uint32_t i = 0; i < n; i++)
+  {
+    values[i].present = false;
+    memset (&values[i].v, 0, sizeof (values[i].v));
+  }
+  (void) dds_stream_extract_members_impl (is, desc->ops.ops, 0, &em);
+}
+
+#undef EXTRACT_MEMBERS_NO_MATCH
+
 /*******************************************************************************************
  **
  **  Read/write of samples and keys -- i.e., DDSI payloads.
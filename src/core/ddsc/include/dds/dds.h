@@ -1645,6 +1645,8 @@ enum dds_topic_filter_mode {
   DDS_TOPIC_FILTER_SAMPLE_ARG,            /**< Use with \ref dds_topic_filter_sample_arg_fn */
   DDS_TOPIC_FILTER_SAMPLEINFO_ARG,        /**< Use with \ref dds_topic_filter_sampleinfo_arg_fn */
   DDS_TOPIC_FILTER_SAMPLE_SAMPLEINFO_ARG, /**< Use with \ref dds_topic_filter_sample_sampleinfo_arg_fn */
+  DDS_TOPIC_FILTER_MEMBERS,               /**< Set using \ref dds_set_topic_filter_members */
+  DDS_TOPIC_FILTER_EXPRESSION,            /**< Set using \ref dds_set_topic_filter_expression */
 };
 
 /**
@@ -1765,6 +1767,130 @@ dds_get_topic_filter_extended (
   dds_entity_t topic,
   struct dds_topic_filter *filter);
 
+/**
+ * @brief Comparison operator of a member predicate
+ * @ingroup topic_filter
+ * @warning Unstable API
+ */
+enum dds_topic_filter_member_op {
+  DDS_TOPIC_FILTER_MEMBER_EQ, /**< member equal to value */
+  DDS_TOPIC_FILTER_MEMBER_NE, /**< member not equal to value */
+  DDS_TOPIC_FILTER_MEMBER_LT, /**< member less than value */
+  DDS_TOPIC_FILTER_MEMBER_LE, /**< member less than or equal to value */
+  DDS_TOPIC_FILTER_MEMBER_GT, /**< member greater than value */
+  DDS_TOPIC_FILTER_MEMBER_GE  /**< member greater than or equal to value */
+};
+
+/**
+ * @brief Predicate on a single member of a sample
+ * @ingroup topic_filter
+ * @warning Unstable API
+ *
+ * The member is identified by its offset in the sample type, e.g., `offsetof (T, a.b)`
+ * for member `b` of the struct-typed member `a` of `T`. The member must be an integer,
+ * a floating-point number, a boolean, a character, an enum, a bitmask or a string, and
+ * may not be optional, external or in a mutable type. The value field to use follows
+ * from the type of the member.
+ */
+typedef struct dds_topic_filter_member_predicate {
+  uint32_t offset;                     /**< Offset of the member in the sample */
+  enum dds_topic_filter_member_op op;  /**< Comparison operator */
+  union {
+    int64_t i;                         /**< Signed integers */
+    uint64_t u;                        /**< Unsigned integers, booleans, characters, enums and bitmasks */
+    double d;                          /**< Floating-point numbers */
+    const char *s;                     /**< Strings, compared byte-wise */
+  } value;                             /**< Value to compare the member with */
+} dds_topic_filter_member_predicate_t;
+
+/**
+ * @brief Maximum number of predicates in a member filter
+ * @ingroup topic_filter
+ */
+#define DDS_TOPIC_FILTER_MEMBERS_MAX 32
+
+/**
+ * @brief Sets a filter on a topic that accepts samples for which all member predicates hold
+ * @ingroup topic_filter
+ * @component topic
+ * @warning Unstable API
+ *
+ * The predicates are evaluated on the serialized data, reading only the members they
+ * refer to. This avoids deserializing samples that are rejected by the filter, and
+ * is therefore much cheaper than a filter function for large types. It is only
+ * available for topics using the default (IDL compiler generated) type support.
+ *
+ * The same thread-safety restrictions apply as for @ref dds_set_topic_filter_extended.
+ *
+ * @param[in]  topic        The topic on which the content filter is set.
+ * @param[in]  npredicates  Number of predicates, 0 to remove the filter.
+ * @param[in]  predicates   The predicates, all of which must hold for a sample to be accepted.
+ *
+ * @returns A dds_return_t indicating success or failure.
+ *
+ * @retval DDS_RETCODE_OK  Filter set successfully
+ * @retval DDS_RETCODE_BAD_PARAMETER  The topic handle is invalid, there are more than
+ *             DDS_TOPIC_FILTER_MEMBERS_MAX predicates or a predicate is invalid
+ * @retval DDS_RETCODE_UNSUPPORTED  The topic doesn't use the default type support or a
+ *             predicate refers to a member that can't be used in a member filter
+ */
+DDS_EXPORT dds_return_t
+dds_set_topic_filter_members (
+  dds_entity_t topic,
+  uint32_t npredicates,
+  const dds_topic_filter_member_predicate_t *predicates);
+
+/**
+ * @brief Sets a filter on a topic using an SQL-like filter expression
+ * @ingroup topic_filter
+ * @component topic
+ * @warning Unstable API
+ *
+ * The expression is evaluated in the same way as a filter set using @ref
+ * dds_set_topic_filter_members. In addition, readers created for the topic after
+ * setting the filter advertise the expression in discovery. Writers in other
+ * processes that understand it then stop sending samples that none of their
+ * remote readers accept, saving network bandwidth.
+ *
+ * The expression language is the subset of the DDS content filter grammar that
+ * consists of:
+ * - comparisons `=`, `<>` (or `!=`), `<`, `<=`, `>` and `>=` between a member and a
+ *   literal or a parameter, in either order;
+ * - `member BETWEEN x AND y` and `member NOT BETWEEN x AND y`;
+ * - combinations of these using `AND`, `OR`, `NOT` and parentheses.
+ *
+ * Members are referenced by name, with `.` separating the names of nested members,
+ * and are subject to the same restrictions as in a member filter. Literals are
+ * integers (decimal or hexadecimal), floating-point numbers, `TRUE`, `FALSE` and
+ * strings enclosed in single quotes. A string of one character may be compared with
+ * a character member and enums compare as integers. A parameter `%n` is replaced by
+ * `params[n]`, which is interpreted as a literal, or as a string if it is not a
+ * single literal. At most DDS_TOPIC_FILTER_MEMBERS_MAX comparisons are allowed,
+ * where `BETWEEN` counts as two.
+ *
+ * The same thread-safety restrictions apply as for @ref dds_set_topic_filter_extended.
+ *
+ * @param[in]  topic       The topic on which the content filter is set.
+ * @param[in]  expression  The filter expression, a null pointer to remove the filter.
+ * @param[in]  nparams     Number of parameters.
+ * @param[in]  params      The parameters.
+ *
+ * @returns A dds_return_t indicating success or failure.
+ *
+ * @retval DDS_RETCODE_OK  Filter set successfully
+ * @retval DDS_RETCODE_BAD_PARAMETER  The topic handle is invalid, the expression is
+ *             invalid or refers to a member that does not exist
+ * @retval DDS_RETCODE_UNSUPPORTED  The topic doesn't use the default type support, no
+ *             type information is available or the expression refers to a member that
+ *             can't be used in a filter
+ */
+DDS_EXPORT dds_return_t
+dds_set_topic_filter_expression (
+  dds_entity_t topic,
+  const char *expression,
+  uint32_t nparams,
+  const char * const *params);
+
 /**
  * @defgroup subscriber (Subscriber)
  * @ingroup subscription
@@ -24,7 +24,45 @@ struct ddsi_domaingv;
 /** @component rhc */
 struct dds_rhc *dds_rhc_default_new_xchecks (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos, bool xchecks);
 
-/** @component rhc */
+/**
+ * @component rhc
+ * @brief Constructs a reader history cache with the instances spread over independently locked shards
+ *
+ * Requires unlimited max_samples and max_instances in the resource limits QoS.
+ *
+ * @param[in] gv  domain globals
+ * @param[in] type  sertype of the reader
+ * @param[in] qos  reader QoS
+ * @param[in] nshards  number of shards, > 0
+ * @param[in] xchecks  whether to do expensive consistency checks
+ * @returns the new reader history cache
+ */
+struct dds_rhc *dds_rhc_sharded_new_xchecks (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos, uint32_t nshards, bool xchecks);
+
+/**
+ * @component rhc
+ * @brief Constructs a reader history cache for an unkeyed topic and KEEP_LAST 1 history
+ *
+ * Keeps the sample in an atomic slot as long as the instance is alive and there are no
+ * read conditions, so that taking it doesn't require locking.
+ *
+ * @param[in] gv  domain globals
+ * @param[in] type  sertype of the reader, without key fields
+ * @param[in] qos  reader QoS, with KEEP_LAST 1 history
+ * @param[in] xchecks  whether to do expensive consistency checks
+ * @returns the new reader history cache
+ */
+struct dds_rhc *dds_rhc_latest_new_xchecks (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos, bool xchecks);
+
+/**
+ * @component rhc
+ * @brief Constructs the reader history cache for a reader
+ *
+ * This is a sharded one if Internal/ReaderHistoryShards > 1, the topic is keyed and the
+ * resource limits allow it; a "latest sample" one if the topic is unkeyed with KEEP_LAST 1
+ * history, shared ownership, reception order and no time-based filter or deadline; else
+ * an ordinary one.
+ */
 struct dds_rhc *dds_rhc_default_new (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos);
 
 #ifdef DDS_HAS_LIFESPAN
@@ -77,6 +77,8 @@ struct dds_serdatapool {
   DDS_SERDATA_DEFAULT_DEBUG_FIELDS    \
   struct dds_serdata_default_key key; \
   struct dds_serdatapool *serpool;    \
+  struct ddsi_rmsg *rmsg;             \
+  uint32_t rmsg_off;                  \
   struct dds_serdata_default *next /* in pool->freelist */
 /* We suppress the zero-array warning (MSVC C4200) here ONLY for MSVC
    and ONLY if it is being compiled as C++ code, as it only causes
@@ -140,6 +142,26 @@ extern const struct ddsi_serdata_ops dds_serdata_ops_cdr_nokey;
 extern const struct ddsi_serdata_ops dds_serdata_ops_xcdr2;
 extern const struct ddsi_serdata_ops dds_serdata_ops_xcdr2_nokey;
 
+/**
+ * @component typesupport_c
+ * @brief Reads members directly from the serialized data of a sample
+ *
+ * @returns false if the data isn't available in serialized form
+ * @see dds_stream_extract_members
+ */
+bool dds_serdata_default_extract_members (const struct ddsi_serdata *serdata, uint32_t n, const uint32_t *offsets, struct dds_cdrstream_member_value *values);
+
+/**
+ * @component typesupport_c
+ * @brief Constructs a serdata from serialized data in native byte order that is known to be well-formed
+ *
+ * Skips the normalization `ddsi_serdata_from_ser_iov` does, so it may only be used for data that
+ * this process serialized itself.
+ *
+ * @returns the serdata, or NULL if the CDR header is invalid or not in native byte order
+ */
+struct ddsi_serdata *dds_serdata_default_from_ser_well_formed (const struct ddsi_sertype *tpcmn, enum ddsi_serdata_kind kind, const void *cdr, size_t size);
+
 /** @component typesupport_c */
 struct dds_serdatapool * dds_serdatapool_new (void);
 
@@ -0,0 +1,90 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#ifndef DDS__TOPIC_FILTER_H
+#define DDS__TOPIC_FILTER_H
+
+#include "dds/dds.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+struct ddsi_sertype;
+struct ddsi_serdata;
+struct dds_topic_member_filter;
+struct ddsi_content_filter_interface;
+
+/**
+ * @component topic
+ * @brief Compiles member predicates against the type of a topic
+ *
+ * @param[out] filter  the compiled filter
+ * @param[in] type  sertype of the topic
+ * @param[in] npredicates  number of predicates, > 0
+ * @param[in] predicates  the predicates
+ * @returns a dds_return_t indicating success or failure
+ */
+dds_return_t dds_topic_member_filter_new (struct dds_topic_member_filter **filter, const struct ddsi_sertype *type, uint32_t npredicates, const dds_topic_filter_member_predicate_t *predicates)
+  ddsrt_nonnull_all;
+
+/**
+ * @component topic
+ * @brief Compiles a filter expression against the type of a topic
+ *
+ * See @ref dds_set_topic_filter_expression for the supported expressions.
+ *
+ * @param[out] filter  the compiled filter
+ * @param[in] type  sertype of the topic
+ * @param[in] expression  the filter expression
+ * @param[in] nparams  number of parameters
+ * @param[in] params  the parameters, may be a null pointer if nparams = 0
+ * @returns a dds_return_t indicating success or failure
+ */
+dds_return_t dds_topic_expression_filter_new (struct dds_topic_member_filter **filter, const struct ddsi_sertype *type, const char *expression, uint32_t nparams, const char * const *params)
+  ddsrt_nonnull ((1, 2, 3));
+
+/** @component topic */
+void dds_topic_member_filter_free (struct dds_topic_member_filter *filter)
+  ddsrt_nonnull_all;
+
+/**
+ * @component topic
+ * @brief Evaluates a member filter on a sample
+ *
+ * Reads the members directly from the serialized data if possible, and otherwise
+ * deserializes the sample.
+ *
+ * @param[in] filter  the filter
+ * @param[in] serdata  the sample, containing data
+ * @returns whether all predicates hold
+ */
+bool dds_topic_member_filter_accepts (const struct dds_topic_member_filter *filter, const struct ddsi_serdata *serdata)
+  ddsrt_nonnull_all;
+
+/**
+ * @component topic
+ * @brief Evaluates a member filter on a sample in its in-memory representation
+ *
+ * @param[in] filter  the filter
+ * @param[in] sample  the sample
+ * @returns whether all predicates hold
+ */
+bool dds_topic_member_filter_accepts_sample (const struct dds_topic_member_filter *filter, const void *sample)
+  ddsrt_nonnull_all;
+
+/** @brief Evaluates the filter expressions of remote readers using member filters */
+extern const struct ddsi_content_filter_interface dds_content_filter_interface;
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* DDS__TOPIC_FILTER_H */
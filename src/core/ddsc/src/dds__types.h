@@ -439,6 +439,8 @@ typedef struct dds_topic {
   struct ddsi_sertype *m_stype;
   struct dds_ktopic *m_ktopic; /* refc'd, constant */
   struct dds_topic_filter m_filter;
+  struct dds_topic_member_filter *m_member_filter; /* iff m_filter.mode is DDS_TOPIC_FILTER_MEMBERS or DDS_TOPIC_FILTER_EXPRESSION */
+  struct ddsi_content_filter_property *m_content_filter; /* iff m_filter.mode == DDS_TOPIC_FILTER_EXPRESSION */
   dds_inconsistent_topic_status_t m_inconsistent_topic_status; /* Status metrics */
 } dds_topic;
 
@@ -0,0 +1,41 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#ifndef DDS__WHC_RING_H
+#define DDS__WHC_RING_H
+
+#include "dds/ddsi/ddsi_whc.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+struct ddsi_domaingv;
+
+/**
+ * @component whc
+ * @brief Creates a WHC for a keyless, volatile KEEP_LAST writer
+ *
+ * Stores the most recent @p depth samples in a ring ordered on sequence number,
+ * avoiding the hash tables, interval tree and instance index of the general WHC.
+ * Only valid for writers without deadline and lifespan.
+ *
+ * @param[in] gv  domain globals
+ * @param[in] depth  history depth, must be > 0
+ * @param[in] sample_overhead  estimated per-fragment overhead for computing unacked bytes
+ * @returns the new WHC
+ */
+struct ddsi_whc *dds_whc_ring_new (struct ddsi_domaingv *gv, uint32_t depth, size_t sample_overhead);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* DDS__WHC_RING_H */
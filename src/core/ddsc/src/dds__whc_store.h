@@ -0,0 +1,66 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#ifndef DDS__WHC_STORE_H
+#define DDS__WHC_STORE_H
+
+#include "dds/ddsi/ddsi_whc.h"
+#include "dds/ddsrt/retcode.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+struct ddsi_domaingv;
+struct ddsi_sertype;
+struct dds_writer;
+
+/** @brief Callback for re-publishing a sample loaded from the store, consumes a reference to @p serdata */
+typedef dds_return_t (*dds_whc_store_replay_fn_t) (void *arg, struct ddsi_serdata *serdata);
+
+/**
+ * @component whc
+ * @brief Creates a WHC that keeps the transient-local history in a file
+ *
+ * The transient-local history of @p wr is kept in a memory-mapped file in the
+ * configured TransientLocalStoreDirectory, unacknowledged samples are kept in
+ * @p inner, a volatile WHC. The file is named after the topic and is claimed for
+ * exclusive use by this writer. Samples that were stored in the file by a
+ * previous incarnation are loaded and must be re-published using @ref
+ * dds_whc_store_replay once the writer exists.
+ *
+ * @param[in] gv  domain globals
+ * @param[in] wr  writer for which the WHC is created
+ * @param[in] tldepth  transient-local history depth, 0 for KEEP_ALL
+ * @param[in] inner  volatile WHC for the writer, ownership transfers if successful
+ * @returns the new WHC, or NULL if the file can't be used
+ */
+struct ddsi_whc *dds_whc_store_new (struct ddsi_domaingv *gv, const struct dds_writer *wr, uint32_t tldepth, struct ddsi_whc *inner);
+
+/**
+ * @component whc
+ * @brief Re-publishes the samples loaded from the store when it was created
+ *
+ * Each sample is handed to @p fn in the original order and marked obsolete in the file
+ * once it has been re-published (and thereby stored again). Does nothing if @p whc is
+ * not a WHC created by @ref dds_whc_store_new.
+ *
+ * @param[in] whc  WHC of the writer
+ * @param[in] type  sertype of the writer
+ * @param[in] fn  function for re-publishing a sample
+ * @param[in] arg  argument passed to @p fn
+ */
+void dds_whc_store_replay (struct ddsi_whc *whc, const struct ddsi_sertype *type, dds_whc_store_replay_fn_t fn, void *arg);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* DDS__WHC_STORE_H */
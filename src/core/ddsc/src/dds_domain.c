@@ -31,6 +31,7 @@
 #include "dds__entity.h"
 #include "dds__serdata_default.h"
 #include "dds__psmx.h"
+#include "dds__topic_filter.h"
 
 static dds_return_t dds_domain_free (dds_entity *vdomain);
 
@@ -151,6 +152,7 @@ static dds_entity_t dds_domain_init (dds_domain *domain, dds_domainid_t domain_i
   }
 
   domain->serpool = dds_serdatapool_new ();
+  domain->gv.content_filter_interface = &dds_content_filter_interface;
 
   /* Start monitoring the liveliness of threads if this is the first
      domain to configured to do so. */
@@ -26,6 +26,7 @@
 #include "dds/ddsi/ddsi_statistics.h"
 #include "dds/ddsi/ddsi_endpoint_match.h"
 #include "dds/ddsi/ddsi_tkmap.h"
+#include "dds/ddsi/ddsi_content_filter.h"
 #include "dds/ddsc/dds_rhc.h"
 #include "dds/ddsc/dds_internal_api.h"
 #include "dds__participant.h"
@@ -446,7 +447,11 @@ void dds_reader_invoke_cbs_for_pending_events(struct dds_entity *e, uint32_t sta
 }
 
 static const struct dds_stat_keyvalue_descriptor dds_reader_statistics_kv[] = {
-  { "discarded_bytes", DDS_STAT_KIND_UINT64 }
+  { "discarded_bytes", DDS_STAT_KIND_UINT64 },
+  { "rx_latency_samples", DDS_STAT_KIND_UINT64 },
+  { "rx_latency_kernel_to_recv", DDS_STAT_KIND_UINT64 },
+  { "rx_latency_recv_to_deliver", DDS_STAT_KIND_UINT64 },
+  { "rx_latency_deliver_to_store", DDS_STAT_KIND_UINT64 }
 };
 
 static const struct dds_stat_descriptor dds_reader_statistics_desc = {
@@ -463,7 +468,10 @@ static void dds_reader_refresh_statistics (const struct dds_entity *entity, stru
 {
   const struct dds_reader *rd = (const struct dds_reader *) entity;
   if (rd->m_rd)
+  {
     ddsi_get_reader_stats (rd->m_rd, &stat->kv[0].u.u64);
+    ddsi_get_reader_rx_latency_stats (rd->m_rd, &stat->kv[1].u.u64, &stat->kv[2].u.u64, &stat->kv[3].u.u64, &stat->kv[4].u.u64);
+  }
 }
 
 const struct dds_entity_deriver dds_entity_deriver_reader = {
@@ -656,8 +664,13 @@ static dds_entity_t dds_create_reader_int (dds_entity_t participant_or_subscribe
   struct ddsi_psmx_locators_set *vl_set = dds_get_psmx_locators_set (rqos, &rd->m_entity.m_domain->psmx_instances);
 
   /* Reader gets the sertype from the topic, as the serdata functions the reader uses are
-     not specific for a data representation (the representation can be retrieved from the cdr header) */
-  rc = ddsi_new_reader (&rd->m_rd, &rd->m_entity.m_guid, NULL, pp, tp->m_name, tp->m_stype, rqos, &rd->m_rhc->common.rhc, dds_reader_status_cb, rd, vl_set);
+     not specific for a data representation (the representation can be retrieved from the cdr header).
+     A filter expression on the topic is advertised so that remote writers can apply it. */
+  ddsrt_mutex_lock (&tp->m_entity.m_mutex);
+  struct ddsi_content_filter_property *content_filter = tp->m_content_filter ? ddsi_content_filter_property_dup (tp->m_content_filter) : NULL;
+  ddsrt_mutex_unlock (&tp->m_entity.m_mutex);
+  rc = ddsi_new_reader (&rd->m_rd, &rd->m_entity.m_guid, NULL, pp, tp->m_name, tp->m_stype, rqos, &rd->m_rhc->common.rhc, dds_reader_status_cb, rd, vl_set, content_filter);
+  ddsi_content_filter_property_free (content_filter);
   if (rc != DDS_RETCODE_OK)
   {
     /* FIXME: can be out-of-resources at the very least; would leak allocated entity id */
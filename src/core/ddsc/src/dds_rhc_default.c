@@ -28,6 +28,7 @@
 #include "dds__loaned_sample.h"
 #include "dds/ddsc/dds_rhc.h"
 #include "dds__rhc_default.h"
+#include "dds__topic_filter.h"
 #include "dds/ddsi/ddsi_tkmap.h"
 #include "dds/ddsrt/hopscotch.h"
 #include "dds/ddsrt/avl.h"
@@ -313,6 +314,7 @@ struct dds_rhc_default {
   bool exclusive_ownership;          /* true if EXCLUSIVE, false if SHARED */
   bool reliable;                     /* true if reliability RELIABLE */
   bool xchecks;                      /* whether to do expensive checking if checking at all */
+  bool is_shard;                     /* true if one of the shards of a dds_rhc_sharded */
 
   dds_reader *reader;                /* reader -- may be NULL (used by rhc_torture) */
   struct ddsi_tkmap *tkmap;          /* back pointer to tkmap */
@@ -321,7 +323,7 @@ struct dds_rhc_default {
   uint32_t history_depth;            /* depth, 1 for KEEP_LAST_1, 2**32-1 for KEEP_ALL */
 
   ddsrt_mutex_t lock;
-  dds_readcond * conds;              /* List of associated read conditions */
+  dds_readcond * conds;              /* List of associated read conditions (shared by all shards) */
   uint32_t nconds;                   /* Number of associated read conditions */
   uint32_t nqconds;                  /* Number of associated query conditions */
   dds_querycond_mask_t qconds_samplest;  /* Mask of associated query conditions that check the sample state */
@@ -362,6 +364,8 @@ struct trigger_info_post {
 };
 
 static const struct dds_rhc_ops dds_rhc_default_ops;
+static const struct dds_rhc_ops dds_rhc_sharded_ops;
+static const struct dds_rhc_ops dds_rhc_latest_ops;
 
 static uint32_t qmask_of_sample (const struct rhc_sample *s)
 {
@@ -610,7 +614,20 @@ struct dds_rhc *dds_rhc_default_new_xchecks (struct ddsi_domaingv *gv, const str
 
 struct dds_rhc *dds_rhc_default_new (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos)
 {
-  return dds_rhc_default_new_xchecks (gv, type, qos, (gv->config.enabled_xchecks & DDSI_XCHECK_RHC) != 0);
+  const bool xchecks = (gv->config.enabled_xchecks & DDSI_XCHECK_RHC) != 0;
+  if (gv->config.reader_history_shards > 1 && type->has_key &&
+      qos->resource_limits.max_samples == DDS_LENGTH_UNLIMITED &&
+      qos->resource_limits.max_instances == DDS_LENGTH_UNLIMITED)
+    return dds_rhc_sharded_new_xchecks (gv, type, qos, (uint32_t) gv->config.reader_history_shards, xchecks);
+  else if (!type->has_key &&
+           qos->history.kind == DDS_HISTORY_KEEP_LAST && qos->history.depth == 1 &&
+           qos->ownership.kind == DDS_OWNERSHIP_SHARED &&
+           qos->destination_order.kind == DDS_DESTINATIONORDER_BY_RECEPTION_TIMESTAMP &&
+           qos->time_based_filter.minimum_separation == 0 &&
+           (!(qos->present & DDSI_QP_DEADLINE) || qos->deadline.deadline == DDS_INFINITY))
+    return dds_rhc_latest_new_xchecks (gv, type, qos, xchecks);
+  else
+    return dds_rhc_default_new_xchecks (gv, type, qos, xchecks);
 }
 
 static dds_return_t dds_rhc_default_associate (struct dds_rhc *rhc_common, dds_reader *reader)
@@ -793,12 +810,8 @@ static void dds_rhc_default_free (struct ddsi_rhc *rhc_common)
   ddsrt_free (rhc);
 }
 
-static void dds_rhc_default_get_state (const struct ddsi_rhc *rhc_common, struct ddsi_rhc_state *st)
+static void get_state_locked (const struct dds_rhc_default *rhc, struct ddsi_rhc_state *st)
 {
-  struct dds_rhc_default *rhc = (struct dds_rhc_default *) rhc_common;
-
-  ddsrt_mutex_lock (&rhc->lock);
-
   st->n_instances = rhc->n_instances;
   st->n_nonempty_instances = rhc->n_nonempty_instances;
   st->n_not_alive_disposed = rhc->n_not_alive_disposed;
@@ -808,7 +821,13 @@ static void dds_rhc_default_get_state (const struct ddsi_rhc *rhc_common, struct
   st->n_vread = rhc->n_vread;
   st->n_invsamples = rhc->n_invsamples;
   st->n_invread = rhc->n_invread;
+}
 
+static void dds_rhc_default_get_state (const struct ddsi_rhc *rhc_common, struct ddsi_rhc_state *st)
+{
+  struct dds_rhc_default *rhc = (struct dds_rhc_default *) rhc_common;
+  ddsrt_mutex_lock (&rhc->lock);
+  get_state_locked (rhc, st);
   ddsrt_mutex_unlock (&rhc->lock);
 }
 
@@ -1016,6 +1035,8 @@ static bool content_filter_accepts (const dds_reader *reader, const struct ddsi_
           {
             case DDS_TOPIC_FILTER_NONE:
             case DDS_TOPIC_FILTER_SAMPLEINFO_ARG:
+            case DDS_TOPIC_FILTER_MEMBERS:
+            case DDS_TOPIC_FILTER_EXPRESSION:
               assert (0);
             case DDS_TOPIC_FILTER_SAMPLE:
               ret = (tp->m_filter.f.sample) (tmp);
@@ -1034,6 +1055,10 @@ static bool content_filter_accepts (const dds_reader *reader, const struct ddsi_
         ddsi_sertype_free_sample (tp->m_stype, tmp, DDS_FREE_ALL);
         break;
       }
+      case DDS_TOPIC_FILTER_MEMBERS:
+      case DDS_TOPIC_FILTER_EXPRESSION:
+        ret = dds_topic_member_filter_accepts (tp->m_member_filter, sample);
+        break;
     }
   }
   return ret;
@@ -1593,9 +1618,8 @@ static void update_viewstate_and_disposedness (struct dds_rhc_default *rhc, stru
   delivered (true unless a reliable sample rejected).
 */
 
-static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo, struct ddsi_serdata *sample, struct ddsi_tkmap_instance *tk)
+static rhc_store_result_t rhc_store_locked (struct dds_rhc_default *rhc, const struct ddsi_writer_info *wrinfo, struct ddsi_serdata *sample, struct ddsi_tkmap_instance *tk, bool *nda, ddsi_status_cb_data_t *cb_data)
 {
-  struct dds_rhc_default * const rhc = (struct dds_rhc_default *) rhc_common;
   const uint64_t wr_iid = wrinfo->iid;
   const uint32_t statusinfo = sample->statusinfo;
   const bool has_data = (sample->kind == SDK_DATA);
@@ -1606,8 +1630,9 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
   struct trigger_info_post post;
   struct trigger_info_qcond trig_qc;
   rhc_store_result_t stored;
-  ddsi_status_cb_data_t cb_data;   /* Callback data for reader status callback */
-  bool notify_data_available;
+
+  *nda = false;
+  cb_data->raw_status_id = -1;
 
   TRACE ("rhc_store %"PRIx64",%"PRIx64" si %"PRIx32" has_data %d:", tk->m_iid, wr_iid, statusinfo, has_data);
   if (!has_data && statusinfo == 0)
@@ -1616,18 +1641,14 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
        register, which we do implicitly. (Currently DDSI2 won't allow
        it through anyway.) */
     TRACE (" ignore explicit register\n");
-    return true;
+    return RHC_FILTERED;
   }
 
-  notify_data_available = false;
   dummy_instance.iid = tk->m_iid;
   stored = RHC_FILTERED;
-  cb_data.raw_status_id = -1;
 
   init_trigger_info_qcond (&trig_qc);
 
-  ddsrt_mutex_lock (&rhc->lock);
-
   inst = ddsrt_hh_lookup (rhc->instances, &dummy_instance);
   if (inst == NULL)
   {
@@ -1643,7 +1664,7 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
     else
     {
       TRACE (" new instance\n");
-      stored = rhc_store_new_instance (&inst, rhc, wrinfo, sample, tk, has_data, &cb_data, &trig_qc, &notify_data_available);
+      stored = rhc_store_new_instance (&inst, rhc, wrinfo, sample, tk, has_data, cb_data, &trig_qc, nda);
       if (stored != RHC_STORED)
         goto error_or_nochange;
 
@@ -1662,13 +1683,13 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
     get_trigger_info_pre (&pre, inst);
     if (has_data || is_dispose)
     {
-      dds_rhc_register (rhc, inst, wr_iid, wrinfo->auto_dispose, false, &notify_data_available);
-      if (notify_data_available)
+      dds_rhc_register (rhc, inst, wr_iid, wrinfo->auto_dispose, false, nda);
+      if (*nda)
       {
         if (inst->latest == NULL || inst->latest->isread)
         {
           const bool was_empty = inst_is_empty (inst);
-          inst_set_invsample (rhc, inst, &trig_qc, &notify_data_available);
+          inst_set_invsample (rhc, inst, &trig_qc, nda);
           if (was_empty)
             account_for_empty_to_nonempty_transition (rhc, inst);
         }
@@ -1676,10 +1697,10 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
     }
 
     /* notify sample lost */
-    cb_data.raw_status_id = (int) DDS_SAMPLE_LOST_STATUS_ID;
-    cb_data.extra = 0;
-    cb_data.handle = 0;
-    cb_data.add = true;
+    cb_data->raw_status_id = (int) DDS_SAMPLE_LOST_STATUS_ID;
+    cb_data->extra = 0;
+    cb_data->handle = 0;
+    cb_data->add = true;
   }
   else
   {
@@ -1707,14 +1728,14 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
          (i.e., out-of-memory), abort the operation and hope that the
          caller can still notify the application.  */
 
-      dds_rhc_register (rhc, inst, wr_iid, wrinfo->auto_dispose, true, &notify_data_available);
-      update_viewstate_and_disposedness (rhc, inst, has_data, not_alive, is_dispose, &notify_data_available);
+      dds_rhc_register (rhc, inst, wr_iid, wrinfo->auto_dispose, true, nda);
+      update_viewstate_and_disposedness (rhc, inst, has_data, not_alive, is_dispose, nda);
 
       /* Only need to add a sample to the history if the input actually is a sample. */
       if (has_data)
       {
         TRACE (" add_sample");
-        if (!add_sample (rhc, inst, wrinfo, sample, &cb_data, &trig_qc, &notify_data_available))
+        if (!add_sample (rhc, inst, wrinfo, sample, cb_data, &trig_qc, nda))
         {
           TRACE ("(reject)\n");
           stored = RHC_REJECTED;
@@ -1730,7 +1751,7 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
 
       /* If instance became disposed, add an invalid sample if there are no samples left */
       if ((bool) inst->isdisposed > old_isdisposed && (inst->latest == NULL || inst->latest->isread))
-        inst_set_invsample (rhc, inst, &trig_qc, &notify_data_available);
+        inst_set_invsample (rhc, inst, &trig_qc, nda);
 
       update_inst_have_wr_iid (inst, wrinfo, sample->timestamp);
 
@@ -1753,7 +1774,7 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
       }
     }
 
-    TRACE(" nda=%d\n", notify_data_available);
+    TRACE(" nda=%d\n", *nda);
     assert (rhc_check_counts_locked (rhc, false, false));
   }
 
@@ -1772,7 +1793,7 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
        mean an application reading "x" after the write and reading it
        again after the unregister will see a change in the
        no_writers_generation field? */
-    dds_rhc_unregister (rhc, inst, wrinfo, sample->timestamp, &post, &trig_qc, &notify_data_available);
+    dds_rhc_unregister (rhc, inst, wrinfo, sample->timestamp, &post, &trig_qc, nda);
   }
   else
   {
@@ -1782,19 +1803,35 @@ static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct dds
   postprocess_instance_update (rhc, &inst, &pre, &post, &trig_qc);
 
 error_or_nochange:
-  ddsrt_mutex_unlock (&rhc->lock);
+  return stored;
+}
 
+static bool store_notify (struct dds_rhc_default *rhc, rhc_store_result_t stored, bool notify_data_available, const ddsi_status_cb_data_t *cb_data)
+{
   if (rhc->reader)
   {
     if (notify_data_available)
       dds_reader_data_available_cb (rhc->reader);
-    if (cb_data.raw_status_id >= 0)
-      dds_reader_status_cb (&rhc->reader->m_entity, &cb_data);
+    if (cb_data->raw_status_id >= 0)
+      dds_reader_status_cb (&rhc->reader->m_entity, cb_data);
   }
   return !(rhc->reliable && stored == RHC_REJECTED);
 }
 
-static void dds_rhc_default_unregister_wr (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo)
+static bool dds_rhc_default_store (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo, struct ddsi_serdata *sample, struct ddsi_tkmap_instance *tk)
+{
+  struct dds_rhc_default * const rhc = (struct dds_rhc_default *) rhc_common;
+  ddsi_status_cb_data_t cb_data;   /* Callback data for reader status callback */
+  bool notify_data_available;
+  rhc_store_result_t stored;
+
+  ddsrt_mutex_lock (&rhc->lock);
+  stored = rhc_store_locked (rhc, wrinfo, sample, tk, &notify_data_available, &cb_data);
+  ddsrt_mutex_unlock (&rhc->lock);
+  return store_notify (rhc, stored, notify_data_available, &cb_data);
+}
+
+static bool unregister_wr_locked (struct dds_rhc_default *rhc, const struct ddsi_writer_info *wrinfo)
 {
   /* Only to be called when writer with ID WR_IID has died.
 
@@ -1811,13 +1848,11 @@ static void dds_rhc_default_unregister_wr (struct ddsi_rhc *rhc_common, const st
      need to get two IIDs: the one visible to the application in the
      built-in topics and in get_instance_handle, and one used internally
      for tracking registrations and unregistrations. */
-  struct dds_rhc_default *const rhc = (struct dds_rhc_default *) rhc_common;
   bool notify_data_available = false;
   struct rhc_instance *inst;
   struct ddsrt_hh_iter iter;
   const uint64_t wr_iid = wrinfo->iid;
 
-  ddsrt_mutex_lock (&rhc->lock);
   TRACE ("rhc_unregister_wr_iid %"PRIx64",%d:\n", wr_iid, wrinfo->auto_dispose);
   for (inst = ddsrt_hh_iter_first (rhc->instances, &iter); inst; inst = ddsrt_hh_iter_next (&iter))
   {
@@ -1835,18 +1870,24 @@ static void dds_rhc_default_unregister_wr (struct ddsi_rhc *rhc_common, const st
       TRACE ("\n");
     }
   }
+  return notify_data_available;
+}
+
+static void dds_rhc_default_unregister_wr (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo)
+{
+  struct dds_rhc_default *const rhc = (struct dds_rhc_default *) rhc_common;
+  ddsrt_mutex_lock (&rhc->lock);
+  const bool notify_data_available = unregister_wr_locked (rhc, wrinfo);
   ddsrt_mutex_unlock (&rhc->lock);
 
   if (rhc->reader && notify_data_available)
     dds_reader_data_available_cb (rhc->reader);
 }
 
-static void dds_rhc_default_relinquish_ownership (struct ddsi_rhc *rhc_common, const uint64_t wr_iid)
+static void relinquish_ownership_locked (struct dds_rhc_default *rhc, const uint64_t wr_iid)
 {
-  struct dds_rhc_default *const rhc = (struct dds_rhc_default *) rhc_common;
   struct rhc_instance *inst;
   struct ddsrt_hh_iter iter;
-  ddsrt_mutex_lock (&rhc->lock);
   TRACE ("rhc_relinquish_ownership(%"PRIx64":\n", wr_iid);
   for (inst = ddsrt_hh_iter_first (rhc->instances, &iter); inst; inst = ddsrt_hh_iter_next (&iter))
   {
@@ -1857,6 +1898,13 @@ static void dds_rhc_default_relinquish_ownership (struct ddsi_rhc *rhc_common, c
   }
   TRACE (")\n");
   assert (rhc_check_counts_locked (rhc, true, false));
+}
+
+static void dds_rhc_default_relinquish_ownership (struct ddsi_rhc *rhc_common, const uint64_t wr_iid)
+{
+  struct dds_rhc_default *const rhc = (struct dds_rhc_default *) rhc_common;
+  ddsrt_mutex_lock (&rhc->lock);
+  relinquish_ownership_locked (rhc, wr_iid);
   ddsrt_mutex_unlock (&rhc->lock);
 }
 
@@ -2409,12 +2457,11 @@ abort_on_error: ;
   return rc;
 }
 
-static dds_return_t read_w_qminv (const struct readtake_w_qminv_inst_state *state, bool mark_as_read, dds_instance_handle_t handle, bool next_instance)
+static dds_return_t read_w_qminv_locked (const struct readtake_w_qminv_inst_state *state, bool mark_as_read, dds_instance_handle_t handle, bool next_instance)
 {
   struct dds_rhc_default * const rhc = state->rhc;
   dds_return_t rc = DDS_RETCODE_OK;
   assert (0 < *state->limit && *state->limit <= INT32_MAX);
-  ddsrt_mutex_lock (&rhc->lock);
 
   TRACE ("read_w_qminv(%p,%"PRId32",%"PRIx32",%"PRIx64") - inst %"PRIu32" nonempty %"PRIu32" disp %"PRIu32" nowr %"PRIu32" new %"PRIu32" samples %"PRIu32"+%"PRIu32" read %"PRIu32"+%"PRIu32"\n", (void*) rhc, *state->limit, state->qminv, handle,
     rhc->n_instances, rhc->n_nonempty_instances, rhc->n_not_alive_disposed,
@@ -2448,16 +2495,22 @@ static dds_return_t read_w_qminv (const struct readtake_w_qminv_inst_state *stat
   }
   TRACE ("read: returning %"PRId32" with remaining limit %"PRId32"\n", rc, *state->limit);
   assert (rhc_check_counts_locked (rhc, true, false));
-  ddsrt_mutex_unlock (&rhc->lock);
   return rc;
 }
 
-static dds_return_t take_w_qminv (const struct readtake_w_qminv_inst_state *state, dds_instance_handle_t handle, bool next_instance)
+static dds_return_t read_w_qminv (const struct readtake_w_qminv_inst_state *state, bool mark_as_read, dds_instance_handle_t handle, bool next_instance)
+{
+  ddsrt_mutex_lock (&state->rhc->lock);
+  const dds_return_t rc = read_w_qminv_locked (state, mark_as_read, handle, next_instance);
+  ddsrt_mutex_unlock (&state->rhc->lock);
+  return rc;
+}
+
+static dds_return_t take_w_qminv_locked (const struct readtake_w_qminv_inst_state *state, dds_instance_handle_t handle, bool next_instance)
 {
   struct dds_rhc_default * const rhc = state->rhc;
   dds_return_t rc = DDS_RETCODE_OK;
   assert (0 < *state->limit && *state->limit <= INT32_MAX);
-  ddsrt_mutex_lock (&rhc->lock);
 
   TRACE ("take_w_qminv(%p,%"PRId32",%"PRIx32",%"PRIx64") - inst %"PRIu32" nonempty %"PRIu32" disp %"PRIu32" nowr %"PRIu32" new %"PRIu32" samples %"PRIu32"+%"PRIu32" read %"PRIu32"+%"PRIu32"\n", (void*) rhc, *state->limit, state->qminv, handle,
     rhc->n_instances, rhc->n_nonempty_instances, rhc->n_not_alive_disposed,
@@ -2493,7 +2546,14 @@ static dds_return_t take_w_qminv (const struct readtake_w_qminv_inst_state *stat
   }
   TRACE ("take: returning %"PRId32" with remaining limit %"PRId32"\n", rc, *state->limit);
   assert (rhc_check_counts_locked (rhc, true, false));
-  ddsrt_mutex_unlock (&rhc->lock);
+  return rc;
+}
+
+static dds_return_t take_w_qminv (const struct readtake_w_qminv_inst_state *state, dds_instance_handle_t handle, bool next_instance)
+{
+  ddsrt_mutex_lock (&state->rhc->lock);
+  const dds_return_t rc = take_w_qminv_locked (state, handle, next_instance);
+  ddsrt_mutex_unlock (&state->rhc->lock);
   return rc;
 }
 
@@ -2540,25 +2600,9 @@ static bool cond_is_sample_state_dependent (const struct dds_readcond *cond)
   }
 }
 
-static bool dds_rhc_default_add_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+static bool alloc_readcondition_qcmask_locked (const struct dds_rhc_default *rhc, dds_readcond *cond)
 {
-  /* On the assumption that a readcondition will be attached to a
-     waitset for nearly all of its life, we keep track of all
-     readconditions on a reader in one set, without distinguishing
-     between those attached to a waitset or not. */
-  struct dds_rhc_default * const rhc = (struct dds_rhc_default *) rhc_common;
-  struct ddsrt_hh_iter it;
-
-  assert ((dds_entity_kind (&cond->m_entity) == DDS_KIND_COND_READ && cond->m_query.m_filter == 0) ||
-          (dds_entity_kind (&cond->m_entity) == DDS_KIND_COND_QUERY && cond->m_query.m_filter != 0));
-  assert (ddsrt_atomic_ld32 (&cond->m_entity.m_status.m_trigger) == 0);
-  assert (cond->m_query.m_qcmask == 0);
-
-  cond->m_qminv = qmask_from_dcpsquery (cond->m_sample_states, cond->m_view_states, cond->m_instance_states);
-
-  ddsrt_mutex_lock (&rhc->lock);
-
-  /* Allocate a slot in the condition bitmasks; return an error no more slots are available */
+  /* Allocate a slot in the condition bitmasks; return false if no more slots are available */
   if (cond->m_query.m_filter != NULL)
   {
     dds_querycond_mask_t avail_qcmask = ~(dds_querycond_mask_t)0;
@@ -2570,17 +2614,21 @@ static bool dds_rhc_default_add_readcondition (struct dds_rhc *rhc_common, dds_r
     if (avail_qcmask == 0)
     {
       /* no available indices */
-      ddsrt_mutex_unlock (&rhc->lock);
       return false;
     }
 
     /* use the least significant bit set */
     cond->m_query.m_qcmask = avail_qcmask & (~avail_qcmask + 1);
   }
+  return true;
+}
 
+static uint32_t attach_readcondition_locked (struct dds_rhc_default *rhc, dds_readcond *cond)
+{
+  /* Pre: cond is at the head of rhc->conds; returns the number of matching samples in rhc */
+  struct ddsrt_hh_iter it;
+  assert (rhc->conds == cond);
   rhc->nconds++;
-  cond->m_next = rhc->conds;
-  rhc->conds = cond;
 
   uint32_t trigger = 0;
   if (cond->m_query.m_filter == NULL)
@@ -2631,7 +2679,33 @@ static bool dds_rhc_default_add_readcondition (struct dds_rhc *rhc_common, dds_r
         trigger += (inst->inv_exists ? instmatch : 0) + matches;
     }
   }
+  return trigger;
+}
+
+static void detach_readcondition_locked (struct dds_rhc_default *rhc, const dds_readcond *cond)
+{
+  /* Pre: cond has been removed from rhc->conds, but still has its bit in the condition bitmasks */
+  rhc->nconds--;
+  if (cond->m_query.m_filter)
+  {
+    rhc->nqconds--;
+    rhc->qconds_samplest &= ~cond->m_query.m_qcmask;
+    if (rhc->nqconds == 0)
+    {
+      assert (rhc->qcond_eval_samplebuf != NULL);
+      ddsi_sertype_free_sample (rhc->type, rhc->qcond_eval_samplebuf, DDS_FREE_ALL);
+      rhc->qcond_eval_samplebuf = NULL;
+    }
+  }
+}
 
+static bool add_readcondition_locked (struct dds_rhc_default *rhc, dds_readcond *cond)
+{
+  if (!alloc_readcondition_qcmask_locked (rhc, cond))
+    return false;
+  cond->m_next = rhc->conds;
+  rhc->conds = cond;
+  const uint32_t trigger = attach_readcondition_locked (rhc, cond);
   if (trigger)
   {
     ddsrt_atomic_st32 (&cond->m_entity.m_status.m_trigger, trigger);
@@ -2641,33 +2715,46 @@ static bool dds_rhc_default_add_readcondition (struct dds_rhc *rhc_common, dds_r
   TRACE ("add_readcondition(%p, %"PRIx32", %"PRIx32", %"PRIx32") => %p qminv %"PRIx32" ; rhc %"PRIu32" conds\n",
     (void *) rhc, cond->m_sample_states, cond->m_view_states,
     cond->m_instance_states, (void *) cond, cond->m_qminv, rhc->nconds);
-
-  ddsrt_mutex_unlock (&rhc->lock);
   return true;
 }
 
-static void dds_rhc_default_remove_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+static bool dds_rhc_default_add_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
 {
+  /* On the assumption that a readcondition will be attached to a
+     waitset for nearly all of its life, we keep track of all
+     readconditions on a reader in one set, without distinguishing
+     between those attached to a waitset or not. */
   struct dds_rhc_default * const rhc = (struct dds_rhc_default *) rhc_common;
-  dds_readcond **ptr;
+
+  assert ((dds_entity_kind (&cond->m_entity) == DDS_KIND_COND_READ && cond->m_query.m_filter == 0) ||
+          (dds_entity_kind (&cond->m_entity) == DDS_KIND_COND_QUERY && cond->m_query.m_filter != 0));
+  assert (ddsrt_atomic_ld32 (&cond->m_entity.m_status.m_trigger) == 0);
+  assert (cond->m_query.m_qcmask == 0);
+
+  cond->m_qminv = qmask_from_dcpsquery (cond->m_sample_states, cond->m_view_states, cond->m_instance_states);
+
   ddsrt_mutex_lock (&rhc->lock);
+  const bool ret = add_readcondition_locked (rhc, cond);
+  ddsrt_mutex_unlock (&rhc->lock);
+  return ret;
+}
+
+static void remove_readcondition_locked (struct dds_rhc_default *rhc, dds_readcond *cond)
+{
+  dds_readcond **ptr;
   ptr = &rhc->conds;
   while (*ptr != cond)
     ptr = &(*ptr)->m_next;
   *ptr = (*ptr)->m_next;
-  rhc->nconds--;
-  if (cond->m_query.m_filter)
-  {
-    rhc->nqconds--;
-    rhc->qconds_samplest &= ~cond->m_query.m_qcmask;
-    cond->m_query.m_qcmask = 0;
-    if (rhc->nqconds == 0)
-    {
-      assert (rhc->qcond_eval_samplebuf != NULL);
-      ddsi_sertype_free_sample (rhc->type, rhc->qcond_eval_samplebuf, DDS_FREE_ALL);
-      rhc->qcond_eval_samplebuf = NULL;
-    }
-  }
+  detach_readcondition_locked (rhc, cond);
+  cond->m_query.m_qcmask = 0;
+}
+
+static void dds_rhc_default_remove_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+{
+  struct dds_rhc_default * const rhc = (struct dds_rhc_default *) rhc_common;
+  ddsrt_mutex_lock (&rhc->lock);
+  remove_readcondition_locked (rhc, cond);
   ddsrt_mutex_unlock (&rhc->lock);
 }
 
@@ -2921,6 +3008,538 @@ static int32_t dds_rhc_default_take (struct dds_rhc *rhc_common, int32_t max_sam
   return (rc < 0 && limit == max_samples) ? rc : (max_samples - limit);
 }
 
+/*************************
+ ******   SHARDED   ******
+ *************************/
+
+/* A sharded RHC partitions the instances over a number of default RHCs ("shards"), each
+   with its own lock, so that storing data in one instance doesn't block reading or taking
+   data from instances in other shards.
+
+   The shards share the list of read conditions.  It is only modified with all shards
+   locked, and the trigger of a condition is the sum of the contributions of the shards
+   (each shard only updates it incrementally).  Reading or taking from all instances
+   visits the shards one after the other and so is not atomic with respect to stores in
+   the other shards, which is no different from what happens with a store immediately
+   following a read/take. */
+
+struct dds_rhc_sharded {
+  struct dds_rhc common;
+  uint32_t nshards;
+  struct dds_rhc_default *shards[];
+};
+
+static struct dds_rhc_default *shard_for_iid (const struct dds_rhc_sharded *rhc, uint64_t iid)
+{
+  /* the low-order bits are used for the hash table in the shard, instance ids are
+     pseudo-random so the high-order bits work fine for selecting the shard */
+  return rhc->shards[(uint32_t) (iid >> 32) % rhc->nshards];
+}
+
+static void lock_all_shards (struct dds_rhc_sharded *rhc)
+{
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+    ddsrt_mutex_lock (&rhc->shards[i]->lock);
+}
+
+static void unlock_all_shards (struct dds_rhc_sharded *rhc)
+{
+  for (uint32_t i = rhc->nshards; i > 0; i--)
+    ddsrt_mutex_unlock (&rhc->shards[i - 1]->lock);
+}
+
+static bool dds_rhc_sharded_store (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo, struct ddsi_serdata *sample, struct ddsi_tkmap_instance *tk)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+  return dds_rhc_default_store (&shard_for_iid (rhc, tk->m_iid)->common.common.rhc, wrinfo, sample, tk);
+}
+
+static void dds_rhc_sharded_unregister_wr (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+    dds_rhc_default_unregister_wr (&rhc->shards[i]->common.common.rhc, wrinfo);
+}
+
+static void dds_rhc_sharded_relinquish_ownership (struct ddsi_rhc *rhc_common, const uint64_t wr_iid)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+    dds_rhc_default_relinquish_ownership (&rhc->shards[i]->common.common.rhc, wr_iid);
+}
+
+static void dds_rhc_sharded_free (struct ddsi_rhc *rhc_common)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+    dds_rhc_default_free (&rhc->shards[i]->common.common.rhc);
+  ddsrt_free (rhc);
+}
+
+static void dds_rhc_sharded_get_state (const struct ddsi_rhc *rhc_common, struct ddsi_rhc_state *st)
+{
+  const struct dds_rhc_sharded * const rhc = (const struct dds_rhc_sharded *) rhc_common;
+  memset (st, 0, sizeof (*st));
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+  {
+    struct ddsi_rhc_state x;
+    dds_rhc_default_get_state (&rhc->shards[i]->common.common.rhc, &x);
+    st->n_instances += x.n_instances;
+    st->n_nonempty_instances += x.n_nonempty_instances;
+    st->n_not_alive_disposed += x.n_not_alive_disposed;
+    st->n_not_alive_no_writers += x.n_not_alive_no_writers;
+    st->n_new += x.n_new;
+    st->n_vsamples += x.n_vsamples;
+    st->n_vread += x.n_vread;
+    st->n_invsamples += x.n_invsamples;
+    st->n_invread += x.n_invread;
+  }
+}
+
+static dds_return_t dds_rhc_sharded_associate (struct dds_rhc *rhc_common, dds_reader *reader)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+    (void) dds_rhc_default_associate (&rhc->shards[i]->common, reader);
+  return DDS_RETCODE_OK;
+}
+
+static bool dds_rhc_sharded_add_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+
+  assert (ddsrt_atomic_ld32 (&cond->m_entity.m_status.m_trigger) == 0);
+  assert (cond->m_query.m_qcmask == 0);
+
+  cond->m_qminv = qmask_from_dcpsquery (cond->m_sample_states, cond->m_view_states, cond->m_instance_states);
+
+  lock_all_shards (rhc);
+  if (!alloc_readcondition_qcmask_locked (rhc->shards[0], cond))
+  {
+    unlock_all_shards (rhc);
+    return false;
+  }
+  cond->m_next = rhc->shards[0]->conds;
+  uint32_t trigger = 0;
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+  {
+    rhc->shards[i]->conds = cond;
+    trigger += attach_readcondition_locked (rhc->shards[i], cond);
+  }
+  if (trigger)
+  {
+    ddsrt_atomic_st32 (&cond->m_entity.m_status.m_trigger, trigger);
+    dds_entity_status_signal (&cond->m_entity);
+  }
+  unlock_all_shards (rhc);
+  return true;
+}
+
+static void dds_rhc_sharded_remove_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+{
+  struct dds_rhc_sharded * const rhc = (struct dds_rhc_sharded *) rhc_common;
+  dds_readcond **ptr;
+  lock_all_shards (rhc);
+  ptr = &rhc->shards[0]->conds;
+  while (*ptr != cond)
+    ptr = &(*ptr)->m_next;
+  *ptr = (*ptr)->m_next;
+  for (uint32_t i = 0; i < rhc->nshards; i++)
+  {
+    rhc->shards[i]->conds = rhc->shards[0]->conds;
+    detach_readcondition_locked (rhc->shards[i], cond);
+  }
+  cond->m_query.m_qcmask = 0;
+  unlock_all_shards (rhc);
+}
+
+static int32_t dds_rhc_sharded_readtake (struct dds_rhc_sharded *rhc, bool take, bool mark_as_read, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  int32_t limit = max_samples;
+  dds_return_t rc = DDS_RETCODE_OK;
+  if (next_instance)
+  {
+    /* Next instance is the one with the smallest handle greater than "handle" over all
+       shards, locking all of them guarantees the result is the same as without sharding */
+    struct readtake_w_qminv_inst_state state =
+      make_readtake_w_qminv_inst_state (NULL, &limit, mask, cond, collect_sample, collect_sample_arg);
+    struct dds_rhc_default *next_shard = NULL;
+    dds_instance_handle_t next_iid = 0;
+    lock_all_shards (rhc);
+    for (uint32_t i = 0; i < rhc->nshards; i++)
+    {
+      const struct rhc_instance *inst;
+      state.rhc = rhc->shards[i];
+      if ((inst = next_nonempty_instance_by_id (&state, state.rhc, handle)) != NULL && (next_shard == NULL || inst->iid < next_iid))
+      {
+        next_shard = state.rhc;
+        next_iid = inst->iid;
+      }
+    }
+    if (next_shard != NULL)
+    {
+      state.rhc = next_shard;
+      rc = take ? take_w_qminv_locked (&state, handle, true) : read_w_qminv_locked (&state, mark_as_read, handle, true);
+    }
+    unlock_all_shards (rhc);
+  }
+  else if (handle)
+  {
+    const struct readtake_w_qminv_inst_state state =
+      make_readtake_w_qminv_inst_state (shard_for_iid (rhc, handle), &limit, mask, cond, collect_sample, collect_sample_arg);
+    rc = take ? take_w_qminv (&state, handle, false) : read_w_qminv (&state, mark_as_read, handle, false);
+  }
+  else
+  {
+    for (uint32_t i = 0; i < rhc->nshards && rc >= 0 && limit > 0; i++)
+    {
+      const struct readtake_w_qminv_inst_state state =
+        make_readtake_w_qminv_inst_state (rhc->shards[i], &limit, mask, cond, collect_sample, collect_sample_arg);
+      rc = take ? take_w_qminv (&state, 0, false) : read_w_qminv (&state, mark_as_read, 0, false);
+    }
+  }
+  return (rc < 0 && limit == max_samples) ? rc : (max_samples - limit);
+}
+
+static int32_t dds_rhc_sharded_peek (struct dds_rhc *rhc_common, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  return dds_rhc_sharded_readtake ((struct dds_rhc_sharded *) rhc_common, false, false, max_samples, mask, handle, cond, collect_sample, collect_sample_arg, next_instance);
+}
+
+static int32_t dds_rhc_sharded_read (struct dds_rhc *rhc_common, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  return dds_rhc_sharded_readtake ((struct dds_rhc_sharded *) rhc_common, false, true, max_samples, mask, handle, cond, collect_sample, collect_sample_arg, next_instance);
+}
+
+static int32_t dds_rhc_sharded_take (struct dds_rhc *rhc_common, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  return dds_rhc_sharded_readtake ((struct dds_rhc_sharded *) rhc_common, true, true, max_samples, mask, handle, cond, collect_sample, collect_sample_arg, next_instance);
+}
+
+struct dds_rhc *dds_rhc_sharded_new_xchecks (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos, uint32_t nshards, bool xchecks)
+{
+  /* Limits on the total number of samples and instances can't be enforced independently by the shards */
+  assert (nshards > 0);
+  assert (qos->resource_limits.max_samples == DDS_LENGTH_UNLIMITED && qos->resource_limits.max_instances == DDS_LENGTH_UNLIMITED);
+  struct dds_rhc_sharded *rhc = ddsrt_malloc (sizeof (*rhc) + nshards * sizeof (rhc->shards[0]));
+  memset (rhc, 0, sizeof (*rhc));
+  rhc->common.common.ops = &dds_rhc_sharded_ops;
+  rhc->nshards = nshards;
+  for (uint32_t i = 0; i < nshards; i++)
+  {
+    rhc->shards[i] = (struct dds_rhc_default *) dds_rhc_default_new_xchecks (gv, type, qos, xchecks);
+    rhc->shards[i]->is_shard = true;
+  }
+  return &rhc->common;
+}
+
+/*************************
+ ******   LATEST    ******
+ *************************/
+
+/* An unkeyed reader with KEEP_LAST 1 history has a single instance holding at most one
+   sample, and when that instance is alive, not new, has no invalid sample and there are
+   no read conditions, storing data from the most recent writer just replaces the sample,
+   while taking it just removes it.  The "latest" RHC keeps the sample in an atomic slot
+   while the instance is in that state (the slot is "open") and otherwise defers to a
+   default RHC (the slot is "closed").
+
+   The slot is only opened and closed with the lock of the default RHC held, closing it
+   moves the sample in it to the default RHC.  Stores also hold the lock, because there
+   may be multiple delivery threads and the writer has to be checked against the instance,
+   but do nothing beyond swapping in the new sample and updating the source timestamp.
+   Takes never lock while the slot is open: a successful CAS from a sample to a null
+   pointer hands over the sample and as the slot can only be open if the simple state
+   holds, no further bookkeeping is needed.  Reads, peeks, taking from a condition or
+   a specific instance and all other operations close the slot first. */
+
+/* Slot value while the default RHC has the data */
+static char latest_slot_closed;
+#define LATEST_SLOT_CLOSED ((void *) &latest_slot_closed)
+
+/* Sample and instance state of a sample in an open slot */
+#define LATEST_SLOT_QMASK (DDS_NOT_READ_SAMPLE_STATE | DDS_NOT_NEW_VIEW_STATE | DDS_ALIVE_INSTANCE_STATE)
+
+struct rhc_latest_sample {
+  struct ddsi_serdata *sample;
+  struct ddsi_writer_info wrinfo;
+  uint64_t iid;
+  uint32_t disposed_gen;
+  uint32_t no_writers_gen;
+};
+
+struct dds_rhc_latest {
+  struct dds_rhc common;
+  ddsrt_atomic_voidp_t slot;         /* null, latest sample or LATEST_SLOT_CLOSED */
+  struct rhc_instance *inst;         /* the instance while the slot is open */
+  struct dds_rhc_default *def;
+};
+
+static void free_latest_sample (struct rhc_latest_sample *ls)
+{
+  ddsi_serdata_unref (ls->sample);
+  ddsrt_free (ls);
+}
+
+static bool latest_close_slot_locked (struct dds_rhc_latest *rhc)
+{
+  /* Returns whether the slot contained a sample */
+  void *v = ddsrt_atomic_ldvoidp (&rhc->slot);
+  while (v != LATEST_SLOT_CLOSED && !ddsrt_atomic_casvoidp (&rhc->slot, v, LATEST_SLOT_CLOSED))
+    v = ddsrt_atomic_ldvoidp (&rhc->slot);
+  if (v == LATEST_SLOT_CLOSED || v == NULL)
+  {
+    rhc->inst = NULL;
+    return false;
+  }
+  /* Storing it again with the same writer info gives the state it would have had had it
+     been stored in the default RHC in the first place; data available has been signalled */
+  struct rhc_latest_sample * const ls = v;
+  ddsi_status_cb_data_t cb_data;
+  bool nda;
+  (void) rhc_store_locked (rhc->def, &ls->wrinfo, ls->sample, rhc->inst->tk, &nda, &cb_data);
+  free_latest_sample (ls);
+  rhc->inst = NULL;
+  return true;
+}
+
+static void latest_try_open_slot_locked (struct dds_rhc_latest *rhc)
+{
+  struct dds_rhc_default * const def = rhc->def;
+  assert (ddsrt_atomic_ldvoidp (&rhc->slot) == LATEST_SLOT_CLOSED);
+  if (def->n_instances != 1 || def->nconds != 0)
+    return;
+  struct ddsrt_hh_iter iter;
+  struct rhc_instance * const inst = ddsrt_hh_iter_first (def->instances, &iter);
+  if (inst->isnew || inst->isdisposed || !inst->wr_iid_islive || !inst_is_empty (inst))
+    return;
+  rhc->inst = inst;
+  ddsrt_atomic_fence_rel ();
+  ddsrt_atomic_stvoidp (&rhc->slot, NULL);
+}
+
+static bool latest_sample_fits_slot (const struct dds_rhc_default *def, const struct ddsi_writer_info *wrinfo, const struct ddsi_serdata *sample)
+{
+  if (sample->kind != SDK_DATA || sample->statusinfo != 0)
+    return false;
+#ifdef DDS_HAS_LIFESPAN
+  if (wrinfo->lifespan_exp.v != DDS_NEVER)
+    return false;
+#else
+  (void) wrinfo;
+#endif
+  return def->reader == NULL || def->reader->m_topic->m_filter.mode == DDS_TOPIC_FILTER_NONE;
+}
+
+static bool dds_rhc_latest_store (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo, struct ddsi_serdata *sample, struct ddsi_tkmap_instance *tk)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  struct dds_rhc_default * const def = rhc->def;
+  struct rhc_latest_sample *ls = NULL;
+  if (latest_sample_fits_slot (def, wrinfo, sample))
+    ls = ddsrt_malloc (sizeof (*ls));
+
+  ddsrt_mutex_lock (&def->lock);
+  void *old = ddsrt_atomic_ldvoidp (&rhc->slot);
+  if (ls && old != LATEST_SLOT_CLOSED && tk->m_iid == rhc->inst->iid && wrinfo->iid == rhc->inst->wr_iid)
+  {
+    struct rhc_instance * const inst = rhc->inst;
+    ls->sample = ddsi_serdata_ref (sample);
+    ls->wrinfo = *wrinfo;
+    ls->iid = inst->iid;
+    ls->disposed_gen = inst->disposed_gen;
+    ls->no_writers_gen = inst->no_writers_gen;
+    update_inst_common (inst, wrinfo, sample->timestamp);
+    /* only a take can change the slot concurrently, and only to a null pointer */
+    while (!ddsrt_atomic_casvoidp (&rhc->slot, old, ls))
+      old = ddsrt_atomic_ldvoidp (&rhc->slot);
+    ddsrt_mutex_unlock (&def->lock);
+    if (old)
+      free_latest_sample (old);
+    if (def->reader)
+      dds_reader_data_available_cb (def->reader);
+    return true;
+  }
+
+  ddsi_status_cb_data_t cb_data;
+  bool notify_data_available;
+  latest_close_slot_locked (rhc);
+  const rhc_store_result_t stored = rhc_store_locked (def, wrinfo, sample, tk, &notify_data_available, &cb_data);
+  latest_try_open_slot_locked (rhc);
+  ddsrt_mutex_unlock (&def->lock);
+  ddsrt_free (ls);
+  return store_notify (def, stored, notify_data_available, &cb_data);
+}
+
+static void dds_rhc_latest_unregister_wr (struct ddsi_rhc *rhc_common, const struct ddsi_writer_info *wrinfo)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  ddsrt_mutex_lock (&rhc->def->lock);
+  latest_close_slot_locked (rhc);
+  const bool notify_data_available = unregister_wr_locked (rhc->def, wrinfo);
+  latest_try_open_slot_locked (rhc);
+  ddsrt_mutex_unlock (&rhc->def->lock);
+  if (rhc->def->reader && notify_data_available)
+    dds_reader_data_available_cb (rhc->def->reader);
+}
+
+static void dds_rhc_latest_relinquish_ownership (struct ddsi_rhc *rhc_common, const uint64_t wr_iid)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  ddsrt_mutex_lock (&rhc->def->lock);
+  latest_close_slot_locked (rhc);
+  relinquish_ownership_locked (rhc->def, wr_iid);
+  latest_try_open_slot_locked (rhc);
+  ddsrt_mutex_unlock (&rhc->def->lock);
+}
+
+static void dds_rhc_latest_free (struct ddsi_rhc *rhc_common)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  void *v = ddsrt_atomic_ldvoidp (&rhc->slot);
+  if (v != NULL && v != LATEST_SLOT_CLOSED)
+    free_latest_sample (v);
+  dds_rhc_default_free (&rhc->def->common.common.rhc);
+  ddsrt_free (rhc);
+}
+
+static void dds_rhc_latest_get_state (const struct ddsi_rhc *rhc_common, struct ddsi_rhc_state *st)
+{
+  const struct dds_rhc_latest * const rhc = (const struct dds_rhc_latest *) rhc_common;
+  ddsrt_mutex_lock (&rhc->def->lock);
+  get_state_locked (rhc->def, st);
+  const void *v = ddsrt_atomic_ldvoidp (&rhc->slot);
+  if (v != NULL && v != LATEST_SLOT_CLOSED)
+  {
+    /* the instance is empty as far as the default RHC is concerned */
+    st->n_nonempty_instances++;
+    st->n_vsamples++;
+  }
+  ddsrt_mutex_unlock (&rhc->def->lock);
+}
+
+static dds_return_t dds_rhc_latest_associate (struct dds_rhc *rhc_common, dds_reader *reader)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  return dds_rhc_default_associate (&rhc->def->common, reader);
+}
+
+static bool dds_rhc_latest_add_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+
+  assert (ddsrt_atomic_ld32 (&cond->m_entity.m_status.m_trigger) == 0);
+  assert (cond->m_query.m_qcmask == 0);
+
+  cond->m_qminv = qmask_from_dcpsquery (cond->m_sample_states, cond->m_view_states, cond->m_instance_states);
+
+  ddsrt_mutex_lock (&rhc->def->lock);
+  latest_close_slot_locked (rhc);
+  const bool ret = add_readcondition_locked (rhc->def, cond);
+  latest_try_open_slot_locked (rhc);
+  ddsrt_mutex_unlock (&rhc->def->lock);
+  return ret;
+}
+
+static void dds_rhc_latest_remove_readcondition (struct dds_rhc *rhc_common, dds_readcond *cond)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  ddsrt_mutex_lock (&rhc->def->lock);
+  latest_close_slot_locked (rhc);
+  remove_readcondition_locked (rhc->def, cond);
+  latest_try_open_slot_locked (rhc);
+  ddsrt_mutex_unlock (&rhc->def->lock);
+}
+
+static int32_t latest_take_from_slot (struct dds_rhc_latest *rhc, struct rhc_latest_sample *ls, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg)
+{
+  const dds_sample_info_t si = {
+    .sample_state = DDS_NOT_READ_SAMPLE_STATE,
+    .view_state = DDS_NOT_NEW_VIEW_STATE,
+    .instance_state = DDS_ALIVE_INSTANCE_STATE,
+    .valid_data = true,
+    .source_timestamp = ls->sample->timestamp.v,
+    .instance_handle = ls->iid,
+    .publication_handle = ls->wrinfo.iid,
+    .disposed_generation_count = ls->disposed_gen,
+    .no_writers_generation_count = ls->no_writers_gen,
+    .sample_rank = 0,
+    .generation_rank = 0,
+    .absolute_generation_rank = 0
+  };
+  const int32_t rc = collect_sample (collect_sample_arg, &si, rhc->def->type, ls->sample);
+  if (rc < 0)
+  {
+    /* Put it back, like the default RHC leaves it in place, unless the state has changed
+       in the meantime: then it might as well have been replaced by a newer sample */
+    ddsrt_mutex_lock (&rhc->def->lock);
+    if (ddsrt_atomic_ldvoidp (&rhc->slot) == NULL && ls->iid == rhc->inst->iid && ls->wrinfo.iid == rhc->inst->wr_iid)
+    {
+      ddsrt_atomic_stvoidp (&rhc->slot, ls);
+      ls = NULL;
+    }
+    ddsrt_mutex_unlock (&rhc->def->lock);
+  }
+  if (ls)
+    free_latest_sample (ls);
+  return (rc < 0) ? rc : 1;
+}
+
+static int32_t dds_rhc_latest_readtake (struct dds_rhc_latest *rhc, bool take, bool mark_as_read, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  int32_t limit = max_samples;
+  const struct readtake_w_qminv_inst_state state =
+    make_readtake_w_qminv_inst_state (rhc->def, &limit, mask, cond, collect_sample, collect_sample_arg);
+  ddsrt_mutex_lock (&rhc->def->lock);
+  latest_close_slot_locked (rhc);
+  const dds_return_t rc = take ? take_w_qminv_locked (&state, handle, next_instance) : read_w_qminv_locked (&state, mark_as_read, handle, next_instance);
+  latest_try_open_slot_locked (rhc);
+  ddsrt_mutex_unlock (&rhc->def->lock);
+  return (rc < 0 && limit == max_samples) ? rc : (max_samples - limit);
+}
+
+static int32_t dds_rhc_latest_peek (struct dds_rhc *rhc_common, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  return dds_rhc_latest_readtake ((struct dds_rhc_latest *) rhc_common, false, false, max_samples, mask, handle, cond, collect_sample, collect_sample_arg, next_instance);
+}
+
+static int32_t dds_rhc_latest_read (struct dds_rhc *rhc_common, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  return dds_rhc_latest_readtake ((struct dds_rhc_latest *) rhc_common, false, true, max_samples, mask, handle, cond, collect_sample, collect_sample_arg, next_instance);
+}
+
+static int32_t dds_rhc_latest_take (struct dds_rhc *rhc_common, int32_t max_samples, uint32_t mask, dds_instance_handle_t handle, dds_readcond *cond, dds_read_with_collector_fn_t collect_sample, void *collect_sample_arg, bool next_instance)
+{
+  struct dds_rhc_latest * const rhc = (struct dds_rhc_latest *) rhc_common;
+  if (cond == NULL && handle == 0 && !next_instance)
+  {
+    const bool match = (qmask_from_mask_n_cond (mask, NULL) & LATEST_SLOT_QMASK) == 0;
+    void *v = ddsrt_atomic_ldvoidp (&rhc->slot);
+    while (v != LATEST_SLOT_CLOSED)
+    {
+      if (v == NULL || !match)
+        return 0;
+      else if (ddsrt_atomic_casvoidp (&rhc->slot, v, NULL))
+        return latest_take_from_slot (rhc, v, collect_sample, collect_sample_arg);
+      v = ddsrt_atomic_ldvoidp (&rhc->slot);
+    }
+  }
+  return dds_rhc_latest_readtake (rhc, true, true, max_samples, mask, handle, cond, collect_sample, collect_sample_arg, next_instance);
+}
+
+struct dds_rhc *dds_rhc_latest_new_xchecks (struct ddsi_domaingv *gv, const struct ddsi_sertype *type, const dds_qos_t *qos, bool xchecks)
+{
+  assert (!type->has_key);
+  assert (qos->history.kind == DDS_HISTORY_KEEP_LAST && qos->history.depth == 1);
+  struct dds_rhc_latest *rhc = ddsrt_malloc (sizeof (*rhc));
+  memset (rhc, 0, sizeof (*rhc));
+  rhc->common.common.ops = &dds_rhc_latest_ops;
+  ddsrt_atomic_stvoidp (&rhc->slot, LATEST_SLOT_CLOSED);
+  rhc->inst = NULL;
+  rhc->def = (struct dds_rhc_default *) dds_rhc_default_new_xchecks (gv, type, qos, xchecks);
+  return &rhc->common;
+}
+
 /*************************
  ******    CHECK    ******
  *************************/
@@ -3065,8 +3684,14 @@ static bool rhc_check_counts_locked (struct dds_rhc_default *rhc, bool check_con
 
   if (check_conds)
   {
+    /* the trigger of a condition on a sharded RHC is the sum of the contributions of all shards */
     for (i = 0, rciter = rhc->conds; rciter && i < ncheck; i++, rciter = rciter->m_next)
-      assert (cond_match_count[i] == ddsrt_atomic_ld32 (&rciter->m_entity.m_status.m_trigger));
+    {
+      if (rhc->is_shard)
+        assert (cond_match_count[i] <= ddsrt_atomic_ld32 (&rciter->m_entity.m_status.m_trigger));
+      else
+        assert (cond_match_count[i] == ddsrt_atomic_ld32 (&rciter->m_entity.m_status.m_trigger));
+    }
   }
 
   if (rhc->n_nonempty_instances == 0)
@@ -3111,3 +3736,35 @@ static const struct dds_rhc_ops dds_rhc_default_ops = {
   .remove_readcondition = dds_rhc_default_remove_readcondition,
   .associate = dds_rhc_default_associate
 };
+
+static const struct dds_rhc_ops dds_rhc_sharded_ops = {
+  .rhc_ops = {
+    .store = dds_rhc_sharded_store,
+    .unregister_wr = dds_rhc_sharded_unregister_wr,
+    .relinquish_ownership = dds_rhc_sharded_relinquish_ownership,
+    .free = dds_rhc_sharded_free,
+    .get_state = dds_rhc_sharded_get_state
+  },
+  .peek = dds_rhc_sharded_peek,
+  .read = dds_rhc_sharded_read,
+  .take = dds_rhc_sharded_take,
+  .add_readcondition = dds_rhc_sharded_add_readcondition,
+  .remove_readcondition = dds_rhc_sharded_remove_readcondition,
+  .associate = dds_rhc_sharded_associate
+};
+
+static const struct dds_rhc_ops dds_rhc_latest_ops = {
+  .rhc_ops = {
+    .store = dds_rhc_latest_store,
+    .unregister_wr = dds_rhc_latest_unregister_wr,
+    .relinquish_ownership = dds_rhc_latest_relinquish_ownership,
+    .free = dds_rhc_latest_free,
+    .get_state = dds_rhc_latest_get_state
+  },
+  .peek = dds_rhc_latest_peek,
+  .read = dds_rhc_latest_read,
+  .take = dds_rhc_latest_take,
+  .add_readcondition = dds_rhc_latest_add_readcondition,
+  .remove_readcondition = dds_rhc_latest_remove_readcondition,
+  .associate = dds_rhc_latest_associate
+};
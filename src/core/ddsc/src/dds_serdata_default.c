@@ -62,6 +62,14 @@
   - otherwise:
       - `d->c.loan` null pointer
       - `d->data` points to a local copy
+
+  In case of `serdata_default_from_ser` for a large sample received in a single fragment (or reassembled
+  contiguously, see Internal/DefragContiguousThreshold) and in native byte order (see
+  General/ZeroCopyReceiveThreshold), it may reference the receive buffer instead of copying the data:
+  - `d->rmsg` points to the message in the receive buffer, which is kept alive until `d` is freed
+  - the CDR header and the serialized data are at offset `d->rmsg_off` in that message
+  - `d->pos` is the size of the serialized data, `d->data` is not used
+  (it does not use a loan, because those have a specific meaning when writing)
 */
 
 
@@ -76,6 +84,20 @@
 
 static void serdata_default_get_keyhash (const struct ddsi_serdata *serdata_common, struct ddsi_keyhash *buf, bool force_md5);
 
+static char *serdata_default_cdr (const struct dds_serdata_default *d)
+{
+  // the CDR header immediately precedes the data, also in the receive buffer
+  if (d->rmsg)
+    return (char *) DDSI_RMSG_PAYLOADOFF (d->rmsg, d->rmsg_off);
+  else
+    return (char *) &d->hdr;
+}
+
+static char *serdata_default_data (const struct dds_serdata_default *d)
+{
+  return serdata_default_cdr (d) + sizeof (struct dds_cdr_header);
+}
+
 #ifndef NDEBUG
 static int ispowerof2_size (size_t x)
 {
@@ -182,6 +204,8 @@ static void serdata_default_free(struct ddsi_serdata *dcmn)
     ddsrt_free (d->key.u.dynbuf);
   if (d->c.loan)
     dds_loaned_sample_unref (d->c.loan);
+  if (d->rmsg)
+    ddsi_rmsg_unpin (d->rmsg);
   if (d->size > MAX_SIZE_FOR_POOL || !ddsi_freelist_push (&d->serpool->freelist, d))
     dds_free (d);
 }
@@ -200,6 +224,8 @@ static void serdata_default_init(struct dds_serdata_default *d, const struct dds
   d->hdr.options = 0;
   d->key.buftype = KEYBUFTYPE_UNSET;
   d->key.keysize = 0;
+  d->rmsg = NULL;
+  d->rmsg_off = 0;
 }
 
 static struct dds_serdata_default *serdata_default_allocnew (struct dds_serdatapool *serpool, uint32_t init_size)
@@ -355,6 +381,37 @@ enum from_ser_result {
 static enum from_ser_result serdata_default_from_ser_common (const struct ddsi_sertype *tpcmn, enum ddsi_serdata_kind kind, const struct ddsi_rdata *fragchain, size_t size, struct dds_serdata_default **sd_out)
   ddsrt_nonnull_all;
 
+static struct dds_serdata_default *serdata_default_from_ser_borrow (const struct dds_sertype_default *tp, enum ddsi_serdata_kind kind, const struct ddsi_rdata *fragchain, uint32_t size)
+{
+  // Referencing the data in place requires it to be contiguous, suitably aligned for
+  // the stream functions, and not in need of byte swapping (which would modify the
+  // receive buffer while it might still be in use for other readers).  Any fragments
+  // following one that covers everything add no data.
+  const unsigned char *payload = DDSI_RMSG_PAYLOADOFF (fragchain->rmsg, DDSI_RDATA_PAYLOAD_OFF (fragchain));
+  struct dds_cdr_header hdr;
+  if (fragchain->maxp1 != size)
+    return NULL;
+  if (((uintptr_t) payload % 4) != 0)
+    return NULL;
+  memcpy (&hdr, payload, sizeof (hdr));
+  if (!is_valid_xcdr_id (hdr.identifier) || !DDSI_RTPS_CDR_ENC_IS_NATIVE (hdr.identifier))
+    return NULL;
+  if (!ddsi_rmsg_pin (fragchain->rmsg, size))
+    return NULL;
+
+  struct dds_serdata_default *d;
+  if ((d = serdata_default_new_size (tp, kind, 0, DDSI_RTPS_CDR_ENC_VERSION_UNDEF)) == NULL)
+  {
+    ddsi_rmsg_unpin (fragchain->rmsg);
+    return NULL;
+  }
+  d->rmsg = fragchain->rmsg;
+  d->rmsg_off = DDSI_RDATA_PAYLOAD_OFF (fragchain);
+  d->hdr = hdr;
+  d->pos = size - (uint32_t) sizeof (hdr);
+  return d;
+}
+
 static enum from_ser_result serdata_default_from_ser_common (const struct ddsi_sertype *tpcmn, enum ddsi_serdata_kind kind, const struct ddsi_rdata *fragchain, size_t size, struct dds_serdata_default **sd_out)
 {
   const struct dds_sertype_default *tp = (const struct dds_sertype_default *)tpcmn;
@@ -365,30 +422,37 @@ static enum from_ser_result serdata_default_from_ser_common (const struct ddsi_s
      serdata */
   if (size > UINT32_MAX - offsetof (struct dds_serdata_default, hdr))
     return FROM_SER_ERROR;
-  struct dds_serdata_default *d = serdata_default_new_size (tp, kind, (uint32_t) size, DDSI_RTPS_CDR_ENC_VERSION_UNDEF);
-  if (d == NULL)
-    return FROM_SER_OUT_OF_MEMORY;
-
-  uint32_t off = 4; /* must skip the CDR header */
 
   assert (fragchain->min == 0);
-  assert (fragchain->maxp1 >= off); /* CDR header must be in first fragment */
+  assert (fragchain->maxp1 >= 4); /* CDR header must be in first fragment */
 
-  memcpy (&d->hdr, DDSI_RMSG_PAYLOADOFF (fragchain->rmsg, DDSI_RDATA_PAYLOAD_OFF (fragchain)), sizeof (d->hdr));
-  if (!is_valid_xcdr_id (d->hdr.identifier))
-    goto err;
-
-  for (const struct ddsi_rdata *frag = fragchain; frag != NULL; frag = frag->nextfrag)
+  struct dds_serdata_default *d;
+  char *data;
+  if ((d = serdata_default_from_ser_borrow (tp, kind, fragchain, (uint32_t) size)) != NULL)
+    data = serdata_default_data (d);
+  else
   {
-    assert (frag->min <= off);
-    assert (frag->maxp1 <= size);
-    if (frag->maxp1 > off)
+    if ((d = serdata_default_new_size (tp, kind, (uint32_t) size, DDSI_RTPS_CDR_ENC_VERSION_UNDEF)) == NULL)
+      return FROM_SER_OUT_OF_MEMORY;
+
+    uint32_t off = 4; /* must skip the CDR header */
+    memcpy (&d->hdr, DDSI_RMSG_PAYLOADOFF (fragchain->rmsg, DDSI_RDATA_PAYLOAD_OFF (fragchain)), sizeof (d->hdr));
+    if (!is_valid_xcdr_id (d->hdr.identifier))
+      goto err;
+
+    for (const struct ddsi_rdata *frag = fragchain; frag != NULL; frag = frag->nextfrag)
     {
-      /* only copy if this fragment adds data */
-      const unsigned char *payload = DDSI_RMSG_PAYLOADOFF (frag->rmsg, DDSI_RDATA_PAYLOAD_OFF (frag));
-      serdata_default_append_blob (&d, frag->maxp1 - off, payload + off - frag->min);
-      off = frag->maxp1;
+      assert (frag->min <= off);
+      assert (frag->maxp1 <= size);
+      if (frag->maxp1 > off)
+      {
+        /* only copy if this fragment adds data */
+        const unsigned char *payload = DDSI_RMSG_PAYLOADOFF (frag->rmsg, DDSI_RDATA_PAYLOAD_OFF (frag));
+        serdata_default_append_blob (&d, frag->maxp1 - off, payload + off - frag->min);
+        off = frag->maxp1;
+      }
     }
+    data = d->data;
   }
 
   const bool needs_bswap = !DDSI_RTPS_CDR_ENC_IS_NATIVE (d->hdr.identifier);
@@ -405,7 +469,7 @@ static enum from_ser_result serdata_default_from_ser_common (const struct ddsi_s
   if (d->pos < pad)
     nres = DDS_STREAM_NORMALIZE_ERROR;
   else
-    nres = dds_stream_normalize_to_istream (&is, d->data, d->pos - pad, needs_bswap, xcdr_version, &tp->type, kind == SDK_KEY, &actual_size);
+    nres = dds_stream_normalize_to_istream (&is, data, d->pos - pad, needs_bswap, xcdr_version, &tp->type, kind == SDK_KEY, &actual_size);
   switch (nres)
   {
     case DDS_STREAM_NORMALIZE_SUCCESS:
@@ -561,6 +625,35 @@ static struct ddsi_serdata *serdata_default_from_ser_iov_nokey (const struct dds
   return NULL;
 }
 
+struct ddsi_serdata *dds_serdata_default_from_ser_well_formed (const struct ddsi_sertype *tpcmn, enum ddsi_serdata_kind kind, const void *cdr, size_t size)
+{
+  const struct dds_sertype_default *tp = (const struct dds_sertype_default *)tpcmn;
+  if (size < 4 || size > UINT32_MAX - offsetof (struct dds_serdata_default, hdr))
+    return NULL;
+  struct dds_serdata_default *d = serdata_default_new_size (tp, kind, (uint32_t) size, DDSI_RTPS_CDR_ENC_VERSION_UNDEF);
+  if (d == NULL)
+    return NULL;
+  memcpy (&d->hdr, cdr, sizeof (d->hdr));
+  if (!is_valid_xcdr_id (d->hdr.identifier) || !DDSI_RTPS_CDR_ENC_IS_NATIVE (d->hdr.identifier))
+    goto err;
+  serdata_default_append_blob (&d, size - 4, (const char *) cdr + 4);
+
+  /* no normalization: only the key needs to be extracted */
+  const uint32_t pad = ddsrt_fromBE2u (d->hdr.options) & DDS_CDR_HDR_PADDING_MASK;
+  const uint32_t xcdr_version = ddsi_sertype_enc_id_xcdr_version (d->hdr.identifier);
+  dds_istream_t is;
+  if (d->pos < pad)
+    goto err;
+  dds_istream_init_well_formed (&is, d->pos - pad, d->data, xcdr_version);
+  if (!gen_serdata_key_from_cdr (&is, &d->key, tp, kind == SDK_KEY))
+    goto err;
+  return tpcmn->has_key ? fix_serdata_default (d, tpcmn->serdata_basehash) : fix_serdata_default_nokey (d, tpcmn->serdata_basehash);
+
+err:
+  ddsi_serdata_unref (&d->c);
+  return NULL;
+}
+
 static struct ddsi_serdata *serdata_default_from_keyhash_cdr (const struct ddsi_sertype *tpcmn, const ddsi_keyhash_t *keyhash)
 {
   const struct dds_sertype_default *tp = (const struct dds_sertype_default *)tpcmn;
@@ -600,6 +693,12 @@ static void istream_from_serdata_default (dds_istream_t *s, const struct dds_ser
     s->m_index = 0;
     s->m_size = d->c.loan->metadata->sample_size;
   }
+  else if (d->rmsg)
+  {
+    s->m_buffer = (const unsigned char *) serdata_default_data (d);
+    s->m_index = 0;
+    s->m_size = d->pos;
+  }
   else
   {
     s->m_buffer = (const unsigned char *) d;
@@ -772,7 +871,7 @@ static void serdata_default_to_ser (const struct ddsi_serdata *serdata_common, s
   const struct dds_serdata_default *d = (const struct dds_serdata_default *)serdata_common;
   assert (off < d->pos + sizeof(struct dds_cdr_header));
   assert (sz <= alignup_size (d->pos + sizeof(struct dds_cdr_header), 4) - off);
-  memcpy (buf, (char *)&d->hdr + off, sz);
+  memcpy (buf, serdata_default_cdr (d) + off, sz);
 }
 
 static struct ddsi_serdata *serdata_default_to_ser_ref (const struct ddsi_serdata *serdata_common, size_t off, size_t sz, ddsrt_iovec_t *ref)
@@ -780,7 +879,7 @@ static struct ddsi_serdata *serdata_default_to_ser_ref (const struct ddsi_serdat
   const struct dds_serdata_default *d = (const struct dds_serdata_default *)serdata_common;
   assert (off < d->pos + sizeof(struct dds_cdr_header));
   assert (sz <= alignup_size (d->pos + sizeof(struct dds_cdr_header), 4) - off);
-  ref->iov_base = (char *)&d->hdr + off;
+  ref->iov_base = serdata_default_cdr (d) + off;
   ref->iov_len = (ddsrt_iov_len_t)sz;
   return ddsi_serdata_ref(serdata_common);
 }
@@ -817,6 +916,22 @@ static bool serdata_default_to_sample_cdr (const struct ddsi_serdata *serdata_co
   return true; /* FIXME: can't conversion to sample fail? */
 }
 
+bool dds_serdata_default_extract_members (const struct ddsi_serdata *serdata_common, uint32_t n, const uint32_t *offsets, struct dds_cdrstream_member_value *values)
+{
+  const struct dds_serdata_default *d = (const struct dds_serdata_default *)serdata_common;
+  const struct dds_sertype_default *tp = (const struct dds_sertype_default *) d->c.type;
+  dds_istream_t is;
+  if (d->c.kind != SDK_DATA)
+    return false;
+  if (d->c.loan != NULL &&
+      d->c.loan->metadata->sample_state != DDS_LOANED_SAMPLE_STATE_SERIALIZED_DATA)
+    return false;
+  assert (DDSI_RTPS_CDR_ENC_IS_NATIVE (d->hdr.identifier));
+  istream_from_serdata_default (&is, d);
+  dds_stream_extract_members (&is, &tp->type, n, offsets, values);
+  return true;
+}
+
 static bool serdata_default_untyped_to_sample_cdr (const struct ddsi_sertype *sertype_common, const struct ddsi_serdata *serdata_common, void *sample, void **bufptr, void *buflim)
 {
   const struct dds_serdata_default *d = (const struct dds_serdata_default *)serdata_common;
@@ -40,6 +40,8 @@
 #include "dds__serdata_builtintopic.h"
 #include "dds__serdata_default.h"
 #include "dds__psmx.h"
+#include "dds__topic_filter.h"
+#include "dds/ddsi/ddsi_content_filter.h"
 
 DECL_ENTITY_LOCK_UNLOCK (dds_topic)
 
@@ -239,6 +241,9 @@ static void dds_topic_close (dds_entity *e)
   ddsi_type_unref_sertype (&e->m_domain->gv, tp->m_stype);
 #endif
   dds_free (tp->m_name);
+  if (tp->m_member_filter)
+    dds_topic_member_filter_free (tp->m_member_filter);
+  ddsi_content_filter_property_free (tp->m_content_filter);
 
   ddsrt_mutex_lock (&pp->m_entity.m_mutex);
 
@@ -960,6 +965,77 @@ dds_entity_t dds_find_topic_scoped (dds_find_scope_t scope, dds_entity_t partici
   return dds_find_topic_impl (scope, participant, name, NULL, timeout);
 }
 
+static void pushdown_content_filter (dds_entity *e, dds_topic *tp)
+{
+  /* on input: both entities pinned but no mutexes held */
+  switch (dds_entity_kind (e))
+  {
+    case DDS_KIND_READER: {
+      dds_reader *rd = (dds_reader *) e;
+      if (rd->m_topic != tp)
+        break;
+      /* may lock topic while holding reader lock; reading the filter at this point means
+         the last of several concurrent changes is the one that gets advertised */
+      ddsrt_mutex_lock (&rd->m_entity.m_mutex);
+      ddsrt_mutex_lock (&tp->m_entity.m_mutex);
+      struct ddsi_content_filter_property *cf = tp->m_content_filter ? ddsi_content_filter_property_dup (tp->m_content_filter) : NULL;
+      ddsrt_mutex_unlock (&tp->m_entity.m_mutex);
+      ddsi_thread_state_awake (ddsi_lookup_thread_state (), &rd->m_entity.m_domain->gv);
+      ddsi_update_reader_content_filter (rd->m_rd, cf);
+      ddsi_thread_state_asleep (ddsi_lookup_thread_state ());
+      ddsrt_mutex_unlock (&rd->m_entity.m_mutex);
+      ddsi_content_filter_property_free (cf);
+      break;
+    }
+    case DDS_KIND_PARTICIPANT:
+    case DDS_KIND_SUBSCRIBER: {
+      struct dds_entity *c;
+      dds_instance_handle_t last_iid = 0;
+      ddsrt_mutex_lock (&e->m_mutex);
+      while ((c = ddsrt_avl_lookup_succ (&dds_entity_children_td, &e->m_children, &last_iid)) != NULL)
+      {
+        struct dds_entity *x;
+        last_iid = c->m_iid;
+        if (dds_entity_pin (c->m_hdllink.hdl, &x) == DDS_RETCODE_OK)
+        {
+          assert (x == c);
+          /* see dds_get_children for why "c" remains valid despite unlocking m_mutex */
+          ddsrt_mutex_unlock (&e->m_mutex);
+          pushdown_content_filter (c, tp);
+          ddsrt_mutex_lock (&e->m_mutex);
+          dds_entity_unpin (c);
+        }
+      }
+      ddsrt_mutex_unlock (&e->m_mutex);
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+static void dds_topic_unlock_and_pushdown_content_filter (dds_topic *t, bool changed)
+{
+  /* The filter expression is advertised by the readers of the topic so that remote writers
+     can apply it, a change must therefore be pushed down to the readers.  That requires
+     locking the readers, which isn't allowed while holding the topic lock. */
+  if (!changed)
+  {
+    dds_topic_unlock (t);
+    return;
+  }
+  ddsrt_mutex_unlock (&t->m_entity.m_mutex);
+  dds_entity *pp;
+  assert (dds_entity_kind (t->m_entity.m_parent) == DDS_KIND_PARTICIPANT);
+  if (dds_entity_pin (t->m_entity.m_parent->m_hdllink.hdl, &pp) == DDS_RETCODE_OK)
+  {
+    pushdown_content_filter (pp, t);
+    dds_entity_unpin (pp);
+  }
+  dds_entity_unpin (&t->m_entity);
+}
+
 dds_return_t dds_set_topic_filter_extended (dds_entity_t topic, const struct dds_topic_filter *filter)
 {
   struct dds_topic_filter f;
@@ -991,6 +1067,11 @@ dds_return_t dds_set_topic_filter_extended (dds_entity_t topic, const struct dds
         // can safely use any of the function pointers
         valid = (filter->f.sample != NULL);
         break;
+      case DDS_TOPIC_FILTER_MEMBERS:
+      case DDS_TOPIC_FILTER_EXPRESSION:
+        // only via dds_set_topic_filter_members/dds_set_topic_filter_expression
+        valid = false;
+        break;
     }
     if (!valid)
     {
@@ -1001,11 +1082,93 @@ dds_return_t dds_set_topic_filter_extended (dds_entity_t topic, const struct dds
 
   if ((rc = dds_topic_lock (topic, &t)) != DDS_RETCODE_OK)
     return rc;
+  const bool content_filter_changed = (t->m_content_filter != NULL);
   t->m_filter = f;
-  dds_topic_unlock (t);
+  if (t->m_member_filter)
+  {
+    dds_topic_member_filter_free (t->m_member_filter);
+    t->m_member_filter = NULL;
+  }
+  ddsi_content_filter_property_free (t->m_content_filter);
+  t->m_content_filter = NULL;
+  dds_topic_unlock_and_pushdown_content_filter (t, content_filter_changed);
   return DDS_RETCODE_OK;
 }
 
+dds_return_t dds_set_topic_filter_members (dds_entity_t topic, uint32_t npredicates, const dds_topic_filter_member_predicate_t *predicates)
+{
+  struct dds_topic_member_filter *mf;
+  dds_topic *t;
+  dds_return_t rc;
+
+  if (npredicates == 0)
+  {
+    const struct dds_topic_filter f = { .mode = DDS_TOPIC_FILTER_NONE };
+    return dds_set_topic_filter_extended (topic, &f);
+  }
+  if (predicates == NULL)
+    return DDS_RETCODE_BAD_PARAMETER;
+
+  if ((rc = dds_topic_lock (topic, &t)) != DDS_RETCODE_OK)
+    return rc;
+  bool content_filter_changed = false;
+  if ((rc = dds_topic_member_filter_new (&mf, t->m_stype, npredicates, predicates)) == DDS_RETCODE_OK)
+  {
+    content_filter_changed = (t->m_content_filter != NULL);
+    if (t->m_member_filter)
+      dds_topic_member_filter_free (t->m_member_filter);
+    ddsi_content_filter_property_free (t->m_content_filter);
+    t->m_member_filter = mf;
+    t->m_content_filter = NULL;
+    t->m_filter.mode = DDS_TOPIC_FILTER_MEMBERS;
+    t->m_filter.f.sample = NULL;
+    t->m_filter.arg = NULL;
+  }
+  dds_topic_unlock_and_pushdown_content_filter (t, content_filter_changed);
+  return rc;
+}
+
+dds_return_t dds_set_topic_filter_expression (dds_entity_t topic, const char *expression, uint32_t nparams, const char * const *params)
+{
+  struct dds_topic_member_filter *mf;
+  dds_topic *t;
+  dds_return_t rc;
+
+  if (expression == NULL)
+  {
+    const struct dds_topic_filter f = { .mode = DDS_TOPIC_FILTER_NONE };
+    return dds_set_topic_filter_extended (topic, &f);
+  }
+  if (nparams > 0 && params == NULL)
+    return DDS_RETCODE_BAD_PARAMETER;
+
+  if ((rc = dds_topic_lock (topic, &t)) != DDS_RETCODE_OK)
+    return rc;
+  bool content_filter_changed = false;
+  if ((rc = dds_topic_expression_filter_new (&mf, t->m_stype, expression, nparams, params)) == DDS_RETCODE_OK)
+  {
+    /* there is no content-filtered topic entity, so the topic name doubles as its name */
+    ddsi_content_filter_property_t prop = {
+      .content_filtered_topic_name = t->m_name,
+      .related_topic_name = t->m_name,
+      .filter_class_name = DDSI_CONTENT_FILTER_CLASS_SQL,
+      .filter_expression = (char *) expression,
+      .expression_parameters = { .n = nparams, .strs = (char **) params }
+    };
+    content_filter_changed = !ddsi_content_filter_property_equal (t->m_content_filter, &prop);
+    if (t->m_member_filter)
+      dds_topic_member_filter_free (t->m_member_filter);
+    ddsi_content_filter_property_free (t->m_content_filter);
+    t->m_member_filter = mf;
+    t->m_content_filter = ddsi_content_filter_property_dup (&prop);
+    t->m_filter.mode = DDS_TOPIC_FILTER_EXPRESSION;
+    t->m_filter.f.sample = NULL;
+    t->m_filter.arg = NULL;
+  }
+  dds_topic_unlock_and_pushdown_content_filter (t, content_filter_changed);
+  return rc;
+}
+
 dds_return_t dds_set_topic_filter_and_arg (dds_entity_t topic, dds_topic_filter_arg_fn filter, void *arg)
 {
   struct dds_topic_filter f = {
@@ -1049,6 +1212,8 @@ dds_return_t dds_get_topic_filter_and_arg (dds_entity_t topic, dds_topic_filter_
     case DDS_TOPIC_FILTER_SAMPLE:
     case DDS_TOPIC_FILTER_SAMPLEINFO_ARG:
     case DDS_TOPIC_FILTER_SAMPLE_SAMPLEINFO_ARG:
+    case DDS_TOPIC_FILTER_MEMBERS:
+    case DDS_TOPIC_FILTER_EXPRESSION:
       rc = DDS_RETCODE_PRECONDITION_NOT_MET;
       break;
   }
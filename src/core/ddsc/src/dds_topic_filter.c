@@ -0,0 +1,889 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <assert.h>
+#include <ctype.h>
+#include <float.h>
+#include <string.h>
+#include <math.h>
+
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/string.h"
+#include "dds/ddsrt/strtod.h"
+#include "dds/ddsrt/strtol.h"
+#include "dds/ddsi/ddsi_sertype.h"
+#include "dds/ddsi/ddsi_serdata.h"
+#include "dds/ddsi/ddsi_typelib.h"
+#include "dds/ddsi/ddsi_content_filter.h"
+#include "dds/cdr/dds_cdrstream.h"
+#include "dds__serdata_default.h"
+#include "dds__topic_filter.h"
+
+enum member_kind {
+  MK_SIGNED,
+  MK_UNSIGNED,
+  MK_FLOAT32,
+  MK_FLOAT64,
+  MK_STRING_REF, /* char * in the sample */
+  MK_STRING_INLINE /* bounded string, char[] in the sample */
+};
+
+struct member {
+  uint32_t offset;
+  uint32_t size;
+  enum member_kind kind;
+};
+
+struct pred {
+  uint32_t member; /* index in dds_topic_member_filter::members */
+  enum dds_topic_filter_member_op op;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    struct { char *s; uint32_t len; } str;
+  } value;
+};
+
+/* The predicates are combined by a program in postfix notation, evaluated with a stack
+   of booleans. Each predicate occurs once, so the stack never holds more than npreds
+   entries. */
+enum filter_opcode {
+  FOP_PRED, /* push value of predicate arg */
+  FOP_NOT,
+  FOP_AND,
+  FOP_OR
+};
+
+struct filter_insn {
+  uint8_t opcode;
+  uint8_t arg;
+};
+
+#define FILTER_CODE_MAX (4 * DDS_TOPIC_FILTER_MEMBERS_MAX)
+
+struct dds_topic_member_filter {
+  const struct ddsi_sertype *type;
+  uint32_t nmembers;
+  uint32_t npreds;
+  uint32_t ncode;
+  uint32_t offsets[DDS_TOPIC_FILTER_MEMBERS_MAX]; /* distinct, for dds_stream_extract_members */
+  struct member members[DDS_TOPIC_FILTER_MEMBERS_MAX];
+  struct filter_insn code[FILTER_CODE_MAX];
+  struct pred preds[];
+};
+
+static void member_from_insn (struct member *m, uint32_t offset, uint32_t insn)
+{
+  m->offset = offset;
+  switch (DDS_OP_TYPE (insn))
+  {
+    case DDS_OP_VAL_BLN: case DDS_OP_VAL_1BY: m->size = 1; break;
+    case DDS_OP_VAL_2BY: m->size = 2; break;
+    case DDS_OP_VAL_4BY: m->size = 4; break;
+    case DDS_OP_VAL_8BY: m->size = 8; break;
+    case DDS_OP_VAL_ENU: m->size = 4; break; /* always a uint32_t in the sample */
+    case DDS_OP_VAL_BMK: m->size = DDS_OP_TYPE_SZ (insn); break;
+    default: m->size = 0; break;
+  }
+  switch (DDS_OP_TYPE (insn))
+  {
+    case DDS_OP_VAL_STR:
+      m->kind = MK_STRING_REF;
+      break;
+    case DDS_OP_VAL_BST:
+      m->kind = MK_STRING_INLINE;
+      break;
+    case DDS_OP_VAL_4BY: case DDS_OP_VAL_8BY:
+      if (insn & DDS_OP_FLAG_FP)
+      {
+        m->kind = (m->size == 4) ? MK_FLOAT32 : MK_FLOAT64;
+        break;
+      }
+      /* fall through */
+    case DDS_OP_VAL_1BY: case DDS_OP_VAL_2BY:
+      m->kind = (insn & DDS_OP_FLAG_SGN) ? MK_SIGNED : MK_UNSIGNED;
+      break;
+    default:
+      m->kind = MK_UNSIGNED;
+      break;
+  }
+}
+
+static dds_return_t member_filter_new_program (struct dds_topic_member_filter **filter, const struct ddsi_sertype *type, uint32_t npredicates, const dds_topic_filter_member_predicate_t *predicates, uint32_t ncode, const struct filter_insn *code)
+{
+  assert (npredicates > 0 && npredicates <= DDS_TOPIC_FILTER_MEMBERS_MAX);
+  assert (ncode > 0 && ncode <= FILTER_CODE_MAX);
+  for (uint32_t i = 0; i < npredicates; i++)
+  {
+    if ((uint32_t) predicates[i].op > (uint32_t) DDS_TOPIC_FILTER_MEMBER_GE)
+      return DDS_RETCODE_BAD_PARAMETER;
+  }
+  if (type->ops != &dds_sertype_ops_default)
+    return DDS_RETCODE_UNSUPPORTED;
+  const struct dds_sertype_default *tp = (const struct dds_sertype_default *) type;
+
+  struct dds_topic_member_filter *f = ddsrt_malloc (sizeof (*f) + npredicates * sizeof (f->preds[0]));
+  f->type = type;
+  f->nmembers = 0;
+  f->npreds = 0;
+  f->ncode = ncode;
+  memcpy (f->code, code, ncode * sizeof (*code));
+  for (uint32_t i = 0; i < npredicates; i++)
+  {
+    const dds_topic_filter_member_predicate_t *p = &predicates[i];
+    const uint32_t *insnp;
+    uint32_t m;
+    if ((insnp = dds_stream_find_member (&tp->type, p->offset)) == NULL)
+    {
+      dds_topic_member_filter_free (f);
+      return DDS_RETCODE_UNSUPPORTED;
+    }
+    for (m = 0; m < f->nmembers && f->offsets[m] != p->offset; m++)
+      ;
+    if (m == f->nmembers)
+    {
+      f->offsets[m] = p->offset;
+      member_from_insn (&f->members[m], p->offset, *insnp);
+      f->nmembers++;
+    }
+
+    struct pred * const q = &f->preds[f->npreds];
+    q->member = m;
+    q->op = p->op;
+    switch (f->members[m].kind)
+    {
+      case MK_SIGNED: q->value.i = p->value.i; break;
+      case MK_UNSIGNED: q->value.u = p->value.u; break;
+      case MK_FLOAT32:
+        /* compare with the nearest float, else "x = 0.1" never matches 0.1f */
+        q->value.d = (fabs (p->value.d) <= FLT_MAX) ? (double) (float) p->value.d : p->value.d;
+        break;
+      case MK_FLOAT64: q->value.d = p->value.d; break;
+      case MK_STRING_REF: case MK_STRING_INLINE:
+        if (p->value.s == NULL)
+        {
+          dds_topic_member_filter_free (f);
+          return DDS_RETCODE_BAD_PARAMETER;
+        }
+        q->value.str.s = ddsrt_strdup (p->value.s);
+        q->value.str.len = (uint32_t) strlen (p->value.s);
+        break;
+    }
+    f->npreds++;
+  }
+  *filter = f;
+  return DDS_RETCODE_OK;
+}
+
+dds_return_t dds_topic_member_filter_new (struct dds_topic_member_filter **filter, const struct ddsi_sertype *type, uint32_t npredicates, const dds_topic_filter_member_predicate_t *predicates)
+{
+  struct filter_insn code[FILTER_CODE_MAX];
+  uint32_t ncode = 0;
+  if (npredicates == 0 || npredicates > DDS_TOPIC_FILTER_MEMBERS_MAX)
+    return DDS_RETCODE_BAD_PARAMETER;
+  for (uint32_t i = 0; i < npredicates; i++)
+  {
+    code[ncode++] = (struct filter_insn) { FOP_PRED, (uint8_t) i };
+    if (i > 0)
+      code[ncode++] = (struct filter_insn) { FOP_AND, 0 };
+  }
+  return member_filter_new_program (filter, type, npredicates, predicates, ncode, code);
+}
+
+#ifdef DDS_HAS_TYPELIB
+
+/* Maximum nesting depth of a member referenced in a filter expression */
+#define EXPR_MEMBER_DEPTH_MAX 8
+
+enum expr_token_kind {
+  ETK_END,
+  ETK_ERROR,
+  ETK_IDENT,
+  ETK_INT,
+  ETK_FLOAT,
+  ETK_STRING, /* s, len exclude the quotes, embedded quotes are doubled */
+  ETK_PARAM,
+  ETK_LPAREN,
+  ETK_RPAREN,
+  ETK_RELOP,
+  ETK_AND,
+  ETK_OR,
+  ETK_NOT,
+  ETK_BETWEEN,
+  ETK_TRUE,
+  ETK_FALSE
+};
+
+struct expr_token {
+  enum expr_token_kind kind;
+  const char *s;
+  size_t len;
+  uint32_t param; /* ETK_PARAM */
+  enum dds_topic_filter_member_op op; /* ETK_RELOP */
+  size_t nquotes; /* ETK_STRING: number of '' pairs in s */
+};
+
+struct expr_operand {
+  bool is_member;
+  struct member m; /* iff is_member */
+  struct expr_token lit; /* iff !is_member */
+};
+
+struct expr_parser {
+  const char *pos;
+  struct expr_token tok;
+  const struct dds_sertype_default *type;
+  const struct ddsi_type *xtype;
+  uint32_t nparams;
+  const char * const *params;
+  uint32_t npreds;
+  dds_topic_filter_member_predicate_t preds[DDS_TOPIC_FILTER_MEMBERS_MAX];
+  char *strs[DDS_TOPIC_FILTER_MEMBERS_MAX]; /* string values of preds, if any */
+  uint32_t ncode;
+  struct filter_insn code[FILTER_CODE_MAX];
+  uint32_t depth; /* nesting of NOT and parentheses */
+};
+
+/* Maximum nesting of NOT and parentheses in a filter expression: the parser is recursive
+   and expressions may come from remote readers */
+#define EXPR_NESTING_MAX 32
+
+static bool expr_is_number_start (const char *s)
+{
+  if (*s == '-' || *s == '+')
+    s++;
+  if (*s == '.')
+    s++;
+  return isdigit ((unsigned char) *s);
+}
+
+static int32_t expr_int_base (const char *s)
+{
+  if (*s == '-' || *s == '+')
+    s++;
+  return (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) ? 16 : 10;
+}
+
+static const char *expr_lex (const char *pos, struct expr_token *t)
+{
+  static const struct { const char *s; enum expr_token_kind kind; } keywords[] = {
+    { "AND", ETK_AND }, { "OR", ETK_OR }, { "NOT", ETK_NOT }, { "BETWEEN", ETK_BETWEEN },
+    { "TRUE", ETK_TRUE }, { "FALSE", ETK_FALSE }
+  };
+  static const struct { const char *s; enum dds_topic_filter_member_op op; } relops[] = {
+    { "<>", DDS_TOPIC_FILTER_MEMBER_NE }, { "!=", DDS_TOPIC_FILTER_MEMBER_NE },
+    { "<=", DDS_TOPIC_FILTER_MEMBER_LE }, { ">=", DDS_TOPIC_FILTER_MEMBER_GE },
+    { "=", DDS_TOPIC_FILTER_MEMBER_EQ }, { "<", DDS_TOPIC_FILTER_MEMBER_LT },
+    { ">", DDS_TOPIC_FILTER_MEMBER_GT }
+  };
+  while (isspace ((unsigned char) *pos))
+    pos++;
+  t->s = pos;
+  t->len = 0;
+  t->nquotes = 0;
+  t->kind = ETK_ERROR;
+  if (*pos == 0)
+    t->kind = ETK_END;
+  else if (isalpha ((unsigned char) *pos) || *pos == '_')
+  {
+    while (isalnum ((unsigned char) pos[t->len]) || pos[t->len] == '_' || pos[t->len] == '.')
+      t->len++;
+    t->kind = ETK_IDENT;
+    for (size_t i = 0; i < sizeof (keywords) / sizeof (keywords[0]); i++)
+      if (strlen (keywords[i].s) == t->len && ddsrt_strncasecmp (pos, keywords[i].s, t->len) == 0)
+        t->kind = keywords[i].kind;
+  }
+  else if (expr_is_number_start (pos))
+  {
+    char *iend, *fend;
+    int64_t i;
+    double d;
+    (void) ddsrt_strtoint64 (pos, &iend, expr_int_base (pos), &i);
+    if (ddsrt_strtod (pos, &fend, &d) == DDS_RETCODE_OK && expr_int_base (pos) == 10 && fend > iend)
+    {
+      t->kind = ETK_FLOAT;
+      t->len = (size_t) (fend - pos);
+    }
+    else if (iend > pos)
+    {
+      t->kind = ETK_INT;
+      t->len = (size_t) (iend - pos);
+    }
+  }
+  else if (*pos == '\'')
+  {
+    /* a quote inside a string literal is written as two quotes, as in SQL */
+    const char *end = pos + 1;
+    size_t nquotes = 0;
+    while ((end = strchr (end, '\'')) != NULL && end[1] == '\'')
+    {
+      nquotes++;
+      end += 2;
+    }
+    if (end != NULL)
+    {
+      t->kind = ETK_STRING;
+      t->s = pos + 1;
+      t->len = (size_t) (end - t->s);
+      t->nquotes = nquotes;
+      return end + 1;
+    }
+  }
+  else if (*pos == '%' && isdigit ((unsigned char) pos[1]))
+  {
+    char *end;
+    uint64_t n;
+    if (ddsrt_strtouint64 (pos + 1, &end, 10, &n) == DDS_RETCODE_OK && n <= UINT32_MAX)
+    {
+      t->kind = ETK_PARAM;
+      t->param = (uint32_t) n;
+      t->len = (size_t) (end - pos);
+    }
+  }
+  else if (*pos == '(' || *pos == ')')
+  {
+    t->kind = (*pos == '(') ? ETK_LPAREN : ETK_RPAREN;
+    t->len = 1;
+  }
+  else
+  {
+    for (size_t i = 0; i < sizeof (relops) / sizeof (relops[0]); i++)
+    {
+      const size_t n = strlen (relops[i].s);
+      if (strncmp (pos, relops[i].s, n) == 0)
+      {
+        t->kind = ETK_RELOP;
+        t->op = relops[i].op;
+        t->len = n;
+        break;
+      }
+    }
+  }
+  return pos + t->len;
+}
+
+static void expr_next (struct expr_parser *p)
+{
+  p->pos = expr_lex (p->pos, &p->tok);
+}
+
+static dds_return_t expr_emit (struct expr_parser *p, enum filter_opcode opcode, uint32_t arg)
+{
+  if (p->ncode == FILTER_CODE_MAX)
+    return DDS_RETCODE_BAD_PARAMETER;
+  p->code[p->ncode++] = (struct filter_insn) { (uint8_t) opcode, (uint8_t) arg };
+  return DDS_RETCODE_OK;
+}
+
+static dds_return_t expr_member (struct expr_parser *p, const struct expr_token *t, struct member *m)
+{
+  uint32_t indices[EXPR_MEMBER_DEPTH_MAX], depth, offset;
+  char name[256];
+  dds_return_t rc;
+  const uint32_t *insnp;
+  if (t->len >= sizeof (name))
+    return DDS_RETCODE_BAD_PARAMETER;
+  memcpy (name, t->s, t->len);
+  name[t->len] = 0;
+  if ((rc = ddsi_type_get_member_path (p->xtype, name, EXPR_MEMBER_DEPTH_MAX, indices, &depth)) != DDS_RETCODE_OK)
+    return rc;
+  if ((insnp = dds_stream_find_member_by_index (&p->type->type, depth, indices, &offset)) == NULL)
+    return DDS_RETCODE_UNSUPPORTED;
+  member_from_insn (m, offset, *insnp);
+  return DDS_RETCODE_OK;
+}
+
+static dds_return_t expr_operand (struct expr_parser *p, struct expr_operand *o)
+{
+  dds_return_t rc = DDS_RETCODE_OK;
+  switch (p->tok.kind)
+  {
+    case ETK_IDENT:
+      o->is_member = true;
+      rc = expr_member (p, &p->tok, &o->m);
+      break;
+    case ETK_INT: case ETK_FLOAT: case ETK_STRING: case ETK_TRUE: case ETK_FALSE:
+      o->is_member = false;
+      o->lit = p->tok;
+      break;
+    case ETK_PARAM: {
+      if (p->tok.param >= p->nparams || p->params[p->tok.param] == NULL)
+        return DDS_RETCODE_BAD_PARAMETER;
+      const char *param = p->params[p->tok.param];
+      struct expr_token rest;
+      o->is_member = false;
+      (void) expr_lex (expr_lex (param, &o->lit), &rest);
+      if (rest.kind != ETK_END || !(o->lit.kind == ETK_INT || o->lit.kind == ETK_FLOAT || o->lit.kind == ETK_STRING || o->lit.kind == ETK_TRUE || o->lit.kind == ETK_FALSE))
+      {
+        /* anything that is not a single literal is taken as an unquoted string */
+        o->lit.kind = ETK_STRING;
+        o->lit.s = param;
+        o->lit.len = strlen (param);
+        o->lit.nquotes = 0;
+      }
+      break;
+    }
+    default:
+      return DDS_RETCODE_BAD_PARAMETER;
+  }
+  expr_next (p);
+  return rc;
+}
+
+static char *expr_string_value (const struct expr_token *t)
+{
+  assert (t->kind == ETK_STRING);
+  char *str = ddsrt_malloc (t->len - t->nquotes + 1);
+  size_t n = 0;
+  for (size_t i = 0; i < t->len; i++)
+  {
+    str[n++] = t->s[i];
+    if (t->s[i] == '\'' && t->nquotes > 0)
+      i++;
+  }
+  str[n] = 0;
+  return str;
+}
+
+static dds_return_t expr_literal_value (struct expr_parser *p, const struct member *m, const struct expr_token *t, dds_topic_filter_member_predicate_t *pred)
+{
+  char *end;
+  switch (m->kind)
+  {
+    case MK_SIGNED: case MK_UNSIGNED:
+      if (t->kind == ETK_TRUE || t->kind == ETK_FALSE)
+        pred->value.u = (t->kind == ETK_TRUE);
+      else if (t->kind == ETK_STRING && t->len - t->nquotes == 1)
+        pred->value.u = (unsigned char) t->s[0]; /* character */
+      else if (t->kind != ETK_INT)
+        return DDS_RETCODE_BAD_PARAMETER;
+      else if (m->kind == MK_SIGNED)
+      {
+        if (ddsrt_strtoint64 (t->s, &end, expr_int_base (t->s), &pred->value.i) != DDS_RETCODE_OK || end != t->s + t->len)
+          return DDS_RETCODE_BAD_PARAMETER;
+      }
+      else
+      {
+        if (t->s[0] == '-' || ddsrt_strtouint64 (t->s, &end, expr_int_base (t->s), &pred->value.u) != DDS_RETCODE_OK || end != t->s + t->len)
+          return DDS_RETCODE_BAD_PARAMETER;
+      }
+      return DDS_RETCODE_OK;
+    case MK_FLOAT32: case MK_FLOAT64:
+      if (t->kind == ETK_INT && expr_int_base (t->s) == 16)
+      {
+        int64_t x;
+        if (ddsrt_strtoint64 (t->s, &end, 16, &x) != DDS_RETCODE_OK)
+          return DDS_RETCODE_BAD_PARAMETER;
+        pred->value.d = (double) x;
+      }
+      else if (t->kind != ETK_INT && t->kind != ETK_FLOAT)
+        return DDS_RETCODE_BAD_PARAMETER;
+      else if (ddsrt_strtod (t->s, &end, &pred->value.d) != DDS_RETCODE_OK || end != t->s + t->len)
+        return DDS_RETCODE_BAD_PARAMETER;
+      return DDS_RETCODE_OK;
+    case MK_STRING_REF: case MK_STRING_INLINE:
+      if (t->kind != ETK_STRING)
+        return DDS_RETCODE_BAD_PARAMETER;
+      p->strs[p->npreds] = expr_string_value (t);
+      pred->value.s = p->strs[p->npreds];
+      return DDS_RETCODE_OK;
+  }
+  return DDS_RETCODE_BAD_PARAMETER;
+}
+
+static dds_return_t expr_add_pred (struct expr_parser *p, const struct member *m, enum dds_topic_filter_member_op op, const struct expr_token *lit)
+{
+  dds_return_t rc;
+  if (p->npreds == DDS_TOPIC_FILTER_MEMBERS_MAX)
+    return DDS_RETCODE_BAD_PARAMETER;
+  dds_topic_filter_member_predicate_t * const pred = &p->preds[p->npreds];
+  pred->offset = m->offset;
+  pred->op = op;
+  if ((rc = expr_literal_value (p, m, lit, pred)) != DDS_RETCODE_OK)
+    return rc;
+  return expr_emit (p, FOP_PRED, p->npreds++);
+}
+
+static enum dds_topic_filter_member_op expr_swap_op (enum dds_topic_filter_member_op op)
+{
+  switch (op)
+  {
+    case DDS_TOPIC_FILTER_MEMBER_LT: return DDS_TOPIC_FILTER_MEMBER_GT;
+    case DDS_TOPIC_FILTER_MEMBER_LE: return DDS_TOPIC_FILTER_MEMBER_GE;
+    case DDS_TOPIC_FILTER_MEMBER_GT: return DDS_TOPIC_FILTER_MEMBER_LT;
+    case DDS_TOPIC_FILTER_MEMBER_GE: return DDS_TOPIC_FILTER_MEMBER_LE;
+    default: return op;
+  }
+}
+
+/* comparison := operand relop operand | member [NOT] BETWEEN operand AND operand */
+static dds_return_t expr_comparison (struct expr_parser *p)
+{
+  struct expr_operand lhs, rhs, upper;
+  dds_return_t rc;
+  if ((rc = expr_operand (p, &lhs)) != DDS_RETCODE_OK)
+    return rc;
+  if (p->tok.kind == ETK_RELOP)
+  {
+    enum dds_topic_filter_member_op op = p->tok.op;
+    expr_next (p);
+    if ((rc = expr_operand (p, &rhs)) != DDS_RETCODE_OK)
+      return rc;
+    if (lhs.is_member == rhs.is_member)
+      return DDS_RETCODE_BAD_PARAMETER;
+    if (lhs.is_member)
+      return expr_add_pred (p, &lhs.m, op, &rhs.lit);
+    else
+      return expr_add_pred (p, &rhs.m, expr_swap_op (op), &lhs.lit);
+  }
+  else
+  {
+    const bool negate = (p->tok.kind == ETK_NOT);
+    if (negate)
+      expr_next (p);
+    if (p->tok.kind != ETK_BETWEEN || !lhs.is_member)
+      return DDS_RETCODE_BAD_PARAMETER;
+    expr_next (p);
+    if ((rc = expr_operand (p, &rhs)) != DDS_RETCODE_OK)
+      return rc;
+    if (p->tok.kind != ETK_AND)
+      return DDS_RETCODE_BAD_PARAMETER;
+    expr_next (p);
+    if ((rc = expr_operand (p, &upper)) != DDS_RETCODE_OK)
+      return rc;
+    if (rhs.is_member || upper.is_member)
+      return DDS_RETCODE_BAD_PARAMETER;
+    if ((rc = expr_add_pred (p, &lhs.m, DDS_TOPIC_FILTER_MEMBER_GE, &rhs.lit)) != DDS_RETCODE_OK ||
+        (rc = expr_add_pred (p, &lhs.m, DDS_TOPIC_FILTER_MEMBER_LE, &upper.lit)) != DDS_RETCODE_OK ||
+        (rc = expr_emit (p, FOP_AND, 0)) != DDS_RETCODE_OK)
+      return rc;
+    return negate ? expr_emit (p, FOP_NOT, 0) : DDS_RETCODE_OK;
+  }
+}
+
+static dds_return_t expr_or (struct expr_parser *p);
+
+/* factor := NOT factor | "(" or ")" | comparison */
+static dds_return_t expr_factor (struct expr_parser *p)
+{
+  dds_return_t rc;
+  switch (p->tok.kind)
+  {
+    case ETK_NOT:
+      if (p->depth == EXPR_NESTING_MAX)
+        return DDS_RETCODE_BAD_PARAMETER;
+      expr_next (p);
+      p->depth++;
+      rc = expr_factor (p);
+      p->depth--;
+      if (rc != DDS_RETCODE_OK)
+        return rc;
+      return expr_emit (p, FOP_NOT, 0);
+    case ETK_LPAREN:
+      if (p->depth == EXPR_NESTING_MAX)
+        return DDS_RETCODE_BAD_PARAMETER;
+      expr_next (p);
+      p->depth++;
+      rc = expr_or (p);
+      p->depth--;
+      if (rc != DDS_RETCODE_OK)
+        return rc;
+      if (p->tok.kind != ETK_RPAREN)
+        return DDS_RETCODE_BAD_PARAMETER;
+      expr_next (p);
+      return DDS_RETCODE_OK;
+    default:
+      return expr_comparison (p);
+  }
+}
+
+/* and := factor { AND factor } */
+static dds_return_t expr_and (struct expr_parser *p)
+{
+  dds_return_t rc;
+  if ((rc = expr_factor (p)) != DDS_RETCODE_OK)
+    return rc;
+  while (p->tok.kind == ETK_AND)
+  {
+    expr_next (p);
+    if ((rc = expr_factor (p)) != DDS_RETCODE_OK || (rc = expr_emit (p, FOP_AND, 0)) != DDS_RETCODE_OK)
+      return rc;
+  }
+  return DDS_RETCODE_OK;
+}
+
+/* or := and { OR and } */
+static dds_return_t expr_or (struct expr_parser *p)
+{
+  dds_return_t rc;
+  if ((rc = expr_and (p)) != DDS_RETCODE_OK)
+    return rc;
+  while (p->tok.kind == ETK_OR)
+  {
+    expr_next (p);
+    if ((rc = expr_and (p)) != DDS_RETCODE_OK || (rc = expr_emit (p, FOP_OR, 0)) != DDS_RETCODE_OK)
+      return rc;
+  }
+  return DDS_RETCODE_OK;
+}
+
+dds_return_t dds_topic_expression_filter_new (struct dds_topic_member_filter **filter, const struct ddsi_sertype *type, const char *expression, uint32_t nparams, const char * const *params)
+{
+  struct ddsi_domaingv * const gv = ddsrt_atomic_ldvoidp (&type->gv);
+  struct ddsi_type *xtype = NULL;
+  struct expr_parser *p;
+  dds_return_t rc;
+
+  if (nparams > 0 && params == NULL)
+    return DDS_RETCODE_BAD_PARAMETER;
+  if (type->ops != &dds_sertype_ops_default || gv == NULL)
+    return DDS_RETCODE_UNSUPPORTED;
+  if (ddsi_type_ref_local (gv, &xtype, type, DDSI_TYPEID_KIND_COMPLETE) != DDS_RETCODE_OK)
+    return DDS_RETCODE_UNSUPPORTED;
+
+  p = ddsrt_malloc (sizeof (*p));
+  p->pos = expression;
+  p->type = (const struct dds_sertype_default *) type;
+  p->xtype = xtype;
+  p->nparams = nparams;
+  p->params = params;
+  p->npreds = 0;
+  p->ncode = 0;
+  p->depth = 0;
+  memset (p->strs, 0, sizeof (p->strs));
+  expr_next (p);
+  if ((rc = expr_or (p)) == DDS_RETCODE_OK)
+  {
+    if (p->tok.kind != ETK_END)
+      rc = DDS_RETCODE_BAD_PARAMETER;
+    else
+      rc = member_filter_new_program (filter, type, p->npreds, p->preds, p->ncode, p->code);
+  }
+  for (uint32_t i = 0; i < DDS_TOPIC_FILTER_MEMBERS_MAX; i++)
+    ddsrt_free (p->strs[i]);
+  ddsrt_free (p);
+  ddsi_type_unref (gv, xtype);
+  return rc;
+}
+
+#else /* DDS_HAS_TYPELIB */
+
+dds_return_t dds_topic_expression_filter_new (struct dds_topic_member_filter **filter, const struct ddsi_sertype *type, const char *expression, uint32_t nparams, const char * const *params)
+{
+  (void) filter; (void) type; (void) expression; (void) nparams; (void) params;
+  return DDS_RETCODE_UNSUPPORTED;
+}
+
+#endif /* DDS_HAS_TYPELIB */
+
+void dds_topic_member_filter_free (struct dds_topic_member_filter *filter)
+{
+  for (uint32_t i = 0; i < filter->npreds; i++)
+  {
+    const enum member_kind kind = filter->members[filter->preds[i].member].kind;
+    if (kind == MK_STRING_REF || kind == MK_STRING_INLINE)
+      ddsrt_free (filter->preds[i].value.str.s);
+  }
+  ddsrt_free (filter);
+}
+
+static void values_from_sample (const struct dds_topic_member_filter *filter, const char *sample, struct dds_cdrstream_member_value *values)
+{
+  for (uint32_t i = 0; i < filter->nmembers; i++)
+  {
+    const struct member *m = &filter->members[i];
+    const char *addr = sample + m->offset;
+    values[i].present = true;
+    switch (m->kind)
+    {
+      case MK_STRING_REF: {
+        const char *s;
+        memcpy (&s, addr, sizeof (s));
+        values[i].v.str.s = s;
+        values[i].v.str.len = (s == NULL) ? 0 : (uint32_t) strlen (s);
+        break;
+      }
+      case MK_STRING_INLINE:
+        values[i].v.str.s = addr;
+        values[i].v.str.len = (uint32_t) strlen (addr);
+        break;
+      default:
+        switch (m->size)
+        {
+          case 1: { uint8_t x; memcpy (&x, addr, 1); values[i].v.u = x; break; }
+          case 2: { uint16_t x; memcpy (&x, addr, 2); values[i].v.u = x; break; }
+          case 4: { uint32_t x; memcpy (&x, addr, 4); values[i].v.u = x; break; }
+          default: { uint64_t x; memcpy (&x, addr, 8); values[i].v.u = x; break; }
+        }
+        break;
+    }
+  }
+}
+
+static int compare_member (const struct member *m, const struct dds_cdrstream_member_value *v, const struct pred *p, bool *unordered)
+{
+  *unordered = false;
+  switch (m->kind)
+  {
+    case MK_SIGNED: {
+      /* sign-extend */
+      const uint32_t shift = 64 - 8 * m->size;
+      const int64_t x = (int64_t) (v->v.u << shift) >> shift;
+      return (x > p->value.i) - (x < p->value.i);
+    }
+    case MK_UNSIGNED:
+      return (v->v.u > p->value.u) - (v->v.u < p->value.u);
+    case MK_FLOAT32: case MK_FLOAT64: {
+      double x;
+      if (m->kind == MK_FLOAT64)
+        memcpy (&x, &v->v.u, sizeof (x));
+      else
+      {
+        const uint32_t bits = (uint32_t) v->v.u;
+        float xf;
+        memcpy (&xf, &bits, sizeof (xf));
+        x = xf;
+      }
+      if (isnan (x) || isnan (p->value.d))
+      {
+        *unordered = true;
+        return 0;
+      }
+      return (x > p->value.d) - (x < p->value.d);
+    }
+    case MK_STRING_REF: case MK_STRING_INLINE: {
+      const uint32_t len = v->v.str.len, plen = p->value.str.len;
+      const int c = (len == 0 || plen == 0) ? 0 : memcmp (v->v.str.s, p->value.str.s, (len < plen) ? len : plen);
+      if (c != 0)
+        return (c > 0) - (c < 0);
+      return (len > plen) - (len < plen);
+    }
+  }
+  return 0;
+}
+
+static bool eval_pred (const struct dds_topic_member_filter *filter, const struct pred *p, const struct dds_cdrstream_member_value *values)
+{
+  bool unordered;
+  const int c = compare_member (&filter->members[p->member], &values[p->member], p, &unordered);
+  if (unordered)
+    return p->op == DDS_TOPIC_FILTER_MEMBER_NE;
+  switch (p->op)
+  {
+    case DDS_TOPIC_FILTER_MEMBER_EQ: return c == 0;
+    case DDS_TOPIC_FILTER_MEMBER_NE: return c != 0;
+    case DDS_TOPIC_FILTER_MEMBER_LT: return c < 0;
+    case DDS_TOPIC_FILTER_MEMBER_LE: return c <= 0;
+    case DDS_TOPIC_FILTER_MEMBER_GT: return c > 0;
+    case DDS_TOPIC_FILTER_MEMBER_GE: return c >= 0;
+  }
+  return false;
+}
+
+static bool eval_preds (const struct dds_topic_member_filter *filter, const struct dds_cdrstream_member_value *values)
+{
+  bool stack[DDS_TOPIC_FILTER_MEMBERS_MAX];
+  uint32_t sp = 0;
+  for (uint32_t i = 0; i < filter->ncode; i++)
+  {
+    const struct filter_insn insn = filter->code[i];
+    switch ((enum filter_opcode) insn.opcode)
+    {
+      case FOP_PRED:
+        assert (sp < DDS_TOPIC_FILTER_MEMBERS_MAX);
+        stack[sp++] = eval_pred (filter, &filter->preds[insn.arg], values);
+        break;
+      case FOP_NOT:
+        assert (sp >= 1);
+        stack[sp - 1] = !stack[sp - 1];
+        break;
+      case FOP_AND:
+        assert (sp >= 2);
+        sp--;
+        stack[sp - 1] = stack[sp - 1] && stack[sp];
+        break;
+      case FOP_OR:
+        assert (sp >= 2);
+        sp--;
+        stack[sp - 1] = stack[sp - 1] || stack[sp];
+        break;
+    }
+  }
+  assert (sp == 1);
+  return stack[0];
+}
+
+bool dds_topic_member_filter_accepts_sample (const struct dds_topic_member_filter *filter, const void *sample)
+{
+  struct dds_cdrstream_member_value values[DDS_TOPIC_FILTER_MEMBERS_MAX];
+  values_from_sample (filter, sample, values);
+  return eval_preds (filter, values);
+}
+
+bool dds_topic_member_filter_accepts (const struct dds_topic_member_filter *filter, const struct ddsi_serdata *serdata)
+{
+  struct dds_cdrstream_member_value values[DDS_TOPIC_FILTER_MEMBERS_MAX];
+  void *sample = NULL;
+  bool ret;
+  if (!dds_serdata_default_extract_members (serdata, filter->nmembers, filter->offsets, values))
+  {
+    /* e.g. a loaned sample in its in-memory representation */
+    sample = ddsi_sertype_alloc_sample (filter->type);
+    if (!ddsi_serdata_to_sample (serdata, sample, NULL, NULL))
+    {
+      ddsi_sertype_free_sample (filter->type, sample, DDS_FREE_ALL);
+      return false;
+    }
+    values_from_sample (filter, sample, values);
+  }
+  ret = eval_preds (filter, values);
+  if (sample)
+    ddsi_sertype_free_sample (filter->type, sample, DDS_FREE_ALL);
+  return ret;
+}
+
+/* Filters of remote readers, evaluated by the DDSI writer before sending data */
+struct ddsi_content_filter {
+  struct dds_topic_member_filter *f;
+};
+
+static struct ddsi_content_filter *content_filter_compile (const struct ddsi_sertype *type, const ddsi_content_filter_property_t *prop, void *arg)
+{
+  struct dds_topic_member_filter *f;
+  (void) arg;
+  if (prop->filter_class_name == NULL || strcmp (prop->filter_class_name, DDSI_CONTENT_FILTER_CLASS_SQL) != 0 || prop->filter_expression == NULL)
+    return NULL;
+  if (dds_topic_expression_filter_new (&f, type, prop->filter_expression, prop->expression_parameters.n, (const char * const *) prop->expression_parameters.strs) != DDS_RETCODE_OK)
+    return NULL;
+  struct ddsi_content_filter *cf = ddsrt_malloc (sizeof (*cf));
+  cf->f = f;
+  return cf;
+}
+
+static bool content_filter_accepts (const struct ddsi_content_filter *filter, const struct ddsi_serdata *serdata, void *arg)
+{
+  (void) arg;
+  return dds_topic_member_filter_accepts (filter->f, serdata);
+}
+
+static void content_filter_free (struct ddsi_content_filter *filter, void *arg)
+{
+  (void) arg;
+  dds_topic_member_filter_free (filter->f);
+  ddsrt_free (filter);
+}
+
+const struct ddsi_content_filter_interface dds_content_filter_interface = {
+  .arg = NULL,
+  .compile = content_filter_compile,
+  .accepts = content_filter_accepts,
+  .free = content_filter_free
+};
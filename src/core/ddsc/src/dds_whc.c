@@ -32,6 +32,8 @@
 #include "dds/ddsi/ddsi_domaingv.h"
 #include "dds/ddsi/ddsi_entity.h"
 #include "dds__whc.h"
+#include "dds__whc_ring.h"
+#include "dds__whc_store.h"
 #include "dds__entity.h"
 #include "dds__writer.h"
 
@@ -50,6 +52,7 @@ struct dds_whc_default_node {
   unsigned borrowed: 1; /* at most one can borrow it at any time */
   ddsrt_mtime_t last_rexmit_ts;
   uint32_t rexmit_count;
+  uint64_t filter_rejects; /* content filters of the writer rejecting the sample */
 #ifdef DDS_HAS_LIFESPAN
   struct ddsi_lifespan_fhnode lifespan; /* fibheap node for lifespan */
 #endif
@@ -87,6 +90,8 @@ struct whc_writer_info {
   dds_writer * writer; /* can be NULL, eg in case of whc for built-in writers */
   unsigned is_transient_local: 1;
   unsigned has_deadline: 1;
+  unsigned has_lifespan: 1;
+  unsigned is_keyless: 1; /* false if unknown, eg in case of built-in writers */
   uint32_t hdepth; /* 0 = unlimited */
   uint32_t tldepth; /* 0 = disabled/unlimited (no need to maintain an index if KEEP_ALL <=> is_transient_local + tldepth=0) */
   uint32_t idxdepth; /* = max (hdepth, tldepth) */
@@ -154,7 +159,7 @@ static uint32_t whc_default_remove_acked_messages_full (struct whc_impl *whc, dd
 static uint32_t whc_default_remove_acked_messages (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, struct ddsi_whc_state *whcst, struct ddsi_whc_node **deferred_free_list);
 static void whc_default_free_deferred_free_list (struct ddsi_whc *whc_generic, struct ddsi_whc_node *deferred_free_list);
 static void whc_default_get_state (const struct ddsi_whc *whc_generic, struct ddsi_whc_state *st);
-static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk);
+static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects);
 static ddsi_seqno_t whc_default_next_seq (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq);
 static bool whc_default_borrow_sample (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample);
 static bool whc_default_borrow_sample_key (const struct ddsi_whc *whc_generic, const struct ddsi_serdata *serdata_key, struct ddsi_whc_borrowed_sample *sample);
@@ -378,9 +383,11 @@ static ddsrt_mtime_t whc_sample_expired_cb(void *hc, ddsrt_mtime_t tnow)
   void *sample;
   ddsrt_mtime_t tnext;
   ddsrt_mutex_lock (&whc->lock);
+  const size_t old_unacked_bytes = whc->unacked_bytes;
   while ((tnext = ddsi_lifespan_next_expired_locked (&whc->lifespan, tnow, &sample)).v == 0)
     whc_delete_one (whc, sample);
   whc->maxseq_node = whc_findmax_procedurally (whc);
+  ddsi_whc_account_unacked_bytes (whc->gv, old_unacked_bytes, whc->unacked_bytes);
   ddsrt_mutex_unlock (&whc->lock);
   return tnext;
 }
@@ -428,6 +435,12 @@ struct whc_writer_info *dds_whc_make_wrinfo (struct dds_writer *wr, const dds_qo
   wrinfo->writer = wr;
   wrinfo->is_transient_local = (qos->durability.kind == DDS_DURABILITY_TRANSIENT_LOCAL);
   wrinfo->has_deadline = (qos->deadline.deadline != DDS_INFINITY);
+#ifdef DDS_HAS_LIFESPAN
+  wrinfo->has_lifespan = (qos->present & DDSI_QP_LIFESPAN) && qos->lifespan.duration != DDS_INFINITY;
+#else
+  wrinfo->has_lifespan = 0;
+#endif
+  wrinfo->is_keyless = (wr != NULL && !wr->m_topic->m_stype->has_key);
   wrinfo->hdepth = (qos->history.kind == DDS_HISTORY_KEEP_ALL) ? 0 : (unsigned) qos->history.depth;
   if (!wrinfo->is_transient_local)
     wrinfo->tldepth = 0;
@@ -450,6 +463,27 @@ struct ddsi_whc *dds_whc_new (struct ddsi_domaingv *gv, const struct whc_writer_
 
   assert ((wrinfo->hdepth == 0 || wrinfo->tldepth <= wrinfo->hdepth) || wrinfo->is_transient_local);
 
+  /* A keyless volatile KEEP_LAST writer has but a single instance and never needs
+     to retain more than the last hdepth samples, a simple ring buffer suffices */
+  if (wrinfo->is_keyless && wrinfo->hdepth > 0 && !wrinfo->is_transient_local && !wrinfo->has_deadline && !wrinfo->has_lifespan)
+    return dds_whc_ring_new (gv, wrinfo->hdepth, sample_overhead);
+
+  /* The transient-local history can be kept in a file instead, with the unacknowledged
+     samples in a volatile WHC */
+  if (wrinfo->is_transient_local && wrinfo->writer != NULL &&
+      gv->config.tl_store_directory != NULL && *gv->config.tl_store_directory != 0)
+  {
+    struct whc_writer_info volatile_wrinfo = *wrinfo;
+    struct ddsi_whc *inner, *store;
+    volatile_wrinfo.is_transient_local = 0;
+    volatile_wrinfo.tldepth = 0;
+    volatile_wrinfo.idxdepth = volatile_wrinfo.hdepth;
+    inner = dds_whc_new (gv, &volatile_wrinfo);
+    if ((store = dds_whc_store_new (gv, wrinfo->writer, wrinfo->tldepth, inner)) != NULL)
+      return store;
+    inner->ops->free (inner);
+  }
+
   whc = ddsrt_malloc (sizeof (*whc));
   whc->common.ops = &whc_ops;
   ddsrt_mutex_init (&whc->lock);
@@ -530,6 +564,7 @@ static void whc_default_free (struct ddsi_whc *whc_generic)
     ddsrt_free (idxn);
   }
   ddsrt_hh_free (whc->idx_hash);
+  ddsi_whc_account_unacked_bytes (whc->gv, whc->unacked_bytes, 0);
 
   {
     struct dds_whc_default_node *whcn = whc->maxseq_node;
@@ -1079,6 +1114,7 @@ static uint32_t whc_default_remove_acked_messages (struct ddsi_whc *whc_generic,
   uint32_t cnt;
 
   ddsrt_mutex_lock (&whc->lock);
+  const size_t old_unacked_bytes = whc->unacked_bytes;
   assert (max_drop_seq < DDSI_MAX_SEQ_NUMBER);
   assert (max_drop_seq >= whc->max_drop_seq);
 
@@ -1102,11 +1138,12 @@ static uint32_t whc_default_remove_acked_messages (struct ddsi_whc *whc_generic,
   else
     cnt = whc_default_remove_acked_messages_full (whc, max_drop_seq, deferred_free_list);
   get_state_locked (whc, whcst);
+  ddsi_whc_account_unacked_bytes (whc->gv, old_unacked_bytes, whc->unacked_bytes);
   ddsrt_mutex_unlock (&whc->lock);
   return cnt;
 }
 
-static struct dds_whc_default_node *whc_default_insert_seq (struct whc_impl *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata)
+static struct dds_whc_default_node *whc_default_insert_seq (struct whc_impl *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, uint64_t filter_rejects)
 {
   struct dds_whc_default_node *newn = NULL;
 
@@ -1123,6 +1160,7 @@ static struct dds_whc_default_node *whc_default_insert_seq (struct whc_impl *whc
   newn->idxnode_pos = 0;
   newn->last_rexmit_ts.v = 0;
   newn->rexmit_count = 0;
+  newn->filter_rejects = filter_rejects;
   newn->serdata = ddsi_serdata_ref (serdata);
   newn->next_seq = NULL;
   newn->prev_seq = whc->maxseq_node;
@@ -1177,7 +1215,7 @@ static struct dds_whc_default_node *whc_default_insert_seq (struct whc_impl *whc
   return newn;
 }
 
-static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk)
+static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects)
 {
   struct whc_impl * const whc = (struct whc_impl *)whc_generic;
   struct dds_whc_default_node *newn = NULL;
@@ -1192,6 +1230,7 @@ static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_dr
 
   ddsrt_mutex_lock (&whc->lock);
   check_whc (whc);
+  const size_t old_unacked_bytes = whc->unacked_bytes;
 
   if (whc->gv->logconfig.c.mask & DDS_LC_WHC)
   {
@@ -1212,7 +1251,7 @@ static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_dr
   assert (whc->seq_size == 0 || seq > whc->maxseq_node->common.seq);
 
   /* Always insert in seq admin */
-  newn = whc_default_insert_seq (whc, max_drop_seq, seq, exp, serdata);
+  newn = whc_default_insert_seq (whc, max_drop_seq, seq, exp, serdata, filter_rejects);
 
   TRACE ("  whcn %p:", (void*)newn);
 
@@ -1220,6 +1259,7 @@ static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_dr
   if (serdata->kind == SDK_EMPTY)
   {
     TRACE (" empty or no hist\n");
+    ddsi_whc_account_unacked_bytes (whc->gv, old_unacked_bytes, whc->unacked_bytes);
     ddsrt_mutex_unlock (&whc->lock);
     return 0;
   }
@@ -1329,6 +1369,7 @@ static int whc_default_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_dr
     }
     TRACE ("\n");
   }
+  ddsi_whc_account_unacked_bytes (whc->gv, old_unacked_bytes, whc->unacked_bytes);
   ddsrt_mutex_unlock (&whc->lock);
   return 0;
 }
@@ -1342,6 +1383,8 @@ static void make_borrowed_sample (struct ddsi_whc_borrowed_sample *sample, struc
   sample->unacked = whcn->unacked;
   sample->rexmit_count = whcn->rexmit_count;
   sample->last_rexmit_ts = whcn->last_rexmit_ts;
+  sample->filter_rejects = whcn->filter_rejects;
+  sample->filter_rejects_valid = true;
 }
 
 static bool whc_default_borrow_sample (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample)
@@ -236,7 +236,7 @@ static void bwhc_get_state (const struct ddsi_whc *whc, struct ddsi_whc_state *s
   st->unacked_bytes = 0;
 }
 
-static int bwhc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk)
+static int bwhc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects)
 {
   (void)whc;
   (void)max_drop_seq;
@@ -244,6 +244,7 @@ static int bwhc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_se
   (void)exp;
   (void)serdata;
   (void)tk;
+  (void)filter_rejects;
   return 0;
 }
 
@@ -0,0 +1,407 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/sync.h"
+#include "dds/ddsrt/misc.h"
+#include "dds/ddsi/ddsi_serdata.h"
+#include "dds/ddsi/ddsi_protocol.h"
+#include "dds/ddsi/ddsi_domaingv.h"
+#include "dds__whc_ring.h"
+
+/* WHC for keyless, volatile KEEP_LAST writers without deadline and lifespan
+
+ Such a writer has a single instance, and so the history is nothing more than
+ the last "depth" samples. The samples are stored in a ring buffer in sequence
+ number order, and because a writer (nearly always) inserts consecutive sequence
+ numbers, the position of a sequence number in the ring is simply its offset
+ from the oldest one. Gaps can occur when there are temporarily no reliable
+ readers, in which case lookups fall back to a binary search.
+
+ Differences with the general WHC:
+ - an unregister does not end the history of the instance, and so it may be
+   pushed out of the WHC by subsequent writes just like any other sample, but
+   those writes implicitly register the instance again
+ - acknowledged samples are released immediately rather than returned in a
+   deferred free list */
+
+#define WHC_RING_INITIAL_SIZE 16
+
+struct whc_ring_entry {
+  ddsi_seqno_t seq;
+  struct ddsi_serdata *serdata;
+  size_t size;
+  unsigned unacked: 1; /* counted in whc::unacked_bytes iff 1 */
+  unsigned borrowed: 1; /* at most one can borrow it at any time */
+  ddsrt_mtime_t last_rexmit_ts;
+  uint32_t rexmit_count;
+  uint64_t filter_rejects; /* content filters of the writer rejecting the sample */
+};
+
+struct whc_ring {
+  struct ddsi_whc common;
+  ddsrt_mutex_t lock;
+  struct ddsi_domaingv *gv;
+  uint32_t depth; /* history depth, maximum number of samples stored */
+  uint32_t size; /* number of allocated entries, grows up to depth */
+  uint32_t head; /* index of oldest sample */
+  uint32_t count; /* number of samples stored */
+  size_t unacked_bytes;
+  size_t sample_overhead;
+  uint32_t fragment_size;
+  ddsi_seqno_t max_drop_seq;
+  struct whc_ring_entry *entries;
+};
+
+struct whc_ring_sample_iter {
+  struct ddsi_whc_sample_iter_base c;
+  bool first;
+};
+
+/* check that our definition of whc_sample_iter fits in the type that callers allocate */
+DDSRT_STATIC_ASSERT (sizeof (struct whc_ring_sample_iter) <= sizeof (struct ddsi_whc_sample_iter));
+
+#define TRACE(...) DDS_CLOG (DDS_LC_WHC, &whc->gv->logconfig, __VA_ARGS__)
+
+static struct whc_ring_entry *ring_entry (const struct whc_ring *whc, uint32_t i)
+{
+  /* i-th sample counting from the oldest one */
+  assert (i < whc->count);
+  const uint32_t k = whc->head + i;
+  return &whc->entries[(k >= whc->size) ? k - whc->size : k];
+}
+
+static uint32_t ring_lower_bound (const struct whc_ring *whc, ddsi_seqno_t seq)
+{
+  /* position of the first sample with sequence number >= seq, count if none */
+  if (whc->count == 0 || seq <= ring_entry (whc, 0)->seq)
+    return 0;
+  const ddsi_seqno_t d = seq - ring_entry (whc, 0)->seq;
+  if (d < whc->count && ring_entry (whc, (uint32_t) d)->seq == seq)
+    return (uint32_t) d;
+  uint32_t lo = 0, hi = whc->count;
+  while (lo < hi)
+  {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (ring_entry (whc, mid)->seq < seq)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static struct whc_ring_entry *ring_findseq (const struct whc_ring *whc, ddsi_seqno_t seq)
+{
+  const uint32_t i = ring_lower_bound (whc, seq);
+  if (i < whc->count && ring_entry (whc, i)->seq == seq)
+    return ring_entry (whc, i);
+  return NULL;
+}
+
+static void ring_drop_oldest (struct whc_ring *whc)
+{
+  struct whc_ring_entry * const e = ring_entry (whc, 0);
+  if (e->unacked)
+  {
+    assert (whc->unacked_bytes >= e->size);
+    whc->unacked_bytes -= e->size;
+  }
+  /* a borrowed sample's reference passes to the borrower, return_sample releases it */
+  if (!e->borrowed)
+    ddsi_serdata_unref (e->serdata);
+  if (++whc->head == whc->size)
+    whc->head = 0;
+  whc->count--;
+}
+
+static void ring_grow (struct whc_ring *whc)
+{
+  const uint32_t size = (whc->size > whc->depth / 2) ? whc->depth : 2 * whc->size;
+  struct whc_ring_entry *entries = ddsrt_malloc (size * sizeof (*entries));
+  for (uint32_t i = 0; i < whc->count; i++)
+    entries[i] = *ring_entry (whc, i);
+  ddsrt_free (whc->entries);
+  whc->entries = entries;
+  whc->size = size;
+  whc->head = 0;
+}
+
+static void get_state_locked (const struct whc_ring *whc, struct ddsi_whc_state *st)
+{
+  if (whc->count == 0)
+  {
+    st->min_seq = st->max_seq = 0;
+    st->unacked_bytes = 0;
+  }
+  else
+  {
+    st->min_seq = ring_entry (whc, 0)->seq;
+    st->max_seq = ring_entry (whc, whc->count - 1)->seq;
+    st->unacked_bytes = whc->unacked_bytes;
+  }
+}
+
+static void whc_ring_get_state (const struct ddsi_whc *whc_generic, struct ddsi_whc_state *st)
+{
+  const struct whc_ring * const whc = (const struct whc_ring *) whc_generic;
+  ddsrt_mutex_lock ((ddsrt_mutex_t *) &whc->lock);
+  get_state_locked (whc, st);
+  ddsrt_mutex_unlock ((ddsrt_mutex_t *) &whc->lock);
+}
+
+static ddsi_seqno_t whc_ring_next_seq (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq)
+{
+  const struct whc_ring * const whc = (const struct whc_ring *) whc_generic;
+  ddsi_seqno_t nseq;
+  ddsrt_mutex_lock ((ddsrt_mutex_t *) &whc->lock);
+  const uint32_t i = ring_lower_bound (whc, seq + 1);
+  nseq = (i < whc->count) ? ring_entry (whc, i)->seq : DDSI_MAX_SEQ_NUMBER;
+  ddsrt_mutex_unlock ((ddsrt_mutex_t *) &whc->lock);
+  return nseq;
+}
+
+static int whc_ring_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects)
+{
+  struct whc_ring * const whc = (struct whc_ring *) whc_generic;
+  DDSRT_UNUSED_ARG (exp);
+  DDSRT_UNUSED_ARG (tk);
+
+  ddsrt_mutex_lock (&whc->lock);
+  const size_t old_unacked_bytes = whc->unacked_bytes;
+  TRACE ("whc_ring_insert(%p max_drop_seq %"PRIu64" seq %"PRIu64" serdata %p:%"PRIx32") count %"PRIu32"/%"PRIu32"\n",
+         (void *) whc, max_drop_seq, seq, (void *) serdata, serdata->hash, whc->count, whc->depth);
+  assert (max_drop_seq < DDSI_MAX_SEQ_NUMBER);
+  assert (max_drop_seq >= whc->max_drop_seq);
+  assert (whc->count == 0 || seq > ring_entry (whc, whc->count - 1)->seq);
+
+  /* An unregister that is acknowledged on arrival is of no use to anyone */
+  if ((serdata->statusinfo & DDSI_STATUSINFO_UNREGISTER) && seq <= max_drop_seq)
+  {
+    ddsrt_mutex_unlock (&whc->lock);
+    return 0;
+  }
+
+  if (whc->count == whc->depth)
+    ring_drop_oldest (whc);
+  else if (whc->count == whc->size)
+    ring_grow (whc);
+
+  whc->count++;
+  struct whc_ring_entry * const e = ring_entry (whc, whc->count - 1);
+  const size_t sz = ddsi_serdata_size (serdata);
+  e->seq = seq;
+  e->serdata = ddsi_serdata_ref (serdata);
+  e->size = sz + ((sz + whc->fragment_size - 1) / whc->fragment_size) * whc->sample_overhead;
+  e->unacked = (seq > max_drop_seq);
+  e->borrowed = 0;
+  e->last_rexmit_ts.v = 0;
+  e->rexmit_count = 0;
+  e->filter_rejects = filter_rejects;
+  if (e->unacked)
+    whc->unacked_bytes += e->size;
+  ddsi_whc_account_unacked_bytes (whc->gv, old_unacked_bytes, whc->unacked_bytes);
+  ddsrt_mutex_unlock (&whc->lock);
+  return 0;
+}
+
+static uint32_t whc_ring_remove_acked_messages (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, struct ddsi_whc_state *whcst, struct ddsi_whc_node **deferred_free_list)
+{
+  struct whc_ring * const whc = (struct whc_ring *) whc_generic;
+  uint32_t cnt = 0;
+  ddsrt_mutex_lock (&whc->lock);
+  const size_t old_unacked_bytes = whc->unacked_bytes;
+  assert (max_drop_seq < DDSI_MAX_SEQ_NUMBER);
+  assert (max_drop_seq >= whc->max_drop_seq);
+  TRACE ("whc_ring_remove_acked_messages(%p max_drop_seq %"PRIu64")\n", (void *) whc, max_drop_seq);
+  while (whc->count > 0 && ring_entry (whc, 0)->seq <= max_drop_seq)
+  {
+    ring_drop_oldest (whc);
+    cnt++;
+  }
+  whc->max_drop_seq = max_drop_seq;
+  get_state_locked (whc, whcst);
+  ddsi_whc_account_unacked_bytes (whc->gv, old_unacked_bytes, whc->unacked_bytes);
+  ddsrt_mutex_unlock (&whc->lock);
+  *deferred_free_list = NULL;
+  return cnt;
+}
+
+static void whc_ring_free_deferred_free_list (struct ddsi_whc *whc_generic, struct ddsi_whc_node *deferred_free_list)
+{
+  (void) whc_generic;
+  assert (deferred_free_list == NULL);
+  (void) deferred_free_list;
+}
+
+static void make_borrowed_sample (struct ddsi_whc_borrowed_sample *sample, struct whc_ring_entry *e)
+{
+  assert (!e->borrowed);
+  e->borrowed = 1;
+  sample->seq = e->seq;
+  sample->serdata = e->serdata;
+  sample->unacked = e->unacked;
+  sample->rexmit_count = e->rexmit_count;
+  sample->last_rexmit_ts = e->last_rexmit_ts;
+  sample->filter_rejects = e->filter_rejects;
+  sample->filter_rejects_valid = true;
+}
+
+static bool whc_ring_borrow_sample (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample)
+{
+  const struct whc_ring * const whc = (const struct whc_ring *) whc_generic;
+  struct whc_ring_entry *e;
+  bool found;
+  ddsrt_mutex_lock ((ddsrt_mutex_t *) &whc->lock);
+  if ((e = ring_findseq (whc, seq)) == NULL)
+    found = false;
+  else
+  {
+    make_borrowed_sample (sample, e);
+    found = true;
+  }
+  ddsrt_mutex_unlock ((ddsrt_mutex_t *) &whc->lock);
+  return found;
+}
+
+static bool whc_ring_borrow_sample_key (const struct ddsi_whc *whc_generic, const struct ddsi_serdata *serdata_key, struct ddsi_whc_borrowed_sample *sample)
+{
+  /* There is only one instance, the latest sample is the one we want unless the
+     instance has been unregistered since */
+  const struct whc_ring * const whc = (const struct whc_ring *) whc_generic;
+  bool found = false;
+  (void) serdata_key;
+  ddsrt_mutex_lock ((ddsrt_mutex_t *) &whc->lock);
+  for (uint32_t i = whc->count; i > 0; i--)
+  {
+    struct whc_ring_entry * const e = ring_entry (whc, i - 1);
+    if (e->serdata->kind == SDK_EMPTY)
+      continue;
+    if (!(e->serdata->statusinfo & DDSI_STATUSINFO_UNREGISTER))
+    {
+      make_borrowed_sample (sample, e);
+      found = true;
+    }
+    break;
+  }
+  ddsrt_mutex_unlock ((ddsrt_mutex_t *) &whc->lock);
+  return found;
+}
+
+static void return_sample_locked (struct whc_ring *whc, struct ddsi_whc_borrowed_sample *sample, bool update_retransmit_info)
+{
+  struct whc_ring_entry *e;
+  if ((e = ring_findseq (whc, sample->seq)) == NULL)
+  {
+    /* data no longer present in WHC */
+    ddsi_serdata_unref (sample->serdata);
+  }
+  else
+  {
+    assert (e->borrowed);
+    e->borrowed = 0;
+    if (update_retransmit_info)
+    {
+      e->rexmit_count = sample->rexmit_count;
+      e->last_rexmit_ts = sample->last_rexmit_ts;
+    }
+  }
+}
+
+static void whc_ring_return_sample (struct ddsi_whc *whc_generic, struct ddsi_whc_borrowed_sample *sample, bool update_retransmit_info)
+{
+  struct whc_ring * const whc = (struct whc_ring *) whc_generic;
+  ddsrt_mutex_lock (&whc->lock);
+  return_sample_locked (whc, sample, update_retransmit_info);
+  ddsrt_mutex_unlock (&whc->lock);
+}
+
+static void whc_ring_sample_iter_init (const struct ddsi_whc *whc_generic, struct ddsi_whc_sample_iter *opaque_it)
+{
+  struct whc_ring_sample_iter *it = (struct whc_ring_sample_iter *) opaque_it;
+  it->c.whc = (struct ddsi_whc *) whc_generic;
+  it->first = true;
+}
+
+static bool whc_ring_sample_iter_borrow_next (struct ddsi_whc_sample_iter *opaque_it, struct ddsi_whc_borrowed_sample *sample)
+{
+  struct whc_ring_sample_iter * const it = (struct whc_ring_sample_iter *) opaque_it;
+  struct whc_ring * const whc = (struct whc_ring *) it->c.whc;
+  ddsi_seqno_t seq;
+  bool valid;
+  ddsrt_mutex_lock (&whc->lock);
+  if (!it->first)
+  {
+    seq = sample->seq;
+    return_sample_locked (whc, sample, false);
+  }
+  else
+  {
+    it->first = false;
+    seq = 0;
+  }
+  const uint32_t i = ring_lower_bound (whc, seq + 1);
+  if (i == whc->count)
+    valid = false;
+  else
+  {
+    make_borrowed_sample (sample, ring_entry (whc, i));
+    valid = true;
+  }
+  ddsrt_mutex_unlock (&whc->lock);
+  return valid;
+}
+
+static void whc_ring_free (struct ddsi_whc *whc_generic)
+{
+  struct whc_ring * const whc = (struct whc_ring *) whc_generic;
+  ddsi_whc_account_unacked_bytes (whc->gv, whc->unacked_bytes, 0);
+  for (uint32_t i = 0; i < whc->count; i++)
+    ddsi_serdata_unref (ring_entry (whc, i)->serdata);
+  ddsrt_free (whc->entries);
+  ddsrt_mutex_destroy (&whc->lock);
+  ddsrt_free (whc);
+}
+
+static const struct ddsi_whc_ops whc_ring_ops = {
+  .insert = whc_ring_insert,
+  .remove_acked_messages = whc_ring_remove_acked_messages,
+  .free_deferred_free_list = whc_ring_free_deferred_free_list,
+  .get_state = whc_ring_get_state,
+  .next_seq = whc_ring_next_seq,
+  .borrow_sample = whc_ring_borrow_sample,
+  .borrow_sample_key = whc_ring_borrow_sample_key,
+  .return_sample = whc_ring_return_sample,
+  .sample_iter_init = whc_ring_sample_iter_init,
+  .sample_iter_borrow_next = whc_ring_sample_iter_borrow_next,
+  .free = whc_ring_free
+};
+
+struct ddsi_whc *dds_whc_ring_new (struct ddsi_domaingv *gv, uint32_t depth, size_t sample_overhead)
+{
+  assert (depth > 0);
+  struct whc_ring *whc = ddsrt_malloc (sizeof (*whc));
+  whc->common.ops = &whc_ring_ops;
+  ddsrt_mutex_init (&whc->lock);
+  whc->gv = gv;
+  whc->depth = depth;
+  whc->size = (depth < WHC_RING_INITIAL_SIZE) ? depth : WHC_RING_INITIAL_SIZE;
+  whc->head = 0;
+  whc->count = 0;
+  whc->unacked_bytes = 0;
+  whc->sample_overhead = sample_overhead;
+  whc->fragment_size = gv->config.fragment_size;
+  whc->max_drop_seq = 0;
+  whc->entries = ddsrt_malloc (whc->size * sizeof (*whc->entries));
+  return (struct ddsi_whc *) whc;
+}
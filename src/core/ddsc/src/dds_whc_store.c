@@ -0,0 +1,976 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
+#include "dds/ddsrt/sync.h"
+#include "dds/ddsrt/misc.h"
+#include "dds/ddsrt/mh3.h"
+#include "dds/ddsrt/string.h"
+#include "dds/ddsrt/time.h"
+#include "dds/ddsrt/hopscotch.h"
+#include "dds/ddsrt/fibheap.h"
+#include "dds/ddsi/ddsi_serdata.h"
+#include "dds/ddsi/ddsi_tkmap.h"
+#include "dds/ddsi/ddsi_protocol.h"
+#include "dds/ddsi/ddsi_domaingv.h"
+#include "dds/ddsi/ddsi_typelib.h"
+#include "dds__types.h"
+#include "dds__serdata_default.h"
+#include "dds__whc_store.h"
+
+/* WHC for transient-local writers that keeps the transient-local history in a file
+
+ The file consists of a header followed by records, each record holding the
+ serialized form of one sample plus its timestamp and status info. Records are
+ only ever appended, and the file is memory-mapped so that retrieving a sample
+ for a late-joining reader is a matter of deserializing it from the mapping.
+
+ A record starts out "live" and is marked "dead" in place once it is no longer
+ part of the history, because it was pushed out by newer samples of the same
+ instance or because the instance was unregistered. Once more than half of the
+ file is dead and it has grown beyond a minimum size, the live records are
+ copied to a new file that then replaces the old one.
+
+ Unacknowledged samples are also kept in a volatile WHC, which provides the
+ retransmit administration and the unacked byte count for flow control, and
+ is consulted first. The sequence numbers of samples in the history are kept in
+ a sorted array mapping them to their offset in the file, and for each instance
+ the sequence numbers of its most recent samples are kept in a ring.
+
+ On creation, the live records in an existing file are loaded, and once the
+ writer exists, they are re-published with new sequence numbers. That stores
+ them again, and after that they are marked dead in their original location.
+ Writes to the mapping are not synchronised to disk while the writer exists,
+ the history therefore survives restarts of the process but not necessarily a
+ crash of the operating system. */
+
+#define WHC_STORE_MAGIC "CDDSWHC"
+#define WHC_STORE_VERSION 1u
+#define WHC_STORE_REC_LIVE 0x4556494cu /* "LIVE" */
+#define WHC_STORE_REC_DEAD 0x44414544u /* "DEAD" */
+#define WHC_STORE_INITIAL_MAP_SIZE ((size_t) 65536)
+#define WHC_STORE_COMPACT_MIN_SIZE ((size_t) 1048576)
+#define WHC_STORE_NOOFF UINT64_MAX
+
+struct whc_store_hdr {
+  char magic[8];
+  uint32_t version;
+  uint32_t type_hash;
+};
+
+struct whc_store_rec {
+  uint32_t state; /* 0 while being written, then WHC_STORE_REC_LIVE or WHC_STORE_REC_DEAD */
+  uint32_t size; /* size of the serialized data following the record header */
+  int64_t timestamp;
+  uint32_t statusinfo;
+  uint32_t kind;
+};
+
+DDSRT_STATIC_ASSERT (sizeof (struct whc_store_hdr) % 8 == 0 && sizeof (struct whc_store_rec) % 8 == 0);
+
+struct whc_store_exp {
+  ddsrt_fibheap_node_t fhnode;
+  ddsrt_mtime_t texp;
+  ddsi_seqno_t seq;
+  uint64_t iid;
+};
+
+struct whc_store_entry {
+  ddsi_seqno_t seq;
+  uint64_t off; /* WHC_STORE_NOOFF if no longer in the history */
+  struct whc_store_exp *exp; /* node in the lifespan heap, NULL if it never expires */
+};
+
+struct whc_store_inst {
+  uint64_t iid;
+  struct ddsi_tkmap_instance *tk;
+  uint32_t head; /* index of oldest sample in hist */
+  uint32_t n; /* number of samples in hist */
+  uint32_t size; /* = tldepth, or grows for KEEP_ALL */
+  ddsi_seqno_t *hist;
+};
+
+struct whc_store {
+  struct ddsi_whc common;
+  ddsrt_mutex_t lock;
+  struct ddsi_domaingv *gv;
+  struct ddsi_whc *inner; /* volatile WHC for unacknowledged samples */
+  const struct ddsi_sertype *type; /* NULL until the first sample is inserted */
+  uint32_t tldepth; /* 0 = KEEP_ALL */
+  bool has_deadline; /* volatile WHC tracks deadlines */
+  char *path;
+  uint32_t type_hash;
+#ifndef _WIN32
+  int fd;
+#endif
+  unsigned char *base;
+  size_t map_size;
+  size_t end; /* offset at which the next record goes */
+  size_t live_bytes;
+  size_t dead_bytes;
+  size_t next_compact_size; /* don't consider compacting until end exceeds this */
+  struct ddsrt_hh *inst_hash;
+  struct whc_store_entry *entries; /* sorted on seq */
+  uint32_t entries_head; /* entries before head are all dead */
+  uint32_t entries_n; /* last entry is live unless head = n */
+  uint32_t entries_size;
+  uint32_t entries_ndead; /* number of dead entries in [0,n) */
+  ddsrt_fibheap_t exp_heap; /* live entries with a finite lifespan, ordered on expiry time */
+  uint64_t *pending; /* offsets of records loaded from the file still to be replayed */
+  uint32_t npending;
+};
+
+struct whc_store_sample_iter {
+  struct ddsi_whc_sample_iter_base c;
+  bool first;
+};
+
+/* check that our definition of whc_sample_iter fits in the type that callers allocate */
+DDSRT_STATIC_ASSERT (sizeof (struct whc_store_sample_iter) <= sizeof (struct ddsi_whc_sample_iter));
+
+#ifndef _WIN32
+
+static int whc_store_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects);
+static uint32_t whc_store_remove_acked_messages (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, struct ddsi_whc_state *whcst, struct ddsi_whc_node **deferred_free_list);
+static void whc_store_free_deferred_free_list (struct ddsi_whc *whc_generic, struct ddsi_whc_node *deferred_free_list);
+static void whc_store_get_state (const struct ddsi_whc *whc_generic, struct ddsi_whc_state *st);
+static ddsi_seqno_t whc_store_next_seq (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq);
+static bool whc_store_borrow_sample (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample);
+static bool whc_store_borrow_sample_key (const struct ddsi_whc *whc_generic, const struct ddsi_serdata *serdata_key, struct ddsi_whc_borrowed_sample *sample);
+static void whc_store_return_sample (struct ddsi_whc *whc_generic, struct ddsi_whc_borrowed_sample *sample, bool update_retransmit_info);
+static void whc_store_sample_iter_init (const struct ddsi_whc *whc_generic, struct ddsi_whc_sample_iter *opaque_it);
+static bool whc_store_sample_iter_borrow_next (struct ddsi_whc_sample_iter *opaque_it, struct ddsi_whc_borrowed_sample *sample);
+static void whc_store_free (struct ddsi_whc *whc_generic);
+
+static const struct ddsi_whc_ops whc_store_ops = {
+  .insert = whc_store_insert,
+  .remove_acked_messages = whc_store_remove_acked_messages,
+  .free_deferred_free_list = whc_store_free_deferred_free_list,
+  .get_state = whc_store_get_state,
+  .next_seq = whc_store_next_seq,
+  .borrow_sample = whc_store_borrow_sample,
+  .borrow_sample_key = whc_store_borrow_sample_key,
+  .return_sample = whc_store_return_sample,
+  .sample_iter_init = whc_store_sample_iter_init,
+  .sample_iter_borrow_next = whc_store_sample_iter_borrow_next,
+  .free = whc_store_free
+};
+
+#define TRACE(...) DDS_CLOG (DDS_LC_WHC, &whc->gv->logconfig, __VA_ARGS__)
+
+static uint32_t whc_store_inst_hash (const void *vn)
+{
+  const struct whc_store_inst *n = vn;
+  return (uint32_t) (((n->iid + UINT64_C (16292676669999574021)) * UINT64_C (10242350189706880077)) >> 32);
+}
+
+static bool whc_store_inst_eq (const void *va, const void *vb)
+{
+  const struct whc_store_inst *a = va;
+  const struct whc_store_inst *b = vb;
+  return a->iid == b->iid;
+}
+
+static int whc_store_exp_cmp (const void *va, const void *vb)
+{
+  const struct whc_store_exp *a = va;
+  const struct whc_store_exp *b = vb;
+  return (a->texp.v == b->texp.v) ? 0 : (a->texp.v < b->texp.v) ? -1 : 1;
+}
+
+static const ddsrt_fibheap_def_t whc_store_exp_fhdef = DDSRT_FIBHEAPDEF_INITIALIZER (offsetof (struct whc_store_exp, fhnode), whc_store_exp_cmp);
+
+static size_t rec_size (uint32_t size)
+{
+  return (sizeof (struct whc_store_rec) + size + 7) & ~(size_t) 7;
+}
+
+static struct whc_store_rec *rec_at (const struct whc_store *whc, uint64_t off)
+{
+  assert (off + sizeof (struct whc_store_rec) <= whc->end);
+  return (struct whc_store_rec *) (whc->base + off);
+}
+
+static unsigned char *store_map (int fd, size_t size)
+{
+  void *base;
+  if (ftruncate (fd, (off_t) size) != 0)
+    return NULL;
+  if ((base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+    return NULL;
+  return base;
+}
+
+static bool store_reserve (struct whc_store *whc, size_t size)
+{
+  if (whc->end + size <= whc->map_size)
+    return true;
+  size_t new_size = whc->map_size;
+  while (whc->end + size > new_size)
+    new_size *= 2;
+  unsigned char *base;
+  if ((base = store_map (whc->fd, new_size)) == NULL)
+    return false;
+  munmap (whc->base, whc->map_size);
+  whc->base = base;
+  whc->map_size = new_size;
+  return true;
+}
+
+static uint32_t store_lower_bound (const struct whc_store *whc, ddsi_seqno_t seq)
+{
+  /* index of the first entry with sequence number >= seq, entries_n if none */
+  uint32_t lo = whc->entries_head, hi = whc->entries_n;
+  while (lo < hi)
+  {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (whc->entries[mid].seq < seq)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static const struct whc_store_entry *store_findseq (const struct whc_store *whc, ddsi_seqno_t seq)
+{
+  const uint32_t i = store_lower_bound (whc, seq);
+  if (i < whc->entries_n && whc->entries[i].seq == seq && whc->entries[i].off != WHC_STORE_NOOFF)
+    return &whc->entries[i];
+  return NULL;
+}
+
+static void store_squeeze_entries (struct whc_store *whc)
+{
+  uint32_t n = 0;
+  for (uint32_t i = whc->entries_head; i < whc->entries_n; i++)
+    if (whc->entries[i].off != WHC_STORE_NOOFF)
+      whc->entries[n++] = whc->entries[i];
+  whc->entries_head = 0;
+  whc->entries_n = n;
+  whc->entries_ndead = 0;
+}
+
+static void store_kill (struct whc_store *whc, ddsi_seqno_t seq)
+{
+  const uint32_t i = store_lower_bound (whc, seq);
+  assert (i < whc->entries_n && whc->entries[i].seq == seq && whc->entries[i].off != WHC_STORE_NOOFF);
+  struct whc_store_rec * const rec = rec_at (whc, whc->entries[i].off);
+  const size_t sz = rec_size (rec->size);
+  TRACE ("whc_store_kill(%p seq %"PRIu64" off %"PRIu64")\n", (void *) whc, seq, whc->entries[i].off);
+  rec->state = WHC_STORE_REC_DEAD;
+  if (whc->entries[i].exp)
+  {
+    ddsrt_fibheap_delete (&whc_store_exp_fhdef, &whc->exp_heap, whc->entries[i].exp);
+    ddsrt_free (whc->entries[i].exp);
+    whc->entries[i].exp = NULL;
+  }
+  assert (whc->live_bytes >= sz);
+  whc->live_bytes -= sz;
+  whc->dead_bytes += sz;
+  whc->entries[i].off = WHC_STORE_NOOFF;
+  whc->entries_ndead++;
+  /* maintain invariants: nothing live before head, last one live unless empty */
+  while (whc->entries_head < whc->entries_n && whc->entries[whc->entries_head].off == WHC_STORE_NOOFF)
+    whc->entries_head++;
+  while (whc->entries_n > whc->entries_head && whc->entries[whc->entries_n - 1].off == WHC_STORE_NOOFF)
+  {
+    whc->entries_n--;
+    whc->entries_ndead--;
+  }
+  if (whc->entries_ndead > 32 && whc->entries_ndead > whc->entries_n / 2)
+    store_squeeze_entries (whc);
+}
+
+static uint64_t store_append (struct whc_store *whc, const struct ddsi_serdata *serdata)
+{
+  const uint32_t size = ddsi_serdata_size (serdata);
+  const size_t sz = rec_size (size);
+  if (!store_reserve (whc, sz))
+    return WHC_STORE_NOOFF;
+  const uint64_t off = whc->end;
+  struct whc_store_rec * const rec = (struct whc_store_rec *) (whc->base + off);
+  rec->state = 0;
+  rec->size = size;
+  rec->timestamp = serdata->timestamp.v;
+  rec->statusinfo = serdata->statusinfo;
+  rec->kind = (uint32_t) serdata->kind;
+  ddsi_serdata_to_ser (serdata, 0, size, rec + 1);
+  /* only now is the record complete */
+  rec->state = WHC_STORE_REC_LIVE;
+  whc->end += sz;
+  whc->live_bytes += sz;
+  return off;
+}
+
+static void store_add_entry (struct whc_store *whc, ddsi_seqno_t seq, uint64_t off, uint64_t iid, ddsrt_mtime_t exp)
+{
+  assert (whc->entries_n == whc->entries_head || whc->entries[whc->entries_n - 1].seq < seq);
+  if (whc->entries_n == whc->entries_size)
+  {
+    if (whc->entries_head > 0)
+      store_squeeze_entries (whc);
+    if (whc->entries_n == whc->entries_size)
+    {
+      whc->entries_size = (whc->entries_size == 0) ? 64 : 2 * whc->entries_size;
+      whc->entries = ddsrt_realloc (whc->entries, whc->entries_size * sizeof (*whc->entries));
+    }
+  }
+  struct whc_store_exp *x = NULL;
+  if (exp.v != DDS_NEVER)
+  {
+    x = ddsrt_malloc (sizeof (*x));
+    x->texp = exp;
+    x->seq = seq;
+    x->iid = iid;
+    ddsrt_fibheap_insert (&whc_store_exp_fhdef, &whc->exp_heap, x);
+  }
+  whc->entries[whc->entries_n].seq = seq;
+  whc->entries[whc->entries_n].off = off;
+  whc->entries[whc->entries_n].exp = x;
+  whc->entries_n++;
+}
+
+static struct whc_store_inst *store_lookup_inst (const struct whc_store *whc, uint64_t iid)
+{
+  struct whc_store_inst template = { .iid = iid };
+  return ddsrt_hh_lookup (whc->inst_hash, &template);
+}
+
+static void store_drop_inst (struct whc_store *whc, struct whc_store_inst *inst)
+{
+  for (uint32_t i = 0; i < inst->n; i++)
+  {
+    const uint32_t k = inst->head + i;
+    store_kill (whc, inst->hist[(k >= inst->size) ? k - inst->size : k]);
+  }
+  ddsrt_hh_remove_present (whc->inst_hash, inst);
+  ddsi_tkmap_instance_unref (whc->gv->m_tkmap, inst->tk);
+  ddsrt_free (inst->hist);
+  ddsrt_free (inst);
+}
+
+static void store_push_hist (struct whc_store *whc, struct whc_store_inst *inst, ddsi_seqno_t seq)
+{
+  if (whc->tldepth > 0 && inst->n == whc->tldepth)
+  {
+    /* push out the oldest sample of the instance */
+    store_kill (whc, inst->hist[inst->head]);
+    if (++inst->head == inst->size)
+      inst->head = 0;
+    inst->n--;
+  }
+  else if (inst->n == inst->size)
+  {
+    /* KEEP_ALL: grow the ring, making it contiguous again */
+    assert (whc->tldepth == 0);
+    const uint32_t new_size = 2 * inst->size;
+    ddsi_seqno_t *hist = ddsrt_malloc (new_size * sizeof (*hist));
+    for (uint32_t i = 0; i < inst->n; i++)
+    {
+      const uint32_t k = inst->head + i;
+      hist[i] = inst->hist[(k >= inst->size) ? k - inst->size : k];
+    }
+    ddsrt_free (inst->hist);
+    inst->hist = hist;
+    inst->head = 0;
+    inst->size = new_size;
+  }
+  const uint32_t k = inst->head + inst->n;
+  inst->hist[(k >= inst->size) ? k - inst->size : k] = seq;
+  inst->n++;
+}
+
+static void store_remove_from_hist (struct whc_store_inst *inst, ddsi_seqno_t seq)
+{
+  uint32_t i = 0, k;
+  while (inst->hist[(k = inst->head + i) >= inst->size ? k - inst->size : k] != seq)
+    i++;
+  assert (i < inst->n);
+  for (; i + 1 < inst->n; i++)
+  {
+    const uint32_t k0 = inst->head + i, k1 = k0 + 1;
+    inst->hist[(k0 >= inst->size) ? k0 - inst->size : k0] = inst->hist[(k1 >= inst->size) ? k1 - inst->size : k1];
+  }
+  inst->n--;
+}
+
+static void store_expire (struct whc_store *whc)
+{
+  /* Lifespan is handled lazily: expired samples are removed whenever the WHC is
+     used, which is indistinguishable from removing them on time because the
+     history can't be observed otherwise */
+  struct whc_store_exp *x;
+  if ((x = ddsrt_fibheap_min (&whc_store_exp_fhdef, &whc->exp_heap)) == NULL)
+    return;
+  const ddsrt_mtime_t tnow = ddsrt_time_monotonic ();
+  while (x != NULL && x->texp.v <= tnow.v)
+  {
+    /* killing the entry frees x */
+    const ddsi_seqno_t seq = x->seq;
+    struct whc_store_inst * const inst = store_lookup_inst (whc, x->iid);
+    TRACE ("whc_store_expire(%p seq %"PRIu64")\n", (void *) whc, seq);
+    store_remove_from_hist (inst, seq);
+    store_kill (whc, seq);
+    if (inst->n == 0)
+      store_drop_inst (whc, inst);
+    x = ddsrt_fibheap_min (&whc_store_exp_fhdef, &whc->exp_heap);
+  }
+}
+
+static struct whc_store *store_lock (const struct whc_store *whc_const)
+{
+  /* all operations may remove expired samples, even those that formally don't modify the WHC */
+  struct whc_store * const whc = (struct whc_store *) whc_const;
+  ddsrt_mutex_lock (&whc->lock);
+  store_expire (whc);
+  return whc;
+}
+
+static void store_write_header (struct whc_store *whc)
+{
+  struct whc_store_hdr * const hdr = (struct whc_store_hdr *) whc->base;
+  memset (hdr, 0, sizeof (*hdr));
+  memcpy (hdr->magic, WHC_STORE_MAGIC, sizeof (WHC_STORE_MAGIC));
+  hdr->version = WHC_STORE_VERSION;
+  hdr->type_hash = whc->type_hash;
+}
+
+static bool store_header_ok (const struct whc_store *whc, size_t file_size)
+{
+  const struct whc_store_hdr * const hdr = (const struct whc_store_hdr *) whc->base;
+  return (file_size >= sizeof (*hdr) &&
+          memcmp (hdr->magic, WHC_STORE_MAGIC, sizeof (WHC_STORE_MAGIC)) == 0 &&
+          hdr->version == WHC_STORE_VERSION &&
+          hdr->type_hash == whc->type_hash);
+}
+
+static void store_maybe_compact (struct whc_store *whc)
+{
+  /* not while the loaded records are being replayed: they are not in the index */
+  if (whc->npending > 0 || whc->end < whc->next_compact_size || whc->dead_bytes <= whc->live_bytes)
+    return;
+
+  const size_t new_end = sizeof (struct whc_store_hdr) + whc->live_bytes;
+  size_t map_size = WHC_STORE_INITIAL_MAP_SIZE;
+  while (map_size < 2 * new_end)
+    map_size *= 2;
+  char *tmppath = NULL;
+  unsigned char *base = NULL;
+  int fd;
+  (void) ddsrt_asprintf (&tmppath, "%s.tmp", whc->path);
+  if ((fd = open (tmppath, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0)
+    goto err_open;
+  if (flock (fd, LOCK_EX | LOCK_NB) != 0 || (base = store_map (fd, map_size)) == NULL)
+    goto err_map;
+
+  memcpy (base, whc->base, sizeof (struct whc_store_hdr));
+  store_squeeze_entries (whc);
+  size_t off = sizeof (struct whc_store_hdr);
+  for (uint32_t i = 0; i < whc->entries_n; i++)
+  {
+    const struct whc_store_rec *rec = rec_at (whc, whc->entries[i].off);
+    const size_t sz = rec_size (rec->size);
+    memcpy (base + off, rec, sz);
+    off += sz;
+  }
+  assert (off == new_end);
+  if (rename (tmppath, whc->path) != 0)
+    goto err_rename;
+
+  TRACE ("whc_store_compact(%p %s: %"PRIuSIZE" -> %"PRIuSIZE" bytes)\n", (void *) whc, whc->path, whc->end, new_end);
+  off = sizeof (struct whc_store_hdr);
+  for (uint32_t i = 0; i < whc->entries_n; i++)
+  {
+    const size_t sz = rec_size (rec_at (whc, whc->entries[i].off)->size);
+    whc->entries[i].off = off;
+    off += sz;
+  }
+  munmap (whc->base, whc->map_size);
+  close (whc->fd);
+  whc->fd = fd;
+  whc->base = base;
+  whc->map_size = map_size;
+  whc->end = new_end;
+  whc->dead_bytes = 0;
+  whc->next_compact_size = (2 * new_end > WHC_STORE_COMPACT_MIN_SIZE) ? 2 * new_end : WHC_STORE_COMPACT_MIN_SIZE;
+  ddsrt_free (tmppath);
+  return;
+
+err_rename:
+  munmap (base, map_size);
+err_map:
+  close (fd);
+  unlink (tmppath);
+err_open:
+  DDS_CWARNING (&whc->gv->logconfig, "%s: failed to compact transient-local store (errno %d)\n", whc->path, errno);
+  ddsrt_free (tmppath);
+  whc->next_compact_size = 2 * whc->end;
+}
+
+static void get_state_locked (const struct whc_store *whc, struct ddsi_whc_state *st)
+{
+  whc->inner->ops->get_state (whc->inner, st);
+  if (whc->entries_head < whc->entries_n)
+  {
+    const ddsi_seqno_t min_seq = whc->entries[whc->entries_head].seq;
+    const ddsi_seqno_t max_seq = whc->entries[whc->entries_n - 1].seq;
+    if (DDSI_WHCST_ISEMPTY (st))
+    {
+      st->min_seq = min_seq;
+      st->max_seq = max_seq;
+    }
+    else
+    {
+      if (min_seq < st->min_seq)
+        st->min_seq = min_seq;
+      if (max_seq > st->max_seq)
+        st->max_seq = max_seq;
+    }
+  }
+}
+
+static void whc_store_get_state (const struct ddsi_whc *whc_generic, struct ddsi_whc_state *st)
+{
+  struct whc_store * const whc = store_lock ((const struct whc_store *) whc_generic);
+  get_state_locked (whc, st);
+  ddsrt_mutex_unlock (&whc->lock);
+}
+
+static ddsi_seqno_t next_seq_locked (const struct whc_store *whc, ddsi_seqno_t seq)
+{
+  ddsi_seqno_t nseq = whc->inner->ops->next_seq (whc->inner, seq);
+  for (uint32_t i = store_lower_bound (whc, seq + 1); i < whc->entries_n && whc->entries[i].seq < nseq; i++)
+  {
+    if (whc->entries[i].off != WHC_STORE_NOOFF)
+    {
+      nseq = whc->entries[i].seq;
+      break;
+    }
+  }
+  return nseq;
+}
+
+static ddsi_seqno_t whc_store_next_seq (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq)
+{
+  struct whc_store * const whc = store_lock ((const struct whc_store *) whc_generic);
+  ddsi_seqno_t nseq;
+  nseq = next_seq_locked (whc, seq);
+  ddsrt_mutex_unlock (&whc->lock);
+  return nseq;
+}
+
+static struct ddsi_serdata *store_make_serdata (const struct whc_store *whc, const struct ddsi_sertype *type, uint64_t off, bool trusted)
+{
+  /* records written by this incarnation hold what the default serdata serialized itself,
+     so those can be copied as-is; anything else (e.g. loaded from the file) gets checked */
+  const struct whc_store_rec *rec = rec_at (whc, off);
+  struct ddsi_serdata *sd;
+  if (trusted && type->ops == &dds_sertype_ops_default)
+    sd = dds_serdata_default_from_ser_well_formed (type, (enum ddsi_serdata_kind) rec->kind, rec + 1, rec->size);
+  else
+  {
+    const ddsrt_iovec_t iov = { .iov_base = (void *) (rec + 1), .iov_len = (ddsrt_iov_len_t) rec->size };
+    sd = ddsi_serdata_from_ser_iov (type, (enum ddsi_serdata_kind) rec->kind, 1, &iov, rec->size);
+  }
+  if (sd == NULL)
+    return NULL;
+  sd->statusinfo = rec->statusinfo;
+  sd->timestamp.v = rec->timestamp;
+  return sd;
+}
+
+static bool borrow_sample_locked (const struct whc_store *whc, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample)
+{
+  const struct whc_store_entry *e;
+  if (whc->inner->ops->borrow_sample (whc->inner, seq, sample))
+    return true;
+  if (whc->type == NULL || (e = store_findseq (whc, seq)) == NULL)
+    return false;
+  /* a copy that only this borrower references, the volatile WHC doesn't know the sequence
+     number and so return_sample of the volatile WHC simply drops the reference */
+  if ((sample->serdata = store_make_serdata (whc, whc->type, e->off, true)) == NULL)
+    return false;
+  sample->seq = seq;
+  sample->unacked = false;
+  sample->rexmit_count = 0;
+  sample->last_rexmit_ts.v = 0;
+  /* filter results are not kept in the file */
+  sample->filter_rejects = 0;
+  sample->filter_rejects_valid = false;
+  return true;
+}
+
+static bool whc_store_borrow_sample (const struct ddsi_whc *whc_generic, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample)
+{
+  struct whc_store * const whc = store_lock ((const struct whc_store *) whc_generic);
+  bool found;
+  found = borrow_sample_locked (whc, seq, sample);
+  ddsrt_mutex_unlock (&whc->lock);
+  return found;
+}
+
+static bool whc_store_borrow_sample_key (const struct ddsi_whc *whc_generic, const struct ddsi_serdata *serdata_key, struct ddsi_whc_borrowed_sample *sample)
+{
+  struct whc_store * const whc = store_lock ((const struct whc_store *) whc_generic);
+  const struct whc_store_inst *inst;
+  bool found;
+  if ((inst = store_lookup_inst (whc, ddsi_tkmap_lookup (whc->gv->m_tkmap, serdata_key))) == NULL || inst->n == 0)
+    found = whc->inner->ops->borrow_sample_key (whc->inner, serdata_key, sample);
+  else
+  {
+    const uint32_t k = inst->head + inst->n - 1;
+    found = borrow_sample_locked (whc, inst->hist[(k >= inst->size) ? k - inst->size : k], sample);
+  }
+  ddsrt_mutex_unlock (&whc->lock);
+  return found;
+}
+
+static void whc_store_return_sample (struct ddsi_whc *whc_generic, struct ddsi_whc_borrowed_sample *sample, bool update_retransmit_info)
+{
+  struct whc_store * const whc = (struct whc_store *) whc_generic;
+  ddsrt_mutex_lock (&whc->lock);
+  whc->inner->ops->return_sample (whc->inner, sample, update_retransmit_info);
+  ddsrt_mutex_unlock (&whc->lock);
+}
+
+static void whc_store_sample_iter_init (const struct ddsi_whc *whc_generic, struct ddsi_whc_sample_iter *opaque_it)
+{
+  struct whc_store_sample_iter *it = (struct whc_store_sample_iter *) opaque_it;
+  it->c.whc = (struct ddsi_whc *) whc_generic;
+  it->first = true;
+}
+
+static bool whc_store_sample_iter_borrow_next (struct ddsi_whc_sample_iter *opaque_it, struct ddsi_whc_borrowed_sample *sample)
+{
+  struct whc_store_sample_iter * const it = (struct whc_store_sample_iter *) opaque_it;
+  struct whc_store * const whc = store_lock ((struct whc_store *) it->c.whc);
+  ddsi_seqno_t seq;
+  bool valid = false;
+  if (!it->first)
+  {
+    seq = sample->seq;
+    whc->inner->ops->return_sample (whc->inner, sample, false);
+  }
+  else
+  {
+    it->first = false;
+    seq = 0;
+  }
+  /* skip samples for which no serdata can be constructed */
+  while (!valid && (seq = next_seq_locked (whc, seq)) != DDSI_MAX_SEQ_NUMBER)
+    valid = borrow_sample_locked (whc, seq, sample);
+  ddsrt_mutex_unlock (&whc->lock);
+  return valid;
+}
+
+static void whc_store_free_deferred_free_list (struct ddsi_whc *whc_generic, struct ddsi_whc_node *deferred_free_list)
+{
+  struct whc_store * const whc = (struct whc_store *) whc_generic;
+  whc->inner->ops->free_deferred_free_list (whc->inner, deferred_free_list);
+}
+
+static uint32_t whc_store_remove_acked_messages (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, struct ddsi_whc_state *whcst, struct ddsi_whc_node **deferred_free_list)
+{
+  struct whc_store * const whc = store_lock ((struct whc_store *) whc_generic);
+  uint32_t cnt;
+  cnt = whc->inner->ops->remove_acked_messages (whc->inner, max_drop_seq, whcst, deferred_free_list);
+  get_state_locked (whc, whcst);
+  ddsrt_mutex_unlock (&whc->lock);
+  return cnt;
+}
+
+static int whc_store_insert (struct ddsi_whc *whc_generic, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects)
+{
+  struct whc_store * const whc = store_lock ((struct whc_store *) whc_generic);
+  struct whc_store_inst *inst;
+  int ret;
+  TRACE ("whc_store_insert(%p max_drop_seq %"PRIu64" seq %"PRIu64" serdata %p:%"PRIx32")\n",
+         (void *) whc, max_drop_seq, seq, (void *) serdata, serdata->hash);
+  /* A sample that is acknowledged already (for lack of reliable readers) only goes into
+     the volatile WHC if it tracks deadlines, just like for a volatile writer, and then
+     is removed immediately */
+  if (seq > max_drop_seq || whc->has_deadline)
+    ret = whc->inner->ops->insert (whc->inner, max_drop_seq, seq, exp, serdata, tk, filter_rejects);
+  else
+    ret = 0;
+  if (seq <= max_drop_seq)
+  {
+    struct ddsi_whc_node *deferred_free_list = NULL;
+    struct ddsi_whc_state whcst;
+    (void) whc->inner->ops->remove_acked_messages (whc->inner, max_drop_seq, &whcst, &deferred_free_list);
+    whc->inner->ops->free_deferred_free_list (whc->inner, deferred_free_list);
+  }
+
+  /* Same as the default WHC: empty data (such as commit messages) isn't part of the history
+     and an unregister ends the history of the instance */
+  if (serdata->kind == SDK_EMPTY)
+    ;
+  else if (serdata->statusinfo & DDSI_STATUSINFO_UNREGISTER)
+  {
+    if ((inst = store_lookup_inst (whc, tk->m_iid)) != NULL)
+      store_drop_inst (whc, inst);
+  }
+  else
+  {
+    uint64_t off;
+    if (whc->type == NULL)
+      whc->type = serdata->type;
+    if ((off = store_append (whc, serdata)) == WHC_STORE_NOOFF)
+      DDS_CWARNING (&whc->gv->logconfig, "%s: failed to store sample %"PRIu64" (errno %d)\n", whc->path, seq, errno);
+    else
+    {
+      store_add_entry (whc, seq, off, tk->m_iid, exp);
+      if ((inst = store_lookup_inst (whc, tk->m_iid)) == NULL)
+      {
+        inst = ddsrt_malloc (sizeof (*inst));
+        inst->iid = tk->m_iid;
+        inst->tk = tk;
+        ddsi_tkmap_instance_ref (tk);
+        inst->head = 0;
+        inst->n = 0;
+        inst->size = (whc->tldepth > 0) ? whc->tldepth : 4;
+        inst->hist = ddsrt_malloc (inst->size * sizeof (*inst->hist));
+        ddsrt_hh_add_absent (whc->inst_hash, inst);
+      }
+      store_push_hist (whc, inst, seq);
+      store_maybe_compact (whc);
+    }
+  }
+  ddsrt_mutex_unlock (&whc->lock);
+  return ret;
+}
+
+static void whc_store_free (struct ddsi_whc *whc_generic)
+{
+  struct whc_store * const whc = (struct whc_store *) whc_generic;
+  struct ddsrt_hh_iter it;
+  struct whc_store_inst *inst;
+  whc->inner->ops->free (whc->inner);
+  for (inst = ddsrt_hh_iter_first (whc->inst_hash, &it); inst != NULL; inst = ddsrt_hh_iter_next (&it))
+  {
+    ddsi_tkmap_instance_unref (whc->gv->m_tkmap, inst->tk);
+    ddsrt_free (inst->hist);
+    ddsrt_free (inst);
+  }
+  ddsrt_hh_free (whc->inst_hash);
+  for (uint32_t i = whc->entries_head; i < whc->entries_n; i++)
+    ddsrt_free (whc->entries[i].exp);
+  munmap (whc->base, whc->map_size);
+  /* drop the unused tail of the mapping so that the file doesn't grow forever */
+  if (ftruncate (whc->fd, (off_t) whc->end) != 0)
+    DDS_CWARNING (&whc->gv->logconfig, "%s: failed to truncate transient-local store (errno %d)\n", whc->path, errno);
+  close (whc->fd);
+  ddsrt_free (whc->pending);
+  ddsrt_free (whc->entries);
+  ddsrt_free (whc->path);
+  ddsrt_mutex_destroy (&whc->lock);
+  ddsrt_free (whc);
+}
+
+static uint32_t store_type_hash (const struct ddsi_sertype *type)
+{
+  /* the type name alone doesn't catch a changed definition, the type identifier does */
+  uint32_t h = ddsrt_mh3 (type->type_name, strlen (type->type_name), 0);
+#ifdef DDS_HAS_TYPELIB
+  ddsi_typeinfo_t *type_info;
+  if ((type_info = ddsi_sertype_typeinfo (type)) != NULL)
+  {
+    const ddsi_typeid_t *type_id;
+    if ((type_id = ddsi_typeinfo_complete_typeid (type_info)) == NULL || ddsi_typeid_is_none (type_id))
+      type_id = ddsi_typeinfo_minimal_typeid (type_info);
+    const uint32_t tid_hash = ddsi_typeid_hash (type_id);
+    h = ddsrt_mh3 (&tid_hash, sizeof (tid_hash), h);
+    ddsi_typeinfo_free (type_info);
+  }
+#endif
+  return h;
+}
+
+static char *store_path (const struct ddsi_domaingv *gv, const struct dds_writer *wr)
+{
+  /* topic name for recognizability, type name and partitions only in the hash */
+  const dds_qos_t *qos = wr->m_entity.m_qos;
+  const char *type_name = wr->m_topic->m_stype->type_name;
+  uint32_t h = ddsrt_mh3 (type_name, strlen (type_name), 0);
+  if (qos->present & DDSI_QP_PARTITION)
+  {
+    for (uint32_t i = 0; i < qos->partition.n; i++)
+      h = ddsrt_mh3 (qos->partition.strs[i], strlen (qos->partition.strs[i]) + 1, h);
+  }
+  char *name = ddsrt_strdup (wr->m_topic->m_name);
+  for (char *p = name; *p; p++)
+  {
+    if (!((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || *p == '-' || *p == '_' || *p == '.'))
+      *p = '_';
+  }
+  char *path = NULL;
+  (void) ddsrt_asprintf (&path, "%s/%s-%08"PRIx32".whc", gv->config.tl_store_directory, name, h);
+  ddsrt_free (name);
+  return path;
+}
+
+static void store_load (struct whc_store *whc, size_t file_size)
+{
+  /* collect the live records, they get replayed once the writer exists, until then they
+     are counted as dead as they are not in the history of this incarnation */
+  size_t off = sizeof (struct whc_store_hdr);
+  uint32_t size_pending = 0;
+  while (off + sizeof (struct whc_store_rec) <= file_size)
+  {
+    const struct whc_store_rec *rec = (const struct whc_store_rec *) (whc->base + off);
+    if (rec->state != WHC_STORE_REC_LIVE && rec->state != WHC_STORE_REC_DEAD)
+      break;
+    const size_t sz = rec_size (rec->size);
+    if (sz > file_size - off)
+      break;
+    if (rec->state == WHC_STORE_REC_LIVE && (rec->kind == (uint32_t) SDK_KEY || rec->kind == (uint32_t) SDK_DATA))
+    {
+      if (whc->npending == size_pending)
+      {
+        size_pending = (size_pending == 0) ? 64 : 2 * size_pending;
+        whc->pending = ddsrt_realloc (whc->pending, size_pending * sizeof (*whc->pending));
+      }
+      whc->pending[whc->npending++] = off;
+    }
+    off += sz;
+  }
+  whc->end = off;
+  whc->dead_bytes = off - sizeof (struct whc_store_hdr);
+}
+
+struct ddsi_whc *dds_whc_store_new (struct ddsi_domaingv *gv, const struct dds_writer *wr, uint32_t tldepth, struct ddsi_whc *inner)
+{
+  struct whc_store *whc = ddsrt_malloc (sizeof (*whc));
+  struct stat st;
+  whc->common.ops = &whc_store_ops;
+  whc->gv = gv;
+  whc->inner = inner;
+  whc->type = NULL;
+  whc->tldepth = tldepth;
+  whc->has_deadline = (wr->m_entity.m_qos->deadline.deadline != DDS_INFINITY);
+  whc->path = store_path (gv, wr);
+  whc->type_hash = store_type_hash (wr->m_topic->m_stype);
+  whc->base = NULL;
+  whc->map_size = 0;
+  whc->end = sizeof (struct whc_store_hdr);
+  whc->live_bytes = 0;
+  whc->dead_bytes = 0;
+  whc->next_compact_size = WHC_STORE_COMPACT_MIN_SIZE;
+  whc->entries = NULL;
+  whc->entries_head = whc->entries_n = whc->entries_size = whc->entries_ndead = 0;
+  ddsrt_fibheap_init (&whc_store_exp_fhdef, &whc->exp_heap);
+  whc->pending = NULL;
+  whc->npending = 0;
+
+  if ((whc->fd = open (whc->path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) < 0)
+  {
+    DDS_CWARNING (&gv->logconfig, "%s: can't open transient-local store (errno %d)\n", whc->path, errno);
+    goto err_open;
+  }
+  if (flock (whc->fd, LOCK_EX | LOCK_NB) != 0)
+  {
+    DDS_CWARNING (&gv->logconfig, "%s: transient-local store in use by another writer\n", whc->path);
+    goto err_lock;
+  }
+  if (fstat (whc->fd, &st) != 0)
+    goto err_map;
+  const size_t file_size = (size_t) st.st_size;
+  size_t map_size = WHC_STORE_INITIAL_MAP_SIZE;
+  while (map_size < file_size)
+    map_size *= 2;
+  if ((whc->base = store_map (whc->fd, map_size)) == NULL)
+  {
+    DDS_CWARNING (&gv->logconfig, "%s: can't map transient-local store (errno %d)\n", whc->path, errno);
+    goto err_map;
+  }
+  whc->map_size = map_size;
+  if (store_header_ok (whc, file_size))
+    store_load (whc, file_size);
+  else
+  {
+    if (file_size > 0)
+      DDS_CWARNING (&gv->logconfig, "%s: discarding contents of transient-local store for a different type or version\n", whc->path);
+    memset (whc->base, 0, file_size < map_size ? file_size : map_size);
+    store_write_header (whc);
+  }
+  ddsrt_mutex_init (&whc->lock);
+  whc->inst_hash = ddsrt_hh_new (1, whc_store_inst_hash, whc_store_inst_eq);
+  DDS_CLOG (DDS_LC_WHC, &gv->logconfig, "whc_store_new(%p %s: %"PRIu32" samples loaded)\n", (void *) whc, whc->path, whc->npending);
+  return &whc->common;
+
+err_map:
+err_lock:
+  close (whc->fd);
+err_open:
+  ddsrt_free (whc->path);
+  ddsrt_free (whc);
+  return NULL;
+}
+
+void dds_whc_store_replay (struct ddsi_whc *whc_generic, const struct ddsi_sertype *type, dds_whc_store_replay_fn_t fn, void *arg)
+{
+  if (whc_generic->ops != &whc_store_ops)
+    return;
+  struct whc_store * const whc = (struct whc_store *) whc_generic;
+  ddsrt_mutex_lock (&whc->lock);
+  for (uint32_t i = 0; i < whc->npending; i++)
+  {
+    struct ddsi_serdata *sd;
+    dds_return_t rc;
+    if ((sd = store_make_serdata (whc, type, whc->pending[i], false)) == NULL)
+      rc = DDS_RETCODE_ERROR;
+    else
+    {
+      /* storing it again requires the lock and may remap the file */
+      ddsrt_mutex_unlock (&whc->lock);
+      rc = fn (arg, sd);
+      ddsrt_mutex_lock (&whc->lock);
+    }
+    if (rc != DDS_RETCODE_OK)
+    {
+      DDS_CWARNING (&whc->gv->logconfig, "%s: failed to replay stored samples, dropping %"PRIu32" of them\n", whc->path, whc->npending - i);
+      break;
+    }
+    rec_at (whc, whc->pending[i])->state = WHC_STORE_REC_DEAD;
+  }
+  ddsrt_free (whc->pending);
+  whc->pending = NULL;
+  whc->npending = 0;
+  ddsrt_mutex_unlock (&whc->lock);
+}
+
+#else /* _WIN32 */
+
+struct ddsi_whc *dds_whc_store_new (struct ddsi_domaingv *gv, const struct dds_writer *wr, uint32_t tldepth, struct ddsi_whc *inner)
+{
+  (void) wr; (void) tldepth; (void) inner;
+  DDS_CWARNING (&gv->logconfig, "transient-local store not supported on this platform\n");
+  return NULL;
+}
+
+void dds_whc_store_replay (struct ddsi_whc *whc, const struct ddsi_sertype *type, dds_whc_store_replay_fn_t fn, void *arg)
+{
+  (void) whc; (void) type; (void) fn; (void) arg;
+}
+
+#endif /* _WIN32 */
@@ -31,6 +31,7 @@
 #include "dds__loaned_sample.h"
 #include "dds__psmx.h"
 #include "dds__guid.h"
+#include "dds__topic_filter.h"
 
 extern inline bool dds_source_timestamp_is_valid_ddsi_time (dds_time_t timestamp, ddsi_protocol_version_t protover);
 
@@ -563,6 +564,11 @@ static bool evaluate_topic_filter (const dds_writer *wr, const void *data, enum
         return false;
       break;
     }
+    case DDS_TOPIC_FILTER_MEMBERS:
+    case DDS_TOPIC_FILTER_EXPRESSION:
+      if (!dds_topic_member_filter_accepts_sample (wr->m_topic->m_member_filter, data))
+        return false;
+      break;
   }
   return true;
 }
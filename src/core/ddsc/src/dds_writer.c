@@ -29,6 +29,7 @@
 #include "dds/cdr/dds_cdrstream.h"
 #include "dds/ddsc/dds_internal_api.h"
 #include "dds__writer.h"
+#include "dds__write.h"
 #include "dds__listener.h"
 #include "dds__init.h"
 #include "dds__publisher.h"
@@ -36,6 +37,7 @@
 #include "dds__get_status.h"
 #include "dds__qos.h"
 #include "dds__whc.h"
+#include "dds__whc_store.h"
 #include "dds__statistics.h"
 #include "dds__psmx.h"
 #include "dds__heap_loan.h"
@@ -266,7 +268,11 @@ static const struct dds_stat_keyvalue_descriptor dds_writer_statistics_kv[] = {
   { "rexmit_bytes", DDS_STAT_KIND_UINT64 },
   { "throttle_count", DDS_STAT_KIND_UINT32 },
   { "time_throttle", DDS_STAT_KIND_UINT64 },
-  { "time_rexmit", DDS_STAT_KIND_UINT64 }
+  { "time_rexmit", DDS_STAT_KIND_UINT64 },
+  { "whc_unacked_bytes", DDS_STAT_KIND_UINT64 },
+  { "domain_whc_unacked_bytes", DDS_STAT_KIND_UINT64 },
+  { "replay_bytes", DDS_STAT_KIND_UINT64 },
+  { "readers_replaying", DDS_STAT_KIND_UINT32 }
 };
 
 static const struct dds_stat_descriptor dds_writer_statistics_desc = {
@@ -283,7 +289,11 @@ static void dds_writer_refresh_statistics (const struct dds_entity *entity, stru
 {
   const struct dds_writer *wr = (const struct dds_writer *) entity;
   if (wr->m_wr)
+  {
     ddsi_get_writer_stats (wr->m_wr, &stat->kv[0].u.u64, &stat->kv[1].u.u32, &stat->kv[2].u.u64, &stat->kv[3].u.u64);
+    ddsi_get_writer_whc_stats (wr->m_wr, &stat->kv[4].u.u64, &stat->kv[5].u.u64);
+    ddsi_get_writer_replay_stats (wr->m_wr, &stat->kv[6].u.u64, &stat->kv[7].u.u32);
+  }
 }
 
 const struct dds_entity_deriver dds_entity_deriver_writer = {
@@ -298,6 +308,12 @@ const struct dds_entity_deriver dds_entity_deriver_writer = {
 };
 
 
+static dds_return_t replay_stored_sample (void *varg, struct ddsi_serdata *serdata)
+{
+  struct dds_writer * const wr = varg;
+  return dds_writecdr_impl (wr, wr->m_xp, serdata, !wr->whc_batch);
+}
+
 static dds_entity_t dds_create_writer_int (dds_entity_t participant_or_publisher, dds_guid_t *guid, dds_entity_t topic, const dds_qos_t *qos, const dds_listener_t *listener)
 {
   dds_return_t rc;
@@ -455,6 +471,12 @@ static dds_entity_t dds_create_writer_int (dds_entity_t participant_or_publisher
   dds_topic_unpin (tp);
   dds_publisher_unlock (pub);
 
+  // Samples loaded from a transient-local store are published again now that the writer
+  // exists and can assign them sequence numbers
+  ddsrt_mutex_lock (&wr->m_entity.m_mutex);
+  dds_whc_store_replay (wr->m_whc, wr->m_wr->type, replay_stored_sample, wr);
+  ddsrt_mutex_unlock (&wr->m_entity.m_mutex);
+
   // start async thread if not already started and the latency budget is non zero
   ddsrt_mutex_lock (&gv->sendq_running_lock);
   if (async_mode && !gv->sendq_running) {
@@ -0,0 +1,127 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+
+#include "dds/dds.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
+#include "test_common.h"
+
+#define NTOPICS 8
+#define NSAMPLES 50
+
+static dds_entity_t create_dq_domain (dds_domainid_t domid, int ndqueues)
+{
+  const char *config_fmt =
+    "<General>"
+    "  <Interfaces><NetworkInterface address=\"127.0.0.1\"/></Interfaces>"
+    "  <AllowMulticast>false</AllowMulticast>"
+    "</General>"
+    "<Discovery>"
+    "  <ExternalDomainId>0</ExternalDomainId>"
+    "  <Tag>${CYCLONEDDS_PID}</Tag>"
+    "  <ParticipantIndex>auto</ParticipantIndex>"
+    "  <Peers><Peer address=\"127.0.0.1\"/></Peers>"
+    "</Discovery>"
+    "<Internal><DeliveryQueues>%d</DeliveryQueues></Internal>";
+  char *config = NULL;
+  (void) ddsrt_asprintf (&config, config_fmt, ndqueues);
+  const dds_entity_t dom = dds_create_domain (domid, config);
+  ddsrt_free (config);
+  return dom;
+}
+
+CU_Test (ddsc_delivery_queues, bad_config)
+{
+  CU_ASSERT_LT (create_dq_domain (0, 0), 0);
+  CU_ASSERT_LT (create_dq_domain (0, 9), 0);
+}
+
+CU_TheoryDataPoints (ddsc_delivery_queues, ordering) = {
+  CU_DataPoints (int, 1, 4, 8)
+};
+
+CU_Theory ((int ndqueues), ddsc_delivery_queues, ordering, .timeout = 30)
+{
+  const dds_entity_t dom_pub = create_dq_domain (0, ndqueues);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = create_dq_domain (1, ndqueues);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  const dds_entity_t pp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  const dds_entity_t pp_sub = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_sub, 0);
+
+  // Writers for different topics end up in different delivery queues (most likely,
+  // it depends on the GUIDs), the data of each must still arrive in order
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  dds_entity_t wr[NTOPICS], rd[NTOPICS];
+  for (int t = 0; t < NTOPICS; t++)
+  {
+    char topicname[100];
+    create_unique_topic_name ("ddsc_delivery_queues", topicname, sizeof (topicname));
+    const dds_entity_t tp_pub = dds_create_topic (pp_pub, &Space_Type1_desc, topicname, qos, NULL);
+    CU_ASSERT_GT_FATAL (tp_pub, 0);
+    const dds_entity_t tp_sub = dds_create_topic (pp_sub, &Space_Type1_desc, topicname, qos, NULL);
+    CU_ASSERT_GT_FATAL (tp_sub, 0);
+    wr[t] = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+    CU_ASSERT_GT_FATAL (wr[t], 0);
+    rd[t] = dds_create_reader (pp_sub, tp_sub, qos, NULL);
+    CU_ASSERT_GT_FATAL (rd[t], 0);
+  }
+  dds_delete_qos (qos);
+  for (int t = 0; t < NTOPICS; t++)
+    sync_reader_writer (pp_sub, rd[t], pp_pub, wr[t]);
+
+  dds_return_t rc;
+  for (int32_t i = 0; i < NSAMPLES; i++)
+  {
+    for (int t = 0; t < NTOPICS; t++)
+    {
+      rc = dds_write (wr[t], &(Space_Type1){ 0, i, t });
+      CU_ASSERT_EQ_FATAL (rc, 0);
+    }
+  }
+
+  int32_t nreceived[NTOPICS] = { 0 };
+  int ndone = 0;
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  while (ndone < NTOPICS && dds_time () < tend)
+  {
+    ndone = 0;
+    for (int t = 0; t < NTOPICS; t++)
+    {
+      Space_Type1 sample;
+      void *raw = &sample;
+      dds_sample_info_t si;
+      while ((rc = dds_take (rd[t], &raw, &si, 1, 1)) == 1)
+      {
+        CU_ASSERT_FATAL (si.valid_data);
+        CU_ASSERT_EQ_FATAL (sample.long_2, nreceived[t]);
+        CU_ASSERT_EQ_FATAL (sample.long_3, t);
+        nreceived[t]++;
+      }
+      CU_ASSERT_GEQ_FATAL (rc, 0);
+      if (nreceived[t] == NSAMPLES)
+        ndone++;
+    }
+    if (ndone < NTOPICS)
+      dds_sleepfor (DDS_MSECS (10));
+  }
+  CU_ASSERT_EQ (ndone, NTOPICS);
+
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+}
@@ -24,10 +24,20 @@
 #include <assert.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
 
 #include "dds/dds.h"
+#include "dds/ddsrt/heap.h"
 #include "dds/ddsrt/misc.h"
 #include "dds/ddsrt/attributes.h"
+#include "dds/ddsrt/environ.h"
+#include "dds/ddsi/ddsi_endpoint.h"
+#include "ddsi__whc.h"
+#include "ddsi__endpoint_match.h"
+#include "dds__entity.h"
+#include "dds__types.h"
 
 #include "test_common.h"
 
@@ -184,6 +194,37 @@ static void checkdata (dds_entity_t rd, const struct exp *exp, const char *heade
   }
 }
 
+struct simpletypes_case {
+  Space_simpletypes x; // written sample, s must be unique
+  bool accept; // whether the filter accepts it
+};
+
+static void checkdata_simpletypes (dds_entity_t rd, const struct simpletypes_case *xs, size_t nxs)
+{
+  Space_simpletypes data[MAXSAMPLES];
+  void *raw[MAXSAMPLES];
+  dds_sample_info_t si[MAXSAMPLES];
+  for (int i = 0; i < MAXSAMPLES; i++)
+    raw[i] = &data[i];
+  memset (data, 0, sizeof (data));
+  dds_return_t naccept = 0;
+  for (size_t k = 0; k < nxs; k++)
+    naccept += xs[k].accept;
+  const dds_return_t ret = dds_take (rd, raw, si, MAXSAMPLES, MAXSAMPLES);
+  CU_ASSERT_EQ_FATAL (ret, naccept);
+  for (int i = 0; i < ret; i++)
+  {
+    bool found = false;
+    for (size_t k = 0; k < nxs && !found; k++)
+      if (strcmp (xs[k].x.s, data[i].s) == 0)
+        found = xs[k].accept;
+    tprintf ("accepted %s\n", data[i].s);
+    CU_ASSERT_FATAL (found);
+  }
+  for (int i = 0; i < ret; i++)
+    Space_simpletypes_free (&data[i], DDS_FREE_CONTENTS);
+}
+
 CU_Test (ddsc_filter, basic)
 {
   dds_entity_t dp[2], tp[2][2], rd[2][2], wr[2][2];
@@ -645,3 +686,771 @@ CU_Test (ddsc_filter, sampleinfo)
   dds_delete (dp);
 }
 
+
+CU_Test (ddsc_filter, members_getset)
+{
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  const dds_entity_t dp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp, 0);
+  const dds_entity_t tp = dds_create_topic (dp, &Space_simpletypes_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+
+  dds_topic_filter_member_predicate_t ps[DDS_TOPIC_FILTER_MEMBERS_MAX + 1];
+  for (uint32_t i = 0; i < DDS_TOPIC_FILTER_MEMBERS_MAX + 1; i++)
+    ps[i] = (dds_topic_filter_member_predicate_t) { .offset = offsetof (Space_simpletypes, l), .op = DDS_TOPIC_FILTER_MEMBER_EQ, .value.i = (int64_t) i };
+
+  // invalid arguments
+  ret = dds_set_topic_filter_members (tp, 1, NULL);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+  ret = dds_set_topic_filter_members (tp, DDS_TOPIC_FILTER_MEMBERS_MAX + 1, ps);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+  ret = dds_set_topic_filter_members (tp, 1, &(dds_topic_filter_member_predicate_t){ .offset = 0, .op = (enum dds_topic_filter_member_op) 42 });
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+  ret = dds_set_topic_filter_members (tp, 1, &(dds_topic_filter_member_predicate_t){ .offset = offsetof (Space_simpletypes, s), .op = DDS_TOPIC_FILTER_MEMBER_EQ, .value.s = NULL });
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+  // not the offset of a member
+  ret = dds_set_topic_filter_members (tp, 1, &(dds_topic_filter_member_predicate_t){ .offset = offsetof (Space_simpletypes, l) + 1, .op = DDS_TOPIC_FILTER_MEMBER_EQ });
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_UNSUPPORTED);
+  ret = dds_set_topic_filter_members (tp, 1, &(dds_topic_filter_member_predicate_t){ .offset = sizeof (Space_simpletypes), .op = DDS_TOPIC_FILTER_MEMBER_EQ });
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_UNSUPPORTED);
+
+  // so is the nesting of NOT and parentheses, the expressions may come from remote readers
+  // and must not be able to exhaust the stack
+  const struct { const char *pre, *post; int depth; dds_return_t ret; } nested[] = {
+    { "(", ")", 32, 0 }, { "(", ")", 33, DDS_RETCODE_BAD_PARAMETER },
+    { "(", ")", 100000, DDS_RETCODE_BAD_PARAMETER }, { "NOT ", "", 100000, DDS_RETCODE_BAD_PARAMETER }
+  };
+  for (size_t k = 0; k < sizeof (nested) / sizeof (nested[0]); k++)
+  {
+    char *deep = ddsrt_malloc ((size_t) nested[k].depth * 5 + 10), *q = deep;
+    for (int i = 0; i < nested[k].depth; i++)
+      q += sprintf (q, "%s", nested[k].pre);
+    q += sprintf (q, "l = 1");
+    for (int i = 0; i < nested[k].depth; i++)
+      q += sprintf (q, "%s", nested[k].post);
+    ret = dds_set_topic_filter_expression (tp, deep, 0, NULL);
+    CU_ASSERT_EQ_FATAL (ret, nested[k].ret);
+    ddsrt_free (deep);
+  }
+  ret = dds_set_topic_filter_expression (tp, "((((NOT (l = 1))))) AND NOT NOT NOT (l = 2)", 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_set_topic_filter_expression (tp, NULL, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  // failures leave the topic unfiltered
+  struct dds_topic_filter f;
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_NONE);
+
+  ret = dds_set_topic_filter_members (tp, DDS_TOPIC_FILTER_MEMBERS_MAX, ps);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_MEMBERS);
+  dds_topic_filter_arg_fn fn;
+  void *arg;
+  ret = dds_get_topic_filter_and_arg (tp, &fn, &arg);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_PRECONDITION_NOT_MET);
+  // filter mode MEMBERS can't be set via the generic interface
+  f = (struct dds_topic_filter) { .mode = DDS_TOPIC_FILTER_MEMBERS };
+  ret = dds_set_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+
+  // setting a function filter replaces the member filter
+  ret = dds_set_topic_filter_and_arg (tp, filter_long1_eq, (void *) 1);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_SAMPLE_ARG);
+
+  // no predicates means no filter
+  ret = dds_set_topic_filter_members (tp, 1, ps);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_set_topic_filter_members (tp, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_NONE);
+
+  dds_delete (dp);
+}
+
+CU_Test (ddsc_filter, members_basic)
+{
+  dds_entity_t dp[2], tp[2], rd[2], wr[2];
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  for (int i = 0; i < 2; i++)
+  {
+    dp[i] = dds_create_participant (0, NULL, NULL);
+    CU_ASSERT_GT_FATAL (dp[i], 0);
+    tp[i] = dds_create_topic (dp[i], &Space_Type1_desc, topicname, qos, NULL);
+    CU_ASSERT_GT_FATAL (tp[i], 0);
+    rd[i] = dds_create_reader (dp[i], tp[i], qos, NULL);
+    CU_ASSERT_GT_FATAL (rd[i], 0);
+    wr[i] = dds_create_writer (dp[i], tp[i], qos, NULL);
+    CU_ASSERT_GT_FATAL (wr[i], 0);
+  }
+  dds_delete_qos (qos);
+
+  const dds_topic_filter_member_predicate_t ps[] = {
+    { .offset = offsetof (Space_Type1, long_2), .op = DDS_TOPIC_FILTER_MEMBER_GE, .value.i = 1 },
+    { .offset = offsetof (Space_Type1, long_3), .op = DDS_TOPIC_FILTER_MEMBER_NE, .value.i = 2 },
+    { .offset = offsetof (Space_Type1, long_3), .op = DDS_TOPIC_FILTER_MEMBER_GT, .value.i = -3 }
+  };
+  ret = dds_set_topic_filter_members (tp[0], sizeof (ps) / sizeof (ps[0]), ps);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  // wr[0] filters on the sample, rd[0] filters on the serialized data
+  const Space_Type1 xs[] = { {1,0,0}, {2,1,1}, {3,1,2}, {4,2,-3}, {5,2,-2}, {6,-1,1} };
+  for (int i = 0; i < 2; i++)
+  {
+    for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+    {
+      Space_Type1 x = xs[k];
+      x.long_1 += 10 * i;
+      ret = dds_write (wr[i], &x);
+      CU_ASSERT_EQ_FATAL (ret, 0);
+    }
+  }
+
+  const struct exp exp[2] = {
+    [0] = {
+      .n = 4, .xs = (const Space_Type1[]) {
+        {2,1,1}, {5,2,-2}, {12,1,1}, {15,2,-2}
+      }
+    },
+    [1] = {
+      .n = 8, .xs = (const Space_Type1[]) {
+        {2,1,1}, {5,2,-2},
+        {11,0,0}, {12,1,1}, {13,1,2}, {14,2,-3}, {15,2,-2}, {16,-1,1}
+      }
+    }
+  };
+  for (int i = 0; i < 2; i++)
+    checkdata (rd[i], &exp[i], "rd[%d]:", i);
+  for (int i = 0; i < 2; i++)
+    dds_delete (dp[i]);
+}
+
+CU_Test (ddsc_filter, members_types)
+{
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp, 0);
+  const dds_entity_t dp1 = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp1, 0);
+  const dds_entity_t tp = dds_create_topic (dp, &Space_simpletypes_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  const dds_entity_t tp1 = dds_create_topic (dp1, &Space_simpletypes_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp1, 0);
+  const dds_entity_t rd = dds_create_reader (dp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t wr = dds_create_writer (dp1, tp1, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+
+  const dds_topic_filter_member_predicate_t ps[] = {
+    { .offset = offsetof (Space_simpletypes, s), .op = DDS_TOPIC_FILTER_MEMBER_GT, .value.s = "b" },
+    { .offset = offsetof (Space_simpletypes, ll), .op = DDS_TOPIC_FILTER_MEMBER_LT, .value.i = 0 },
+    { .offset = offsetof (Space_simpletypes, us), .op = DDS_TOPIC_FILTER_MEMBER_GE, .value.u = 65535 },
+    { .offset = offsetof (Space_simpletypes, f), .op = DDS_TOPIC_FILTER_MEMBER_NE, .value.d = 1.5 },
+    { .offset = offsetof (Space_simpletypes, d), .op = DDS_TOPIC_FILTER_MEMBER_LE, .value.d = 2.5 },
+    { .offset = offsetof (Space_simpletypes, b), .op = DDS_TOPIC_FILTER_MEMBER_EQ, .value.u = 1 }
+  };
+  ret = dds_set_topic_filter_members (tp, sizeof (ps) / sizeof (ps[0]), ps);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  const struct simpletypes_case xs[] = {
+    { { .s = "a", .ll = -1, .us = 65535, .f = 0.0f, .d = 0.0, .b = true }, false },
+    { { .s = "b", .ll = -1, .us = 65535, .f = 0.0f, .d = 0.0, .b = true }, false },
+    { { .s = "ba", .ll = -1, .us = 65535, .f = 0.0f, .d = 0.0, .b = true }, true },
+    { { .s = "c", .ll = INT64_MIN, .us = 65535, .f = 2.0f, .d = 2.5, .b = true }, true },
+    { { .s = "d", .ll = 0, .us = 65535, .f = 0.0f, .d = 0.0, .b = true }, false },
+    { { .s = "e", .ll = -1, .us = 65534, .f = 0.0f, .d = 0.0, .b = true }, false },
+    { { .s = "f", .ll = -1, .us = 65535, .f = 1.5f, .d = 0.0, .b = true }, false },
+    { { .s = "g", .ll = -1, .us = 65535, .f = NAN, .d = 0.0, .b = true }, true },
+    { { .s = "h", .ll = -1, .us = 65535, .f = 0.0f, .d = 2.6, .b = true }, false },
+    { { .s = "i", .ll = -1, .us = 65535, .f = 0.0f, .d = NAN, .b = true }, false },
+    { { .s = "j", .ll = -1, .us = 65535, .f = 0.0f, .d = -1e300, .b = false }, false },
+    { { .s = "k", .ll = -1, .us = 65535, .f = 0.0f, .d = -1e300, .b = true }, true }
+  };
+  for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+  {
+    ret = dds_write (wr, &xs[k].x);
+    CU_ASSERT_EQ_FATAL (ret, 0);
+  }
+
+  checkdata_simpletypes (rd, xs, sizeof (xs) / sizeof (xs[0]));
+  dds_delete (dp1);
+  dds_delete (dp);
+}
+
+static int32_t write_take_float32 (dds_entity_t wr, dds_entity_t rd, const float *fs, size_t nfs)
+{
+  for (size_t k = 0; k < nfs; k++)
+  {
+    const dds_return_t ret = dds_write (wr, &(Space_simpletypes){ .s = "x", .f = fs[k] });
+    CU_ASSERT_EQ_FATAL (ret, 0);
+  }
+  Space_simpletypes data[MAXSAMPLES];
+  void *raw[MAXSAMPLES];
+  dds_sample_info_t si[MAXSAMPLES];
+  for (int i = 0; i < MAXSAMPLES; i++)
+    raw[i] = &data[i];
+  memset (data, 0, sizeof (data));
+  const dds_return_t ret = dds_take (rd, raw, si, MAXSAMPLES, MAXSAMPLES);
+  CU_ASSERT_GEQ_FATAL (ret, 0);
+  for (int i = 0; i < ret; i++)
+    Space_simpletypes_free (&data[i], DDS_FREE_CONTENTS);
+  return ret;
+}
+
+CU_Test (ddsc_filter, members_float32)
+{
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp, 0);
+  const dds_entity_t tp = dds_create_topic (dp, &Space_simpletypes_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  const dds_entity_t rd = dds_create_reader (dp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t wr = dds_create_writer (dp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+
+  // a float member holding 0.1f must be equal to the literal 0.1, even though the
+  // double nearest to 0.1 is a different number
+  const float fs[] = { 0.1f, 0.2f, 0.0f };
+  const struct { enum dds_topic_filter_member_op op; int32_t naccept; } cases[] = {
+    { DDS_TOPIC_FILTER_MEMBER_EQ, 1 },
+    { DDS_TOPIC_FILTER_MEMBER_NE, 2 },
+    { DDS_TOPIC_FILTER_MEMBER_LE, 2 },
+    { DDS_TOPIC_FILTER_MEMBER_GE, 2 },
+    { DDS_TOPIC_FILTER_MEMBER_LT, 1 },
+    { DDS_TOPIC_FILTER_MEMBER_GT, 1 }
+  };
+  for (size_t k = 0; k < sizeof (cases) / sizeof (cases[0]); k++)
+  {
+    const dds_topic_filter_member_predicate_t p = { .offset = offsetof (Space_simpletypes, f), .op = cases[k].op, .value.d = 0.1 };
+    ret = dds_set_topic_filter_members (tp, 1, &p);
+    CU_ASSERT_EQ_FATAL (ret, 0);
+    CU_ASSERT_EQ (write_take_float32 (wr, rd, fs, sizeof (fs) / sizeof (fs[0])), cases[k].naccept);
+  }
+#ifdef DDS_HAS_TYPELIB
+  ret = dds_set_topic_filter_expression (tp, "f = 0.1", 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ (write_take_float32 (wr, rd, fs, sizeof (fs) / sizeof (fs[0])), 1);
+#endif
+  dds_delete (dp);
+}
+
+#ifdef DDS_HAS_TYPELIB
+
+CU_Test (ddsc_filter, expression_getset)
+{
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  const dds_entity_t dp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp, 0);
+  const dds_entity_t tp = dds_create_topic (dp, &Space_simpletypes_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+
+  static const char *invalid[] = {
+    "", "l", "l =", "l = 1 AND", "(l = 1", "l = 1)", "l = 1 @", "l == 1",
+    "l = ll", "1 = 2", "nonexistent = 1", "l.x = 1", "l LIKE 'x'", "l BETWEEN 1", "1 BETWEEN 1 AND 2",
+    "s = 1", "l = 'abc'", "l = 1.5", "ul = -1", "f = 'x'", "s = 'unterminated", "s = 'unterminated''",
+    "l = %1", "l = %0 AND s = %2"
+  };
+  const char *params[] = { "1", "x" };
+  for (size_t i = 0; i < sizeof (invalid) / sizeof (invalid[0]); i++)
+  {
+    ret = dds_set_topic_filter_expression (tp, invalid[i], 1, params);
+    CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+  }
+  ret = dds_set_topic_filter_expression (tp, "l = 1", 1, NULL);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+
+  // the number of comparisons is limited
+  char expr[20 * (DDS_TOPIC_FILTER_MEMBERS_MAX + 1)] = "l = 0";
+  for (int i = 1; i < DDS_TOPIC_FILTER_MEMBERS_MAX; i++)
+    (void) snprintf (expr + strlen (expr), sizeof (expr) - strlen (expr), " OR l = %d", i);
+  ret = dds_set_topic_filter_expression (tp, expr, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_set_topic_filter_expression (tp, NULL, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  (void) snprintf (expr + strlen (expr), sizeof (expr) - strlen (expr), " OR l = %d", DDS_TOPIC_FILTER_MEMBERS_MAX);
+  ret = dds_set_topic_filter_expression (tp, expr, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+
+  // so is the nesting of NOT and parentheses, the expressions may come from remote readers
+  // and must not be able to exhaust the stack
+  char *deep = ddsrt_malloc (100000 * 4 + 10);
+  for (size_t n = 0; n < 2; n++)
+  {
+    char *q = deep;
+    for (int i = 0; i < 100000; i++)
+      q += sprintf (q, "%s", (n == 0) ? "(" : "NOT ");
+    q += sprintf (q, "l = 1");
+    if (n == 0)
+      for (int i = 0; i < 100000; i++)
+        *q++ = ')';
+    *q = 0;
+    ret = dds_set_topic_filter_expression (tp, deep, 0, NULL);
+    CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+  }
+  ddsrt_free (deep);
+  ret = dds_set_topic_filter_expression (tp, "((((NOT (l = 1))))) AND NOT NOT NOT (l = 2)", 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_set_topic_filter_expression (tp, NULL, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  // failures leave the topic unfiltered
+  struct dds_topic_filter f;
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_NONE);
+
+  ret = dds_set_topic_filter_expression (tp, "l = %0 and s <> %1", 2, params);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_EXPRESSION);
+  dds_topic_filter_arg_fn fn;
+  void *arg;
+  ret = dds_get_topic_filter_and_arg (tp, &fn, &arg);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_PRECONDITION_NOT_MET);
+  f = (struct dds_topic_filter) { .mode = DDS_TOPIC_FILTER_EXPRESSION };
+  ret = dds_set_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, DDS_RETCODE_BAD_PARAMETER);
+
+  // a member filter replaces the expression and vice versa
+  const dds_topic_filter_member_predicate_t p = { .offset = offsetof (Space_simpletypes, l), .op = DDS_TOPIC_FILTER_MEMBER_EQ, .value.i = 1 };
+  ret = dds_set_topic_filter_members (tp, 1, &p);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_MEMBERS);
+  ret = dds_set_topic_filter_expression (tp, "NOT (l BETWEEN -1 AND 0x10)", 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_EXPRESSION);
+
+  ret = dds_set_topic_filter_expression (tp, NULL, 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  ret = dds_get_topic_filter_extended (tp, &f);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  CU_ASSERT_EQ_FATAL (f.mode, DDS_TOPIC_FILTER_NONE);
+
+  dds_delete (dp);
+}
+
+CU_Test (ddsc_filter, expression_types)
+{
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp, 0);
+  const dds_entity_t dp1 = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp1, 0);
+  const dds_entity_t tp = dds_create_topic (dp, &Space_simpletypes_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  const dds_entity_t tp1 = dds_create_topic (dp1, &Space_simpletypes_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp1, 0);
+  const dds_entity_t rd = dds_create_reader (dp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t wr = dds_create_writer (dp1, tp1, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+
+  const char *params[] = { "2.5", "'x'" };
+  ret = dds_set_topic_filter_expression (tp,
+    "'b' < s AND ll < 0 AND us >= 0xffff AND f <> 1.5 AND d <= %0 AND b = TRUE "
+    "AND NOT c = %1 AND (o BETWEEN 0 AND 9 OR l = 100)", 2, params);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  const struct simpletypes_case xs[] = {
+    { { .s = "a", .ll = -1, .us = 65535, .b = true }, false },
+    { { .s = "ba", .ll = -1, .us = 65535, .b = true }, true },
+    { { .s = "c", .ll = 0, .us = 65535, .b = true }, false },
+    { { .s = "d", .ll = -1, .us = 65534, .b = true }, false },
+    { { .s = "e", .ll = -1, .us = 65535, .f = 1.5f, .b = true }, false },
+    { { .s = "f", .ll = -1, .us = 65535, .d = 2.6, .b = true }, false },
+    { { .s = "g", .ll = -1, .us = 65535, .d = 2.5, .b = false }, false },
+    { { .s = "h", .ll = -1, .us = 65535, .b = true, .c = 'x' }, false },
+    { { .s = "i", .ll = -1, .us = 65535, .b = true, .c = 'y' }, true },
+    { { .s = "j", .ll = -1, .us = 65535, .b = true, .o = 10 }, false },
+    { { .s = "k", .ll = -1, .us = 65535, .b = true, .o = 10, .l = 100 }, true }
+  };
+  for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+  {
+    ret = dds_write (wr, &xs[k].x);
+    CU_ASSERT_EQ_FATAL (ret, 0);
+  }
+
+  checkdata_simpletypes (rd, xs, sizeof (xs) / sizeof (xs[0]));
+  dds_delete (dp1);
+  dds_delete (dp);
+}
+
+CU_Test (ddsc_filter, expression_quotes)
+{
+  dds_return_t ret;
+  char topicname[100];
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp, 0);
+  const dds_entity_t tp = dds_create_topic (dp, &Space_simpletypes_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  const dds_entity_t rd = dds_create_reader (dp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t wr = dds_create_writer (dp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+
+  // a quote in a string literal is written as two quotes, also in a parameter that is
+  // a quoted literal, but an unquoted parameter is taken as is
+  const char *params[] = { "'a''b'", "x'y" };
+  ret = dds_set_topic_filter_expression (tp, "s = 'it''s' OR s = '''' OR c = '''' OR s = %0 OR s = %1", 2, params);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  const struct simpletypes_case xs[] = {
+    { { .s = "it's" }, true },
+    { { .s = "it''s" }, false },
+    { { .s = "'" }, true },
+    { { .s = "''" }, false },
+    { { .s = "q", .c = '\'' }, true },
+    { { .s = "a'b" }, true },
+    { { .s = "a''b" }, false },
+    { { .s = "x'y" }, true },
+    { { .s = "it" }, false }
+  };
+  for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+  {
+    ret = dds_write (wr, &xs[k].x);
+    CU_ASSERT_EQ_FATAL (ret, 0);
+  }
+  checkdata_simpletypes (rd, xs, sizeof (xs) / sizeof (xs[0]));
+  dds_delete (dp);
+}
+
+CU_Test (ddsc_filter, expression_remote)
+{
+  const char *config = "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>";
+  char topicname[100];
+  dds_return_t ret;
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  char *conf_pub = ddsrt_expand_envvars (config, 0);
+  char *conf_sub = ddsrt_expand_envvars (config, 1);
+  const dds_entity_t dom_pub = dds_create_domain (0, conf_pub);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = dds_create_domain (1, conf_sub);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  ddsrt_free (conf_pub);
+  ddsrt_free (conf_sub);
+
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp_pub, 0);
+  const dds_entity_t dp_sub = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp_sub, 0);
+  const dds_entity_t tp_pub = dds_create_topic (dp_pub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (dp_sub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  // the reader advertises the filter, the writer's topic is unfiltered
+  ret = dds_set_topic_filter_expression (tp_sub, "long_2 >= %0 AND long_3 NOT BETWEEN 2 AND 4", 1, (const char *[]) { "1" });
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  const dds_entity_t rd = dds_create_reader (dp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t wr = dds_create_writer (dp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (dp_sub, rd, dp_pub, wr);
+
+  const Space_Type1 xs[] = { {1,0,0}, {2,1,1}, {3,1,2}, {4,2,4}, {5,2,5}, {6,-1,1} };
+  for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+  {
+    ret = dds_write (wr, &xs[k]);
+    CU_ASSERT_EQ_FATAL (ret, 0);
+  }
+  ret = dds_wait_for_acks (wr, DDS_SECS (10));
+  CU_ASSERT_EQ_FATAL (ret, 0);
+
+  // rejected samples aren't sent, so they don't get a sequence number
+  struct dds_entity *x;
+  ret = dds_entity_pin (wr, &x);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  struct ddsi_writer * const ddsi_wr = ((struct dds_writer *) x)->m_wr;
+  ddsrt_mutex_lock (&ddsi_wr->e.lock);
+  const ddsi_seqno_t seq = ddsi_wr->seq;
+  ddsrt_mutex_unlock (&ddsi_wr->e.lock);
+  dds_entity_unpin (x);
+  CU_ASSERT_EQ_FATAL (seq, 2);
+
+  // reliable and acknowledged, but delivery to the reader may lag a little
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  Space_Type1 data[MAXSAMPLES];
+  void *raw[MAXSAMPLES];
+  dds_sample_info_t si[MAXSAMPLES];
+  for (int i = 0; i < MAXSAMPLES; i++)
+    raw[i] = &data[i];
+  while (dds_read (rd, raw, si, MAXSAMPLES, MAXSAMPLES) < 2 && dds_time () < tend)
+    dds_sleepfor (DDS_MSECS (10));
+  const struct exp exp = {
+    .n = 2, .xs = (const Space_Type1[]) { {2,1,1}, {5,2,5} }
+  };
+  checkdata (rd, &exp, "rd:");
+  dds_delete (dom_sub);
+  dds_delete (dom_pub);
+}
+
+
+static void wait_for_data (dds_entity_t rd, int n)
+{
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  Space_Type1 data[MAXSAMPLES];
+  void *raw[MAXSAMPLES];
+  dds_sample_info_t si[MAXSAMPLES];
+  for (int i = 0; i < MAXSAMPLES; i++)
+    raw[i] = &data[i];
+  while (dds_read (rd, raw, si, MAXSAMPLES, MAXSAMPLES) < n && dds_time () < tend)
+    dds_sleepfor (DDS_MSECS (10));
+}
+
+CU_Test (ddsc_filter, expression_remote_per_reader)
+{
+  const char *config = "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>";
+  char topicname[100];
+  dds_return_t ret;
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  char *conf_pub = ddsrt_expand_envvars (config, 0);
+  char *conf_sub = ddsrt_expand_envvars (config, 1);
+  char *conf_sub2 = ddsrt_expand_envvars (config, 2);
+  const dds_entity_t dom_pub = dds_create_domain (0, conf_pub);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = dds_create_domain (1, conf_sub);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  const dds_entity_t dom_sub2 = dds_create_domain (2, conf_sub2);
+  CU_ASSERT_GT_FATAL (dom_sub2, 0);
+  ddsrt_free (conf_pub);
+  ddsrt_free (conf_sub);
+  ddsrt_free (conf_sub2);
+
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_durability (qos, DDS_DURABILITY_TRANSIENT_LOCAL);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp_pub, 0);
+  const dds_entity_t tp_pub = dds_create_topic (dp_pub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t wr = dds_create_writer (dp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+
+  // two readers with the same filter in one participant, one with another filter and an
+  // unfiltered one, then later two more readers: one with a filter the writer already
+  // evaluates and one with a new filter, the latter's filter has to be evaluated on the
+  // history; the first two in a separate domain instance so they get GAPs
+  const char *exprs[] = { "long_2 >= 2", "long_2 >= 2", "long_3 < 3", NULL, "long_3 < 3", "long_2 = 1" };
+  dds_entity_t dp_sub[sizeof (exprs) / sizeof (exprs[0])];
+  const struct exp exp[] = {
+    { .n = 3, .xs = (const Space_Type1[]) { {4,2,4}, {5,3,2}, {6,2,0} } },
+    { .n = 3, .xs = (const Space_Type1[]) { {4,2,4}, {5,3,2}, {6,2,0} } },
+    { .n = 4, .xs = (const Space_Type1[]) { {1,0,0}, {2,1,1}, {5,3,2}, {6,2,0} } },
+    { .n = 6, .xs = (const Space_Type1[]) { {1,0,0}, {2,1,1}, {3,1,3}, {4,2,4}, {5,3,2}, {6,2,0} } },
+    { .n = 4, .xs = (const Space_Type1[]) { {1,0,0}, {2,1,1}, {5,3,2}, {6,2,0} } },
+    { .n = 2, .xs = (const Space_Type1[]) { {2,1,1}, {3,1,3} } }
+  };
+  dds_entity_t rd[sizeof (exprs) / sizeof (exprs[0])];
+  for (size_t i = 0; i < sizeof (rd) / sizeof (rd[0]); i++)
+  {
+    dp_sub[i] = (i == 1) ? dp_sub[0] : dds_create_participant ((i == 0) ? 2 : 1, NULL, NULL);
+    CU_ASSERT_GT_FATAL (dp_sub[i], 0);
+    const dds_entity_t tp = dds_create_topic (dp_sub[i], &Space_Type1_desc, topicname, qos, NULL);
+    CU_ASSERT_GT_FATAL (tp, 0);
+    if (exprs[i])
+    {
+      ret = dds_set_topic_filter_expression (tp, exprs[i], 0, NULL);
+      CU_ASSERT_EQ_FATAL (ret, 0);
+    }
+    if (i == 4)
+    {
+      const Space_Type1 xs[] = { {1,0,0}, {2,1,1}, {3,1,3}, {4,2,4}, {5,3,2}, {6,2,0} };
+      for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+      {
+        ret = dds_write (wr, &xs[k]);
+        CU_ASSERT_EQ_FATAL (ret, 0);
+      }
+      ret = dds_wait_for_acks (wr, DDS_SECS (10));
+      CU_ASSERT_EQ_FATAL (ret, 0);
+    }
+    rd[i] = dds_create_reader (dp_sub[i], tp, qos, NULL);
+    CU_ASSERT_GT_FATAL (rd[i], 0);
+    sync_reader_writer (dp_sub[i], rd[i], dp_pub, wr);
+    // the writer must know the filter before it writes
+    dds_publication_matched_status_t pm;
+    const dds_time_t tend = dds_time () + DDS_SECS (10);
+    while ((ret = dds_get_publication_matched_status (wr, &pm)) == 0 && pm.current_count <= i && dds_time () < tend)
+      dds_sleepfor (DDS_MSECS (10));
+    CU_ASSERT_EQ_FATAL (pm.current_count, i + 1);
+  }
+  dds_delete_qos (qos);
+
+  // each distinct filter is evaluated once and the result is in the WHC; the unfiltered
+  // reader wants everything, so none of the samples is dropped
+  struct dds_entity *x;
+  ret = dds_entity_pin (wr, &x);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  struct ddsi_writer * const ddsi_wr = ((struct dds_writer *) x)->m_wr;
+  const uint32_t exp_nrejects[] = { 1, 1, 2, 1, 0, 0 };
+  ddsrt_mutex_lock (&ddsi_wr->e.lock);
+  CU_ASSERT_EQ (ddsi_wr->seq, 6);
+  for (ddsi_seqno_t seq = 1; seq <= 6; seq++)
+  {
+    struct ddsi_whc_borrowed_sample bs;
+    CU_ASSERT_FATAL (ddsi_whc_borrow_sample (ddsi_wr->whc, seq, &bs));
+    CU_ASSERT_FATAL (bs.filter_rejects_valid);
+    uint32_t nrejects = 0;
+    for (uint64_t m = bs.filter_rejects; m; m &= m - 1)
+      nrejects++;
+    CU_ASSERT_EQ (nrejects, exp_nrejects[seq - 1]);
+    ddsi_whc_return_sample (ddsi_wr->whc, &bs, false);
+  }
+  uint32_t nfilters = 0;
+  for (uint64_t m = ddsi_wr->content_filters_in_use; m; m &= m - 1)
+    nfilters++;
+  CU_ASSERT_EQ (nfilters, 3);
+  ddsrt_mutex_unlock (&ddsi_wr->e.lock);
+  dds_entity_unpin (x);
+
+  for (size_t i = 0; i < sizeof (rd) / sizeof (rd[0]); i++)
+  {
+    wait_for_data (rd[i], exp[i].n);
+    checkdata (rd[i], &exp[i], "rd%d:", (int) i);
+  }
+  dds_delete (dom_sub2);
+  dds_delete (dom_sub);
+  dds_delete (dom_pub);
+}
+
+static bool writer_has_content_filter (dds_entity_t wr, const char *expr)
+{
+  struct dds_entity *x;
+  dds_return_t ret = dds_entity_pin (wr, &x);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  struct ddsi_writer * const ddsi_wr = ((struct dds_writer *) x)->m_wr;
+  bool found = false;
+  ddsrt_mutex_lock (&ddsi_wr->e.lock);
+  if (expr == NULL)
+    found = (ddsi_wr->content_filters_in_use == 0 && ddsi_wr->num_readers_filtered == 0);
+  else
+  {
+    for (int32_t i = 0; i < DDSI_WRITER_MAX_CONTENT_FILTERS && !found; i++)
+      if (ddsi_wr->content_filters_in_use & (UINT64_C (1) << i))
+        found = (strcmp (ddsi_wr->content_filters[i].prop->filter_expression, expr) == 0);
+  }
+  ddsrt_mutex_unlock (&ddsi_wr->e.lock);
+  dds_entity_unpin (x);
+  return found;
+}
+
+CU_Test (ddsc_filter, expression_remote_change)
+{
+  const char *config = "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>";
+  char topicname[100];
+  dds_return_t ret;
+  create_unique_topic_name ("ddsc_filter", topicname, sizeof (topicname));
+  char *conf_pub = ddsrt_expand_envvars (config, 0);
+  char *conf_sub = ddsrt_expand_envvars (config, 1);
+  const dds_entity_t dom_pub = dds_create_domain (0, conf_pub);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = dds_create_domain (1, conf_sub);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  ddsrt_free (conf_pub);
+  ddsrt_free (conf_sub);
+
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t dp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp_pub, 0);
+  const dds_entity_t dp_sub = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (dp_sub, 0);
+  const dds_entity_t tp_pub = dds_create_topic (dp_pub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (dp_sub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  ret = dds_set_topic_filter_expression (tp_sub, "long_2 >= 1", 0, NULL);
+  CU_ASSERT_EQ_FATAL (ret, 0);
+  const dds_entity_t rd = dds_create_reader (dp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t wr = dds_create_writer (dp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (dp_sub, rd, dp_pub, wr);
+
+  // changing the expression after creating the reader must change what the remote
+  // writer sends: if it kept applying the old one, samples accepted by the new one
+  // would never arrive; dropping the filter must make it send everything
+  const char *exprs[] = { "long_2 >= 1", "long_2 = 0", NULL };
+  const Space_Type1 xs[] = { {1,0,0}, {2,1,0}, {3,2,0} };
+  const struct exp exp[] = {
+    { .n = 2, .xs = (const Space_Type1[]) { {2,1,0}, {3,2,0} } },
+    { .n = 1, .xs = (const Space_Type1[]) { {1,0,0} } },
+    { .n = 3, .xs = xs }
+  };
+  for (size_t i = 0; i < sizeof (exprs) / sizeof (exprs[0]); i++)
+  {
+    if (i > 0)
+    {
+      ret = dds_set_topic_filter_expression (tp_sub, exprs[i], 0, NULL);
+      CU_ASSERT_EQ_FATAL (ret, 0);
+    }
+    const dds_time_t tend = dds_time () + DDS_SECS (10);
+    while (!writer_has_content_filter (wr, exprs[i]) && dds_time () < tend)
+      dds_sleepfor (DDS_MSECS (10));
+    CU_ASSERT_FATAL (writer_has_content_filter (wr, exprs[i]));
+    for (size_t k = 0; k < sizeof (xs) / sizeof (xs[0]); k++)
+    {
+      ret = dds_write (wr, &xs[k]);
+      CU_ASSERT_EQ_FATAL (ret, 0);
+    }
+    ret = dds_wait_for_acks (wr, DDS_SECS (10));
+    CU_ASSERT_EQ_FATAL (ret, 0);
+    wait_for_data (rd, exp[i].n);
+    checkdata (rd, &exp[i], "rd(%s):", exprs[i] ? exprs[i] : "none");
+  }
+  dds_delete (dom_sub);
+  dds_delete (dom_pub);
+}
+
+#endif /* DDS_HAS_TYPELIB */
@@ -0,0 +1,125 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+
+#include "dds/dds.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
+#include "test_common.h"
+
+#define NINSTANCES 100
+
+static bool accept_all (const void *sample)
+{
+  (void) sample;
+  return true;
+}
+
+static dds_entity_t create_shards_domain (int nshards)
+{
+  const char *config_fmt =
+    "<General>"
+    "  <Interfaces><NetworkInterface address=\"127.0.0.1\"/></Interfaces>"
+    "  <AllowMulticast>false</AllowMulticast>"
+    "</General>"
+    "<Discovery>"
+    "  <ExternalDomainId>0</ExternalDomainId>"
+    "  <Tag>${CYCLONEDDS_PID}</Tag>"
+    "</Discovery>"
+    "<Internal><ReaderHistoryShards>%d</ReaderHistoryShards></Internal>";
+  char *config = NULL;
+  (void) ddsrt_asprintf (&config, config_fmt, nshards);
+  const dds_entity_t dom = dds_create_domain (0, config);
+  ddsrt_free (config);
+  return dom;
+}
+
+CU_Test (ddsc_reader_history_shards, bad_config)
+{
+  CU_ASSERT_LT (create_shards_domain (0), 0);
+  CU_ASSERT_LT (create_shards_domain (65), 0);
+}
+
+CU_TheoryDataPoints (ddsc_reader_history_shards, instances) = {
+  CU_DataPoints (int, 1, 4, 64)
+};
+
+CU_Theory ((int nshards), ddsc_reader_history_shards, instances, .timeout = 10)
+{
+  const dds_entity_t dom = create_shards_domain (nshards);
+  CU_ASSERT_GT_FATAL (dom, 0);
+  const dds_entity_t pp = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp, 0);
+  char topicname[100];
+  create_unique_topic_name ("ddsc_reader_history_shards", topicname, sizeof (topicname));
+  const dds_entity_t tp = dds_create_topic (pp, &Space_Type1_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  const dds_entity_t wr = dds_create_writer (pp, tp, NULL, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  const dds_entity_t rd = dds_create_reader (pp, tp, NULL, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  const dds_entity_t rdcond = dds_create_readcondition (rd, DDS_NOT_READ_SAMPLE_STATE);
+  CU_ASSERT_GT_FATAL (rdcond, 0);
+
+  dds_return_t rc;
+  for (int32_t i = 0; i < NINSTANCES; i++)
+  {
+    rc = dds_write (wr, &(Space_Type1){ i, i, 0 });
+    CU_ASSERT_EQ_FATAL (rc, 0);
+  }
+  // a query condition created afterward must see the existing data in all shards
+  const dds_entity_t qcond = dds_create_querycondition (rd, DDS_ANY_STATE, accept_all);
+  CU_ASSERT_GT_FATAL (qcond, 0);
+  CU_ASSERT_EQ (dds_triggered (rdcond), 1);
+  CU_ASSERT_EQ (dds_triggered (qcond), 1);
+
+  // Iterating over the instances must visit all of them in the order of the instance
+  // handles, regardless of the shard they are in
+  dds_instance_handle_t ih = DDS_HANDLE_NIL;
+  bool seen[NINSTANCES] = { false };
+  int32_t n = 0;
+  Space_Type1 sample;
+  void *raw = &sample;
+  dds_sample_info_t si;
+  while ((rc = dds_take_next_instance (rd, &raw, &si, 1, 1, ih)) == 1)
+  {
+    CU_ASSERT_FATAL (si.instance_handle > ih);
+    CU_ASSERT_FATAL (sample.long_1 >= 0 && sample.long_1 < NINSTANCES);
+    CU_ASSERT_FATAL (!seen[sample.long_1]);
+    seen[sample.long_1] = true;
+    ih = si.instance_handle;
+    n++;
+  }
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  CU_ASSERT_EQ (n, NINSTANCES);
+  CU_ASSERT_EQ (dds_triggered (rdcond), 0);
+  CU_ASSERT_EQ (dds_triggered (qcond), 0);
+
+  // Taking everything at once must gather the data from all shards
+  for (int32_t i = 0; i < NINSTANCES; i++)
+  {
+    rc = dds_write (wr, &(Space_Type1){ i, i + 1, 0 });
+    CU_ASSERT_EQ_FATAL (rc, 0);
+  }
+  Space_Type1 samples[NINSTANCES + 1];
+  void *raws[NINSTANCES + 1];
+  dds_sample_info_t sis[NINSTANCES + 1];
+  for (int32_t i = 0; i <= NINSTANCES; i++)
+    raws[i] = &samples[i];
+  rc = dds_take_mask (rd, raws, sis, NINSTANCES + 1, NINSTANCES + 1, DDS_NOT_READ_SAMPLE_STATE);
+  CU_ASSERT_EQ_FATAL (rc, NINSTANCES);
+  for (int32_t i = 0; i < NINSTANCES; i++)
+    CU_ASSERT_EQ (samples[i].long_2, samples[i].long_1 + 1);
+  CU_ASSERT_EQ (dds_triggered (rdcond), 0);
+
+  rc = dds_delete (dom);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+}
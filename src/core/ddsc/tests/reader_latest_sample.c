@@ -0,0 +1,207 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+
+#include "dds/dds.h"
+#include "dds/ddsrt/atomics.h"
+#include "dds/ddsrt/threads.h"
+#include "test_common.h"
+
+// Unkeyed topic + KEEP_LAST 1 gets the "latest sample" RHC, a (very long) deadline gets
+// the default one: doing the same operations on both readers must give the same results.
+// The writers need to offer that deadline for the second reader to match.
+static dds_entity_t pp, tp, wr[2], rd[2], cond[2];
+
+static void latest_sample_init (void)
+{
+  pp = dds_create_participant (DDS_DOMAIN_DEFAULT, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp, 0);
+  char topicname[100];
+  create_unique_topic_name ("ddsc_reader_latest_sample", topicname, sizeof (topicname));
+  tp = dds_create_topic (pp, &Space_Type3_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_writer_data_lifecycle (qos, false);
+  dds_qset_deadline (qos, DDS_SECS (3600));
+  for (int i = 0; i < 2; i++)
+  {
+    wr[i] = dds_create_writer (pp, tp, qos, NULL);
+    CU_ASSERT_GT_FATAL (wr[i], 0);
+  }
+  dds_reset_qos (qos);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_LAST, 1);
+  rd[0] = dds_create_reader (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd[0], 0);
+  dds_qset_deadline (qos, DDS_SECS (3600));
+  rd[1] = dds_create_reader (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd[1], 0);
+  dds_delete_qos (qos);
+  cond[0] = cond[1] = 0;
+}
+
+static void latest_sample_fini (void)
+{
+  dds_return_t rc = dds_delete (pp);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+}
+
+enum oper {
+  WR, WR2, DISP, WRDISP, UNREG, UNREG2, DEL2, // writer side
+  TAKE, READ, PEEK, TAKE_NOTREAD, TAKE_NEXT_INST, TAKE_COND, // reader side
+  ADD_COND, DEL_COND
+};
+
+static void check_readers (enum oper op)
+{
+  Space_Type3 samples[2][2];
+  void *raw[2][2] = { { &samples[0][0], &samples[0][1] }, { &samples[1][0], &samples[1][1] } };
+  dds_sample_info_t si[2][2];
+  dds_return_t n[2];
+  memset (samples, 0, sizeof (samples));
+  memset (si, 0, sizeof (si));
+  for (int i = 0; i < 2; i++)
+  {
+    switch (op)
+    {
+      case TAKE: n[i] = dds_take (rd[i], raw[i], si[i], 2, 2); break;
+      case READ: n[i] = dds_read (rd[i], raw[i], si[i], 2, 2); break;
+      case PEEK: n[i] = dds_peek (rd[i], raw[i], si[i], 2, 2); break;
+      case TAKE_NOTREAD: n[i] = dds_take_mask (rd[i], raw[i], si[i], 2, 2, DDS_NOT_READ_SAMPLE_STATE); break;
+      case TAKE_NEXT_INST: n[i] = dds_take_next_instance (rd[i], raw[i], si[i], 2, 2, DDS_HANDLE_NIL); break;
+      case TAKE_COND: n[i] = dds_take (cond[i], raw[i], si[i], 2, 2); break;
+      default: CU_ASSERT_FATAL (0);
+    }
+  }
+  CU_ASSERT_EQ_FATAL (n[0], n[1]);
+  for (int32_t j = 0; j < n[0]; j++)
+  {
+    CU_ASSERT_EQ (si[0][j].valid_data, si[1][j].valid_data);
+    CU_ASSERT_EQ (si[0][j].sample_state, si[1][j].sample_state);
+    CU_ASSERT_EQ (si[0][j].view_state, si[1][j].view_state);
+    CU_ASSERT_EQ (si[0][j].instance_state, si[1][j].instance_state);
+    CU_ASSERT_EQ (si[0][j].source_timestamp, si[1][j].source_timestamp);
+    CU_ASSERT_EQ (si[0][j].instance_handle, si[1][j].instance_handle);
+    CU_ASSERT_EQ (si[0][j].publication_handle, si[1][j].publication_handle);
+    CU_ASSERT_EQ (si[0][j].disposed_generation_count, si[1][j].disposed_generation_count);
+    CU_ASSERT_EQ (si[0][j].no_writers_generation_count, si[1][j].no_writers_generation_count);
+    CU_ASSERT_EQ (si[0][j].sample_rank, si[1][j].sample_rank);
+    CU_ASSERT_EQ (si[0][j].generation_rank, si[1][j].generation_rank);
+    CU_ASSERT_EQ (si[0][j].absolute_generation_rank, si[1][j].absolute_generation_rank);
+    if (si[0][j].valid_data)
+      CU_ASSERT_EQ (samples[0][j].long_1, samples[1][j].long_1);
+  }
+}
+
+static void apply (enum oper op, int32_t v)
+{
+  const Space_Type3 sample = { v, v, v };
+  const dds_time_t ts = DDS_SECS (v);
+  dds_return_t rc = 0;
+  switch (op)
+  {
+    case WR: rc = dds_write_ts (wr[0], &sample, ts); break;
+    case WR2: rc = dds_write_ts (wr[1], &sample, ts); break;
+    case DISP: rc = dds_dispose_ts (wr[0], &sample, ts); break;
+    case WRDISP: rc = dds_writedispose_ts (wr[0], &sample, ts); break;
+    case UNREG: rc = dds_unregister_instance_ts (wr[0], &sample, ts); break;
+    case UNREG2: rc = dds_unregister_instance_ts (wr[1], &sample, ts); break;
+    case DEL2: rc = dds_delete (wr[1]); break;
+    case ADD_COND:
+      for (int i = 0; i < 2; i++)
+      {
+        cond[i] = dds_create_readcondition (rd[i], DDS_NOT_READ_SAMPLE_STATE);
+        CU_ASSERT_GT_FATAL (cond[i], 0);
+      }
+      break;
+    case DEL_COND:
+      for (int i = 0; i < 2; i++)
+      {
+        rc = dds_delete (cond[i]);
+        CU_ASSERT_EQ_FATAL (rc, 0);
+        cond[i] = 0;
+      }
+      break;
+    default:
+      check_readers (op);
+      break;
+  }
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  if (cond[0])
+    CU_ASSERT_EQ (dds_triggered (cond[0]), dds_triggered (cond[1]));
+}
+
+CU_Test (ddsc_reader_latest_sample, same_as_default, .init = latest_sample_init, .fini = latest_sample_fini)
+{
+  static const struct { enum oper op; int32_t v; } script[] = {
+    { WR, 1 }, { TAKE, 0 }, { TAKE, 0 },
+    { WR, 2 }, { WR, 3 }, { TAKE, 0 },
+    { WR, 4 }, { READ, 0 }, { TAKE_NOTREAD, 0 }, { PEEK, 0 }, { TAKE, 0 },
+    { WR, 5 }, { ADD_COND, 0 }, { WR, 6 }, { TAKE_COND, 0 }, { WR, 7 }, { TAKE, 0 }, { DEL_COND, 0 },
+    { WR, 8 }, { DISP, 9 }, { TAKE, 0 }, { TAKE, 0 },
+    { WR, 10 }, { TAKE, 0 }, { WRDISP, 11 }, { TAKE, 0 }, { WR, 12 }, { TAKE, 0 },
+    { WR2, 13 }, { WR, 14 }, { TAKE, 0 }, { WR, 15 }, { TAKE, 0 },
+    { UNREG2, 16 }, { WR, 17 }, { TAKE, 0 }, { WR2, 18 }, { TAKE_NEXT_INST, 0 },
+    { WR, 19 }, { UNREG, 20 }, { TAKE, 0 }, { WR, 21 }, { TAKE, 0 },
+    { DEL2, 0 }, { WR, 22 }, { READ, 0 }, { UNREG, 23 }, { READ, 0 }, { TAKE, 0 }, { TAKE, 0 },
+    { WR, 24 }, { ADD_COND, 0 }, { TAKE, 0 }, { WR, 25 }, { DEL_COND, 0 }, { TAKE, 0 }
+  };
+  for (size_t i = 0; i < sizeof (script) / sizeof (script[0]); i++)
+    apply (script[i].op, script[i].v);
+}
+
+#define CONCURRENT_N 100000
+
+struct writer_arg {
+  dds_entity_t wr;
+  ddsrt_atomic_uint32_t done;
+};
+
+static uint32_t latest_sample_writer (void *varg)
+{
+  struct writer_arg * const arg = varg;
+  for (int32_t i = 1; i <= CONCURRENT_N; i++)
+  {
+    if (dds_write (arg->wr, &(Space_Type3){ i, 0, 0 }) != 0)
+      break;
+  }
+  ddsrt_atomic_st32 (&arg->done, 1);
+  return 0;
+}
+
+CU_Test (ddsc_reader_latest_sample, concurrent, .init = latest_sample_init, .fini = latest_sample_fini, .timeout = 30)
+{
+  struct writer_arg arg = { .wr = wr[0], .done = DDSRT_ATOMIC_UINT32_INIT (0) };
+  ddsrt_threadattr_t tattr;
+  ddsrt_thread_t tid;
+  ddsrt_threadattr_init (&tattr);
+  dds_return_t rc = ddsrt_thread_create (&tid, "writer", &tattr, latest_sample_writer, &arg);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+
+  // Every sample taken must be newer than the previous one, and the last one written
+  // must always be taken
+  int32_t last = 0;
+  bool done;
+  do {
+    done = ddsrt_atomic_ld32 (&arg.done);
+    Space_Type3 sample;
+    void *raw = &sample;
+    dds_sample_info_t si;
+    while ((rc = dds_take (rd[0], &raw, &si, 1, 1)) == 1)
+    {
+      CU_ASSERT_FATAL (si.valid_data);
+      CU_ASSERT_GT_FATAL (sample.long_1, last);
+      last = sample.long_1;
+    }
+    CU_ASSERT_EQ_FATAL (rc, 0);
+  } while (!done);
+  CU_ASSERT_EQ (last, CONCURRENT_N);
+  ddsrt_thread_join (tid, NULL);
+}
@@ -0,0 +1,130 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+
+#include "dds/dds.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
+#include "dds/ddsrt/string.h"
+#include "test_common.h"
+
+static dds_entity_t create_spin_domain (dds_domainid_t domid, bool multiple_recv_threads)
+{
+  // Spinning in all receive threads, the ones that block in a socket read and the
+  // ones that wait for multiple sockets
+  const char *thread_fmt =
+    "<Thread name=\"%s\">"
+    "  <SpinDuration>5ms</SpinDuration>"
+    "  <SocketBusyPoll>50us</SocketBusyPoll>"
+    "</Thread>";
+  const char *names[] = { "recv", "recvMC", "recvUC", "recvUC1" };
+  char *threads = ddsrt_strdup ("");
+  for (size_t i = 0; i < sizeof (names) / sizeof (names[0]); i++)
+  {
+    char *thread = NULL, *tmp = NULL;
+    (void) ddsrt_asprintf (&thread, thread_fmt, names[i]);
+    (void) ddsrt_asprintf (&tmp, "%s%s", threads, thread);
+    ddsrt_free (thread);
+    ddsrt_free (threads);
+    threads = tmp;
+  }
+  const char *config_fmt =
+    "<General>"
+    "  <Interfaces><NetworkInterface address=\"127.0.0.1\"/></Interfaces>"
+    "  <AllowMulticast>false</AllowMulticast>"
+    "</General>"
+    "<Discovery>"
+    "  <ExternalDomainId>0</ExternalDomainId>"
+    "  <Tag>${CYCLONEDDS_PID}</Tag>"
+    "  <ParticipantIndex>auto</ParticipantIndex>"
+    "  <Peers><Peer address=\"127.0.0.1\"/></Peers>"
+    "</Discovery>"
+    "<Internal><MultipleReceiveThreads>%s</MultipleReceiveThreads></Internal>"
+    "<Threads>%s</Threads>";
+  char *config = NULL;
+  (void) ddsrt_asprintf (&config, config_fmt, multiple_recv_threads ? "true" : "false", threads);
+  const dds_entity_t dom = dds_create_domain (domid, config);
+  ddsrt_free (config);
+  ddsrt_free (threads);
+  return dom;
+}
+
+CU_TheoryDataPoints (ddsc_recv_spin, loopback) = {
+  CU_DataPoints (bool, false, true)
+};
+
+CU_Theory ((bool multiple_recv_threads), ddsc_recv_spin, loopback, .timeout = 30)
+{
+  const dds_entity_t dom_pub = create_spin_domain (0, multiple_recv_threads);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = create_spin_domain (1, multiple_recv_threads);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+
+  const dds_entity_t pp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  const dds_entity_t pp_sub = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_sub, 0);
+  char topicname[100];
+  create_unique_topic_name ("ddsc_recv_spin_loopback", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t tp_pub = dds_create_topic (pp_pub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (pp_sub, &Space_Type1_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  const dds_entity_t wr = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  const dds_entity_t rd = dds_create_reader (pp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (pp_sub, rd, pp_pub, wr);
+
+  // Alternate bursts and pauses longer than the spin duration, so that the receive
+  // threads go back and forth between spinning and blocking
+  const dds_entity_t ws = dds_create_waitset (pp_sub);
+  CU_ASSERT_GT_FATAL (ws, 0);
+  dds_return_t rc = dds_set_status_mask (rd, DDS_DATA_AVAILABLE_STATUS);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = dds_waitset_attach (ws, rd, 0);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  int32_t nreceived = 0;
+  for (int32_t burst = 0; burst < 5; burst++)
+  {
+    for (int32_t i = 0; i < 20; i++)
+    {
+      rc = dds_write (wr, &(Space_Type1){ 0, 20 * burst + i, 0 });
+      CU_ASSERT_EQ_FATAL (rc, 0);
+    }
+    const dds_time_t tend = dds_time () + DDS_SECS (10);
+    while (nreceived < 20 * (burst + 1) && dds_time () < tend)
+    {
+      (void) dds_waitset_wait (ws, NULL, 0, DDS_MSECS (100));
+      Space_Type1 sample;
+      void *raw = &sample;
+      dds_sample_info_t si;
+      while ((rc = dds_take (rd, &raw, &si, 1, 1)) == 1)
+      {
+        CU_ASSERT_FATAL (si.valid_data);
+        CU_ASSERT_EQ_FATAL (sample.long_2, nreceived);
+        nreceived++;
+      }
+      CU_ASSERT_GEQ_FATAL (rc, 0);
+    }
+    CU_ASSERT_EQ_FATAL (nreceived, 20 * (burst + 1));
+    dds_sleepfor (DDS_MSECS (20));
+  }
+
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+}
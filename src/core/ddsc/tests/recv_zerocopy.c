@@ -0,0 +1,208 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+
+#include "dds/dds.h"
+#include "dds/ddsrt/atomics.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
+#include "dds/ddsi/ddsi_serdata.h"
+#include "test_common.h"
+
+#define NSAMPLES 100u
+
+static ddsrt_atomic_uint32_t rmsg_pins;
+
+static void count_rmsg_pins (void *arg, const dds_log_data_t *data)
+{
+  (void) arg;
+  // ddsi_rmsg_pin traces "rmsg_pin" for samples that are used in place
+  if (strstr (data->message, "rmsg_pin(") != NULL)
+    ddsrt_atomic_inc32 (&rmsg_pins);
+}
+
+static dds_entity_t create_zerocopy_domain (dds_domainid_t domid, const char *limit, const char *maxmsgsize, const char *fragsize, const char *contig)
+{
+  // Either large fragments, so that the large samples are received in one piece,
+  // or reassembling them in a buffer of their own
+  const char *config_fmt =
+    "<General>"
+    "  <Interfaces><NetworkInterface address=\"127.0.0.1\"/></Interfaces>"
+    "  <AllowMulticast>false</AllowMulticast>"
+    "  <MaxMessageSize>%s</MaxMessageSize>"
+    "  <FragmentSize>%s</FragmentSize>"
+    "  <ZeroCopyReceiveThreshold>1kB</ZeroCopyReceiveThreshold>"
+    "</General>"
+    "<Discovery>"
+    "  <ExternalDomainId>0</ExternalDomainId>"
+    "  <Tag>${CYCLONEDDS_PID}</Tag>"
+    "  <ParticipantIndex>auto</ParticipantIndex>"
+    "  <Peers><Peer address=\"127.0.0.1\"/></Peers>"
+    "</Discovery>"
+    "<Internal><DefragContiguousThreshold>%s</DefragContiguousThreshold></Internal>"
+    "<Sizing><ZeroCopyReceiveLimit>%s</ZeroCopyReceiveLimit></Sizing>"
+    "<Tracing><Category>radmin</Category></Tracing>";
+  char *config = NULL;
+  (void) ddsrt_asprintf (&config, config_fmt, maxmsgsize, fragsize, contig, limit);
+  const dds_entity_t dom = dds_create_domain (domid, config);
+  ddsrt_free (config);
+  return dom;
+}
+
+static uint32_t payload_size (uint32_t seq)
+{
+  // mix of small samples that are copied and large ones that are not
+  return (seq % 4 == 3) ? 20000 : 16 + seq;
+}
+
+static void fill_payload (RoundTripModule_DataType *sample, uint32_t seq)
+{
+  const uint32_t size = payload_size (seq);
+  sample->payload._length = sample->payload._maximum = size;
+  sample->payload._buffer = ddsrt_malloc (size);
+  sample->payload._release = true;
+  for (uint32_t i = 0; i < size; i++)
+    sample->payload._buffer[i] = (uint8_t) (seq + i);
+}
+
+static bool check_payload (const RoundTripModule_DataType *sample, uint32_t seq)
+{
+  if (sample->payload._length != payload_size (seq))
+    return false;
+  for (uint32_t i = 0; i < sample->payload._length; i++)
+    if (sample->payload._buffer[i] != (uint8_t) (seq + i))
+      return false;
+  return true;
+}
+
+static bool check_serdata (const struct ddsi_sertype *st, const struct ddsi_serdata *sd, uint32_t seq)
+{
+  RoundTripModule_DataType sample;
+  bool ok;
+  memset (&sample, 0, sizeof (sample));
+  ok = ddsi_serdata_to_sample (sd, &sample, NULL, NULL) && check_payload (&sample, seq);
+  RoundTripModule_DataType_free (&sample, DDS_FREE_CONTENTS);
+  if (!ok)
+    return false;
+
+  // the serialized representation must also be intact
+  const uint32_t size = ddsi_serdata_size (sd);
+  void *buf = ddsrt_malloc (size);
+  ddsi_serdata_to_ser (sd, 0, size, buf);
+  ddsrt_iovec_t iov = { .iov_base = buf, .iov_len = (ddsrt_iov_len_t) size };
+  struct ddsi_serdata *sd1 = ddsi_serdata_from_ser_iov (st, SDK_DATA, 1, &iov, size);
+  ddsrt_free (buf);
+  if (sd1 == NULL)
+    return false;
+  memset (&sample, 0, sizeof (sample));
+  ok = ddsi_serdata_to_sample (sd1, &sample, NULL, NULL) && check_payload (&sample, seq);
+  RoundTripModule_DataType_free (&sample, DDS_FREE_CONTENTS);
+  ddsi_serdata_unref (sd1);
+  return ok;
+}
+
+CU_TheoryDataPoints (ddsc_recv_zerocopy, loopback) = {
+  CU_DataPoints (const char *, "16MiB", "1MiB", "16MiB"),
+  CU_DataPoints (const char *, "65500B", "65500B", "1400B"),
+  CU_DataPoints (const char *, "60000B", "60000B", "1300B"),
+  CU_DataPoints (const char *, "0B", "0B", "1kB")
+};
+
+CU_Theory ((const char *limit, const char *maxmsgsize, const char *fragsize, const char *contig), ddsc_recv_zerocopy, loopback, .timeout = 30)
+{
+  ddsrt_atomic_st32 (&rmsg_pins, 0);
+  dds_set_trace_sink (count_rmsg_pins, NULL);
+  const dds_entity_t dom_pub = create_zerocopy_domain (0, limit, maxmsgsize, fragsize, contig);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = create_zerocopy_domain (1, limit, maxmsgsize, fragsize, contig);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+
+  const dds_entity_t pp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  const dds_entity_t pp_sub = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_sub, 0);
+  char topicname[100];
+  create_unique_topic_name ("ddsc_recv_zerocopy_loopback", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t tp_pub = dds_create_topic (pp_pub, &RoundTripModule_DataType_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (pp_sub, &RoundTripModule_DataType_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  const dds_entity_t wr = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  const dds_entity_t rd = dds_create_reader (pp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (pp_sub, rd, pp_pub, wr);
+
+  dds_return_t rc;
+  for (uint32_t seq = 0; seq < NSAMPLES; seq++)
+  {
+    RoundTripModule_DataType sample;
+    fill_payload (&sample, seq);
+    rc = dds_write (wr, &sample);
+    CU_ASSERT_EQ_FATAL (rc, 0);
+    RoundTripModule_DataType_free (&sample, DDS_FREE_CONTENTS);
+  }
+
+  // The reader holds on to all samples until everything has arrived, with a small
+  // limit that means most large samples get copied after all
+  dds_sample_info_t si;
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  while (dds_time () < tend)
+  {
+    void *raw[NSAMPLES] = { NULL };
+    dds_sample_info_t sis[NSAMPLES];
+    rc = dds_read (rd, raw, sis, NSAMPLES, NSAMPLES);
+    CU_ASSERT_GEQ_FATAL (rc, 0);
+    (void) dds_return_loan (rd, raw, rc);
+    if (rc == (dds_return_t) NSAMPLES)
+      break;
+    dds_sleepfor (DDS_MSECS (10));
+  }
+
+  // First half as serdata, so they get used also after they have been removed from the reader
+  const struct ddsi_sertype *st;
+  rc = dds_get_entity_sertype (rd, &st);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  struct ddsi_serdata *sds[NSAMPLES / 2];
+  for (uint32_t seq = 0; seq < NSAMPLES / 2; seq++)
+  {
+    rc = dds_takecdr (rd, &sds[seq], 1, &si, DDS_ANY_STATE);
+    CU_ASSERT_EQ_FATAL (rc, 1);
+    CU_ASSERT_FATAL (si.valid_data);
+  }
+  for (uint32_t seq = NSAMPLES / 2; seq < NSAMPLES; seq++)
+  {
+    RoundTripModule_DataType sample;
+    memset (&sample, 0, sizeof (sample));
+    void *raw = &sample;
+    rc = dds_take (rd, &raw, &si, 1, 1);
+    CU_ASSERT_EQ_FATAL (rc, 1);
+    CU_ASSERT_FATAL (si.valid_data);
+    CU_ASSERT_FATAL (check_payload (&sample, seq));
+    RoundTripModule_DataType_free (&sample, DDS_FREE_CONTENTS);
+  }
+  for (uint32_t seq = 0; seq < NSAMPLES / 2; seq++)
+  {
+    CU_ASSERT_FATAL (check_serdata (st, sds[seq], seq));
+    ddsi_serdata_unref (sds[seq]);
+  }
+
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  dds_set_trace_sink (NULL, NULL);
+  CU_ASSERT_GT (ddsrt_atomic_ld32 (&rmsg_pins), 0);
+}
@@ -74,11 +74,15 @@ CU_Test(ddsc_statistics, create_refresh_lookup_delete)
   CU_ASSERT_NEQ_FATAL (wstat, NULL);
   CU_ASSERT_EQ (wstat->entity, writer);
   CU_ASSERT_EQ (wstat->time, 0);
-  CU_ASSERT_EQ (wstat->count, 4);
+  CU_ASSERT_EQ (wstat->count, 8);
   assert_stat_kind (wstat, "rexmit_bytes", DDS_STAT_KIND_UINT64);
   assert_stat_kind (wstat, "throttle_count", DDS_STAT_KIND_UINT32);
   assert_stat_kind (wstat, "time_throttle", DDS_STAT_KIND_UINT64);
   assert_stat_kind (wstat, "time_rexmit", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (wstat, "whc_unacked_bytes", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (wstat, "domain_whc_unacked_bytes", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (wstat, "replay_bytes", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (wstat, "readers_replaying", DDS_STAT_KIND_UINT32);
   CU_ASSERT_EQ (dds_lookup_statistic (wstat, "missing"), NULL);
   CU_ASSERT_EQ (dds_refresh_statistics (wstat), DDS_RETCODE_OK);
   CU_ASSERT_NEQ (wstat->time, 0);
@@ -91,8 +95,12 @@ CU_Test(ddsc_statistics, create_refresh_lookup_delete)
   rstat = dds_create_statistics (reader);
   CU_ASSERT_NEQ_FATAL (rstat, NULL);
   CU_ASSERT_EQ (rstat->entity, reader);
-  CU_ASSERT_EQ (rstat->count, 1);
+  CU_ASSERT_EQ (rstat->count, 5);
   assert_stat_kind (rstat, "discarded_bytes", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (rstat, "rx_latency_samples", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (rstat, "rx_latency_kernel_to_recv", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (rstat, "rx_latency_recv_to_deliver", DDS_STAT_KIND_UINT64);
+  assert_stat_kind (rstat, "rx_latency_deliver_to_store", DDS_STAT_KIND_UINT64);
   CU_ASSERT_EQ (dds_refresh_statistics (rstat), DDS_RETCODE_OK);
   CU_ASSERT_NEQ (rstat->time, 0);
 
@@ -105,3 +113,71 @@ CU_Test(ddsc_statistics, create_refresh_lookup_delete)
   CU_ASSERT_EQ (dds_delete (rd_domain), DDS_RETCODE_OK);
   CU_ASSERT_EQ (dds_delete (wr_domain), DDS_RETCODE_OK);
 }
+
+CU_Test(ddsc_statistics, rx_latency)
+{
+  const char *config =
+    "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}"
+    "<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>"
+    "<Internal><SocketTimestamps>software</SocketTimestamps></Internal>";
+  char *rd_conf = ddsrt_expand_envvars (config, 0);
+  char *wr_conf = ddsrt_expand_envvars (config, 1);
+  char name[100];
+  dds_return_t rc;
+
+  const dds_entity_t rd_domain = dds_create_domain (0, rd_conf);
+  CU_ASSERT_GT_FATAL (rd_domain, 0);
+  const dds_entity_t wr_domain = dds_create_domain (1, wr_conf);
+  CU_ASSERT_GT_FATAL (wr_domain, 0);
+  ddsrt_free (rd_conf);
+  ddsrt_free (wr_conf);
+
+  const dds_entity_t rd_participant = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (rd_participant, 0);
+  const dds_entity_t wr_participant = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (wr_participant, 0);
+  create_unique_topic_name ("ddsc_statistics", name, sizeof (name));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t rd_topic = dds_create_topic (rd_participant, &RoundTripModule_DataType_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd_topic, 0);
+  const dds_entity_t wr_topic = dds_create_topic (wr_participant, &RoundTripModule_DataType_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr_topic, 0);
+  const dds_entity_t writer = dds_create_writer (wr_participant, wr_topic, qos, NULL);
+  CU_ASSERT_GT_FATAL (writer, 0);
+  const dds_entity_t reader = dds_create_reader (rd_participant, rd_topic, qos, NULL);
+  CU_ASSERT_GT_FATAL (reader, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (rd_participant, reader, wr_participant, writer);
+
+  const uint32_t nsamples = 10;
+  for (uint32_t i = 0; i < nsamples; i++)
+  {
+    RoundTripModule_DataType sample = { 0 };
+    rc = dds_write (writer, &sample);
+    CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  }
+
+  // the statistics are updated once the samples have been stored in the reader history cache,
+  // acknowledging them may happen before that
+  struct dds_statistics *rstat = dds_create_statistics (reader);
+  CU_ASSERT_NEQ_FATAL (rstat, NULL);
+  const struct dds_stat_keyvalue *samples = dds_lookup_statistic (rstat, "rx_latency_samples");
+  CU_ASSERT_NEQ_FATAL (samples, NULL);
+#ifdef __linux__
+  const uint64_t expected = nsamples;
+#else
+  const uint64_t expected = 0;
+#endif
+  const dds_time_t tend = dds_time () + DDS_SECS (5);
+  do {
+    dds_sleepfor (DDS_MSECS (10));
+    CU_ASSERT_EQ_FATAL (dds_refresh_statistics (rstat), DDS_RETCODE_OK);
+  } while (samples->u.u64 < expected && dds_time () < tend);
+  CU_ASSERT_EQ (samples->u.u64, expected);
+  dds_delete_statistics (rstat);
+
+  CU_ASSERT_EQ (dds_delete (rd_domain), DDS_RETCODE_OK);
+  CU_ASSERT_EQ (dds_delete (wr_domain), DDS_RETCODE_OK);
+}
@@ -10,8 +10,12 @@
 
 #include <stdio.h>
 #include "dds/dds.h"
+#include "dds/ddsc/dds_statistics.h"
+#include "dds/ddsrt/environ.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
 #include "Space.h"
-#include "CUnit/Test.h"
+#include "test_common.h"
 
 #define MAX_SAMPLES  (7)
 CU_Test(ddsc_transient_local, late_joiner)
@@ -95,3 +99,100 @@ CU_Test(ddsc_transient_local, late_joiner)
     dds_delete(par);
     dds_delete_qos(qos);
 }
+
+#define DDS_DOMAINID_PUB 0
+#define DDS_DOMAINID_SUB 1
+#define LATE_JOINER_NINST 20000
+
+static dds_duration_t remote_late_joiner (const char *extra_config, uint64_t *replay_bytes)
+{
+  char *config = NULL;
+  (void) ddsrt_asprintf (&config, "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>%s", extra_config);
+  char *conf_pub = ddsrt_expand_envvars (config, DDS_DOMAINID_PUB);
+  char *conf_sub = ddsrt_expand_envvars (config, DDS_DOMAINID_SUB);
+  const dds_entity_t dom_pub = dds_create_domain (DDS_DOMAINID_PUB, conf_pub);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = dds_create_domain (DDS_DOMAINID_SUB, conf_sub);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  ddsrt_free (conf_pub);
+  ddsrt_free (conf_sub);
+  ddsrt_free (config);
+
+  const dds_entity_t pp_pub = dds_create_participant (DDS_DOMAINID_PUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  const dds_entity_t pp_sub = dds_create_participant (DDS_DOMAINID_SUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_sub, 0);
+  char name[100];
+  create_unique_topic_name ("ddsc_transient_local_remote", name, sizeof name);
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_durability (qos, DDS_DURABILITY_TRANSIENT_LOCAL);
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  const dds_entity_t tp_pub = dds_create_topic (pp_pub, &Space_Type1_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (pp_sub, &Space_Type1_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  const dds_entity_t wr = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  for (int32_t i = 0; i < LATE_JOINER_NINST; i++)
+  {
+    dds_return_t rc = dds_write (wr, &(Space_Type1){ i, 0, i });
+    CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  }
+
+  /* the time to first complete view of the history includes discovery */
+  const dds_time_t tstart = dds_time ();
+  const dds_entity_t rd = dds_create_reader (pp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  int32_t n = 0;
+  while (n < LATE_JOINER_NINST && dds_time () < tstart + DDS_SECS (20))
+  {
+    Space_Type1 data[100];
+    void *ptrs[100];
+    dds_sample_info_t si[100];
+    for (int i = 0; i < 100; i++)
+      ptrs[i] = &data[i];
+    dds_return_t rc = dds_take (rd, ptrs, si, 100, 100);
+    CU_ASSERT_GEQ_FATAL (rc, 0);
+    for (int32_t i = 0; i < rc; i++)
+    {
+      CU_ASSERT_FATAL (si[i].valid_data);
+      CU_ASSERT_EQ_FATAL (data[i].long_1, data[i].long_3);
+    }
+    n += rc;
+    if (rc == 0)
+      dds_sleepfor (DDS_MSECS (1));
+  }
+  const dds_duration_t tcomplete = dds_time () - tstart;
+  CU_ASSERT_EQ_FATAL (n, LATE_JOINER_NINST);
+
+  /* the replay is done once the reader has everything */
+  struct dds_statistics *stat = dds_create_statistics (wr);
+  CU_ASSERT_NEQ_FATAL (stat, NULL);
+  dds_return_t rc = dds_refresh_statistics (stat);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  const struct dds_stat_keyvalue *bytes = dds_lookup_statistic (stat, "replay_bytes");
+  const struct dds_stat_keyvalue *active = dds_lookup_statistic (stat, "readers_replaying");
+  CU_ASSERT_NEQ_FATAL (bytes, NULL);
+  CU_ASSERT_NEQ_FATAL (active, NULL);
+  CU_ASSERT_EQ (active->u.u32, 0);
+  *replay_bytes = bytes->u.u64;
+  dds_delete_statistics (stat);
+
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  return tcomplete;
+}
+
+CU_Test(ddsc_transient_local, remote_late_joiner_replay, .timeout = 60)
+{
+  uint64_t replay_bytes;
+  const dds_duration_t t_rexmit = remote_late_joiner ("", &replay_bytes);
+  CU_ASSERT_EQ (replay_bytes, 0);
+  const dds_duration_t t_replay = remote_late_joiner ("<Internal><BurstSize><HistoryReplay>256 kB</HistoryReplay></BurstSize></Internal>", &replay_bytes);
+  CU_ASSERT_GEQ (replay_bytes, LATE_JOINER_NINST * sizeof (Space_Type1));
+  tprintf ("%d instances: via retransmits %.3fs, via replay %.3fs (%"PRIu64" bytes)\n",
+           LATE_JOINER_NINST, (double) t_rexmit / 1e9, (double) t_replay / 1e9, replay_bytes);
+}
@@ -0,0 +1,161 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+
+#include "dds/dds.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/io.h"
+#include "ddsi__uring.h"
+#include "test_common.h"
+
+#if DDSI_HAVE_URING
+#include <unistd.h>
+#endif
+
+static bool uring_available (void)
+{
+#if DDSI_HAVE_URING
+  // it may still be disabled (kernel.io_uring_disabled, seccomp filters in containers)
+  struct io_uring_params p;
+  memset (&p, 0, sizeof (p));
+  const long fd = syscall (__NR_io_uring_setup, 1, &p);
+  if (fd < 0)
+    return false;
+  close ((int) fd);
+  return true;
+#else
+  return false;
+#endif
+}
+
+static dds_entity_t create_uring_domain (dds_domainid_t domid, bool multiple_recv_threads)
+{
+  const char *config_fmt =
+    "<General>"
+    "  <Interfaces><NetworkInterface address=\"127.0.0.1\"/></Interfaces>"
+    "  <Transport>udp-uring</Transport>"
+    "  <AllowMulticast>false</AllowMulticast>"
+    "  <MaxMessageSize>1400B</MaxMessageSize>"
+    "</General>"
+    "<Discovery>"
+    "  <ExternalDomainId>0</ExternalDomainId>"
+    "  <Tag>${CYCLONEDDS_PID}</Tag>"
+    "  <ParticipantIndex>auto</ParticipantIndex>"
+    "  <Peers><Peer address=\"127.0.0.1\"/></Peers>"
+    "</Discovery>"
+    "<Internal><MultipleReceiveThreads>%s</MultipleReceiveThreads></Internal>";
+  char *config = NULL;
+  (void) ddsrt_asprintf (&config, config_fmt, multiple_recv_threads ? "true" : "false");
+  const dds_entity_t dom = dds_create_domain (domid, config);
+  ddsrt_free (config);
+  return dom;
+}
+
+static void fill_payload (RoundTripModule_DataType *sample, uint32_t seq)
+{
+  // mix of small samples and large ones that need to be fragmented
+  const uint32_t size = (seq % 10 == 9) ? 100000 : 16 + seq;
+  sample->payload._length = sample->payload._maximum = size;
+  sample->payload._buffer = ddsrt_malloc (size);
+  sample->payload._release = true;
+  for (uint32_t i = 0; i < size; i++)
+    sample->payload._buffer[i] = (uint8_t) (seq + i);
+}
+
+static bool check_payload (const RoundTripModule_DataType *sample, uint32_t seq)
+{
+  const uint32_t size = (seq % 10 == 9) ? 100000 : 16 + seq;
+  if (sample->payload._length != size)
+    return false;
+  for (uint32_t i = 0; i < size; i++)
+    if (sample->payload._buffer[i] != (uint8_t) (seq + i))
+      return false;
+  return true;
+}
+
+CU_TheoryDataPoints (ddsc_uring, loopback) = {
+  CU_DataPoints (bool, false, true)
+};
+
+CU_Theory ((bool multiple_recv_threads), ddsc_uring, loopback, .timeout = 30)
+{
+  const dds_entity_t dom_pub = create_uring_domain (0, multiple_recv_threads);
+  if (!uring_available ())
+  {
+    CU_ASSERT_LT_FATAL (dom_pub, 0);
+    return;
+  }
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = create_uring_domain (1, multiple_recv_threads);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+
+  const dds_entity_t pp_pub = dds_create_participant (0, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  const dds_entity_t pp_sub = dds_create_participant (1, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_sub, 0);
+  char topicname[100];
+  create_unique_topic_name ("ddsc_uring_loopback", topicname, sizeof (topicname));
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t tp_pub = dds_create_topic (pp_pub, &RoundTripModule_DataType_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (pp_sub, &RoundTripModule_DataType_desc, topicname, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  const dds_entity_t wr = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  const dds_entity_t rd = dds_create_reader (pp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (pp_sub, rd, pp_pub, wr);
+
+  const uint32_t nsamples = 200;
+  dds_return_t rc;
+  for (uint32_t seq = 0; seq < nsamples; seq++)
+  {
+    RoundTripModule_DataType sample;
+    fill_payload (&sample, seq);
+    rc = dds_write (wr, &sample);
+    CU_ASSERT_EQ_FATAL (rc, 0);
+    RoundTripModule_DataType_free (&sample, DDS_FREE_CONTENTS);
+  }
+
+  const dds_entity_t ws = dds_create_waitset (pp_sub);
+  CU_ASSERT_GT_FATAL (ws, 0);
+  rc = dds_set_status_mask (rd, DDS_DATA_AVAILABLE_STATUS);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = dds_waitset_attach (ws, rd, 0);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  uint32_t nreceived = 0;
+  RoundTripModule_DataType sample;
+  memset (&sample, 0, sizeof (sample));
+  void *raw = &sample;
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  while (nreceived < nsamples && dds_time () < tend)
+  {
+    (void) dds_waitset_wait (ws, NULL, 0, DDS_MSECS (100));
+    dds_sample_info_t si;
+    while ((rc = dds_take (rd, &raw, &si, 1, 1)) == 1)
+    {
+      CU_ASSERT_FATAL (si.valid_data);
+      CU_ASSERT_FATAL (check_payload (&sample, nreceived));
+      nreceived++;
+    }
+    CU_ASSERT_GEQ_FATAL (rc, 0);
+  }
+  RoundTripModule_DataType_free (&sample, DDS_FREE_CONTENTS);
+  CU_ASSERT_EQ (nreceived, nsamples);
+
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+}
@@ -10,15 +10,28 @@
 
 #include <assert.h>
 #include <limits.h>
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
 
 #include "dds/dds.h"
+#include "dds/ddsc/dds_statistics.h"
 #include "dds/ddsrt/process.h"
 #include "dds/ddsrt/threads.h"
 #include "dds/ddsrt/environ.h"
+#include "dds/ddsrt/io.h"
+#include "dds/ddsrt/random.h"
 #include "dds/ddsi/ddsi_entity_index.h"
 #include "dds/ddsi/ddsi_entity.h"
+#include "dds/ddsi/ddsi_serdata.h"
+#include "dds/ddsi/ddsi_tkmap.h"
 #include "ddsi__whc.h"
 #include "dds__entity.h"
+#include "dds__types.h"
+#include "dds__whc.h"
 
 #include "test_common.h"
 
@@ -300,3 +313,655 @@ CU_Test(ddsc_whc, check_end_state, .init=whc_init, .fini=whc_fini, .timeout=30)
 #undef BE
 #undef KA
 #undef KL
+
+static struct ddsi_whc *whc_new_for_writer (dds_entity_t writer)
+{
+  struct dds_entity *wr_entity;
+  CU_ASSERT_EQ_FATAL (dds_entity_pin (writer, &wr_entity), 0);
+  struct dds_writer * const wr = (struct dds_writer *) wr_entity;
+  struct whc_writer_info *wrinfo = dds_whc_make_wrinfo (wr, wr->m_entity.m_qos);
+  struct ddsi_whc *whc = dds_whc_new (&wr->m_entity.m_domain->gv, wrinfo);
+  dds_whc_free_wrinfo (wrinfo);
+  dds_entity_unpin (wr_entity);
+  return whc;
+}
+
+static void check_same_whc_state (const struct ddsi_whc *whc, const struct ddsi_whc *ref)
+{
+  struct ddsi_whc_state st, st_ref;
+  ddsi_whc_get_state (whc, &st);
+  ddsi_whc_get_state (ref, &st_ref);
+  CU_ASSERT_EQ_FATAL (st.min_seq, st_ref.min_seq);
+  CU_ASSERT_EQ_FATAL (st.max_seq, st_ref.max_seq);
+  CU_ASSERT_EQ_FATAL (st.unacked_bytes, st_ref.unacked_bytes);
+}
+
+CU_Test(ddsc_whc, keep_last_keyless, .init=whc_init, .fini=whc_fini, .timeout=30)
+{
+  /* A keyless volatile KEEP_LAST writer gets a specialized WHC, which must behave
+     the same as the general one does for a single instance */
+  char name[100];
+  dds_qset_durability (g_qos, DDS_DURABILITY_VOLATILE);
+  dds_qset_reliability (g_qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_history (g_qos, DDS_HISTORY_KEEP_LAST, 5);
+  dds_qset_deadline (g_qos, DDS_INFINITY);
+  create_unique_topic_name ("ddsc_whc_keep_last_keyless", name, sizeof name);
+  const dds_entity_t tp_keyless = dds_create_topic (g_participant, &Space_Type3_desc, name, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp_keyless, 0);
+  create_unique_topic_name ("ddsc_whc_keep_last_keyed", name, sizeof name);
+  const dds_entity_t tp_keyed = dds_create_topic (g_participant, &Space_Type1_desc, name, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp_keyed, 0);
+  const dds_entity_t wr_keyless = dds_create_writer (g_publisher, tp_keyless, g_qos, NULL);
+  CU_ASSERT_GT_FATAL (wr_keyless, 0);
+  const dds_entity_t wr_keyed = dds_create_writer (g_publisher, tp_keyed, g_qos, NULL);
+  CU_ASSERT_GT_FATAL (wr_keyed, 0);
+
+  struct ddsi_whc *whc = whc_new_for_writer (wr_keyless);
+  struct ddsi_whc *ref = whc_new_for_writer (wr_keyed);
+  CU_ASSERT_NEQ_FATAL (whc->ops, ref->ops);
+
+  struct dds_entity *x;
+  CU_ASSERT_EQ_FATAL (dds_entity_pin (wr_keyed, &x), 0);
+  struct ddsi_domaingv * const gv = &x->m_domain->gv;
+  const struct ddsi_sertype *st = ((struct dds_writer *) x)->m_topic->m_stype;
+  ddsi_thread_state_awake (ddsi_lookup_thread_state (), gv);
+
+  /* Feed both the same single-instance history, with occasional gaps in the
+     sequence numbers and random acks, borrowing samples in between; the (arbitrary)
+     filter results stored with each sample are its sequence number */
+  ddsrt_prng_t prng;
+  ddsrt_prng_init_simple (&prng, 4711);
+  Space_Type1 sample = { 0, 0, 0 };
+  struct ddsi_tkmap_instance *tk = NULL;
+  ddsi_seqno_t seq = 0, max_drop_seq = 0;
+  for (int32_t i = 0; i < 2000; i++)
+  {
+    const uint32_t op = ddsrt_prng_random (&prng) % 8;
+    if (op < 5)
+    {
+      seq += (ddsrt_prng_random (&prng) % 20 == 0) ? 3 : 1;
+      sample.long_2 = i;
+      struct ddsi_serdata *sd = ddsi_serdata_from_sample (st, SDK_DATA, &sample);
+      if (tk == NULL)
+        tk = ddsi_tkmap_lookup_instance_ref (gv->m_tkmap, sd);
+      CU_ASSERT_EQ_FATAL (ddsi_whc_insert (whc, max_drop_seq, seq, DDSRT_MTIME_NEVER, sd, tk, seq), 0);
+      CU_ASSERT_EQ_FATAL (ddsi_whc_insert (ref, max_drop_seq, seq, DDSRT_MTIME_NEVER, sd, tk, seq), 0);
+      ddsi_serdata_unref (sd);
+    }
+    else if (op < 6 && seq > max_drop_seq)
+    {
+      struct ddsi_whc_state whcst, whcst_ref;
+      struct ddsi_whc_node *dfl, *dfl_ref;
+      max_drop_seq += 1 + ddsrt_prng_random (&prng) % (seq - max_drop_seq);
+      const uint32_t n = ddsi_whc_remove_acked_messages (whc, max_drop_seq, &whcst, &dfl);
+      const uint32_t n_ref = ddsi_whc_remove_acked_messages (ref, max_drop_seq, &whcst_ref, &dfl_ref);
+      ddsi_whc_free_deferred_free_list (whc, dfl);
+      ddsi_whc_free_deferred_free_list (ref, dfl_ref);
+      CU_ASSERT_EQ_FATAL (n, n_ref);
+      CU_ASSERT_EQ_FATAL (whcst.min_seq, whcst_ref.min_seq);
+      CU_ASSERT_EQ_FATAL (whcst.max_seq, whcst_ref.max_seq);
+    }
+    else
+    {
+      /* borrow a sample and return it after a few more writes */
+      const ddsi_seqno_t bseq = seq + 2 - ddsrt_prng_random (&prng) % 10;
+      struct ddsi_whc_borrowed_sample bs, bs_ref;
+      const bool found = ddsi_whc_borrow_sample (whc, bseq, &bs);
+      const bool found_ref = ddsi_whc_borrow_sample (ref, bseq, &bs_ref);
+      CU_ASSERT_EQ_FATAL (found, found_ref);
+      CU_ASSERT_EQ_FATAL (ddsi_whc_next_seq (whc, bseq), ddsi_whc_next_seq (ref, bseq));
+      if (found)
+      {
+        CU_ASSERT_EQ_FATAL (bs.seq, bs_ref.seq);
+        CU_ASSERT_EQ_FATAL (bs.serdata, bs_ref.serdata);
+        CU_ASSERT_EQ_FATAL (bs.unacked, bs_ref.unacked);
+        CU_ASSERT_EQ_FATAL (bs.rexmit_count, bs_ref.rexmit_count);
+        CU_ASSERT_EQ_FATAL (bs.filter_rejects, bs.seq);
+        CU_ASSERT_EQ_FATAL (bs_ref.filter_rejects, bs_ref.seq);
+        CU_ASSERT_FATAL (bs.filter_rejects_valid && bs_ref.filter_rejects_valid);
+        for (uint32_t j = ddsrt_prng_random (&prng) % 8; j > 0; j--)
+        {
+          sample.long_2 = -i;
+          struct ddsi_serdata *sd = ddsi_serdata_from_sample (st, SDK_DATA, &sample);
+          seq++;
+          CU_ASSERT_EQ_FATAL (ddsi_whc_insert (whc, max_drop_seq, seq, DDSRT_MTIME_NEVER, sd, tk, seq), 0);
+          CU_ASSERT_EQ_FATAL (ddsi_whc_insert (ref, max_drop_seq, seq, DDSRT_MTIME_NEVER, sd, tk, seq), 0);
+          ddsi_serdata_unref (sd);
+        }
+        bs.rexmit_count++;
+        bs_ref.rexmit_count++;
+        ddsi_whc_return_sample (whc, &bs, true);
+        ddsi_whc_return_sample (ref, &bs_ref, true);
+      }
+    }
+    check_same_whc_state (whc, ref);
+  }
+
+  /* Iterating must produce the same samples, too */
+  struct ddsi_whc_sample_iter it, it_ref;
+  struct ddsi_whc_borrowed_sample bs, bs_ref;
+  bool valid, valid_ref;
+  ddsi_whc_sample_iter_init (whc, &it);
+  ddsi_whc_sample_iter_init (ref, &it_ref);
+  do {
+    valid = ddsi_whc_sample_iter_borrow_next (&it, &bs);
+    valid_ref = ddsi_whc_sample_iter_borrow_next (&it_ref, &bs_ref);
+    CU_ASSERT_EQ_FATAL (valid, valid_ref);
+    if (valid)
+    {
+      CU_ASSERT_EQ_FATAL (bs.seq, bs_ref.seq);
+      CU_ASSERT_EQ_FATAL (bs.rexmit_count, bs_ref.rexmit_count);
+      CU_ASSERT_EQ_FATAL (bs.filter_rejects, bs_ref.filter_rejects);
+      CU_ASSERT_EQ_FATAL (bs.filter_rejects_valid, bs_ref.filter_rejects_valid);
+    }
+  } while (valid);
+
+  ddsi_whc_free (whc);
+  ddsi_whc_free (ref);
+  if (tk)
+    ddsi_tkmap_instance_unref (gv->m_tkmap, tk);
+  ddsi_thread_state_asleep (ddsi_lookup_thread_state ());
+  dds_entity_unpin (x);
+  dds_delete (wr_keyless);
+  dds_delete (wr_keyed);
+  dds_delete (tp_keyless);
+  dds_delete (tp_keyed);
+}
+
+CU_Test(ddsc_whc, budget, .timeout=30)
+{
+  /* A budget that is much smaller than the high-water mark: once exceeded, only the
+     writer holding most of the unacknowledged data gets throttled */
+  const char *config =
+    "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}"
+    "<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>"
+    "<Internal><Watermarks><WhcBudget>8 kB</WhcBudget><WhcHigh>1 MB</WhcHigh><WhcHighInit>1 MB</WhcHighInit></Watermarks></Internal>";
+  char *conf_pub = ddsrt_expand_envvars (config, DDS_DOMAINID_PUB);
+  char *conf_sub = ddsrt_expand_envvars (config, DDS_DOMAINID_SUB);
+  const dds_entity_t dom_pub = dds_create_domain (DDS_DOMAINID_PUB, conf_pub);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = dds_create_domain (DDS_DOMAINID_SUB, conf_sub);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  dds_free (conf_pub);
+  dds_free (conf_sub);
+
+  const dds_entity_t pp_pub = dds_create_participant (DDS_DOMAINID_PUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  const dds_entity_t pp_sub = dds_create_participant (DDS_DOMAINID_SUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_sub, 0);
+  char name[100];
+  create_unique_topic_name ("ddsc_whc_budget", name, sizeof name);
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_MSECS (50));
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t tp_pub = dds_create_topic (pp_pub, &RoundTripModule_DataType_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t tp_sub = dds_create_topic (pp_sub, &RoundTripModule_DataType_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_sub, 0);
+  const dds_entity_t wr_big = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr_big, 0);
+  const dds_entity_t wr_small = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr_small, 0);
+  const dds_entity_t rd = dds_create_reader (pp_sub, tp_sub, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  sync_reader_writer (pp_sub, rd, pp_pub, wr_big);
+  sync_reader_writer (pp_sub, rd, pp_pub, wr_small);
+
+  /* Stop the reader from acknowledging anything */
+  dds_return_t rc = dds_domain_set_deafmute (dom_sub, true, true, DDS_INFINITY);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+
+  uint8_t payload[1000] = { 0 };
+  RoundTripModule_DataType small = { .payload = { ._length = 16, ._maximum = 16, ._buffer = payload } };
+  RoundTripModule_DataType big = { .payload = { ._length = sizeof (payload), ._maximum = sizeof (payload), ._buffer = payload } };
+  rc = dds_write (wr_small, &small);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+
+  /* Without the budget, the big one would only block after about 1000 samples */
+  int n;
+  for (n = 0; n < 100 && (rc = dds_write (wr_big, &big)) == DDS_RETCODE_OK; n++)
+    ;
+  tprintf ("big writer blocked after %d samples\n", n);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_TIMEOUT);
+  CU_ASSERT_FATAL (n >= 4 && n < 20);
+
+  struct dds_statistics *stat = dds_create_statistics (wr_big);
+  CU_ASSERT_NEQ_FATAL (stat, NULL);
+  rc = dds_refresh_statistics (stat);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  const struct dds_stat_keyvalue *wr_bytes = dds_lookup_statistic (stat, "whc_unacked_bytes");
+  const struct dds_stat_keyvalue *domain_bytes = dds_lookup_statistic (stat, "domain_whc_unacked_bytes");
+  CU_ASSERT_NEQ_FATAL (wr_bytes, NULL);
+  CU_ASSERT_NEQ_FATAL (domain_bytes, NULL);
+  tprintf ("unacked bytes: writer %"PRIu64" domain %"PRIu64"\n", wr_bytes->u.u64, domain_bytes->u.u64);
+  CU_ASSERT_FATAL (wr_bytes->u.u64 >= (uint64_t) n * sizeof (payload));
+  CU_ASSERT_FATAL (domain_bytes->u.u64 > 8192);
+  dds_delete_statistics (stat);
+
+  /* The small writer holds far less than its share and can continue */
+  rc = dds_write (wr_small, &small);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+
+  rc = dds_domain_set_deafmute (dom_sub, false, false, DDS_INFINITY);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+}
+
+CU_Test(ddsc_whc, lossy_retransmit, .timeout=60)
+{
+  /* Retransmits are packed after releasing the writer lock, while the application keeps
+     writing; with a lossy network and several readers that both merges retransmits and
+     sends them to individual readers, and all samples must still arrive in order */
+  const char *config_pub =
+    "${CYCLONEDDS_URI}${CYCLONEDDS_URI:+,}"
+    "<Discovery><ExternalDomainId>0</ExternalDomainId></Discovery>"
+    "<Internal><Test><XmitLossiness>200</XmitLossiness></Test></Internal>";
+  char *conf_pub = ddsrt_expand_envvars (config_pub, DDS_DOMAINID_PUB);
+  char *conf_sub = ddsrt_expand_envvars (DDS_CONFIG_NO_PORT_GAIN, DDS_DOMAINID_SUB);
+  const dds_entity_t dom_pub = dds_create_domain (DDS_DOMAINID_PUB, conf_pub);
+  CU_ASSERT_GT_FATAL (dom_pub, 0);
+  const dds_entity_t dom_sub = dds_create_domain (DDS_DOMAINID_SUB, conf_sub);
+  CU_ASSERT_GT_FATAL (dom_sub, 0);
+  dds_free (conf_pub);
+  dds_free (conf_sub);
+
+  const dds_entity_t pp_pub = dds_create_participant (DDS_DOMAINID_PUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp_pub, 0);
+  char name[100];
+  create_unique_topic_name ("ddsc_whc_lossy_retransmit", name, sizeof name);
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_SECS (10));
+  dds_qset_history (qos, DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t tp_pub = dds_create_topic (pp_pub, &Space_Type1_desc, name, qos, NULL);
+  CU_ASSERT_GT_FATAL (tp_pub, 0);
+  const dds_entity_t wr = dds_create_writer (pp_pub, tp_pub, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+
+#define LOSSY_NREADERS 3
+#define LOSSY_NINST 10
+#define LOSSY_NSAMPLES 2000
+  dds_entity_t pp_sub[LOSSY_NREADERS], rd[LOSSY_NREADERS];
+  for (int i = 0; i < LOSSY_NREADERS; i++)
+  {
+    pp_sub[i] = dds_create_participant (DDS_DOMAINID_SUB, NULL, NULL);
+    CU_ASSERT_GT_FATAL (pp_sub[i], 0);
+    const dds_entity_t tp_sub = dds_create_topic (pp_sub[i], &Space_Type1_desc, name, qos, NULL);
+    CU_ASSERT_GT_FATAL (tp_sub, 0);
+    rd[i] = dds_create_reader (pp_sub[i], tp_sub, qos, NULL);
+    CU_ASSERT_GT_FATAL (rd[i], 0);
+    sync_reader_writer (pp_sub[i], rd[i], pp_pub, wr);
+  }
+  dds_delete_qos (qos);
+  // the readers are volatile, so the writer must know all of them before it writes
+  dds_publication_matched_status_t pm;
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  while (dds_get_publication_matched_status (wr, &pm) == 0 && pm.current_count < LOSSY_NREADERS && dds_time () < tend)
+    dds_sleepfor (DDS_MSECS (10));
+  CU_ASSERT_EQ_FATAL (pm.current_count, LOSSY_NREADERS);
+
+  for (int32_t i = 0; i < LOSSY_NSAMPLES; i++)
+  {
+    const Space_Type1 s = { i % LOSSY_NINST, i / LOSSY_NINST, 0 };
+    dds_return_t rc = dds_write (wr, &s);
+    CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  }
+  dds_return_t rc = dds_wait_for_acks (wr, DDS_SECS (30));
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  struct dds_statistics *stat = dds_create_statistics (wr);
+  rc = dds_refresh_statistics (stat);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  const struct dds_stat_keyvalue *rexmit_bytes = dds_lookup_statistic (stat, "rexmit_bytes");
+  CU_ASSERT_NEQ_FATAL (rexmit_bytes, NULL);
+  CU_ASSERT_GT (rexmit_bytes->u.u64, 0);
+  dds_delete_statistics (stat);
+
+  for (int i = 0; i < LOSSY_NREADERS; i++)
+  {
+    int32_t next[LOSSY_NINST] = { 0 };
+    int32_t n = 0;
+    Space_Type1 s;
+    void *raw = &s;
+    dds_sample_info_t si;
+    while (dds_take (rd[i], &raw, &si, 1, 1) == 1)
+    {
+      CU_ASSERT_FATAL (si.valid_data);
+      CU_ASSERT_FATAL (s.long_1 >= 0 && s.long_1 < LOSSY_NINST);
+      CU_ASSERT_EQ_FATAL (s.long_2, next[s.long_1]);
+      next[s.long_1]++;
+      n++;
+    }
+    CU_ASSERT_EQ (n, LOSSY_NSAMPLES);
+  }
+#undef LOSSY_NSAMPLES
+#undef LOSSY_NINST
+#undef LOSSY_NREADERS
+
+  rc = dds_delete (dom_pub);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  rc = dds_delete (dom_sub);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+}
+
+#ifndef _WIN32
+#define STORE_NINST 10
+#define STORE_DEPTH 2
+
+static dds_entity_t create_store_domain (dds_domainid_t domid, const char *dir)
+{
+  char *config = NULL, *xconfig;
+  (void) ddsrt_asprintf (&config, "%s<Internal><TransientLocalStoreDirectory>%s</TransientLocalStoreDirectory></Internal>", DDS_CONFIG_NO_PORT_GAIN, dir);
+  xconfig = ddsrt_expand_envvars (config, domid);
+  const dds_entity_t dom = dds_create_domain (domid, xconfig);
+  CU_ASSERT_GT_FATAL (dom, 0);
+  ddsrt_free (xconfig);
+  ddsrt_free (config);
+  return dom;
+}
+
+static void remove_store_dir (const char *dir)
+{
+  DIR *d = opendir (dir);
+  struct dirent *de;
+  CU_ASSERT_NEQ_FATAL (d, NULL);
+  while ((de = readdir (d)) != NULL)
+  {
+    char *path = NULL;
+    if (strcmp (de->d_name, ".") == 0 || strcmp (de->d_name, "..") == 0)
+      continue;
+    (void) ddsrt_asprintf (&path, "%s/%s", dir, de->d_name);
+    (void) unlink (path);
+    ddsrt_free (path);
+  }
+  closedir (d);
+  (void) rmdir (dir);
+}
+
+static size_t store_dir_size (const char *dir)
+{
+  DIR *d = opendir (dir);
+  struct dirent *de;
+  size_t size = 0;
+  CU_ASSERT_NEQ_FATAL (d, NULL);
+  while ((de = readdir (d)) != NULL)
+  {
+    char *path = NULL;
+    struct stat st;
+    (void) ddsrt_asprintf (&path, "%s/%s", dir, de->d_name);
+    if (stat (path, &st) == 0 && S_ISREG (st.st_mode))
+      size += (size_t) st.st_size;
+    ddsrt_free (path);
+  }
+  closedir (d);
+  return size;
+}
+
+static dds_qos_t *create_store_qos (dds_history_kind_t kind, int32_t depth)
+{
+  dds_qos_t *qos = dds_create_qos ();
+  dds_qset_reliability (qos, DDS_RELIABILITY_RELIABLE, DDS_INFINITY);
+  dds_qset_durability (qos, DDS_DURABILITY_TRANSIENT_LOCAL);
+  dds_qset_history (qos, kind, depth);
+  dds_qset_durability_service (qos, 0, kind, depth, DDS_LENGTH_UNLIMITED, DDS_LENGTH_UNLIMITED, DDS_LENGTH_UNLIMITED);
+  return qos;
+}
+
+static void check_store_history (dds_entity_t pp, const char *topicname, int32_t extra)
+{
+  // a late-joining reader must get the last STORE_DEPTH samples of each registered instance,
+  // with an "extra" one for instance 0
+  dds_qos_t *qos = create_store_qos (DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t tp = dds_create_topic (pp, &Space_Type1_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  const dds_entity_t rd = dds_create_reader (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  const uint32_t nexp = (STORE_NINST - 1) * STORE_DEPTH;
+  Space_Type1 xs[2 * nexp];
+  void *raw[2 * nexp];
+  dds_sample_info_t si[2 * nexp];
+  for (uint32_t i = 0; i < 2 * nexp; i++)
+    raw[i] = &xs[i];
+  dds_return_t n = 0;
+  const dds_time_t tend = dds_time () + DDS_SECS (10);
+  while (dds_time () < tend && (n = dds_read (rd, raw, si, 2 * nexp, 2 * nexp)) < (dds_return_t) nexp)
+    dds_sleepfor (DDS_MSECS (10));
+  CU_ASSERT_EQ_FATAL (n, (dds_return_t) nexp);
+  int32_t count[STORE_NINST] = { 0 };
+  for (int32_t i = 0; i < n; i++)
+  {
+    CU_ASSERT_FATAL (si[i].valid_data);
+    CU_ASSERT_FATAL (xs[i].long_1 >= 0 && xs[i].long_1 < STORE_NINST - 1);
+    const int32_t v0 = (xs[i].long_1 == 0) ? 3 + extra : 3;
+    CU_ASSERT_FATAL (xs[i].long_2 == v0 || xs[i].long_2 == v0 + 1);
+    CU_ASSERT_EQ_FATAL (xs[i].long_3, xs[i].long_1 + xs[i].long_2);
+    count[xs[i].long_1]++;
+  }
+  for (int32_t k = 0; k < STORE_NINST - 1; k++)
+    CU_ASSERT_EQ_FATAL (count[k], STORE_DEPTH);
+  dds_delete (rd);
+}
+
+CU_Test(ddsc_whc, store_restart, .timeout=60)
+{
+  char dir[] = "/tmp/cdds_whc_store_XXXXXX";
+  char topicname[100];
+  CU_ASSERT_NEQ_FATAL (mkdtemp (dir), NULL);
+  create_unique_topic_name ("ddsc_whc_store_restart", topicname, sizeof (topicname));
+
+  // first incarnation writes the data, the second must find it in the file, the third
+  // one checks that the history of the second was also kept in the store
+  for (int32_t incarnation = 0; incarnation < 3; incarnation++)
+  {
+    const dds_entity_t dom_pub = create_store_domain (DDS_DOMAINID_PUB, dir);
+    const dds_entity_t dom_sub = create_store_domain (DDS_DOMAINID_SUB, dir);
+    const dds_entity_t pp_pub = dds_create_participant (DDS_DOMAINID_PUB, NULL, NULL);
+    CU_ASSERT_GT_FATAL (pp_pub, 0);
+    const dds_entity_t pp_sub = dds_create_participant (DDS_DOMAINID_SUB, NULL, NULL);
+    CU_ASSERT_GT_FATAL (pp_sub, 0);
+    const dds_entity_t tp = dds_create_topic (pp_pub, &Space_Type1_desc, topicname, NULL, NULL);
+    CU_ASSERT_GT_FATAL (tp, 0);
+    dds_qos_t *qos = create_store_qos (DDS_HISTORY_KEEP_LAST, STORE_DEPTH);
+    const dds_entity_t wr = dds_create_writer (pp_pub, tp, qos, NULL);
+    CU_ASSERT_GT_FATAL (wr, 0);
+    dds_delete_qos (qos);
+
+    dds_return_t rc;
+    if (incarnation == 0)
+    {
+      // lots of garbage in the file so that it gets compacted
+      for (int32_t j = 0; j < 30000; j++)
+      {
+        rc = dds_write (wr, &(Space_Type1){ 0, -1, -1 });
+        CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+      }
+      for (int32_t k = 0; k < STORE_NINST; k++)
+      {
+        for (int32_t j = 0; j < 5; j++)
+        {
+          rc = dds_write (wr, &(Space_Type1){ k, j, k + j });
+          CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+        }
+      }
+      rc = dds_unregister_instance (wr, &(Space_Type1){ STORE_NINST - 1, 0, 0 });
+      CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+    }
+
+    // local reader gets it from the WHC directly, the remote one via retransmits
+    check_store_history (pp_pub, topicname, incarnation == 2);
+    check_store_history (pp_sub, topicname, incarnation == 2);
+
+    if (incarnation == 1)
+    {
+      rc = dds_write (wr, &(Space_Type1){ 0, 5, 5 });
+      CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+    }
+
+    rc = dds_delete (dom_sub);
+    CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+    rc = dds_delete (dom_pub);
+    CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+    // without compaction, the garbage alone would occupy more than 1MB
+    CU_ASSERT_FATAL (store_dir_size (dir) < 30000 * sizeof (Space_Type1));
+  }
+  remove_store_dir (dir);
+}
+
+CU_Test(ddsc_whc, store_lifespan, .timeout=30)
+{
+  char dir[] = "/tmp/cdds_whc_store_XXXXXX";
+  char topicname[100];
+  CU_ASSERT_NEQ_FATAL (mkdtemp (dir), NULL);
+  create_unique_topic_name ("ddsc_whc_store_lifespan", topicname, sizeof (topicname));
+  const dds_entity_t dom = create_store_domain (DDS_DOMAINID_PUB, dir);
+  const dds_entity_t pp = dds_create_participant (DDS_DOMAINID_PUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp, 0);
+  const dds_entity_t tp = dds_create_topic (pp, &Space_Type1_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  dds_qos_t *qos = create_store_qos (DDS_HISTORY_KEEP_LAST, STORE_DEPTH);
+  dds_qset_lifespan (qos, DDS_SECS (1));
+  const dds_entity_t wr = dds_create_writer (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  dds_delete_qos (qos);
+
+  // the first half of the instances expires before the second half gets written, so a
+  // late-joining reader must only get the second half
+  dds_return_t rc;
+  for (int32_t k = 0; k < STORE_NINST; k++)
+  {
+    if (k == STORE_NINST / 2)
+      dds_sleepfor (DDS_MSECS (1200));
+    for (int32_t j = 0; j < STORE_DEPTH; j++)
+    {
+      rc = dds_write (wr, &(Space_Type1){ k, j, k + j });
+      CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+    }
+  }
+
+  qos = create_store_qos (DDS_HISTORY_KEEP_ALL, 0);
+  const dds_entity_t rd = dds_create_reader (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (rd, 0);
+  dds_delete_qos (qos);
+  Space_Type1 xs[STORE_NINST * STORE_DEPTH];
+  void *raw[STORE_NINST * STORE_DEPTH];
+  dds_sample_info_t si[STORE_NINST * STORE_DEPTH];
+  for (uint32_t i = 0; i < STORE_NINST * STORE_DEPTH; i++)
+    raw[i] = &xs[i];
+  rc = dds_read (rd, raw, si, STORE_NINST * STORE_DEPTH, STORE_NINST * STORE_DEPTH);
+  CU_ASSERT_EQ_FATAL (rc, (STORE_NINST / 2) * STORE_DEPTH);
+  for (int32_t i = 0; i < rc; i++)
+  {
+    CU_ASSERT_FATAL (si[i].valid_data);
+    CU_ASSERT_FATAL (xs[i].long_1 >= STORE_NINST / 2);
+  }
+
+  rc = dds_delete (dom);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  remove_store_dir (dir);
+}
+
+static struct ddsi_writer *lookup_ddsi_writer (dds_entity_t writer, struct dds_entity **wr_entity)
+{
+  struct ddsi_writer *wr;
+  CU_ASSERT_EQ_FATAL (dds_entity_pin (writer, wr_entity), 0);
+  ddsi_thread_state_awake (ddsi_lookup_thread_state (), &(*wr_entity)->m_domain->gv);
+  wr = ddsi_entidx_lookup_writer_guid ((*wr_entity)->m_domain->gv.entity_index, &(*wr_entity)->m_guid);
+  CU_ASSERT_NEQ_FATAL (wr, NULL);
+  return wr;
+}
+
+static void unlookup_ddsi_writer (struct dds_entity *wr_entity)
+{
+  ddsi_thread_state_asleep (ddsi_lookup_thread_state ());
+  dds_entity_unpin (wr_entity);
+}
+
+CU_Test(ddsc_whc, store_throughput, .timeout=120)
+{
+  // Not so much a test as a benchmark for the file-backed transient-local history: rates
+  // for storing, looking up samples by sequence number as for retransmits, iterating over
+  // the history as for late-joining local readers and reloading it at writer creation
+  const uint32_t nsamples = 20000, nlookups = 100000, payload_size = 1024;
+  char dir[] = "/tmp/cdds_whc_store_XXXXXX";
+  char topicname[100];
+  CU_ASSERT_NEQ_FATAL (mkdtemp (dir), NULL);
+  create_unique_topic_name ("ddsc_whc_store_throughput", topicname, sizeof (topicname));
+  const dds_entity_t dom = create_store_domain (DDS_DOMAINID_PUB, dir);
+  const dds_entity_t pp = dds_create_participant (DDS_DOMAINID_PUB, NULL, NULL);
+  CU_ASSERT_GT_FATAL (pp, 0);
+  const dds_entity_t tp = dds_create_topic (pp, &RoundTripModule_DataType_desc, topicname, NULL, NULL);
+  CU_ASSERT_GT_FATAL (tp, 0);
+  dds_qos_t *qos = create_store_qos (DDS_HISTORY_KEEP_ALL, 0);
+  dds_entity_t wr = dds_create_writer (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+
+  uint8_t *payload = ddsrt_malloc (payload_size);
+  memset (payload, 0x55, payload_size);
+  RoundTripModule_DataType sample = { .payload = { ._length = payload_size, ._maximum = payload_size, ._buffer = payload } };
+  dds_time_t t0 = dds_time ();
+  for (uint32_t i = 0; i < nsamples; i++)
+  {
+    dds_return_t rc = dds_write (wr, &sample);
+    CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  }
+  dds_time_t t1 = dds_time ();
+  tprintf ("store: %.0f samples/s\n", nsamples / ((double) (t1 - t0) / 1e9));
+  ddsrt_free (payload);
+
+  struct dds_entity *wr_entity;
+  struct ddsi_writer *ddsi_wr = lookup_ddsi_writer (wr, &wr_entity);
+  struct ddsi_whc_state whcst;
+  struct ddsi_whc_borrowed_sample bs;
+  ddsi_whc_get_state (ddsi_wr->whc, &whcst);
+  CU_ASSERT_EQ_FATAL (whcst.max_seq - whcst.min_seq + 1, nsamples);
+  CU_ASSERT_EQ_FATAL (whcst.unacked_bytes, 0);
+  ddsrt_prng_t prng;
+  ddsrt_prng_init_simple (&prng, 0);
+  t0 = dds_time ();
+  for (uint32_t i = 0; i < nlookups; i++)
+  {
+    const ddsi_seqno_t seq = whcst.min_seq + ddsrt_prng_random (&prng) % nsamples;
+    CU_ASSERT_FATAL (ddsi_whc_borrow_sample (ddsi_wr->whc, seq, &bs));
+    CU_ASSERT_EQ_FATAL (bs.seq, seq);
+    ddsi_whc_return_sample (ddsi_wr->whc, &bs, false);
+  }
+  t1 = dds_time ();
+  tprintf ("lookup: %.0f lookups/s\n", nlookups / ((double) (t1 - t0) / 1e9));
+
+  struct ddsi_whc_sample_iter it;
+  uint64_t nbytes = 0;
+  uint32_t n = 0;
+  t0 = dds_time ();
+  ddsi_whc_sample_iter_init (ddsi_wr->whc, &it);
+  while (ddsi_whc_sample_iter_borrow_next (&it, &bs))
+  {
+    nbytes += ddsi_serdata_size (bs.serdata);
+    n++;
+  }
+  t1 = dds_time ();
+  CU_ASSERT_EQ_FATAL (n, nsamples);
+  tprintf ("iterate: %.1f MB/s\n", (double) nbytes / ((double) (t1 - t0) / 1e3));
+  unlookup_ddsi_writer (wr_entity);
+
+  dds_return_t rc = dds_delete (wr);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  t0 = dds_time ();
+  wr = dds_create_writer (pp, tp, qos, NULL);
+  CU_ASSERT_GT_FATAL (wr, 0);
+  t1 = dds_time ();
+  tprintf ("reload: %.1f MB/s\n", (double) nbytes / ((double) (t1 - t0) / 1e3));
+  ddsi_wr = lookup_ddsi_writer (wr, &wr_entity);
+  ddsi_whc_get_state (ddsi_wr->whc, &whcst);
+  CU_ASSERT_EQ_FATAL (whcst.min_seq, 1);
+  CU_ASSERT_EQ_FATAL (whcst.max_seq, nsamples);
+  unlookup_ddsi_writer (wr_entity);
+
+  dds_delete_qos (qos);
+  rc = dds_delete (dom);
+  CU_ASSERT_EQ_FATAL (rc, DDS_RETCODE_OK);
+  remove_store_dir (dir);
+}
+#endif
@@ -30,6 +30,7 @@ void ddsi_config_init_default (struct ddsi_config *cfg)
 #endif /* DDS_HAS_NETWORK_PARTITIONS */
   cfg->rbuf_size = UINT32_C (1048576);
   cfg->rmsg_chunk_size = UINT32_C (131072);
+  cfg->zerocopy_receive_limit = UINT32_C (16777216);
   cfg->standards_conformance = INT32_C (2);
   cfg->many_sockets_mode = INT32_C (1);
   cfg->protocol_version.major = 2;
@@ -56,6 +57,8 @@ void ddsi_config_init_default (struct ddsi_config *cfg)
   cfg->tracefile = "cyclonedds.log";
   cfg->pcap_file = "";
   cfg->delivery_queue_maxsamples = UINT32_C (256);
+  cfg->delivery_queues = INT32_C (1);
+  cfg->reader_history_shards = INT32_C (1);
   cfg->primary_reorder_maxsamples = UINT32_C (128);
   cfg->secondary_reorder_maxsamples = UINT32_C (128);
   cfg->defrag_unreliable_maxsamples = UINT32_C (4);
@@ -70,6 +73,8 @@ void ddsi_config_init_default (struct ddsi_config *cfg)
   cfg->max_queued_rexmit_bytes = UINT32_C (524288);
   cfg->max_queued_rexmit_msgs = UINT32_C (200);
   cfg->writer_linger_duration = INT64_C (1000000000);
+  cfg->history_replay_interval = INT64_C (1000000);
+  cfg->tl_store_directory = "";
   cfg->socket_rcvbuf_size.min.isdefault = 1;
   cfg->socket_rcvbuf_size.max.isdefault = 1;
   cfg->socket_sndbuf_size.min.isdefault = 0;
@@ -85,6 +90,8 @@ void ddsi_config_init_default (struct ddsi_config *cfg)
   cfg->monitor_port = INT32_C (-1);
   cfg->prioritize_retransmit = INT32_C (1);
   cfg->recv_thread_stop_maxretries = UINT32_C (4294967295);
+  cfg->recv_uc_sockets = INT32_C (1);
+  cfg->recv_batch_size = INT32_C (8);
   cfg->whc_lowwater_mark = UINT32_C (1024);
   cfg->whc_highwater_mark = UINT32_C (512000);
   cfg->whc_init_highwater_mark.isdefault = 0;
@@ -108,14 +115,14 @@ void ddsi_config_init_default (struct ddsi_config *cfg)
   cfg->ssl_min_version.minor = 3;
 #endif /* DDS_HAS_TCP_TLS */
 }
-/* generated from ddsi_config.h[296c449e5f567df1dad1ac3d0db7c8f079ee9cc3] */
-/* generated from ddsi_config.c[898d7e396b2d99b164e14562b1fa6c33910f2cc7] */
-/* generated from ddsi__cfgelems.h[0224b00c31124b7d7148a6cb4bf179561fbba4e7] */
+/* generated from ddsi_config.h[6db54357cf95baca7fde271aa9c4f6ca6c7c5de6] */
+/* generated from ddsi_config.c[352941cc13a6d300c2af5756b49efa61a3ba56ff] */
+/* generated from ddsi__cfgelems.h[5372ee3ce7f49a06d326b619b5a2ebc3ef8600fd] */
 /* generated from cfgunits.h[05f093223fce107d24dd157ebaafa351dc9df752] */
-/* generated from _confgen.h[bb9a0fc6ef1f7f7c46790ee00132e340e5fff36d] */
+/* generated from _confgen.h[99fd431d2445ae884c5fb67ed29c955a82b50099] */
 /* generated from _confgen.c[500178f92fc0791a8de2234cea5b277820e6b40b] */
 /* generated from generate_rnc.c[b50e4b7ab1d04b2bc1d361a0811247c337b74934] */
 /* generated from generate_md.c[789b92e422631684352909cfb8bf43f6ceb16a01] */
 /* generated from generate_rst.c[3c4b523fbb57c8e4a7e247379d06a8021ccc21c4] */
 /* generated from generate_xsd.c[9bb91084fff7495aee9c025db3108549a0141957] */
-/* generated from generate_defconfig.c[02afff6935d72b7f04dc64c8a649b09f9f6143ac] */
+/* generated from generate_defconfig.c[bef2a9153b83ff32682f5b4307f462be27f2cb90] */
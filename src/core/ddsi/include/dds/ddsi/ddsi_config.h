@@ -133,6 +133,8 @@ struct ddsi_config_thread_properties_listelem {
   struct ddsi_config_maybe_int32 schedule_priority;
   struct ddsi_config_maybe_uint32 stack_size;
   struct ddsi_config_uint32_array affinity;
+  int64_t spin_duration;
+  int64_t socket_busy_poll;
 };
 
 struct ddsi_config_peer_listelem
@@ -188,6 +190,12 @@ enum ddsi_many_sockets_mode {
   DDSI_MSM_MANY_UNICAST
 };
 
+enum ddsi_socket_timestamps {
+  DDSI_SOCKTS_NONE,
+  DDSI_SOCKTS_SOFTWARE,
+  DDSI_SOCKTS_HARDWARE
+};
+
 #ifdef DDS_HAS_SECURITY
 struct ddsi_plugin_library_properties {
   char *library_path;
@@ -279,6 +287,18 @@ struct ddsi_config_psmx_listelem {
   struct ddsi_config_psmx cfg;
 };
 
+/* Upper bound for Internal/ReceiveBatchSize */
+#define DDSI_MAX_RECV_BATCH_SIZE 16
+
+/* Upper bound for Internal/MultipleReceiveThreads[@unicastsockets] */
+#define DDSI_MAX_RECV_UC_SOCKETS 8
+
+/* Upper bound for Internal/DeliveryQueues */
+#define DDSI_MAX_DELIVERY_QUEUES 8
+
+/* Upper bound for Internal/ReaderHistoryShards */
+#define DDSI_MAX_READER_HISTORY_SHARDS 64
+
 /* Expensive checks (compiled in when NDEBUG not defined, enabled only if flag set in xchecks) */
 #define DDSI_XCHECK_WHC 1u
 #define DDSI_XCHECK_RHC 2u
@@ -320,6 +340,7 @@ struct ddsi_config
   enum ddsi_fake_network_topology_kind fake_network_topology_kind;
   char *fake_network_topology_file;
 #endif
+  int transport_io_uring; /* udp/udp6 using io_uring, set via transport_selector */
   enum ddsi_boolean_default compat_use_ipv6;
   enum ddsi_boolean_default compat_tcp_enable;
   int dontRoute;
@@ -349,18 +370,28 @@ struct ddsi_config
   int prioritize_retransmit;
   enum ddsi_boolean_default multiple_recv_threads;
   unsigned recv_thread_stop_maxretries;
+  int recv_uc_sockets;
+  int recv_uc_steer_by_source;
+  int recv_batch_size;
+  enum ddsi_socket_timestamps socket_timestamps;
 
   unsigned primary_reorder_maxsamples;
   unsigned secondary_reorder_maxsamples;
 
   unsigned delivery_queue_maxsamples;
+  int delivery_queues;
+  int reader_history_shards;
 
   uint16_t fragment_size;
   uint32_t max_msg_size;
   uint32_t max_rexmit_msg_size;
+  int udp_segmentation_offload;
+  uint32_t zerocopy_send_threshold;
+  uint32_t zerocopy_receive_threshold;
   uint32_t init_transmit_extra_pct;
   uint32_t max_rexmit_burst_size;
   uint32_t max_frags_in_rexmit_of_sample;
+  uint32_t history_replay_burst_size;
 
   int publish_uc_locators; /* Publish discovery unicast locators */
   int enable_uc_locators; /* If false, don't even try to create a unicast socket */
@@ -403,6 +434,9 @@ struct ddsi_config
   int xmit_lossiness;           /**<< fraction of packets to drop on xmit, in units of 1e-3 */
   uint32_t rmsg_chunk_size;          /**<< size of a chunk in the receive buffer */
   uint32_t rbuf_size;                /* << size of a single receiver buffer */
+  uint32_t rbufpool_size;            /* << size of preallocated region per receive buffer pool, 0 = disabled */
+  int rbufpool_hugepages;            /* << back preallocated receive buffer pool region with huge pages */
+  uint32_t zerocopy_receive_limit;   /* << maximum amount of sample data referenced in place per receive buffer pool */
   enum ddsi_besmode besmode;
   int meas_hb_to_ack_latency;
   int synchronous_delivery_priority_threshold;
@@ -414,14 +448,18 @@ struct ddsi_config
   uint32_t whc_lowwater_mark;
   uint32_t whc_highwater_mark;
   struct ddsi_config_maybe_uint32 whc_init_highwater_mark;
+  uint32_t whc_budget;
   int whc_adaptive;
 
   unsigned defrag_unreliable_maxsamples;
   unsigned defrag_reliable_maxsamples;
+  uint32_t defrag_contiguous_threshold;
   unsigned accelerate_rexmit_block_size;
   int64_t responsiveness_timeout;
   uint32_t max_participants;
   int64_t writer_linger_duration;
+  int64_t history_replay_interval;
+  char *tl_store_directory;
   int multicast_ttl;
   struct ddsi_config_socket_buf_size socket_rcvbuf_size;
   struct ddsi_config_socket_buf_size socket_sndbuf_size;
@@ -0,0 +1,90 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#ifndef DDSI_CONTENT_FILTER_H
+#define DDSI_CONTENT_FILTER_H
+
+#include "dds/export.h"
+#include "dds/ddsi/ddsi_plist.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+struct ddsi_sertype;
+struct ddsi_serdata;
+struct ddsi_content_filter;
+
+/* Filter class name for the SQL-like filter expressions defined by the DDS spec */
+#define DDSI_CONTENT_FILTER_CLASS_SQL "DDSSQL"
+
+/* Interface through which the DDSI layer can evaluate the content filter expressions
+   remote readers advertise in discovery, provided by the layer that knows how to
+   interpret the types. */
+struct ddsi_content_filter_interface {
+  void *arg;
+
+  /* Returns NULL if the filter can't be evaluated for this type, in which case
+     all data is sent */
+  struct ddsi_content_filter * (*compile) (const struct ddsi_sertype *type, const ddsi_content_filter_property_t *prop, void *arg);
+  bool (*accepts) (const struct ddsi_content_filter *filter, const struct ddsi_serdata *serdata, void *arg);
+  void (*free) (struct ddsi_content_filter *filter, void *arg);
+};
+
+/** @component content_filter */
+inline struct ddsi_content_filter *ddsi_content_filter_compile (const struct ddsi_content_filter_interface *cfif, const struct ddsi_sertype *type, const ddsi_content_filter_property_t *prop) {
+  return (cfif && prop) ? cfif->compile (type, prop, cfif->arg) : NULL;
+}
+
+/** @component content_filter */
+inline bool ddsi_content_filter_accepts (const struct ddsi_content_filter_interface *cfif, const struct ddsi_content_filter *filter, const struct ddsi_serdata *serdata) {
+  return filter ? cfif->accepts (filter, serdata, cfif->arg) : true;
+}
+
+/** @component content_filter */
+inline void ddsi_content_filter_free (const struct ddsi_content_filter_interface *cfif, struct ddsi_content_filter *filter) {
+  if (filter) cfif->free (filter, cfif->arg);
+}
+
+/**
+ * @brief Duplicates a content filter property
+ * @component content_filter
+ *
+ * @param[in] src  property to copy
+ * @returns a newly allocated copy
+ */
+DDS_EXPORT ddsi_content_filter_property_t *ddsi_content_filter_property_dup (const ddsi_content_filter_property_t *src);
+
+/**
+ * @brief Frees a content filter property allocated by @ref ddsi_content_filter_property_dup
+ * @component content_filter
+ *
+ * @param[in] prop  property to free, may be NULL
+ */
+DDS_EXPORT void ddsi_content_filter_property_free (ddsi_content_filter_property_t *prop);
+
+/**
+ * @brief Compares two content filter properties for equivalence
+ * @component content_filter
+ *
+ * The name of the content-filtered topic is ignored because it doesn't affect the result
+ * of the filter.
+ *
+ * @param[in] a  property, may be NULL
+ * @param[in] b  property, may be NULL
+ * @returns true iff both are NULL or they define the same filter
+ */
+DDS_EXPORT bool ddsi_content_filter_property_equal (const ddsi_content_filter_property_t *a, const ddsi_content_filter_property_t *b);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* DDSI_CONTENT_FILTER_H */
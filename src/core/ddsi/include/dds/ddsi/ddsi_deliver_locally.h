@@ -43,11 +43,15 @@ typedef struct ddsi_reader * (*deliver_locally_next_reader_t) (struct ddsi_entit
     - anything else: error to be returned from deliver_locally_xxx */
 typedef dds_return_t (*deliver_locally_on_failure_fastpath_t) (struct ddsi_entity_common *source_entity, bool source_entity_locked, struct ddsi_local_reader_ary *fastpath_rdary, void *vsourceinfo);
 
+/** optional, called after the sample has been stored in the history cache of the reader */
+typedef void (*deliver_locally_on_stored_t) (struct ddsi_reader *rd, void *vsourceinfo);
+
 struct ddsi_deliver_locally_ops {
   deliver_locally_makesample_t makesample;
   deliver_locally_first_reader_t first_reader;
   deliver_locally_next_reader_t next_reader;
   deliver_locally_on_failure_fastpath_t on_failure_fastpath;
+  deliver_locally_on_stored_t on_stored;
 };
 
 /** @component local_delivery */
@@ -50,6 +50,7 @@ struct dds_security_context;
 struct dds_security_match_index;
 struct ddsi_hsadmin;
 struct spdp_admin;
+struct ddsi_content_filter_interface;
 
 struct ddsi_config_in_addr_node {
    ddsi_locator_t loc;
@@ -80,6 +81,7 @@ struct ddsi_recv_thread_arg {
     } single;
     struct {
       struct ddsi_sock_waitset *ws;
+      struct ddsi_tran_conn *conn; /* if non-NULL, the only socket handled by this thread */
     } many;
   } u;
 };
@@ -125,6 +127,10 @@ struct ddsi_domaingv {
   struct ddsi_tran_conn * data_conn_mc;
   struct ddsi_tran_conn * disc_conn_uc[MAX_XMIT_CONNS];
   struct ddsi_tran_conn * data_conn_uc[MAX_XMIT_CONNS];
+  /* Additional sockets bound to the same port as data_conn_uc[0] if the
+     load is spread over multiple receive threads using SO_REUSEPORT */
+  uint32_t n_data_conn_uc_shards;
+  struct ddsi_tran_conn * data_conn_uc_shards[DDSI_MAX_RECV_UC_SOCKETS - 1];
 
   /* Connections used for output (for connectionless transports), split
      between metatraffic and user data so the source port can follow the
@@ -208,7 +214,7 @@ struct ddsi_domaingv {
      trigger socket.) Receive buffer pool is per receive thread,
      it is only a global variable because it needs to be freed way later
      than the receive thread itself terminates */
-#define MAX_RECV_THREADS 3
+#define MAX_RECV_THREADS (3 + DDSI_MAX_RECV_UC_SOCKETS - 1)
   uint32_t n_recv_threads;
   struct recv_thread {
     const char *name;
@@ -263,8 +269,10 @@ struct ddsi_domaingv {
   uint32_t networkQueueId;
   struct ddsi_thread_state *channel_reader_thrst;
 
-  /* Application data gets its own delivery queue */
-  struct ddsi_dqueue *user_dqueue;
+  /* Application data gets its own delivery queues, each proxy writer is
+     assigned to one of them based on its GUID */
+  uint32_t n_user_dqueues;
+  struct ddsi_dqueue *user_dqueues[DDSI_MAX_DELIVERY_QUEUES];
 
   /* Transmit side: pool for transmit queue*/
   struct ddsi_xmsgpool *xmsgpool;
@@ -296,11 +304,17 @@ struct ddsi_domaingv {
   bool sendq_running;
   ddsrt_mutex_t sendq_running_lock;
 
+  /* Unacknowledged data in all WHCs together and the number of WHCs
+     contributing to it, for enforcing the WhcBudget */
+  ddsrt_atomic_uint64_t whc_unacked_bytes;
+  ddsrt_atomic_uint32_t whc_unacked_writers;
+
   /* File for dumping captured packets, NULL if disabled */
   FILE *pcap_fp;
   ddsrt_mutex_t pcap_lock;
 
   struct ddsi_builtin_topic_interface *builtin_topic_interface;
+  const struct ddsi_content_filter_interface *content_filter_interface;
 
   struct ddsi_mcgroup_membership *mship;
 
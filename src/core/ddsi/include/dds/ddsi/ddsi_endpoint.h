@@ -31,6 +31,8 @@ struct ddsi_endpoint_common;
 struct ddsi_ldur_fhnode;
 struct ddsi_entity_index;
 struct dds_qos;
+struct ddsi_content_filter_property;
+struct ddsi_writer_content_filter;
 
 /* Liveliness changed is more complicated than just add/remove. Encode the event
    in ddsi_status_cb_data_t::extra and ignore ddsi_status_cb_data_t::add */
@@ -126,6 +128,11 @@ struct ddsi_writer
   uint64_t sent_bytes; /* cum bytes sent (excluding retransmits) */
   uint64_t time_throttled; /* cum time in throttled state */
   uint64_t time_retransmit; /* cum time in retransmitting state */
+  uint64_t replay_bytes; /* cum bytes of history sent to late-joining readers outside the retransmit path */
+  uint32_t num_readers_replaying; /* number of PROXY readers still being sent the history */
+  uint32_t num_readers_filtered; /* number of PROXY readers with a content filter evaluated by this writer */
+  uint64_t content_filters_in_use; /* bitmask of the slots in content_filters that are in use */
+  struct ddsi_writer_content_filter *content_filters; /* distinct content filters of PROXY readers, allocated on first use */
   struct ddsi_xeventq *evq; /* timed event queue to be used by this writer */
   struct ddsi_local_reader_ary rdary; /* LOCAL readers for fast-pathing; if not fast-pathed, fall back to scanning local_readers */
   struct ddsi_lease *lease; /* for liveliness administration (writer can only become inactive when using manual liveliness) */
@@ -138,6 +145,16 @@ struct ddsi_local_orphan_writer {
   struct ddsi_writer wr;
 };
 
+/* Cumulative time in ns spent between reception of a datagram by the kernel (or network
+   interface) and storing the samples in it in the reader history cache, split up into
+   the successive stages */
+struct ddsi_reader_rx_latency {
+  ddsrt_atomic_uint64_t samples; /* number of samples included */
+  ddsrt_atomic_uint64_t kernel_to_recv; /* kernel to processing by receive thread */
+  ddsrt_atomic_uint64_t recv_to_deliver; /* receive thread to delivery (via delivery queue) */
+  ddsrt_atomic_uint64_t deliver_to_store; /* delivery to stored in reader history cache */
+};
+
 struct ddsi_reader
 {
   struct ddsi_entity_common e;
@@ -158,6 +175,7 @@ struct ddsi_reader
   struct ddsi_networkpartition_address *mc_as;
 #endif
   const struct ddsi_sertype * type; /* type of the data read by this reader */
+  struct ddsi_content_filter_property *content_filter; /* content filter advertised in discovery, or NULL */
   uint32_t num_writers; /* total number of matching PROXY writers */
   ddsrt_avl_tree_t writers; /* all matching PROXY writers, see struct ddsi_rd_pwr_match */
   ddsrt_avl_tree_t local_writers; /* all matching LOCAL writers, see struct ddsi_rd_wr_match */
@@ -165,6 +183,7 @@ struct ddsi_reader
   struct ddsi_reader_sec_attributes *sec_attr;
 #endif
   ddsrt_atomic_uint64_t received_bytes; /* cum bytes received (excluding retransmits) */
+  struct ddsi_reader_rx_latency rx_latency; /* only updated if socket timestamps are enabled */
 };
 
 struct ddsi_generic_endpoint
@@ -225,11 +244,14 @@ struct ddsi_reader *ddsi_writer_next_in_sync_reader (struct ddsi_entity_index *e
 dds_return_t ddsi_generate_reader_guid (struct ddsi_guid *rdguid, struct ddsi_participant *participant, const struct ddsi_sertype *sertype);
 
 /** @component ddsi_endpoint */
-dds_return_t ddsi_new_reader (struct ddsi_reader **rd_out, const struct ddsi_guid *guid, const struct ddsi_guid *group_guid, struct ddsi_participant *pp, const char *topic_name, const struct ddsi_sertype *type, const struct dds_qos *xqos, struct ddsi_rhc *rhc, ddsi_status_cb_t status_cb, void * status_entity, struct ddsi_psmx_locators_set *psmx_locators);
+dds_return_t ddsi_new_reader (struct ddsi_reader **rd_out, const struct ddsi_guid *guid, const struct ddsi_guid *group_guid, struct ddsi_participant *pp, const char *topic_name, const struct ddsi_sertype *type, const struct dds_qos *xqos, struct ddsi_rhc *rhc, ddsi_status_cb_t status_cb, void * status_entity, struct ddsi_psmx_locators_set *psmx_locators, const struct ddsi_content_filter_property *content_filter);
 
 /** @component ddsi_endpoint */
 void ddsi_update_reader_qos (struct ddsi_reader *rd, const struct dds_qos *xqos);
 
+/** @component ddsi_endpoint */
+void ddsi_update_reader_content_filter (struct ddsi_reader *rd, const struct ddsi_content_filter_property *content_filter);
+
 /** @component ddsi_endpoint */
 dds_return_t ddsi_delete_reader (struct ddsi_domaingv *gv, const struct ddsi_guid *guid);
 
@@ -77,6 +77,35 @@ struct ddsi_freelist {
 
 #endif
 
+#if DDSI_FREELIST_TYPE != DDSI_FREELIST_NONE
+
+/* Each thread with a thread state caches a few elements of the last
+   couple of freelists it used, exchanging them with the freelist
+   itself in batches of half a cache.  Only the owning thread uses it
+   and it does so without locking: it marks the cache busy while using
+   it and destroying a freelist bumps a global generation counter and
+   waits for the caches that are busy.  An owner that finds the
+   generation changed catches up once the purge has completed. */
+#define DDSI_FREELIST_CACHE_NSLOTS 4
+#define DDSI_FREELIST_CACHE_SIZE 32
+
+struct ddsi_freelist_cache_slot {
+  struct ddsi_freelist *fl;
+  uint32_t count;
+  void *x[DDSI_FREELIST_CACHE_SIZE];
+};
+
+struct ddsi_freelist_cache {
+  ddsrt_atomic_uint32_t busy; /* set by the owner while it uses the cache */
+  uint32_t gen; /* last purge generation the owner caught up with */
+  uint32_t evict;
+  struct ddsi_freelist_cache_slot slots[DDSI_FREELIST_CACHE_NSLOTS];
+};
+
+#endif
+
+struct ddsi_thread_state;
+
 /** @component ddsi_freelist */
 void ddsi_freelist_init (struct ddsi_freelist *fl, uint32_t max, size_t linkoff);
 
@@ -92,6 +121,14 @@ void *ddsi_freelist_pushmany (struct ddsi_freelist *fl, void *first, void *last,
 /** @component ddsi_freelist */
 void *ddsi_freelist_pop (struct ddsi_freelist *fl);
 
+/**
+ * @component ddsi_freelist
+ * @brief Returns the elements cached by a thread to their freelists and frees the cache
+ *
+ * @param[in] thrst  thread state, its thread must no longer use any freelist
+ */
+void ddsi_freelist_thread_cache_release (struct ddsi_thread_state *thrst);
+
 #if defined (__cplusplus)
 }
 #endif
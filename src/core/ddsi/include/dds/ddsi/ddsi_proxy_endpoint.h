@@ -29,6 +29,7 @@ struct ddsi_writer;
 struct dds_qos;
 struct ddsi_addrset;
 struct ddsi_serdata;
+struct ddsi_content_filter_property;
 
 struct ddsi_proxy_endpoint_common
 {
@@ -100,6 +101,7 @@ struct ddsi_proxy_reader {
   ddsrt_avl_tree_t writers; /* matching LOCAL writers */
   uint32_t receive_buffer_size; /* assumed receive buffer size inherited from proxypp */
   ddsi_filter_fn_t filter;
+  struct ddsi_content_filter_property *content_filter; /* content filter advertised by the reader, or NULL */
 };
 
 
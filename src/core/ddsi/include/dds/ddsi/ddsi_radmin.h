@@ -128,6 +128,29 @@ struct ddsi_rdata {
 #define DDSI_RDATA_SUBMSG_OFF(rdata) DDSI_ZOFF_TO_OFF ((rdata)->submsg_zoff)
 #define DDSI_RDATA_KEYHASH_OFF(rdata) DDSI_ZOFF_TO_OFF ((rdata)->keyhash_zoff)
 
+/**
+ * @brief Keep a received message alive so a sample in it can be used in place
+ * @component receive_buffers
+ *
+ * Used for constructing a serdata that references the payload in the receive buffer
+ * instead of copying it. This is only allowed for samples of at least the configured
+ * threshold size and as long as the total size of the receive buffers kept alive by
+ * pinned messages stays within the configured limit for the receive buffer pool.
+ *
+ * @param[in] rmsg message containing the sample, the caller must hold a reference to it
+ * @param[in] size size of the sample
+ * @returns true if the message was pinned, false if the sample must be copied
+ */
+bool ddsi_rmsg_pin (struct ddsi_rmsg *rmsg, uint32_t size);
+
+/**
+ * @brief Undo a successful @ref ddsi_rmsg_pin
+ * @component receive_buffers
+ *
+ * @param[in] rmsg message that was pinned
+ */
+void ddsi_rmsg_unpin (struct ddsi_rmsg *rmsg);
+
 #if defined (__cplusplus)
 }
 #endif
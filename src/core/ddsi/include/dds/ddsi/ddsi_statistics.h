@@ -23,9 +23,18 @@ struct ddsi_writer;
 /** @component ddsi_statistics */
 void ddsi_get_writer_stats (struct ddsi_writer *wr, uint64_t *rexmit_bytes, uint32_t *throttle_count, uint64_t *time_throttled, uint64_t *time_retransmit);
 
+/** @component ddsi_statistics */
+void ddsi_get_writer_whc_stats (struct ddsi_writer *wr, uint64_t *unacked_bytes, uint64_t *domain_unacked_bytes);
+
+/** @component ddsi_statistics */
+void ddsi_get_writer_replay_stats (struct ddsi_writer *wr, uint64_t *replay_bytes, uint32_t *readers_replaying);
+
 /** @component ddsi_statistics */
 void ddsi_get_reader_stats (struct ddsi_reader *rd, uint64_t *discarded_bytes);
 
+/** @component ddsi_statistics */
+void ddsi_get_reader_rx_latency_stats (struct ddsi_reader *rd, uint64_t *samples, uint64_t *kernel_to_recv, uint64_t *recv_to_deliver, uint64_t *deliver_to_store);
+
 #if defined (__cplusplus)
 }
 #endif
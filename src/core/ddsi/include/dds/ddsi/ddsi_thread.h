@@ -95,6 +95,7 @@ void ddsi_thread_vtime_trace (struct ddsi_thread_state *thrst);
   ddsrt_thread_t tid;                           \
   uint32_t (*f) (void *arg);                    \
   void *f_arg;                                  \
+  ddsrt_atomic_voidp_t freelist_cache;          \
   THREAD_BASE_DEBUG /* note: no semicolon! */   \
   char name[24] /* note: no semicolon! */
 
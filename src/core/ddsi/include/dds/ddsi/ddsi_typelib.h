@@ -118,6 +118,24 @@ struct ddsi_domaingv *ddsi_type_get_gv (const struct ddsi_type *type);
 /** @component type_system */
 DDS_XTypes_TypeKind ddsi_type_get_kind (const struct ddsi_type *type);
 
+/**
+ * @brief Looks up a (nested) member of a struct type by name
+ * @component type_system
+ *
+ * @param[in] type      complete type, must be a struct
+ * @param[in] name      member name, with "." separating the names of nested members
+ * @param[in] maxdepth  maximum nesting depth
+ * @param[out] indices  position of the member in each of the enclosing structs, with the
+ *                      members of base types counted first
+ * @param[out] depth    number of entries in indices
+ * @returns a dds_return_t indicating success or failure
+ *
+ * @retval DDS_RETCODE_OK  found
+ * @retval DDS_RETCODE_BAD_PARAMETER  not a complete struct type, or no such member
+ * @retval DDS_RETCODE_UNSUPPORTED  nested deeper than maxdepth
+ */
+dds_return_t ddsi_type_get_member_path (const struct ddsi_type *type, const char *name, uint32_t maxdepth, uint32_t *indices, uint32_t *depth);
+
 
 #ifdef DDS_HAS_TYPELIB
 
@@ -22,6 +22,7 @@ struct ddsi_serdata;
 struct ddsi_plist;
 struct ddsi_tkmap_instance;
 struct ddsi_whc;
+struct ddsi_domaingv;
 
 /**
  * @brief Base type for whc node
@@ -36,6 +37,8 @@ struct ddsi_whc_borrowed_sample {
   bool unacked;
   ddsrt_mtime_t last_rexmit_ts;
   unsigned rexmit_count;
+  uint64_t filter_rejects; /* content filters of the writer rejecting this sample, see ddsi_whc_insert_t */
+  bool filter_rejects_valid; /* false if the WHC doesn't have filter_rejects */
 };
 
 struct ddsi_whc_state {
@@ -64,6 +67,10 @@ struct ddsi_whc_sample_iter {
   } opaque;
 };
 
+/* A sample can only be borrowed by one party at a time, implementations assert this.  The
+   WHC doesn't enforce it: all borrowing of a writer's samples is done while holding that
+   writer's lock (wr->e.lock), and the WHC's own lock is only held for the duration of each
+   operation. */
 typedef ddsi_seqno_t (*ddsi_whc_next_seq_t)(const struct ddsi_whc *whc, ddsi_seqno_t seq);
 typedef void (*ddsi_whc_get_state_t)(const struct ddsi_whc *whc, struct ddsi_whc_state *st);
 typedef bool (*ddsi_whc_borrow_sample_t)(const struct ddsi_whc *whc, ddsi_seqno_t seq, struct ddsi_whc_borrowed_sample *sample);
@@ -77,7 +84,11 @@ typedef void (*whc_free_t)(struct ddsi_whc *whc);
    reliable readers that have not acknowledged all data */
 /* max_drop_seq must go soon, it's way too ugly. */
 /* plist may be NULL or ddsrt_malloc'd, WHC takes ownership of plist */
-typedef int (*ddsi_whc_insert_t)(struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk);
+/* filter_rejects is a bitmask of the content filter slots of the writer that reject the
+   sample, stored so retransmits needn't evaluate the filters again; it is returned as-is
+   in borrowed samples with filter_rejects_valid set, or with filter_rejects_valid cleared
+   if the WHC doesn't keep it */
+typedef int (*ddsi_whc_insert_t)(struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects);
 typedef uint32_t (*ddsi_whc_remove_acked_messages_t)(struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, struct ddsi_whc_state *whcst, struct ddsi_whc_node **deferred_free_list);
 typedef void (*ddsi_whc_free_deferred_free_list_t)(struct ddsi_whc *whc, struct ddsi_whc_node *deferred_free_list);
 
@@ -99,6 +110,19 @@ struct ddsi_whc {
   const struct ddsi_whc_ops *ops;
 };
 
+/**
+ * @brief Updates the domain-wide accounting of unacknowledged bytes in WHCs
+ * @component whc
+ *
+ * WHC implementations call this whenever the amount of unacknowledged data they hold
+ * changes, including dropping it to 0 when the WHC is freed.
+ *
+ * @param[in] gv  domain globals
+ * @param[in] old_unacked_bytes  previous number of unacknowledged bytes in the WHC
+ * @param[in] new_unacked_bytes  new number of unacknowledged bytes in the WHC
+ */
+void ddsi_whc_account_unacked_bytes (struct ddsi_domaingv *gv, size_t old_unacked_bytes, size_t new_unacked_bytes);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -62,6 +62,42 @@ inline void ddsi_bitset_one (uint32_t numbits, uint32_t *bits)
   }
 }
 
+/** @component bitset
+ * @brief Mask for bits [lo,hi) of a word, 0 <= lo <= hi <= 32, in the bit order of the bitset */
+inline uint32_t ddsi_bitset_word_mask (uint32_t lo, uint32_t hi)
+{
+  assert (lo <= hi && hi <= 32);
+  return (lo == hi) ? 0 : ((~UINT32_C(0) >> lo) & ~(hi == 32 ? 0 : (~UINT32_C(0) >> hi)));
+}
+
+/** @component bitset
+ * @brief Sets bits [from,to) a word at a time */
+inline void ddsi_bitset_set_range (UNUSED_ARG_NDEBUG (uint32_t numbits), uint32_t *bits, uint32_t from, uint32_t to)
+{
+  assert (from <= to && to <= numbits);
+  while (from < to)
+  {
+    const uint32_t k = from / 32;
+    const uint32_t hi = (to - 32 * k > 32) ? 32 : to - 32 * k;
+    bits[k] |= ddsi_bitset_word_mask (from % 32, hi);
+    from = 32 * k + hi;
+  }
+}
+
+/** @component bitset
+ * @brief Clears bits [from,to) a word at a time */
+inline void ddsi_bitset_clear_range (UNUSED_ARG_NDEBUG (uint32_t numbits), uint32_t *bits, uint32_t from, uint32_t to)
+{
+  assert (from <= to && to <= numbits);
+  while (from < to)
+  {
+    const uint32_t k = from / 32;
+    const uint32_t hi = (to - 32 * k > 32) ? 32 : to - 32 * k;
+    bits[k] &= ~ddsi_bitset_word_mask (from % 32, hi);
+    from = 32 * k + hi;
+  }
+}
+
 #if defined (__cplusplus)
 }
 #endif
@@ -435,18 +435,23 @@ static struct cfgelem general_cfgelems[] = {
     FUNCTIONS(0, uf_transport_selector, 0, pf_transport_selector),
     DESCRIPTION(
       "<p>This element allows selecting the transport to be used (udp, udp6, "
-      "tcp, tcp6, raweth, fakeudp). The fakeudp transport is available only "
-      "when built with ENABLE_FAKEUDP and uses a built-in deterministic fake "
-      "network by default. It may also be written as fakeudp:<i>file</i> to "
-      "load the fake network topology from an XML file, or as fakeudp:real to "
-      "import the real interface list into the fake network.</p>")),
+      "udp-uring, udp6-uring, tcp, tcp6, raweth, fakeudp). The udp-uring and "
+      "udp6-uring variants of udp and udp6 use io_uring for receiving and "
+      "sending data and are only available on Linux. The fakeudp transport is "
+      "available only when built with ENABLE_FAKEUDP and uses a built-in "
+      "deterministic fake network by default. It may also be written as "
+      "fakeudp:<i>file</i> to load the fake network topology from an XML file, "
+      "or as fakeudp:real to import the real interface list into the fake "
+      "network.</p>")),
 #else
   STRING("Transport", NULL, 1, "default",
     MEMBER(transport_selector),
     FUNCTIONS(0, uf_transport_selector, 0, pf_transport_selector),
     DESCRIPTION(
       "<p>This element allows selecting the transport to be used (udp, udp6, "
-      "tcp, tcp6, raweth).</p>")),
+      "udp-uring, udp6-uring, tcp, tcp6, raweth). The udp-uring and udp6-uring "
+      "variants of udp and udp6 use io_uring for receiving and sending data "
+      "and are only available on Linux.</p>")),
 #endif
 #else
 #ifdef DDS_HAS_FAKEUDP
@@ -455,18 +460,22 @@ static struct cfgelem general_cfgelems[] = {
     FUNCTIONS(0, uf_transport_selector, 0, pf_transport_selector),
     DESCRIPTION(
       "<p>This element allows selecting the transport to be used (udp, udp6, "
-      "raweth, fakeudp). The fakeudp transport is available only when built "
-      "with ENABLE_FAKEUDP and uses a built-in deterministic fake network by "
-      "default. It may also be written as fakeudp:<i>file</i> to load the fake "
-      "network topology from an XML file, or as fakeudp:real to import the "
-      "real interface list into the fake network.</p>")),
+      "udp-uring, udp6-uring, raweth, fakeudp). The udp-uring and udp6-uring "
+      "variants of udp and udp6 use io_uring for receiving and sending data "
+      "and are only available on Linux. The fakeudp transport is available "
+      "only when built with ENABLE_FAKEUDP and uses a built-in deterministic "
+      "fake network by default. It may also be written as fakeudp:<i>file</i> "
+      "to load the fake network topology from an XML file, or as fakeudp:real "
+      "to import the real interface list into the fake network.</p>")),
 #else
   STRING("Transport", NULL, 1, "default",
     MEMBER(transport_selector),
     FUNCTIONS(0, uf_transport_selector, 0, pf_transport_selector),
     DESCRIPTION(
       "<p>This element allows selecting the transport to be used (udp, udp6, "
-      "raweth).</p>")),
+      "udp-uring, udp6-uring, raweth). The udp-uring and udp6-uring variants "
+      "of udp and udp6 use io_uring for receiving and sending data and are "
+      "only available on Linux.</p>")),
 #endif
 #endif
   BOOL("EnableMulticastLoopback", NULL, 1, "true",
@@ -515,6 +524,56 @@ static struct cfgelem general_cfgelems[] = {
       "fragments of which the size is at least the minimum of 1025 and "
       "FragmentSize.</p>"),
     UNIT("memsize")),
+  BOOL("UDPSegmentationOffload", NULL, 1, "false",
+    MEMBER(udp_segmentation_offload),
+    FUNCTIONS(0, uf_boolean, 0, pf_boolean),
+    DESCRIPTION(
+      "<p>This element enables the use of UDP segmentation offload on "
+      "platforms that support it (Linux UDP_SEGMENT and UDP_GRO). When "
+      "enabled, multiple consecutive RTPS messages for the same destinations "
+      "are combined into a single send operation of up to 64kB, in which all "
+      "but the last message are padded to exactly MaxMessageSize (rounded "
+      "down to a multiple of 4) and then split into individual datagrams by "
+      "the kernel or the network interface. On reception, the kernel may "
+      "likewise coalesce such datagrams into a single buffer.</p>\n"
+      "<p>This reduces the per-datagram processing cost for large, fragmented "
+      "samples. MaxMessageSize must be set such that the datagrams fit in the "
+      "MTU of the network for this to be effective, e.g., 1456 B for "
+      "FragmentSize at its default value. Coalescing on reception is not used "
+      "when DDS Security is configured.</p>")),
+  STRING("ZeroCopySendThreshold", NULL, 1, "0 B",
+    MEMBER(zerocopy_send_threshold),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element sets the serialised size from which on the data of a "
+      "sample is transmitted without copying it into the kernel, on "
+      "platforms that support it (Linux MSG_ZEROCOPY). The sample is then "
+      "kept in memory until the kernel reports that it is done with it, "
+      "which happens in the background, and the messages containing it are "
+      "sent to each destination individually. A value of 0 disables it.</p>\n"
+      "<p>The pinning of memory and the completion notifications have a "
+      "cost of their own, so this only pays off for large samples, "
+      "typically of tens of kilobytes or more. It is currently only "
+      "supported for UDP, and not used for messages that are protected by "
+      "DDS Security, combined using UDPSegmentationOffload, or for the "
+      "io_uring variants of the transport.</p>"),
+    UNIT("memsize")),
+  STRING("ZeroCopyReceiveThreshold", NULL, 1, "0 B",
+    MEMBER(zerocopy_receive_threshold),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element sets the serialised size from which on received "
+      "samples reference the data in the receive buffer instead of copying "
+      "it. This is only done for samples that were received in a single "
+      "fragment (see General/FragmentSize) or were reassembled in a buffer "
+      "of their own (see Internal/DefragContiguousThreshold), and in the "
+      "native byte order. A value of 0 disables it.</p>\n"
+      "<p>A sample referencing the receive buffer keeps the message it was "
+      "received in, and with it the entire receive buffer (see "
+      "Sizing/ReceiveBufferSize), alive until the sample is freed. The number "
+      "of receive buffers that can be kept alive this way is limited by "
+      "Sizing/ZeroCopyReceiveLimit; beyond that, samples are copied.</p>"),
+    UNIT("memsize")),
   BOOL("RedundantNetworking", NULL, 1, "false",
     MEMBER(redundant_networking),
     FUNCTIONS(0, uf_boolean, 0, pf_boolean),
@@ -1028,8 +1087,13 @@ static struct cfgelem thread_properties_cfgattrs[] = {
       "<li><i>recv</i>: "
       "receive thread, taking data from the network and running the protocol "
       "state machine;</li>\n"
+      "<li><i>recvMC</i>, <i>recvUC</i>, <i>recvUC1</i> .. <i>recvUC7</i>: "
+      "additional receive threads for multicast and unicast data, see "
+      "Internal/MultipleReceiveThreads;</li>\n"
       "<li><i>dq.builtins</i>: "
       "delivery thread for DDSI-builtin data, primarily for discovery;</li>\n"
+      "<li><i>dq.user</i>, <i>dq.user1</i> .. <i>dq.user7</i>: "
+      "delivery threads for application data, see Internal/DeliveryQueues;</li>\n"
       "<li><i>lease</i>: "
       "DDSI liveliness monitoring;</li>\n"
       "<li><i>tev</i>: "
@@ -1061,6 +1125,30 @@ static struct cfgelem thread_properties_cfgelems[] = {
       "default value <i>default</i> leaves the stack size at the operating "
       "system default.</p>"),
     UNIT("maybe_memsize")),
+  STRING("SpinDuration", NULL, 1, "0 s",
+    MEMBEROF(ddsi_config_thread_properties_listelem, spin_duration),
+    FUNCTIONS(0, uf_duration_us_1s, 0, pf_duration),
+    DESCRIPTION(
+      "<p>This element sets how long a receive thread (<i>recv</i>, "
+      "<i>recvMC</i>, <i>recvUC</i>, <i>recvUC1</i>, ...) keeps checking "
+      "its sockets for new data without blocking after it has received "
+      "data, before it blocks in the operating system again. This trades "
+      "a CPU core per receive thread for not having to wait for the thread "
+      "to be woken up when data arrives. The default of 0 means it always "
+      "blocks. Not supported for the io_uring variants of the UDP "
+      "transport.</p>"),
+    UNIT("duration")),
+  STRING("SocketBusyPoll", NULL, 1, "0 s",
+    MEMBEROF(ddsi_config_thread_properties_listelem, socket_busy_poll),
+    FUNCTIONS(0, uf_duration_us_1s, 0, pf_duration),
+    DESCRIPTION(
+      "<p>This element sets the time the kernel busy-polls the network "
+      "device when a receive thread blocks on a socket without data "
+      "(Linux SO_BUSY_POLL, in microsecond resolution), for the sockets the "
+      "receive thread handles at startup. The default of 0 leaves it at "
+      "the system default (net.core.busy_read). Setting it above that "
+      "typically requires special privileges.</p>"),
+    UNIT("duration")),
   END_MARKER
 };
 
@@ -1223,6 +1311,17 @@ static struct cfgelem internal_watermarks_cfgelems[] = {
       "<p>This element sets the initial level of the high-water mark for the "
       "Cyclone DDS WHCs, expressed in bytes.</p>"),
     UNIT("maybe_memsize")),
+  STRING("WhcBudget", NULL, 1, "0 B",
+    MEMBER(whc_budget),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element sets a domain-wide limit on the amount of unacknowledged "
+      "data in all Cyclone DDS WHCs together, expressed in bytes. When it is "
+      "exceeded, writers holding more than an equal share of it are suspended "
+      "as if they had reached their high-water mark, starting with those holding "
+      "the most data. KEEP_LAST writers are never suspended. 0 means "
+      "unlimited.</p>"),
+    UNIT("memsize")),
   BOOL("WhcAdaptive|WhcAdaptative", NULL, 1, "true",
     MEMBER(whc_adaptive),
     FUNCTIONS(0, uf_boolean, 0, pf_boolean),
@@ -1260,6 +1359,17 @@ static struct cfgelem internal_burstsize_cfgelems[] = {
       "<p>This element controls the maximum number of fragments of a sample that "
       "are retransmit in response to a NACK of the entire sample (as opposed to "
       "what is sent in response to a NACKFRAG requesting specific fragments).</p>")),
+  STRING("HistoryReplay", NULL, 1, "0 B",
+    MEMBER(history_replay_burst_size),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element specifies the amount of historical data that is sent in "
+      "one batch to a newly matched reliable transient-local reader, without "
+      "waiting for it to request the data. The batches are spaced by "
+      "Internal/HistoryReplayInterval and don't count towards the retransmit "
+      "limits. 0 disables this and leaves it to the retransmit requests of the "
+      "reader.</p>"),
+    UNIT("memsize")),
   END_MARKER
 };
 
@@ -1367,6 +1477,30 @@ static struct cfgelem multiple_recv_threads_attrs[] = {
       "but to eliminate all risks, it will retry as many times as specified "
       "by this attribute before aborting.</p>"
     )),
+  INT("unicastsockets", NULL, 1, "1",
+    MEMBER(recv_uc_sockets),
+    FUNCTIONS(0, uf_recv_uc_sockets, 0, pf_int),
+    DESCRIPTION(
+      "<p>This attribute sets the number of sockets bound to the unicast data "
+      "port using SO_REUSEPORT, each served by its own receive thread with its "
+      "own receive buffer pool, so that the processing of unicast data "
+      "received from many peers can be spread over multiple cores. The kernel "
+      "distributes the datagrams over the sockets. It only applies if a "
+      "separate thread is used for the unicast data port, that is, if "
+      "ManySocketsMode is \"single\" and the transport is UDP, and is "
+      "currently only supported on Linux.</p>"
+    ),
+    RANGE("1;8")),
+  BOOL("steerbysource", NULL, 1, "false",
+    MEMBER(recv_uc_steer_by_source),
+    FUNCTIONS(0, uf_boolean, 0, pf_boolean),
+    DESCRIPTION(
+      "<p>This attribute enables a socket filter that makes the kernel select "
+      "the unicast data socket by hashing the source IP address instead of "
+      "the default hash over source and destination address and port, so "
+      "that all traffic from a given host is handled by the same receive "
+      "thread. It only has an effect if unicastsockets is greater than 1.</p>"
+    )),
   END_MARKER
 };
 
@@ -1425,6 +1559,29 @@ static struct cfgelem internal_cfgelems[] = {
       "expressed in samples. Once a delivery queue is full, incoming samples "
       "destined for that queue are dropped until space becomes available "
       "again.</p>")),
+  INT("DeliveryQueues", NULL, 1, "1",
+    MEMBER(delivery_queues),
+    FUNCTIONS(0, uf_delivery_queues, 0, pf_int),
+    DESCRIPTION(
+      "<p>This element sets the number of delivery queues, each with its own "
+      "delivery thread (<i>dq.user</i>, <i>dq.user1</i>, ...), used for "
+      "asynchronously delivering application data. Each remote writer is "
+      "assigned to one of them based on its GUID, so that the data of any "
+      "one writer is still delivered in order while the delivery of data "
+      "from different writers can be spread over multiple cores.</p>")),
+  INT("ReaderHistoryShards", NULL, 1, "1",
+    MEMBER(reader_history_shards),
+    FUNCTIONS(0, uf_reader_history_shards, 0, pf_int),
+    DESCRIPTION(
+      "<p>This element sets the number of shards the instances in the history "
+      "of a reader are spread over, each with its own lock, so that storing "
+      "data in one instance and reading or taking data from another rarely "
+      "have to wait for each other. It only applies to readers of keyed "
+      "topics without limits on the total number of samples and instances "
+      "in the resource limits QoS. With multiple shards, reading or taking "
+      "from all instances returns the instances grouped by shard instead of "
+      "in the order in which they received data, and reading or taking the "
+      "next instance involves all shards.</p>")),
   INT("PrimaryReorderMaxSamples", NULL, 1, "128",
     MEMBER(primary_reorder_maxsamples),
     FUNCTIONS(0, uf_uint, 0, pf_uint),
@@ -1456,6 +1613,18 @@ static struct cfgelem internal_cfgelems[] = {
       "defragmented simultaneously for a reliable writer. This has to be "
       "large enough to handle retransmissions of historical data in addition "
       "to new samples.</p>")),
+  STRING("DefragContiguousThreshold", NULL, 1, "0 B",
+    MEMBER(defrag_contiguous_threshold),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element sets the sample size from which on fragmented samples "
+      "are reassembled in a buffer of their own, instead of keeping all "
+      "received fragments in the receive buffers until the sample is "
+      "complete. The fragments are copied into this buffer as they arrive, "
+      "so that the receive buffers they were received in can be reused "
+      "immediately. It is only done if the first fragment of the sample is "
+      "received before any of the others. A value of 0 disables it.</p>"),
+    UNIT("memsize")),
   ENUM("BuiltinEndpointSet", NULL, 1, "writers",
     MEMBER(besmode),
     FUNCTIONS(0, uf_besmode, 0, pf_besmode),
@@ -1574,6 +1743,24 @@ static struct cfgelem internal_cfgelems[] = {
       "deletion of a reliable writer with unacknowledged data in its history "
       "will be postponed to provide proper reliable transmission.<p>"),
     UNIT("duration")),
+  STRING("HistoryReplayInterval", NULL, 1, "1 ms",
+    MEMBER(history_replay_interval),
+    FUNCTIONS(0, uf_duration_us_1s, 0, pf_duration),
+    DESCRIPTION(
+      "<p>This element specifies the interval between successive batches of "
+      "historical data sent to a newly matched reader, see "
+      "Internal/BurstSize/HistoryReplay.</p>"),
+    UNIT("duration")),
+  STRING("TransientLocalStoreDirectory", NULL, 1, "",
+    MEMBER(tl_store_directory),
+    FUNCTIONS(0, uf_string, ff_free, pf_string),
+    DESCRIPTION(
+      "<p>This element specifies a directory in which the history of "
+      "transient-local writers is kept in memory-mapped files instead of in "
+      "memory. The files are named after the topic, and a writer that finds a "
+      "file left behind by a previous incarnation publishes its contents again "
+      "when it is created, with the lifespan starting anew. Only one writer "
+      "at a time can use a file. An empty string disables this.</p>")),
   MOVED("MinimumSocketReceiveBufferSize", "CycloneDDS/Domain/Internal/SocketReceiveBufferSize[@min]"),
   MOVED("MinimumSocketSendBufferSize", "CycloneDDS/Domain/Internal/SocketSendBufferSize[@min]"),
   GROUP("SocketReceiveBufferSize", NULL, sock_rcvbuf_size_attrs, 1,
@@ -1772,6 +1959,38 @@ static struct cfgelem internal_cfgelems[] = {
     "transport (e.g., UDP) and ManySocketsMode not set to single (the "
     "default).</p>"),
     VALUES("false","true","default")),
+  INT("ReceiveBatchSize", NULL, 1, "8",
+    MEMBER(recv_batch_size),
+    FUNCTIONS(0, uf_recv_batch_size, 0, pf_int),
+    DESCRIPTION(
+      "<p>This element sets the maximum number of datagrams a receive thread "
+      "reads from a socket in a single operation, using recvmmsg where the "
+      "platform supports it. The datagrams are stored in consecutive "
+      "allocations in the receive buffer and processed in order. Setting it "
+      "to 1 reads one datagram at a time. Stream-oriented transports (e.g., "
+      "TCP) always read one message at a time.</p>"),
+    RANGE("1;16")),
+  ENUM("SocketTimestamps", NULL, 1, "none",
+    MEMBER(socket_timestamps),
+    FUNCTIONS(0, uf_socket_timestamps, 0, pf_socket_timestamps),
+    DESCRIPTION(
+      "<p>This element controls whether the kernel is asked to record the "
+      "time at which datagrams were received (Linux SO_TIMESTAMPING), for "
+      "measuring where the time goes between the network and the reader "
+      "history cache. Possible values are:</p>\n"
+      "<ul><li><i>none</i>: no timestamps are requested;</li>\n"
+      "<li><i>software</i>: the kernel timestamps datagrams when they "
+      "enter the network stack;</li>\n"
+      "<li><i>hardware</i>: the network interface timestamps datagrams, "
+      "falling back to software timestamps if it does not provide them. "
+      "Hardware timestamping must be enabled on the interface separately "
+      "and its clock synchronised with the system clock.</li></ul>\n"
+      "<p>The time spent between reception by the kernel, processing by the "
+      "receive thread, processing by the delivery queue and storing the "
+      "sample in the reader history cache is then accumulated in the "
+      "rx_latency statistics of the readers. It is currently only supported "
+      "for UDP.</p>"),
+    VALUES("none","software","hardware")),
   GROUP("ControlTopic", control_topic_cfgelems, control_topic_cfgattrs, 1,
     NOMEMBER,
     NOFUNCTIONS,
@@ -1835,6 +2054,41 @@ static struct cfgelem sizing_cfgelems[] = {
       "shrunk immediately after processing a message or freed "
       "straightaway.</p>"),
     UNIT("memsize")),
+  STRING("ReceiveBufferPoolSize", NULL, 1, "0 B",
+    MEMBER(rbufpool_size),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element sets the size of a memory region reserved for each "
+      "receive thread from which its receive buffers are carved. Receive "
+      "buffers that are released are recycled within the region, and only "
+      "when the region is exhausted are receive buffers allocated from the "
+      "heap. The pages of the region are first touched by the receive thread "
+      "itself, so that on a NUMA system they end up on the node of the CPU "
+      "the thread runs on (see also Threads/Thread/Affinity). The default of "
+      "0 disables the region.</p>"),
+    UNIT("memsize")),
+  STRING("ZeroCopyReceiveLimit", NULL, 1, "16 MiB",
+    MEMBER(zerocopy_receive_limit),
+    FUNCTIONS(0, uf_memsize, 0, pf_memsize),
+    DESCRIPTION(
+      "<p>This element sets the maximum total size of the receive buffers per "
+      "receive thread that may be kept alive by samples referencing them "
+      "instead of being copied (see General/ZeroCopyReceiveThreshold). Each "
+      "receive buffer containing at least one such sample counts in full "
+      "(see Sizing/ReceiveBufferSize), so the default allows 16 receive "
+      "buffers of the default size to be kept alive. It prevents readers that "
+      "hold on to samples for a long time from tying up an unbounded number "
+      "of receive buffers.</p>"),
+    UNIT("memsize")),
+  BOOL("ReceiveBufferHugePages", NULL, 1, "false",
+    MEMBER(rbufpool_hugepages),
+    FUNCTIONS(0, uf_boolean, 0, pf_boolean),
+    DESCRIPTION(
+      "<p>This element enables backing the region configured with "
+      "Sizing/ReceiveBufferPoolSize with huge pages, to reduce TLB misses. "
+      "Explicitly reserved huge pages are used if available, otherwise "
+      "transparent huge pages are requested. It is only supported on Linux "
+      "and ignored elsewhere.</p>")),
   END_MARKER
 };
 
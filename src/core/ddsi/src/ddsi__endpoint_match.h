@@ -31,6 +31,9 @@ struct ddsi_proxy_writer;
 struct ddsi_proxy_reader;
 struct ddsi_alive_state;
 struct ddsi_generic_proxy_endpoint;
+struct ddsi_content_filter;
+struct ddsi_content_filter_property;
+struct ddsi_whc_borrowed_sample;
 
 struct ddsi_bestab {
   unsigned besflag;
@@ -95,10 +98,13 @@ struct ddsi_wr_prd_match {
   unsigned all_have_replied_to_hb: 1; /* true iff 'has_replied_to_hb' for all readers in subtree */
   unsigned is_reliable: 1; /* true iff reliable proxy reader */
   unsigned via_psmx: 1; /* true iff there is a common psmx locator */
+  unsigned replay_scheduled: 1; /* true iff the history replay has been started */
   ddsi_seqno_t min_seq; /* smallest ack'd seq nr in subtree */
   ddsi_seqno_t max_seq; /* sort-of highest ack'd seq nr in subtree (see augment function) */
   ddsi_seqno_t seq; /* highest acknowledged seq nr */
   ddsi_seqno_t last_seq; /* highest seq send to this reader used when filter is applied */
+  ddsi_seqno_t replay_seq; /* next seq of the history to send to this reader, 0 if not replaying */
+  ddsi_seqno_t replay_end; /* last seq of the history to send to this reader */
   uint32_t num_reliable_readers_where_seq_equals_max;
   ddsi_guid_t arbitrary_unacked_reader;
   ddsi_count_t prev_acknack; /* latest accepted acknack sequence number */
@@ -109,11 +115,24 @@ struct ddsi_wr_prd_match {
   ddsrt_wctime_t hb_to_ack_latency_tlastlog;
   uint32_t non_responsive_count;
   uint32_t rexmit_requests;
+  int32_t content_filter_slot; /* index in the writer's content_filters, or -1 if not filtered */
 #ifdef DDS_HAS_SECURITY
   int64_t crypto_handle;
 #endif
 };
 
+/* Maximum number of distinct content filters a writer evaluates, the results for a sample
+   are stored as a bitmask in the WHC; readers with other filters are sent all data */
+#define DDSI_WRITER_MAX_CONTENT_FILTERS 64
+
+/* Content filter shared by all matched proxy readers with an equal filter property */
+struct ddsi_writer_content_filter {
+  struct ddsi_content_filter_property *prop; /* NULL iff slot not in use */
+  struct ddsi_content_filter *filter;
+  uint32_t refc; /* number of proxy readers using this filter */
+  ddsi_seqno_t valid_from; /* the WHC has the results of this filter from this sequence number onwards */
+};
+
 struct ddsi_prd_wr_match {
   ddsrt_avl_node_t avlnode;
   ddsi_guid_t wr_guid;
@@ -200,6 +219,9 @@ void ddsi_free_wr_rd_match (struct ddsi_wr_rd_match *m);
 /** @component endpoint_matching */
 void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reader *prd, int64_t crypto_handle);
 
+/** @component endpoint_matching */
+void ddsi_writer_update_content_filter (struct ddsi_writer *wr, const struct ddsi_proxy_reader *prd, const struct ddsi_content_filter_property *content_filter);
+
 /** @component endpoint_matching */
 void ddsi_writer_add_local_connection (struct ddsi_writer *wr, struct ddsi_reader *rd);
 
@@ -215,6 +237,70 @@ void ddsi_proxy_writer_add_connection (struct ddsi_proxy_writer *pwr, struct dds
 /** @component endpoint_matching */
 void ddsi_proxy_reader_add_connection (struct ddsi_proxy_reader *prd, struct ddsi_writer *wr, int64_t crypto_handle);
 
+/**
+ * @component endpoint_matching
+ * @brief Whether proxy readers may be in the same DDSI instance
+ *
+ * The readers in a DDSI instance may share the reordering of the data of a writer, so
+ * that a GAP addressed to one of them applies to all of them. Cyclone uses a random first
+ * word in the GUID prefixes of all participants in an instance, other implementations
+ * typically something derived from the host, and so grouping on it is conservative.
+ *
+ * @param[in] a  GUID of a proxy reader
+ * @param[in] b  GUID of another proxy reader
+ * @returns true if the readers may be in the same DDSI instance
+ */
+inline bool ddsi_proxy_readers_may_share_instance (const ddsi_guid_t *a, const ddsi_guid_t *b) {
+  return a->prefix.u[0] == b->prefix.u[0];
+}
+
+/**
+ * @component endpoint_matching
+ * @brief Evaluates the content filters of the matched proxy readers on a new sample
+ *
+ * Each distinct filter is evaluated once, for data only: invalid samples are never
+ * filtered. Writer must be locked.
+ *
+ * @param[in] wr  the writer
+ * @param[in] serdata  the sample
+ * @returns bitmask of the content filter slots that reject the sample
+ */
+uint64_t ddsi_writer_content_filters_eval (const struct ddsi_writer *wr, const struct ddsi_serdata *serdata);
+
+/**
+ * @component endpoint_matching
+ * @brief Determines whether a proxy reader may be sent a GAP instead of a sample in the WHC
+ *
+ * For a Cyclone reader, that requires the content filters of all matched readers that may
+ * be in the same DDSI instance as the reader to reject the sample (see @ref
+ * ddsi_proxy_readers_may_share_instance), for others only its own filter. Uses the results stored in the WHC, evaluating a
+ * filter only if the sample was written before the filter was known to the writer or if
+ * the WHC doesn't keep the results. Writer must be locked.
+ *
+ * @param[in] wr  the writer
+ * @param[in] prd  the proxy reader
+ * @param[in] m  the match object of the proxy reader
+ * @param[in] sample  the sample borrowed from the WHC of the writer
+ * @returns true iff the sample need not be sent to the proxy reader
+ */
+bool ddsi_writer_content_filter_rejects (const struct ddsi_writer *wr, const struct ddsi_proxy_reader *prd, const struct ddsi_wr_prd_match *m, const struct ddsi_whc_borrowed_sample *sample);
+
+/**
+ * @component endpoint_matching
+ * @brief Determines whether none of the content filters of a writer rejects a sample in the WHC
+ *
+ * Retransmits may only be merged if this is the case. Uses the results stored in the WHC
+ * where possible, like @ref ddsi_writer_content_filter_rejects. Writer must be locked.
+ *
+ * @param[in] wr  the writer
+ * @param[in] sample  the sample borrowed from the WHC of the writer
+ * @returns true iff all matched proxy readers accept the sample
+ */
+bool ddsi_writer_content_filters_accept_all (const struct ddsi_writer *wr, const struct ddsi_whc_borrowed_sample *sample);
+
+/** @component endpoint_matching */
+void ddsi_writer_content_filters_fini (struct ddsi_writer *wr);
+
 /** @component endpoint_matching */
 void ddsi_writer_drop_connection (const struct ddsi_guid *wr_guid, const struct ddsi_proxy_reader *prd);
 
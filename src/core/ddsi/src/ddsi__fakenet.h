@@ -63,9 +63,19 @@ dds_return_t ddsi_fakenet_getsockname (ddsrt_socket_t sock, struct sockaddr *add
 /** @component fake_network */
 dds_return_t ddsi_fakenet_sendmsg (ddsrt_socket_t sock, const ddsrt_msghdr_t *msg, int flags, size_t *sent);
 
+#if DDSRT_HAVE_MMSG
+/** @component fake_network */
+dds_return_t ddsi_fakenet_sendmmsg (ddsrt_socket_t sock, ddsrt_mmsghdr_t *msgs, size_t vlen, int flags, size_t *nsent);
+#endif
+
 /** @component fake_network */
 dds_return_t ddsi_fakenet_recvmsg (const ddsrt_socket_ext_t *sockext, ddsrt_msghdr_t *msg, int flags, size_t *rcvd);
 
+#if DDSRT_HAVE_MMSG
+/** @component fake_network */
+dds_return_t ddsi_fakenet_recvmmsg (const ddsrt_socket_ext_t *sockext, ddsrt_mmsghdr_t *msgs, size_t vlen, int flags, size_t *nrcvd);
+#endif
+
 /** @component fake_network */
 dds_return_t ddsi_fakenet_getsockopt (ddsrt_socket_t sock, int32_t level, int32_t optname, void *optval, socklen_t *optlen);
 
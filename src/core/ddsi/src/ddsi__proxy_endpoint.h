@@ -29,6 +29,7 @@ extern "C" {
 struct ddsi_alive_state;
 struct dds_qos;
 struct ddsi_addrset;
+struct ddsi_content_filter_property;
 
 extern const ddsrt_avl_treedef_t ddsi_pwr_readers_treedef;
 extern const ddsrt_avl_treedef_t ddsi_prd_writers_treedef;
@@ -49,6 +50,17 @@ struct ddsi_entity_common *ddsi_entity_common_from_proxy_endpoint_common (const
 /** @component ddsi_proxy_endpoint */
 bool ddsi_is_proxy_endpoint (const struct ddsi_entity_common *e);
 
+/** @brief Selects the delivery queue for application data from a proxy writer
+ * @component ddsi_proxy_endpoint
+ *
+ * All data of a writer goes through the same queue, which preserves the order,
+ * writers are spread over the queues by hashing the GUID.
+ *
+ * @param[in] gv    domain
+ * @param[in] guid  proxy writer GUID
+ * @returns the delivery queue to use */
+struct ddsi_dqueue *ddsi_user_dqueue_for_proxy_writer (const struct ddsi_domaingv *gv, const ddsi_guid_t *guid);
+
 /** @component ddsi_proxy_endpoint */
 void ddsi_send_entityid_to_pwr (struct ddsi_proxy_writer *pwr, const ddsi_guid_t *guid);
 
@@ -88,7 +100,7 @@ int ddsi_delete_proxy_writer (struct ddsi_domaingv *gv, const struct ddsi_guid *
 int ddsi_delete_proxy_reader (struct ddsi_domaingv *gv, const struct ddsi_guid *guid, ddsrt_wctime_t timestamp, bool lease_expired);
 
 /** @component ddsi_proxy_endpoint */
-void ddsi_update_proxy_reader (struct ddsi_proxy_reader *prd, ddsi_seqno_t seq, struct ddsi_addrset *as, const struct dds_qos *xqos, ddsrt_wctime_t timestamp);
+void ddsi_update_proxy_reader (struct ddsi_proxy_reader *prd, ddsi_seqno_t seq, struct ddsi_addrset *as, const struct dds_qos *xqos, const struct ddsi_content_filter_property *content_filter, ddsrt_wctime_t timestamp);
 
 /** @component ddsi_proxy_endpoint */
 void ddsi_update_proxy_writer (struct ddsi_proxy_writer *pwr, ddsi_seqno_t seq, struct ddsi_addrset *as, const struct dds_qos *xqos, ddsrt_wctime_t timestamp);
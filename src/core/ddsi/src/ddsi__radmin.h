@@ -70,6 +70,7 @@ struct ddsi_rsample_info {
   uint32_t fragsize;
   ddsrt_wctime_t timestamp;
   ddsrt_wctime_t reception_timestamp; /* OpenSplice extension -- but we get it essentially for free, so why not? */
+  ddsrt_wctime_t rx_timestamp;  /* reception by kernel/network interface if SocketTimestamps enabled, else invalid */
   unsigned statusinfo: 2;       /* just the two defined bits from the status info */
   unsigned bswap: 1;            /* so we can extract well formatted writer info quicker */
   unsigned complex_qos: 1;      /* includes QoS other than keyhash, 2-bit statusinfo, PT writer info */
@@ -119,9 +120,57 @@ enum ddsi_defrag_nackmap_result {
   DDSI_DEFRAG_NACKMAP_FRAGMENTS_MISSING
 };
 
+/** @brief Occupancy and recycling statistics of a receive buffer pool
+ * @component receive_buffers */
+struct ddsi_rbufpool_stats {
+  uint32_t nslots;        /**< number of receive buffers that fit in the preallocated region */
+  uint32_t inuse;         /**< number of slots currently in use */
+  uint32_t peak_inuse;    /**< maximum number of slots simultaneously in use */
+  uint64_t recycled;      /**< number of allocations satisfied by a released slot */
+  uint64_t overflow;      /**< number of allocations from the heap because the region was exhausted */
+  bool hugepages;         /**< whether the region is backed by explicitly reserved huge pages */
+};
+
 /** @component receive_buffers */
 struct ddsi_rbufpool *ddsi_rbufpool_new (const struct ddsrt_log_cfg *logcfg, uint32_t rbuf_size, uint32_t max_rmsg_size);
 
+/**
+ * @brief Create a receive buffer pool that carves its receive buffers from a preallocated region
+ * @component receive_buffers
+ *
+ * The region is reserved but not touched, each slot in it is initialized by the owner of
+ * the pool when it first needs it. That way, on a NUMA system, the memory gets allocated
+ * on the node the owning receive thread runs on. Released slots are recycled, and when
+ * all slots are in use, receive buffers are allocated from the heap.
+ *
+ * @param[in] logcfg logging configuration
+ * @param[in] rbuf_size size of a receive buffer
+ * @param[in] max_rmsg_size maximum size of a message
+ * @param[in] region_size size of the region, 0 is equivalent to @ref ddsi_rbufpool_new
+ * @param[in] hugepages try to back the region with huge pages
+ * @returns the new pool, or NULL on failure
+ */
+struct ddsi_rbufpool *ddsi_rbufpool_new_preallocated (const struct ddsrt_log_cfg *logcfg, uint32_t rbuf_size, uint32_t max_rmsg_size, uint32_t region_size, bool hugepages);
+
+/**
+ * @brief Get occupancy and recycling statistics of a receive buffer pool
+ * @component receive_buffers
+ *
+ * @param[in] rbp receive buffer pool
+ * @param[out] stats statistics, all 0 for a pool without a preallocated region
+ */
+void ddsi_rbufpool_get_stats (struct ddsi_rbufpool *rbp, struct ddsi_rbufpool_stats *stats);
+
+/**
+ * @brief Set the limits for referencing samples in place in the receive buffers
+ * @component receive_buffers
+ *
+ * @param[in] rbp receive buffer pool
+ * @param[in] threshold minimum size of a sample for @ref ddsi_rmsg_pin to succeed, 0 disables it
+ * @param[in] limit maximum total size of the receive buffers kept alive by pinned messages
+ */
+void ddsi_rbufpool_set_pin_limits (struct ddsi_rbufpool *rbp, uint32_t threshold, uint32_t limit);
+
 /** @component receive_buffers */
 void ddsi_rbufpool_setowner (struct ddsi_rbufpool *rbp, ddsrt_thread_t tid);
 
@@ -131,6 +180,21 @@ void ddsi_rbufpool_free (struct ddsi_rbufpool *rbp);
 /** @component receive_buffers */
 struct ddsi_rmsg *ddsi_rmsg_new (struct ddsi_rbufpool *rbufpool);
 
+/**
+ * @brief Allocate a batch of rmsgs for receiving multiple packets at once
+ * @component receive_buffers
+ *
+ * All rmsgs in the batch are uncommitted and must be committed in order,
+ * before the next call to @ref ddsi_rmsg_new_batch on the same pool.
+ *
+ * @param[in] rbufpool pool to allocate from
+ * @param[out] rmsgs array for storing the allocated rmsgs
+ * @param[in] n maximum number of rmsgs to allocate, > 0
+ * @return number of allocated rmsgs, 0 on failure, may be less than n if the
+ *         current receive buffer has no room for n rmsgs
+ */
+uint32_t ddsi_rmsg_new_batch (struct ddsi_rbufpool *rbufpool, struct ddsi_rmsg **rmsgs, uint32_t n);
+
 /** @component receive_buffers */
 void ddsi_rmsg_setsize (struct ddsi_rmsg *rmsg, uint32_t size);
 
@@ -162,6 +226,20 @@ struct ddsi_defrag *ddsi_defrag_new (const struct ddsrt_log_cfg *logcfg, enum dd
 /** @component receive_buffers */
 void ddsi_defrag_free (struct ddsi_defrag *defrag);
 
+/**
+ * @brief Reassemble samples of at least the given size in a buffer of their own
+ * @component receive_buffers
+ *
+ * Fragments of such samples are copied into a buffer allocated when the first
+ * fragment is received, rather than referencing the receive buffers until the
+ * sample is complete.  Only applies to samples of which the first fragment is
+ * received first.
+ *
+ * @param[in] defrag     defragmenter
+ * @param[in] threshold  minimum sample size, 0 disables it
+ */
+void ddsi_defrag_set_contiguous_threshold (struct ddsi_defrag *defrag, uint32_t threshold);
+
 /** @component receive_buffers */
 struct ddsi_rsample *ddsi_defrag_rsample (struct ddsi_defrag *defrag, struct ddsi_rdata *rdata, const struct ddsi_rsample_info *sampleinfo);
 
@@ -0,0 +1,70 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#ifndef DDSI__REPLAY_H
+#define DDSI__REPLAY_H
+
+#include "dds/ddsi/ddsi_protocol.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+struct ddsi_writer;
+struct ddsi_wr_prd_match;
+struct ddsi_proxy_reader;
+
+/**
+ * @component outgoing_rtps
+ * @brief Prepares sending the history of a writer to a newly matched proxy reader
+ *
+ * The history available in the WHC up to the last transmitted sequence number is sent
+ * directly to the reader in batches of Internal/BurstSize/HistoryReplay bytes spaced
+ * by Internal/HistoryReplayInterval, with gaps for whatever is missing. This bypasses
+ * the retransmit path and its limits, retransmit requests for the part of the history
+ * that is still to be sent are ignored.
+ *
+ * Does nothing if the replay is disabled or if the reader doesn't need the history.
+ *
+ * @remark must be called with the writer lock held
+ *
+ * @param[in] wr   the writer
+ * @param[in] m    the match object for the reader, already added to the writer
+ * @param[in] prd  the proxy reader
+ */
+void ddsi_writer_start_history_replay (struct ddsi_writer *wr, struct ddsi_wr_prd_match *m, const struct ddsi_proxy_reader *prd);
+
+/**
+ * @component outgoing_rtps
+ * @brief Schedules sending the history prepared by @ref ddsi_writer_start_history_replay
+ *
+ * Called upon receipt of the first AckNack from the reader, because before that the
+ * reader may not yet know the writer and would drop the data.
+ *
+ * @remark must be called with the writer lock held
+ *
+ * @param[in] wr   the writer
+ * @param[in] m    the match object for the reader, with a history replay pending
+ */
+void ddsi_writer_schedule_history_replay (struct ddsi_writer *wr, struct ddsi_wr_prd_match *m);
+
+/**
+ * @component outgoing_rtps
+ * @brief Whether the sample with sequence number @p seq is still to be sent by the replay
+ *
+ * @remark must be called with the writer lock held
+ */
+bool ddsi_history_replay_pending (const struct ddsi_wr_prd_match *m, ddsi_seqno_t seq);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* DDSI__REPLAY_H */
@@ -111,6 +111,18 @@ void ddsi_sock_waitset_purge (struct ddsi_sock_waitset * ws, unsigned index);
  */
 struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset * ws);
 
+/**
+ * @brief Checks whether some of the connections in WS have data to be read.
+ * @component socket_waitset
+ *
+ * Like ddsi_sock_waitset_wait, but returns immediately if there is nothing
+ * to be read, either NULL or a context without events.
+ *
+ * @param ws The socket waitset
+ * @return struct ddsi_sock_waitset_ctx*
+ */
+struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_poll (struct ddsi_sock_waitset * ws);
+
 /**
  * @component socket_waitset
  *
@@ -94,11 +94,20 @@ enum ddsi_tran_qos_purpose {
   DDSI_TRAN_QOS_RECV_MC  ///< will be used for receiving multicast
 };
 
+/// @brief Type for describing whether a connection being created shares its port with others
+enum ddsi_tran_qos_port_sharing {
+  DDSI_TRAN_PORT_EXCLUSIVE, ///< port may not be in use (default)
+  DDSI_TRAN_PORT_SHARE_FIRST, ///< port may not be in use, but allows DDSI_TRAN_PORT_SHARE_JOIN
+  DDSI_TRAN_PORT_SHARE_JOIN ///< joins a port created with DDSI_TRAN_PORT_SHARE_FIRST, the kernel distributes the incoming data
+};
+
 /// @brief Network packet info
 struct ddsi_network_packet_info {
   ddsi_locator_t src;     ///< Source address
   ddsi_locator_t dst; ///< Actual destination address in packet, pkt_dst.kind = INVALID if unknown (other fields undefined)
   uint32_t if_index;      ///< Interface over which packet was received, 0 if unknown
+  uint32_t segsize;       ///< Size of the datagrams the kernel coalesced into this one (GRO), 0 if a single datagram
+  ddsrt_wctime_t timestamp; ///< Time of reception by the kernel or network interface, DDSRT_WCTIME_INVALID if unknown
 };
 
 /** @brief Read bytes from an connection that may have SSL enabled
@@ -115,6 +124,29 @@ struct ddsi_network_packet_info {
  * @retval other error codes possible as well (from ddsrt) */
 typedef dds_return_t (*ddsi_tran_read_fn_t) (struct ddsi_tran_conn *conn, unsigned char *buf, size_t sz, bool allow_spurious, struct ddsi_network_packet_info *pktinfo, size_t *bytes_read) ddsrt_nonnull((1, 2, 6)) ddsrt_attribute_warn_unused_result;
 
+/// @brief Buffer descriptor for reading multiple datagrams in one operation
+typedef struct ddsi_tran_read_buf {
+  unsigned char *buf; ///< buffer to store received bytes
+  size_t sz; ///< size of buffer pointed to by buf
+  size_t offset; ///< offset of the datagram in buf, initialized to 0 by the caller, changed only by transports that put metadata in front of it
+  size_t bytes_read; ///< number of bytes read into buf (from offset), 0 for the buffers that were not filled
+  struct ddsi_network_packet_info pktinfo; ///< source & destination IP address information
+} ddsi_tran_read_buf_t;
+
+/** @brief Read multiple datagrams from a connectionless connection
+ * @param[in,out] conn connection to read data from
+ * @param[in,out] bufs array of buffers to fill
+ * @param[in] nbufs number of entries in bufs, > 0
+ * @param[in] allow_spurious if true, return TRY_AGAIN if no bytes available
+ * @param[out] nread number of entries in bufs that were filled (entries before it may be empty if the
+ *   transport fills them out of order), only blocks until the first one is filled
+ * @return return code indicating success or failure
+ * @retval `DDS_RETCODE_OK` at least one datagram read, `nread` in [1,nbufs]
+ * @retval `DDS_RETCODE_TRY_AGAIN` no datagrams available (only if `allow_spurious`)
+ * @retval `DDS_RETCODE_ERROR` unspecified error
+ * @retval other error codes possible as well (from ddsrt) */
+typedef dds_return_t (*ddsi_tran_read_multiple_fn_t) (struct ddsi_tran_conn *conn, ddsi_tran_read_buf_t *bufs, size_t nbufs, bool allow_spurious, size_t *nread) ddsrt_nonnull((1, 2, 5)) ddsrt_attribute_warn_unused_result;
+
 /** @brief Write a message to a destination address
  * @param[in,out] conn  connection to write data to
  * @param[in] dst destination address
@@ -128,6 +160,51 @@ typedef dds_return_t (*ddsi_tran_read_fn_t) (struct ddsi_tran_conn *conn, unsign
  * @retval other error codes possible as well (from ddsrt) */
 typedef dds_return_t (*ddsi_tran_write_fn_t) (struct ddsi_tran_conn *conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t flags, size_t *bytes_written) ddsrt_nonnull((1, 2, 3));
 
+/// @brief Message descriptor for writing multiple messages in one operation
+typedef struct ddsi_tran_write_buf {
+  const ddsi_locator_t *dst; ///< destination address
+  const ddsi_tran_write_msgfrags_t *msgfrags; ///< message contents
+  dds_return_t rc; ///< result of writing this message
+  size_t bytes_written; ///< number of bytes written, only valid if rc is `DDS_RETCODE_OK`
+} ddsi_tran_write_buf_t;
+
+/** @brief Write multiple messages, each to its own destination address
+ * @param[in,out] conn connection to write data to
+ * @param[in,out] bufs array of messages to write, on return `rc` and `bytes_written` are set for all of them
+ * @param[in] nbufs number of entries in bufs, > 0
+ * @param[in] flags write flags, as for @ref ddsi_tran_write_fn_t */
+typedef void (*ddsi_tran_write_multiple_fn_t) (struct ddsi_tran_conn *conn, ddsi_tran_write_buf_t *bufs, size_t nbufs, uint32_t flags) ddsrt_nonnull((1, 2));
+
+/** @brief Write a sequence of datagrams of equal size (but for the last) to a destination address
+ * @param[in,out] conn connection to write data to
+ * @param[in] dst destination address
+ * @param[in] msgfrags contents of all datagrams concatenated
+ * @param[in] segsize size of each datagram but the last, which may be smaller
+ * @param[in] flags write flags, as for @ref ddsi_tran_write_fn_t
+ * @param[out] bytes_written optional, number of bytes written on successful completion, undefined in all other cases
+ * @return return code indicating success or failure, as for @ref ddsi_tran_write_fn_t */
+typedef dds_return_t (*ddsi_tran_write_segmented_fn_t) (struct ddsi_tran_conn *conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t segsize, uint32_t flags, size_t *bytes_written) ddsrt_nonnull((1, 2, 3));
+
+/** @brief Reference-counted object that keeps the memory referenced by a message alive
+ *
+ * Transports that continue to use the memory after returning from the write call (i.e.,
+ * zero-copy transmission) take a reference for as long as they need it, the last one to
+ * release it calls `free`. */
+typedef struct ddsi_tran_write_keepalive {
+  ddsrt_atomic_uint32_t refc;
+  void (*free) (struct ddsi_tran_write_keepalive *keepalive);
+} ddsi_tran_write_keepalive_t;
+
+/** @brief Write a message without copying the data, if the transport can do so
+ * @param[in,out] conn connection to write data to
+ * @param[in] dst destination address
+ * @param[in] msgfrags message contents, all of it remains valid while `keepalive` is referenced
+ * @param[in] keepalive object to reference for as long as the message contents are in use
+ * @param[in] flags write flags, as for @ref ddsi_tran_write_fn_t
+ * @param[out] bytes_written optional, number of bytes written on successful completion, undefined in all other cases
+ * @return return code indicating success or failure, as for @ref ddsi_tran_write_fn_t */
+typedef dds_return_t (*ddsi_tran_write_zerocopy_fn_t) (struct ddsi_tran_conn *conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, ddsi_tran_write_keepalive_t *keepalive, uint32_t flags, size_t *bytes_written) ddsrt_nonnull((1, 2, 3, 4));
+
 typedef int (*ddsi_tran_locator_fn_t) (struct ddsi_tran_factory *, struct ddsi_tran_base *, ddsi_locator_t *);
 typedef bool (*ddsi_tran_supports_fn_t) (const struct ddsi_tran_factory *, int32_t);
 typedef ddsrt_socket_t (*ddsi_tran_handle_fn_t) (struct ddsi_tran_base *);
@@ -135,6 +212,13 @@ typedef int (*ddsi_tran_listen_fn_t) (struct ddsi_tran_listener *);
 typedef void (*ddsi_tran_free_fn_t) (struct ddsi_tran_factory *);
 typedef void (*ddsi_tran_peer_locator_fn_t) (struct ddsi_tran_conn *, ddsi_locator_t *);
 typedef void (*ddsi_tran_disable_multiplexing_fn_t) (struct ddsi_tran_conn *);
+
+/** @brief Configures busy polling for a connection
+ * @param[in] conn connection
+ * @param[in] spin if > 0, time to keep trying non-blocking reads before blocking (only for connections that have a receive thread of their own)
+ * @param[in] sock_busy_poll if > 0, time the kernel may busy-poll the device for blocking reads
+ * @return DDS_RETCODE_OK or DDS_RETCODE_UNSUPPORTED if (a part of) the settings is not supported */
+typedef dds_return_t (*ddsi_tran_set_busy_poll_fn_t) (struct ddsi_tran_conn *conn, dds_duration_t spin, dds_duration_t sock_busy_poll);
 typedef struct ddsi_tran_conn * (*ddsi_tran_accept_fn_t) (struct ddsi_tran_listener *);
 typedef dds_return_t (*ddsi_tran_create_conn_fn_t) (struct ddsi_tran_conn **conn, struct ddsi_tran_factory * fact, uint32_t, const struct ddsi_tran_qos *);
 typedef dds_return_t (*ddsi_tran_create_listener_fn_t) (struct ddsi_tran_listener **listener, struct ddsi_tran_factory * fact, uint32_t port, const struct ddsi_tran_qos *);
@@ -200,9 +284,14 @@ struct ddsi_tran_conn
   /* Functions */
 
   ddsi_tran_read_fn_t m_read_fn;
+  ddsi_tran_read_multiple_fn_t m_read_multiple_fn; // optional, only for datagram transports
   ddsi_tran_write_fn_t m_write_fn;
+  ddsi_tran_write_multiple_fn_t m_write_multiple_fn; // optional, only for datagram transports
+  ddsi_tran_write_segmented_fn_t m_write_segmented_fn; // optional, only for datagram transports with segmentation offload
+  ddsi_tran_write_zerocopy_fn_t m_write_zerocopy_fn; // optional, only for transports that can send without copying
   ddsi_tran_peer_locator_fn_t m_peer_locator_fn;
   ddsi_tran_disable_multiplexing_fn_t m_disable_multiplexing_fn;
+  ddsi_tran_set_busy_poll_fn_t m_set_busy_poll_fn; // optional
   ddsi_tran_locator_fn_t m_locator_fn;
 
   /* Data */
@@ -309,6 +398,8 @@ struct ddsi_tran_qos
      multicast transmit options. */
   struct ddsi_network_interface *m_interface;
   bool m_bind_to_any;
+  /* Only supported for receiving unicast by the UDP transport on Linux */
+  enum ddsi_tran_qos_port_sharing m_port_sharing;
 };
 
 /** @component transport */
@@ -443,6 +534,33 @@ inline dds_return_t ddsi_conn_write (struct ddsi_tran_conn * conn, const ddsi_lo
   return conn->m_closed ? DDS_RETCODE_ALREADY_DELETED : (conn->m_write_fn) (conn, dst, msgfrags, flags, bytes_written);
 }
 
+/** @brief Write multiple messages, each to its own destination address
+ * @component transport
+ *
+ * Falls back to writing the messages one by one if the transport has no support for
+ * writing multiple ones in one operation.
+ *
+ * @param[in,out] conn connection to write data to
+ * @param[in,out] bufs array of messages to write, on return `rc` and `bytes_written` are set for all of them
+ * @param[in] nbufs number of entries in bufs, > 0
+ * @param[in] flags write flags -- FIXME: do we actually have any? */
+ddsrt_nonnull ((1, 2))
+inline void ddsi_conn_write_multiple (struct ddsi_tran_conn * conn, ddsi_tran_write_buf_t *bufs, size_t nbufs, uint32_t flags) {
+  assert (nbufs > 0);
+  if (conn->m_closed)
+  {
+    for (size_t i = 0; i < nbufs; i++)
+      bufs[i].rc = DDS_RETCODE_ALREADY_DELETED;
+  }
+  else if (conn->m_write_multiple_fn)
+    conn->m_write_multiple_fn (conn, bufs, nbufs, flags);
+  else
+  {
+    for (size_t i = 0; i < nbufs; i++)
+      bufs[i].rc = conn->m_write_fn (conn, bufs[i].dst, bufs[i].msgfrags, flags, &bufs[i].bytes_written);
+  }
+}
+
 /** @brief Read bytes from an connection that may have SSL enabled
  * @component transport
  * @param[in,out] conn connection to read data from
@@ -461,12 +579,114 @@ inline dds_return_t ddsi_conn_read (struct ddsi_tran_conn * conn, unsigned char
   return conn->m_closed ? DDS_RETCODE_ALREADY_DELETED : conn->m_read_fn (conn, buf, sz, allow_spurious, pktinfo, bytes_read);
 }
 
+/** @brief Read multiple datagrams from a connectionless connection
+ * @component transport
+ *
+ * Falls back to reading a single datagram into the first buffer if the transport has
+ * no support for reading multiple ones in one operation.
+ *
+ * @param[in,out] conn connection to read data from
+ * @param[in,out] bufs array of buffers to fill
+ * @param[in] nbufs number of entries in bufs, > 0
+ * @param[in] allow_spurious if true, return TRY_AGAIN if no bytes available
+ * @param[out] nread number of entries in bufs that were filled
+ * @return return code indicating success or failure
+ * @retval `DDS_RETCODE_OK` at least one datagram read, `nread` in [1,nbufs]
+ * @retval `DDS_RETCODE_TRY_AGAIN` no datagrams available (only if `allow_spurious`)
+ * @retval `DDS_RETCODE_ERROR` unspecified error
+ * @retval other error codes possible as well (from ddsrt) */
+ddsrt_nonnull ((1, 2, 5)) ddsrt_attribute_warn_unused_result
+inline dds_return_t ddsi_conn_read_multiple (struct ddsi_tran_conn * conn, ddsi_tran_read_buf_t *bufs, size_t nbufs, bool allow_spurious, size_t *nread) {
+  assert (nbufs > 0 && !conn->m_stream);
+  if (conn->m_closed)
+    return DDS_RETCODE_ALREADY_DELETED;
+  else if (conn->m_read_multiple_fn)
+    return conn->m_read_multiple_fn (conn, bufs, nbufs, allow_spurious, nread);
+  else
+  {
+    const dds_return_t rc = conn->m_read_fn (conn, bufs[0].buf, bufs[0].sz, allow_spurious, &bufs[0].pktinfo, &bufs[0].bytes_read);
+    *nread = (rc == DDS_RETCODE_OK && bufs[0].bytes_read > 0) ? 1 : 0;
+    return rc;
+  }
+}
+
+/** @brief Write a sequence of datagrams of equal size (but for the last) to a destination address
+ * @component transport
+ *
+ * Uses segmentation offload if the transport supports it, otherwise writes the datagrams
+ * one by one.
+ *
+ * @param[in,out] conn connection to write data to
+ * @param[in] dst destination address
+ * @param[in] msgfrags contents of all datagrams concatenated
+ * @param[in] segsize size of each datagram but the last, which may be smaller
+ * @param[in] flags write flags -- FIXME: do we actually have any?
+ * @param[out] bytes_written optional, number of bytes written on successful completion, undefined in all other cases
+ * @return return code indicating success or failure, as for @ref ddsi_conn_write */
+dds_return_t ddsi_conn_write_segmented (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t segsize, uint32_t flags, size_t *bytes_written)
+  ddsrt_nonnull ((1, 2, 3));
+
+/** @brief Write a sequence of datagrams of equal size (but for the last) one by one
+ * @component transport
+ *
+ * For use by transports that implement segmentation offload but need to fall back to
+ * writing the datagrams individually.
+ *
+ * @param[in,out] conn connection to write data to
+ * @param[in] dst destination address
+ * @param[in] msgfrags contents of all datagrams concatenated
+ * @param[in] segsize size of each datagram but the last, which may be smaller
+ * @param[in] flags write flags
+ * @param[out] bytes_written optional, number of bytes written on successful completion, undefined in all other cases
+ * @return return code indicating success or failure, the first failure stops the process */
+dds_return_t ddsi_conn_write_segments (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t segsize, uint32_t flags, size_t *bytes_written)
+  ddsrt_nonnull ((1, 2, 3));
+
+/** @brief Write a message without copying the data if possible
+ * @component transport
+ *
+ * Falls back to a regular write if the transport doesn't support sending without
+ * copying.
+ *
+ * @param[in,out] conn connection to write data to
+ * @param[in] dst destination address
+ * @param[in] msgfrags message contents, all of it remains valid while `keepalive` is referenced
+ * @param[in] keepalive object that the transport references for as long as it needs the contents
+ * @param[in] flags write flags -- FIXME: do we actually have any?
+ * @param[out] bytes_written optional, number of bytes written on successful completion, undefined in all other cases
+ * @return return code indicating success or failure, as for @ref ddsi_conn_write */
+ddsrt_nonnull ((1, 2, 3, 4))
+inline dds_return_t ddsi_conn_write_zerocopy (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, ddsi_tran_write_keepalive_t *keepalive, uint32_t flags, size_t *bytes_written) {
+  if (conn->m_closed)
+    return DDS_RETCODE_ALREADY_DELETED;
+  else if (conn->m_write_zerocopy_fn)
+    return conn->m_write_zerocopy_fn (conn, dst, msgfrags, keepalive, flags, bytes_written);
+  else
+    return conn->m_write_fn (conn, dst, msgfrags, flags, bytes_written);
+}
+
+/** @brief Take a reference to a keepalive object
+ * @component transport */
+inline void ddsi_tran_write_keepalive_ref (ddsi_tran_write_keepalive_t *keepalive) {
+  ddsrt_atomic_inc32 (&keepalive->refc);
+}
+
+/** @brief Release a reference to a keepalive object, freeing it when it was the last one
+ * @component transport */
+inline void ddsi_tran_write_keepalive_unref (ddsi_tran_write_keepalive_t *keepalive) {
+  if (ddsrt_atomic_dec32_ov (&keepalive->refc) == 1)
+    keepalive->free (keepalive);
+}
+
 /** @component transport */
 bool ddsi_conn_peer_locator (struct ddsi_tran_conn * conn, ddsi_locator_t * loc);
 
 /** @component transport */
 void ddsi_conn_disable_multiplexing (struct ddsi_tran_conn * conn);
 
+/** @component transport */
+dds_return_t ddsi_conn_set_busy_poll (struct ddsi_tran_conn * conn, dds_duration_t spin, dds_duration_t sock_busy_poll);
+
 /** @component transport */
 void ddsi_conn_add_ref (struct ddsi_tran_conn * conn);
 
@@ -55,6 +55,43 @@ dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t
 /** @component outgoing_rtps */
 int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd, int isnew);
 
+/* Retransmits in response to an ACKNACK are collected while holding wr->lock, then packed
+   and queued after releasing it, so that the writer isn't blocked while that happens. The
+   samples are referenced, not borrowed from the WHC, and everything that comes from the
+   writer's mutable state is captured when adding them. An ACKNACK covers at most 256
+   sequence numbers. */
+#define DDSI_REXMIT_BATCH_MAX 256
+
+struct ddsi_addrset;
+
+struct ddsi_rexmit_batch_entry {
+  ddsi_seqno_t seq;
+  struct ddsi_serdata *serdata;
+  struct ddsi_proxy_reader *prd; /* NULL: all readers */
+  ddsi_count_t hbfragcount;
+};
+
+struct ddsi_rexmit_batch {
+  struct ddsi_addrset *as;
+  int64_t maxdelay;
+  bool keyhash;
+  uint32_t n;
+  struct ddsi_rexmit_batch_entry xs[DDSI_REXMIT_BATCH_MAX];
+};
+
+/** @component outgoing_rtps */
+void ddsi_rexmit_batch_init (struct ddsi_rexmit_batch *rb);
+
+/** @component outgoing_rtps */
+bool ddsi_rexmit_batch_add_wrlock_held (struct ddsi_writer *wr, struct ddsi_rexmit_batch *rb, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd);
+
+/* Does not require wr->lock and must be called without holding it. Returns false if the
+   queue of retransmits filled up before all of the batch was queued. Either way, the batch
+   is empty again on return. */
+
+/** @component outgoing_rtps */
+bool ddsi_rexmit_batch_send (struct ddsi_writer *wr, struct ddsi_rexmit_batch *rb);
+
 /** @component outgoing_rtps */
 void ddsi_enqueue_spdp_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd);
 
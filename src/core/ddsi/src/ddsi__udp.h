@@ -29,6 +29,12 @@ typedef struct ddsi_udpv4mcgen_address {
 /** @component udp_transport */
 int ddsi_udp_init (struct ddsi_domaingv *gv);
 
+/** @brief Variant of the UDP transport that uses io_uring for the data path
+ * @component udp_transport
+ *
+ * Only available on Linux, elsewhere it fails */
+int ddsi_uringudp_init (struct ddsi_domaingv *gv);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -0,0 +1,101 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#ifndef DDSI__URING_H
+#define DDSI__URING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "dds/ddsrt/retcode.h"
+
+// Minimal io_uring support without depending on liburing: it only needs the kernel
+// header for the data structures and the system call numbers.  Multishot recvmsg
+// (Linux 6.0) is the newest feature used, the header is the one that decides.
+#if defined __linux__ && defined __has_include
+#  if __has_include(<linux/io_uring.h>)
+#    include <sys/syscall.h>
+#    include <linux/io_uring.h>
+#    if defined __NR_io_uring_setup && defined __NR_io_uring_enter && defined IORING_RECV_MULTISHOT
+#      define DDSI_HAVE_URING 1
+#    endif
+#  endif
+#endif
+#ifndef DDSI_HAVE_URING
+#  define DDSI_HAVE_URING 0
+#endif
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#if DDSI_HAVE_URING
+
+/** @brief A submission and completion queue pair for a single user
+ * @component uring
+ *
+ * None of the operations are thread-safe, concurrent use requires external locking. */
+struct ddsi_uring {
+  int fd;
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t sqe_tail; ///< local copy of the SQ tail, the shared one is updated on submit
+  uint32_t *sq_head, *sq_tail, *sq_mask, *sq_array;
+  uint32_t *cq_head, *cq_tail, *cq_mask;
+  struct io_uring_sqe *sqes;
+  struct io_uring_cqe *cqes;
+  void *sq_ring_ptr, *cq_ring_ptr;
+  size_t sq_ring_sz, cq_ring_sz, sqes_sz;
+};
+
+/** @brief Create an io_uring with (at least) the requested number of submission queue entries
+ * @component uring
+ *
+ * @param[out] ring ring to initialize
+ * @param[in] entries number of submission queue entries, the completion queue is twice as large
+ * @return `DDS_RETCODE_OK` on success, `DDS_RETCODE_UNSUPPORTED` if the kernel does not support
+ *   it (or it is disabled), `DDS_RETCODE_ERROR` for any other failure */
+dds_return_t ddsi_uring_init (struct ddsi_uring *ring, uint32_t entries);
+
+/** @component uring */
+void ddsi_uring_fini (struct ddsi_uring *ring);
+
+/** @brief Get a cleared submission queue entry
+ * @component uring
+ *
+ * @return pointer to the entry, or NULL if the submission queue is full */
+struct io_uring_sqe *ddsi_uring_get_sqe (struct ddsi_uring *ring);
+
+/** @brief Submit all pending submission queue entries and wait for completions
+ * @component uring
+ *
+ * @param[in] ring ring
+ * @param[in] wait_nr minimum number of completions to wait for (0 for not waiting)
+ * @return `DDS_RETCODE_OK` on success, `DDS_RETCODE_INTERRUPTED` if the wait was interrupted,
+ *   `DDS_RETCODE_TRY_AGAIN` if the kernel is temporarily unable to accept the submissions,
+ *   `DDS_RETCODE_ERROR` otherwise */
+dds_return_t ddsi_uring_submit_and_wait (struct ddsi_uring *ring, uint32_t wait_nr);
+
+/** @brief Get the oldest unprocessed completion queue entry without blocking
+ * @component uring
+ *
+ * @return pointer to the entry, or NULL if there is none, it remains valid until
+ *   @ref ddsi_uring_cqe_seen is called */
+struct io_uring_cqe *ddsi_uring_peek_cqe (struct ddsi_uring *ring);
+
+/** @component uring */
+void ddsi_uring_cqe_seen (struct ddsi_uring *ring);
+
+#endif /* DDSI_HAVE_URING */
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* DDSI__URING_H */
@@ -64,8 +64,8 @@ inline void ddsi_whc_free (struct ddsi_whc *whc) {
 }
 
 /** @component whc_if */
-inline int ddsi_whc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk) {
-  return whc->ops->insert (whc, max_drop_seq, seq, exp, serdata, tk);
+inline int ddsi_whc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects) {
+  return whc->ops->insert (whc, max_drop_seq, seq, exp, serdata, tk, filter_rejects);
 }
 
 /** @component whc_if */
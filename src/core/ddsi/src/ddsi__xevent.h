@@ -30,6 +30,7 @@ struct ddsi_proxy_writer;
 struct ddsi_proxy_reader;
 struct ddsi_domaingv;
 struct ddsi_xmsg;
+struct ddsi_addrset;
 
 /** @component timed_events */
 struct ddsi_xeventq *ddsi_xeventq_new (struct ddsi_domaingv *gv, size_t max_queued_rexmit_bytes, size_t max_queued_rexmit_msgs);
@@ -70,8 +71,11 @@ enum ddsi_qxev_msg_rexmit_result {
   DDSI_QXEV_MSG_REXMIT_QUEUED
 };
 
+/* wras is the writer's address set, used if the message gets merged with a queued one that
+   is addressed to a different participant */
+
 /** @component timed_events */
-enum ddsi_qxev_msg_rexmit_result ddsi_qxev_msg_rexmit_wrlock_held (struct ddsi_xeventq *evq, struct ddsi_xmsg *msg, int force);
+enum ddsi_qxev_msg_rexmit_result ddsi_qxev_msg_rexmit (struct ddsi_xeventq *evq, struct ddsi_xmsg *msg, struct ddsi_addrset *wras, int force);
 
 #ifndef NDEBUG
 /**
@@ -164,9 +164,10 @@ void ddsi_xmsg_set_data_reader_id (struct ddsi_xmsg *m, ddsi_entityid_t *readerI
  * @param gv    domain globals
  * @param m     xmsg
  * @param madd  xmsg to add
+ * @param wras  the writer's address set
  * @returns Returns 1 if merge was successful, else 0.
  */
-int ddsi_xmsg_merge_rexmit_destinations_wrlock_held (struct ddsi_domaingv *gv, struct ddsi_xmsg *m, const struct ddsi_xmsg *madd)
+int ddsi_xmsg_merge_rexmit_destinations (struct ddsi_domaingv *gv, struct ddsi_xmsg *m, const struct ddsi_xmsg *madd, struct ddsi_addrset *wras)
   ddsrt_nonnull_all;
 
 /**
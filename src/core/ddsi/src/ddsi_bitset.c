@@ -15,4 +15,7 @@ extern inline void ddsi_bitset_set (uint32_t numbits, uint32_t *bits, uint32_t i
 extern inline void ddsi_bitset_clear (uint32_t numbits, uint32_t *bits, uint32_t idx);
 extern inline void ddsi_bitset_zero (uint32_t numbits, uint32_t *bits);
 extern inline void ddsi_bitset_one (uint32_t numbits, uint32_t *bits);
+extern inline uint32_t ddsi_bitset_word_mask (uint32_t lo, uint32_t hi);
+extern inline void ddsi_bitset_set_range (uint32_t numbits, uint32_t *bits, uint32_t from, uint32_t to);
+extern inline void ddsi_bitset_clear_range (uint32_t numbits, uint32_t *bits, uint32_t from, uint32_t to);
 
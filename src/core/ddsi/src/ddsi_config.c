@@ -170,6 +170,10 @@ DUPF(uint32);
 #endif
 DU(natint);
 DU(natint_255);
+DU(recv_batch_size);
+DU(recv_uc_sockets);
+DU(delivery_queues);
+DU(reader_history_shards);
 DU(pos_uint);
 DUPF(participantIndex);
 #ifdef DDS_HAS_TCP
@@ -198,6 +202,7 @@ DUPF(maybe_int32);
 DUPF(domainId);
 DUPF(transport_selector);
 DUPF(many_sockets_mode);
+DUPF(socket_timestamps);
 DU(deaf_mute);
 #ifdef DDS_HAS_TCP_TLS
 DUPF(min_tls_version);
@@ -1031,6 +1036,13 @@ DDSRT_STATIC_ASSERT (sizeof (en_transport_selector_vs) / sizeof (*en_transport_s
 static enum update_result uf_transport_selector (struct ddsi_cfgst *cfgst, void *parent, UNUSED_ARG (struct cfgelem const * const cfgelem), UNUSED_ARG (int first), const char *value)
 {
   enum ddsi_transport_selector * const elem = cfg_address (cfgst, parent, cfgelem);
+  cfgst->cfg->transport_io_uring = 0;
+  if (ddsrt_strcasecmp (value, "udp-uring") == 0 || ddsrt_strcasecmp (value, "udp6-uring") == 0)
+  {
+    *elem = (ddsrt_strcasecmp (value, "udp-uring") == 0) ? DDSI_TRANS_UDP : DDSI_TRANS_UDP6;
+    cfgst->cfg->transport_io_uring = 1;
+    return URES_SUCCESS;
+  }
 #ifdef DDS_HAS_FAKEUDP
   if (strncmp (value, "fakeudp:", strlen ("fakeudp:")) == 0)
   {
@@ -1066,6 +1078,11 @@ static enum update_result uf_transport_selector (struct ddsi_cfgst *cfgst, void
 static void pf_transport_selector (struct ddsi_cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, uint32_t sources)
 {
   enum ddsi_transport_selector const * const p = cfg_address (cfgst, parent, cfgelem);
+  if ((*p == DDSI_TRANS_UDP || *p == DDSI_TRANS_UDP6) && cfgst->cfg->transport_io_uring)
+  {
+    cfg_logelem (cfgst, sources, "%s-uring", (*p == DDSI_TRANS_UDP) ? "udp" : "udp6");
+    return;
+  }
 #ifdef DDS_HAS_FAKEUDP
   if (*p == DDSI_TRANS_FAKEUDP && cfgst->cfg->fake_network_topology_kind == DDSI_FAKENET_TOPOLOGY_REAL)
   {
@@ -1099,6 +1116,10 @@ static const enum ddsi_many_sockets_mode en_many_sockets_mode_ms[] = {
   DDSI_MSM_SINGLE_UNICAST, DDSI_MSM_NO_UNICAST, DDSI_MSM_MANY_UNICAST, DDSI_MSM_SINGLE_UNICAST, DDSI_MSM_MANY_UNICAST, 0 };
 GENERIC_ENUM_CTYPE (many_sockets_mode, enum ddsi_many_sockets_mode)
 
+static const char *en_socket_timestamps_vs[] = { "none", "software", "hardware", NULL };
+static const enum ddsi_socket_timestamps en_socket_timestamps_ms[] = { DDSI_SOCKTS_NONE, DDSI_SOCKTS_SOFTWARE, DDSI_SOCKTS_HARDWARE, 0 };
+GENERIC_ENUM_CTYPE (socket_timestamps, enum ddsi_socket_timestamps)
+
 static const char *en_standards_conformance_vs[] = { "pedantic", "strict", "lax", NULL };
 static const enum ddsi_standards_conformance en_standards_conformance_ms[] = { DDSI_SC_PEDANTIC, DDSI_SC_STRICT, DDSI_SC_LAX, 0 };
 GENERIC_ENUM_CTYPE (standards_conformance, enum ddsi_standards_conformance)
@@ -1601,6 +1622,26 @@ static enum update_result uf_natint_255(struct ddsi_cfgst *cfgst, void *parent,
   return uf_int_min_max(cfgst, parent, cfgelem, first, value, 0, 255);
 }
 
+static enum update_result uf_recv_batch_size(struct ddsi_cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, int first, const char *value)
+{
+  return uf_int_min_max(cfgst, parent, cfgelem, first, value, 1, DDSI_MAX_RECV_BATCH_SIZE);
+}
+
+static enum update_result uf_recv_uc_sockets(struct ddsi_cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, int first, const char *value)
+{
+  return uf_int_min_max(cfgst, parent, cfgelem, first, value, 1, DDSI_MAX_RECV_UC_SOCKETS);
+}
+
+static enum update_result uf_delivery_queues(struct ddsi_cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, int first, const char *value)
+{
+  return uf_int_min_max(cfgst, parent, cfgelem, first, value, 1, DDSI_MAX_DELIVERY_QUEUES);
+}
+
+static enum update_result uf_reader_history_shards(struct ddsi_cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, int first, const char *value)
+{
+  return uf_int_min_max(cfgst, parent, cfgelem, first, value, 1, DDSI_MAX_READER_HISTORY_SHARDS);
+}
+
 static enum update_result uf_uint (struct ddsi_cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, UNUSED_ARG (int first), const char *value)
 {
   uint32_t * const elem = cfg_address (cfgst, parent, cfgelem);
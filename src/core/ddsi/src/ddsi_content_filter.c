@@ -0,0 +1,65 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <string.h>
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/string.h"
+#include "dds/ddsi/ddsi_content_filter.h"
+
+extern inline struct ddsi_content_filter *ddsi_content_filter_compile (const struct ddsi_content_filter_interface *cfif, const struct ddsi_sertype *type, const ddsi_content_filter_property_t *prop);
+extern inline bool ddsi_content_filter_accepts (const struct ddsi_content_filter_interface *cfif, const struct ddsi_content_filter *filter, const struct ddsi_serdata *serdata);
+extern inline void ddsi_content_filter_free (const struct ddsi_content_filter_interface *cfif, struct ddsi_content_filter *filter);
+
+ddsi_content_filter_property_t *ddsi_content_filter_property_dup (const ddsi_content_filter_property_t *src)
+{
+  ddsi_content_filter_property_t *dst = ddsrt_malloc (sizeof (*dst));
+  dst->content_filtered_topic_name = ddsrt_strdup (src->content_filtered_topic_name);
+  dst->related_topic_name = ddsrt_strdup (src->related_topic_name);
+  dst->filter_class_name = ddsrt_strdup (src->filter_class_name);
+  dst->filter_expression = ddsrt_strdup (src->filter_expression);
+  dst->expression_parameters.n = src->expression_parameters.n;
+  dst->expression_parameters.strs = NULL;
+  if (src->expression_parameters.n > 0)
+  {
+    dst->expression_parameters.strs = ddsrt_malloc (src->expression_parameters.n * sizeof (*dst->expression_parameters.strs));
+    for (uint32_t i = 0; i < src->expression_parameters.n; i++)
+      dst->expression_parameters.strs[i] = ddsrt_strdup (src->expression_parameters.strs[i]);
+  }
+  return dst;
+}
+
+void ddsi_content_filter_property_free (ddsi_content_filter_property_t *prop)
+{
+  if (prop == NULL)
+    return;
+  ddsrt_free (prop->content_filtered_topic_name);
+  ddsrt_free (prop->related_topic_name);
+  ddsrt_free (prop->filter_class_name);
+  ddsrt_free (prop->filter_expression);
+  for (uint32_t i = 0; i < prop->expression_parameters.n; i++)
+    ddsrt_free (prop->expression_parameters.strs[i]);
+  ddsrt_free (prop->expression_parameters.strs);
+  ddsrt_free (prop);
+}
+
+bool ddsi_content_filter_property_equal (const ddsi_content_filter_property_t *a, const ddsi_content_filter_property_t *b)
+{
+  if (a == NULL || b == NULL)
+    return a == b;
+  if (strcmp (a->related_topic_name, b->related_topic_name) != 0 ||
+      strcmp (a->filter_class_name, b->filter_class_name) != 0 ||
+      strcmp (a->filter_expression, b->filter_expression) != 0 ||
+      a->expression_parameters.n != b->expression_parameters.n)
+    return false;
+  for (uint32_t i = 0; i < a->expression_parameters.n; i++)
+    if (strcmp (a->expression_parameters.strs[i], b->expression_parameters.strs[i]) != 0)
+      return false;
+  return true;
+}
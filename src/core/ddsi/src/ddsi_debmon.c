@@ -401,6 +401,8 @@ static void print_writer (struct st *st, void *varg)
     cpfkobj (st, "ack", print_writer_ack, w);
   }
   cpfku64 (st, "rexmit_bytes", w->rexmit_bytes);
+  cpfku64 (st, "replay_bytes", w->replay_bytes);
+  cpfku32 (st, "readers_replaying", w->num_readers_replaying);
   cpfku64 (st, "sent_bytes", w->sent_bytes);
   cpfku32 (st, "throttle_count", w->throttle_count);
   cpfku64 (st, "time_throttled", w->time_throttled);
@@ -637,11 +639,68 @@ static void print_proxy_participants (struct st *st)
   ddsi_thread_state_asleep (st->thrst);
 }
 
+#define WHC_TOP_WRITERS 10
+
+struct whc_top_writer {
+  ddsi_guid_t guid;
+  size_t unacked_bytes;
+};
+
+struct whc_top_writers {
+  uint32_t n;
+  struct whc_top_writer wr[WHC_TOP_WRITERS];
+};
+
+static void print_whc_top_writer (struct st *st, void *vwr)
+{
+  struct whc_top_writer * const wr = vwr;
+  cpfkguid (st, "guid", &wr->guid);
+  cpfksize (st, "unacked_bytes", wr->unacked_bytes);
+}
+
+static void print_whc_top_writers (struct st *st, void *vtop)
+{
+  struct whc_top_writers * const top = vtop;
+  for (uint32_t i = 0; i < top->n; i++)
+    cpfobj (st, print_whc_top_writer, &top->wr[i]);
+}
+
+static void print_whc_budget (struct st *st, void *varg)
+{
+  (void) varg;
+  struct whc_top_writers top = { .n = 0 };
+  struct ddsi_entity_enum_writer ew;
+  struct ddsi_writer *w;
+  ddsi_thread_state_awake_fixed_domain (st->thrst);
+  ddsi_entidx_enum_writer_init (&ew, st->gv->entity_index);
+  while ((w = ddsi_entidx_enum_writer_next (&ew)) != NULL)
+  {
+    struct ddsi_whc_state whcst;
+    ddsi_whc_get_state (w->whc, &whcst);
+    if (whcst.unacked_bytes == 0 || (top.n == WHC_TOP_WRITERS && whcst.unacked_bytes <= top.wr[top.n - 1].unacked_bytes))
+      continue;
+    // insertion sort on decreasing size, dropping the smallest one if full
+    uint32_t i = (top.n < WHC_TOP_WRITERS) ? top.n++ : top.n - 1;
+    for (; i > 0 && top.wr[i - 1].unacked_bytes < whcst.unacked_bytes; i--)
+      top.wr[i] = top.wr[i - 1];
+    top.wr[i].guid = w->e.guid;
+    top.wr[i].unacked_bytes = whcst.unacked_bytes;
+  }
+  ddsi_entidx_enum_writer_fini (&ew);
+  ddsi_thread_state_asleep (st->thrst);
+
+  cpfku32 (st, "budget", st->gv->config.whc_budget);
+  cpfku64 (st, "unacked_bytes", ddsrt_atomic_ld64 (&st->gv->whc_unacked_bytes));
+  cpfku32 (st, "unacked_writers", ddsrt_atomic_ld32 (&st->gv->whc_unacked_writers));
+  cpfkseq (st, "top_writers", print_whc_top_writers, &top);
+}
+
 static void print_domain (struct st *st, void *varg)
 {
   (void) varg;
   print_participants (st);
   print_proxy_participants (st);
+  cpfkobj (st, "whc", print_whc_budget, NULL);
 }
 
 static void debmon_write_response (struct ddsi_debug_monitor *dm, struct ddsi_tran_conn * conn)
@@ -147,7 +147,8 @@ dds_return_t ddsi_deliver_locally_one (struct ddsi_domaingv *gv, struct ddsi_ent
        "awake" (although a delete can be initiated), and blocking like this is a stopgap
        anyway -- quite possibly to abort once either is deleted */
     ddsrt_atomic_add64(&rd->received_bytes, ddsi_serdata_size (payload));
-    while (!ddsi_rhc_store (rd->rhc, wrinfo, payload, tk))
+    bool stored;
+    while (!(stored = ddsi_rhc_store (rd->rhc, wrinfo, payload, tk)))
     {
       if (source_entity_locked)
         ddsrt_mutex_unlock (&source_entity->lock);
@@ -161,6 +162,8 @@ dds_return_t ddsi_deliver_locally_one (struct ddsi_domaingv *gv, struct ddsi_ent
         break;
       }
     }
+    if (stored && ops->on_stored)
+      ops->on_stored (rd, vsourceinfo);
     free_sample_after_store (gv, payload, tk);
   }
   return DDS_RETCODE_OK;
@@ -201,7 +204,8 @@ static dds_return_t deliver_locally_slowpath (struct ddsi_domaingv *gv, struct d
       EETRACE (source_entity, "%s "PGUIDFMT, trace_is_first ? " =>" : "", PGUID (rd->e.guid));
       trace_is_first = false;
       ddsrt_atomic_add64(&rd->received_bytes, ddsi_serdata_size (payload));
-      (void) ddsi_rhc_store (rd->rhc, wrinfo, payload, tk);
+      if (ddsi_rhc_store (rd->rhc, wrinfo, payload, tk) && ops->on_stored)
+        ops->on_stored (rd, vsourceinfo);
     }
   }
   EETRACE (source_entity, "\n");
@@ -239,6 +243,8 @@ static dds_return_t deliver_locally_fastpath (struct ddsi_domaingv *gv, struct d
             return rc;
           }
         }
+        if (ops->on_stored)
+          ops->on_stored (rdary[i], vsourceinfo);
       } while (rdary[++i] && rdary[i]->type == type);
       free_sample_after_store (gv, payload, tk);
     }
@@ -16,6 +16,7 @@
 
 #include "dds/version.h"
 #include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/string.h"
 #include "dds/ddsrt/log.h"
 #include "dds/ddsi/ddsi_domaingv.h"
 #include "ddsi__discovery.h"
@@ -177,6 +178,16 @@ static int sedp_write_endpoint_impl
         ps.present |= PP_CYCLONE_REQUESTS_KEYHASH;
         ps.cyclone_requests_keyhash = 1u;
       }
+      if (rd->content_filter)
+      {
+        /* strings are aliased, owned by the reader, but ddsi_plist_fini always frees
+           the array of parameters */
+        const ddsi_stringseq_t *params = &rd->content_filter->expression_parameters;
+        ps.present |= PP_CONTENT_FILTER_PROPERTY;
+        ps.aliased |= PP_CONTENT_FILTER_PROPERTY;
+        ps.content_filter_property = *rd->content_filter;
+        ps.content_filter_property.expression_parameters.strs = (params->n > 0) ? ddsrt_memdup (params->strs, params->n * sizeof (*params->strs)) : NULL;
+      }
     }
 
 #ifdef DDSRT_HAVE_SSM
@@ -538,13 +549,13 @@ void ddsi_handle_sedp_alive_endpoint (const struct ddsi_receiver_state *rst, dds
         struct ddsi_proxy_writer *proxy_writer;
         /* not supposed to get here for built-in ones, so can determine the channel based on the transport priority */
         assert (!ddsi_is_builtin_entityid (datap->endpoint_guid.entityid, vendorid));
-        ddsi_new_proxy_writer (&proxy_writer, gv, &ppguid, &datap->endpoint_guid, as, datap, gv->user_dqueue, gv->xevents, timestamp, seq);
+        ddsi_new_proxy_writer (&proxy_writer, gv, &ppguid, &datap->endpoint_guid, as, datap, ddsi_user_dqueue_for_proxy_writer (gv, &datap->endpoint_guid), gv->xevents, timestamp, seq);
       }
     }
     else
     {
       if (prd)
-        ddsi_update_proxy_reader (prd, seq, as, xqos, timestamp);
+        ddsi_update_proxy_reader (prd, seq, as, xqos, (datap->present & PP_CONTENT_FILTER_PROPERTY) ? &datap->content_filter_property : NULL, timestamp);
       else
       {
         struct ddsi_proxy_reader *proxy_reader;
@@ -18,6 +18,7 @@
 #include "dds/ddsrt/string.h"
 #include "dds/ddsi/ddsi_domaingv.h"
 #include "dds/ddsi/ddsi_builtin_topic_if.h"
+#include "dds/ddsi/ddsi_content_filter.h"
 #include "dds/ddsi/ddsi_tkmap.h"
 #include "dds/ddsi/ddsi_serdata.h"
 #include "ddsi__entity.h"
@@ -392,6 +393,8 @@ void ddsi_deliver_historical_data (const struct ddsi_writer *wr, const struct dd
   struct ddsi_tkmap * const tkmap = gv->m_tkmap;
   struct ddsi_whc_sample_iter it;
   struct ddsi_whc_borrowed_sample sample;
+  /* borrowing samples from the WHC requires holding the writer lock */
+  ASSERT_MUTEX_HELD (&wr->e.lock);
   /* FIXME: should limit ourselves to what it is available because of durability history, not writer history */
   ddsi_whc_sample_iter_init (wr->whc, &it);
   while (ddsi_whc_sample_iter_borrow_next (&it, &sample))
@@ -810,6 +813,11 @@ static void ddsi_new_writer_guid_common_init (struct ddsi_writer *wr, const char
   wr->sent_bytes = 0;
   wr->time_throttled = 0;
   wr->time_retransmit = 0;
+  wr->replay_bytes = 0;
+  wr->num_readers_replaying = 0;
+  wr->num_readers_filtered = 0;
+  wr->content_filters_in_use = 0;
+  wr->content_filters = NULL;
   wr->force_md5_keyhash = 0;
   wr->alive = 1;
   wr->test_ignore_acknack = 0;
@@ -1140,6 +1148,7 @@ static void gc_delete_writer (struct ddsi_gcreq *gcreq)
   if (!ddsi_is_builtin_entityid (wr->e.guid.entityid, DDSI_VENDORID_ECLIPSE))
     ddsi_sedp_dispose_unregister_writer (wr);
   ddsi_whc_free (wr->whc);
+  ddsi_writer_content_filters_fini (wr);
   if (wr->status_cb)
     (wr->status_cb) (wr->status_cb_entity, NULL);
 
@@ -1479,7 +1488,7 @@ static void reader_init_network_partition (struct ddsi_reader *rd)
 }
 #endif /* DDS_HAS_NETWORK_PARTITIONS */
 
-dds_return_t ddsi_new_reader (struct ddsi_reader **rd_out, const struct ddsi_guid *guid, const struct ddsi_guid *group_guid, struct ddsi_participant *pp, const char *topic_name, const struct ddsi_sertype *type, const struct dds_qos *xqos, struct ddsi_rhc *rhc, ddsi_status_cb_t status_cb, void * status_entity, struct ddsi_psmx_locators_set *psmx_locators)
+dds_return_t ddsi_new_reader (struct ddsi_reader **rd_out, const struct ddsi_guid *guid, const struct ddsi_guid *group_guid, struct ddsi_participant *pp, const char *topic_name, const struct ddsi_sertype *type, const struct dds_qos *xqos, struct ddsi_rhc *rhc, ddsi_status_cb_t status_cb, void * status_entity, struct ddsi_psmx_locators_set *psmx_locators, const struct ddsi_content_filter_property *content_filter)
 {
   /* see ddsi_new_writer for commenets */
 
@@ -1524,6 +1533,7 @@ dds_return_t ddsi_new_reader (struct ddsi_reader **rd_out, const struct ddsi_gui
   rd->handle_as_transient_local = (rd->xqos->durability.kind == DDS_DURABILITY_TRANSIENT_LOCAL) ||
                                   (rd->e.guid.entityid.u == DDSI_ENTITYID_P2P_BUILTIN_PARTICIPANT_VOLATILE_SECURE_READER);
   rd->type = ddsi_sertype_ref (type);
+  rd->content_filter = content_filter ? ddsi_content_filter_property_dup (content_filter) : NULL;
   rd->request_keyhash = rd->type->request_keyhash;
   rd->init_acknack_count = 1;
   rd->num_writers = 0;
@@ -1537,6 +1547,10 @@ dds_return_t ddsi_new_reader (struct ddsi_reader **rd_out, const struct ddsi_gui
   rd->status_cb_entity = status_entity;
   rd->rhc = rhc;
   ddsrt_atomic_st64 (&rd->received_bytes, (uint64_t) 0);
+  ddsrt_atomic_st64 (&rd->rx_latency.samples, (uint64_t) 0);
+  ddsrt_atomic_st64 (&rd->rx_latency.kernel_to_recv, (uint64_t) 0);
+  ddsrt_atomic_st64 (&rd->rx_latency.recv_to_deliver, (uint64_t) 0);
+  ddsrt_atomic_st64 (&rd->rx_latency.deliver_to_store, (uint64_t) 0);
   assert (rd->xqos->present & DDSI_QP_LIVELINESS);
 
 #ifdef DDS_HAS_SECURITY
@@ -1612,6 +1626,7 @@ static void gc_delete_reader (struct ddsi_gcreq *gcreq)
     (rd->status_cb) (rd->status_cb_entity, NULL);
   }
   ddsi_sertype_unref ((struct ddsi_sertype *) rd->type);
+  ddsi_content_filter_property_free (rd->content_filter);
 
   ddsi_xqos_fini (rd->xqos);
   ddsrt_free (rd->xqos);
@@ -1650,6 +1665,18 @@ void ddsi_update_reader_qos (struct ddsi_reader *rd, const struct dds_qos *xqos)
   ddsrt_mutex_unlock (&rd->e.lock);
 }
 
+void ddsi_update_reader_content_filter (struct ddsi_reader *rd, const struct ddsi_content_filter_property *content_filter)
+{
+  ddsrt_mutex_lock (&rd->e.lock);
+  if (!ddsi_content_filter_property_equal (rd->content_filter, content_filter))
+  {
+    ddsi_content_filter_property_free (rd->content_filter);
+    rd->content_filter = content_filter ? ddsi_content_filter_property_dup (content_filter) : NULL;
+    ddsi_sedp_write_reader (rd);
+  }
+  ddsrt_mutex_unlock (&rd->e.lock);
+}
+
 struct ddsi_reader *ddsi_writer_first_in_sync_reader (struct ddsi_entity_index *entity_index, struct ddsi_entity_common *wrcmn, ddsrt_avl_iter_t *it)
 {
   assert (wrcmn->kind == DDSI_EK_WRITER);
@@ -15,6 +15,8 @@
 #include "dds/ddsrt/heap.h"
 #include "dds/ddsi/ddsi_proxy_participant.h"
 #include "dds/ddsi/ddsi_qosmatch.h"
+#include "dds/ddsi/ddsi_content_filter.h"
+#include "dds/ddsi/ddsi_serdata.h"
 #include "ddsi__entity.h"
 #include "ddsi__participant.h"
 #include "ddsi__security_omg.h"
@@ -33,8 +35,10 @@
 #include "ddsi__vendor.h"
 #include "ddsi__lat_estim.h"
 #include "ddsi__acknack.h"
+#include "ddsi__replay.h"
 #ifdef DDS_HAS_TYPE_DISCOVERY
 #include "ddsi__typelookup.h"
+#include "ddsi__sysdeps.h"
 #endif
 #include "dds/dds.h"
 
@@ -762,8 +766,147 @@ static bool connected_via_psmx (const struct ddsi_entity_common *a, const struct
   return false;
 }
 
+extern inline bool ddsi_proxy_readers_may_share_instance (const ddsi_guid_t *a, const ddsi_guid_t *b);
+
+static int32_t writer_content_filter_ref (struct ddsi_writer *wr, const struct ddsi_content_filter_property *prop, struct ddsi_content_filter *filter)
+{
+  /* Takes ownership of filter; proxy readers with equal filters share a slot so each
+     sample is evaluated only once for all of them */
+  const struct ddsi_content_filter_interface * const cfif = wr->e.gv->content_filter_interface;
+  int32_t slot = -1;
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  for (int32_t i = 0; i < DDSI_WRITER_MAX_CONTENT_FILTERS; i++)
+  {
+    if (!(wr->content_filters_in_use & (UINT64_C (1) << i)))
+    {
+      if (slot < 0)
+        slot = i;
+    }
+    else if (ddsi_content_filter_property_equal (wr->content_filters[i].prop, prop))
+    {
+      ddsi_content_filter_free (cfif, filter);
+      wr->content_filters[i].refc++;
+      return i;
+    }
+  }
+  if (slot < 0)
+  {
+    ddsi_content_filter_free (cfif, filter);
+    return -1;
+  }
+  if (wr->content_filters == NULL)
+    wr->content_filters = ddsrt_malloc (DDSI_WRITER_MAX_CONTENT_FILTERS * sizeof (*wr->content_filters));
+  struct ddsi_writer_content_filter * const f = &wr->content_filters[slot];
+  f->prop = ddsi_content_filter_property_dup (prop);
+  f->filter = filter;
+  f->refc = 1;
+  /* samples already written weren't evaluated with this filter, whatever the WHC has
+     stored for this slot is from a previous occupant */
+  f->valid_from = wr->seq + 1;
+  wr->content_filters_in_use |= UINT64_C (1) << slot;
+  return slot;
+}
+
+static void writer_content_filter_unref (struct ddsi_writer *wr, int32_t slot)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  if (slot < 0)
+    return;
+  struct ddsi_writer_content_filter * const f = &wr->content_filters[slot];
+  assert (f->refc > 0);
+  if (--f->refc == 0)
+  {
+    ddsi_content_filter_free (wr->e.gv->content_filter_interface, f->filter);
+    ddsi_content_filter_property_free (f->prop);
+    f->prop = NULL;
+    wr->content_filters_in_use &= ~(UINT64_C (1) << slot);
+  }
+}
+
+void ddsi_writer_content_filters_fini (struct ddsi_writer *wr)
+{
+  for (int32_t i = 0; i < DDSI_WRITER_MAX_CONTENT_FILTERS; i++)
+  {
+    if (wr->content_filters_in_use & (UINT64_C (1) << i))
+    {
+      ddsi_content_filter_free (wr->e.gv->content_filter_interface, wr->content_filters[i].filter);
+      ddsi_content_filter_property_free (wr->content_filters[i].prop);
+    }
+  }
+  wr->content_filters_in_use = 0;
+  ddsrt_free (wr->content_filters);
+  wr->content_filters = NULL;
+}
+
+uint64_t ddsi_writer_content_filters_eval (const struct ddsi_writer *wr, const struct ddsi_serdata *serdata)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  if (wr->content_filters_in_use == 0 || serdata->kind != SDK_DATA || serdata->statusinfo != 0)
+    return 0;
+  const struct ddsi_content_filter_interface * const cfif = wr->e.gv->content_filter_interface;
+  uint64_t rejects = 0;
+  uint64_t in_use = wr->content_filters_in_use;
+  for (uint32_t i = 0; in_use != 0; i++, in_use >>= 1)
+  {
+    if ((in_use & 1) && !ddsi_content_filter_accepts (cfif, wr->content_filters[i].filter, serdata))
+      rejects |= UINT64_C (1) << i;
+  }
+  return rejects;
+}
+
+static bool content_filter_slot_rejects (const struct ddsi_writer *wr, int32_t slot, const struct ddsi_whc_borrowed_sample *sample)
+{
+  const struct ddsi_writer_content_filter * const f = &wr->content_filters[slot];
+  if (sample->seq >= f->valid_from && sample->filter_rejects_valid)
+    return (sample->filter_rejects >> slot) & 1;
+  /* written before the writer knew the filter, or the WHC doesn't have the result */
+  if (sample->serdata->kind != SDK_DATA || sample->serdata->statusinfo != 0)
+    return false;
+  return !ddsi_content_filter_accepts (wr->e.gv->content_filter_interface, f->filter, sample->serdata);
+}
+
+static bool reader_content_filter_rejects (const struct ddsi_writer *wr, const struct ddsi_wr_prd_match *m, const struct ddsi_whc_borrowed_sample *sample)
+{
+  return m->content_filter_slot >= 0 && content_filter_slot_rejects (wr, m->content_filter_slot, sample);
+}
+
+bool ddsi_writer_content_filter_rejects (const struct ddsi_writer *wr, const struct ddsi_proxy_reader *prd, const struct ddsi_wr_prd_match *m, const struct ddsi_whc_borrowed_sample *sample)
+{
+  /* For Cyclone, a GAP for one reader may be a GAP for all readers in its DDSI instance,
+     so they all have to reject it. They are adjacent in wr->readers because the GUID
+     prefix comes first. Other implementations process it for the addressed reader only. */
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  if (m->content_filter_slot < 0)
+    return false;
+  if (!ddsi_vendor_is_eclipse (prd->c.vendor))
+    return reader_content_filter_rejects (wr, m, sample);
+  const ddsi_guid_t first = { .prefix = { .u = { m->prd_guid.prefix.u[0], 0, 0 } }, .entityid = { 0 } };
+  for (const struct ddsi_wr_prd_match *n = ddsrt_avl_lookup_succ_eq (&ddsi_wr_readers_treedef, &wr->readers, &first);
+       n != NULL && ddsi_proxy_readers_may_share_instance (&n->prd_guid, &m->prd_guid);
+       n = ddsrt_avl_find_succ (&ddsi_wr_readers_treedef, &wr->readers, n))
+  {
+    if (!n->via_psmx && !reader_content_filter_rejects (wr, n, sample))
+      return false;
+  }
+  return true;
+}
+
+bool ddsi_writer_content_filters_accept_all (const struct ddsi_writer *wr, const struct ddsi_whc_borrowed_sample *sample)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  uint64_t in_use = wr->content_filters_in_use;
+  for (int32_t i = 0; in_use != 0; i++, in_use >>= 1)
+  {
+    if ((in_use & 1) && content_filter_slot_rejects (wr, i, sample))
+      return false;
+  }
+  return true;
+}
+
 void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reader *prd, int64_t crypto_handle)
 {
+  struct ddsi_content_filter_property *content_filter_prop;
+  struct ddsi_content_filter *content_filter;
   struct ddsi_wr_prd_match *m = ddsrt_malloc (sizeof (*m));
   ddsrt_avl_ipath_t path;
   bool pretend_everything_acked;
@@ -776,6 +919,10 @@ void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reade
   m->all_have_replied_to_hb = 0;
   m->non_responsive_count = 0;
   m->rexmit_requests = 0;
+  m->replay_scheduled = 0;
+  m->replay_seq = 0;
+  m->replay_end = 0;
+  m->content_filter_slot = -1;
 #ifdef DDS_HAS_SECURITY
   m->crypto_handle = crypto_handle;
 #else
@@ -799,7 +946,18 @@ void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reade
   {
     pretend_everything_acked = false;
   }
+  /* the filter can be replaced by a discovery update, so copy it while holding the lock */
+  if (prd->content_filter == NULL || m->via_psmx)
+    content_filter_prop = NULL;
+  else
+    content_filter_prop = ddsi_content_filter_property_dup (prd->content_filter);
   ddsrt_mutex_unlock (&prd->e.lock);
+  /* Evaluating the filter only makes sense for samples that would otherwise be sent;
+     compile it before locking the writer, even if it turns out to be shared */
+  if (content_filter_prop == NULL)
+    content_filter = NULL;
+  else
+    content_filter = ddsi_content_filter_compile (wr->e.gv->content_filter_interface, wr->type, content_filter_prop);
   m->prev_acknack = 0;
   m->prev_nackfrag = 0;
   ddsi_lat_estim_init (&m->hb_to_ack_latency);
@@ -818,6 +976,8 @@ void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reade
     ELOGDISC (wr, "  ddsi_writer_add_connection(wr "PGUIDFMT" prd "PGUIDFMT") - already connected\n",
               PGUID (wr->e.guid), PGUID (prd->e.guid));
     ddsrt_mutex_unlock (&wr->e.lock);
+    ddsi_content_filter_free (wr->e.gv->content_filter_interface, content_filter);
+    ddsi_content_filter_property_free (content_filter_prop);
     ddsi_lat_estim_fini (&m->hb_to_ack_latency);
     ddsrt_free (m);
   }
@@ -825,12 +985,17 @@ void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reade
   {
     ELOGDISC (wr, "  ddsi_writer_add_connection(wr "PGUIDFMT" prd "PGUIDFMT") - ack seq %"PRIu64"\n",
               PGUID (wr->e.guid), PGUID (prd->e.guid), m->seq);
+    if (content_filter)
+      m->content_filter_slot = writer_content_filter_ref (wr, content_filter_prop, content_filter);
     ddsrt_avl_insert_ipath (&ddsi_wr_readers_treedef, &wr->readers, m, &path);
     wr->num_readers++;
     wr->num_reliable_readers += m->is_reliable;
+    wr->num_readers_filtered += (m->content_filter_slot >= 0);
     wr->num_readers_requesting_keyhash += prd->requests_keyhash ? 1 : 0;
     ddsi_rebuild_writer_addrset (wr);
+    ddsi_writer_start_history_replay (wr, m, prd);
     ddsrt_mutex_unlock (&wr->e.lock);
+    ddsi_content_filter_property_free (content_filter_prop);
 
     if (wr->status_cb)
     {
@@ -868,6 +1033,30 @@ void ddsi_writer_add_connection (struct ddsi_writer *wr, struct ddsi_proxy_reade
   }
 }
 
+void ddsi_writer_update_content_filter (struct ddsi_writer *wr, const struct ddsi_proxy_reader *prd, const struct ddsi_content_filter_property *content_filter)
+{
+  struct ddsi_content_filter *filter = NULL;
+  struct ddsi_wr_prd_match *m;
+  if (content_filter)
+    filter = ddsi_content_filter_compile (wr->e.gv->content_filter_interface, wr->type, content_filter);
+  ddsrt_mutex_lock (&wr->e.lock);
+  if ((m = ddsrt_avl_lookup (&ddsi_wr_readers_treedef, &wr->readers, &prd->e.guid)) == NULL || m->via_psmx)
+  {
+    ddsrt_mutex_unlock (&wr->e.lock);
+    ddsi_content_filter_free (wr->e.gv->content_filter_interface, filter);
+    return;
+  }
+  ELOGDISC (wr, "  ddsi_writer_update_content_filter(wr "PGUIDFMT" prd "PGUIDFMT") - %s\n",
+            PGUID (wr->e.guid), PGUID (prd->e.guid), content_filter ? content_filter->filter_expression : "(none)");
+  /* samples written from now on are evaluated against the new filter; those already in
+     the WHC and not yet acknowledged get evaluated when they are retransmitted */
+  wr->num_readers_filtered -= (m->content_filter_slot >= 0);
+  writer_content_filter_unref (wr, m->content_filter_slot);
+  m->content_filter_slot = filter ? writer_content_filter_ref (wr, content_filter, filter) : -1;
+  wr->num_readers_filtered += (m->content_filter_slot >= 0);
+  ddsrt_mutex_unlock (&wr->e.lock);
+}
+
 void ddsi_writer_add_local_connection (struct ddsi_writer *wr, struct ddsi_reader *rd)
 {
   struct ddsi_wr_rd_match *m = ddsrt_malloc (sizeof (*m));
@@ -1237,6 +1426,9 @@ void ddsi_writer_drop_connection (const struct ddsi_guid *wr_guid, const struct
       ddsrt_avl_delete (&ddsi_wr_readers_treedef, &wr->readers, m);
       wr->num_readers--;
       wr->num_reliable_readers -= m->is_reliable;
+      wr->num_readers_filtered -= (m->content_filter_slot >= 0);
+      writer_content_filter_unref (wr, m->content_filter_slot);
+      wr->num_readers_replaying -= (m->replay_seq != 0);
       wr->num_readers_requesting_keyhash -= prd->requests_keyhash ? 1 : 0;
       ddsi_rebuild_writer_addrset (wr);
       ddsi_remove_acked_messages (wr, &whcst, &deferred_free_list);
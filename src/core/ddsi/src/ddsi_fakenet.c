@@ -1299,6 +1299,23 @@ dds_return_t ddsi_fakenet_sendmsg (ddsrt_socket_t sock, const ddsrt_msghdr_t *ms
   return DDS_RETCODE_OK;
 }
 
+#if DDSRT_HAVE_MMSG
+dds_return_t ddsi_fakenet_sendmmsg (ddsrt_socket_t sock, ddsrt_mmsghdr_t *msgs, size_t vlen, int flags, size_t *nsent)
+{
+  dds_return_t rc = DDS_RETCODE_OK;
+  size_t n = 0;
+  while (n < vlen)
+  {
+    size_t sent;
+    if ((rc = ddsi_fakenet_sendmsg (sock, &msgs[n].msg_hdr, flags, &sent)) != DDS_RETCODE_OK)
+      break;
+    msgs[n++].msg_len = (unsigned) sent;
+  }
+  *nsent = n;
+  return (n > 0) ? DDS_RETCODE_OK : rc;
+}
+#endif
+
 dds_return_t ddsi_fakenet_recvmsg (const ddsrt_socket_ext_t *sockext, ddsrt_msghdr_t *msg, int flags, size_t *rcvd)
 {
   (void) flags;
@@ -1344,6 +1361,25 @@ dds_return_t ddsi_fakenet_recvmsg (const ddsrt_socket_ext_t *sockext, ddsrt_msgh
   return DDS_RETCODE_OK;
 }
 
+#if DDSRT_HAVE_MMSG
+dds_return_t ddsi_fakenet_recvmmsg (const ddsrt_socket_ext_t *sockext, ddsrt_mmsghdr_t *msgs, size_t vlen, int flags, size_t *nrcvd)
+{
+  // Fake sockets never block, so reading until the queue is empty is equivalent
+  // to MSG_WAITFORONE
+  dds_return_t rc = DDS_RETCODE_OK;
+  size_t n = 0;
+  while (n < vlen)
+  {
+    size_t rcvd;
+    if ((rc = ddsi_fakenet_recvmsg (sockext, &msgs[n].msg_hdr, flags, &rcvd)) != DDS_RETCODE_OK)
+      break;
+    msgs[n++].msg_len = (unsigned) rcvd;
+  }
+  *nrcvd = n;
+  return (n > 0) ? DDS_RETCODE_OK : rc;
+}
+#endif
+
 dds_return_t ddsi_fakenet_getsockopt (ddsrt_socket_t sock, int32_t level, int32_t optname, void *optval, socklen_t *optlen)
 {
   fakenet_lock_init ();
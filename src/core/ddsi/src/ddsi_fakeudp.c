@@ -26,7 +26,9 @@
 #define ddsrt_bind ddsi_fakenet_bind
 #define ddsrt_getsockname ddsi_fakenet_getsockname
 #define ddsrt_sendmsg ddsi_fakenet_sendmsg
+#define ddsrt_sendmmsg ddsi_fakenet_sendmmsg
 #define ddsrt_recvmsg ddsi_fakenet_recvmsg
+#define ddsrt_recvmmsg ddsi_fakenet_recvmmsg
 #define ddsrt_getsockopt ddsi_fakenet_getsockopt
 #define ddsrt_setsockopt ddsi_fakenet_setsockopt
 #define ddsrt_setsockreuse ddsi_fakenet_setsockreuse
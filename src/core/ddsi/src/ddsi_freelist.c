@@ -15,7 +15,9 @@
 #include "dds/ddsrt/heap.h"
 #include "dds/ddsrt/sync.h"
 #include "dds/ddsrt/threads.h"
+#include "dds/ddsrt/time.h"
 #include "dds/ddsi/ddsi_freelist.h"
+#include "ddsi__thread.h"
 
 #if DDSI_FREELIST_TYPE == DDSI_FREELIST_NONE
 
@@ -47,6 +49,11 @@ void *ddsi_freelist_pop (struct ddsi_freelist *fl)
   return NULL;
 }
 
+void ddsi_freelist_thread_cache_release (struct ddsi_thread_state *thrst)
+{
+  (void) thrst;
+}
+
 #elif DDSI_FREELIST_TYPE == DDSI_FREELIST_ATOMIC_LIFO
 
 void ddsi_freelist_init (struct ddsi_freelist *fl, uint32_t max, size_t linkoff)
@@ -57,46 +64,43 @@ void ddsi_freelist_init (struct ddsi_freelist *fl, uint32_t max, size_t linkoff)
   fl->linkoff = linkoff;
 }
 
+static void purge_caches (struct ddsi_freelist *fl, void (*xfree) (void *));
+
 void ddsi_freelist_fini (struct ddsi_freelist *fl, void (*free) (void *elem))
 {
   void *e;
+  purge_caches (fl, free);
   while ((e = ddsrt_atomic_lifo_pop (&fl->x, fl->linkoff)) != NULL)
     free (e);
 }
 
-bool ddsi_freelist_push (struct ddsi_freelist *fl, void *elem)
+static uint32_t freelist_push_shared (struct ddsi_freelist *fl, void **xs, uint32_t n, bool force)
 {
-  if (ddsrt_atomic_inc32_nv (&fl->count) <= fl->max)
+  /* pushes xs[n-1], xs[n-2], ... for as long as the freelist has room, returns
+     the number pushed */
+  uint32_t i;
+  for (i = 0; i < n; i++)
   {
-    ddsrt_atomic_lifo_push (&fl->x, elem, fl->linkoff);
-    return true;
-  }
-  else
-  {
-    ddsrt_atomic_dec32 (&fl->count);
-    return false;
+    if (ddsrt_atomic_inc32_nv (&fl->count) > fl->max && !force)
+    {
+      ddsrt_atomic_dec32 (&fl->count);
+      break;
+    }
+    ddsrt_atomic_lifo_push (&fl->x, xs[n - 1 - i], fl->linkoff);
   }
+  return i;
 }
 
-void *ddsi_freelist_pushmany (struct ddsi_freelist *fl, void *first, void *last, uint32_t n)
-{
-  ddsrt_atomic_add32 (&fl->count, n);
-  ddsrt_atomic_lifo_pushmany (&fl->x, first, last, fl->linkoff);
-  return NULL;
-}
-
-void *ddsi_freelist_pop (struct ddsi_freelist *fl)
+static uint32_t freelist_pop_shared (struct ddsi_freelist *fl, void **xs, uint32_t n)
 {
-  void *e;
-  if ((e = ddsrt_atomic_lifo_pop (&fl->x, fl->linkoff)) != NULL)
+  uint32_t i;
+  for (i = 0; i < n; i++)
   {
-    ddsrt_atomic_dec32(&fl->count);
-    return e;
-  }
-  else
-  {
-    return NULL;
+    if ((xs[i] = ddsrt_atomic_lifo_pop (&fl->x, fl->linkoff)) == NULL)
+      break;
+    ddsrt_atomic_dec32 (&fl->count);
   }
+  return i;
 }
 
 #elif DDSI_FREELIST_TYPE == DDSI_FREELIST_DOUBLE
@@ -121,16 +125,14 @@ void ddsi_freelist_init (struct ddsi_freelist *fl, uint32_t max, size_t linkoff)
   fl->linkoff = linkoff;
 }
 
-static void *get_next (const struct ddsi_freelist *fl, const void *e)
-{
-  return *((void **) ((char *)e + fl->linkoff));
-}
+static void purge_caches (struct ddsi_freelist *fl, void (*xfree) (void *));
 
 void ddsi_freelist_fini (struct ddsi_freelist *fl, void (*xfree) (void *))
 {
   int i;
   uint32_t j;
   struct ddsi_freelist_m *m;
+  purge_caches (fl, xfree);
   ddsrt_mutex_destroy (&fl->lock);
   for (i = 0; i < NN_FREELIST_NPAR; i++)
   {
@@ -190,23 +192,20 @@ static int lock_inner (struct ddsi_freelist *fl)
   return k;
 }
 
-bool ddsi_freelist_push (struct ddsi_freelist *fl, void *elem)
+static bool push_locked (struct ddsi_freelist *fl, int k, void *elem, bool force)
 {
-  int k = lock_inner (fl);
   if (fl->inner[k].count < NN_FREELIST_MAGSIZE)
   {
     fl->inner[k].m->x[fl->inner[k].count++] = elem;
-    ddsrt_mutex_unlock (&fl->inner[k].lock);
     return true;
   }
   else
   {
     struct ddsi_freelist_m *m;
     ddsrt_mutex_lock (&fl->lock);
-    if (fl->count + NN_FREELIST_MAGSIZE >= fl->max)
+    if (fl->count + NN_FREELIST_MAGSIZE >= fl->max && !force)
     {
       ddsrt_mutex_unlock (&fl->lock);
-      ddsrt_mutex_unlock (&fl->inner[k].lock);
       return false;
     }
     m = fl->inner[k].m;
@@ -223,35 +222,15 @@ bool ddsi_freelist_push (struct ddsi_freelist *fl, void *elem)
     }
     ddsrt_mutex_unlock (&fl->lock);
     fl->inner[k].m->x[fl->inner[k].count++] = elem;
-    ddsrt_mutex_unlock (&fl->inner[k].lock);
     return true;
   }
 }
 
-void *ddsi_freelist_pushmany (struct ddsi_freelist *fl, void *first, void *last, uint32_t n)
+static void *pop_locked (struct ddsi_freelist *fl, int k)
 {
-  void *m = first;
-  (void)last;
-  (void)n;
-  while (m)
-  {
-    void *mnext = get_next (fl, m);
-    if (!ddsi_freelist_push (fl, m)) {
-      return m;
-    }
-    m = mnext;
-  }
-  return NULL;
-}
-
-void *ddsi_freelist_pop (struct ddsi_freelist *fl)
-{
-  int k = lock_inner (fl);
   if (fl->inner[k].count > 0)
   {
-    void *e = fl->inner[k].m->x[--fl->inner[k].count];
-    ddsrt_mutex_unlock (&fl->inner[k].lock);
-    return e;
+    return fl->inner[k].m->x[--fl->inner[k].count];
   }
   else
   {
@@ -259,12 +238,10 @@ void *ddsi_freelist_pop (struct ddsi_freelist *fl)
     if (fl->mlist == NULL)
     {
       ddsrt_mutex_unlock (&fl->lock);
-      ddsrt_mutex_unlock (&fl->inner[k].lock);
       return NULL;
     }
     else
     {
-      void *e;
       fl->inner[k].m->next = fl->emlist;
       fl->emlist = fl->inner[k].m;
       fl->inner[k].m = fl->mlist;
@@ -272,11 +249,221 @@ void *ddsi_freelist_pop (struct ddsi_freelist *fl)
       fl->count -= NN_FREELIST_MAGSIZE;
       ddsrt_mutex_unlock (&fl->lock);
       fl->inner[k].count = NN_FREELIST_MAGSIZE;
-      e = fl->inner[k].m->x[--fl->inner[k].count];
-      ddsrt_mutex_unlock (&fl->inner[k].lock);
-      return e;
+      return fl->inner[k].m->x[--fl->inner[k].count];
     }
   }
 }
 
+static uint32_t freelist_push_shared (struct ddsi_freelist *fl, void **xs, uint32_t n, bool force)
+{
+  /* pushes xs[n-1], xs[n-2], ... for as long as the freelist has room, returns
+     the number pushed */
+  int k = lock_inner (fl);
+  uint32_t i = 0;
+  while (i < n && push_locked (fl, k, xs[n - 1 - i], force))
+    i++;
+  ddsrt_mutex_unlock (&fl->inner[k].lock);
+  return i;
+}
+
+static uint32_t freelist_pop_shared (struct ddsi_freelist *fl, void **xs, uint32_t n)
+{
+  int k = lock_inner (fl);
+  uint32_t i = 0;
+  while (i < n && (xs[i] = pop_locked (fl, k)) != NULL)
+    i++;
+  ddsrt_mutex_unlock (&fl->inner[k].lock);
+  return i;
+}
+
 #endif /* DDSI_FREELIST_TYPE */
+
+#if DDSI_FREELIST_TYPE != DDSI_FREELIST_NONE
+
+static void *get_next (const struct ddsi_freelist *fl, const void *e)
+{
+  return *((void **) ((char *)e + fl->linkoff));
+}
+
+/* Incremented (with thread_states.lock held) by each purge of the thread caches */
+static ddsrt_atomic_uint32_t freelist_purge_gen = DDSRT_ATOMIC_UINT32_INIT (0);
+
+static struct ddsi_freelist_cache *get_cache (void)
+{
+  /* Only threads with a thread state get a cache, and no new cache gets
+     attached to it once it has been reaped. */
+  struct ddsi_thread_state * const thrst = tsd_thread_state;
+  struct ddsi_freelist_cache *c;
+  if (thrst == NULL || (thrst->state != DDSI_THREAD_STATE_ALIVE && thrst->state != DDSI_THREAD_STATE_LAZILY_CREATED))
+    return NULL;
+  if ((c = ddsrt_atomic_ldvoidp (&thrst->freelist_cache)) == NULL)
+  {
+    if ((c = ddsrt_malloc_s (sizeof (*c))) == NULL)
+      return NULL;
+    ddsrt_atomic_st32 (&c->busy, 0);
+    c->gen = ddsrt_atomic_ld32 (&freelist_purge_gen);
+    c->evict = 0;
+    for (uint32_t i = 0; i < DDSI_FREELIST_CACHE_NSLOTS; i++)
+    {
+      c->slots[i].fl = NULL;
+      c->slots[i].count = 0;
+    }
+    ddsrt_atomic_stvoidp (&thrst->freelist_cache, c);
+  }
+  return c;
+}
+
+static void cache_enter (struct ddsi_freelist_cache *c)
+{
+  /* Either purge_caches sees the cache is busy and waits, or this thread sees
+     the new generation and waits for the purge to complete before touching
+     the slots */
+  ddsrt_atomic_st32 (&c->busy, 1);
+  ddsrt_atomic_fence ();
+  while (ddsrt_atomic_ld32 (&freelist_purge_gen) != c->gen)
+  {
+    ddsrt_atomic_st32 (&c->busy, 0);
+    ddsrt_mutex_lock (&thread_states.lock);
+    c->gen = ddsrt_atomic_ld32 (&freelist_purge_gen);
+    ddsrt_mutex_unlock (&thread_states.lock);
+    ddsrt_atomic_st32 (&c->busy, 1);
+    ddsrt_atomic_fence ();
+  }
+}
+
+static void cache_leave (struct ddsi_freelist_cache *c)
+{
+  ddsrt_atomic_fence_rel ();
+  ddsrt_atomic_st32 (&c->busy, 0);
+}
+
+static struct ddsi_freelist_cache_slot *get_cache_slot (struct ddsi_freelist_cache *c, struct ddsi_freelist *fl)
+{
+  struct ddsi_freelist_cache_slot *s = NULL;
+  for (uint32_t i = 0; i < DDSI_FREELIST_CACHE_NSLOTS; i++)
+  {
+    if (c->slots[i].fl == fl)
+      return &c->slots[i];
+    else if (c->slots[i].fl == NULL && s == NULL)
+      s = &c->slots[i];
+  }
+  if (s == NULL)
+  {
+    /* Round-robin eviction, the cached elements go back to their own freelist
+       even if it is full, there is no other way of getting rid of them */
+    s = &c->slots[c->evict];
+    c->evict = (c->evict + 1) % DDSI_FREELIST_CACHE_NSLOTS;
+    (void) freelist_push_shared (s->fl, s->x, s->count, true);
+    s->count = 0;
+  }
+  s->fl = fl;
+  return s;
+}
+
+bool ddsi_freelist_push (struct ddsi_freelist *fl, void *elem)
+{
+  struct ddsi_freelist_cache *c;
+  if ((c = get_cache ()) == NULL)
+    return freelist_push_shared (fl, &elem, 1, false) == 1;
+  cache_enter (c);
+  struct ddsi_freelist_cache_slot * const s = get_cache_slot (c, fl);
+  if (s->count == DDSI_FREELIST_CACHE_SIZE)
+    s->count -= freelist_push_shared (fl, s->x + DDSI_FREELIST_CACHE_SIZE / 2, DDSI_FREELIST_CACHE_SIZE / 2, false);
+  const bool ok = (s->count < DDSI_FREELIST_CACHE_SIZE);
+  if (ok)
+    s->x[s->count++] = elem;
+  cache_leave (c);
+  return ok;
+}
+
+void *ddsi_freelist_pushmany (struct ddsi_freelist *fl, void *first, void *last, uint32_t n)
+{
+  void *m = first;
+  (void) last;
+  (void) n;
+  while (m)
+  {
+    void *mnext = get_next (fl, m);
+    if (!ddsi_freelist_push (fl, m))
+      return m;
+    m = mnext;
+  }
+  return NULL;
+}
+
+void *ddsi_freelist_pop (struct ddsi_freelist *fl)
+{
+  struct ddsi_freelist_cache *c;
+  void *e = NULL;
+  if ((c = get_cache ()) == NULL)
+    return (freelist_pop_shared (fl, &e, 1) == 1) ? e : NULL;
+  cache_enter (c);
+  struct ddsi_freelist_cache_slot * const s = get_cache_slot (c, fl);
+  if (s->count == 0)
+    s->count = freelist_pop_shared (fl, s->x, DDSI_FREELIST_CACHE_SIZE / 2);
+  if (s->count > 0)
+    e = s->x[--s->count];
+  cache_leave (c);
+  return e;
+}
+
+static void purge_caches (struct ddsi_freelist *fl, void (*xfree) (void *))
+{
+  /* The freelist is no longer in use, so the only remaining references to it
+     are in the caches of the threads that used it.  Once a cache is no longer
+     busy, its owner won't touch it again until it has caught up with the new
+     generation, and that requires the lock held here. */
+  if (ddsrt_atomic_ldvoidp (&thread_states.thread_states_head) == NULL)
+    return;
+  ddsrt_mutex_lock (&thread_states.lock);
+  ddsrt_atomic_inc32 (&freelist_purge_gen);
+  ddsrt_atomic_fence ();
+  for (struct ddsi_thread_states_list *cur = ddsrt_atomic_ldvoidp (&thread_states.thread_states_head); cur; cur = cur->next)
+  {
+    for (uint32_t i = 0; i < DDSI_THREAD_STATE_BATCH; i++)
+    {
+      struct ddsi_freelist_cache * const c = ddsrt_atomic_ldvoidp (&cur->thrst[i].freelist_cache);
+      if (c == NULL)
+        continue;
+      while (ddsrt_atomic_ld32 (&c->busy))
+        dds_sleepfor (DDS_USECS (10));
+      ddsrt_atomic_fence_acq ();
+      for (uint32_t j = 0; j < DDSI_FREELIST_CACHE_NSLOTS; j++)
+      {
+        struct ddsi_freelist_cache_slot * const s = &c->slots[j];
+        if (s->fl != fl)
+          continue;
+        while (s->count > 0)
+          xfree (s->x[--s->count]);
+        s->fl = NULL;
+      }
+    }
+  }
+  ddsrt_mutex_unlock (&thread_states.lock);
+}
+
+void ddsi_freelist_thread_cache_release (struct ddsi_thread_state *thrst)
+{
+  /* Normally called by the owning thread when it is done using freelists, else
+     once it has terminated.  The cache remains visible to purge_caches until
+     it has been flushed, so the freelists it references still exist. */
+  struct ddsi_freelist_cache * const c = ddsrt_atomic_ldvoidp (&thrst->freelist_cache);
+  if (c == NULL)
+    return;
+  cache_enter (c);
+  for (uint32_t j = 0; j < DDSI_FREELIST_CACHE_NSLOTS; j++)
+  {
+    struct ddsi_freelist_cache_slot * const s = &c->slots[j];
+    if (s->fl != NULL)
+      (void) freelist_push_shared (s->fl, s->x, s->count, true);
+    s->fl = NULL;
+    s->count = 0;
+  }
+  cache_leave (c);
+  ddsrt_mutex_lock (&thread_states.lock);
+  ddsrt_atomic_stvoidp (&thrst->freelist_cache, NULL);
+  ddsrt_mutex_unlock (&thread_states.lock);
+  ddsrt_free (c);
+}
+
+#endif
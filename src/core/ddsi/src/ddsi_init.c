@@ -95,6 +95,61 @@ static bool transport_selector_is_udp_like (enum ddsi_transport_selector transpo
     ;
 }
 
+static bool use_multiple_receive_threads (const struct ddsi_config *cfg)
+{
+  switch (cfg->multiple_recv_threads)
+  {
+    case DDSI_BOOLDEF_FALSE:
+    case DDSI_BOOLDEF_DEFAULT:
+      // Too many people run into trouble with firewalls blocking the packets
+      // Cyclone sends to itself for interrupting the blocking reads.  So
+      // default to a single thread and multiplexing.
+      //
+      // (One could also consider multiple threads, but still doing select+read
+      // but having fewer threads is arguably a good thing in itself.)
+      return false;
+    case DDSI_BOOLDEF_TRUE:
+      return true;
+  }
+  assert (0);
+  return false;
+}
+
+static bool use_shared_data_port (const struct ddsi_domaingv *gv, uint32_t port_disc, uint32_t port_data)
+{
+  // Multiple sockets for the unicast data port only make sense if there is a
+  // separate receive thread for that port to begin with (see
+  // setup_and_start_recv_threads) and that port is not also used for discovery.
+  // The fake UDP network has no notion of distributing datagrams over sockets.
+  return gv->config.recv_uc_sockets > 1 &&
+    (gv->config.transport_selector == DDSI_TRANS_UDP || gv->config.transport_selector == DDSI_TRANS_UDP6) &&
+    gv->config.many_sockets_mode == DDSI_MSM_SINGLE_UNICAST &&
+    use_multiple_receive_threads (&gv->config) &&
+    port_data != 0 && port_data != port_disc;
+}
+
+static void make_uc_data_shards (struct ddsi_domaingv *gv, const struct ddsi_tran_qos *qos, uint32_t port_data)
+{
+  assert (gv->n_data_conn_uc_shards == 0);
+  const struct ddsi_tran_qos shard_qos = {
+    .m_purpose = qos->m_purpose,
+    .m_diffserv = qos->m_diffserv,
+    .m_interface = qos->m_interface,
+    .m_bind_to_any = qos->m_bind_to_any,
+    .m_port_sharing = DDSI_TRAN_PORT_SHARE_JOIN
+  };
+  while (gv->n_data_conn_uc_shards < (uint32_t) gv->config.recv_uc_sockets - 1)
+  {
+    struct ddsi_tran_conn **conn = &gv->data_conn_uc_shards[gv->n_data_conn_uc_shards];
+    if (ddsi_factory_create_conn (conn, gv->m_factory, port_data, &shard_qos) != DDS_RETCODE_OK)
+    {
+      GVWARNING ("rtps_init: failed to create additional socket for unicast data port %"PRIu32", continuing with %"PRIu32"\n", port_data, gv->n_data_conn_uc_shards + 1);
+      break;
+    }
+    gv->n_data_conn_uc_shards++;
+  }
+}
+
 static enum make_uc_sockets_ret make_uc_sockets (struct ddsi_domaingv *gv, uint32_t * pdisc, uint32_t * pdata, int ppid)
 {
   dds_return_t rc;
@@ -132,6 +187,7 @@ static enum make_uc_sockets_ret make_uc_sockets (struct ddsi_domaingv *gv, uint3
     return MUSRET_INVALID_PORTS;
 
   const bool random_disc_port = (*pdisc == DDSI_TRAN_RANDOM_PORT_NUMBER);
+  const bool shared_data_port = !per_interface_uc && use_shared_data_port (gv, *pdisc, *pdata);
   for (int i = 0; i < n_uc_conns; i++)
   {
     if (per_interface_uc && !ddsi_factory_supports (gv->m_factory, gv->interfaces[i].loc.kind))
@@ -155,12 +211,21 @@ static enum make_uc_sockets_ret make_uc_sockets (struct ddsi_domaingv *gv, uint3
       if (*pdata == DDSI_TRAN_RANDOM_PORT_NUMBER)
         *pdata = *pdisc;
     }
-    else
+    else if (!shared_data_port)
     {
       rc = ddsi_factory_create_conn (&gv->data_conn_uc[i], gv->m_factory, *pdata, &qos);
       if (rc != DDS_RETCODE_OK)
         goto fail;
     }
+    else
+    {
+      struct ddsi_tran_qos data_qos = qos;
+      data_qos.m_port_sharing = DDSI_TRAN_PORT_SHARE_FIRST;
+      rc = ddsi_factory_create_conn (&gv->data_conn_uc[i], gv->m_factory, *pdata, &data_qos);
+      if (rc != DDS_RETCODE_OK)
+        goto fail;
+      make_uc_data_shards (gv, &qos, ddsi_conn_port (gv->data_conn_uc[i]));
+    }
   }
   ddsi_conn_locator (gv->disc_conn_uc[0], &gv->loc_meta_uc);
   ddsi_conn_locator (gv->data_conn_uc[0], &gv->loc_default_uc);
@@ -462,7 +527,12 @@ static int set_ext_address_and_mask (struct ddsi_domaingv *gv)
 
 static int check_thread_properties (const struct ddsi_domaingv *gv)
 {
-  static const char *fixed[] = { "recv", "recvUC", "recvMC", "tev", "gc", "lease", "dq.builtins", "xmit.user", "dq.user", "debmon", "fsm", NULL };
+  static const char *fixed[] = {
+    "recv", "recvUC", "recvUC1", "recvUC2", "recvUC3", "recvUC4", "recvUC5", "recvUC6", "recvUC7", "recvMC",
+    "tev", "gc", "lease", "dq.builtins", "xmit.user",
+    "dq.user", "dq.user1", "dq.user2", "dq.user3", "dq.user4", "dq.user5", "dq.user6", "dq.user7",
+    "debmon", "fsm", NULL
+  };
   const struct ddsi_config_thread_properties_listelem *e;
   int ok = 1, i;
   for (e = gv->config.thread_properties; e; e = e->next)
@@ -912,26 +982,6 @@ static void make_special_types (struct ddsi_domaingv *gv)
   free_special_types (gv);
 }
 
-static bool use_multiple_receive_threads (const struct ddsi_config *cfg)
-{
-  switch (cfg->multiple_recv_threads)
-  {
-    case DDSI_BOOLDEF_FALSE:
-    case DDSI_BOOLDEF_DEFAULT:
-      // Too many people run into trouble with firewalls blocking the packets
-      // Cyclone sends to itself for interrupting the blocking reads.  So
-      // default to a single thread and multiplexing.
-      //
-      // (One could also consider multiple threads, but still doing select+read
-      // but having fewer threads is arguably a good thing in itself.)
-      return false;
-    case DDSI_BOOLDEF_TRUE:
-      return true;
-  }
-  assert (0);
-  return false;
-}
-
 static int setup_and_start_recv_threads (struct ddsi_domaingv *gv)
 {
   const bool multi_recv_thr = use_multiple_receive_threads (&gv->config);
@@ -945,11 +995,15 @@ static int setup_and_start_recv_threads (struct ddsi_domaingv *gv)
     gv->recv_threads[i].arg.u.single.loc = NULL;
     gv->recv_threads[i].arg.u.single.conn = NULL;
   }
+  static const char *uc_shard_names[] = { "recvUC", "recvUC1", "recvUC2", "recvUC3", "recvUC4", "recvUC5", "recvUC6", "recvUC7" };
+  DDSRT_STATIC_ASSERT (sizeof (uc_shard_names) / sizeof (uc_shard_names[0]) == DDSI_MAX_RECV_UC_SOCKETS);
 
   /* First thread always uses a waitset and gobbles up all sockets not handled by dedicated threads - FIXME: DDSI_MSM_NO_UNICAST mode with UDP probably doesn't even need this one to use a waitset */
   gv->n_recv_threads = 1;
   gv->recv_threads[0].name = "recv";
   gv->recv_threads[0].arg.mode = DDSI_RTM_MANY;
+  gv->recv_threads[0].arg.u.many.ws = NULL;
+  gv->recv_threads[0].arg.u.many.conn = NULL;
   if (gv->m_factory->m_connless && gv->config.many_sockets_mode != DDSI_MSM_NO_UNICAST && multi_recv_thr)
   {
     bool allow_asm_mc = false;
@@ -970,7 +1024,7 @@ static int setup_and_start_recv_threads (struct ddsi_domaingv *gv)
     for (int i = 1; i < gv->n_interfaces && single_data_uc; i++)
       if (gv->data_conn_uc[i] != NULL && gv->data_conn_uc[i] != gv->data_conn_uc[0])
         single_data_uc = false;
-    if (gv->config.many_sockets_mode == DDSI_MSM_SINGLE_UNICAST && single_data_uc)
+    if (gv->config.many_sockets_mode == DDSI_MSM_SINGLE_UNICAST && single_data_uc && gv->n_data_conn_uc_shards == 0)
     {
       /* No per-participant sockets => handle data unicasts on a separate thread as well */
       gv->recv_threads[gv->n_recv_threads].name = "recvUC";
@@ -980,6 +1034,20 @@ static int setup_and_start_recv_threads (struct ddsi_domaingv *gv)
       ddsi_conn_disable_multiplexing (gv->data_conn_uc[0]);
       gv->n_recv_threads++;
     }
+    else if (gv->config.many_sockets_mode == DDSI_MSM_SINGLE_UNICAST && single_data_uc)
+    {
+      /* Same, but with the unicast data port shared by multiple sockets, one thread per
+         socket.  These can't be triggered by sending a packet to the port because the
+         kernel decides which socket receives it, so these use a waitset */
+      for (uint32_t i = 0; i <= gv->n_data_conn_uc_shards; i++)
+      {
+        gv->recv_threads[gv->n_recv_threads].name = uc_shard_names[i];
+        gv->recv_threads[gv->n_recv_threads].arg.mode = DDSI_RTM_MANY;
+        gv->recv_threads[gv->n_recv_threads].arg.u.many.ws = NULL;
+        gv->recv_threads[gv->n_recv_threads].arg.u.many.conn = (i == 0) ? gv->data_conn_uc[0] : gv->data_conn_uc_shards[i - 1];
+        gv->n_recv_threads++;
+      }
+    }
   }
   assert (gv->n_recv_threads <= MAX_RECV_THREADS);
 
@@ -989,11 +1057,12 @@ static int setup_and_start_recv_threads (struct ddsi_domaingv *gv)
     /* We create the rbufpool for the receive thread, and so we'll
        become the initial owner thread. The receive thread will change
        it before it does anything with it. */
-    if ((gv->recv_threads[i].arg.rbpool = ddsi_rbufpool_new (&gv->logconfig, gv->config.rbuf_size, gv->config.rmsg_chunk_size)) == NULL)
+    if ((gv->recv_threads[i].arg.rbpool = ddsi_rbufpool_new_preallocated (&gv->logconfig, gv->config.rbuf_size, gv->config.rmsg_chunk_size, gv->config.rbufpool_size, gv->config.rbufpool_hugepages)) == NULL)
     {
       GVERROR ("rtps_init: can't allocate receive buffer pool for thread %s\n", gv->recv_threads[i].name);
       goto fail;
     }
+    ddsi_rbufpool_set_pin_limits (gv->recv_threads[i].arg.rbpool, gv->config.zerocopy_receive_threshold, gv->config.zerocopy_receive_limit);
     if (gv->recv_threads[i].arg.mode == DDSI_RTM_MANY)
     {
       if ((gv->recv_threads[i].arg.u.many.ws = ddsi_sock_waitset_new ()) == NULL)
@@ -1071,6 +1140,10 @@ static void free_conns (struct ddsi_domaingv *gv)
 {
   // Depending on settings, various "conn"s can alias others, this makes sure we free each one only once
   // FIXME: perhaps store them in a table instead?
+  for (uint32_t i = 0; i < gv->n_data_conn_uc_shards; i++)
+    ddsi_conn_free (gv->data_conn_uc_shards[i]);
+  gv->n_data_conn_uc_shards = 0;
+
   struct ddsi_tran_conn * cs[2 + 4 * MAX_XMIT_CONNS] = { gv->disc_conn_mc, gv->data_conn_mc };
   for (size_t i = 0; i < MAX_XMIT_CONNS; i++)
   {
@@ -1206,6 +1279,7 @@ int ddsi_init (struct ddsi_domaingv *gv, struct ddsi_psmx_instance_locators *psm
     gv->xmit_conns_meta[i] = NULL;
     gv->xmit_conns_data[i] = NULL;
   }
+  gv->n_data_conn_uc_shards = 0;
   gv->listener = NULL;
   gv->debmon = NULL;
   gv->n_recv_threads = 0;
@@ -1239,7 +1313,7 @@ int ddsi_init (struct ddsi_domaingv *gv, struct ddsi_psmx_instance_locators *psm
     case DDSI_TRANS_UDP6:
       gv->config.publish_uc_locators = 1;
       gv->config.enable_uc_locators = 1;
-      if (ddsi_udp_init (gv) < 0)
+      if ((gv->config.transport_io_uring ? ddsi_uringudp_init (gv) : ddsi_udp_init (gv)) < 0)
         goto err_udp_tcp_init;
       gv->m_factory = ddsi_factory_find (gv, gv->config.transport_selector == DDSI_TRANS_UDP ? "udp" : "udp6");
       break;
@@ -1744,13 +1818,24 @@ int ddsi_init (struct ddsi_domaingv *gv, struct ddsi_psmx_instance_locators *psm
   gv->gcreq_queue = ddsi_gcreq_queue_new (gv);
 
   ddsrt_atomic_st32 (&gv->rtps_keepgoing, 1);
+  ddsrt_atomic_st64 (&gv->whc_unacked_bytes, 0);
+  ddsrt_atomic_st32 (&gv->whc_unacked_writers, 0);
 
   // sendq thread is started if a DW is created with non-zero latency
   gv->sendq_running = false;
   ddsrt_mutex_init (&gv->sendq_running_lock);
 
   gv->builtins_dqueue = ddsi_dqueue_new ("builtins", gv, gv->config.delivery_queue_maxsamples, ddsi_builtins_dqueue_handler, NULL);
-  gv->user_dqueue = ddsi_dqueue_new ("user", gv, gv->config.delivery_queue_maxsamples, ddsi_user_dqueue_handler, NULL);
+  gv->n_user_dqueues = (uint32_t) gv->config.delivery_queues;
+  for (uint32_t i = 0; i < gv->n_user_dqueues; i++)
+  {
+    char name[16];
+    if (i == 0)
+      (void) snprintf (name, sizeof (name), "user");
+    else
+      (void) snprintf (name, sizeof (name), "user%"PRIu32, i);
+    gv->user_dqueues[i] = ddsi_dqueue_new (name, gv, gv->config.delivery_queue_maxsamples, ddsi_user_dqueue_handler, NULL);
+  }
 
   if (reset_deaf_mute_time.v < DDS_NEVER)
     ddsi_qxev_callback (gv->xevents, reset_deaf_mute_time, reset_deaf_mute, NULL, 0, false);
@@ -1847,7 +1932,8 @@ int ddsi_start (struct ddsi_domaingv *gv)
   ddsi_gcreq_queue_start (gv->gcreq_queue);
 
   ddsi_dqueue_start (gv->builtins_dqueue);
-  ddsi_dqueue_start (gv->user_dqueue);
+  for (uint32_t i = 0; i < gv->n_user_dqueues; i++)
+    ddsi_dqueue_start (gv->user_dqueues[i]);
 
   if (ddsi_xeventq_start (gv->xevents, NULL) < 0)
     return -1;
@@ -2054,7 +2140,8 @@ void ddsi_fini (struct ddsi_domaingv *gv)
      has ended, so now we can drain the delivery queues to end up with
      the expected reference counts all over the radmin thingummies. */
   ddsi_dqueue_free (gv->builtins_dqueue);
-  ddsi_dqueue_free (gv->user_dqueue);
+  for (uint32_t i = 0; i < gv->n_user_dqueues; i++)
+    ddsi_dqueue_free (gv->user_dqueues[i]);
 
 #ifdef DDS_HAS_SECURITY
   ddsi_omg_security_deinit (gv->security_context);
@@ -13,8 +13,10 @@
 #include <stddef.h>
 
 #include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/mh3.h"
 #include "dds/ddsi/ddsi_domaingv.h"
 #include "dds/ddsi/ddsi_builtin_topic_if.h"
+#include "dds/ddsi/ddsi_content_filter.h"
 #include "ddsi__addrset.h"
 #include "ddsi__entity.h"
 #include "ddsi__endpoint_match.h"
@@ -263,6 +265,14 @@ static enum ddsi_reorder_mode get_proxy_writer_reorder_mode(const ddsi_entityid_
   return DDSI_REORDER_MODE_MONOTONICALLY_INCREASING;
 }
 
+struct ddsi_dqueue *ddsi_user_dqueue_for_proxy_writer (const struct ddsi_domaingv *gv, const ddsi_guid_t *guid)
+{
+  if (gv->n_user_dqueues == 1)
+    return gv->user_dqueues[0];
+  const uint32_t h = ddsrt_mh3 (guid, sizeof (*guid), 0);
+  return gv->user_dqueues[h % gv->n_user_dqueues];
+}
+
 dds_return_t ddsi_new_proxy_writer (struct ddsi_proxy_writer **proxy_writer, struct ddsi_domaingv *gv, const struct ddsi_guid *ppguid, const struct ddsi_guid *guid, struct ddsi_addrset *as, const ddsi_plist_t *plist, struct ddsi_dqueue *dqueue, struct ddsi_xeventq *evq, ddsrt_wctime_t timestamp, ddsi_seqno_t seq)
 {
   struct ddsi_proxy_participant *proxypp;
@@ -364,6 +374,7 @@ dds_return_t ddsi_new_proxy_writer (struct ddsi_proxy_writer **proxy_writer, str
   {
     pwr->defrag = ddsi_defrag_new (&gv->logconfig, DDSI_DEFRAG_DROP_OLDEST, gv->config.defrag_unreliable_maxsamples);
   }
+  ddsi_defrag_set_contiguous_threshold (pwr->defrag, gv->config.defrag_contiguous_threshold);
   reorder_mode = get_proxy_writer_reorder_mode(pwr->e.guid.entityid, isreliable);
   pwr->reorder = ddsi_reorder_new (&gv->logconfig, reorder_mode, gv->config.primary_reorder_maxsamples, gv->config.late_ack_mode);
 
@@ -695,6 +706,7 @@ dds_return_t ddsi_new_proxy_reader (struct ddsi_proxy_reader **proxy_reader, str
   prd->is_fict_trans_reader = 0;
   prd->receive_buffer_size = proxypp->receive_buffer_size;
   prd->requests_keyhash = (plist->present & PP_CYCLONE_REQUESTS_KEYHASH) && plist->cyclone_requests_keyhash;
+  prd->content_filter = (plist->present & PP_CONTENT_FILTER_PROPERTY) ? ddsi_content_filter_property_dup (&plist->content_filter_property) : NULL;
   if (plist->present & PP_CYCLONE_REDUNDANT_NETWORKING)
     prd->redundant_networking = (plist->cyclone_redundant_networking != 0);
   else
@@ -731,10 +743,11 @@ dds_return_t ddsi_new_proxy_reader (struct ddsi_proxy_reader **proxy_reader, str
   }
 }
 
-void ddsi_update_proxy_reader (struct ddsi_proxy_reader *prd, ddsi_seqno_t seq, struct ddsi_addrset *as, const struct dds_qos *xqos, ddsrt_wctime_t timestamp)
+void ddsi_update_proxy_reader (struct ddsi_proxy_reader *prd, ddsi_seqno_t seq, struct ddsi_addrset *as, const struct dds_qos *xqos, const struct ddsi_content_filter_property *content_filter, ddsrt_wctime_t timestamp)
 {
   struct ddsi_prd_wr_match * m;
   ddsi_guid_t wrguid;
+  bool content_filter_changed = false;
 
   memset (&wrguid, 0, sizeof (wrguid));
 
@@ -742,6 +755,12 @@ void ddsi_update_proxy_reader (struct ddsi_proxy_reader *prd, ddsi_seqno_t seq,
   if (seq > prd->c.seq)
   {
     prd->c.seq = seq;
+    if (!ddsi_content_filter_property_equal (prd->content_filter, content_filter))
+    {
+      ddsi_content_filter_property_free (prd->content_filter);
+      prd->content_filter = content_filter ? ddsi_content_filter_property_dup (content_filter) : NULL;
+      content_filter_changed = true;
+    }
     if (! ddsi_addrset_eq_onesidederr (prd->c.as, as))
     {
       /* Update proxy reader endpoints (from SEDP alive) */
@@ -785,6 +804,23 @@ void ddsi_update_proxy_reader (struct ddsi_proxy_reader *prd, ddsi_seqno_t seq,
     }
 
     (void) ddsi_update_qos_locked (&prd->e, prd->c.xqos, xqos, timestamp);
+
+    if (content_filter_changed)
+    {
+      /* Writers evaluate the filter on behalf of the reader, so they need to switch to the new one */
+      struct ddsi_content_filter_property *cf = content_filter ? ddsi_content_filter_property_dup (content_filter) : NULL;
+      memset (&wrguid, 0, sizeof (wrguid));
+      while ((m = ddsrt_avl_lookup_succ (&ddsi_prd_writers_treedef, &prd->writers, &wrguid)) != NULL)
+      {
+        struct ddsi_writer *wr;
+        wrguid = m->wr_guid;
+        ddsrt_mutex_unlock (&prd->e.lock);
+        if ((wr = ddsi_entidx_lookup_writer_guid (prd->e.gv->entity_index, &wrguid)) != NULL)
+          ddsi_writer_update_content_filter (wr, prd, cf);
+        ddsrt_mutex_lock (&prd->e.lock);
+      }
+      ddsi_content_filter_property_free (cf);
+    }
   }
   ddsrt_mutex_unlock (&prd->e.lock);
 }
@@ -862,6 +898,7 @@ static void gc_delete_proxy_reader (struct ddsi_gcreq *gcreq)
 #ifdef DDS_HAS_SECURITY
   ddsi_omg_security_deregister_remote_reader (prd);
 #endif
+  ddsi_content_filter_property_free (prd->content_filter);
   proxy_endpoint_common_fini (&prd->e, &prd->c);
   ddsrt_free (prd);
 }
@@ -10,10 +10,18 @@
 
 #include <ctype.h>
 #include <stddef.h>
+#include <string.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <limits.h>
 
+#ifdef __linux
+#include <sys/mman.h>
+#define RBUFPOOL_MMAP 1
+#else
+#define RBUFPOOL_MMAP 0
+#endif
+
 #if HAVE_VALGRIND && ! defined (NDEBUG)
 #include <memcheck.h>
 #define USE_VALGRIND 1
@@ -273,13 +281,34 @@ struct ddsi_rbufpool {
 
      Could trivially be done lockless, except that it requires
      compare-and-swap, and we don't have that. But it hardly ever
-     happens anyway. */
+     happens anyway.
+
+     Optionally, rbufs are carved from a preallocated region of
+     "nslots" slots of "slot_size" bytes. Slots are initialized on
+     first use by the owner, and released slots go on a free list.
+     The free list and the statistics are protected by "lock". */
   ddsrt_mutex_t lock;
   struct ddsi_rbuf *current;
   uint32_t rbuf_size;
   uint32_t max_rmsg_size;
   const struct ddsrt_log_cfg *logcfg;
   bool trace;
+  unsigned char *region;
+  size_t region_size;
+  size_t slot_size;
+  uint32_t nslots_touched;
+  struct ddsi_rbuf *freelist;
+  struct ddsi_rbufpool_stats stats;
+
+  /* Samples of at least pin_threshold bytes may keep the rmsg they
+     are in alive instead of being copied (0 = never).  A pinned rmsg
+     keeps its entire rbuf alive, so what is limited is the total size
+     of the rbufs containing pinned rmsgs: "pinned" must remain within
+     pin_limit.  Both "pinned" and the rbufs' "npins" are protected by
+     "lock". */
+  uint32_t pin_threshold;
+  uint32_t pin_limit;
+  uint32_t pinned;
 #ifndef NDEBUG
   /* Thread that owns this pool, so we can check that no other thread
      is calling functions only the owner may use. */
@@ -289,6 +318,7 @@ struct ddsi_rbufpool {
 
 static struct ddsi_rbuf *ddsi_rbuf_alloc_new (struct ddsi_rbufpool *rbp);
 static void ddsi_rbuf_release (struct ddsi_rbuf *rbuf);
+static size_t ddsi_rbuf_slot_size (uint32_t rbuf_size);
 
 #define TRACE_CFG(obj, logcfg, ...) ((obj)->trace ? (void) DDS_CLOG (DDS_LC_RADMIN, (logcfg), __VA_ARGS__) : (void) 0)
 #define TRACE(obj, ...)             TRACE_CFG ((obj), (obj)->logcfg, __VA_ARGS__)
@@ -330,7 +360,64 @@ static uint32_t max_rmsg_size_w_hdr (uint32_t max_rmsg_size)
     + max_rmsg_size;
 }
 
+static bool rbufpool_region_init (struct ddsi_rbufpool *rbp, uint32_t region_size, bool hugepages)
+{
+  /* Reserve the region without touching it, the first access to each
+     page determines on which NUMA node it gets allocated and that
+     should be done by the owner */
+  size_t size = region_size;
+#if RBUFPOOL_MMAP
+  void *region = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (hugepages)
+  {
+    /* Explicitly reserved huge pages (2MB by default); fails if there
+       aren't enough of them, in which case we fall back to transparent
+       huge pages */
+    const size_t hpsize = (size_t) 2 << 20;
+    size = (size + hpsize - 1) & ~(hpsize - 1);
+    if ((region = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)) != MAP_FAILED)
+      rbp->stats.hugepages = true;
+    else
+      size = region_size;
+  }
+#endif
+  if (region == MAP_FAILED)
+  {
+    if ((region = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+      return false;
+#ifdef MADV_HUGEPAGE
+    if (hugepages)
+      (void) madvise (region, size, MADV_HUGEPAGE);
+#endif
+  }
+#else
+  (void) hugepages;
+  void *region;
+  if ((region = ddsrt_malloc (size)) == NULL)
+    return false;
+#endif
+  rbp->region = region;
+  rbp->region_size = size;
+  rbp->stats.nslots = (uint32_t) (size / rbp->slot_size);
+  return true;
+}
+
+static void rbufpool_region_fini (struct ddsi_rbufpool *rbp)
+{
+#if RBUFPOOL_MMAP
+  (void) munmap (rbp->region, rbp->region_size);
+#else
+  ddsrt_free (rbp->region);
+#endif
+}
+
 struct ddsi_rbufpool *ddsi_rbufpool_new (const struct ddsrt_log_cfg *logcfg, uint32_t rbuf_size, uint32_t max_rmsg_size)
+{
+  return ddsi_rbufpool_new_preallocated (logcfg, rbuf_size, max_rmsg_size, 0, false);
+}
+
+struct ddsi_rbufpool *ddsi_rbufpool_new_preallocated (const struct ddsrt_log_cfg *logcfg, uint32_t rbuf_size, uint32_t max_rmsg_size, uint32_t region_size, bool hugepages)
 {
   struct ddsi_rbufpool *rbp;
 
@@ -355,15 +442,31 @@ struct ddsi_rbufpool *ddsi_rbufpool_new (const struct ddsrt_log_cfg *logcfg, uin
   rbp->max_rmsg_size = max_rmsg_size;
   rbp->logcfg = logcfg;
   rbp->trace = (logcfg->c.mask & DDS_LC_RADMIN) != 0;
+  rbp->region = NULL;
+  rbp->region_size = 0;
+  rbp->slot_size = ddsi_rbuf_slot_size (rbuf_size);
+  rbp->nslots_touched = 0;
+  rbp->freelist = NULL;
+  memset (&rbp->stats, 0, sizeof (rbp->stats));
+  rbp->pin_threshold = 0;
+  rbp->pin_limit = 0;
+  rbp->pinned = 0;
 
 #if USE_VALGRIND
   VALGRIND_CREATE_MEMPOOL (rbp, 0, 0);
 #endif
 
+  /* The initial rbuf is allocated by the creating thread, not the
+     owner, so it is taken from the heap by allocating it before
+     setting up the region */
   if ((rbp->current = ddsi_rbuf_alloc_new (rbp)) == NULL)
     goto fail_rbuf;
+  if (region_size >= rbp->slot_size && !rbufpool_region_init (rbp, region_size, hugepages))
+    goto fail_region;
   return rbp;
 
+ fail_region:
+  ddsi_rbuf_release (rbp->current);
  fail_rbuf:
 #if USE_VALGRIND
   VALGRIND_DESTROY_MEMPOOL (rbp);
@@ -391,6 +494,13 @@ void ddsi_rbufpool_free (struct ddsi_rbufpool *rbp)
   ASSERT_RBUFPOOL_OWNER (rbp);
 #endif
   ddsi_rbuf_release (rbp->current);
+  if (rbp->region)
+  {
+    DDS_CLOG (DDS_LC_CONFIG, rbp->logcfg, "rbufpool %p: %"PRIu32" slots%s, peak in use %"PRIu32", recycled %"PRIu64", overflow %"PRIu64"\n",
+              (void *) rbp, rbp->stats.nslots, rbp->stats.hugepages ? " (huge pages)" : "",
+              rbp->stats.peak_inuse, rbp->stats.recycled, rbp->stats.overflow);
+    rbufpool_region_fini (rbp);
+  }
 #if USE_VALGRIND
   VALGRIND_DESTROY_MEMPOOL (rbp);
 #endif
@@ -398,6 +508,19 @@ void ddsi_rbufpool_free (struct ddsi_rbufpool *rbp)
   ddsrt_free (rbp);
 }
 
+void ddsi_rbufpool_set_pin_limits (struct ddsi_rbufpool *rbp, uint32_t threshold, uint32_t limit)
+{
+  rbp->pin_threshold = threshold;
+  rbp->pin_limit = limit;
+}
+
+void ddsi_rbufpool_get_stats (struct ddsi_rbufpool *rbp, struct ddsi_rbufpool_stats *stats)
+{
+  ddsrt_mutex_lock (&rbp->lock);
+  *stats = rbp->stats;
+  ddsrt_mutex_unlock (&rbp->lock);
+}
+
 /* RBUF ---------------------------------------------------------------- */
 
 struct ddsi_rbuf {
@@ -407,12 +530,26 @@ struct ddsi_rbuf {
   struct ddsi_rbufpool *rbufpool;
   bool trace;
 
+  /* Next free slot if this rbuf is in the pool's region and released */
+  struct ddsi_rbuf *freelist_next;
+
+  /* Number of pinned rmsgs in this rbuf, the rbuf counts towards the
+     pool's pin limit if it is not 0 */
+  uint32_t npins;
+
   /* Allocating sequentially, releasing in random order, not bothering
      to reuse memory as soon as it becomes available again. I think
      this will have to change eventually, but this is the easiest
      approach.  Changes would be confined rmsg_new and rmsg_free. */
   unsigned char *freeptr;
 
+  /* End of the space reserved for a batch of uncommitted rmsgs
+     allocated by ddsi_rmsg_new_batch, and so not available for new
+     allocations even if it is beyond freeptr. It is reset when the
+     next batch is allocated, by which time all rmsgs of the previous
+     batch have been committed. */
+  unsigned char *reserved_endp;
+
   /* to ensure reasonable alignment of raw[] */
   union {
     int64_t l;
@@ -424,22 +561,60 @@ struct ddsi_rbuf {
   unsigned char raw[];
 };
 
+static size_t ddsi_rbuf_slot_size (uint32_t rbuf_size)
+{
+  return align_rmsg ((uint32_t) sizeof (struct ddsi_rbuf) + rbuf_size);
+}
+
+static bool ddsi_rbuf_in_region (const struct ddsi_rbufpool *rbp, const struct ddsi_rbuf *rb)
+{
+  const unsigned char *p = (const unsigned char *) rb;
+  return rbp->region != NULL && p >= rbp->region && p < rbp->region + rbp->region_size;
+}
+
+static struct ddsi_rbuf *ddsi_rbuf_alloc_slot (struct ddsi_rbufpool *rbp)
+{
+  struct ddsi_rbuf *rb = NULL;
+  ddsrt_mutex_lock (&rbp->lock);
+  if (rbp->freelist)
+  {
+    rb = rbp->freelist;
+    rbp->freelist = rb->freelist_next;
+    rbp->stats.recycled++;
+  }
+  else if (rbp->nslots_touched < rbp->stats.nslots)
+  {
+    rb = (struct ddsi_rbuf *) (rbp->region + rbp->nslots_touched++ * rbp->slot_size);
+  }
+  if (rb == NULL)
+    rbp->stats.overflow++;
+  else if (++rbp->stats.inuse > rbp->stats.peak_inuse)
+    rbp->stats.peak_inuse = rbp->stats.inuse;
+  ddsrt_mutex_unlock (&rbp->lock);
+  return rb;
+}
+
 static struct ddsi_rbuf *ddsi_rbuf_alloc_new (struct ddsi_rbufpool *rbp)
 {
-  struct ddsi_rbuf *rb;
+  struct ddsi_rbuf *rb = NULL;
   ASSERT_RBUFPOOL_OWNER (rbp);
 
-  if ((rb = ddsrt_malloc (sizeof (struct ddsi_rbuf) + rbp->rbuf_size)) == NULL)
+  if (rbp->region)
+    rb = ddsi_rbuf_alloc_slot (rbp);
+  if (rb == NULL && (rb = ddsrt_malloc (sizeof (struct ddsi_rbuf) + rbp->rbuf_size)) == NULL)
     return NULL;
 #if USE_VALGRIND
   VALGRIND_MAKE_MEM_NOACCESS (rb->raw, rbp->rbuf_size);
 #endif
 
   rb->rbufpool = rbp;
+  rb->freelist_next = NULL;
+  rb->npins = 0;
   ddsrt_atomic_st32 (&rb->n_live_rmsg_chunks, 1);
   rb->size = rbp->rbuf_size;
   rb->max_rmsg_size = rbp->max_rmsg_size;
   rb->freeptr = rb->raw;
+  rb->reserved_endp = rb->raw;
   rb->trace = rbp->trace;
   RBPTRACE ("rbuf_alloc_new(%p) = %p\n", (void *) rbp, (void *) rb);
   return rb;
@@ -452,10 +627,13 @@ static struct ddsi_rbuf *ddsi_rbuf_new (struct ddsi_rbufpool *rbp)
   ASSERT_RBUFPOOL_OWNER (rbp);
   if ((rb = ddsi_rbuf_alloc_new (rbp)) != NULL)
   {
+    struct ddsi_rbuf *old;
     ddsrt_mutex_lock (&rbp->lock);
-    ddsi_rbuf_release (rbp->current);
+    old = rbp->current;
     rbp->current = rb;
     ddsrt_mutex_unlock (&rbp->lock);
+    /* releasing may return it to the free list, which requires the lock */
+    ddsi_rbuf_release (old);
   }
   return rb;
 }
@@ -467,7 +645,16 @@ static void ddsi_rbuf_release (struct ddsi_rbuf *rbuf)
   if (ddsrt_atomic_dec32_ov (&rbuf->n_live_rmsg_chunks) == 1)
   {
     RBPTRACE ("rbuf_release(%p) free\n", (void *) rbuf);
-    ddsrt_free (rbuf);
+    if (!ddsi_rbuf_in_region (rbp, rbuf))
+      ddsrt_free (rbuf);
+    else
+    {
+      ddsrt_mutex_lock (&rbp->lock);
+      rbuf->freelist_next = rbp->freelist;
+      rbp->freelist = rbuf;
+      rbp->stats.inuse--;
+      ddsrt_mutex_unlock (&rbp->lock);
+    }
   }
 }
 
@@ -488,6 +675,19 @@ static void ddsi_rbuf_release (struct ddsi_rbuf *rbuf)
 #define ASSERT_RMSG_UNCOMMITTED(rmsg) ((void) 0)
 #endif
 
+static unsigned char *ddsi_rbuf_allocptr (const struct ddsi_rbuf *rb)
+{
+  return (rb->freeptr > rb->reserved_endp) ? rb->freeptr : rb->reserved_endp;
+}
+
+static uint32_t ddsi_rbuf_avail (const struct ddsi_rbuf *rb)
+{
+  const unsigned char *allocptr = ddsi_rbuf_allocptr (rb);
+  assert (allocptr >= rb->raw);
+  assert (allocptr <= rb->raw + rb->size);
+  return (uint32_t) (rb->raw + rb->size - allocptr);
+}
+
 static void *ddsi_rbuf_alloc (struct ddsi_rbufpool *rbp)
 {
   /* Note: only one thread calls ddsi_rmsg_new on a pool */
@@ -497,24 +697,23 @@ static void *ddsi_rbuf_alloc (struct ddsi_rbufpool *rbp)
   ASSERT_RBUFPOOL_OWNER (rbp);
   rb = rbp->current;
   assert (rb != NULL);
-  assert (rb->freeptr >= rb->raw);
-  assert (rb->freeptr <= rb->raw + rb->size);
 
-  if ((uint32_t) (rb->raw + rb->size - rb->freeptr) < asize)
+  if (ddsi_rbuf_avail (rb) < asize)
   {
     /* not enough space left for new rmsg */
     if ((rb = ddsi_rbuf_new (rbp)) == NULL)
       return NULL;
 
     /* a new one should have plenty of space */
-    assert ((uint32_t) (rb->raw + rb->size - rb->freeptr) >= asize);
+    assert (ddsi_rbuf_avail (rb) >= asize);
   }
 
-  RBPTRACE ("rmsg_rbuf_alloc(%p, %"PRIu32") = %p\n", (void *) rbp, asize, (void *) rb->freeptr);
+  unsigned char * const ptr = ddsi_rbuf_allocptr (rb);
+  RBPTRACE ("rmsg_rbuf_alloc(%p, %"PRIu32") = %p\n", (void *) rbp, asize, (void *) ptr);
 #if USE_VALGRIND
-  VALGRIND_MEMPOOL_ALLOC (rbp, rb->freeptr, asize);
+  VALGRIND_MEMPOOL_ALLOC (rbp, ptr, asize);
 #endif
-  return rb->freeptr;
+  return ptr;
 }
 
 static void init_rmsg_chunk (struct ddsi_rmsg_chunk *chunk, struct ddsi_rbuf *rbuf)
@@ -525,6 +724,16 @@ static void init_rmsg_chunk (struct ddsi_rmsg_chunk *chunk, struct ddsi_rbuf *rb
   ddsrt_atomic_inc32 (&rbuf->n_live_rmsg_chunks);
 }
 
+static void init_rmsg (struct ddsi_rmsg *rmsg, struct ddsi_rbuf *rbuf)
+{
+  /* Reference to this rmsg, undone by rmsg_commit(). */
+  ddsrt_atomic_st32 (&rmsg->refcount, RMSG_REFCOUNT_UNCOMMITTED_BIAS);
+  /* Initial chunk */
+  init_rmsg_chunk (&rmsg->chunk, rbuf);
+  rmsg->trace = rbuf->trace;
+  rmsg->lastchunk = &rmsg->chunk;
+}
+
 struct ddsi_rmsg *ddsi_rmsg_new (struct ddsi_rbufpool *rbp)
 {
   /* Note: only one thread calls ddsi_rmsg_new on a pool */
@@ -535,18 +744,101 @@ struct ddsi_rmsg *ddsi_rmsg_new (struct ddsi_rbufpool *rbp)
   if (rmsg == NULL)
     return NULL;
 
-  /* Reference to this rmsg, undone by rmsg_commit(). */
-  ddsrt_atomic_st32 (&rmsg->refcount, RMSG_REFCOUNT_UNCOMMITTED_BIAS);
-  /* Initial chunk */
-  init_rmsg_chunk (&rmsg->chunk, rbp->current);
-  rmsg->trace = rbp->trace;
-  rmsg->lastchunk = &rmsg->chunk;
+  init_rmsg (rmsg, rbp->current);
   /* Incrementing freeptr happens in commit(), so that discarding the
      message is really simple. */
   RBPTRACE ("rmsg_new(%p) = %p\n", (void *) rbp, (void *) rmsg);
   return rmsg;
 }
 
+uint32_t ddsi_rmsg_new_batch (struct ddsi_rbufpool *rbp, struct ddsi_rmsg **rmsgs, uint32_t n)
+{
+  /* Note: only one thread calls ddsi_rmsg_new on a pool
+
+     Each rmsg in the batch gets a full-size slot, because the packet
+     gets received into it before any processing starts.  This means
+     freeptr can't be used to prevent overlapping allocations while
+     the batch is being processed (it only moves on commit), and so
+     the end of the batch is recorded in the rbuf as a reservation
+     that all further allocations must respect. */
+  const uint32_t asize = align_rmsg (max_rmsg_size_w_hdr (rbp->max_rmsg_size));
+  struct ddsi_rbuf *rb = rbp->current;
+  RBPTRACE ("rmsg_new_batch(%p, %"PRIu32")\n", (void *) rbp, n);
+  ASSERT_RBUFPOOL_OWNER (rbp);
+  assert (n > 0);
+
+  /* All rmsgs of the previous batch have been committed by now */
+  rb->reserved_endp = rb->raw;
+  uint32_t navail = ddsi_rbuf_avail (rb) / asize;
+  if (navail == 0)
+  {
+    if ((rb = ddsi_rbuf_new (rbp)) == NULL)
+      return 0;
+    navail = ddsi_rbuf_avail (rb) / asize;
+    assert (navail > 0);
+  }
+  if (n > navail)
+    n = navail;
+
+  unsigned char *ptr = rb->freeptr;
+  for (uint32_t i = 0; i < n; i++, ptr += asize)
+  {
+#if USE_VALGRIND
+    VALGRIND_MEMPOOL_ALLOC (rbp, ptr, asize);
+#endif
+    rmsgs[i] = (struct ddsi_rmsg *) ptr;
+    init_rmsg (rmsgs[i], rb);
+    RBPTRACE ("rmsg_new_batch(%p) [%"PRIu32"] = %p\n", (void *) rbp, i, (void *) rmsgs[i]);
+  }
+  rb->reserved_endp = ptr;
+  return n;
+}
+
+static struct ddsi_rmsg *ddsi_rmsg_new_dedicated (struct ddsi_rbufpool *rbp, uint32_t size)
+{
+  /* Allocates an uncommitted rmsg with room for size bytes (payload
+     and anything allocated from it using rmsg_alloc) in an rbuf of
+     its own, taken from the heap and freed when the rmsg is freed.
+     It is accounted to rbp, but not in the current rbuf, and so it
+     may not be committed with ddsi_rmsg_commit.  Used by the
+     defragmenter for reassembling large samples. */
+  struct ddsi_rbuf *rb;
+  struct ddsi_rmsg *rmsg;
+  const size_t rawsize = sizeof (struct ddsi_rmsg) + size;
+  RBPTRACE ("rmsg_new_dedicated(%p, %"PRIu32")\n", (void *) rbp, size);
+  ASSERT_RBUFPOOL_OWNER (rbp);
+  if ((rb = ddsrt_malloc_s (sizeof (struct ddsi_rbuf) + rawsize)) == NULL)
+    return NULL;
+  rb->rbufpool = rbp;
+  rb->freelist_next = NULL;
+  /* the rmsg is the only reference, so that freeing it frees the rbuf */
+  ddsrt_atomic_st32 (&rb->n_live_rmsg_chunks, 0);
+  rb->size = (uint32_t) rawsize;
+  rb->max_rmsg_size = size;
+  rb->freeptr = rb->raw + rawsize;
+  rb->reserved_endp = rb->raw;
+  rb->trace = rbp->trace;
+  rmsg = (struct ddsi_rmsg *) rb->raw;
+#if USE_VALGRIND
+  VALGRIND_MEMPOOL_ALLOC (rbp, rmsg, rawsize);
+#endif
+  init_rmsg (rmsg, rb);
+  RBPTRACE ("rmsg_new_dedicated(%p, %"PRIu32") = %p\n", (void *) rbp, size, (void *) rmsg);
+  return rmsg;
+}
+
+static void ddsi_rmsg_discard_dedicated (struct ddsi_rmsg *rmsg)
+{
+  /* Drops the reference held by whoever allocated it using
+     rmsg_new_dedicated, i.e., the equivalent of rmsg_commit, but
+     possibly called by a different thread than the one that
+     allocated it */
+  RMSGTRACE ("rmsg_discard_dedicated(%p)\n", (void *) rmsg);
+  ASSERT_RMSG_UNCOMMITTED (rmsg);
+  if (ddsrt_atomic_sub32_nv (&rmsg->refcount, RMSG_REFCOUNT_UNCOMMITTED_BIAS) == 0)
+    ddsi_rmsg_free (rmsg);
+}
+
 void ddsi_rmsg_setsize (struct ddsi_rmsg *rmsg, uint32_t size)
 {
   uint32_t size8P = align_rmsg (size);
@@ -596,8 +888,13 @@ void ddsi_rmsg_free (struct ddsi_rmsg *rmsg)
 static void commit_rmsg_chunk (struct ddsi_rmsg_chunk *chunk)
 {
   struct ddsi_rbuf *rbuf = chunk->rbuf;
+  unsigned char * const endp = (unsigned char *) (chunk + 1) + chunk->u.size;
   RBUFTRACE ("commit_rmsg_chunk(%p)\n", (void *) chunk);
-  rbuf->freeptr = (unsigned char *) (chunk + 1) + chunk->u.size;
+  /* Rmsgs allocated in a batch are committed in order, but an extra
+     chunk for one of them may be located beyond the later ones, so
+     freeptr must never move backwards */
+  if (endp > rbuf->freeptr)
+    rbuf->freeptr = endp;
 }
 
 void ddsi_rmsg_commit (struct ddsi_rmsg *rmsg)
@@ -620,7 +917,9 @@ void ddsi_rmsg_commit (struct ddsi_rmsg *rmsg)
   assert (ddsrt_atomic_ld32 (&rmsg->refcount) >= RMSG_REFCOUNT_UNCOMMITTED_BIAS);
   assert (ddsrt_atomic_ld32 (&rmsg->chunk.rbuf->n_live_rmsg_chunks) > 0);
   assert (ddsrt_atomic_ld32 (&chunk->rbuf->n_live_rmsg_chunks) > 0);
-  assert (chunk->rbuf->rbufpool->current == chunk->rbuf);
+  /* The rbuf may have been replaced while processing an earlier rmsg
+     of the same batch */
+  assert (chunk->rbuf->rbufpool->current == chunk->rbuf || (unsigned char *) chunk < chunk->rbuf->reserved_endp);
   if (ddsrt_atomic_sub32_nv (&rmsg->refcount, RMSG_REFCOUNT_UNCOMMITTED_BIAS) == 0)
     ddsi_rmsg_free (rmsg);
   else
@@ -669,6 +968,49 @@ static void ddsi_rmsg_unref (struct ddsi_rmsg *rmsg)
     ddsi_rmsg_free (rmsg);
 }
 
+bool ddsi_rmsg_pin (struct ddsi_rmsg *rmsg, uint32_t size)
+{
+  /* Note: any thread may call rmsg_pin, provided it holds a reference
+     to the rmsg for the duration of the call (e.g., via an rdata) */
+  struct ddsi_rbuf * const rbuf = rmsg->chunk.rbuf;
+  struct ddsi_rbufpool * const rbp = rbuf->rbufpool;
+  if (rbp->pin_threshold == 0 || size < rbp->pin_threshold)
+    return false;
+  ddsrt_mutex_lock (&rbp->lock);
+  if (rbuf->npins == 0)
+  {
+    if (rbuf->size > rbp->pin_limit || rbp->pinned > rbp->pin_limit - rbuf->size)
+    {
+      ddsrt_mutex_unlock (&rbp->lock);
+      return false;
+    }
+    rbp->pinned += rbuf->size;
+  }
+  rbuf->npins++;
+  ddsrt_mutex_unlock (&rbp->lock);
+  RMSGTRACE ("rmsg_pin(%p, %"PRIu32")\n", (void *) rmsg, size);
+  assert (ddsrt_atomic_ld32 (&rmsg->refcount) > 0);
+  ddsrt_atomic_inc32 (&rmsg->refcount);
+  return true;
+}
+
+void ddsi_rmsg_unpin (struct ddsi_rmsg *rmsg)
+{
+  /* Note: any thread may call rmsg_unpin */
+  struct ddsi_rbuf * const rbuf = rmsg->chunk.rbuf;
+  struct ddsi_rbufpool * const rbp = rbuf->rbufpool;
+  RMSGTRACE ("rmsg_unpin(%p)\n", (void *) rmsg);
+  ddsrt_mutex_lock (&rbp->lock);
+  assert (rbuf->npins > 0);
+  if (--rbuf->npins == 0)
+  {
+    assert (rbp->pinned >= rbuf->size);
+    rbp->pinned -= rbuf->size;
+  }
+  ddsrt_mutex_unlock (&rbp->lock);
+  ddsi_rmsg_unref (rmsg);
+}
+
 void *ddsi_rmsg_alloc (struct ddsi_rmsg *rmsg, uint32_t size)
 {
   struct ddsi_rmsg_chunk *chunk = rmsg->lastchunk;
@@ -745,6 +1087,22 @@ static void ddsi_rdata_addbias (struct ddsi_rdata *rdata)
   ddsi_rmsg_addbias (rmsg);
 }
 
+static void ddsi_rdata_addbias_dedicated (struct ddsi_rdata *rdata)
+{
+  /* Turns the reference held by the creator of an rmsg allocated
+     using rmsg_new_dedicated into the bias for rdata, i.e., the
+     equivalent of rdata_addbias followed by rmsg_discard_dedicated.
+     Unlike rdata_addbias, any receive thread may do this. */
+  struct ddsi_rmsg *rmsg = rdata->rmsg;
+  RMSGTRACE ("rdata_addbias_dedicated(%p)\n", (void *) rdata);
+#ifndef NDEBUG
+  if (ddsrt_atomic_inc32_nv (&rdata->refcount_bias_added) != 1)
+    abort ();
+#endif
+  ASSERT_RMSG_UNCOMMITTED (rmsg);
+  ddsrt_atomic_sub32 (&rmsg->refcount, RMSG_REFCOUNT_UNCOMMITTED_BIAS - RMSG_REFCOUNT_RDATA_BIAS);
+}
+
 static void ddsi_rdata_rmbias_and_adjust (struct ddsi_rdata *rdata, int adjust)
 {
   struct ddsi_rmsg *rmsg = rdata->rmsg;
@@ -813,6 +1171,16 @@ static void ddsi_rdata_unref (struct ddsi_rdata *rdata)
    which points to a list of fragments, in-order (but for the caveat
    above).
 
+   Large samples (see ddsi_defrag_set_contiguous_threshold) of which
+   the first fragment arrives first are instead reassembled in an rmsg
+   of their own, allocated when that first fragment arrives, into
+   which the data of all fragments is copied as they arrive.  The
+   interval tree then merely tracks which bytes have been received,
+   the fragments themselves are not retained, allowing the receive
+   buffers to be reused immediately.  The completed sample consists
+   of a single rdata covering all bytes (and the one that completed
+   it, see defrag_add_fragment_contig).
+
    Memory used for the storage of interval nodes while defragmenting
    is afterward re-used for chaining samples.  An unfragmented message
    will have a new sample chain allocated for this purpose, a
@@ -833,6 +1201,17 @@ struct ddsi_defrag_iv {
   struct ddsi_rdata *last;
 };
 
+/* Maximum number of disjoint intervals of a sample reassembled in an
+   rmsg of its own, fragments that would require more are dropped */
+#define DEFRAG_CONTIG_MAX_IVS 256u
+
+struct ddsi_defrag_contig {
+  struct ddsi_rdata *rdata; /* covers the entire sample */
+  unsigned char *payload;
+  uint32_t n_free_ivs;
+  struct ddsi_defrag_iv *free_ivs[];
+};
+
 struct ddsi_rsample {
   union {
     struct ddsi_rsample_defrag {
@@ -840,6 +1219,7 @@ struct ddsi_rsample {
       ddsrt_avl_tree_t fragtree;
       struct ddsi_defrag_iv *lastfrag;
       struct ddsi_rsample_info *sampleinfo;
+      struct ddsi_defrag_contig *contig; /* non-NULL if reassembled in an rmsg of its own */
       ddsi_seqno_t seq;
     } defrag;
     struct ddsi_rsample_reorder {
@@ -857,6 +1237,7 @@ struct ddsi_defrag {
   uint32_t n_samples;
   uint32_t max_samples;
   enum ddsi_defrag_drop_mode drop_mode;
+  uint32_t contig_threshold;
   uint64_t discarded_bytes;
   const struct ddsrt_log_cfg *logcfg;
   bool trace;
@@ -893,12 +1274,18 @@ struct ddsi_defrag *ddsi_defrag_new (const struct ddsrt_log_cfg *logcfg, enum dd
   d->max_samples = max_samples;
   d->n_samples = 0;
   d->max_sample = NULL;
+  d->contig_threshold = 0;
   d->discarded_bytes = 0;
   d->logcfg = logcfg;
   d->trace = (logcfg->c.mask & DDS_LC_RADMIN) != 0;
   return d;
 }
 
+void ddsi_defrag_set_contiguous_threshold (struct ddsi_defrag *defrag, uint32_t threshold)
+{
+  defrag->contig_threshold = threshold;
+}
+
 void ddsi_defrag_stats (struct ddsi_defrag *defrag, uint64_t *discarded_bytes)
 {
   *discarded_bytes = defrag->discarded_bytes;
@@ -931,6 +1318,7 @@ static void defrag_rsample_drop (struct ddsi_defrag *defrag, struct ddsi_rsample
      inorder treewalk does provide. */
   ddsrt_avl_iter_t iter;
   struct ddsi_defrag_iv *iv;
+  struct ddsi_defrag_contig * const contig = rsample->u.defrag.contig;
   TRACE (defrag, "  defrag_rsample_drop (%p, %p)\n", (void *) defrag, (void *) rsample);
   ddsrt_avl_delete (&defrag_sampletree_treedef, &defrag->sampletree, rsample);
   assert (defrag->n_samples > 0);
@@ -941,6 +1329,9 @@ static void defrag_rsample_drop (struct ddsi_defrag *defrag, struct ddsi_rsample
       /* if the first fragment is missing, a sentinel "iv" is inserted with an empty chain */
       ddsi_fragchain_rmbias (iv->first);
   }
+  /* rsample lives in the rmsg of contig->rdata if there is one */
+  if (contig)
+    ddsi_rmsg_discard_dedicated (contig->rdata->rmsg);
 }
 
 void ddsi_defrag_free (struct ddsi_defrag *defrag)
@@ -1046,6 +1437,7 @@ static struct ddsi_rsample *defrag_rsample_new (struct ddsi_rdata *rdata, const
   rsample_init_common (rsample, rdata, sampleinfo);
   dfsample = &rsample->u.defrag;
   dfsample->lastfrag = NULL;
+  dfsample->contig = NULL;
   dfsample->seq = sampleinfo->seq;
   if ((dfsample->sampleinfo = ddsi_rmsg_alloc (rdata->rmsg, sizeof (*dfsample->sampleinfo))) == NULL)
     return NULL;
@@ -1071,6 +1463,96 @@ static struct ddsi_rsample *defrag_rsample_new (struct ddsi_rdata *rdata, const
   return rsample;
 }
 
+static void defrag_contig_copy (struct ddsi_defrag_contig *contig, const struct ddsi_rdata *rdata)
+{
+  memcpy (contig->payload + rdata->min, DDSI_RMSG_PAYLOADOFF (rdata->rmsg, DDSI_RDATA_PAYLOAD_OFF (rdata)), rdata->maxp1 - rdata->min);
+}
+
+static struct ddsi_rsample *defrag_rsample_new_contig (struct ddsi_defrag *defrag, struct ddsi_rdata *rdata, const struct ddsi_rsample_info *sampleinfo)
+{
+  /* Variant of defrag_rsample_new for reassembling the sample in an
+     rmsg of its own, rdata must be the first fragment.  The submessage
+     header (including the inline QoS) and the receiver state are
+     copied as well, so the sample doesn't depend on the rmsg of the
+     first fragment.  All memory needed while defragmenting is
+     allocated here, which is required because the other fragments may
+     be received by threads that do not own the rbufpool. */
+  struct ddsi_rbufpool * const rbp = rdata->rmsg->chunk.rbuf->rbufpool;
+  const uint32_t submsg_off = DDSI_RDATA_SUBMSG_OFF (rdata);
+  const uint32_t hdrsize = DDSI_RDATA_PAYLOAD_OFF (rdata) - submsg_off;
+  const uint32_t keyhash_off = (rdata->keyhash_zoff == 0) ? 0 : DDSI_RDATA_KEYHASH_OFF (rdata) - submsg_off;
+  const uint32_t nfrags = (sampleinfo->size + sampleinfo->fragsize - 1) / sampleinfo->fragsize;
+  const uint32_t n_ivs = (nfrags / 2 + 1 < DEFRAG_CONTIG_MAX_IVS) ? nfrags / 2 + 1 : DEFRAG_CONTIG_MAX_IVS;
+  const uint32_t admsize =
+    align_rmsg ((uint32_t) sizeof (struct ddsi_rdata)) +
+    align_rmsg ((uint32_t) sizeof (struct ddsi_rsample)) +
+    align_rmsg ((uint32_t) sizeof (struct ddsi_rsample_info)) +
+    align_rmsg ((uint32_t) sizeof (struct ddsi_receiver_state)) +
+    align_rmsg ((uint32_t) (sizeof (struct ddsi_defrag_contig) + n_ivs * sizeof (struct ddsi_defrag_iv *))) +
+    align_rmsg ((uint32_t) (n_ivs * sizeof (struct ddsi_defrag_iv)));
+  struct ddsi_rmsg *rmsg;
+  struct ddsi_rsample *rsample;
+  struct ddsi_rsample_defrag *dfsample;
+  struct ddsi_defrag_contig *contig;
+  struct ddsi_defrag_iv *ivs;
+  struct ddsi_receiver_state *rst;
+  ddsrt_avl_ipath_t ivpath;
+
+  assert (rdata->min == 0);
+  assert (DDSI_RDATA_PAYLOAD_OFF (rdata) >= submsg_off);
+  if (sampleinfo->size > UINT32_MAX - hdrsize - admsize - DDSI_ALIGNOF_RMSG)
+    return NULL;
+  if ((rmsg = ddsi_rmsg_new_dedicated (rbp, align_rmsg (hdrsize + sampleinfo->size) + admsize)) == NULL)
+    return NULL;
+  memcpy (DDSI_RMSG_PAYLOAD (rmsg), DDSI_RMSG_PAYLOADOFF (rdata->rmsg, submsg_off), hdrsize);
+  ddsi_rmsg_setsize (rmsg, hdrsize + sampleinfo->size);
+
+  /* there is room for all of these, so none of the allocations fail */
+  rsample = ddsi_rmsg_alloc (rmsg, sizeof (*rsample));
+  dfsample = &rsample->u.defrag;
+  dfsample->sampleinfo = ddsi_rmsg_alloc (rmsg, sizeof (*dfsample->sampleinfo));
+  rst = ddsi_rmsg_alloc (rmsg, sizeof (*rst));
+  contig = ddsi_rmsg_alloc (rmsg, (uint32_t) (sizeof (*contig) + n_ivs * sizeof (contig->free_ivs[0])));
+  ivs = ddsi_rmsg_alloc (rmsg, (uint32_t) (n_ivs * sizeof (*ivs)));
+  contig->rdata = ddsi_rdata_new (rmsg, 0, sampleinfo->size, 0, hdrsize, keyhash_off);
+  assert (rsample && dfsample->sampleinfo && rst && contig && ivs && contig->rdata);
+  assert (rmsg->lastchunk == &rmsg->chunk);
+  TRACE (defrag, "  contiguous %p size %"PRIu32" header %"PRIu32" intervals %"PRIu32"\n", (void *) rmsg, sampleinfo->size, hdrsize, n_ivs);
+
+  contig->payload = DDSI_RMSG_PAYLOADOFF (rmsg, hdrsize);
+  contig->n_free_ivs = n_ivs;
+  for (uint32_t i = 0; i < n_ivs; i++)
+    contig->free_ivs[i] = &ivs[n_ivs - 1 - i];
+  *rst = *sampleinfo->rst;
+  *dfsample->sampleinfo = *sampleinfo;
+  dfsample->sampleinfo->rst = rst;
+  dfsample->contig = contig;
+  dfsample->seq = sampleinfo->seq;
+  ddsrt_avl_init (&rsample_defrag_fragtree_treedef, &dfsample->fragtree);
+
+  /* interval for the first fragment, which is not retained */
+  dfsample->lastfrag = contig->free_ivs[--contig->n_free_ivs];
+  dfsample->lastfrag->min = 0;
+  dfsample->lastfrag->maxp1 = rdata->maxp1;
+  dfsample->lastfrag->first = dfsample->lastfrag->last = NULL;
+  ddsrt_avl_lookup_ipath (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, &dfsample->lastfrag->min, &ivpath);
+  ddsrt_avl_insert_ipath (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, dfsample->lastfrag, &ivpath);
+  defrag_contig_copy (contig, rdata);
+  return rsample;
+}
+
+static struct ddsi_rsample *defrag_rsample_create (struct ddsi_defrag *defrag, struct ddsi_rdata *rdata, const struct ddsi_rsample_info *sampleinfo)
+{
+  struct ddsi_rsample *rsample;
+  if (defrag->contig_threshold > 0 && sampleinfo->size >= defrag->contig_threshold && rdata->min == 0 && sampleinfo->fragsize > 0)
+  {
+    if ((rsample = defrag_rsample_new_contig (defrag, rdata, sampleinfo)) != NULL)
+      return rsample;
+    TRACE (defrag, "  contiguous allocation failed\n");
+  }
+  return defrag_rsample_new (rdata, sampleinfo);
+}
+
 static struct ddsi_rsample *reorder_rsample_new (struct ddsi_rdata *rdata, const struct ddsi_rsample_info *sampleinfo)
 {
   /* Implements:
@@ -1158,6 +1640,103 @@ static void rsample_convert_defrag_to_reorder (struct ddsi_rsample *sample)
   sample->u.reorder.n_samples = 1;
 }
 
+static struct ddsi_rsample *defrag_add_fragment_contig (struct ddsi_defrag *defrag, struct ddsi_rsample *sample, struct ddsi_rdata *rdata)
+{
+  /* Variant of defrag_add_fragment for a sample reassembled in an rmsg
+     of its own: the data is copied, the intervals only track which
+     bytes have been received and there is no need for a sentinel
+     because the first fragment is always present */
+  struct ddsi_rsample_defrag *dfsample = &sample->u.defrag;
+  struct ddsi_defrag_contig *contig = dfsample->contig;
+  struct ddsi_defrag_iv *predeq, *succ, *node;
+  const uint32_t min = rdata->min;
+  const uint32_t maxp1 = rdata->maxp1;
+
+  if (min >= dfsample->lastfrag->min)
+    predeq = dfsample->lastfrag;
+  else
+    predeq = ddsrt_avl_lookup_pred_eq (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, &min);
+  assert (predeq != NULL);
+
+  if (predeq->maxp1 >= maxp1)
+  {
+    TRACE (defrag, "  new contained in predeq\n");
+    defrag->discarded_bytes += maxp1 - min;
+    return NULL;
+  }
+  else if (min <= predeq->maxp1)
+  {
+    TRACE (defrag, "  grow predeq with new\n");
+    node = predeq;
+    node->maxp1 = maxp1;
+  }
+  else if (predeq != dfsample->lastfrag &&
+           (succ = ddsrt_avl_find_succ (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, predeq)) != NULL &&
+           succ->min <= maxp1)
+  {
+    /* key changes, but the order of the intervals doesn't */
+    TRACE (defrag, "  extending succ %p [%"PRIu32"..%"PRIu32") at head\n", (void *) succ, succ->min, succ->maxp1);
+    node = succ;
+    node->min = min;
+    if (maxp1 > node->maxp1)
+      node->maxp1 = maxp1;
+  }
+  else if (contig->n_free_ivs == 0)
+  {
+    /* it'll be retransmitted once the gaps have been filled */
+    TRACE (defrag, "  new interval, but too many intervals\n");
+    defrag->discarded_bytes += maxp1 - min;
+    return NULL;
+  }
+  else
+  {
+    ddsrt_avl_ipath_t path;
+    TRACE (defrag, "  new interval\n");
+    node = contig->free_ivs[--contig->n_free_ivs];
+    node->min = min;
+    node->maxp1 = maxp1;
+    node->first = node->last = NULL;
+    if (ddsrt_avl_lookup_ipath (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, &min, &path))
+      assert (0);
+    ddsrt_avl_insert_ipath (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, node, &path);
+    if (min > dfsample->lastfrag->min)
+      dfsample->lastfrag = node;
+  }
+  defrag_contig_copy (contig, rdata);
+
+  while (node != dfsample->lastfrag)
+  {
+    succ = ddsrt_avl_find_succ (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, node);
+    assert (succ != NULL);
+    if (succ->min > node->maxp1)
+      break;
+    TRACE (defrag, "  merge with succ %p [%"PRIu32"..%"PRIu32")\n", (void *) succ, succ->min, succ->maxp1);
+    if (succ->maxp1 > node->maxp1)
+      node->maxp1 = succ->maxp1;
+    ddsrt_avl_delete (&rsample_defrag_fragtree_treedef, &dfsample->fragtree, succ);
+    if (dfsample->lastfrag == succ)
+      dfsample->lastfrag = node;
+    contig->free_ivs[contig->n_free_ivs++] = succ;
+  }
+
+  if (!is_complete (dfsample))
+    return NULL;
+
+  /* The fragment chain of the completed sample is the rdata covering
+     the entire sample, followed by the one that completed it.  The
+     latter adds no information, but it keeps the rmsg currently being
+     processed alive for as long as the sample, as required by
+     ddsi_reorder_rsample_dup_first. */
+  node = ddsrt_avl_root_non_empty (&rsample_defrag_fragtree_treedef, &dfsample->fragtree);
+  ddsi_rdata_addbias_dedicated (contig->rdata);
+  ddsi_rdata_addbias (rdata);
+  rdata->nextfrag = NULL;
+  contig->rdata->nextfrag = rdata;
+  node->first = contig->rdata;
+  node->last = rdata;
+  return sample;
+}
+
 static struct ddsi_rsample *defrag_add_fragment (struct ddsi_defrag *defrag, struct ddsi_rsample *sample, struct ddsi_rdata *rdata, const struct ddsi_rsample_info *sampleinfo)
 {
   struct ddsi_rsample_defrag *dfsample = &sample->u.defrag;
@@ -1177,6 +1756,8 @@ static struct ddsi_rsample *defrag_add_fragment (struct ddsi_defrag *defrag, str
   assert (dfsample->lastfrag == ddsrt_avl_find_max (&rsample_defrag_fragtree_treedef, &dfsample->fragtree));
 
   TRACE (defrag, "  lastfrag %p [%"PRIu32"..%"PRIu32")\n", (void *) dfsample->lastfrag, dfsample->lastfrag->min, dfsample->lastfrag->maxp1);
+  if (dfsample->contig)
+    return defrag_add_fragment_contig (defrag, sample, rdata);
 
   /* Interval tree is sorted on min offset; each key is unique:
      otherwise one would be wholly contained in another. */
@@ -1384,7 +1965,7 @@ struct ddsi_rsample *ddsi_defrag_rsample (struct ddsi_defrag *defrag, struct dds
     /* FIXME: MERGE THIS ONE WITH THE NEXT */
     TRACE (defrag, "  new max sample\n");
     ddsrt_avl_lookup_ipath (&defrag_sampletree_treedef, &defrag->sampletree, &sampleinfo->seq, &path);
-    if ((sample = defrag_rsample_new (rdata, sampleinfo)) == NULL)
+    if ((sample = defrag_rsample_create (defrag, rdata, sampleinfo)) == NULL)
       return NULL;
     ddsrt_avl_insert_ipath (&defrag_sampletree_treedef, &defrag->sampletree, sample, &path);
     defrag->max_sample = sample;
@@ -1396,7 +1977,7 @@ struct ddsi_rsample *ddsi_defrag_rsample (struct ddsi_defrag *defrag, struct dds
     /* a new sequence number, but smaller than the maximum */
     TRACE (defrag, "  new sample less than max\n");
     assert (sampleinfo->seq < max_seq);
-    if ((sample = defrag_rsample_new (rdata, sampleinfo)) == NULL)
+    if ((sample = defrag_rsample_create (defrag, rdata, sampleinfo)) == NULL)
       return NULL;
     ddsrt_avl_insert_ipath (&defrag_sampletree_treedef, &defrag->sampletree, sample, &path);
     defrag->n_samples++;
@@ -1532,11 +2113,9 @@ enum ddsi_defrag_nackmap_result ddsi_defrag_nackmap (struct ddsi_defrag *defrag,
          extra to cover everything up to iv->min. */
       ++bound;
     }
-    for (; i < map->bitmap_base + map->numbits && i < bound; i++)
-    {
-      unsigned x = (unsigned) (i - map->bitmap_base);
-      ddsi_bitset_set (map->numbits, mapbits, x);
-    }
+    const uint32_t lim = (bound < map->bitmap_base + map->numbits) ? bound : map->bitmap_base + map->numbits;
+    if (i < lim)
+      ddsi_bitset_set_range (map->numbits, mapbits, i - map->bitmap_base, lim - map->bitmap_base);
     /* next sequence of fragments to request retranmsission of starts
        at fragment containing maxp1 (because we don't have that byte
        yet), and runs until the next interval begins */
@@ -1544,11 +2123,8 @@ enum ddsi_defrag_nackmap_result ddsi_defrag_nackmap (struct ddsi_defrag *defrag,
     iv = ddsrt_avl_find_succ (&rsample_defrag_fragtree_treedef, &s->u.defrag.fragtree, iv);
   }
   /* and set bits for missing fragments beyond the highest interval */
-  for (; i < map->bitmap_base + map->numbits; i++)
-  {
-    unsigned x = (unsigned) (i - map->bitmap_base);
-    ddsi_bitset_set (map->numbits, mapbits, x);
-  }
+  if (i < map->bitmap_base + map->numbits)
+    ddsi_bitset_set_range (map->numbits, mapbits, i - map->bitmap_base, map->numbits);
   return DDSI_DEFRAG_NACKMAP_FRAGMENTS_MISSING;
 }
 
@@ -1650,10 +2226,21 @@ void ddsi_defrag_prune (struct ddsi_defrag *defrag, ddsi_guid_prefix_t *dst, dds
    based on the fragment chain instead of the sample.  Example code is
    in the overview comment at the top of this file. */
 
+/* The intervals in the reorder admin that fall within a fixed-size
+   window starting at next_seq are also tracked in a bitmap with the
+   same layout as a DDSI sequence number set, bit j set iff next_seq+j
+   is covered by an interval.  That is just large enough to answer
+   everything a NACK bitmap needs from it a word at a time, and for
+   answering "wantsample" queries for samples in the window without a
+   tree lookup.  The tree remains the only storage for samples. */
+#define REORDER_WINDOW_BITS 256u
+#define REORDER_WINDOW_WORDS (REORDER_WINDOW_BITS / 32u)
+
 struct ddsi_reorder {
   ddsrt_avl_tree_t sampleivtree;
   struct ddsi_rsample *max_sampleiv; /* = max(sampleivtree) */
   ddsi_seqno_t next_seq;
+  uint32_t window[REORDER_WINDOW_WORDS]; /* intervals in [next_seq, next_seq+REORDER_WINDOW_BITS) */
   enum ddsi_reorder_mode mode;
   uint32_t max_samples;
   uint32_t n_samples;
@@ -1674,6 +2261,7 @@ struct ddsi_reorder *ddsi_reorder_new (const struct ddsrt_log_cfg *logcfg, enum
   ddsrt_avl_init (&reorder_sampleivtree_treedef, &r->sampleivtree);
   r->max_sampleiv = NULL;
   r->next_seq = 1;
+  ddsi_bitset_zero (REORDER_WINDOW_BITS, r->window);
   r->mode = mode;
   r->max_samples = max_samples;
   r->n_samples = 0;
@@ -1729,7 +2317,107 @@ static void reorder_add_rsampleiv (struct ddsi_reorder *reorder, struct ddsi_rsa
   ddsrt_avl_insert_ipath (&reorder_sampleivtree_treedef, &reorder->sampleivtree, rsample, &path);
 }
 
+static void reorder_window_update (struct ddsi_reorder *reorder, ddsi_seqno_t min, ddsi_seqno_t maxp1, bool present)
+{
+  /* Marks [min,maxp1) as (not) covered by an interval, only the part
+     overlapping with the window matters */
+  const ddsi_seqno_t wend = reorder->next_seq + REORDER_WINDOW_BITS;
+  if (min < reorder->next_seq)
+    min = reorder->next_seq;
+  if (maxp1 > wend)
+    maxp1 = wend;
+  if (min >= maxp1)
+    return;
+  const uint32_t from = (uint32_t) (min - reorder->next_seq), to = (uint32_t) (maxp1 - reorder->next_seq);
+  if (present)
+    ddsi_bitset_set_range (REORDER_WINDOW_BITS, reorder->window, from, to);
+  else
+    ddsi_bitset_clear_range (REORDER_WINDOW_BITS, reorder->window, from, to);
+}
+
+static void reorder_set_next_seq (struct ddsi_reorder *reorder, ddsi_seqno_t next_seq)
+{
+  /* Slides the window to start at next_seq, the intervals below
+     next_seq must have been removed from the tree already */
+  const ddsi_seqno_t old_wend = reorder->next_seq + REORDER_WINDOW_BITS;
+  if (ddsrt_avl_is_empty (&reorder->sampleivtree))
+  {
+    /* the last intervals may just have been removed */
+    reorder->next_seq = next_seq;
+    ddsi_bitset_zero (REORDER_WINDOW_BITS, reorder->window);
+    return;
+  }
+  assert (next_seq >= reorder->next_seq);
+  const ddsi_seqno_t shift = next_seq - reorder->next_seq;
+  if (shift == 0)
+    return;
+  reorder->next_seq = next_seq;
+  if (shift >= REORDER_WINDOW_BITS)
+    ddsi_bitset_zero (REORDER_WINDOW_BITS, reorder->window);
+  else
+  {
+    const uint32_t q = (uint32_t) shift / 32, r = (uint32_t) shift % 32;
+    for (uint32_t k = 0; k < REORDER_WINDOW_WORDS; k++)
+    {
+      uint32_t w = 0;
+      if (k + q < REORDER_WINDOW_WORDS)
+        w = reorder->window[k + q] << r;
+      if (r > 0 && k + q + 1 < REORDER_WINDOW_WORDS)
+        w |= reorder->window[k + q + 1] >> (32 - r);
+      reorder->window[k] = w;
+    }
+  }
+  /* Intervals beyond the old end of the window may now (partially) be
+     inside it; that is only possible if the last one ends beyond it */
+  struct ddsi_rsample *iv = ddsrt_avl_find_max (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+  if (iv->u.reorder.maxp1 > old_wend)
+  {
+    const ddsi_seqno_t wend = reorder->next_seq + REORDER_WINDOW_BITS;
+    if ((iv = ddsrt_avl_lookup_pred_eq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &old_wend)) == NULL)
+      iv = ddsrt_avl_find_min (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+    for (; iv && iv->u.reorder.min < wend; iv = ddsrt_avl_find_succ (&reorder_sampleivtree_treedef, &reorder->sampleivtree, iv))
+      reorder_window_update (reorder, iv->u.reorder.min, iv->u.reorder.maxp1, true);
+  }
+}
+
+static bool reorder_window_isset (const struct ddsi_reorder *reorder, ddsi_seqno_t seq)
+{
+  assert (seq >= reorder->next_seq && seq - reorder->next_seq < REORDER_WINDOW_BITS);
+  return ddsi_bitset_isset (REORDER_WINDOW_BITS, reorder->window, (uint32_t) (seq - reorder->next_seq));
+}
+
+static uint32_t reorder_window_word_shifted (const struct ddsi_reorder *reorder, ddsi_seqno_t shift, uint32_t k)
+{
+  /* Word k of the window after moving it up by shift bits, shifting in
+     zeros at the start */
+  if (shift >= 32 * (ddsi_seqno_t) k + 32)
+    return 0;
+  else if (shift > 32 * (ddsi_seqno_t) k)
+    return reorder->window[0] >> (uint32_t) (shift - 32 * k);
+  const uint32_t off = 32 * k - (uint32_t) shift, q = off / 32, r = off % 32;
+  uint32_t w = 0;
+  if (q < REORDER_WINDOW_WORDS)
+    w = reorder->window[q] << r;
+  if (r > 0 && q + 1 < REORDER_WINDOW_WORDS)
+    w |= reorder->window[q + 1] >> (32 - r);
+  return w;
+}
+
 #ifndef NDEBUG
+static bool reorder_window_consistent (const struct ddsi_reorder *reorder)
+{
+  const struct ddsi_rsample *iv = ddsrt_avl_find_min (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+  for (ddsi_seqno_t seq = reorder->next_seq; seq < reorder->next_seq + REORDER_WINDOW_BITS; seq++)
+  {
+    while (iv && iv->u.reorder.maxp1 <= seq)
+      iv = ddsrt_avl_find_succ (&reorder_sampleivtree_treedef, &reorder->sampleivtree, iv);
+    const bool covered = (iv != NULL && iv->u.reorder.min <= seq);
+    if (covered != reorder_window_isset (reorder, seq))
+      return false;
+  }
+  return true;
+}
+
 static int rsample_is_singleton (const struct ddsi_rsample_reorder *s)
 {
   assert (s->min < s->maxp1);
@@ -1857,6 +2545,7 @@ static void delete_last_sample (struct ddsi_reorder *reorder)
     if (last->sc.first->sampleinfo)
       reorder->discarded_bytes += last->sc.first->sampleinfo->size;
     fragchain = last->sc.first->fragchain;
+    reorder_window_update (reorder, last->min, last->maxp1, false);
     ddsrt_avl_delete (&reorder_sampleivtree_treedef, &reorder->sampleivtree, reorder->max_sampleiv);
     reorder->max_sampleiv = ddsrt_avl_find_max (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
     /* No harm done if it the sampleivtree is empty, except that we
@@ -1887,6 +2576,7 @@ static void delete_last_sample (struct ddsi_reorder *reorder)
     last->sc.last = pe;
     last->maxp1--;
     last->n_samples--;
+    reorder_window_update (reorder, last->maxp1, last->maxp1 + 1, false);
   }
 
   ddsi_fragchain_unref (fragchain);
@@ -1957,7 +2647,7 @@ ddsi_reorder_result_t ddsi_reorder_rsample (struct ddsi_rsample_chain *sc, struc
       if (reorder_try_append_and_discard (reorder, rsampleiv, min))
         reorder->max_sampleiv = NULL;
     }
-    reorder->next_seq = s->maxp1;
+    reorder_set_next_seq (reorder, s->maxp1);
     *sc = rsampleiv->u.reorder.sc;
     (*refcount_adjust)++;
     TRACE (reorder, "  return [%"PRIu64",%"PRIu64")\n", s->min, s->maxp1);
@@ -1996,6 +2686,7 @@ ddsi_reorder_result_t ddsi_reorder_rsample (struct ddsi_rsample_chain *sc, struc
       reorder_add_rsampleiv (reorder, rsampleiv);
       reorder->max_sampleiv = rsampleiv;
       reorder->n_samples++;
+      reorder_window_update (reorder, s->min, s->maxp1, true);
     }
   }
   else if (((void) assert (reorder->max_sampleiv != NULL)), (s->min == reorder->max_sampleiv->u.reorder.maxp1))
@@ -2015,6 +2706,7 @@ ddsi_reorder_result_t ddsi_reorder_rsample (struct ddsi_rsample_chain *sc, struc
     {
       append_rsample_interval (reorder->max_sampleiv, rsampleiv);
       reorder->n_samples++;
+      reorder_window_update (reorder, s->min, s->maxp1, true);
     }
     else
     {
@@ -2038,6 +2730,7 @@ ddsi_reorder_result_t ddsi_reorder_rsample (struct ddsi_rsample_chain *sc, struc
       reorder_add_rsampleiv (reorder, rsampleiv);
       reorder->max_sampleiv = rsampleiv;
       reorder->n_samples++;
+      reorder_window_update (reorder, s->min, s->maxp1, true);
     }
     else
     {
@@ -2127,6 +2820,7 @@ ddsi_reorder_result_t ddsi_reorder_rsample (struct ddsi_rsample_chain *sc, struc
       TRACE (reorder, "  new interval\n");
       reorder_add_rsampleiv (reorder, rsampleiv);
     }
+    reorder_window_update (reorder, s->min, s->maxp1, true);
 
     /* do not let radmin grow beyond max_samples; now that we've
        inserted it (and possibly have grown the radmin beyond its max
@@ -2187,6 +2881,7 @@ static struct ddsi_rsample *coalesce_intervals_touching_range (struct ddsi_reord
     *valuable = 1;
     s->u.reorder.maxp1 = maxp1;
   }
+  reorder_window_update (reorder, s->u.reorder.min, s->u.reorder.maxp1, true);
   return s;
 }
 
@@ -2218,6 +2913,7 @@ static int reorder_insert_gap (struct ddsi_reorder *reorder, struct ddsi_rdata *
   s->u.reorder.maxp1 = maxp1;
   s->u.reorder.n_samples = 1;
   ddsrt_avl_insert_ipath (&reorder_sampleivtree_treedef, &reorder->sampleivtree, s, &path);
+  reorder_window_update (reorder, min, maxp1, true);
   return 1;
 }
 
@@ -2274,7 +2970,7 @@ ddsi_reorder_result_t ddsi_reorder_gap (struct ddsi_rsample_chain *sc, struct dd
     if (min <= reorder->next_seq)
     {
       TRACE (reorder, "  next expected: %"PRIu64"\n", maxp1);
-      reorder->next_seq = maxp1;
+      reorder_set_next_seq (reorder, maxp1);
       res = DDSI_REORDER_ACCEPT;
     }
     else if (reorder->n_samples == reorder->max_samples &&
@@ -2313,8 +3009,8 @@ ddsi_reorder_result_t ddsi_reorder_gap (struct ddsi_rsample_chain *sc, struct dd
     ddsrt_avl_delete (&reorder_sampleivtree_treedef, &reorder->sampleivtree, coalesced);
     if (coalesced->u.reorder.min <= reorder->next_seq)
       assert (min <= reorder->next_seq);
-    reorder->next_seq = coalesced->u.reorder.maxp1;
     reorder->max_sampleiv = ddsrt_avl_find_max (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+    reorder_set_next_seq (reorder, coalesced->u.reorder.maxp1);
     TRACE (reorder, "  next expected: %"PRIu64"\n", reorder->next_seq);
     *sc = coalesced->u.reorder.sc;
 
@@ -2370,6 +3066,8 @@ int ddsi_reorder_wantsample (const struct ddsi_reorder *reorder, ddsi_seqno_t se
   if (seq < reorder->next_seq)
     /* trivially not interesting */
     return 0;
+  if (seq - reorder->next_seq < REORDER_WINDOW_BITS)
+    return !reorder_window_isset (reorder, seq);
   /* Find interval that contains seq, if we know seq.  We are
      interested if seq is outside this interval (if any). */
   s = ddsrt_avl_lookup_pred_eq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &seq);
@@ -2422,34 +3120,34 @@ enum ddsi_reorder_nackmap_result ddsi_reorder_nackmap (const struct ddsi_reorder
   if (map->numbits == 0)
     return DDSI_REORDER_NACKMAP_ACK;
 
-  ddsi_bitset_zero (map->numbits, mapbits);
   // Reorder buffer can be treated as a sequence of intervals of available samples with gaps in
-  // between and with a gap between base and the first interval.  The bitmap is clear, we only
-  // need to set the bits corresponding to the gaps in the range [base, base+numbits).
-  struct ddsi_rsample *iv = ddsrt_avl_find_min (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
-  assert (iv == NULL || iv->u.reorder.min > base);
-  ddsi_seqno_t i = base;
+  // between and with a gap between base and the first interval.  The window has that for
+  // [next_seq, next_seq+256) and base <= next_seq, so the bitmap is the inverse of the window
+  // moved up by next_seq - base bits, with the bits for [base, next_seq) set.
+  assert (reorder_window_consistent (reorder));
+  const uint32_t nwords = (map->numbits + 31) / 32;
+  for (uint32_t k = 0; k < nwords; k++)
+    mapbits[k] = ~reorder_window_word_shifted (reorder, reorder->next_seq - base, k);
+  if ((map->numbits % 32) != 0)
+    mapbits[nwords - 1] &= ddsi_bitset_word_mask (0, map->numbits % 32);
+  // For "notail", the bitmap ends at the start of the last interval that starts inside it,
+  // unless there are more intervals following it and there is a gap after the interval
+  // inside the bitmap
   ddsi_seqno_t last_nacked_p1 = 0;
-  while (iv && i < base + map->numbits)
+  if (reorder->max_sampleiv != NULL)
   {
-    for (; i < base + map->numbits && i < iv->u.reorder.min; i++)
-    {
-      uint32_t x = (uint32_t) (i - base);
-      ddsi_bitset_set (map->numbits, mapbits, x);
-    }
-    last_nacked_p1 = i;
-    i = iv->u.reorder.maxp1;
-    iv = ddsrt_avl_find_succ (&reorder_sampleivtree_treedef, &reorder->sampleivtree, iv);
+    const ddsi_seqno_t end = base + map->numbits, endm1 = end - 1;
+    const struct ddsi_rsample *iv = ddsrt_avl_lookup_pred_eq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &endm1);
+    assert (iv == NULL || iv->u.reorder.min > base);
+    if (iv == NULL || (iv->u.reorder.maxp1 < end && iv != reorder->max_sampleiv))
+      last_nacked_p1 = end;
+    else
+      last_nacked_p1 = iv->u.reorder.min;
   }
   if (!notail)
   {
     // Not "notail" (the normal case): NACK all remaining sequence numbers that we know
-    // exist and that fit in the bitmap.
-    for (; i < base + map->numbits; i++)
-    {
-      uint32_t x = (uint32_t) (i - base);
-      ddsi_bitset_set (map->numbits, mapbits, x);
-    }
+    // exist and that fit in the bitmap, which the bitmap already does.
     return DDSI_REORDER_NACKMAP_NACK;
   }
   else if (last_nacked_p1 == 0)
@@ -2458,6 +3156,7 @@ enum ddsi_reorder_nackmap_result ddsi_reorder_nackmap (const struct ddsi_reorder
     // NACK nothing at all (given that "notail" still results in NACKs when the reorder
     // buffer is not empty).
     map->numbits = 1;
+    ddsi_bitset_zero (map->numbits, mapbits);
     ddsi_bitset_set (map->numbits, mapbits, 0);
     return DDSI_REORDER_NACKMAP_NACK;
   }
@@ -2466,6 +3165,8 @@ enum ddsi_reorder_nackmap_result ddsi_reorder_nackmap (const struct ddsi_reorder
     // "notail", non-empty reorder, at least one bit set: truncate after the last bit we set
     assert (last_nacked_p1 > base);
     map->numbits = (uint32_t) (last_nacked_p1 - base);
+    if ((map->numbits % 32) != 0)
+      mapbits[map->numbits / 32] &= ddsi_bitset_word_mask (0, map->numbits % 32);
     assert (ddsi_bitset_isset (map->numbits, mapbits, map->numbits - 1));
     return DDSI_REORDER_NACKMAP_NACK;
   }
@@ -2475,6 +3176,7 @@ enum ddsi_reorder_nackmap_result ddsi_reorder_nackmap (const struct ddsi_reorder
     // by more than the bitmap can hold.  Make a bitmap with a trailing 0 so we can tell the
     // different cases apart just from looking at an ACKNACK.
     map->numbits = 1;
+    ddsi_bitset_zero (map->numbits, mapbits);
     return DDSI_REORDER_NACKMAP_SUPPRESSED_NACK;
   }
 }
@@ -2486,19 +3188,30 @@ ddsi_seqno_t ddsi_reorder_next_seq (const struct ddsi_reorder *reorder)
 
 void ddsi_reorder_set_next_seq (struct ddsi_reorder *reorder, ddsi_seqno_t seq)
 {
-  reorder->next_seq = seq;
+  reorder_set_next_seq (reorder, seq);
 }
 
 /* DQUEUE -------------------------------------------------------------- */
 
+/* The queue itself is a lock-free stack of sample chain elements in reverse
+   order: enqueueing a chain means reversing it and pushing it in one go, and
+   dequeueing means taking the entire stack and reversing it once more.  This
+   preserves the order of the elements in a chain as well as the order of the
+   chains, it never blocks a producer and it is insensitive to ABA because the
+   consumer always takes the whole stack.
+
+   The mutex and condition variable are only used for parking the consumer
+   when the queue is empty and for threads waiting for it to drain, and hence
+   only touched when someone is (about to be) waiting. */
 struct ddsi_dqueue {
+  ddsrt_atomic_voidp_t head;
+  ddsrt_atomic_uint32_t parked;
+  ddsrt_atomic_uint32_t nwaiting_empty;
   ddsrt_mutex_t lock;
   ddsrt_cond_t cond;
   ddsi_dqueue_handler_t handler;
   void *handler_arg;
 
-  struct ddsi_rsample_chain sc;
-
   struct ddsi_thread_state *thrst;
   struct ddsi_domaingv *gv;
   char *name;
@@ -2547,21 +3260,86 @@ static enum dqueue_elem_kind dqueue_elem_kind (const struct ddsi_rsample_chain_e
     return DQEK_BUBBLE;
 }
 
-bool ddsi_dqueue_step_deaf (struct ddsi_dqueue *q)
+static struct ddsi_rsample_chain_elem *dqueue_reverse (struct ddsi_rsample_chain_elem *e, struct ddsi_rsample_chain_elem *tail)
+{
+  while (e)
+  {
+    struct ddsi_rsample_chain_elem * const next = e->next;
+    e->next = tail;
+    tail = e;
+    e = next;
+  }
+  return tail;
+}
+
+static bool dqueue_push (struct ddsi_dqueue *q, struct ddsi_rsample_chain *sc)
+{
+  /* The links are written before the CAS that publishes them, the consumer
+     only follows them after the CAS that takes them, the full barriers
+     implied by the CAS operations take care of the rest */
+  struct ddsi_rsample_chain_elem * const last = sc->first;
+  struct ddsi_rsample_chain_elem * const first = dqueue_reverse (sc->first, NULL);
+  void *old;
+  do {
+    old = ddsrt_atomic_ldvoidp (&q->head);
+    last->next = old;
+  } while (!ddsrt_atomic_casvoidp (&q->head, old, first));
+  return old == NULL;
+}
+
+static struct ddsi_rsample_chain_elem *dqueue_take_all (struct ddsi_dqueue *q)
+{
+  void *old;
+  do {
+    if ((old = ddsrt_atomic_ldvoidp (&q->head)) == NULL)
+      return NULL;
+  } while (!ddsrt_atomic_casvoidp (&q->head, old, NULL));
+  return dqueue_reverse (old, NULL);
+}
+
+static void dqueue_wakeup (struct ddsi_dqueue *q)
+{
+  /* The consumer sets "parked" before checking the queue one last time while
+     holding the lock, so either it sees the new data or this sees it parked */
+  if (ddsrt_atomic_ld32 (&q->parked))
+  {
+    ddsrt_mutex_lock (&q->lock);
+    ddsrt_cond_broadcast (&q->cond);
+    ddsrt_mutex_unlock (&q->lock);
+  }
+}
+
+static void dqueue_park (struct ddsi_dqueue *q)
 {
-  struct ddsi_thread_state * const thrst = ddsi_lookup_thread_state ();
-  struct ddsi_rsample_chain sc;
   ddsrt_mutex_lock (&q->lock);
-  while ((sc = q->sc).first != NULL)
+  ddsrt_atomic_st32 (&q->parked, 1);
+  ddsrt_atomic_fence ();
+  while (ddsrt_atomic_ldvoidp (&q->head) == NULL)
+    ddsrt_cond_wait (&q->cond, &q->lock);
+  ddsrt_atomic_st32 (&q->parked, 0);
+  ddsrt_mutex_unlock (&q->lock);
+}
+
+static void dqueue_dec_nof_samples (struct ddsi_dqueue *q)
+{
+  if (ddsrt_atomic_dec32_ov (&q->nof_samples) == 1 && ddsrt_atomic_ld32 (&q->nwaiting_empty) > 0)
   {
-    q->sc.first = q->sc.last = NULL;
+    ddsrt_mutex_lock (&q->lock);
+    ddsrt_cond_broadcast (&q->cond);
     ddsrt_mutex_unlock (&q->lock);
+  }
+}
 
+bool ddsi_dqueue_step_deaf (struct ddsi_dqueue *q)
+{
+  struct ddsi_thread_state * const thrst = ddsi_lookup_thread_state ();
+  struct ddsi_rsample_chain_elem *e;
+  while ((e = dqueue_take_all (q)) != NULL)
+  {
     ddsi_thread_state_awake (thrst, q->gv);
-    while (sc.first)
+    while (e)
     {
-      struct ddsi_rsample_chain_elem *e = sc.first;
-      sc.first = e->next;
+      struct ddsi_rsample_chain_elem * const next = e->next;
       ddsi_thread_state_awake_to_awake_no_nest (thrst);
       switch (dqueue_elem_kind (e))
       {
@@ -2585,13 +3363,11 @@ bool ddsi_dqueue_step_deaf (struct ddsi_dqueue *q)
           break;
         }
       }
+      e = next;
     }
     ddsi_thread_state_asleep (thrst);
-    ddsrt_mutex_lock (&q->lock);
   }
-  const bool ret = q->sc.first != NULL;
-  ddsrt_mutex_unlock (&q->lock);
-  return ret;
+  return ddsrt_atomic_ldvoidp (&q->head) != NULL;
 }
 
 static uint32_t dqueue_thread (void *vq)
@@ -2606,28 +3382,24 @@ static uint32_t dqueue_thread (void *vq)
   ddsi_guid_t rdguid, *prdguid = NULL;
   uint32_t rdguid_count = 0;
 
-  ddsrt_mutex_lock (&q->lock);
   while (keepgoing)
   {
-    struct ddsi_rsample_chain sc;
+    struct ddsi_rsample_chain_elem *e;
 
     LOG_THREAD_CPUTIME (&gv->logconfig, next_thread_cputime);
 
-    if (q->sc.first == NULL)
-      ddsrt_cond_wait (&q->cond, &q->lock);
-    sc = q->sc;
-    q->sc.first = q->sc.last = NULL;
-    ddsrt_mutex_unlock (&q->lock);
+    if ((e = dqueue_take_all (q)) == NULL)
+    {
+      dqueue_park (q);
+      continue;
+    }
 
     ddsi_thread_state_awake_fixed_domain (thrst);
-    while (sc.first)
+    while (e)
     {
-      struct ddsi_rsample_chain_elem *e = sc.first;
+      struct ddsi_rsample_chain_elem * const next = e->next;
       int ret;
-      sc.first = e->next;
-      if (ddsrt_atomic_dec32_ov (&q->nof_samples) == 1) {
-        ddsrt_cond_broadcast (&q->cond);
-      }
+      dqueue_dec_nof_samples (q);
       ddsi_thread_state_awake_to_awake_no_nest (thrst);
       switch (dqueue_elem_kind (e))
       {
@@ -2653,7 +3425,7 @@ static uint32_t dqueue_thread (void *vq)
               /* Stuff enqueued behind the bubble will still be
                  processed, we do want to drain the queue.  Nothing
                  may be queued anymore once we queue the stop bubble,
-                 so q->sc.first should be empty.  If it isn't
+                 so the queue should be empty.  If it isn't
                  ... dqueue_free fail an assertion.  STOP bubble
                  doesn't get malloced, and hence not freed. */
               keepgoing = 0;
@@ -2678,12 +3450,11 @@ static uint32_t dqueue_thread (void *vq)
             break;
           }
       }
+      e = next;
     }
 
     ddsi_thread_state_asleep (thrst);
-    ddsrt_mutex_lock (&q->lock);
   }
-  ddsrt_mutex_unlock (&q->lock);
   return 0;
 }
 
@@ -2699,7 +3470,9 @@ struct ddsi_dqueue *ddsi_dqueue_new (const char *name, const struct ddsi_domaing
   ddsrt_atomic_st32 (&q->nof_samples, 0);
   q->handler = handler;
   q->handler_arg = arg;
-  q->sc.first = q->sc.last = NULL;
+  ddsrt_atomic_stvoidp (&q->head, NULL);
+  ddsrt_atomic_st32 (&q->parked, 0);
+  ddsrt_atomic_st32 (&q->nwaiting_empty, 0);
   q->gv = (struct ddsi_domaingv *) gv;
   q->thrst = NULL;
 
@@ -2726,41 +3499,18 @@ bool ddsi_dqueue_start (struct ddsi_dqueue *q)
   return ret == DDS_RETCODE_OK;
 }
 
-static int ddsi_dqueue_enqueue_locked (struct ddsi_dqueue *q, struct ddsi_rsample_chain *sc)
-{
-  int must_signal;
-  if (q->sc.first == NULL)
-  {
-    must_signal = 1;
-    q->sc = *sc;
-  }
-  else
-  {
-    must_signal = 0;
-    q->sc.last->next = sc->first;
-    q->sc.last = sc->last;
-  }
-  return must_signal;
-}
-
 bool ddsi_dqueue_enqueue_deferred_wakeup (struct ddsi_dqueue *q, struct ddsi_rsample_chain *sc, ddsi_reorder_result_t rres)
 {
-  bool signal;
   assert (rres > 0);
   assert (sc->first);
   assert (sc->last->next == NULL);
-  ddsrt_mutex_lock (&q->lock);
   ddsrt_atomic_add32 (&q->nof_samples, (uint32_t) rres);
-  signal = ddsi_dqueue_enqueue_locked (q, sc);
-  ddsrt_mutex_unlock (&q->lock);
-  return signal;
+  return dqueue_push (q, sc);
 }
 
 void ddsi_dqueue_enqueue_trigger (struct ddsi_dqueue *q)
 {
-  ddsrt_mutex_lock (&q->lock);
-  ddsrt_cond_broadcast (&q->cond);
-  ddsrt_mutex_unlock (&q->lock);
+  dqueue_wakeup (q);
 }
 
 void ddsi_dqueue_enqueue (struct ddsi_dqueue *q, struct ddsi_rsample_chain *sc, ddsi_reorder_result_t rres)
@@ -2768,30 +3518,26 @@ void ddsi_dqueue_enqueue (struct ddsi_dqueue *q, struct ddsi_rsample_chain *sc,
   assert (rres > 0);
   assert (sc->first);
   assert (sc->last->next == NULL);
-  ddsrt_mutex_lock (&q->lock);
   ddsrt_atomic_add32 (&q->nof_samples, (uint32_t) rres);
-  if (ddsi_dqueue_enqueue_locked (q, sc))
-    ddsrt_cond_broadcast (&q->cond);
-  ddsrt_mutex_unlock (&q->lock);
+  if (dqueue_push (q, sc))
+    dqueue_wakeup (q);
 }
 
-static int ddsi_dqueue_enqueue_bubble_locked (struct ddsi_dqueue *q, struct ddsi_dqueue_bubble *b)
+static void ddsi_dqueue_init_bubble (struct ddsi_dqueue_bubble *b)
 {
-  struct ddsi_rsample_chain sc;
   b->sce.next = NULL;
   b->sce.fragchain = NULL;
   b->sce.sampleinfo = (struct ddsi_rsample_info *) b;
-  sc.first = sc.last = &b->sce;
-  return ddsi_dqueue_enqueue_locked (q, &sc);
 }
 
 static void ddsi_dqueue_enqueue_bubble (struct ddsi_dqueue *q, struct ddsi_dqueue_bubble *b)
 {
-  ddsrt_mutex_lock (&q->lock);
+  struct ddsi_rsample_chain sc;
+  ddsi_dqueue_init_bubble (b);
+  sc.first = sc.last = &b->sce;
   ddsrt_atomic_inc32 (&q->nof_samples);
-  if (ddsi_dqueue_enqueue_bubble_locked (q, b))
-    ddsrt_cond_broadcast (&q->cond);
-  ddsrt_mutex_unlock (&q->lock);
+  if (dqueue_push (q, &sc))
+    dqueue_wakeup (q);
 }
 
 void ddsi_dqueue_enqueue_callback (struct ddsi_dqueue *q, ddsi_dqueue_callback_t cb, void *arg)
@@ -2817,12 +3563,16 @@ void ddsi_dqueue_enqueue1 (struct ddsi_dqueue *q, const ddsi_guid_t *rdguid, str
   assert (rdguid != NULL);
   assert (sc->first);
   assert (sc->last->next == NULL);
-  ddsrt_mutex_lock (&q->lock);
+  /* the bubble must immediately precede the samples it applies to, so they
+     are pushed as a single chain */
+  struct ddsi_rsample_chain bsc;
+  ddsi_dqueue_init_bubble (b);
+  b->sce.next = sc->first;
+  bsc.first = &b->sce;
+  bsc.last = sc->last;
   ddsrt_atomic_add32 (&q->nof_samples, 1 + (uint32_t) rres);
-  if (ddsi_dqueue_enqueue_bubble_locked (q, b))
-    ddsrt_cond_broadcast (&q->cond);
-  (void) ddsi_dqueue_enqueue_locked (q, sc);
-  ddsrt_mutex_unlock (&q->lock);
+  if (dqueue_push (q, &bsc))
+    dqueue_wakeup (q);
 }
 
 int ddsi_dqueue_is_full (struct ddsi_dqueue *q)
@@ -2844,10 +3594,12 @@ void ddsi_dqueue_wait_until_empty_if_full (struct ddsi_dqueue *q)
   if (count >= q->max_samples)
   {
     ddsrt_mutex_lock (&q->lock);
+    ddsrt_atomic_inc32 (&q->nwaiting_empty);
     /* In case the wakeups are were all deferred */
     ddsrt_cond_broadcast (&q->cond);
     while (ddsrt_atomic_ld32 (&q->nof_samples) > 0)
       ddsrt_cond_wait (&q->cond, &q->lock);
+    ddsrt_atomic_dec32 (&q->nwaiting_empty);
     ddsrt_mutex_unlock (&q->lock);
   }
 }
@@ -2855,10 +3607,10 @@ void ddsi_dqueue_wait_until_empty_if_full (struct ddsi_dqueue *q)
 static void dqueue_free_remaining_elements (struct ddsi_dqueue *q)
 {
   assert (q->thrst == NULL);
-  while (q->sc.first)
+  struct ddsi_rsample_chain_elem *e = dqueue_take_all (q);
+  while (e)
   {
-    struct ddsi_rsample_chain_elem *e = q->sc.first;
-    q->sc.first = e->next;
+    struct ddsi_rsample_chain_elem * const next = e->next;
     switch (dqueue_elem_kind (e))
     {
       case DQEK_DATA:
@@ -2872,6 +3624,7 @@ static void dqueue_free_remaining_elements (struct ddsi_dqueue *q)
         break;
       }
     }
+    e = next;
   }
 }
 
@@ -2889,7 +3642,7 @@ void ddsi_dqueue_free (struct ddsi_dqueue *q)
     ddsi_dqueue_enqueue_bubble (q, &b);
 
     ddsi_join_thread (q->thrst);
-    assert (q->sc.first == NULL);
+    assert (ddsrt_atomic_ldvoidp (&q->head) == NULL);
   }
   else
   {
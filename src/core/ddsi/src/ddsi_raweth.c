@@ -122,6 +122,8 @@ static void set_pktinfo(struct ddsi_network_packet_info *pktinfo, const uint8_t
   memset(pktinfo->src.address, 0, 10);
   memcpy(pktinfo->src.address + 10, addr, 6);
   pktinfo->if_index = 0;
+  pktinfo->segsize = 0;
+  pktinfo->timestamp = DDSRT_WCTIME_INVALID;
   pktinfo->dst.kind = DDSI_LOCATOR_KIND_INVALID;
 }
 
@@ -396,8 +398,13 @@ static dds_return_t ddsi_raweth_create_conn (struct ddsi_tran_conn **conn_out, s
   uc->m_base.m_base.m_handle_fn = ddsi_raweth_conn_handle;
   uc->m_base.m_locator_fn = ddsi_raweth_conn_locator;
   uc->m_base.m_read_fn = ddsi_raweth_conn_read;
+  uc->m_base.m_read_multiple_fn = 0;
   uc->m_base.m_write_fn = ddsi_raweth_conn_write;
+  uc->m_base.m_write_multiple_fn = 0;
+  uc->m_base.m_write_segmented_fn = 0;
+  uc->m_base.m_write_zerocopy_fn = 0;
   uc->m_base.m_disable_multiplexing_fn = 0;
+  uc->m_base.m_set_busy_poll_fn = 0;
 
   DDS_CTRACE (&fact->gv->logconfig, "ddsi_raweth_create_conn %s socket %d port %u\n", mcast ? "multicast" : "unicast", uc->m_sockext.sock, uc->m_base.m_base.m_port);
   *conn_out = &uc->m_base;
@@ -679,8 +686,13 @@ static dds_return_t ddsi_raweth_create_conn (struct ddsi_tran_conn **conn_out, s
   uc->m_base.m_base.m_handle_fn = ddsi_raweth_conn_handle;
   uc->m_base.m_locator_fn = ddsi_raweth_conn_locator;
   uc->m_base.m_read_fn = ddsi_raweth_conn_read;
+  uc->m_base.m_read_multiple_fn = 0;
   uc->m_base.m_write_fn = ddsi_raweth_conn_write;
+  uc->m_base.m_write_multiple_fn = 0;
+  uc->m_base.m_write_segmented_fn = 0;
+  uc->m_base.m_write_zerocopy_fn = 0;
   uc->m_base.m_disable_multiplexing_fn = 0;
+  uc->m_base.m_set_busy_poll_fn = 0;
   uc->buffer = ddsrt_malloc(buflen);
   uc->buflen = buflen;
   uc->bptr = uc->buffer;
@@ -57,6 +57,7 @@
 #include "ddsi__tran.h"
 #include "ddsi__vendor.h"
 #include "ddsi__hbcontrol.h"
+#include "ddsi__replay.h"
 #include "ddsi__sockwaitset.h"
 
 #include "dds/cdr/dds_cdrstream.h"
@@ -784,6 +785,8 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
   ddsi_seqno_t max_seq_in_reply;
   struct ddsi_whc_node *deferred_free_list = NULL;
   struct ddsi_whc_state whcst;
+  struct ddsi_rexmit_batch rexmits;
+  struct ddsi_xmsg *gap = NULL;
   int hb_sent_in_response = 0;
   countp = (ddsi_count_t *) ((char *) msg + offsetof (ddsi_rtps_acknack_t, bits) + DDSI_SEQUENCE_NUMBER_SET_BITS_SIZE (msg->readerSNState.numbits));
   src.prefix = rst->src_guid_prefix;
@@ -833,6 +836,7 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
     return 1;
   }
 
+  ddsi_rexmit_batch_init (&rexmits);
   ddsrt_mutex_lock (&wr->e.lock);
   if (wr->test_ignore_acknack)
   {
@@ -925,6 +929,11 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
     DDS_CLOG (DDS_LC_THROTTLE, &rst->gv->logconfig, "writer "PGUIDFMT" considering reader "PGUIDFMT" responsive again\n", PGUID (wr->e.guid), PGUID (rn->prd_guid));
   }
 
+  /* An AckNack proves the reader knows about the writer, so data sent to it from now on
+     won't be dropped for lack of a proxy writer */
+  if (rn->replay_seq != 0 && !rn->replay_scheduled)
+    ddsi_writer_schedule_history_replay (wr, rn);
+
   /* Second, the NACK bits (literally, that is). To do so, attempt to
      classify the AckNack for reverse-engineered compatibility with
      RTI's invalid acks and sometimes slightly odd behaviour. */
@@ -997,7 +1006,10 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
      last transmitted, even though we may have more available.  If it
      hasn't been transmitted ever, the initial transmit should solve
      that issue; if it has, then the timing is terribly unlucky, but
-     a future request'll fix it. */
+     a future request'll fix it.
+
+     The retransmits are only collected here, they are packed and
+     queued after releasing the writer lock. */
   if (wr->test_suppress_retransmit && numbits > 0)
   {
     RSTTRACE (" test_suppress_retransmit");
@@ -1019,19 +1031,29 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
     {
       ddsi_seqno_t seq = seqbase + i;
       struct ddsi_whc_borrowed_sample sample;
+      if (ddsi_history_replay_pending (rn, seq))
+      {
+        /* still to be sent as part of the history, neither retransmitted nor lost */
+        continue;
+      }
       if (seqbase + i >= min_seq_to_rexmit && ddsi_whc_borrow_sample (wr->whc, seq, &sample))
       {
         if (!wr->retransmitting && sample.unacked)
           ddsi_writer_set_retransmitting (wr);
 
-        if (rst->gv->config.retransmit_merging != DDSI_REXMIT_MERGE_NEVER && rn->assumed_in_sync && !prd->filter)
+        if (ddsi_writer_content_filter_rejects (wr, prd, rn, &sample))
+        {
+          /* the content filters reject it, so it wasn't sent to the reader either */
+          ddsi_gap_info_update (rst->gv, &gi, seqbase + i);
+        }
+        else if (rst->gv->config.retransmit_merging != DDSI_REXMIT_MERGE_NEVER && rn->assumed_in_sync && !prd->filter && ddsi_writer_content_filters_accept_all (wr, &sample))
         {
           /* send retransmit to all receivers, but skip if recently done */
           ddsrt_mtime_t tstamp = ddsrt_time_monotonic ();
           if (tstamp.v > sample.last_rexmit_ts.v + rst->gv->config.retransmit_merging_period)
           {
             RSTTRACE (" RX%"PRIu64, seqbase + i);
-            enqueued = (ddsi_enqueue_sample_wrlock_held (wr, seq, sample.serdata, NULL, 0) >= 0);
+            enqueued = ddsi_rexmit_batch_add_wrlock_held (wr, &rexmits, seq, sample.serdata, NULL);
             if (enqueued)
             {
               max_seq_in_reply = seqbase + i;
@@ -1062,7 +1084,7 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
           {
             /* no merging, send directed retransmit */
             RSTTRACE (" RX%"PRIu64"", seqbase + i);
-            enqueued = (ddsi_enqueue_sample_wrlock_held (wr, seq, sample.serdata, prd, 0) >= 0);
+            enqueued = ddsi_rexmit_batch_add_wrlock_held (wr, &rexmits, seq, sample.serdata, prd);
             if (enqueued)
             {
               max_seq_in_reply = seqbase + i;
@@ -1091,11 +1113,10 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
 
   if (!enqueued)
     RSTTRACE (" rexmit-limit-hit");
-  /* Generate a Gap message if some of the sequence is missing */
+  /* Generate a Gap message if some of the sequence is missing, it is queued after the
+     retransmits */
   if (gi.gapstart > 0)
   {
-    struct ddsi_xmsg *gap;
-
     if (gi.gapend == seqbase + msg->readerSNState.numbits)
       gi.gapend = grow_gap_to_next_seq (wr, gi.gapend);
 
@@ -1104,10 +1125,7 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
 
     gap = ddsi_gap_info_create_gap (wr, prd, &gi);
     if (gap)
-    {
-      ddsi_qxev_msg (wr->evq, gap);
       msgs_sent++;
-    }
   }
 
   wr->rexmit_count += msgs_sent;
@@ -1135,6 +1153,10 @@ static int handle_AckNack (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
   RSTTRACE (")");
  out:
   ddsrt_mutex_unlock (&wr->e.lock);
+  if (rexmits.n > 0 && !ddsi_rexmit_batch_send (wr, &rexmits))
+    RSTTRACE (" rexmit-queue-full");
+  if (gap)
+    ddsi_qxev_msg (wr->evq, gap);
   ddsi_whc_free_deferred_free_list (wr->whc, deferred_free_list);
   return 1;
 }
@@ -1677,7 +1699,7 @@ static int handle_NackFrag (struct ddsi_receiver_state *rst, ddsrt_etime_t tnow,
         struct ddsi_xmsg *reply;
         if (ddsi_create_fragment_message (wr, seq, sample.serdata, base + i, 1, prd, &reply, 0, 0) < 0)
           nfrags_lim = 0;
-        else if (ddsi_qxev_msg_rexmit_wrlock_held (wr->evq, reply, 0) == DDSI_QXEV_MSG_REXMIT_DROPPED)
+        else if (ddsi_qxev_msg_rexmit (wr->evq, reply, wr->as, 0) == DDSI_QXEV_MSG_REXMIT_DROPPED)
           nfrags_lim = 0;
         else
         {
@@ -2010,6 +2032,7 @@ struct remote_sourceinfo {
   const struct ddsi_rdata *fragchain;
   unsigned statusinfo;
   ddsrt_wctime_t tstamp;
+  ddsrt_wctime_t tdeliver; /* only set if sampleinfo has an rx_timestamp */
 };
 
 static struct ddsi_serdata *remote_make_sample (struct ddsi_tkmap_instance **tk, struct ddsi_domaingv *gv, struct ddsi_sertype const * const type, void *vsourceinfo)
@@ -2189,13 +2212,33 @@ static dds_return_t remote_on_delivery_failure_fastpath (struct ddsi_entity_comm
   return DDS_RETCODE_TRY_AGAIN;
 }
 
+static uint64_t rx_latency_interval (ddsrt_wctime_t t0, ddsrt_wctime_t t1)
+{
+  // hardware timestamps come from a different clock, so the difference can be negative
+  return (t1.v > t0.v) ? (uint64_t) (t1.v - t0.v) : 0;
+}
+
+static void remote_on_stored (struct ddsi_reader *rd, void *vsourceinfo)
+{
+  struct remote_sourceinfo const * const si = vsourceinfo;
+  struct ddsi_rsample_info const * const sampleinfo = si->sampleinfo;
+  if (sampleinfo->rx_timestamp.v == DDSRT_WCTIME_INVALID.v)
+    return;
+  const ddsrt_wctime_t tstored = ddsrt_time_wallclock ();
+  ddsrt_atomic_inc64 (&rd->rx_latency.samples);
+  ddsrt_atomic_add64 (&rd->rx_latency.kernel_to_recv, rx_latency_interval (sampleinfo->rx_timestamp, sampleinfo->reception_timestamp));
+  ddsrt_atomic_add64 (&rd->rx_latency.recv_to_deliver, rx_latency_interval (sampleinfo->reception_timestamp, si->tdeliver));
+  ddsrt_atomic_add64 (&rd->rx_latency.deliver_to_store, rx_latency_interval (si->tdeliver, tstored));
+}
+
 static int deliver_user_data (const struct ddsi_rsample_info *sampleinfo, const struct ddsi_rdata *fragchain, const ddsi_guid_t *rdguid, int pwr_locked)
 {
   static const struct ddsi_deliver_locally_ops deliver_locally_ops = {
     .makesample = remote_make_sample,
     .first_reader = proxy_writer_first_in_sync_reader,
     .next_reader = proxy_writer_next_in_sync_reader,
-    .on_failure_fastpath = remote_on_delivery_failure_fastpath
+    .on_failure_fastpath = remote_on_delivery_failure_fastpath,
+    .on_stored = remote_on_stored
   };
   struct ddsi_receiver_state const * const rst = sampleinfo->rst;
   struct ddsi_domaingv * const gv = rst->gv;
@@ -2268,7 +2311,8 @@ static int deliver_user_data (const struct ddsi_rsample_info *sampleinfo, const
     .qos = &qos,
     .fragchain = fragchain,
     .statusinfo = statusinfo,
-    .tstamp = tstamp
+    .tstamp = tstamp,
+    .tdeliver = (sampleinfo->rx_timestamp.v != DDSRT_WCTIME_INVALID.v) ? ddsrt_time_wallclock () : DDSRT_WCTIME_INVALID
   };
   if (rdguid)
     (void) ddsi_deliver_locally_one (gv, &pwr->e, pwr_locked != 0, rdguid, &wrinfo, &deliver_locally_ops, &sourceinfo);
@@ -3021,6 +3065,8 @@ static int handle_submsg_sequence
   struct ddsi_dqueue *deferred_wakeup = NULL;
   ddsi_rtps_submessage_kind_t prev_smid = DDSI_RTPS_SMID_PAD;
   struct defer_hb_state defer_hb_state;
+  /* pktinfo->timestamp is only set by the transport if asked to */
+  const ddsrt_wctime_t rx_timestamp = (gv->config.socket_timestamps != DDSI_SOCKTS_NONE) ? pktinfo->timestamp : DDSRT_WCTIME_INVALID;
 
   /* Receiver state is dynamically allocated with lifetime bound to
      the message.  Updates cause a new copy to be created if the
@@ -3174,6 +3220,7 @@ static int handle_submsg_sequence
         } else {
           sampleinfo.timestamp = timestamp;
           sampleinfo.reception_timestamp = tnowWC;
+          sampleinfo.rx_timestamp = rx_timestamp;
           handle_DataFrag (rst, tnowE, rmsg, &sm->datafrag, submsg_len, &sampleinfo, keyhash, datap, &deferred_wakeup, prev_smid);
           rst_live = 1;
         }
@@ -3195,6 +3242,7 @@ static int handle_submsg_sequence
         } else {
           sampleinfo.timestamp = timestamp;
           sampleinfo.reception_timestamp = tnowWC;
+          sampleinfo.rx_timestamp = rx_timestamp;
           handle_Data (rst, tnowE, rmsg, &sm->data, submsg_len, &sampleinfo, keyhash, datap, &deferred_wakeup, prev_smid);
           rst_live = 1;
         }
@@ -3263,9 +3311,12 @@ static int handle_submsg_sequence
   }
 }
 
-static void handle_rtps_message (struct ddsi_thread_state * const thrst, struct ddsi_domaingv *gv, struct ddsi_tran_conn * conn, const ddsi_guid_prefix_t *guidprefix, struct ddsi_rbufpool *rbpool, struct ddsi_rmsg *rmsg, size_t sz, const struct ddsi_network_packet_info *pktinfo)
+static struct ddsi_rmsg *handle_rtps_message (struct ddsi_thread_state * const thrst, struct ddsi_domaingv *gv, struct ddsi_tran_conn * conn, const ddsi_guid_prefix_t *guidprefix, struct ddsi_rbufpool *rbpool, struct ddsi_rmsg *rmsg, unsigned char *msg, size_t sz, const struct ddsi_network_packet_info *pktinfo)
 {
-  unsigned char *msg = DDSI_RMSG_PAYLOAD (rmsg);
+  /* Returns the rmsg the caller must commit: decoding a secure message
+     commits the original one and continues with a new rmsg containing
+     the decoded message.  Outside batched receiving that new one has the
+     same address, but in a batch it is allocated beyond it. */
   ddsi_rtps_header_t *hdr = (ddsi_rtps_header_t *) msg;
   assert (gv->config.protocol_version.major == DDSI_RTPS_MAJOR);
   assert (ddsi_thread_is_asleep ());
@@ -3302,11 +3353,32 @@ static void handle_rtps_message (struct ddsi_thread_state * const thrst, struct
       handle_submsg_sequence (thrst, gv, conn, pktinfo, ddsrt_time_wallclock (), ddsrt_time_elapsed (), &hdr->guid_prefix, guidprefix, msg, (size_t) sz, msg + DDSI_RTPS_MESSAGE_HEADER_SIZE, rmsg, res == DDSI_RTPS_MSG_STATE_ENCODED);
     }
   }
+  return rmsg;
+}
+
+static struct ddsi_rmsg *handle_rtps_messages (struct ddsi_thread_state * const thrst, struct ddsi_domaingv *gv, struct ddsi_tran_conn * conn, const ddsi_guid_prefix_t *guidprefix, struct ddsi_rbufpool *rbpool, struct ddsi_rmsg *rmsg, size_t offset, size_t sz, const struct ddsi_network_packet_info *pktinfo)
+{
+  /* Datagrams coalesced by the kernel (UDP GRO) are received as a single
+     buffer containing a sequence of RTPS messages, each but the last of
+     exactly pktinfo->segsize bytes.  They all share the rmsg, which is fine
+     because the rdata refer to the payload by offset.  For the same reason
+     the data need not start at the beginning of the payload. */
+  unsigned char * const buf = DDSI_RMSG_PAYLOAD (rmsg) + offset;
+  const size_t segsize = (pktinfo->segsize > 0 && pktinfo->segsize < sz) ? pktinfo->segsize : sz;
+  for (size_t off = 0; off < sz; off += segsize)
+  {
+    struct ddsi_rmsg * const rmsg1 = handle_rtps_message (thrst, gv, conn, guidprefix, rbpool, rmsg, buf + off, (sz - off < segsize) ? sz - off : segsize, pktinfo);
+    /* GRO is not enabled if the messages may need decoding, so this
+       only happens for a single message */
+    if (rmsg1 != rmsg)
+      return rmsg1;
+  }
+  return rmsg;
 }
 
 void ddsi_handle_rtps_message (struct ddsi_thread_state * const thrst, struct ddsi_domaingv *gv, struct ddsi_tran_conn * conn, const ddsi_guid_prefix_t *guidprefix, struct ddsi_rbufpool *rbpool, struct ddsi_rmsg *rmsg, size_t sz, const struct ddsi_network_packet_info *pktinfo)
 {
-  handle_rtps_message (thrst, gv, conn, guidprefix, rbpool, rmsg, sz, pktinfo);
+  (void) handle_rtps_message (thrst, gv, conn, guidprefix, rbpool, rmsg, DDSI_RMSG_PAYLOAD (rmsg), sz, pktinfo);
 }
 
 ddsrt_nonnull_all ddsrt_attribute_warn_unused_result
@@ -3368,7 +3440,7 @@ static bool do_packet (struct ddsi_thread_state * const thrst, struct ddsi_domai
   size_t sz;
   dds_return_t rc;
 
-  struct ddsi_rmsg * const rmsg = ddsi_rmsg_new (rbpool);
+  struct ddsi_rmsg *rmsg = ddsi_rmsg_new (rbpool);
   if (rmsg == NULL)
     return false;
 
@@ -3384,12 +3456,67 @@ static bool do_packet (struct ddsi_thread_state * const thrst, struct ddsi_domai
   if (rc == DDS_RETCODE_OK && sz > 0 && !gv->deaf)
   {
     ddsi_rmsg_setsize (rmsg, (uint32_t) sz);
-    handle_rtps_message (thrst, gv, conn, guidprefix, rbpool, rmsg, sz, &pktinfo);
+    rmsg = handle_rtps_messages (thrst, gv, conn, guidprefix, rbpool, rmsg, 0, sz, &pktinfo);
   }
   ddsi_rmsg_commit (rmsg);
   return (rc == DDS_RETCODE_OK && sz > 0);
 }
 
+static bool do_packets (struct ddsi_thread_state * const thrst, struct ddsi_domaingv *gv, struct ddsi_tran_conn * conn, const ddsi_guid_prefix_t *guidprefix, struct ddsi_rbufpool *rbpool)
+{
+  /* Batched variant of do_packet for datagram transports: reads as many
+     packets as are available (up to the configured batch size) into
+     consecutive rmsgs in one operation, then processes them in order.  The
+     transport gets the full rmsgs, it may need some space in front of the
+     datagram. */
+  const size_t maxsz = gv->config.rmsg_chunk_size;
+  struct ddsi_rmsg *rmsgs[DDSI_MAX_RECV_BATCH_SIZE];
+  ddsi_tran_read_buf_t bufs[DDSI_MAX_RECV_BATCH_SIZE];
+  size_t nread;
+  dds_return_t rc;
+
+  assert (!conn->m_stream);
+  assert (gv->config.recv_batch_size > 0 && gv->config.recv_batch_size <= DDSI_MAX_RECV_BATCH_SIZE);
+  const uint32_t n = ddsi_rmsg_new_batch (rbpool, rmsgs, (uint32_t) gv->config.recv_batch_size);
+  if (n == 0)
+    return false;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    bufs[i].buf = DDSI_RMSG_PAYLOAD (rmsgs[i]);
+    bufs[i].sz = maxsz;
+    bufs[i].offset = 0;
+  }
+  rc = ddsi_conn_read_multiple (conn, bufs, n, true, &nread);
+  if (rc == DDS_RETCODE_TRY_AGAIN)
+  {
+    rc = DDS_RETCODE_OK;
+    nread = 0;
+  }
+  for (uint32_t i = 0; i < n; i++)
+  {
+    /* committing the unused ones in order is what releases them; each one
+       must be committed before processing the next because any additional
+       allocations are made beyond the batch */
+    struct ddsi_rmsg *rmsg = rmsgs[i];
+    if (i < nread && bufs[i].bytes_read > 0 && !gv->deaf)
+    {
+      ddsi_rmsg_setsize (rmsg, (uint32_t) (bufs[i].offset + bufs[i].bytes_read));
+      rmsg = handle_rtps_messages (thrst, gv, conn, guidprefix, rbpool, rmsg, bufs[i].offset, bufs[i].bytes_read, &bufs[i].pktinfo);
+    }
+    ddsi_rmsg_commit (rmsg);
+  }
+  return (rc == DDS_RETCODE_OK && nread > 0);
+}
+
+static bool do_packet_or_packets (struct ddsi_thread_state * const thrst, struct ddsi_domaingv *gv, struct ddsi_tran_conn * conn, const ddsi_guid_prefix_t *guidprefix, struct ddsi_rbufpool *rbpool)
+{
+  if (conn->m_stream || gv->config.recv_batch_size <= 1)
+    return do_packet (thrst, gv, conn, guidprefix, rbpool);
+  else
+    return do_packets (thrst, gv, conn, guidprefix, rbpool);
+}
+
 struct local_participant_desc
 {
   struct ddsi_tran_conn * m_conn;
@@ -3534,7 +3661,15 @@ uint32_t ddsi_listen_thread (void *vlistener)
   return 0;
 }
 
-static int recv_thread_waitset_add_conn (struct ddsi_sock_waitset * ws, struct ddsi_tran_conn * conn)
+static void recv_thread_set_busy_poll (const struct ddsi_thread_state *thrst, struct ddsi_tran_conn * conn, dds_duration_t spin, dds_duration_t sock_busy_poll)
+{
+  struct ddsi_domaingv * const gv = conn->m_base.gv;
+  dds_return_t rc;
+  if ((spin > 0 || sock_busy_poll > 0) && (rc = ddsi_conn_set_busy_poll (conn, spin, sock_busy_poll)) != DDS_RETCODE_OK)
+    GVWARNING ("%s: failed to enable busy polling on socket %d: retcode %"PRId32"\n", thrst->name, (int) ddsi_conn_handle (conn), rc);
+}
+
+static int recv_thread_waitset_add_conn (const struct ddsi_thread_state *thrst, struct ddsi_sock_waitset * ws, struct ddsi_tran_conn * conn, dds_duration_t sock_busy_poll)
 {
   if (conn == NULL)
     return 0;
@@ -3542,9 +3677,16 @@ static int recv_thread_waitset_add_conn (struct ddsi_sock_waitset * ws, struct d
   {
     struct ddsi_domaingv *gv = conn->m_base.gv;
     for (uint32_t i = 0; i < gv->n_recv_threads; i++)
+    {
       if (gv->recv_threads[i].arg.mode == DDSI_RTM_SINGLE && gv->recv_threads[i].arg.u.single.conn == conn)
         return 0;
-    return ddsi_sock_waitset_add (ws, conn);
+      if (gv->recv_threads[i].arg.mode == DDSI_RTM_MANY && gv->recv_threads[i].arg.u.many.conn == conn)
+        return 0;
+    }
+    const int rc = ddsi_sock_waitset_add (ws, conn);
+    if (rc > 0)
+      recv_thread_set_busy_poll (thrst, conn, 0, sock_busy_poll);
+    return rc;
   }
 }
 
@@ -3583,15 +3725,20 @@ uint32_t ddsi_recv_thread (void *vrecv_thread_arg)
   struct ddsi_rbufpool *rbpool = recv_thread_arg->rbpool;
   struct ddsi_sock_waitset * waitset = recv_thread_arg->mode == DDSI_RTM_MANY ? recv_thread_arg->u.many.ws : NULL;
   ddsrt_mtime_t next_thread_cputime = { 0 };
+  const struct ddsi_config_thread_properties_listelem *tprops = ddsi_lookup_thread_properties (&gv->config, thrst->name);
+  const dds_duration_t spin = tprops ? tprops->spin_duration : 0;
+  const dds_duration_t sock_busy_poll = tprops ? tprops->socket_busy_poll : 0;
 
   ddsi_rbufpool_setowner (rbpool, ddsrt_thread_self ());
   if (waitset == NULL)
   {
     struct ddsi_tran_conn *conn = recv_thread_arg->u.single.conn;
+    // Blocking in the read, so the spinning is done by the transport
+    recv_thread_set_busy_poll (thrst, conn, spin, sock_busy_poll);
     while (ddsrt_atomic_ld32 (&gv->rtps_keepgoing))
     {
       LOG_THREAD_CPUTIME (&gv->logconfig, next_thread_cputime);
-      (void) do_packet (thrst, gv, conn, NULL, rbpool);
+      (void) do_packet_or_packets (thrst, gv, conn, NULL, rbpool);
     }
   }
   else
@@ -3599,30 +3746,39 @@ uint32_t ddsi_recv_thread (void *vrecv_thread_arg)
     struct local_participant_set lps;
     unsigned num_fixed = 0, num_fixed_uc = 0;
     struct ddsi_sock_waitset_ctx * ctx;
+    ddsrt_mtime_t tspin_end = { 0 };
     local_participant_set_init (&lps, &gv->participant_set_generation);
-    if (gv->m_factory->m_connless)
+    if (recv_thread_arg->u.many.conn != NULL)
+    {
+      /* Dedicated to one of the sockets sharing a port */
+      if (ddsi_sock_waitset_add (waitset, recv_thread_arg->u.many.conn) < 0)
+        DDS_FATAL("recv_thread: failed to add dedicated connection to waitset\n");
+      recv_thread_set_busy_poll (thrst, recv_thread_arg->u.many.conn, 0, sock_busy_poll);
+      num_fixed = 1;
+    }
+    else if (gv->m_factory->m_connless)
     {
       int rc;
       for (int i = 0; i < gv->n_interfaces; i++)
       {
         if (gv->disc_conn_uc[i])
         {
-          if ((rc = recv_thread_waitset_add_conn (waitset, gv->disc_conn_uc[i])) < 0)
+          if ((rc = recv_thread_waitset_add_conn (thrst, waitset, gv->disc_conn_uc[i], sock_busy_poll)) < 0)
             DDS_FATAL("recv_thread: failed to add disc_conn_uc[%d] to waitset\n", i);
           num_fixed_uc += (unsigned)rc;
         }
         if (gv->data_conn_uc[i])
         {
-          if ((rc = recv_thread_waitset_add_conn (waitset, gv->data_conn_uc[i])) < 0)
+          if ((rc = recv_thread_waitset_add_conn (thrst, waitset, gv->data_conn_uc[i], sock_busy_poll)) < 0)
             DDS_FATAL("recv_thread: failed to add data_conn_uc[%d] to waitset\n", i);
           num_fixed_uc += (unsigned)rc;
         }
       }
       num_fixed += num_fixed_uc;
-      if ((rc = recv_thread_waitset_add_conn (waitset, gv->disc_conn_mc)) < 0)
+      if ((rc = recv_thread_waitset_add_conn (thrst, waitset, gv->disc_conn_mc, sock_busy_poll)) < 0)
         DDS_FATAL("recv_thread: failed to add disc_conn_mc to waitset\n");
       num_fixed += (unsigned)rc;
-      if ((rc = recv_thread_waitset_add_conn (waitset, gv->data_conn_mc)) < 0)
+      if ((rc = recv_thread_waitset_add_conn (thrst, waitset, gv->data_conn_mc, sock_busy_poll)) < 0)
         DDS_FATAL("recv_thread: failed to add data_conn_mc to waitset\n");
       num_fixed += (unsigned)rc;
 
@@ -3634,7 +3790,7 @@ uint32_t ddsi_recv_thread (void *vrecv_thread_arg)
         // for input on
         if (ddsi_conn_handle (gv->xmit_conns_data[i]) == DDSRT_INVALID_SOCKET)
           continue;
-        if ((rc = recv_thread_waitset_add_conn (waitset, gv->xmit_conns_data[i])) < 0)
+        if ((rc = recv_thread_waitset_add_conn (thrst, waitset, gv->xmit_conns_data[i], sock_busy_poll)) < 0)
           DDS_FATAL("recv_thread: failed to add transmit_conn[%d] to waitset\n", i);
         num_fixed += (unsigned)rc;
       }
@@ -3666,19 +3822,24 @@ uint32_t ddsi_recv_thread (void *vrecv_thread_arg)
         }
       }
 
-      if ((ctx = ddsi_sock_waitset_wait (waitset)) != NULL)
+      // After receiving data, keep polling the waitset until the spin duration has passed
+      // without new data, only then block
+      const bool spinning = (spin > 0 && ddsrt_time_monotonic ().v < tspin_end.v);
+      if ((ctx = spinning ? ddsi_sock_waitset_poll (waitset) : ddsi_sock_waitset_wait (waitset)) != NULL)
       {
         int idx;
         struct ddsi_tran_conn * conn;
         while ((idx = ddsi_sock_waitset_next_event (ctx, &conn)) >= 0)
         {
           const ddsi_guid_prefix_t *guid_prefix;
+          if (spin > 0)
+            tspin_end = ddsrt_mtime_add_duration (ddsrt_time_monotonic (), spin);
           if (((unsigned)idx < num_fixed) || gv->config.many_sockets_mode != DDSI_MSM_MANY_UNICAST)
             guid_prefix = NULL;
           else
             guid_prefix = &lps.ps[(unsigned)idx - num_fixed].guid_prefix;
           /* Process message and clean out connection if failed or closed */
-          if (!do_packet (thrst, gv, conn, guid_prefix, rbpool) && !conn->m_connless)
+          if (!do_packet_or_packets (thrst, gv, conn, guid_prefix, rbpool) && !conn->m_connless)
             ddsi_conn_free (conn);
         }
       }
@@ -0,0 +1,235 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <assert.h>
+#include <string.h>
+
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/sync.h"
+#include "dds/ddsrt/avl.h"
+#include "dds/ddsi/ddsi_domaingv.h"
+#include "dds/ddsi/ddsi_proxy_endpoint.h"
+#include "dds/ddsi/ddsi_serdata.h"
+#include "ddsi__entity_index.h"
+#include "ddsi__endpoint.h"
+#include "ddsi__endpoint_match.h"
+#include "ddsi__hbcontrol.h"
+#include "ddsi__log.h"
+#include "ddsi__misc.h"
+#include "ddsi__receive.h"
+#include "ddsi__sysdeps.h"
+#include "ddsi__transmit.h"
+#include "ddsi__whc.h"
+#include "ddsi__xevent.h"
+#include "ddsi__xmsg.h"
+#include "ddsi__replay.h"
+
+/* A late-joining reliable transient-local reader of a writer with a large history would
+   otherwise get it via the regular heartbeat/retransmit mechanism, which limits the
+   amount of data sent in response to a single NACK and competes with retransmits of
+   live data for the retransmit queue. Instead, the history up to what had been
+   transmitted when the reader matched is sent directly into the event thread's packer
+   once the reader has shown it knows the writer by sending an AckNack (anything sent
+   before that is almost certainly dropped), in batches of a configurable size, with
+   gaps for what is no longer available and a heartbeat at the end of each batch.
+   Retransmit requests for the part that is still to be sent are ignored, anything lost
+   in transit is recovered in the usual manner. */
+
+struct history_replay_xevent_cb_arg {
+  ddsi_guid_t wr_guid;
+  ddsi_guid_t prd_guid;
+};
+
+struct replay_msgs {
+  uint32_t n, size;
+  struct ddsi_xmsg **ms;
+};
+
+static void replay_msgs_add (struct replay_msgs *rm, struct ddsi_xmsg *m)
+{
+  if (m == NULL)
+    return;
+  if (rm->n == rm->size)
+  {
+    rm->size = (rm->size == 0) ? 32 : 2 * rm->size;
+    rm->ms = ddsrt_realloc (rm->ms, rm->size * sizeof (*rm->ms));
+  }
+  rm->ms[rm->n++] = m;
+}
+
+static void replay_gap (struct replay_msgs *rm, struct ddsi_writer *wr, struct ddsi_proxy_reader *prd, ddsi_seqno_t start, ddsi_seqno_t end)
+{
+  /* nothing to send for [start,end) */
+  struct ddsi_gap_info gi;
+  ddsi_gap_info_init (&gi);
+  gi.gapstart = start;
+  gi.gapend = end;
+  replay_msgs_add (rm, ddsi_gap_info_create_gap (wr, prd, &gi));
+}
+
+static uint32_t replay_sample (struct replay_msgs *rm, struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd)
+{
+  /* all fragments: unlike a retransmit, the reader hasn't seen anything of it yet */
+  const uint32_t fragment_size = wr->e.gv->config.fragment_size;
+  const uint32_t size = ddsi_serdata_size (serdata);
+  uint32_t nfrags = (size + fragment_size - 1) / fragment_size, sent = 0;
+  if (nfrags == 0)
+    nfrags = 1;
+  for (uint32_t i = 0; i < nfrags; i++)
+  {
+    struct ddsi_xmsg *fmsg = NULL;
+    if (ddsi_create_fragment_message (wr, seq, serdata, i, 1, prd, &fmsg, 0, (i + 1) == nfrags ? i : UINT32_MAX) >= 0 && fmsg != NULL)
+    {
+      sent += (uint32_t) ddsi_xmsg_size (fmsg);
+      replay_msgs_add (rm, fmsg);
+    }
+  }
+  return sent;
+}
+
+static void replay_heartbeat (struct replay_msgs *rm, struct ddsi_writer *wr, struct ddsi_proxy_reader *prd)
+{
+  struct ddsi_whc_state whcst;
+  struct ddsi_xmsg *msg;
+  ddsi_whc_get_state (wr->whc, &whcst);
+  if ((msg = ddsi_xmsg_new (wr->e.gv->xmsgpool, &wr->e.guid, wr->c.pp, 0, DDSI_XMSG_KIND_CONTROL)) == NULL)
+    return;
+  ddsi_xmsg_setdst_prd (msg, prd);
+  ddsi_add_heartbeat (msg, wr, &whcst, DDSI_HBC_ACK_REQ_YES, 0, prd->e.guid.entityid, 0);
+  if (ddsi_xmsg_size (msg) == 0)
+    ddsi_xmsg_free (msg);
+  else
+    replay_msgs_add (rm, msg);
+}
+
+static void history_replay_xevent_cb (struct ddsi_domaingv *gv, struct ddsi_xevent *ev, struct ddsi_xpack *xp, void *varg, ddsrt_mtime_t tnow)
+{
+  struct history_replay_xevent_cb_arg const * const arg = varg;
+  struct ddsi_writer *wr;
+  struct ddsi_proxy_reader *prd;
+  struct ddsi_wr_prd_match *m;
+  if ((wr = ddsi_entidx_lookup_writer_guid (gv->entity_index, &arg->wr_guid)) == NULL ||
+      (prd = ddsi_entidx_lookup_proxy_reader_guid (gv->entity_index, &arg->prd_guid)) == NULL)
+  {
+    GVTRACE ("history_replay(wr "PGUIDFMT" prd "PGUIDFMT") gone\n", PGUID (arg->wr_guid), PGUID (arg->prd_guid));
+    ddsi_delete_xevent (ev);
+    return;
+  }
+
+  ddsrt_mutex_lock (&wr->e.lock);
+  if ((m = ddsrt_avl_lookup (&ddsi_wr_readers_treedef, &wr->readers, &prd->e.guid)) == NULL || m->replay_seq == 0)
+  {
+    ddsrt_mutex_unlock (&wr->e.lock);
+    ddsi_delete_xevent (ev);
+    return;
+  }
+
+  struct replay_msgs rm = { .n = 0, .size = 0, .ms = NULL };
+  const uint32_t budget = gv->config.history_replay_burst_size;
+  const ddsi_seqno_t seq0 = m->replay_seq;
+  ddsi_seqno_t seq = m->replay_seq, gapstart = 0;
+  uint32_t sent = 0;
+  while (seq <= m->replay_end && sent < budget)
+  {
+    struct ddsi_whc_borrowed_sample sample;
+    const ddsi_seqno_t next_seq = ddsi_whc_next_seq (wr->whc, seq - 1);
+    if (next_seq > seq || !ddsi_whc_borrow_sample (wr->whc, seq, &sample))
+    {
+      if (gapstart == 0)
+        gapstart = seq;
+      if (next_seq <= seq)
+        seq++;
+      else
+        seq = (next_seq > m->replay_end) ? m->replay_end + 1 : next_seq;
+      continue;
+    }
+    if ((prd->filter && !prd->filter (wr, prd, sample.serdata)) || ddsi_writer_content_filter_rejects (wr, prd, m, &sample))
+    {
+      if (gapstart == 0)
+        gapstart = seq;
+    }
+    else
+    {
+      if (gapstart != 0)
+      {
+        replay_gap (&rm, wr, prd, gapstart, seq);
+        gapstart = 0;
+      }
+      sent += replay_sample (&rm, wr, seq, sample.serdata, prd);
+    }
+    ddsi_whc_return_sample (wr->whc, &sample, false);
+    seq++;
+  }
+  if (gapstart != 0)
+    replay_gap (&rm, wr, prd, gapstart, seq);
+  replay_heartbeat (&rm, wr, prd);
+
+  const bool done = (seq > m->replay_end);
+  ETRACE (wr, "history_replay(wr "PGUIDFMT" prd "PGUIDFMT") %"PRIu64"..%"PRIu64" of %"PRIu64" %"PRIu32" bytes%s\n",
+          PGUID (wr->e.guid), PGUID (prd->e.guid), seq0, seq - 1, m->replay_end, sent, done ? " done" : "");
+  wr->replay_bytes += sent;
+  if (!done)
+    m->replay_seq = seq;
+  else
+  {
+    m->replay_seq = 0;
+    wr->num_readers_replaying--;
+  }
+  ddsrt_mutex_unlock (&wr->e.lock);
+
+  for (uint32_t i = 0; i < rm.n; i++)
+    ddsi_xpack_addmsg (xp, rm.ms[i], 0);
+  ddsrt_free (rm.ms);
+
+  if (done)
+    ddsi_delete_xevent (ev);
+  else
+    (void) ddsi_resched_xevent_if_earlier (ev, ddsrt_mtime_add_duration (tnow, gv->config.history_replay_interval));
+}
+
+void ddsi_writer_start_history_replay (struct ddsi_writer *wr, struct ddsi_wr_prd_match *m, const struct ddsi_proxy_reader *prd)
+{
+  struct ddsi_domaingv * const gv = wr->e.gv;
+  struct ddsi_whc_state whcst;
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  assert (m->replay_seq == 0);
+
+  /* only reliable readers that need the history and don't get it via PSMX, the
+     others are considered to have acknowledged everything */
+  if (gv->config.history_replay_burst_size == 0 || !m->is_reliable || m->via_psmx || m->seq == DDSI_MAX_SEQ_NUMBER)
+    return;
+  if (wr->xqos->durability.kind == DDS_DURABILITY_VOLATILE || prd->c.xqos->durability.kind == DDS_DURABILITY_VOLATILE)
+    return;
+  /* anything beyond what has been transmitted already goes out in the normal manner */
+  const ddsi_seqno_t seq_xmit = ddsi_writer_read_seq_xmit (wr);
+  ddsi_whc_get_state (wr->whc, &whcst);
+  if (DDSI_WHCST_ISEMPTY (&whcst) || whcst.min_seq > seq_xmit)
+    return;
+
+  m->replay_seq = whcst.min_seq;
+  m->replay_end = seq_xmit;
+  wr->num_readers_replaying++;
+  ELOGDISC (wr, "  history_replay(wr "PGUIDFMT" prd "PGUIDFMT") - seq %"PRIu64"..%"PRIu64"\n",
+            PGUID (wr->e.guid), PGUID (prd->e.guid), m->replay_seq, m->replay_end);
+}
+
+void ddsi_writer_schedule_history_replay (struct ddsi_writer *wr, struct ddsi_wr_prd_match *m)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  assert (m->replay_seq != 0 && !m->replay_scheduled);
+  struct history_replay_xevent_cb_arg arg = { .wr_guid = wr->e.guid, .prd_guid = m->prd_guid };
+  m->replay_scheduled = 1;
+  (void) ddsi_qxev_callback (wr->evq, ddsrt_time_monotonic (), history_replay_xevent_cb, &arg, sizeof (arg), false);
+}
+
+bool ddsi_history_replay_pending (const struct ddsi_wr_prd_match *m, ddsi_seqno_t seq)
+{
+  return m->replay_seq != 0 && seq >= m->replay_seq && seq <= m->replay_end;
+}
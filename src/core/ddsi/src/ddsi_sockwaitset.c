@@ -248,7 +248,7 @@ void ddsi_sock_waitset_remove (struct ddsi_sock_waitset * ws, struct ddsi_tran_c
   ddsrt_mutex_unlock (&ws->lock);
 }
 
-struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset * ws)
+static struct ddsi_sock_waitset_ctx * sock_waitset_wait_int (struct ddsi_sock_waitset * ws, bool block)
 {
   /* if the array of events is smaller than the number of file descriptors in the
      kqueue, things will still work fine, as the kernel will just return what can
@@ -260,7 +260,8 @@ struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset
     ws->ctx.evs_sz = ws_sz;
     ws->ctx.evs = ddsrt_realloc (ws->ctx.evs, ws_sz * sizeof(*ws->ctx.evs));
   }
-  nevs = kevent (ws->kqueue, NULL, 0, ws->ctx.evs, (int)ws->ctx.evs_sz, NULL);
+  const struct timespec zero = { 0, 0 };
+  nevs = kevent (ws->kqueue, NULL, 0, ws->ctx.evs, (int)ws->ctx.evs_sz, block ? NULL : &zero);
   if (nevs < 0)
   {
     if (errno == EINTR)
@@ -506,7 +507,7 @@ void ddsi_sock_waitset_remove (struct ddsi_sock_waitset * ws, struct ddsi_tran_c
   ddsrt_mutex_unlock (&ws->lock);
 }
 
-struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset * ws)
+static struct ddsi_sock_waitset_ctx * sock_waitset_wait_int (struct ddsi_sock_waitset * ws, bool block)
 {
   /* if the array of events is smaller than the number of file descriptors in the
      kqueue, things will still work fine, as the kernel will just return what can
@@ -518,7 +519,7 @@ struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset
     ws->ctx.evs_sz = ws_sz;
     ws->ctx.evs = ddsrt_realloc (ws->ctx.evs, ws_sz * sizeof(*ws->ctx.evs));
   }
-  nevs = epoll_wait (ws->epfd, ws->ctx.evs, (int)ws->ctx.evs_sz, -1);
+  nevs = epoll_wait (ws->epfd, ws->ctx.evs, (int)ws->ctx.evs_sz, block ? -1 : 0);
   if (nevs < 0)
   {
     if (errno == EINTR)
@@ -680,7 +681,7 @@ int ddsi_sock_waitset_add (struct ddsi_sock_waitset * ws, struct ddsi_tran_conn
   return ret;
 }
 
-struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset * ws)
+static struct ddsi_sock_waitset_ctx * sock_waitset_wait_int (struct ddsi_sock_waitset * ws, bool block)
 {
   unsigned idx;
 
@@ -690,11 +691,13 @@ struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset
   ws->ctx0 = ws->ctx;
   ddsrt_mutex_unlock (&ws->mutex);
 
-  if ((idx = WSAWaitForMultipleEvents (ws->ctx0.n, ws->ctx0.events, FALSE, WSA_INFINITE, FALSE)) == WSA_WAIT_FAILED)
+  if ((idx = WSAWaitForMultipleEvents (ws->ctx0.n, ws->ctx0.events, FALSE, block ? WSA_INFINITE : 0, FALSE)) == WSA_WAIT_FAILED)
   {
     DDS_WARNING("ddsi_sock_waitset_wait: WSAWaitForMultipleEvents(%d,...,0,0,0) failed, error %d\n", ws->ctx0.n, os_getErrno ());
     return NULL;
   }
+  if (idx == WSA_WAIT_TIMEOUT)
+    return NULL;
 
 #ifndef WAIT_IO_COMPLETION /* curious omission in the WinCE headers */
 #define TEMP_DEF_WAIT_IO_COMPLETION
@@ -1101,7 +1104,7 @@ void ddsi_sock_waitset_remove (struct ddsi_sock_waitset * ws, struct ddsi_tran_c
   ddsrt_mutex_unlock (&ws->mutex);
 }
 
-struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset * ws)
+static struct ddsi_sock_waitset_ctx * sock_waitset_wait_int (struct ddsi_sock_waitset * ws, bool block)
 {
   unsigned u;
 #if !_WIN32
@@ -1155,7 +1158,9 @@ struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset
   dds_return_t rc;
   do
   {
-    rc = ddsrt_select (fdmax, rdset, NULL, NULL, DDS_INFINITY);
+    rc = ddsrt_select (fdmax, rdset, NULL, NULL, block ? DDS_INFINITY : 0);
+    if (rc == DDS_RETCODE_TIMEOUT)
+      break;
     if (rc < 0 && rc != DDS_RETCODE_INTERRUPTED && rc != DDS_RETCODE_TRY_AGAIN)
     {
       DDS_WARNING("ddsi_sock_waitset_wait: select failed, retcode = %"PRId32, rc);
@@ -1220,3 +1225,13 @@ DDSRT_WARNING_GNUC_ON(sign-conversion)
 #else
 #error "no mode selected"
 #endif
+
+struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_wait (struct ddsi_sock_waitset * ws)
+{
+  return sock_waitset_wait_int (ws, true);
+}
+
+struct ddsi_sock_waitset_ctx * ddsi_sock_waitset_poll (struct ddsi_sock_waitset * ws)
+{
+  return sock_waitset_wait_int (ws, false);
+}
@@ -18,6 +18,7 @@
 #include "ddsi__endpoint_match.h"
 #include "ddsi__radmin.h"
 #include "ddsi__proxy_endpoint.h"
+#include "ddsi__whc.h"
 
 void ddsi_get_writer_stats (struct ddsi_writer *wr, uint64_t *rexmit_bytes, uint32_t *throttle_count, uint64_t *time_throttled, uint64_t *time_retransmit)
 {
@@ -29,6 +30,23 @@ void ddsi_get_writer_stats (struct ddsi_writer *wr, uint64_t *rexmit_bytes, uint
   ddsrt_mutex_unlock (&wr->e.lock);
 }
 
+void ddsi_get_writer_whc_stats (struct ddsi_writer *wr, uint64_t *unacked_bytes, uint64_t *domain_unacked_bytes)
+{
+  // the domain-wide total is updated independently of this writer
+  struct ddsi_whc_state whcst;
+  ddsi_whc_get_state (wr->whc, &whcst);
+  *unacked_bytes = whcst.unacked_bytes;
+  *domain_unacked_bytes = ddsrt_atomic_ld64 (&wr->e.gv->whc_unacked_bytes);
+}
+
+void ddsi_get_writer_replay_stats (struct ddsi_writer *wr, uint64_t *replay_bytes, uint32_t *readers_replaying)
+{
+  ddsrt_mutex_lock (&wr->e.lock);
+  *replay_bytes = wr->replay_bytes;
+  *readers_replaying = wr->num_readers_replaying;
+  ddsrt_mutex_unlock (&wr->e.lock);
+}
+
 void ddsi_get_reader_stats (struct ddsi_reader *rd, uint64_t *discarded_bytes)
 {
   struct ddsi_rd_pwr_match *m;
@@ -65,3 +83,12 @@ void ddsi_get_reader_stats (struct ddsi_reader *rd, uint64_t *discarded_bytes)
   }
   ddsrt_mutex_unlock (&rd->e.lock);
 }
+
+void ddsi_get_reader_rx_latency_stats (struct ddsi_reader *rd, uint64_t *samples, uint64_t *kernel_to_recv, uint64_t *recv_to_deliver, uint64_t *deliver_to_store)
+{
+  // updated without holding a lock, so not necessarily mutually consistent
+  *samples = ddsrt_atomic_ld64 (&rd->rx_latency.samples);
+  *kernel_to_recv = ddsrt_atomic_ld64 (&rd->rx_latency.kernel_to_recv);
+  *recv_to_deliver = ddsrt_atomic_ld64 (&rd->rx_latency.recv_to_deliver);
+  *deliver_to_store = ddsrt_atomic_ld64 (&rd->rx_latency.deliver_to_store);
+}
@@ -516,6 +516,8 @@ static dds_return_t ddsi_tcp_conn_read (struct ddsi_tran_conn * conn, unsigned c
             const int32_t kind = addrfam_to_locator_kind (tcp->m_peer_addr.a.sa_family);
             ddsi_ipaddr_to_loc (&pktinfo->src, &tcp->m_peer_addr.a, kind);
             pktinfo->if_index = 0;
+            pktinfo->segsize = 0;
+            pktinfo->timestamp = DDSRT_WCTIME_INVALID;
             pktinfo->dst.kind = DDSI_LOCATOR_KIND_INVALID;
           }
           *bytes_read = pos;
@@ -1033,9 +1035,14 @@ static void ddsi_tcp_base_init (const struct ddsi_tran_factory_tcp *fact, const
   base->m_base.m_trantype = DDSI_TRAN_CONN;
   base->m_base.m_handle_fn = ddsi_tcp_conn_handle;
   base->m_read_fn = ddsi_tcp_conn_read;
+  base->m_read_multiple_fn = 0;
   base->m_write_fn = ddsi_tcp_conn_write;
+  base->m_write_multiple_fn = 0;
+  base->m_write_segmented_fn = 0;
+  base->m_write_zerocopy_fn = 0;
   base->m_peer_locator_fn = ddsi_tcp_conn_peer_locator;
   base->m_disable_multiplexing_fn = 0;
+  base->m_set_busy_poll_fn = 0;
   base->m_locator_fn = ddsi_tcp_locator;
 }
 
@@ -22,6 +22,7 @@
 #include "dds/ddsi/ddsi_threadmon.h"
 #include "dds/ddsi/ddsi_log.h"
 #include "dds/ddsi/ddsi_domaingv.h"
+#include "dds/ddsi/ddsi_freelist.h"
 #include "ddsi__thread.h"
 #include "ddsi__sysdeps.h"
 
@@ -261,6 +262,8 @@ static uint32_t create_thread_wrapper (void *ptr)
   ddsrt_mutex_lock (&thread_states.lock);
   thrst->state = DDSI_THREAD_STATE_STOPPED;
   ddsrt_mutex_unlock (&thread_states.lock);
+  /* stopped threads don't get a new cache, so flushing it here is final */
+  ddsi_freelist_thread_cache_release (thrst);
   tsd_thread_state = NULL;
   return ret;
 }
@@ -370,6 +373,7 @@ dds_return_t ddsi_create_thread (struct ddsi_thread_state **thrst, const struct
 
 static void reap_thread_state (struct ddsi_thread_state *thrst, bool in_ddsi_thread_states_fini)
 {
+  ddsi_freelist_thread_cache_release (thrst);
   ddsrt_mutex_lock (&thread_states.lock);
   switch (thrst->state)
   {
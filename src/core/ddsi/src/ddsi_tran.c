@@ -36,7 +36,12 @@ extern inline int ddsi_listener_locator (struct ddsi_tran_listener * listener, d
 extern inline int ddsi_listener_listen (struct ddsi_tran_listener * listener);
 extern inline struct ddsi_tran_conn * ddsi_listener_accept (struct ddsi_tran_listener * listener);
 extern inline dds_return_t ddsi_conn_read (struct ddsi_tran_conn * conn, unsigned char * buf, size_t len, bool allow_spurious, struct ddsi_network_packet_info *pktinfo, size_t *bytes_read);
+extern inline dds_return_t ddsi_conn_read_multiple (struct ddsi_tran_conn * conn, ddsi_tran_read_buf_t *bufs, size_t nbufs, bool allow_spurious, size_t *nread);
 extern inline dds_return_t ddsi_conn_write (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t flags, size_t *bytes_written);
+extern inline void ddsi_conn_write_multiple (struct ddsi_tran_conn * conn, ddsi_tran_write_buf_t *bufs, size_t nbufs, uint32_t flags);
+extern inline dds_return_t ddsi_conn_write_zerocopy (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, ddsi_tran_write_keepalive_t *keepalive, uint32_t flags, size_t *bytes_written);
+extern inline void ddsi_tran_write_keepalive_ref (ddsi_tran_write_keepalive_t *keepalive);
+extern inline void ddsi_tran_write_keepalive_unref (ddsi_tran_write_keepalive_t *keepalive);
 extern inline uint32_t ddsi_tran_get_locator_port (const struct ddsi_tran_factory *factory, const ddsi_locator_t *loc);
 extern inline void ddsi_tran_set_locator_port (const struct ddsi_tran_factory *factory, ddsi_locator_t *loc, uint32_t port);
 extern inline uint32_t ddsi_tran_get_locator_aux (const struct ddsi_tran_factory *factory, const ddsi_locator_t *loc);
@@ -188,6 +193,61 @@ void ddsi_conn_disable_multiplexing (struct ddsi_tran_conn * conn)
     (conn->m_disable_multiplexing_fn) (conn);
 }
 
+dds_return_t ddsi_conn_set_busy_poll (struct ddsi_tran_conn * conn, dds_duration_t spin, dds_duration_t sock_busy_poll)
+{
+  if (conn->m_set_busy_poll_fn == 0)
+    return (spin > 0 || sock_busy_poll > 0) ? DDS_RETCODE_UNSUPPORTED : DDS_RETCODE_OK;
+  return (conn->m_set_busy_poll_fn) (conn, spin, sock_busy_poll);
+}
+
+dds_return_t ddsi_conn_write_segments (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t segsize, uint32_t flags, size_t *bytes_written)
+{
+  // A datagram covers a contiguous range of the input iovecs, splitting the ones
+  // at the ends of the range, and so never needs more iovecs than the input
+  ddsi_tran_write_msgfrags_t *seg;
+  dds_return_t rc = DDS_RETCODE_OK;
+  size_t total = 0;
+  assert (segsize > 0);
+  if ((seg = ddsrt_malloc (sizeof (*seg) + msgfrags->niov * sizeof (ddsrt_iovec_t))) == NULL)
+    return DDS_RETCODE_OUT_OF_RESOURCES;
+  size_t i = 0, off = 0;
+  while (i < msgfrags->niov && rc == DDS_RETCODE_OK)
+  {
+    size_t rem = segsize, n;
+    seg->niov = 0;
+    while (rem > 0 && i < msgfrags->niov)
+    {
+      const size_t avail = (size_t) msgfrags->iov[i].iov_len - off;
+      const size_t take = (avail < rem) ? avail : rem;
+      seg->iov[seg->niov].iov_base = (char *) msgfrags->iov[i].iov_base + off;
+      seg->iov[seg->niov].iov_len = (ddsrt_iov_len_t) take;
+      seg->niov++;
+      rem -= take;
+      if ((off += take) == (size_t) msgfrags->iov[i].iov_len)
+      {
+        i++;
+        off = 0;
+      }
+    }
+    if ((rc = conn->m_write_fn (conn, dst, seg, flags, &n)) == DDS_RETCODE_OK)
+      total += n;
+  }
+  ddsrt_free (seg);
+  if (bytes_written)
+    *bytes_written = total;
+  return rc;
+}
+
+dds_return_t ddsi_conn_write_segmented (struct ddsi_tran_conn * conn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t segsize, uint32_t flags, size_t *bytes_written)
+{
+  if (conn->m_closed)
+    return DDS_RETCODE_ALREADY_DELETED;
+  else if (conn->m_write_segmented_fn)
+    return conn->m_write_segmented_fn (conn, dst, msgfrags, segsize, flags, bytes_written);
+  else
+    return ddsi_conn_write_segments (conn, dst, msgfrags, segsize, flags, bytes_written);
+}
+
 bool ddsi_conn_peer_locator (struct ddsi_tran_conn * conn, ddsi_locator_t * loc)
 {
   if (conn->m_peer_locator_fn)
@@ -124,7 +124,26 @@ static dds_return_t ddsi_create_fragment_message_simple (struct ddsi_writer *wr,
   return 0;
 }
 
-dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, uint32_t fragnum, uint16_t nfrags, const struct ddsi_proxy_reader *prd, struct ddsi_xmsg **pmsg, int isnew, uint32_t advertised_fragnum)
+/* The writer state that goes into DATA, DATA_FRAG and HEARTBEAT_FRAG messages besides the
+   constant attributes, either taken directly from the writer while holding its lock, or a
+   snapshot for retransmitting after releasing it (see ddsi_rexmit_batch_send) */
+struct writer_xmit_info {
+  struct ddsi_addrset *as;
+  int64_t maxdelay;
+  bool keyhash;
+  ddsi_count_t *hbfragcount;
+};
+
+static void writer_xmit_info_init_wrlock_held (struct writer_xmit_info *xi, struct ddsi_writer *wr)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  xi->as = wr->as;
+  xi->maxdelay = wr->xqos->latency_budget.duration;
+  xi->keyhash = (wr->num_readers_requesting_keyhash > 0);
+  xi->hbfragcount = &wr->hbfragcount;
+}
+
+static dds_return_t create_fragment_message (struct ddsi_writer *wr, const struct writer_xmit_info *xi, ddsi_seqno_t seq, struct ddsi_serdata *serdata, uint32_t fragnum, uint16_t nfrags, const struct ddsi_proxy_reader *prd, struct ddsi_xmsg **pmsg, int isnew, uint32_t advertised_fragnum)
 {
   /* We always fragment into FRAGMENT_SIZEd fragments, which are near
      the smallest allowed fragment size & can't be bothered (yet) to
@@ -150,8 +169,6 @@ dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t
   const uint32_t size = ddsi_serdata_size (serdata);
   dds_return_t ret = 0;
 
-  ASSERT_MUTEX_HELD (&wr->e.lock);
-
   if (fragnum * (uint32_t) gv->config.fragment_size >= size && size > 0)
   {
     /* This is the first chance to detect an attempt at retransmitting
@@ -174,8 +191,8 @@ dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t
   }
   else
   {
-    ddsi_xmsg_setdst_addrset (*pmsg, wr->as);
-    ddsi_xmsg_setmaxdelay (*pmsg, wr->xqos->latency_budget.duration);
+    ddsi_xmsg_setdst_addrset (*pmsg, xi->as);
+    ddsi_xmsg_setmaxdelay (*pmsg, xi->maxdelay);
   }
 
   /* Timestamp only needed once, for the first fragment */
@@ -252,7 +269,7 @@ dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t
   {
     int rc;
     /* Adding parameters means potential reallocing, so sm, ddcmn now likely become invalid */
-    if (wr->num_readers_requesting_keyhash > 0)
+    if (xi->keyhash)
     {
       ddsi_xmsg_addpar_keyhash (*pmsg, serdata, wr->force_md5_keyhash);
     }
@@ -288,18 +305,24 @@ dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t
   return ret;
 }
 
-static void create_HeartbeatFrag (struct ddsi_writer *wr, ddsi_seqno_t seq, unsigned fragnum, struct ddsi_proxy_reader *prd, struct ddsi_xmsg **pmsg)
+dds_return_t ddsi_create_fragment_message (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, uint32_t fragnum, uint16_t nfrags, const struct ddsi_proxy_reader *prd, struct ddsi_xmsg **pmsg, int isnew, uint32_t advertised_fragnum)
+{
+  struct writer_xmit_info xi;
+  writer_xmit_info_init_wrlock_held (&xi, wr);
+  return create_fragment_message (wr, &xi, seq, serdata, fragnum, nfrags, prd, pmsg, isnew, advertised_fragnum);
+}
+
+static void create_HeartbeatFrag (struct ddsi_writer *wr, const struct writer_xmit_info *xi, ddsi_seqno_t seq, unsigned fragnum, struct ddsi_proxy_reader *prd, struct ddsi_xmsg **pmsg)
 {
   struct ddsi_domaingv const * const gv = wr->e.gv;
   struct ddsi_xmsg_marker sm_marker;
   ddsi_rtps_heartbeatfrag_t *hbf;
-  ASSERT_MUTEX_HELD (&wr->e.lock);
   if ((*pmsg = ddsi_xmsg_new (gv->xmsgpool, &wr->e.guid, wr->c.pp, sizeof (ddsi_rtps_heartbeatfrag_t), DDSI_XMSG_KIND_CONTROL)) == NULL)
     return; /* ignore out-of-memory: HeartbeatFrag is only advisory anyway */
   if (prd)
     ddsi_xmsg_setdst_prd (*pmsg, prd);
   else
-    ddsi_xmsg_setdst_addrset (*pmsg, wr->as);
+    ddsi_xmsg_setdst_addrset (*pmsg, xi->as);
   hbf = ddsi_xmsg_append (*pmsg, &sm_marker, sizeof (ddsi_rtps_heartbeatfrag_t));
   ddsi_xmsg_submsg_init (*pmsg, sm_marker, DDSI_RTPS_SMID_HEARTBEAT_FRAG);
   hbf->readerId = ddsi_hton_entityid (prd ? prd->e.guid.entityid : ddsi_to_entityid (DDSI_ENTITYID_UNKNOWN));
@@ -307,7 +330,7 @@ static void create_HeartbeatFrag (struct ddsi_writer *wr, ddsi_seqno_t seq, unsi
   hbf->writerSN = ddsi_to_seqno (seq);
   hbf->lastFragmentNum = fragnum + 1; /* network format is 1 based */
 
-  hbf->count = wr->hbfragcount++;
+  hbf->count = (*xi->hbfragcount)++;
 
   ddsi_xmsg_submsg_setnext (*pmsg, sm_marker);
   ddsi_security_encode_datawriter_submsg(*pmsg, sm_marker, wr);
@@ -406,11 +429,13 @@ static void transmit_sample_lgmsg_unlocks_wr (struct ddsi_xpack *xp, struct ddsi
        eventually we'll have to retry.  But if a packet went out and
        we haven't yet completed transmitting a fragmented message, add
        a HeartbeatFrag. */
-    ret = ddsi_create_fragment_message (wr, seq, serdata, i, (uint16_t) nf_in_submsg, prd, &fmsg, isnew, i + nf_in_submsg == nfrags_lim ? nfrags - 1 : UINT32_MAX);
+    struct writer_xmit_info xi;
+    writer_xmit_info_init_wrlock_held (&xi, wr);
+    ret = create_fragment_message (wr, &xi, seq, serdata, i, (uint16_t) nf_in_submsg, prd, &fmsg, isnew, i + nf_in_submsg == nfrags_lim ? nfrags - 1 : UINT32_MAX);
     if (ret >= 0 && i + nf_in_submsg < nfrags_lim && wr->heartbeat_xevent)
     {
       // more fragment messages to come
-      create_HeartbeatFrag (wr, seq, i + nf_in_submsg - 1, prd, &hmsg);
+      create_HeartbeatFrag (wr, &xi, seq, i + nf_in_submsg - 1, prd, &hmsg);
     }
     ddsrt_mutex_unlock (&wr->e.lock);
 
@@ -471,16 +496,10 @@ void ddsi_enqueue_spdp_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t
     ddsi_qxev_msg (wr->evq, msg);
 }
 
-int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd, int isnew)
+static uint32_t enqueue_sample_nfrags (struct ddsi_domaingv const * const gv, const struct ddsi_serdata *serdata, int isnew)
 {
-  struct ddsi_domaingv const * const gv = wr->e.gv;
-  uint32_t i, sz, nfrags;
-  enum ddsi_qxev_msg_rexmit_result enqueued = DDSI_QXEV_MSG_REXMIT_QUEUED;
-
-  ASSERT_MUTEX_HELD (&wr->e.lock);
-
-  sz = ddsi_serdata_size (serdata);
-  nfrags = (sz + gv->config.fragment_size - 1) / gv->config.fragment_size;
+  const uint32_t sz = ddsi_serdata_size (serdata);
+  uint32_t nfrags = (sz + gv->config.fragment_size - 1) / gv->config.fragment_size;
   if (nfrags == 0)
   {
     /* end-of-transaction messages are empty, but still need to be sent */
@@ -495,7 +514,14 @@ int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, s
        (I am not aware of any implementations that never use NACKFRAG.) */
     nfrags = gv->config.max_frags_in_rexmit_of_sample;
   }
-  for (i = 0; i < nfrags && enqueued != DDSI_QXEV_MSG_REXMIT_DROPPED; i++)
+  return nfrags;
+}
+
+static int enqueue_sample (struct ddsi_writer *wr, const struct writer_xmit_info *xi, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd, int isnew)
+{
+  const uint32_t nfrags = enqueue_sample_nfrags (wr->e.gv, serdata, isnew);
+  enum ddsi_qxev_msg_rexmit_result enqueued = DDSI_QXEV_MSG_REXMIT_QUEUED;
+  for (uint32_t i = 0; i < nfrags && enqueued != DDSI_QXEV_MSG_REXMIT_DROPPED; i++)
   {
     struct ddsi_xmsg *fmsg = NULL;
     struct ddsi_xmsg *hmsg = NULL;
@@ -503,10 +529,10 @@ int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, s
        eventually we'll have to retry.  But if a packet went out and
        we haven't yet completed transmitting a fragmented message, add
        a HeartbeatFrag. */
-    if (ddsi_create_fragment_message (wr, seq, serdata, i, 1, prd, &fmsg, isnew, (i+1) == nfrags ? i : UINT32_MAX) >= 0)
+    if (create_fragment_message (wr, xi, seq, serdata, i, 1, prd, &fmsg, isnew, (i+1) == nfrags ? i : UINT32_MAX) >= 0)
     {
       if (nfrags > 1 && i + 1 < nfrags)
-        create_HeartbeatFrag (wr, seq, i, prd, &hmsg);
+        create_HeartbeatFrag (wr, xi, seq, i, prd, &hmsg);
     }
     if (isnew)
     {
@@ -523,7 +549,7 @@ int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, s
       const int force = 0;
       if(fmsg)
       {
-        enqueued = ddsi_qxev_msg_rexmit_wrlock_held (wr->evq, fmsg, force);
+        enqueued = ddsi_qxev_msg_rexmit (wr->evq, fmsg, xi->as, force);
       }
       /* Functioning of the system is not dependent on getting the
          HeartbeatFrags out, so never force them into the queue. */
@@ -545,7 +571,62 @@ int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, s
   return (enqueued != DDSI_QXEV_MSG_REXMIT_DROPPED) ? 0 : -1;
 }
 
-static int insert_sample_in_whc (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk)
+int ddsi_enqueue_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd, int isnew)
+{
+  struct writer_xmit_info xi;
+  writer_xmit_info_init_wrlock_held (&xi, wr);
+  return enqueue_sample (wr, &xi, seq, serdata, prd, isnew);
+}
+
+void ddsi_rexmit_batch_init (struct ddsi_rexmit_batch *rb)
+{
+  rb->as = NULL;
+  rb->n = 0;
+}
+
+bool ddsi_rexmit_batch_add_wrlock_held (struct ddsi_writer *wr, struct ddsi_rexmit_batch *rb, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_proxy_reader *prd)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  if (rb->n == DDSI_REXMIT_BATCH_MAX)
+    return false;
+  if (rb->as == NULL)
+  {
+    rb->as = ddsi_ref_addrset (wr->as);
+    rb->maxdelay = wr->xqos->latency_budget.duration;
+    rb->keyhash = (wr->num_readers_requesting_keyhash > 0);
+  }
+  struct ddsi_rexmit_batch_entry * const e = &rb->xs[rb->n++];
+  e->seq = seq;
+  e->serdata = ddsi_serdata_ref (serdata);
+  e->prd = prd;
+  /* HeartbeatFrags go out with all but the last fragment, reserve their counts now */
+  e->hbfragcount = wr->hbfragcount;
+  wr->hbfragcount += enqueue_sample_nfrags (wr->e.gv, serdata, 0) - 1;
+  return true;
+}
+
+bool ddsi_rexmit_batch_send (struct ddsi_writer *wr, struct ddsi_rexmit_batch *rb)
+{
+  bool all_queued = true;
+  for (uint32_t i = 0; i < rb->n; i++)
+  {
+    struct ddsi_rexmit_batch_entry * const e = &rb->xs[i];
+    if (all_queued)
+    {
+      const struct writer_xmit_info xi = {
+        .as = rb->as, .maxdelay = rb->maxdelay, .keyhash = rb->keyhash, .hbfragcount = &e->hbfragcount
+      };
+      all_queued = (enqueue_sample (wr, &xi, e->seq, e->serdata, e->prd, 0) >= 0);
+    }
+    ddsi_serdata_unref (e->serdata);
+  }
+  if (rb->as)
+    ddsi_unref_addrset (rb->as);
+  ddsi_rexmit_batch_init (rb);
+  return all_queued;
+}
+
+static int insert_sample_in_whc (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects)
 {
   /* returns: < 0 on error, 0 if no need to insert in whc, > 0 if inserted */
   int insres, res = 0;
@@ -584,7 +665,7 @@ static int insert_sample_in_whc (struct ddsi_writer *wr, ddsi_seqno_t seq, struc
     if (wr->xqos->lifespan.duration != DDS_INFINITY && (serdata->statusinfo & (DDSI_STATUSINFO_UNREGISTER | DDSI_STATUSINFO_DISPOSE)) == 0)
       exp = ddsrt_mtime_add_duration(serdata->twrite, wr->xqos->lifespan.duration);
 #endif
-    res = ((insres = ddsi_whc_insert (wr->whc, ddsi_writer_max_drop_seq (wr), seq, exp, serdata, tk)) < 0) ? insres : 1;
+    res = ((insres = ddsi_whc_insert (wr->whc, ddsi_writer_max_drop_seq (wr), seq, exp, serdata, tk, filter_rejects)) < 0) ? insres : 1;
 
 #ifdef DDS_HAS_DEADLINE_MISSED
     if (!(wr->reliable && have_reliable_subs (wr)) && !wr->handle_as_transient_local)
@@ -615,9 +696,90 @@ static int insert_sample_in_whc (struct ddsi_writer *wr, ddsi_seqno_t seq, struc
   return res;
 }
 
+static bool writer_over_whc_budget (const struct ddsi_writer *wr, const struct ddsi_whc_state *whcst)
+{
+  /* Once all WHCs together exceed the budget, the writers holding more than an
+     equal share of it are throttled: this always includes the largest ones.
+     Writers that never block (KEEP_LAST) are exempt. */
+  struct ddsi_domaingv const * const gv = wr->e.gv;
+  if (gv->config.whc_budget == 0 || wr->whc_high == INT32_MAX)
+    return false;
+  if (ddsrt_atomic_ld64 (&gv->whc_unacked_bytes) <= gv->config.whc_budget)
+    return false;
+  const uint32_t nwriters = ddsrt_atomic_ld32 (&gv->whc_unacked_writers);
+  return nwriters > 0 && whcst->unacked_bytes > gv->config.whc_budget / nwriters;
+}
+
+static bool writer_filters_out_sample (const struct ddsi_writer *wr, uint64_t filter_rejects)
+{
+  /* A sample that none of the remote readers wants need not be sent at all, provided
+     it is not also needed for late-joining readers or deadline tracking, and is data
+     rather than a change in instance state (those are never rejected). It then doesn't
+     get a sequence number either, so the readers don't observe a gap. */
+  if (wr->num_readers_filtered == 0 || wr->num_readers_filtered != wr->num_readers)
+    return false;
+  if (wr->xqos->durability.kind != DDS_DURABILITY_VOLATILE || wr->xqos->deadline.deadline != DDS_INFINITY)
+    return false;
+  return filter_rejects == wr->content_filters_in_use;
+}
+
+static bool reader_rejects (const struct ddsi_wr_prd_match *m, uint64_t filter_rejects)
+{
+  return m->content_filter_slot >= 0 && ((filter_rejects >> m->content_filter_slot) & 1);
+}
+
+static void enqueue_filtered_sample_wrlock_held (struct ddsi_writer *wr, ddsi_seqno_t seq, struct ddsi_serdata *serdata, uint64_t filter_rejects)
+{
+  /* Some of the readers reject the sample. Cyclone processes a message addressed to one
+     reader for all readers in sync, so once per participant suffices for it, and if any
+     reader in a DDSI instance accepts the sample, sending it to that one covers the others
+     in that instance. Others need a message for each reader: the sample if it accepts it, a
+     GAP if it is reliable and rejects it, so it doesn't request it in response to a
+     heartbeat. The readers of an instance are adjacent in wr->readers. */
+  struct ddsi_domaingv * const gv = wr->e.gv;
+  bool sent = false;
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  struct ddsi_wr_prd_match *m = ddsrt_avl_find_min (&ddsi_wr_readers_treedef, &wr->readers);
+  while (m != NULL)
+  {
+    struct ddsi_wr_prd_match * const first = m;
+    const struct ddsi_wr_prd_match *last = NULL;
+    bool accept = false;
+    for (; m != NULL && ddsi_proxy_readers_may_share_instance (&m->prd_guid, &first->prd_guid); m = ddsrt_avl_find_succ (&ddsi_wr_readers_treedef, &wr->readers, m))
+      accept = accept || (!m->via_psmx && !reader_rejects (m, filter_rejects));
+    for (struct ddsi_wr_prd_match *n = first; n != m; n = ddsrt_avl_find_succ (&ddsi_wr_readers_treedef, &wr->readers, n))
+    {
+      struct ddsi_proxy_reader *prd;
+      if (n->via_psmx || (prd = ddsi_entidx_lookup_proxy_reader_guid (gv->entity_index, &n->prd_guid)) == NULL)
+        continue;
+      if (last && ddsi_guid_prefix_eq (&last->prd_guid.prefix, &n->prd_guid.prefix) && ddsi_vendor_is_eclipse (prd->c.vendor))
+        continue;
+      if (accept && !reader_rejects (n, filter_rejects))
+      {
+        (void) ddsi_enqueue_sample_wrlock_held (wr, seq, serdata, prd, 1);
+        last = n;
+        sent = true;
+      }
+      else if (n->is_reliable && !(accept && ddsi_vendor_is_eclipse (prd->c.vendor)))
+      {
+        struct ddsi_gap_info gi;
+        struct ddsi_xmsg *gap;
+        ddsi_gap_info_init (&gi);
+        ddsi_gap_info_update (gv, &gi, seq);
+        if ((gap = ddsi_gap_info_create_gap (wr, prd, &gi)) != NULL)
+          ddsi_qxev_msg (wr->evq, gap);
+        last = n;
+      }
+    }
+  }
+  /* the retransmit path ignores requests for anything beyond what has been transmitted */
+  if (!sent)
+    ddsi_writer_update_seq_xmit (wr, seq);
+}
+
 static int writer_may_continue (const struct ddsi_writer *wr, const struct ddsi_whc_state *whcst)
 {
-  return (whcst->unacked_bytes <= wr->whc_low && !wr->retransmitting) || (wr->state != WRST_OPERATIONAL);
+  return (whcst->unacked_bytes <= wr->whc_low && !wr->retransmitting && !writer_over_whc_budget (wr, whcst)) || (wr->state != WRST_OPERATIONAL);
 }
 
 static dds_return_t throttle_writer (struct ddsi_thread_state * const thrst, struct ddsi_xpack *xp, struct ddsi_writer *wr)
@@ -785,7 +947,7 @@ int ddsi_write_sample_p2p_wrlock_held(struct ddsi_writer *wr, ddsi_seqno_t seq,
     }
   }
 
-  if ((r = insert_sample_in_whc (wr, seq, serdata, tk)) >= 0)
+  if ((r = insert_sample_in_whc (wr, seq, serdata, tk, 0)) >= 0)
   {
     ddsi_enqueue_sample_wrlock_held (wr, seq, serdata, prd, 1);
 
@@ -844,7 +1006,7 @@ static int write_sample (struct ddsi_thread_state * const thrst, struct ddsi_xpa
   {
     struct ddsi_whc_state whcst;
     ddsi_whc_get_state(wr->whc, &whcst);
-    if (whcst.unacked_bytes > wr->whc_high)
+    if (whcst.unacked_bytes > wr->whc_high || writer_over_whc_budget (wr, &whcst))
     {
       dds_return_t ores;
       assert(gc_allowed); /* also see beginning of the function */
@@ -853,7 +1015,7 @@ static int write_sample (struct ddsi_thread_state * const thrst, struct ddsi_xpa
       else
       {
         maybe_grow_whc (wr);
-        if (whcst.unacked_bytes <= wr->whc_high)
+        if (whcst.unacked_bytes <= wr->whc_high && !writer_over_whc_budget (wr, &whcst))
           ores = DDS_RETCODE_OK;
         else
           ores = throttle_writer (thrst, xp, wr);
@@ -874,13 +1036,22 @@ static int write_sample (struct ddsi_thread_state * const thrst, struct ddsi_xpa
     goto drop;
   }
 
+  /* Each distinct filter is evaluated once, the WHC keeps the result for retransmits */
+  const uint64_t filter_rejects = ddsi_writer_content_filters_eval (wr, serdata);
+  if (writer_filters_out_sample (wr, filter_rejects))
+  {
+    ddsrt_mutex_unlock (&wr->e.lock);
+    r = 0;
+    goto drop;
+  }
+
   /* Always use the current monotonic time */
   tnow = ddsrt_time_monotonic ();
   serdata->twrite = tnow;
 
   seq = ++wr->seq;
   wr->sent_bytes += ddsi_serdata_size (serdata);
-  if ((r = insert_sample_in_whc (wr, seq, serdata, tk)) < 0)
+  if ((r = insert_sample_in_whc (wr, seq, serdata, tk, filter_rejects)) < 0)
   {
     /* Failure of some kind */
     ddsrt_mutex_unlock (&wr->e.lock);
@@ -902,6 +1073,13 @@ static int write_sample (struct ddsi_thread_state * const thrst, struct ddsi_xpa
     ddsi_writer_update_seq_xmit (wr, seq);
     ddsrt_mutex_unlock (&wr->e.lock);
   }
+  else if (filter_rejects != 0)
+  {
+    if (wr->heartbeat_xevent)
+      ddsi_writer_hbcontrol_note_asyncwrite (wr, tnow);
+    enqueue_filtered_sample_wrlock_held (wr, seq, serdata, filter_rejects);
+    ddsrt_mutex_unlock (&wr->e.lock);
+  }
   else
   {
     /* Note the subtlety of enqueueing with the lock held but
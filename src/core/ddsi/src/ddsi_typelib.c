@@ -3286,6 +3286,64 @@ DDS_XTypes_TypeKind ddsi_type_get_kind (const struct ddsi_type *type)
   return type->xt._d;
 }
 
+static const struct ddsi_type *type_unalias (const struct ddsi_type *type)
+{
+  while (type != NULL && type->xt._d == DDS_XTypes_TK_ALIAS)
+    type = type->xt._u.alias.related_type;
+  return type;
+}
+
+static uint32_t struct_member_count (const struct ddsi_type *type)
+{
+  const struct ddsi_type *base = type_unalias (type->xt._u.structure.base_type);
+  return (base ? struct_member_count (base) : 0) + type->xt._u.structure.members.length;
+}
+
+static bool struct_find_member (const struct ddsi_type *type, const char *name, size_t len, uint32_t *index, const struct ddsi_type **member_type)
+{
+  const struct ddsi_type *base = type_unalias (type->xt._u.structure.base_type);
+  uint32_t nbase = 0;
+  if (base != NULL)
+  {
+    if (struct_find_member (base, name, len, index, member_type))
+      return true;
+    nbase = struct_member_count (base);
+  }
+  const struct xt_struct_member_seq *ms = &type->xt._u.structure.members;
+  for (uint32_t i = 0; i < ms->length; i++)
+  {
+    const char *mname = ms->seq[i].detail.name;
+    if (strncmp (mname, name, len) == 0 && mname[len] == 0)
+    {
+      *index = nbase + i;
+      *member_type = ms->seq[i].type;
+      return true;
+    }
+  }
+  return false;
+}
+
+dds_return_t ddsi_type_get_member_path (const struct ddsi_type *type, const char *name, uint32_t maxdepth, uint32_t *indices, uint32_t *depth)
+{
+  if (type->xt.kind != DDSI_TYPEID_KIND_COMPLETE)
+    return DDS_RETCODE_BAD_PARAMETER;
+  *depth = 0;
+  while (true)
+  {
+    const size_t len = strcspn (name, ".");
+    if ((type = type_unalias (type)) == NULL || type->xt._d != DDS_XTypes_TK_STRUCTURE)
+      return DDS_RETCODE_BAD_PARAMETER;
+    if (*depth == maxdepth)
+      return DDS_RETCODE_UNSUPPORTED;
+    if (!struct_find_member (type, name, len, &indices[*depth], &type))
+      return DDS_RETCODE_BAD_PARAMETER;
+    (*depth)++;
+    if (name[len] == 0)
+      return DDS_RETCODE_OK;
+    name += len + 1;
+  }
+}
+
 static void ddsi_type_scc_free_locked (struct ddsi_domaingv *gv, struct ddsi_type_scc *scc)
 {
   const uint32_t n_types = scc->n_types;
@@ -22,6 +22,12 @@
 
 #include <assert.h>
 #include <string.h>
+#if defined __linux__
+#include <errno.h>
+#include <netinet/udp.h>
+#include <linux/filter.h>
+#include <linux/errqueue.h>
+#endif
 #include "dds/ddsrt/atomics.h"
 #include "dds/ddsrt/heap.h"
 #include "dds/ddsrt/log.h"
@@ -65,6 +71,61 @@ DDSRT_STATIC_ASSERT (DDSI_LOCATOR_UDPv4MCGEN_INDEX_MASK_BITS <= 32 - UDP_MC_ADDR
 #  endif
 #endif
 
+// UDP segmentation offload (UDP_SEGMENT, for sending) and generic receive offload (UDP_GRO)
+// are Linux-specific.  GRO passes the segment size in a control message and so it requires
+// the same support for control messages as the packet destination info.
+#if PACKET_DESTINATION_INFO && defined __linux__ && defined UDP_SEGMENT && defined UDP_GRO
+#  define UDP_SEGMENTATION_OFFLOAD 1
+#else
+#  define UDP_SEGMENTATION_OFFLOAD 0
+#endif
+
+// Spreading the datagrams arriving on a port over multiple sockets bound to it relies on
+// the Linux semantics of SO_REUSEPORT; elsewhere it typically gives the datagrams to one
+// of the sockets only.
+#if defined __linux__ && defined SO_REUSEPORT
+#  define UDP_PORT_SHARING 1
+#else
+#  define UDP_PORT_SHARING 0
+#endif
+
+// The io_uring variant of this transport (ddsi_uringudp.c) includes this file with
+// UDP_URING defined as 1, after including ddsi__uring.h.  It only replaces the data
+// path, and it falls back to the regular path where needed, so it relies on the Linux
+// versions of those.
+#ifndef UDP_URING
+#  define UDP_URING 0
+#endif
+#if UDP_URING && !(DDSRT_HAVE_MMSG && PACKET_DESTINATION_INFO)
+#  error "io_uring support requires recvmmsg and packet destination information"
+#endif
+
+// Zero-copy transmission (MSG_ZEROCOPY) is Linux-specific, the kernel reports completions
+// on the socket's error queue.  Not combined with io_uring, which has its own mechanism.
+#if defined __linux__ && defined SO_ZEROCOPY && defined MSG_ZEROCOPY && defined SO_EE_ORIGIN_ZEROCOPY && !UDP_URING
+#  include <poll.h>
+#  define UDP_ZEROCOPY 1
+#else
+#  define UDP_ZEROCOPY 0
+#endif
+
+// Receive timestamps are passed in control messages as well.  SO_TIMESTAMPING is what
+// provides hardware timestamps, SO_TIMESTAMPNS is the fallback for software ones.
+#if PACKET_DESTINATION_INFO && defined __linux__ && defined SO_TIMESTAMPING && defined SO_TIMESTAMPNS
+#  include <linux/net_tstamp.h>
+#  define UDP_TIMESTAMPS 1
+#else
+#  define UDP_TIMESTAMPS 0
+#endif
+
+// Spinning on a socket is done with non-blocking reads, the io_uring variant does its
+// own waiting and doesn't support it
+#if defined MSG_DONTWAIT && !UDP_URING
+#  define UDP_SPIN 1
+#else
+#  define UDP_SPIN 0
+#endif
+
 union addr {
   struct sockaddr_storage x;
   struct sockaddr a;
@@ -82,6 +143,24 @@ typedef struct ddsi_udp_conn {
 #endif
   int m_diffserv;
   union addr m_addr;
+#if UDP_SEGMENTATION_OFFLOAD
+  ddsrt_atomic_uint32_t m_gso_failed;
+#endif
+#if UDP_URING
+  // The rings are created on first use, the receive side is only ever touched by
+  // the receive thread, the transmit side by anyone holding m_uring_send_lock
+  struct udp_uring_recv *m_uring_recv;
+  bool m_uring_recv_failed;
+  ddsrt_mutex_t m_uring_send_lock;
+  struct udp_uring_send *m_uring_send;
+  bool m_uring_send_failed;
+#endif
+#if UDP_ZEROCOPY
+  struct udp_zerocopy *m_zerocopy; // NULL if not enabled on this socket
+#endif
+#if UDP_SPIN
+  dds_duration_t m_spin; // only set for sockets with a dedicated receive thread
+#endif
 } *ddsi_udp_conn_t;
 
 typedef struct ddsi_udp_tran_factory {
@@ -161,6 +240,293 @@ static void translate_pktinfo (struct ddsi_network_packet_info *pktinfo, ddsrt_m
   pktinfo->if_index = 0;
 }
 
+#if PACKET_DESTINATION_INFO
+union in_pktinfo_4_6 {
+#if defined IP_PKTINFO
+  struct in_pktinfo ip4;
+#endif
+#if DDSRT_HAVE_IPV6 && defined IPV6_PKTINFO
+  struct in6_pktinfo ip6;
+#endif
+};
+#if UDP_SEGMENTATION_OFFLOAD
+#define UDP_INCMSG_GRO_SIZE CMSG_SPACE (sizeof (int))
+#else
+#define UDP_INCMSG_GRO_SIZE 0
+#endif
+#if UDP_TIMESTAMPS
+#define UDP_INCMSG_TIMESTAMP_SIZE CMSG_SPACE (sizeof (struct scm_timestamping))
+#else
+#define UDP_INCMSG_TIMESTAMP_SIZE 0
+#endif
+#define UDP_INCMSG_SIZE (CMSG_SPACE (sizeof (union in_pktinfo_4_6)) + UDP_INCMSG_GRO_SIZE + UDP_INCMSG_TIMESTAMP_SIZE)
+#endif // PACKET_DESTINATION_INFO
+
+// Receiving via io_uring puts the source address and control messages in front of the
+// datagram, in the same buffer
+#if UDP_URING
+#define UDP_RECV_HEADROOM (sizeof (struct io_uring_recvmsg_out) + sizeof (union addr) + UDP_INCMSG_SIZE)
+#else
+#define UDP_RECV_HEADROOM 0
+#endif
+
+static uint32_t get_gro_segsize (ddsrt_msghdr_t *msghdr)
+{
+#if UDP_SEGMENTATION_OFFLOAD
+  // The kernel only adds the UDP_GRO control message if it actually coalesced datagrams
+  for (struct cmsghdr *ctrl = CMSG_FIRSTHDR (msghdr); ctrl; ctrl = CMSG_NXTHDR (msghdr, ctrl))
+  {
+    if (ctrl->cmsg_level == IPPROTO_UDP && ctrl->cmsg_type == UDP_GRO)
+    {
+      int segsize;
+      memcpy (&segsize, CMSG_DATA (ctrl), sizeof (segsize));
+      return (segsize > 0) ? (uint32_t) segsize : 0;
+    }
+  }
+#else
+  (void) msghdr;
+#endif
+  return 0;
+}
+
+#if UDP_TIMESTAMPS
+static ddsrt_wctime_t timespec_to_wctime (const struct timespec *ts)
+{
+  return (ddsrt_wctime_t) { (int64_t) ts->tv_sec * DDS_NSECS_IN_SEC + ts->tv_nsec };
+}
+#endif
+
+static ddsrt_wctime_t get_rx_timestamp (ddsrt_msghdr_t *msghdr)
+{
+#if UDP_TIMESTAMPS
+  for (struct cmsghdr *ctrl = CMSG_FIRSTHDR (msghdr); ctrl; ctrl = CMSG_NXTHDR (msghdr, ctrl))
+  {
+    if (ctrl->cmsg_level != SOL_SOCKET)
+      continue;
+    if (ctrl->cmsg_type == SCM_TIMESTAMPING)
+    {
+      // ts[0] is the software timestamp, ts[2] the raw hardware one, each is zero
+      // if not requested or not provided
+      struct scm_timestamping ts;
+      memcpy (&ts, CMSG_DATA (ctrl), sizeof (ts));
+      if (ts.ts[2].tv_sec != 0 || ts.ts[2].tv_nsec != 0)
+        return timespec_to_wctime (&ts.ts[2]);
+      else if (ts.ts[0].tv_sec != 0 || ts.ts[0].tv_nsec != 0)
+        return timespec_to_wctime (&ts.ts[0]);
+    }
+    else if (ctrl->cmsg_type == SCM_TIMESTAMPNS)
+    {
+      struct timespec ts;
+      memcpy (&ts, CMSG_DATA (ctrl), sizeof (ts));
+      return timespec_to_wctime (&ts);
+    }
+  }
+#else
+  (void) msghdr;
+#endif
+  return DDSRT_WCTIME_INVALID;
+}
+
+static void ddsi_udp_conn_read_postprocess (ddsi_udp_conn_t conn, const union addr *src, ddsrt_msghdr_t *msghdr, unsigned char *buf, size_t len, size_t nrecv, struct ddsi_network_packet_info *pktinfo)
+{
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  if (pktinfo)
+  {
+    addr_to_loc (conn->m_base.m_factory, &pktinfo->src, src);
+    translate_pktinfo (pktinfo, msghdr, conn->m_base.m_base.m_port, src->a.sa_family == AF_INET6);
+    pktinfo->segsize = get_gro_segsize (msghdr);
+    pktinfo->timestamp = (gv->config.socket_timestamps != DDSI_SOCKTS_NONE) ? get_rx_timestamp (msghdr) : DDSRT_WCTIME_INVALID;
+  }
+
+  if (gv->pcap_fp)
+  {
+    struct ddsi_udp_tran_factory * const fact = (struct ddsi_udp_tran_factory *) conn->m_base.m_factory;
+    ddsrt_mutex_lock (&fact->ownaddrs_lock);
+    const bool drop = ddsrt_hh_lookup (fact->ownaddrs, src);
+    ddsrt_mutex_unlock (&fact->ownaddrs_lock);
+    if (!drop)
+    {
+      union addr dest;
+      socklen_t dest_len = sizeof (dest);
+      if (pktinfo && pktinfo->dst.kind != DDSI_LOCATOR_KIND_INVALID)
+        ddsi_ipaddr_from_loc (&dest.x, &pktinfo->dst);
+      else if (ddsrt_getsockname (conn->m_sockext.sock, &dest.a, &dest_len) != DDS_RETCODE_OK)
+        memset (&dest, 0, sizeof (dest));
+      // coalesced datagrams (GRO) are written as the individual datagrams that were received
+      const size_t segsize = (pktinfo && pktinfo->segsize > 0) ? pktinfo->segsize : nrecv;
+      const ddsrt_wctime_t now = ddsrt_time_wallclock ();
+      for (size_t off = 0; off < nrecv; off += segsize)
+        ddsi_write_pcap_received (gv, now, &src->x, &dest.x, buf + off, (nrecv - off < segsize) ? nrecv - off : segsize);
+    }
+  }
+
+  /* Check for udp packet truncation */
+#if ! DDSRT_MSGHDR_FLAGS
+  const bool trunc_flag = false;
+#elif defined MSG_CTRUNC
+  const bool trunc_flag = (msghdr->msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0;
+#else
+  const bool trunc_flag = (msghdr->msg_flags & MSG_TRUNC) != 0;
+#endif
+  if (nrecv > len || trunc_flag)
+  {
+    char addrbuf[DDSI_LOCSTRLEN];
+    ddsi_locator_t tmp;
+    addr_to_loc (conn->m_base.m_factory, &tmp, src);
+    ddsi_locator_to_string (addrbuf, sizeof (addrbuf), &tmp);
+    GVWARNING ("%s => %"PRIuSIZE" truncated to %"PRIuSIZE"\n", addrbuf, nrecv, len);
+  }
+}
+
+#if UDP_ZEROCOPY
+// Zero-copy transmission: the kernel numbers the successful sends with MSG_ZEROCOPY on a
+// socket consecutively, starting at 0, and reports ranges of completed ones on the error
+// queue.  The keepalive objects for outstanding sends are stored in a fixed-size array
+// indexed by that number, a send that would not fit is done by copying.
+#define UDP_ZEROCOPY_MAX_PENDING 256u
+
+// Maximum time to wait for the kernel to report the completion of outstanding sends when
+// closing the socket
+#define UDP_ZEROCOPY_FINI_TIMEOUT DDS_MSECS (100)
+
+struct udp_zerocopy {
+  ddsrt_mutex_t lock;
+  // Writers only process completions if no receive thread waits for the socket to become
+  // readable: completions make it readable, and taking them off the error queue between
+  // the wake-up and the read would make that read block
+  bool writer_reaps;
+  uint32_t first_id; // oldest send not yet released
+  uint32_t next_id; // number of the next send
+  ddsi_tran_write_keepalive_t *pending[UDP_ZEROCOPY_MAX_PENDING];
+};
+
+static void udp_zerocopy_complete (struct udp_zerocopy *zc, uint32_t lo, uint32_t hi)
+{
+  // inclusive range, numbers wrap around
+  for (uint32_t id = lo; id - lo <= hi - lo; id++)
+  {
+    ddsi_tran_write_keepalive_t ** const p = &zc->pending[id % UDP_ZEROCOPY_MAX_PENDING];
+    if (id - zc->first_id < zc->next_id - zc->first_id && *p != NULL)
+    {
+      ddsi_tran_write_keepalive_unref (*p);
+      *p = NULL;
+    }
+    if (id == hi)
+      break;
+  }
+  while (zc->first_id != zc->next_id && zc->pending[zc->first_id % UDP_ZEROCOPY_MAX_PENDING] == NULL)
+    zc->first_id++;
+}
+
+static bool udp_zerocopy_reap (ddsi_udp_conn_t conn, struct udp_zerocopy *zc)
+{
+  bool reaped = false;
+  while (zc->first_id != zc->next_id)
+  {
+    union {
+      char buf[CMSG_SPACE (sizeof (struct sock_extended_err) + sizeof (union addr))];
+      struct cmsghdr align;
+    } ctrl;
+    ddsrt_msghdr_t msghdr;
+    memset (&msghdr, 0, sizeof (msghdr));
+    msghdr.msg_control = ctrl.buf;
+    msghdr.msg_controllen = sizeof (ctrl.buf);
+    size_t nrecv;
+    if (ddsrt_recvmsg (&conn->m_sockext, &msghdr, MSG_ERRQUEUE | MSG_DONTWAIT, &nrecv) != DDS_RETCODE_OK)
+      break;
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR (&msghdr); cm; cm = CMSG_NXTHDR (&msghdr, cm))
+    {
+      if ((cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVERR) || (cm->cmsg_level == IPPROTO_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+      {
+        struct sock_extended_err ee;
+        memcpy (&ee, CMSG_DATA (cm), sizeof (ee));
+        if (ee.ee_errno == 0 && ee.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+        {
+          udp_zerocopy_complete (zc, ee.ee_info, ee.ee_data);
+          reaped = true;
+        }
+      }
+    }
+  }
+  return reaped;
+}
+
+static int udp_zerocopy_recvflags (ddsi_udp_conn_t conn)
+{
+  // If there were completions, they may have been the reason for being called, and then
+  // there need not be any data
+  struct udp_zerocopy * const zc = conn->m_zerocopy;
+  if (zc == NULL)
+    return 0;
+  ddsrt_mutex_lock (&zc->lock);
+  const bool reaped = udp_zerocopy_reap (conn, zc);
+  ddsrt_mutex_unlock (&zc->lock);
+  return reaped ? MSG_DONTWAIT : 0;
+}
+
+static void udp_zerocopy_fini (ddsi_udp_conn_t conn)
+{
+  struct udp_zerocopy * const zc = conn->m_zerocopy;
+  if (zc == NULL)
+    return;
+  // The memory of outstanding sends may only be released once the kernel is done with
+  // it, else a datagram may go out with whatever the memory got reused for.  Completions
+  // make the socket report an error condition, so wait for those for a little while.
+  const ddsrt_mtime_t tend = ddsrt_mtime_add_duration (ddsrt_time_monotonic (), UDP_ZEROCOPY_FINI_TIMEOUT);
+  (void) udp_zerocopy_reap (conn, zc);
+  while (zc->first_id != zc->next_id)
+  {
+    const dds_duration_t left = tend.v - ddsrt_time_monotonic ().v;
+    if (left <= 0)
+      break;
+    struct pollfd pfd = { .fd = conn->m_sockext.sock, .events = 0 };
+    const int n = poll (&pfd, 1, (int) ((left + DDS_NSECS_IN_MSEC - 1) / DDS_NSECS_IN_MSEC));
+    if (n < 0 && errno != EINTR)
+      break;
+    (void) udp_zerocopy_reap (conn, zc);
+  }
+  if (zc->first_id != zc->next_id)
+  {
+    // Leaking the keepalives is not an option either: they may be the only references to
+    // large amounts of memory.  The kernel holds on to the pages it still needs.
+    struct ddsi_domaingv const * const gv = conn->m_base.m_base.gv;
+    GVWARNING ("udp: socket %"PRIdSOCK" closed with %"PRIu32" zero-copy sends not yet completed\n",
+               conn->m_sockext.sock, zc->next_id - zc->first_id);
+    for (; zc->first_id != zc->next_id; zc->first_id++)
+    {
+      ddsi_tran_write_keepalive_t * const p = zc->pending[zc->first_id % UDP_ZEROCOPY_MAX_PENDING];
+      if (p != NULL)
+        ddsi_tran_write_keepalive_unref (p);
+    }
+  }
+  ddsrt_mutex_destroy (&zc->lock);
+  ddsrt_free (zc);
+  conn->m_zerocopy = NULL;
+}
+#endif /* UDP_ZEROCOPY */
+
+#if UDP_SPIN
+static int udp_spin_start (const ddsi_udp_conn_t conn, int recvflags, ddsrt_mtime_t *tspin_end)
+{
+  // Nothing to do if the read is non-blocking anyway (a wakeup because of zero-copy
+  // completions)
+  if (conn->m_spin <= 0 || (recvflags & MSG_DONTWAIT))
+    return 0;
+  *tspin_end = ddsrt_mtime_add_duration (ddsrt_time_monotonic (), conn->m_spin);
+  return MSG_DONTWAIT;
+}
+
+static bool udp_spin_continue (dds_return_t rc, int *spinflags, ddsrt_mtime_t tspin_end)
+{
+  // Retry with non-blocking reads until the spin duration has passed, then block
+  if (rc != DDS_RETCODE_TRY_AGAIN || *spinflags == 0)
+    return false;
+  if (ddsrt_time_monotonic ().v >= tspin_end.v)
+    *spinflags = 0;
+  return true;
+}
+#endif /* UDP_SPIN */
+
 ddsrt_nonnull((1, 2, 6)) ddsrt_attribute_warn_unused_result
 static dds_return_t ddsi_udp_conn_read (struct ddsi_tran_conn * conn_cmn, unsigned char * buf, size_t len, bool allow_spurious, struct ddsi_network_packet_info *pktinfo, size_t *bytes_read)
 {
@@ -168,15 +534,7 @@ static dds_return_t ddsi_udp_conn_read (struct ddsi_tran_conn * conn_cmn, unsign
   struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
   union addr src;
 #if PACKET_DESTINATION_INFO
-  union in_pktinfo_4_6 {
-#if defined IP_PKTINFO
-    struct in_pktinfo ip4;
-#endif
-#if DDSRT_HAVE_IPV6 && defined IPV6_PKTINFO
-    struct in6_pktinfo ip6;
-#endif
-  };
-  char incmsg[CMSG_SPACE (sizeof (union in_pktinfo_4_6))];
+  char incmsg[UDP_INCMSG_SIZE];
 #endif // PACKET_DESTINATION_INFO
   ddsrt_iovec_t msg_iov = {
     .iov_base = (void *) buf,
@@ -196,64 +554,321 @@ static dds_return_t ddsi_udp_conn_read (struct ddsi_tran_conn * conn_cmn, unsign
     // msg_flags is an out parameter anyway
   };
   (void) allow_spurious;
+#if UDP_ZEROCOPY
+  const int recvflags = udp_zerocopy_recvflags (conn);
+#else
+  const int recvflags = 0;
+#endif
 
   dds_return_t rc;
   size_t nrecv;
+#if UDP_SPIN
+  ddsrt_mtime_t tspin_end = { 0 };
+  int spinflags = udp_spin_start (conn, recvflags, &tspin_end);
+  do {
+    rc = ddsrt_recvmsg (&conn->m_sockext, &msghdr, recvflags | spinflags, &nrecv);
+  } while (rc == DDS_RETCODE_INTERRUPTED || udp_spin_continue (rc, &spinflags, tspin_end));
+#else
   do {
-    rc = ddsrt_recvmsg (&conn->m_sockext, &msghdr, 0, &nrecv);
+    rc = ddsrt_recvmsg (&conn->m_sockext, &msghdr, recvflags, &nrecv);
   } while (rc == DDS_RETCODE_INTERRUPTED);
+#endif
 
   if (rc != DDS_RETCODE_OK)
   {
-    if (rc != DDS_RETCODE_BAD_PARAMETER && rc != DDS_RETCODE_NO_CONNECTION)
+    if (rc != DDS_RETCODE_BAD_PARAMETER && rc != DDS_RETCODE_NO_CONNECTION && rc != DDS_RETCODE_TRY_AGAIN)
       GVERROR ("UDP recvmsg sock %d: retcode %"PRId32"\n", (int) conn->m_sockext.sock, rc);
     return rc;
   }
 
-  if (pktinfo)
+  ddsi_udp_conn_read_postprocess (conn, &src, &msghdr, buf, len, nrecv, pktinfo);
+  *bytes_read = (size_t) nrecv;
+  return DDS_RETCODE_OK;
+}
+
+#if DDSRT_HAVE_MMSG
+// Upper bound on the number of datagrams read in one go, it is only there to
+// allow allocating the message headers on the stack
+#define UDP_READ_MULTIPLE_MAX 16
+
+ddsrt_nonnull((1, 2, 5)) ddsrt_attribute_warn_unused_result
+static dds_return_t ddsi_udp_conn_read_multiple (struct ddsi_tran_conn * conn_cmn, ddsi_tran_read_buf_t *bufs, size_t nbufs, bool allow_spurious, size_t *nread)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  union addr src[UDP_READ_MULTIPLE_MAX];
+#if PACKET_DESTINATION_INFO
+  char incmsg[UDP_READ_MULTIPLE_MAX][UDP_INCMSG_SIZE];
+#endif // PACKET_DESTINATION_INFO
+  ddsrt_iovec_t msg_iov[UDP_READ_MULTIPLE_MAX];
+  ddsrt_mmsghdr_t msgs[UDP_READ_MULTIPLE_MAX];
+  (void) allow_spurious;
+#if UDP_ZEROCOPY
+  const int recvflags = udp_zerocopy_recvflags (conn);
+#else
+  const int recvflags = 0;
+#endif
+
+  if (nbufs > UDP_READ_MULTIPLE_MAX)
+    nbufs = UDP_READ_MULTIPLE_MAX;
+  for (size_t i = 0; i < nbufs; i++)
   {
-    addr_to_loc (conn->m_base.m_factory, &pktinfo->src, &src);
-    translate_pktinfo (pktinfo, &msghdr, conn->m_base.m_base.m_port, src.a.sa_family == AF_INET6);
+    msg_iov[i] = (ddsrt_iovec_t) { .iov_base = (void *) bufs[i].buf, .iov_len = (ddsrt_iov_len_t) bufs[i].sz };
+    msgs[i] = (ddsrt_mmsghdr_t) {
+      .msg_hdr = {
+        .msg_name = &src[i].x,
+        .msg_namelen = (socklen_t) sizeof (src[i]),
+        .msg_iov = &msg_iov[i],
+        .msg_iovlen = 1
+#if PACKET_DESTINATION_INFO
+        ,
+        .msg_controllen = sizeof (incmsg[i]),
+        .msg_control = incmsg[i]
+#endif // PACKET_DESTINATION_INFO
+      }
+    };
   }
 
-  if (gv->pcap_fp)
+  // MSG_WAITFORONE: block until the first datagram arrives, then pick up whatever
+  // else is queued already without waiting for the remaining buffers to fill
+  dds_return_t rc;
+  size_t n;
+#if UDP_SPIN
+  ddsrt_mtime_t tspin_end = { 0 };
+  int spinflags = udp_spin_start (conn, recvflags, &tspin_end);
+  do {
+    rc = ddsrt_recvmmsg (&conn->m_sockext, msgs, nbufs, MSG_WAITFORONE | recvflags | spinflags, &n);
+  } while (rc == DDS_RETCODE_INTERRUPTED || udp_spin_continue (rc, &spinflags, tspin_end));
+#else
+  do {
+    rc = ddsrt_recvmmsg (&conn->m_sockext, msgs, nbufs, MSG_WAITFORONE | recvflags, &n);
+  } while (rc == DDS_RETCODE_INTERRUPTED);
+#endif
+
+  if (rc != DDS_RETCODE_OK)
   {
-    struct ddsi_udp_tran_factory * const fact = (struct ddsi_udp_tran_factory *) conn->m_base.m_factory;
-    ddsrt_mutex_lock (&fact->ownaddrs_lock);
-    const bool drop = ddsrt_hh_lookup (fact->ownaddrs, &src);
-    ddsrt_mutex_unlock (&fact->ownaddrs_lock);
-    if (!drop)
+    if (rc != DDS_RETCODE_BAD_PARAMETER && rc != DDS_RETCODE_NO_CONNECTION && rc != DDS_RETCODE_TRY_AGAIN)
+      GVERROR ("UDP recvmmsg sock %d: retcode %"PRId32"\n", (int) conn->m_sockext.sock, rc);
+    *nread = 0;
+    return rc;
+  }
+
+  for (size_t i = 0; i < n; i++)
+  {
+    bufs[i].bytes_read = (size_t) msgs[i].msg_len;
+    ddsi_udp_conn_read_postprocess (conn, &src[i], &msgs[i].msg_hdr, bufs[i].buf, bufs[i].sz, bufs[i].bytes_read, &bufs[i].pktinfo);
+  }
+  *nread = n;
+  return DDS_RETCODE_OK;
+}
+#endif /* DDSRT_HAVE_MMSG */
+
+#if UDP_URING
+// Receiving: the buffers of a batch are handed to the kernel as provided buffers for a
+// multishot recvmsg operation, which then stays armed until it runs out of buffers.
+// The kernel puts the source address and control messages in front of the datagram,
+// at fixed offsets, and consumes the provided buffers in order.
+#define UDP_URING_RECV_ENTRIES 32
+#define UDP_URING_BGID 0
+DDSRT_STATIC_ASSERT (UDP_READ_MULTIPLE_MAX + 2 <= UDP_URING_RECV_ENTRIES);
+
+enum udp_uring_recv_tag {
+  UDP_URING_TAG_RECV = 1,
+  UDP_URING_TAG_PROVIDE,
+  UDP_URING_TAG_REMOVE
+};
+
+struct udp_uring_recv {
+  struct ddsi_uring ring;
+  struct msghdr msghdr; // only the name and control lengths matter
+  bool armed;
+};
+
+static struct udp_uring_recv *udp_uring_recv_get (ddsi_udp_conn_t conn)
+{
+  struct ddsi_domaingv const * const gv = conn->m_base.m_base.gv;
+  if (conn->m_uring_recv == NULL && !conn->m_uring_recv_failed)
+  {
+    struct udp_uring_recv *ur = ddsrt_malloc (sizeof (*ur));
+    dds_return_t rc;
+    if ((rc = ddsi_uring_init (&ur->ring, UDP_URING_RECV_ENTRIES)) != DDS_RETCODE_OK)
     {
-      union addr dest;
-      socklen_t dest_len = sizeof (dest);
-      if (pktinfo && pktinfo->dst.kind != DDSI_LOCATOR_KIND_INVALID)
-        ddsi_ipaddr_from_loc (&dest.x, &pktinfo->dst);
-      else if (ddsrt_getsockname (conn->m_sockext.sock, &dest.a, &dest_len) != DDS_RETCODE_OK)
-        memset (&dest, 0, sizeof (dest));
-      ddsi_write_pcap_received (gv, ddsrt_time_wallclock (), &src.x, &dest.x, buf, nrecv);
+      GVWARNING ("ddsi_udp_conn_read: socket %"PRIdSOCK": failed to create io_uring (%s), using recvmmsg\n", conn->m_sockext.sock, dds_strretcode (rc));
+      ddsrt_free (ur);
+      conn->m_uring_recv_failed = true;
+      return NULL;
     }
+    memset (&ur->msghdr, 0, sizeof (ur->msghdr));
+    ur->msghdr.msg_namelen = (socklen_t) sizeof (union addr);
+    ur->msghdr.msg_controllen = UDP_INCMSG_SIZE;
+    ur->armed = false;
+    conn->m_uring_recv = ur;
   }
+  return conn->m_uring_recv;
+}
 
-  /* Check for udp packet truncation */
-#if ! DDSRT_MSGHDR_FLAGS
-  const bool trunc_flag = false;
-#elif defined MSG_CTRUNC
-  const bool trunc_flag = (msghdr.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0;
-#else
-  const bool trunc_flag = (msghdr.msg_flags & MSG_TRUNC) != 0;
-#endif
-  if (nrecv > len || trunc_flag)
+static void udp_uring_recv_fini (ddsi_udp_conn_t conn)
+{
+  if (conn->m_uring_recv)
   {
-    char addrbuf[DDSI_LOCSTRLEN];
-    ddsi_locator_t tmp;
-    addr_to_loc (conn->m_base.m_factory, &tmp, &src);
-    ddsi_locator_to_string (addrbuf, sizeof (addrbuf), &tmp);
-    GVWARNING ("%s => %"PRIuSIZE" truncated to %"PRIuSIZE"\n", addrbuf, nrecv, len);
+    ddsi_uring_fini (&conn->m_uring_recv->ring);
+    ddsrt_free (conn->m_uring_recv);
+    conn->m_uring_recv = NULL;
   }
+}
 
-  *bytes_read = (size_t) nrecv;
+static void udp_uring_recv_postprocess (ddsi_udp_conn_t conn, const struct udp_uring_recv *ur, ddsi_tran_read_buf_t *buf)
+{
+  struct io_uring_recvmsg_out out;
+  memcpy (&out, buf->buf, sizeof (out));
+  unsigned char * const name = buf->buf + sizeof (out);
+  unsigned char * const control = name + ur->msghdr.msg_namelen;
+  buf->offset = UDP_RECV_HEADROOM;
+  assert (buf->offset == sizeof (out) + ur->msghdr.msg_namelen + ur->msghdr.msg_controllen);
+  assert (buf->offset < buf->sz);
+
+  union addr src;
+  memset (&src, 0, sizeof (src));
+  memcpy (&src, name, (out.namelen < sizeof (src)) ? out.namelen : sizeof (src));
+  ddsrt_msghdr_t msghdr = {
+    .msg_name = &src.x,
+    .msg_namelen = (socklen_t) out.namelen,
+    .msg_control = control,
+    .msg_controllen = out.controllen,
+    .msg_flags = (int) out.flags
+  };
+  const size_t avail = buf->sz - buf->offset;
+  buf->bytes_read = (out.payloadlen < avail) ? out.payloadlen : avail;
+  ddsi_udp_conn_read_postprocess (conn, &src, &msghdr, buf->buf + buf->offset, avail, out.payloadlen, &buf->pktinfo);
+}
+
+ddsrt_nonnull((1, 2, 5)) ddsrt_attribute_warn_unused_result
+static dds_return_t ddsi_udp_conn_read_multiple_uring (struct ddsi_tran_conn * conn_cmn, ddsi_tran_read_buf_t *bufs, size_t nbufs, bool allow_spurious, size_t *nread)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  struct udp_uring_recv * const ur = udp_uring_recv_get (conn);
+  if (ur == NULL)
+    return ddsi_udp_conn_read_multiple (conn_cmn, bufs, nbufs, allow_spurious, nread);
+
+  if (nbufs > UDP_READ_MULTIPLE_MAX)
+    nbufs = UDP_READ_MULTIPLE_MAX;
+  for (size_t i = 0; i < nbufs; i++)
+  {
+    // Separate operations because the rmsgs are not contiguous, with the buffer id
+    // the index; the submission queue is empty at this point so there is room
+    struct io_uring_sqe * const sqe = ddsi_uring_get_sqe (&ur->ring);
+    assert (sqe != NULL && bufs[i].sz <= UINT32_MAX);
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = 1;
+    sqe->addr = (uintptr_t) bufs[i].buf;
+    sqe->len = (uint32_t) bufs[i].sz;
+    sqe->off = (uint64_t) i;
+    sqe->buf_group = UDP_URING_BGID;
+    sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = UDP_URING_TAG_PROVIDE;
+    bufs[i].bytes_read = 0;
+  }
+
+  // Wait for at least one datagram, then take back the buffers that are still unused
+  // before returning: the memory in the rbuf is only reserved for the duration of the
+  // call.  Datagrams received while waiting for that are returned as well.
+  enum { RECEIVING, REMOVING, DONE } state = RECEIVING;
+  size_t nconsumed = 0, nfilled = 0;
+  bool failed = false;
+  while (state != DONE)
+  {
+    if (state == RECEIVING && !ur->armed)
+    {
+      struct io_uring_sqe * const sqe = ddsi_uring_get_sqe (&ur->ring);
+      assert (sqe != NULL);
+      sqe->opcode = IORING_OP_RECVMSG;
+      sqe->fd = conn->m_sockext.sock;
+      sqe->addr = (uintptr_t) &ur->msghdr;
+      sqe->len = 1;
+      sqe->ioprio = IORING_RECV_MULTISHOT;
+      sqe->flags = IOSQE_BUFFER_SELECT;
+      sqe->buf_group = UDP_URING_BGID;
+      sqe->user_data = UDP_URING_TAG_RECV;
+      ur->armed = true;
+    }
+
+    dds_return_t rc;
+    if ((rc = ddsi_uring_submit_and_wait (&ur->ring, 1)) != DDS_RETCODE_OK && rc != DDS_RETCODE_INTERRUPTED)
+    {
+      // Can't take the buffers back without a working ring, but closing it cancels
+      // the receive operation, and we have to fall back to regular reads anyway
+      GVERROR ("ddsi_udp_conn_read: socket %"PRIdSOCK": io_uring_enter failed: %s\n", conn->m_sockext.sock, dds_strretcode (rc));
+      udp_uring_recv_fini (conn);
+      conn->m_uring_recv_failed = true;
+      break;
+    }
+
+    struct io_uring_cqe *cqe;
+    while ((cqe = ddsi_uring_peek_cqe (&ur->ring)) != NULL)
+    {
+      switch ((enum udp_uring_recv_tag) cqe->user_data)
+      {
+        case UDP_URING_TAG_RECV:
+          if (!(cqe->flags & IORING_CQE_F_MORE))
+            ur->armed = false;
+          if (cqe->res >= 0 && (cqe->flags & IORING_CQE_F_BUFFER))
+          {
+            const size_t bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            assert (bid < nbufs);
+            udp_uring_recv_postprocess (conn, ur, &bufs[bid]);
+            if (bid >= nfilled)
+              nfilled = bid + 1;
+            nconsumed++;
+          }
+          else if (cqe->res < 0 && cqe->res != -ENOBUFS)
+          {
+            // ENOBUFS means it ran out of buffers: it needs to be re-armed next time,
+            // other errors mean it doesn't work (e.g., an old kernel)
+            GVWARNING ("ddsi_udp_conn_read: socket %"PRIdSOCK": io_uring recvmsg failed with error %d, using recvmmsg\n", conn->m_sockext.sock, -cqe->res);
+            failed = true;
+          }
+          break;
+        case UDP_URING_TAG_PROVIDE:
+          // only failures result in a completion
+          GVWARNING ("ddsi_udp_conn_read: socket %"PRIdSOCK": io_uring provide buffers failed with error %d, using recvmmsg\n", conn->m_sockext.sock, -cqe->res);
+          failed = true;
+          break;
+        case UDP_URING_TAG_REMOVE:
+          state = DONE;
+          break;
+      }
+      ddsi_uring_cqe_seen (&ur->ring);
+    }
+
+    if (state == RECEIVING && (nconsumed > 0 || failed))
+    {
+      if (nconsumed == nbufs)
+        state = DONE;
+      else
+      {
+        struct io_uring_sqe * const sqe = ddsi_uring_get_sqe (&ur->ring);
+        assert (sqe != NULL);
+        sqe->opcode = IORING_OP_REMOVE_BUFFERS;
+        sqe->fd = (int32_t) nbufs;
+        sqe->buf_group = UDP_URING_BGID;
+        sqe->user_data = UDP_URING_TAG_REMOVE;
+        state = REMOVING;
+      }
+    }
+  }
+
+  if (failed && conn->m_uring_recv)
+  {
+    udp_uring_recv_fini (conn);
+    conn->m_uring_recv_failed = true;
+  }
+  if (nfilled == 0 && conn->m_uring_recv_failed)
+    return ddsi_udp_conn_read_multiple (conn_cmn, bufs, nbufs, allow_spurious, nread);
+  *nread = nfilled;
   return DDS_RETCODE_OK;
 }
+#endif /* UDP_URING */
 
 ddsrt_nonnull((1, 2))
 static dds_return_t ddsi_udp_conn_write (struct ddsi_tran_conn * conn_cmn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t flags, size_t *bytes_written)
@@ -338,19 +953,422 @@ static dds_return_t ddsi_udp_conn_write (struct ddsi_tran_conn * conn_cmn, const
   return rc;
 }
 
+#if UDP_ZEROCOPY
+ddsrt_nonnull((1, 2, 3, 4))
+static dds_return_t ddsi_udp_conn_write_zerocopy (struct ddsi_tran_conn * conn_cmn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, ddsi_tran_write_keepalive_t *keepalive, uint32_t flags, size_t *bytes_written)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  struct udp_zerocopy * const zc = conn->m_zerocopy;
+  // Writing the pcap file is left to the regular path
+  if (gv->pcap_fp)
+    return ddsi_udp_conn_write (conn_cmn, dst, msgfrags, flags, bytes_written);
+
+  union addr dstaddr;
+  assert (msgfrags->niov <= INT_MAX);
+  ddsi_ipaddr_from_loc (&dstaddr.x, dst);
+  ddsrt_msghdr_t msg = {
+    .msg_name = &dstaddr.x,
+    .msg_namelen = (socklen_t) ddsrt_sockaddr_get_size (&dstaddr.a),
+    .msg_iov = (ddsrt_iovec_t *) msgfrags->iov,
+    .msg_iovlen = (ddsrt_msg_iovlen_t) msgfrags->niov
+  };
+  dds_return_t rc = DDS_RETCODE_OUT_OF_RESOURCES;
+  size_t nsent;
+  // The kernel numbers the sends in the order in which they occur, so the lock must be
+  // held while sending to know which number belongs to this one
+  ddsrt_mutex_lock (&zc->lock);
+  if (zc->writer_reaps)
+    (void) udp_zerocopy_reap (conn, zc);
+  if (zc->next_id - zc->first_id < UDP_ZEROCOPY_MAX_PENDING)
+  {
+    do {
+      rc = ddsrt_sendmsg (conn->m_sockext.sock, &msg, MSG_ZEROCOPY | MSG_NOSIGNAL, &nsent);
+    } while (rc == DDS_RETCODE_INTERRUPTED);
+    if (rc == DDS_RETCODE_OK)
+    {
+      ddsi_tran_write_keepalive_ref (keepalive);
+      zc->pending[zc->next_id++ % UDP_ZEROCOPY_MAX_PENDING] = keepalive;
+    }
+  }
+  ddsrt_mutex_unlock (&zc->lock);
+  if (rc != DDS_RETCODE_OK)
+  {
+    // Too many outstanding sends or a failure (e.g., ENOBUFS because of the limit on pinned
+    // memory): nothing was sent and the regular path takes care of retrying and reporting
+    return ddsi_udp_conn_write (conn_cmn, dst, msgfrags, flags, bytes_written);
+  }
+  if (bytes_written)
+    *bytes_written = nsent;
+  return rc;
+}
+#endif /* UDP_ZEROCOPY */
+
+#if DDSRT_HAVE_MMSG
+#define UDP_WRITE_MULTIPLE_MAX 16
+
+ddsrt_nonnull((1, 2))
+static void ddsi_udp_conn_write_multiple (struct ddsi_tran_conn * conn_cmn, ddsi_tran_write_buf_t *bufs, size_t nbufs, uint32_t flags)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  union addr dstaddr[UDP_WRITE_MULTIPLE_MAX];
+  ddsrt_mmsghdr_t msgs[UDP_WRITE_MULTIPLE_MAX];
+  int sendflags = 0;
+  union addr sa;
+  bool have_sa = false;
+  (void) flags; // in case ! DDSRT_MSGHDR_FLAGS
+
+#if MSG_NOSIGNAL && !LWIP_SOCKET
+  sendflags |= MSG_NOSIGNAL;
+#endif
+  size_t i = 0;
+  while (i < nbufs)
+  {
+    const size_t m = (nbufs - i < UDP_WRITE_MULTIPLE_MAX) ? nbufs - i : UDP_WRITE_MULTIPLE_MAX;
+    for (size_t j = 0; j < m; j++)
+    {
+      const ddsi_tran_write_buf_t *b = &bufs[i + j];
+      assert (b->msgfrags->niov <= INT_MAX);
+      ddsi_ipaddr_from_loc (&dstaddr[j].x, b->dst);
+      msgs[j] = (ddsrt_mmsghdr_t) {
+        .msg_hdr = {
+          .msg_name = &dstaddr[j].x,
+          .msg_namelen = (socklen_t) ddsrt_sockaddr_get_size (&dstaddr[j].a),
+          .msg_iov = (ddsrt_iovec_t *) b->msgfrags->iov,
+          .msg_iovlen = (ddsrt_msg_iovlen_t) b->msgfrags->niov
+#if DDSRT_MSGHDR_FLAGS
+          , .msg_flags = (int) flags
+#endif
+        }
+      };
+    }
+
+    size_t nsent;
+    if (ddsrt_sendmmsg (conn->m_sockext.sock, msgs, m, sendflags, &nsent) != DDS_RETCODE_OK)
+    {
+      // Failure to send the first message: the single-message path takes care of retrying
+      // and reporting the error, then continue with the remainder
+      bufs[i].rc = ddsi_udp_conn_write (conn_cmn, bufs[i].dst, bufs[i].msgfrags, flags, &bufs[i].bytes_written);
+      i++;
+      continue;
+    }
+
+    for (size_t j = 0; j < nsent; j++)
+    {
+      bufs[i + j].rc = DDS_RETCODE_OK;
+      bufs[i + j].bytes_written = (size_t) msgs[j].msg_len;
+      if (msgs[j].msg_len > 0 && gv->pcap_fp)
+      {
+        if (!have_sa)
+        {
+          socklen_t alen = sizeof (sa);
+          if (ddsrt_getsockname (conn->m_sockext.sock, &sa.a, &alen) != DDS_RETCODE_OK)
+            memset (&sa, 0, sizeof (sa));
+          have_sa = true;
+        }
+        ddsi_write_pcap_sent (gv, ddsrt_time_wallclock (), &sa.x, &msgs[j].msg_hdr, (size_t) msgs[j].msg_len);
+      }
+    }
+    i += nsent;
+  }
+}
+#endif /* DDSRT_HAVE_MMSG */
+
+#if UDP_URING
+// Transmitting: the datagram is copied so that the writer can continue as soon as the
+// send operation has been queued.  Completions are processed on subsequent writes, and
+// the number of outstanding sends is limited to what the completion queue can hold.
+#define UDP_URING_SEND_ENTRIES 256
+
+struct udp_uring_send {
+  struct ddsi_uring ring;
+  uint32_t inflight;
+};
+
+struct udp_uring_sendbuf {
+  struct msghdr msghdr;
+  struct iovec iov;
+  union addr dst;
+  unsigned char data[];
+};
+
+static struct udp_uring_send *udp_uring_send_get (ddsi_udp_conn_t conn)
+{
+  struct ddsi_domaingv const * const gv = conn->m_base.m_base.gv;
+  if (conn->m_uring_send == NULL && !conn->m_uring_send_failed)
+  {
+    struct udp_uring_send *us = ddsrt_malloc (sizeof (*us));
+    dds_return_t rc;
+    if ((rc = ddsi_uring_init (&us->ring, UDP_URING_SEND_ENTRIES)) != DDS_RETCODE_OK)
+    {
+      GVWARNING ("ddsi_udp_conn_write: socket %"PRIdSOCK": failed to create io_uring (%s), using sendmsg\n", conn->m_sockext.sock, dds_strretcode (rc));
+      ddsrt_free (us);
+      conn->m_uring_send_failed = true;
+      return NULL;
+    }
+    us->inflight = 0;
+    conn->m_uring_send = us;
+  }
+  return conn->m_uring_send;
+}
+
+static void udp_uring_send_reap (ddsi_udp_conn_t conn, struct udp_uring_send *us)
+{
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  struct io_uring_cqe *cqe;
+  while ((cqe = ddsi_uring_peek_cqe (&us->ring)) != NULL)
+  {
+    struct udp_uring_sendbuf * const sb = (struct udp_uring_sendbuf *) (uintptr_t) cqe->user_data;
+    // same errors are ignored as in ddsi_udp_conn_write, but no retrying
+    if (cqe->res < 0 && cqe->res != -EPERM && cqe->res != -EACCES && cqe->res != -ENETUNREACH && cqe->res != -EHOSTUNREACH)
+    {
+      char locbuf[DDSI_LOCSTRLEN];
+      ddsi_locator_t dst;
+      addr_to_loc (conn->m_base.m_factory, &dst, &sb->dst);
+      GVERROR ("ddsi_udp_conn_write to %s failed with error %d\n", ddsi_locator_to_string (locbuf, sizeof (locbuf), &dst), -cqe->res);
+    }
+    ddsrt_free (sb);
+    us->inflight--;
+    ddsi_uring_cqe_seen (&us->ring);
+  }
+}
+
+static dds_return_t udp_uring_send_wait (ddsi_udp_conn_t conn, struct udp_uring_send *us, uint32_t wait_nr)
+{
+  dds_return_t rc;
+  do {
+    rc = ddsi_uring_submit_and_wait (&us->ring, wait_nr);
+  } while (rc == DDS_RETCODE_INTERRUPTED);
+  udp_uring_send_reap (conn, us);
+  return rc;
+}
+
+static void udp_uring_send_fini (ddsi_udp_conn_t conn)
+{
+  struct udp_uring_send * const us = conn->m_uring_send;
+  if (us == NULL)
+    return;
+  // the data of the outstanding sends can only be freed once they have completed
+  while (us->inflight > 0 && udp_uring_send_wait (conn, us, us->inflight) == DDS_RETCODE_OK)
+    ;
+  ddsi_uring_fini (&us->ring);
+  ddsrt_free (us);
+  conn->m_uring_send = NULL;
+}
+
+static dds_return_t udp_uring_queue_send (ddsi_udp_conn_t conn, struct udp_uring_send *us, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, size_t *bytes_written)
+{
+  size_t len = 0;
+  for (size_t i = 0; i < msgfrags->niov; i++)
+    len += msgfrags->iov[i].iov_len;
+  struct udp_uring_sendbuf * const sb = ddsrt_malloc (sizeof (*sb) + len);
+  size_t off = 0;
+  for (size_t i = 0; i < msgfrags->niov; i++)
+  {
+    memcpy (sb->data + off, msgfrags->iov[i].iov_base, msgfrags->iov[i].iov_len);
+    off += msgfrags->iov[i].iov_len;
+  }
+  ddsi_ipaddr_from_loc (&sb->dst.x, dst);
+  sb->iov = (struct iovec) { .iov_base = sb->data, .iov_len = len };
+  sb->msghdr = (struct msghdr) {
+    .msg_name = &sb->dst.x,
+    .msg_namelen = (socklen_t) ddsrt_sockaddr_get_size (&sb->dst.a),
+    .msg_iov = &sb->iov,
+    .msg_iovlen = 1
+  };
+
+  struct io_uring_sqe *sqe;
+  while (us->inflight >= us->ring.sq_entries || (sqe = ddsi_uring_get_sqe (&us->ring)) == NULL)
+  {
+    dds_return_t rc;
+    if ((rc = udp_uring_send_wait (conn, us, 1)) != DDS_RETCODE_OK && rc != DDS_RETCODE_TRY_AGAIN)
+    {
+      ddsrt_free (sb);
+      return rc;
+    }
+  }
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = conn->m_sockext.sock;
+  sqe->addr = (uintptr_t) &sb->msghdr;
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = (uintptr_t) sb;
+  us->inflight++;
+  *bytes_written = len;
+  return DDS_RETCODE_OK;
+}
+
+static void udp_uring_send_submit (ddsi_udp_conn_t conn, struct udp_uring_send *us)
+{
+  // Anything not accepted now stays in the submission queue and gets picked up by
+  // the next submit, waiting for a completion makes sure there is one
+  dds_return_t rc;
+  udp_uring_send_reap (conn, us);
+  if ((rc = udp_uring_send_wait (conn, us, 0)) == DDS_RETCODE_TRY_AGAIN && us->inflight > 0)
+    rc = udp_uring_send_wait (conn, us, 1);
+  if (rc != DDS_RETCODE_OK)
+  {
+    struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+    GVERROR ("ddsi_udp_conn_write: socket %"PRIdSOCK": io_uring_enter failed: %s\n", conn->m_sockext.sock, dds_strretcode (rc));
+  }
+}
+
+ddsrt_nonnull((1, 2, 3))
+static dds_return_t ddsi_udp_conn_write_uring (struct ddsi_tran_conn * conn_cmn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t flags, size_t *bytes_written)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  // packet capturing is done by the synchronous path
+  if (conn->m_base.m_base.gv->pcap_fp == NULL)
+  {
+    ddsrt_mutex_lock (&conn->m_uring_send_lock);
+    struct udp_uring_send * const us = udp_uring_send_get (conn);
+    if (us != NULL)
+    {
+      size_t nbytes;
+      const dds_return_t rc = udp_uring_queue_send (conn, us, dst, msgfrags, &nbytes);
+      if (rc == DDS_RETCODE_OK)
+        udp_uring_send_submit (conn, us);
+      ddsrt_mutex_unlock (&conn->m_uring_send_lock);
+      if (bytes_written)
+        *bytes_written = nbytes;
+      return rc;
+    }
+    ddsrt_mutex_unlock (&conn->m_uring_send_lock);
+  }
+  return ddsi_udp_conn_write (conn_cmn, dst, msgfrags, flags, bytes_written);
+}
+
+ddsrt_nonnull((1, 2))
+static void ddsi_udp_conn_write_multiple_uring (struct ddsi_tran_conn * conn_cmn, ddsi_tran_write_buf_t *bufs, size_t nbufs, uint32_t flags)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  if (conn->m_base.m_base.gv->pcap_fp == NULL)
+  {
+    ddsrt_mutex_lock (&conn->m_uring_send_lock);
+    struct udp_uring_send * const us = udp_uring_send_get (conn);
+    if (us != NULL)
+    {
+      // all of them in a single system call
+      for (size_t i = 0; i < nbufs; i++)
+        bufs[i].rc = udp_uring_queue_send (conn, us, bufs[i].dst, bufs[i].msgfrags, &bufs[i].bytes_written);
+      udp_uring_send_submit (conn, us);
+      ddsrt_mutex_unlock (&conn->m_uring_send_lock);
+      return;
+    }
+    ddsrt_mutex_unlock (&conn->m_uring_send_lock);
+  }
+  ddsi_udp_conn_write_multiple (conn_cmn, bufs, nbufs, flags);
+}
+#endif /* UDP_URING */
+
+#if UDP_SEGMENTATION_OFFLOAD
+ddsrt_nonnull((1, 2, 3))
+static dds_return_t ddsi_udp_conn_write_segmented (struct ddsi_tran_conn * conn_cmn, const ddsi_locator_t *dst, const ddsi_tran_write_msgfrags_t *msgfrags, uint32_t segsize, uint32_t flags, size_t *bytes_written)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  struct ddsi_domaingv * const gv = conn->m_base.m_base.gv;
+  // The pcap file should contain the datagrams as they are on the wire, and once the
+  // kernel has refused segmentation offload for this socket, there's no point in trying
+  // again for every message
+  if (gv->pcap_fp || ddsrt_atomic_ld32 (&conn->m_gso_failed) || segsize > UINT16_MAX)
+    return ddsi_conn_write_segments (conn_cmn, dst, msgfrags, segsize, flags, bytes_written);
+
+  union {
+    char buf[CMSG_SPACE (sizeof (uint16_t))];
+    struct cmsghdr align;
+  } ctrl;
+  union addr dstaddr;
+  assert (msgfrags->niov <= INT_MAX);
+  ddsi_ipaddr_from_loc (&dstaddr.x, dst);
+  memset (&ctrl, 0, sizeof (ctrl));
+  ddsrt_msghdr_t msg = {
+    .msg_name = &dstaddr.x,
+    .msg_namelen = (socklen_t) ddsrt_sockaddr_get_size (&dstaddr.a),
+    .msg_iov = (ddsrt_iovec_t *) msgfrags->iov,
+    .msg_iovlen = (ddsrt_msg_iovlen_t) msgfrags->niov,
+    .msg_control = ctrl.buf,
+    .msg_controllen = sizeof (ctrl.buf)
+  };
+  struct cmsghdr *cm = CMSG_FIRSTHDR (&msg);
+  cm->cmsg_level = IPPROTO_UDP;
+  cm->cmsg_type = UDP_SEGMENT;
+  cm->cmsg_len = CMSG_LEN (sizeof (uint16_t));
+  const uint16_t gso_size = (uint16_t) segsize;
+  memcpy (CMSG_DATA (cm), &gso_size, sizeof (gso_size));
+
+  int sendflags = 0;
+#if MSG_NOSIGNAL && !LWIP_SOCKET
+  sendflags |= MSG_NOSIGNAL;
+#endif
+  dds_return_t rc;
+  size_t nsent;
+  do {
+    rc = ddsrt_sendmsg (conn->m_sockext.sock, &msg, sendflags, &nsent);
+  } while (rc == DDS_RETCODE_INTERRUPTED);
+  if (rc == DDS_RETCODE_OK)
+  {
+    if (bytes_written)
+      *bytes_written = nsent;
+    return rc;
+  }
+
+  // Segmentation offload can fail for reasons that can't be known in advance (e.g., EIO
+  // if the network interface can't do the checksum offload), sending the datagrams one
+  // by one takes care of that as well as of any retrying and reporting of other errors
+  if (ddsrt_atomic_cas32 (&conn->m_gso_failed, 0, 1))
+    GVLOG (DDS_LC_CONFIG, "ddsi_udp_conn_write_segmented: UDP segmentation offload failed with retcode %"PRId32", disabling it on this socket\n", rc);
+  return ddsi_conn_write_segments (conn_cmn, dst, msgfrags, segsize, flags, bytes_written);
+}
+#endif /* UDP_SEGMENTATION_OFFLOAD */
+
 static void ddsi_udp_disable_multiplexing (struct ddsi_tran_conn * conn_cmn)
 {
-#if defined _WIN32 && !defined WINCE
   ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+#if UDP_ZEROCOPY
+  // A dedicated receive thread blocks in the read rather than in a select
+  if (conn->m_zerocopy)
+  {
+    ddsrt_mutex_lock (&conn->m_zerocopy->lock);
+    conn->m_zerocopy->writer_reaps = true;
+    ddsrt_mutex_unlock (&conn->m_zerocopy->lock);
+  }
+#endif
+#if defined _WIN32 && !defined WINCE
   uint32_t zero = 0;
   DWORD dummy;
   WSAEventSelect (conn->m_sockext.sock, 0, 0);
   WSAIoctl (conn->m_sockext.sock, FIONBIO, &zero,sizeof(zero), NULL,0, &dummy, NULL,NULL);
 #else
-  (void) conn_cmn;
+  (void) conn;
 #endif
 }
 
+static dds_return_t ddsi_udp_set_busy_poll (struct ddsi_tran_conn * conn_cmn, dds_duration_t spin, dds_duration_t sock_busy_poll)
+{
+  ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
+  dds_return_t rc = DDS_RETCODE_OK;
+  if (spin > 0)
+  {
+#if UDP_SPIN
+    conn->m_spin = spin;
+#else
+    rc = DDS_RETCODE_UNSUPPORTED;
+#endif
+  }
+  if (sock_busy_poll > 0 && rc == DDS_RETCODE_OK)
+  {
+#if defined __linux__ && defined SO_BUSY_POLL
+    // the kernel wants microseconds, the configuration limits it to 1s
+    const int usecs = (int) ((sock_busy_poll + DDS_NSECS_IN_USEC - 1) / DDS_NSECS_IN_USEC);
+    rc = ddsrt_setsockopt (conn->m_sockext.sock, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof (usecs));
+#else
+    rc = DDS_RETCODE_UNSUPPORTED;
+#endif
+  }
+  return rc;
+}
+
 static ddsrt_socket_t ddsi_udp_conn_handle (struct ddsi_tran_base * conn_cmn)
 {
   ddsi_udp_conn_t conn = (ddsi_udp_conn_t) conn_cmn;
@@ -463,6 +1481,152 @@ static dds_return_t setsockopt_pktinfo (struct ddsi_domaingv const * const gv, d
 }
 #endif // PACKET_DESTINATION_INFO
 
+#if UDP_ZEROCOPY
+static void set_zerocopy (struct ddsi_domaingv const * const gv, ddsi_udp_conn_t conn, enum ddsi_tran_qos_purpose purpose)
+{
+  // Probing SO_ZEROCOPY first tells us whether the kernel supports it for UDP (Linux 5.0)
+  int val;
+  socklen_t optlen = (socklen_t) sizeof (val);
+  dds_return_t rc;
+  if (purpose == DDSI_TRAN_QOS_RECV_MC)
+    return;
+  if ((rc = ddsrt_getsockopt (conn->m_sockext.sock, SOL_SOCKET, SO_ZEROCOPY, &val, &optlen)) != DDS_RETCODE_OK ||
+      (val = 1, rc = ddsrt_setsockopt (conn->m_sockext.sock, SOL_SOCKET, SO_ZEROCOPY, &val, sizeof (val))) != DDS_RETCODE_OK)
+  {
+    GVLOG (DDS_LC_CONFIG, "ddsi_udp_create_conn: zero-copy transmission not supported by network stack: %s\n", dds_strretcode (rc));
+    return;
+  }
+  struct udp_zerocopy * const zc = ddsrt_malloc (sizeof (*zc));
+  ddsrt_mutex_init (&zc->lock);
+  // Sockets only used for transmitting are never read, receive sockets that get a thread
+  // of their own have that thread block in the read (see ddsi_udp_disable_multiplexing)
+  zc->writer_reaps = (purpose != DDSI_TRAN_QOS_RECVXMIT_UC);
+  zc->first_id = zc->next_id = 0;
+  memset (zc->pending, 0, sizeof (zc->pending));
+  conn->m_zerocopy = zc;
+  conn->m_base.m_write_zerocopy_fn = ddsi_udp_conn_write_zerocopy;
+}
+#endif
+
+#if UDP_SEGMENTATION_OFFLOAD
+static void set_segmentation_offload (struct ddsi_domaingv const * const gv, ddsi_udp_conn_t conn, enum ddsi_tran_qos_purpose purpose)
+{
+  // Probing UDP_SEGMENT tells us whether the kernel supports it (Linux 4.18 and later)
+  int val;
+  socklen_t optlen = (socklen_t) sizeof (val);
+  if (ddsrt_getsockopt (conn->m_sockext.sock, IPPROTO_UDP, UDP_SEGMENT, &val, &optlen) == DDS_RETCODE_OK)
+    conn->m_base.m_write_segmented_fn = ddsi_udp_conn_write_segmented;
+  else
+    GVLOG (DDS_LC_CONFIG, "ddsi_udp_create_conn: UDP segmentation offload not supported by network stack\n");
+
+  // Coalescing on receive only works if the receive buffers can hold the result (up to
+  // 64kB), and the security plugin decodes messages in place assuming a message fills
+  // the datagram
+  bool gro = (purpose == DDSI_TRAN_QOS_RECVXMIT_UC || purpose == DDSI_TRAN_QOS_RECV_MC) && gv->config.rmsg_chunk_size >= 65536 + UDP_RECV_HEADROOM;
+#ifdef DDS_HAS_SECURITY
+  if (gv->config.omg_security_configuration != NULL)
+    gro = false;
+#endif
+  val = 1;
+  if (gro && ddsrt_setsockopt (conn->m_sockext.sock, IPPROTO_UDP, UDP_GRO, &val, (socklen_t) sizeof (val)) != DDS_RETCODE_OK)
+    GVLOG (DDS_LC_CONFIG, "ddsi_udp_create_conn: UDP generic receive offload not supported by network stack\n");
+}
+#endif
+
+#if UDP_TIMESTAMPS
+static void set_socket_timestamps (struct ddsi_domaingv const * const gv, ddsi_udp_conn_t conn, enum ddsi_tran_qos_purpose purpose)
+{
+  if (purpose != DDSI_TRAN_QOS_RECVXMIT_UC && purpose != DDSI_TRAN_QOS_RECV_MC)
+    return;
+  // Without the hardware flags the kernel provides software timestamps only; with them it
+  // provides both, where the hardware one is zero if the interface doesn't timestamp
+  unsigned flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+  if (gv->config.socket_timestamps == DDSI_SOCKTS_HARDWARE)
+    flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+  int val = (int) flags;
+  if (ddsrt_setsockopt (conn->m_sockext.sock, SOL_SOCKET, SO_TIMESTAMPING, &val, (socklen_t) sizeof (val)) == DDS_RETCODE_OK)
+    return;
+  val = 1;
+  if (ddsrt_setsockopt (conn->m_sockext.sock, SOL_SOCKET, SO_TIMESTAMPNS, &val, (socklen_t) sizeof (val)) != DDS_RETCODE_OK)
+    GVLOG (DDS_LC_CONFIG, "ddsi_udp_create_conn: socket timestamps not supported by network stack\n");
+  else if (gv->config.socket_timestamps == DDSI_SOCKTS_HARDWARE)
+    GVLOG (DDS_LC_CONFIG, "ddsi_udp_create_conn: hardware socket timestamps not supported by network stack, using software timestamps\n");
+}
+#endif
+
+#if UDP_PORT_SHARING
+static dds_return_t reserve_shared_port (struct ddsi_domaingv const * const gv, union addr *socketname)
+{
+  // Binding with SO_REUSEPORT succeeds if another process (of the same user) did the same,
+  // and so a port already in use would go undetected.  First binding a socket without it
+  // does detect that, and also selects the port if a random one is requested.  There is a
+  // small window in which another process can do the same.
+  ddsrt_socket_t sock;
+  union addr tmp;
+  dds_return_t rc;
+  if ((rc = ddsrt_socket (&sock, socketname->a.sa_family, SOCK_DGRAM, 0)) != DDS_RETCODE_OK)
+  {
+    GVERROR ("ddsi_udp_create_conn: failed to create socket: %s\n", dds_strretcode (rc));
+    return DDS_RETCODE_ERROR;
+  }
+  if ((rc = ddsrt_bind (sock, &socketname->a, ddsrt_sockaddr_get_size (&socketname->a))) == DDS_RETCODE_OK)
+  {
+    const uint16_t port = get_socket_addr_port (gv, sock, &tmp);
+    if (socketname->a.sa_family == AF_INET)
+      socketname->a4.sin_port = htons (port);
+#if DDSRT_HAVE_IPV6
+    else
+      socketname->a6.sin6_port = htons (port);
+#endif
+  }
+  ddsrt_close (sock);
+  return rc;
+}
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+static void set_steer_by_source (struct ddsi_domaingv const * const gv, ddsrt_socket_t sock, bool ipv6, uint32_t nsockets)
+{
+  // The kernel runs the program with the UDP payload as packet data, so the source address
+  // is loaded relative to the network header.  The result is the index of the socket in the
+  // group, the kernel falls back to its default hash if it is out of range and so it is fine
+  // to attach it before the other sockets have been created.
+  struct sock_filter code4[] = {
+    BPF_STMT(BPF_LD+BPF_W+BPF_ABS, (uint32_t) SKF_NET_OFF + 12), // ld [net+12] - IPv4 source address
+    BPF_STMT(BPF_ALU+BPF_MOD+BPF_K, nsockets),                   // mod #nsockets
+    BPF_STMT(BPF_RET+BPF_A, 0)                                   // ret a
+  };
+  struct sock_filter code6[] = {
+    BPF_STMT(BPF_LD+BPF_W+BPF_ABS, (uint32_t) SKF_NET_OFF + 8),  // ld [net+8] - IPv6 source address, word 0
+    BPF_STMT(BPF_MISC+BPF_TAX, 0),                               // tax
+    BPF_STMT(BPF_LD+BPF_W+BPF_ABS, (uint32_t) SKF_NET_OFF + 12), // ld [net+12] - word 1
+    BPF_STMT(BPF_ALU+BPF_XOR+BPF_X, 0),                          // xor x
+    BPF_STMT(BPF_MISC+BPF_TAX, 0),                               // tax
+    BPF_STMT(BPF_LD+BPF_W+BPF_ABS, (uint32_t) SKF_NET_OFF + 16), // ld [net+16] - word 2
+    BPF_STMT(BPF_ALU+BPF_XOR+BPF_X, 0),                          // xor x
+    BPF_STMT(BPF_MISC+BPF_TAX, 0),                               // tax
+    BPF_STMT(BPF_LD+BPF_W+BPF_ABS, (uint32_t) SKF_NET_OFF + 20), // ld [net+20] - word 3
+    BPF_STMT(BPF_ALU+BPF_XOR+BPF_X, 0),                          // xor x
+    BPF_STMT(BPF_ALU+BPF_MOD+BPF_K, nsockets),                   // mod #nsockets
+    BPF_STMT(BPF_RET+BPF_A, 0)                                   // ret a
+  };
+  struct sock_fprog prg;
+  if (ipv6)
+    prg = (struct sock_fprog) { .len = sizeof (code6) / sizeof (code6[0]), .filter = code6 };
+  else
+    prg = (struct sock_fprog) { .len = sizeof (code4) / sizeof (code4[0]), .filter = code4 };
+  dds_return_t rc = ddsrt_setsockopt (sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prg, sizeof (prg));
+  if (rc != DDS_RETCODE_OK)
+    GVWARNING ("ddsi_udp_create_conn: failed to attach socket selection program: %s\n", dds_strretcode (rc));
+}
+#else
+static void set_steer_by_source (struct ddsi_domaingv const * const gv, ddsrt_socket_t sock, bool ipv6, uint32_t nsockets)
+{
+  (void) sock; (void) ipv6; (void) nsockets;
+  GVWARNING ("ddsi_udp_create_conn: selecting socket by source address not supported by network stack\n");
+}
+#endif
+#endif
+
 static dds_return_t set_socket_buffer (struct ddsi_domaingv const * const gv, ddsrt_socket_t sock, int32_t socket_option, const char *socket_option_name, const char *name, const struct ddsi_config_socket_buf_size *config, uint32_t default_min_size)
 {
   // if (min, max)=   and   initbuf=   then  request=  and  result=
@@ -651,6 +1815,25 @@ static dds_return_t ddsi_udp_create_conn (struct ddsi_tran_conn **conn_out, stru
   }
   assert (purpose_str != NULL);
 
+  switch (qos->m_port_sharing)
+  {
+    case DDSI_TRAN_PORT_EXCLUSIVE:
+      break;
+#if UDP_PORT_SHARING
+    case DDSI_TRAN_PORT_SHARE_FIRST:
+    case DDSI_TRAN_PORT_SHARE_JOIN:
+      reuse_addr = true;
+      break;
+#else
+    case DDSI_TRAN_PORT_SHARE_FIRST:
+      // no one will be able to join, so it might as well be exclusive
+      break;
+    case DDSI_TRAN_PORT_SHARE_JOIN:
+      GVERROR ("ddsi_udp_create_conn: sharing a port between sockets is not supported on this platform\n");
+      goto fail;
+#endif
+  }
+
   union addr socketname;
   ddsi_locator_t ownloc_w_port = intf->loc;
   assert (ownloc_w_port.port == DDSI_LOCATOR_PORT_INVALID);
@@ -677,6 +1860,15 @@ static dds_return_t ddsi_udp_create_conn (struct ddsi_tran_conn **conn_out, stru
     default:
       DDS_FATAL ("ddsi_udp_create_conn: unsupported kind %"PRId32"\n", fact->m_kind);
   }
+#if UDP_PORT_SHARING
+  if (qos->m_port_sharing == DDSI_TRAN_PORT_SHARE_FIRST && (rc = reserve_shared_port (gv, &socketname)) != DDS_RETCODE_OK)
+  {
+    if (rc == DDS_RETCODE_PRECONDITION_NOT_MET)
+      return DDS_RETCODE_PRECONDITION_NOT_MET;
+    goto fail;
+  }
+#endif
+
   if ((rc = ddsrt_socket (&sock, socketname.a.sa_family, SOCK_DGRAM, 0)) != DDS_RETCODE_OK)
   {
     GVERROR ("ddsi_udp_create_conn: failed to create socket: %s\n", dds_strretcode (rc));
@@ -731,7 +1923,7 @@ static dds_return_t ddsi_udp_create_conn (struct ddsi_tran_conn **conn_out, stru
   {
     /* PRECONDITION_NOT_MET (= EADDRINUSE) is expected if reuse_addr isn't set, should be handled at
        a higher level and therefore needs to return a specific error message */
-    if (!reuse_addr && rc == DDS_RETCODE_PRECONDITION_NOT_MET)
+    if ((!reuse_addr || qos->m_port_sharing != DDSI_TRAN_PORT_EXCLUSIVE) && rc == DDS_RETCODE_PRECONDITION_NOT_MET)
       goto fail_addrinuse;
 
     char buf[DDSI_LOCSTRLEN];
@@ -741,6 +1933,11 @@ static dds_return_t ddsi_udp_create_conn (struct ddsi_tran_conn **conn_out, stru
     goto fail_w_socket;
   }
 
+#if UDP_PORT_SHARING
+  if (qos->m_port_sharing == DDSI_TRAN_PORT_SHARE_FIRST && gv->config.recv_uc_steer_by_source && gv->config.recv_uc_sockets > 1)
+    set_steer_by_source (gv, sock, ipv6, (uint32_t) gv->config.recv_uc_sockets);
+#endif
+
   if (set_mc_xmit_options)
   {
     rc = ipv6 ? set_mc_options_transmit_ipv6 (gv, intf, sock) : set_mc_options_transmit_ipv4 (gv, intf, sock);
@@ -765,8 +1962,39 @@ static dds_return_t ddsi_udp_create_conn (struct ddsi_tran_conn **conn_out, stru
   conn->m_base.m_base.m_handle_fn = ddsi_udp_conn_handle;
 
   conn->m_base.m_read_fn = ddsi_udp_conn_read;
+#if DDSRT_HAVE_MMSG
+  conn->m_base.m_read_multiple_fn = ddsi_udp_conn_read_multiple;
+#else
+  conn->m_base.m_read_multiple_fn = 0;
+#endif
   conn->m_base.m_write_fn = ddsi_udp_conn_write;
+#if DDSRT_HAVE_MMSG
+  conn->m_base.m_write_multiple_fn = ddsi_udp_conn_write_multiple;
+#else
+  conn->m_base.m_write_multiple_fn = 0;
+#endif
+  conn->m_base.m_write_segmented_fn = 0;
+  conn->m_base.m_write_zerocopy_fn = 0;
+#if UDP_URING
+  ddsrt_mutex_init (&conn->m_uring_send_lock);
+  conn->m_base.m_read_multiple_fn = ddsi_udp_conn_read_multiple_uring;
+  conn->m_base.m_write_fn = ddsi_udp_conn_write_uring;
+  conn->m_base.m_write_multiple_fn = ddsi_udp_conn_write_multiple_uring;
+#endif
+#if UDP_SEGMENTATION_OFFLOAD
+  if (gv->config.udp_segmentation_offload)
+    set_segmentation_offload (gv, conn, qos->m_purpose);
+#endif
+#if UDP_ZEROCOPY
+  if (gv->config.zerocopy_send_threshold > 0)
+    set_zerocopy (gv, conn, qos->m_purpose);
+#endif
+#if UDP_TIMESTAMPS
+  if (gv->config.socket_timestamps != DDSI_SOCKTS_NONE)
+    set_socket_timestamps (gv, conn, qos->m_purpose);
+#endif
   conn->m_base.m_disable_multiplexing_fn = ddsi_udp_disable_multiplexing;
+  conn->m_base.m_set_busy_poll_fn = ddsi_udp_set_busy_poll;
   conn->m_base.m_locator_fn = ddsi_udp_conn_locator;
 
   char bindaddr[DDSI_LOCSTRLEN];
@@ -909,6 +2137,14 @@ static void ddsi_udp_release_conn (struct ddsi_tran_conn * conn_cmn)
     ddsrt_hh_remove_present (fact->ownaddrs, &conn->m_addr);
     ddsrt_mutex_unlock (&fact->ownaddrs_lock);
   }
+#if UDP_URING
+  udp_uring_recv_fini (conn);
+  udp_uring_send_fini (conn);
+  ddsrt_mutex_destroy (&conn->m_uring_send_lock);
+#endif
+#if UDP_ZEROCOPY
+  udp_zerocopy_fini (conn);
+#endif
   ddsrt_socket_ext_fini (&conn->m_sockext);
   ddsrt_close (conn->m_sockext.sock);
 #if defined _WIN32 && !defined WINCE
@@ -1160,6 +2396,20 @@ static bool ownaddrs_eq6 (const void *va, const void *vb)
 
 int ddsi_udp_init (struct ddsi_domaingv*gv)
 {
+#if UDP_URING
+  // Rings are per socket and created lazily, this is only to report a kernel that
+  // doesn't support io_uring (or where it is disabled) at start-up
+  {
+    struct ddsi_uring ring;
+    dds_return_t rc;
+    if ((rc = ddsi_uring_init (&ring, 1)) != DDS_RETCODE_OK)
+    {
+      GVERROR ("ddsi_udp_init: io_uring not available: %s\n", dds_strretcode (rc));
+      return -1;
+    }
+    ddsi_uring_fini (&ring);
+  }
+#endif
   struct ddsi_udp_tran_factory *fact = ddsrt_malloc (sizeof (*fact));
   memset (fact, 0, sizeof (*fact));
   fact->m_kind = DDSI_LOCATOR_KIND_UDPv4;
@@ -1225,6 +2475,10 @@ int ddsi_udp_init (struct ddsi_domaingv*gv)
   ddsrt_atomic_st32 (&fact->receive_buf_size, UINT32_MAX);
 
   ddsi_factory_add (gv, &fact->fact);
-  GVLOG (DDS_LC_CONFIG, "udp initialized\n");
+  GVLOG (DDS_LC_CONFIG, "udp initialized%s\n", UDP_URING ? " (io_uring)" : "");
+  if (!UDP_ZEROCOPY && gv->config.zerocopy_send_threshold > 0)
+    GVLOG (DDS_LC_CONFIG, "udp: zero-copy transmission not supported, ignoring ZeroCopySendThreshold\n");
+  if (!UDP_TIMESTAMPS && gv->config.socket_timestamps != DDSI_SOCKTS_NONE)
+    GVLOG (DDS_LC_CONFIG, "udp: socket timestamps not supported, ignoring SocketTimestamps\n");
   return 0;
 }
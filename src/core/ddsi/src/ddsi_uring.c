@@ -0,0 +1,152 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include "ddsi__uring.h"
+
+#if DDSI_HAVE_URING
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// The shared ring indices are written by one side and read by the other, the
+// acquire/release pairs are what the kernel documentation (and liburing) use.
+#define LOAD_ACQUIRE(p) __atomic_load_n ((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+
+static void *ring_ptr (void *base, uint32_t off)
+{
+  return (unsigned char *) base + off;
+}
+
+dds_return_t ddsi_uring_init (struct ddsi_uring *ring, uint32_t entries)
+{
+  struct io_uring_params p;
+  memset (&p, 0, sizeof (p));
+  memset (ring, 0, sizeof (*ring));
+  const long fd = syscall (__NR_io_uring_setup, entries, &p);
+  if (fd < 0)
+  {
+    // ENOSYS: kernel too old or built without it, EPERM: disabled by the administrator
+    // (kernel.io_uring_disabled), EINVAL: flags or entries not supported
+    return (errno == ENOSYS || errno == EPERM || errno == EINVAL) ? DDS_RETCODE_UNSUPPORTED : DDS_RETCODE_ERROR;
+  }
+  ring->fd = (int) fd;
+  ring->sq_entries = p.sq_entries;
+  ring->cq_entries = p.cq_entries;
+  ring->sq_ring_sz = p.sq_off.array + p.sq_entries * sizeof (uint32_t);
+  ring->cq_ring_sz = p.cq_off.cqes + p.cq_entries * sizeof (struct io_uring_cqe);
+  ring->sqes_sz = p.sq_entries * sizeof (struct io_uring_sqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if (ring->cq_ring_sz > ring->sq_ring_sz)
+      ring->sq_ring_sz = ring->cq_ring_sz;
+    ring->cq_ring_sz = ring->sq_ring_sz;
+  }
+
+  ring->sq_ring_ptr = mmap (NULL, ring->sq_ring_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ring_ptr == MAP_FAILED)
+    goto err_sq_ring;
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+    ring->cq_ring_ptr = ring->sq_ring_ptr;
+  else
+  {
+    ring->cq_ring_ptr = mmap (NULL, ring->cq_ring_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring_ptr == MAP_FAILED)
+      goto err_cq_ring;
+  }
+  ring->sqes = mmap (NULL, ring->sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED)
+    goto err_sqes;
+
+  ring->sq_head = ring_ptr (ring->sq_ring_ptr, p.sq_off.head);
+  ring->sq_tail = ring_ptr (ring->sq_ring_ptr, p.sq_off.tail);
+  ring->sq_mask = ring_ptr (ring->sq_ring_ptr, p.sq_off.ring_mask);
+  ring->sq_array = ring_ptr (ring->sq_ring_ptr, p.sq_off.array);
+  ring->cq_head = ring_ptr (ring->cq_ring_ptr, p.cq_off.head);
+  ring->cq_tail = ring_ptr (ring->cq_ring_ptr, p.cq_off.tail);
+  ring->cq_mask = ring_ptr (ring->cq_ring_ptr, p.cq_off.ring_mask);
+  ring->cqes = ring_ptr (ring->cq_ring_ptr, p.cq_off.cqes);
+  ring->sqe_tail = *ring->sq_tail;
+  // submission queue entries are always used in order, so the indirection array
+  // can be the identity mapping
+  for (uint32_t i = 0; i < ring->sq_entries; i++)
+    ring->sq_array[i] = i;
+  return DDS_RETCODE_OK;
+
+err_sqes:
+  if (ring->cq_ring_ptr != ring->sq_ring_ptr)
+    munmap (ring->cq_ring_ptr, ring->cq_ring_sz);
+err_cq_ring:
+  munmap (ring->sq_ring_ptr, ring->sq_ring_sz);
+err_sq_ring:
+  close (ring->fd);
+  return DDS_RETCODE_ERROR;
+}
+
+void ddsi_uring_fini (struct ddsi_uring *ring)
+{
+  // closing the file descriptor cancels anything that is still outstanding
+  munmap (ring->sqes, ring->sqes_sz);
+  if (ring->cq_ring_ptr != ring->sq_ring_ptr)
+    munmap (ring->cq_ring_ptr, ring->cq_ring_sz);
+  munmap (ring->sq_ring_ptr, ring->sq_ring_sz);
+  close (ring->fd);
+}
+
+struct io_uring_sqe *ddsi_uring_get_sqe (struct ddsi_uring *ring)
+{
+  const uint32_t head = LOAD_ACQUIRE (ring->sq_head);
+  if (ring->sqe_tail - head >= ring->sq_entries)
+    return NULL;
+  struct io_uring_sqe *sqe = &ring->sqes[ring->sqe_tail & *ring->sq_mask];
+  ring->sqe_tail++;
+  memset (sqe, 0, sizeof (*sqe));
+  return sqe;
+}
+
+dds_return_t ddsi_uring_submit_and_wait (struct ddsi_uring *ring, uint32_t wait_nr)
+{
+  // Entries the kernel did not consume in a previous call (because of an error)
+  // are still between the kernel's head and our tail and get submitted again
+  STORE_RELEASE (ring->sq_tail, ring->sqe_tail);
+  const uint32_t to_submit = ring->sqe_tail - LOAD_ACQUIRE (ring->sq_head);
+  if (to_submit == 0 && wait_nr == 0)
+    return DDS_RETCODE_OK;
+  const unsigned flags = (wait_nr > 0) ? IORING_ENTER_GETEVENTS : 0;
+  if (syscall (__NR_io_uring_enter, ring->fd, to_submit, wait_nr, flags, NULL, 0) >= 0)
+    return DDS_RETCODE_OK;
+  switch (errno)
+  {
+    case EINTR:
+      return DDS_RETCODE_INTERRUPTED;
+    case EAGAIN:
+    case EBUSY:
+      return DDS_RETCODE_TRY_AGAIN;
+    default:
+      return DDS_RETCODE_ERROR;
+  }
+}
+
+struct io_uring_cqe *ddsi_uring_peek_cqe (struct ddsi_uring *ring)
+{
+  const uint32_t head = *ring->cq_head;
+  if (head == LOAD_ACQUIRE (ring->cq_tail))
+    return NULL;
+  return &ring->cqes[head & *ring->cq_mask];
+}
+
+void ddsi_uring_cqe_seen (struct ddsi_uring *ring)
+{
+  STORE_RELEASE (ring->cq_head, *ring->cq_head + 1);
+}
+
+#endif /* DDSI_HAVE_URING */
@@ -0,0 +1,40 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+// ddsi_udp.c needs these before any socket-related system header is included.
+#ifndef __APPLE_USE_RFC_3542
+#define __APPLE_USE_RFC_3542
+#endif
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "ddsi__uring.h"
+
+#if DDSI_HAVE_URING
+
+#define UDP_URING 1
+#define ddsi_udp_init ddsi_uringudp_init
+
+#include "ddsi_udp.c"
+
+#else
+
+#include "dds/ddsi/ddsi_log.h"
+#include "dds/ddsi/ddsi_domaingv.h"
+#include "ddsi__udp.h"
+
+int ddsi_uringudp_init (struct ddsi_domaingv *gv)
+{
+  GVERROR ("ddsi_uringudp_init: io_uring is not supported on this platform\n");
+  return -1;
+}
+
+#endif
@@ -8,7 +8,9 @@
 //
 // SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
 
+#include "dds/ddsrt/atomics.h"
 #include "dds/ddsi/ddsi_protocol.h"
+#include "dds/ddsi/ddsi_domaingv.h"
 #include "ddsi__whc.h"
 
 extern inline ddsi_seqno_t ddsi_whc_next_seq (const struct ddsi_whc *whc, ddsi_seqno_t seq);
@@ -19,6 +21,18 @@ extern inline void ddsi_whc_return_sample (struct ddsi_whc *whc, struct ddsi_whc
 extern inline void ddsi_whc_sample_iter_init (const struct ddsi_whc *whc, struct ddsi_whc_sample_iter *it);
 extern inline bool ddsi_whc_sample_iter_borrow_next (struct ddsi_whc_sample_iter *it, struct ddsi_whc_borrowed_sample *sample);
 extern inline void ddsi_whc_free (struct ddsi_whc *whc);
-extern int ddsi_whc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk);
+extern int ddsi_whc_insert (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, ddsi_seqno_t seq, ddsrt_mtime_t exp, struct ddsi_serdata *serdata, struct ddsi_tkmap_instance *tk, uint64_t filter_rejects);
 extern unsigned ddsi_whc_remove_acked_messages (struct ddsi_whc *whc, ddsi_seqno_t max_drop_seq, struct ddsi_whc_state *whcst, struct ddsi_whc_node **deferred_free_list);
 extern void ddsi_whc_free_deferred_free_list (struct ddsi_whc *whc, struct ddsi_whc_node *deferred_free_list);
+
+void ddsi_whc_account_unacked_bytes (struct ddsi_domaingv *gv, size_t old_unacked_bytes, size_t new_unacked_bytes)
+{
+  if (new_unacked_bytes > old_unacked_bytes)
+    ddsrt_atomic_add64 (&gv->whc_unacked_bytes, (uint64_t) (new_unacked_bytes - old_unacked_bytes));
+  else if (new_unacked_bytes < old_unacked_bytes)
+    ddsrt_atomic_sub64 (&gv->whc_unacked_bytes, (uint64_t) (old_unacked_bytes - new_unacked_bytes));
+  if (old_unacked_bytes == 0 && new_unacked_bytes > 0)
+    ddsrt_atomic_inc32 (&gv->whc_unacked_writers);
+  else if (old_unacked_bytes > 0 && new_unacked_bytes == 0)
+    ddsrt_atomic_dec32 (&gv->whc_unacked_writers);
+}
@@ -715,7 +715,7 @@ void ddsi_qxev_nt_callback (struct ddsi_xeventq *evq, void (*cb) (void *arg), vo
   ddsrt_mutex_unlock (&evq->lock);
 }
 
-enum ddsi_qxev_msg_rexmit_result ddsi_qxev_msg_rexmit_wrlock_held (struct ddsi_xeventq *evq, struct ddsi_xmsg *msg, int force)
+enum ddsi_qxev_msg_rexmit_result ddsi_qxev_msg_rexmit (struct ddsi_xeventq *evq, struct ddsi_xmsg *msg, struct ddsi_addrset *wras, int force)
 {
   struct ddsi_domaingv * const gv = evq->gv;
   size_t msg_size = ddsi_xmsg_size (msg);
@@ -724,7 +724,7 @@ enum ddsi_qxev_msg_rexmit_result ddsi_qxev_msg_rexmit_wrlock_held (struct ddsi_x
   assert (evq);
   assert (ddsi_xmsg_kind (msg) == DDSI_XMSG_KIND_DATA_REXMIT || ddsi_xmsg_kind (msg) == DDSI_XMSG_KIND_DATA_REXMIT_NOMERGE);
   ddsrt_mutex_lock (&evq->lock);
-  if ((existing_ev = lookup_msg (evq, msg)) != NULL && ddsi_xmsg_merge_rexmit_destinations_wrlock_held (gv, existing_ev->u.msg_rexmit.msg, msg))
+  if ((existing_ev = lookup_msg (evq, msg)) != NULL && ddsi_xmsg_merge_rexmit_destinations (gv, existing_ev->u.msg_rexmit.msg, msg, wras))
   {
     /* MSG got merged with a pending retransmit, so it has effectively been queued */
     ddsrt_mutex_unlock (&evq->lock);
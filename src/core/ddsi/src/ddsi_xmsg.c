@@ -129,6 +129,12 @@ struct ddsi_xmsg {
 #define DDSI_XMSG_MAX_MESSAGE_IOVECS 256
 #endif
 
+/* UDP segmentation offload: at most this many datagrams per send,
+   matching the Linux kernel's UDP_MAX_SEGMENTS, and the total must fit
+   in a single (IPv4) UDP datagram */
+#define DDSI_XPACK_GSO_MAX_SEGMENTS 64
+#define DDSI_XPACK_GSO_MAX_TOTAL_SIZE 65507
+
 /* Used to keep them in order, but it now transpires that delayed
    updating of writer seq nos benefits from having them in the
    reverse order.  They are not being used for anything else, so
@@ -172,6 +178,18 @@ struct ddsi_xpack
   bool includes_rexmit;
   struct ddsi_xmsg_chain included_msgs;
 
+  /* With segmentation offload, the xpack is a sequence of RTPS messages
+     all but the last one padded to the segment size, and msg_len.length
+     is the size of the last one.  gso_seg_niov is the index of the first
+     iovec of the last message. */
+  uint32_t gso_nsegs;
+  size_t gso_seg_niov;
+  ddsi_rtps_submessage_header_t gso_pad[DDSI_XPACK_GSO_MAX_SEGMENTS];
+
+  /* Only set while sending a message in which the sample data is not copied by
+     the transport, msgfrags then refers to the copy made for it */
+  ddsi_tran_write_keepalive_t *zerocopy;
+
 #ifdef DDS_HAS_NETWORK_PARTITIONS
   uint32_t encoderId;
 #endif /* DDS_HAS_NETWORK_PARTITIONS */
@@ -813,7 +831,7 @@ static int readerId_compatible (const struct ddsi_xmsg *m, const struct ddsi_xms
   return e.u == DDSI_ENTITYID_UNKNOWN || e.u == eadd.u;
 }
 
-int ddsi_xmsg_merge_rexmit_destinations_wrlock_held (struct ddsi_domaingv *gv, struct ddsi_xmsg *m, const struct ddsi_xmsg *madd)
+int ddsi_xmsg_merge_rexmit_destinations (struct ddsi_domaingv *gv, struct ddsi_xmsg *m, const struct ddsi_xmsg *madd, struct ddsi_addrset *wras)
 {
   assert (m->kindspecific.data.wrseq >= 1);
   assert (m->kindspecific.data.wrguid.prefix.u[0] != 0);
@@ -863,26 +881,13 @@ int ddsi_xmsg_merge_rexmit_destinations_wrlock_held (struct ddsi_domaingv *gv, s
         case NN_XMSG_DST_ONE:
           if (memcmp (&m->data->dst.guid_prefix, &madd->data->dst.guid_prefix, sizeof (m->data->dst.guid_prefix)) != 0)
           {
-            struct ddsi_writer *wr;
-            /* This is why wr->e.lock must be held: we can't safely
-               reference the writer's address set if it isn't -- so
-               FIXME: add a way to atomically replace the contents of
-               an addrset in ddsi_rebuild_writer_addrset: then we don't
-               need the lock anymore, and the '_wrlock_held' suffix
-               can go and everyone's life will become easier! */
-            if ((wr = ddsi_entidx_lookup_writer_guid (gv->entity_index, &m->kindspecific.data.wrguid)) == NULL)
-            {
-              GVTRACE ("writer-dead)");
-              return 0;
-            }
-            else
-            {
-              GVTRACE ("1+1->*)");
-              clear_readerId (m);
-              m->dstmode = NN_XMSG_DST_ALL;
-              m->dstaddr.all.as = ddsi_ref_addrset (wr->as);
-              return 1;
-            }
+            /* The caller provides the writer's address set: the writer may replace wr->as
+               at any time unless its lock is held, so it can't be read here. */
+            GVTRACE ("1+1->*)");
+            clear_readerId (m);
+            m->dstmode = NN_XMSG_DST_ALL;
+            m->dstaddr.all.as = ddsi_ref_addrset (wras);
+            return 1;
           }
           else if (readerId_compatible (m, madd))
           {
@@ -1070,6 +1075,8 @@ static void ddsi_xpack_reinit (struct ddsi_xpack *xp)
   xp->msg_len.length = 0;
   xp->includes_rexmit = false;
   xp->included_msgs.latest = NULL;
+  xp->gso_nsegs = 0;
+  xp->gso_seg_niov = 0;
   xp->maxdelay = DDS_INFINITY;
 #ifdef DDS_HAS_SECURITY
   xp->sec_info.use_rtps_encoding = 0;
@@ -1117,6 +1124,16 @@ void ddsi_xpack_free (struct ddsi_xpack *xp)
   ddsrt_free (xp);
 }
 
+static uint32_t ddsi_xpack_gso_segsize (const struct ddsi_xpack *xp)
+{
+  return xp->gv->config.max_msg_size & ~(uint32_t) 3;
+}
+
+static uint32_t ddsi_xpack_size (const struct ddsi_xpack *xp)
+{
+  return xp->gso_nsegs * ddsi_xpack_gso_segsize (xp) + xp->msg_len.length;
+}
+
 ddsrt_nonnull ((1, 2))
 static dds_return_t ddsi_xpack_send_rtps(struct ddsi_xpack * xp, const ddsi_xlocator_t *loc, size_t *bytes_written)
 {
@@ -1140,6 +1157,15 @@ static dds_return_t ddsi_xpack_send_rtps(struct ddsi_xpack * xp, const ddsi_xloc
   }
   else
 #endif /* DDS_HAS_SECURITY */
+  if (xp->gso_nsegs > 0)
+  {
+    ret = ddsi_conn_write_segmented (loc->conn, &loc->c, xp->msgfrags, ddsi_xpack_gso_segsize (xp), xp->call_flags, bytes_written);
+  }
+  else if (xp->zerocopy)
+  {
+    ret = ddsi_conn_write_zerocopy (loc->conn, &loc->c, xp->msgfrags, xp->zerocopy, xp->call_flags, bytes_written);
+  }
+  else
   {
     ret = ddsi_conn_write (loc->conn, &loc->c, xp->msgfrags, xp->call_flags, bytes_written);
   }
@@ -1193,7 +1219,7 @@ static dds_return_t ddsi_xpack_send1 (const ddsi_xlocator_t *loc, void * varg, s
   {
     GVTRACE ("(dropped)");
     if (bytes_written)
-      *bytes_written = xp->msg_len.length;
+      *bytes_written = ddsi_xpack_size (xp);
     ret = DDS_RETCODE_OK;
   }
 
@@ -1208,6 +1234,215 @@ static void ddsi_xpack_send1v (const ddsi_xlocator_t *loc, void * varg)
   (void) ddsi_xpack_send1 (loc, varg, NULL);
 }
 
+/* Maximum number of destinations written in one call to ddsi_conn_write_multiple */
+#define XPACK_SEND_BATCH_MAX 16
+
+struct ddsi_xpack_send_batch {
+  struct ddsi_xpack *xp;
+  struct ddsi_tran_conn *conn;
+  uint32_t n;
+  ddsi_locator_t dsts[XPACK_SEND_BATCH_MAX];
+};
+
+ddsrt_nonnull_all
+static bool ddsi_xpack_can_send_batched (const struct ddsi_xpack *xp)
+{
+  /* Dropping packets for testing, muting and encoding per destination all
+     require sending to each destination individually */
+  struct ddsi_domaingv const * const gv = xp->gv;
+  if (gv->mute || gv->config.xmit_lossiness > 0)
+    return false;
+#ifdef DDS_HAS_SECURITY
+  if (xp->sec_info.use_rtps_encoding)
+    return false;
+#endif
+  /* Segmentation offload already sends multiple datagrams in one call */
+  if (xp->gso_nsegs > 0)
+    return false;
+  /* Zero-copy transmission is only supported for a single destination */
+  if (xp->zerocopy)
+    return false;
+  return true;
+}
+
+ddsrt_nonnull_all
+static void ddsi_xpack_send_batch_flush (struct ddsi_xpack_send_batch *batch)
+{
+  ddsi_tran_write_buf_t bufs[XPACK_SEND_BATCH_MAX];
+  if (batch->n == 0)
+    return;
+  for (uint32_t i = 0; i < batch->n; i++)
+  {
+    bufs[i].dst = &batch->dsts[i];
+    bufs[i].msgfrags = batch->xp->msgfrags;
+  }
+  ddsi_conn_write_multiple (batch->conn, bufs, batch->n, batch->xp->call_flags);
+  /* Clear call flags, as used on a per call basis */
+  batch->xp->call_flags = 0;
+  batch->n = 0;
+}
+
+ddsrt_nonnull ((1))
+static void ddsi_xpack_send_batch_add (const ddsi_xlocator_t *loc, void * varg)
+{
+  struct ddsi_xpack_send_batch * const batch = varg;
+  struct ddsi_domaingv const * const gv = batch->xp->gv;
+
+  if (gv->logconfig.c.mask & DDS_LC_TRACE)
+  {
+    char buf[DDSI_LOCSTRLEN];
+    GVTRACE (" %s", ddsi_xlocator_to_string (buf, sizeof(buf), loc));
+  }
+
+  assert (loc->c.kind != DDSI_LOCATOR_KIND_PSMX);
+  if (batch->n > 0 && (batch->conn != loc->conn || batch->n == XPACK_SEND_BATCH_MAX))
+    ddsi_xpack_send_batch_flush (batch);
+  /* Locators are copied because the flush at the end happens after the
+     address set has been unlocked, connections live as long as the domain */
+  batch->conn = loc->conn;
+  batch->dsts[batch->n++] = loc->c;
+}
+
+ddsrt_nonnull_all
+static size_t ddsi_xpack_send_addrset (struct ddsi_xpack *xp, struct ddsi_addrset *as, bool uc_only)
+{
+  size_t calls;
+  if (!ddsi_xpack_can_send_batched (xp))
+  {
+    if (uc_only)
+      calls = ddsi_addrset_forall_uc_count (as, ddsi_xpack_send1v, xp);
+    else
+      calls = ddsi_addrset_forall_count (as, ddsi_xpack_send1v, xp);
+  }
+  else
+  {
+    struct ddsi_xpack_send_batch batch = { .xp = xp, .conn = NULL, .n = 0 };
+    if (uc_only)
+      calls = ddsi_addrset_forall_uc_count (as, ddsi_xpack_send_batch_add, &batch);
+    else
+      calls = ddsi_addrset_forall_count (as, ddsi_xpack_send_batch_add, &batch);
+    ddsi_xpack_send_batch_flush (&batch);
+  }
+  return calls;
+}
+
+/* Zero-copy transmission: the transport may continue to use the memory after the
+   write returns, so the serialised samples are taken over from the xmsgs and the
+   remainder of the message is copied into a buffer of its own.  The xmsgs then get
+   released as usual. */
+struct ddsi_xpack_zerocopy {
+  ddsi_tran_write_keepalive_t c;
+  ddsi_tran_write_msgfrags_t *msgfrags;
+  uint32_t npayloads;
+  struct {
+    struct ddsi_serdata *serdata;
+    ddsrt_iovec_t iov;
+  } payloads[];
+};
+
+static void ddsi_xpack_zerocopy_free (ddsi_tran_write_keepalive_t *keepalive)
+{
+  struct ddsi_xpack_zerocopy * const zc = (struct ddsi_xpack_zerocopy *) keepalive;
+  for (uint32_t i = 0; i < zc->npayloads; i++)
+    ddsi_serdata_to_ser_unref (zc->payloads[i].serdata, &zc->payloads[i].iov);
+  ddsrt_free (zc->msgfrags);
+  ddsrt_free (zc);
+}
+
+static bool ddsi_xpack_zerocopy_is_payload (const struct ddsi_xpack_zerocopy *zc, const ddsrt_iovec_t *iov)
+{
+  /* ref'd payloads are never merged with other iovecs */
+  for (uint32_t i = 0; i < zc->npayloads; i++)
+    if (zc->payloads[i].iov.iov_base == iov->iov_base && zc->payloads[i].iov.iov_len == iov->iov_len)
+      return true;
+  return false;
+}
+
+ddsrt_nonnull_all
+static struct ddsi_xpack_zerocopy *ddsi_xpack_zerocopy_new (struct ddsi_xpack *xp)
+{
+  struct ddsi_domaingv const * const gv = xp->gv;
+  struct ddsi_xmsg_chain_elem *ce;
+  if (gv->config.zerocopy_send_threshold == 0 || xp->gso_nsegs > 0)
+    return NULL;
+#ifdef DDS_HAS_SECURITY
+  if (xp->sec_info.use_rtps_encoding)
+    return NULL;
+#endif
+
+  /* Only worth it if the message contains (part of) a large sample */
+  uint32_t npayloads = 0;
+  bool large = false;
+  for (ce = xp->included_msgs.latest; ce; ce = ce->older)
+  {
+    const struct ddsi_xmsg *m = (const struct ddsi_xmsg *) ((const char *) ce - offsetof (struct ddsi_xmsg, link));
+    if (m->refd_payload == NULL)
+      continue;
+#ifdef DDS_HAS_SECURITY
+    /* an encoded payload is a copy anyway */
+    if (m->refd_payload_encoded)
+      return NULL;
+#endif
+    npayloads++;
+    if (ddsi_serdata_size (m->refd_payload) >= gv->config.zerocopy_send_threshold)
+      large = true;
+  }
+  if (!large)
+    return NULL;
+
+  struct ddsi_xpack_zerocopy *zc = ddsrt_malloc (sizeof (*zc) + npayloads * sizeof (zc->payloads[0]));
+  ddsrt_atomic_st32 (&zc->c.refc, 1);
+  zc->c.free = ddsi_xpack_zerocopy_free;
+  zc->npayloads = 0;
+  for (ce = xp->included_msgs.latest; ce; ce = ce->older)
+  {
+    const struct ddsi_xmsg *m = (const struct ddsi_xmsg *) ((const char *) ce - offsetof (struct ddsi_xmsg, link));
+    if (m->refd_payload)
+    {
+      zc->payloads[zc->npayloads].serdata = m->refd_payload;
+      zc->payloads[zc->npayloads].iov = m->refd_payload_iov;
+      zc->npayloads++;
+    }
+  }
+
+  const size_t niov = xp->msgfrags->niov;
+  size_t ncopy = 0;
+  for (size_t i = 0; i < niov; i++)
+    if (!ddsi_xpack_zerocopy_is_payload (zc, &xp->msgfrags->iov[i]))
+      ncopy += xp->msgfrags->iov[i].iov_len;
+  zc->msgfrags = ddsrt_malloc (sizeof (*zc->msgfrags) + niov * sizeof (ddsrt_iovec_t) + ncopy);
+  unsigned char *copy = (unsigned char *) &zc->msgfrags->iov[niov];
+  size_t n = 0;
+  for (size_t i = 0; i < niov; i++)
+  {
+    const ddsrt_iovec_t *iov = &xp->msgfrags->iov[i];
+    if (ddsi_xpack_zerocopy_is_payload (zc, iov))
+      zc->msgfrags->iov[n++] = *iov;
+    else
+    {
+      memcpy (copy, iov->iov_base, iov->iov_len);
+      if (n > 0 && (unsigned char *) zc->msgfrags->iov[n-1].iov_base + zc->msgfrags->iov[n-1].iov_len == copy)
+        zc->msgfrags->iov[n-1].iov_len += iov->iov_len;
+      else
+      {
+        zc->msgfrags->iov[n].iov_base = copy;
+        zc->msgfrags->iov[n].iov_len = iov->iov_len;
+        n++;
+      }
+      copy += iov->iov_len;
+    }
+  }
+  zc->msgfrags->niov = n;
+
+  /* Nothing can fail anymore, so the payloads can be taken over */
+  for (ce = xp->included_msgs.latest; ce; ce = ce->older)
+  {
+    struct ddsi_xmsg *m = (struct ddsi_xmsg *) ((char *) ce - offsetof (struct ddsi_xmsg, link));
+    m->refd_payload = NULL;
+  }
+  return zc;
+}
+
 ddsrt_nonnull_all
 static void ddsi_xpack_send_real (struct ddsi_xpack *xp)
 {
@@ -1225,13 +1460,22 @@ static void ddsi_xpack_send_real (struct ddsi_xpack *xp)
   if (gv->logconfig.c.mask & DDS_LC_TRACE)
   {
     int i;
-    GVTRACE ("ddsi_xpack_send %"PRIu32":", xp->msg_len.length);
+    GVTRACE ("ddsi_xpack_send %"PRIu32":", ddsi_xpack_size (xp));
     for (i = 0; i < (int) xp->msgfrags->niov; i++)
     {
       GVTRACE (" %p:%lu", (void *) xp->msgfrags->iov[i].iov_base, (unsigned long) xp->msgfrags->iov[i].iov_len);
     }
   }
 
+  ddsi_tran_write_msgfrags_t * const msgfrags = xp->msgfrags;
+  struct ddsi_xpack_zerocopy * const zc = ddsi_xpack_zerocopy_new (xp);
+  if (zc)
+  {
+    GVTRACE (" zerocopy");
+    xp->msgfrags = zc->msgfrags;
+    xp->zerocopy = &zc->c;
+  }
+
   size_t calls = 0;
   GVTRACE (" [");
   switch (xp->dstmode)
@@ -1249,14 +1493,14 @@ static void ddsi_xpack_send_real (struct ddsi_xpack *xp)
          it is updated, but that might not be something we want to guarantee */
       if (xp->dstaddr.all.as)
       {
-        calls = ddsi_addrset_forall_count (xp->dstaddr.all.as, ddsi_xpack_send1v, xp);
+        calls = ddsi_xpack_send_addrset (xp, xp->dstaddr.all.as, false);
         ddsi_unref_addrset (xp->dstaddr.all.as);
       }
       break;
     case NN_XMSG_DST_ALL_UC:
       if (xp->dstaddr.all_uc.as)
       {
-        calls = ddsi_addrset_forall_uc_count (xp->dstaddr.all_uc.as, ddsi_xpack_send1v, xp);
+        calls = ddsi_xpack_send_addrset (xp, xp->dstaddr.all_uc.as, true);
         ddsi_unref_addrset (xp->dstaddr.all_uc.as);
       }
       break;
@@ -1264,7 +1508,13 @@ static void ddsi_xpack_send_real (struct ddsi_xpack *xp)
   GVTRACE (" ]\n");
   if (calls)
   {
-    GVLOG (DDS_LC_TRAFFIC, "traffic-xmit (%lu) %"PRIu32"\n", (unsigned long) calls, xp->msg_len.length);
+    GVLOG (DDS_LC_TRAFFIC, "traffic-xmit (%lu) %"PRIu32"\n", (unsigned long) calls, ddsi_xpack_size (xp));
+  }
+  if (zc)
+  {
+    xp->msgfrags = msgfrags;
+    xp->zerocopy = NULL;
+    ddsi_tran_write_keepalive_unref (&zc->c);
   }
   ddsi_xmsg_chain_release (xp->gv, &xp->included_msgs);
   ddsi_xpack_reinit (xp);
@@ -1350,6 +1600,14 @@ void ddsi_xpack_send (struct ddsi_xpack *xp, bool immediately)
       xp1->msgfrags = ddsrt_malloc (sizeof (*xp->msgfrags) + xp->msgfrags->niov * sizeof (ddsrt_iovec_t));
       xp1->msgfrags->niov = xp->msgfrags->niov;
       memcpy (xp1->msgfrags->iov, xp->msgfrags->iov, xp->msgfrags->niov * sizeof (*xp->msgfrags->iov));
+      /* The RTPS header and padding live in xp, which gets reused before
+         the copy is sent, so those iovecs must point into the copy */
+      for (size_t i = 0; i < xp1->msgfrags->niov; i++)
+      {
+        char * const base = xp1->msgfrags->iov[i].iov_base;
+        if (base >= (char *) xp && base < (char *) (xp + 1))
+          xp1->msgfrags->iov[i].iov_base = (char *) xp1 + (base - (char *) xp);
+      }
     }
     ddsi_xpack_reinit (xp);
     xp1->sendq_next = NULL;
@@ -1421,6 +1679,64 @@ static int ddsi_xmsg_is_rexmit (const struct ddsi_xmsg *m)
   return 0;
 }
 
+static bool ddsi_xpack_may_add_segment (const struct ddsi_xpack *xp, const struct ddsi_xmsg *m)
+{
+  /* A new segment can be started if segmentation offload is enabled, the
+     current message fits in a segment (so it can be padded), there is room
+     for another segment and m is guaranteed to fit in an empty message */
+  struct ddsi_domaingv const * const gv = xp->gv;
+  const uint32_t segsize = ddsi_xpack_gso_segsize (xp);
+  if (!gv->config.udp_segmentation_offload || !gv->m_factory->m_connless)
+    return false;
+  if (xp->includes_rexmit || ddsi_xmsg_is_rexmit (m))
+    return false;
+#ifdef DDS_HAS_SECURITY
+  if (xp->sec_info.use_rtps_encoding || m->sec_info.use_rtps_encoding)
+    return false;
+#endif
+  if (xp->gso_nsegs + 2 > DDSI_XPACK_GSO_MAX_SEGMENTS || (xp->gso_nsegs + 2) * segsize > DDSI_XPACK_GSO_MAX_TOTAL_SIZE)
+    return false;
+  if (xp->msg_len.length > segsize)
+    return false;
+  const size_t payload_size = m->refd_payload ? (size_t) m->refd_payload_iov.iov_len : 0;
+  if (sizeof (xp->hdr) + sizeof (m->data->src) + sizeof (m->data->dst) + m->sz + payload_size > segsize)
+    return false;
+  /* padding (2), RTPS header (1), INFO_SRC (1) + submessage */
+  return xp->msgfrags->niov + 4 + DDSI_XMSG_MAX_SUBMESSAGE_IOVECS <= DDSI_XMSG_MAX_MESSAGE_IOVECS;
+}
+
+static void ddsi_xpack_add_segment (struct ddsi_xpack *xp)
+{
+  /* Pads the current message to the segment size with a PAD submessage,
+     the contents of which are taken from a block of zeros */
+  static unsigned char zeros[DDSI_XPACK_GSO_MAX_TOTAL_SIZE / 2];
+  const uint32_t segsize = ddsi_xpack_gso_segsize (xp);
+  size_t niov = xp->msgfrags->niov;
+  assert (xp->msg_len.length <= segsize && (xp->msg_len.length % 4) == 0);
+  if (xp->msg_len.length < segsize)
+  {
+    const uint32_t padsize = segsize - xp->msg_len.length - (uint32_t) DDSI_RTPS_SUBMESSAGE_HEADER_SIZE;
+    ddsi_rtps_submessage_header_t * const pad = &xp->gso_pad[xp->gso_nsegs];
+    assert (padsize <= sizeof (zeros));
+    pad->submessageId = DDSI_RTPS_SMID_PAD;
+    pad->flags = (DDSRT_ENDIAN == DDSRT_LITTLE_ENDIAN ? DDSI_RTPS_SUBMESSAGE_FLAG_ENDIANNESS : 0);
+    pad->octetsToNextHeader = (uint16_t) padsize;
+    xp->msgfrags->iov[niov].iov_base = (void *) pad;
+    xp->msgfrags->iov[niov].iov_len = sizeof (*pad);
+    niov++;
+    if (padsize > 0)
+    {
+      xp->msgfrags->iov[niov].iov_base = (void *) zeros;
+      xp->msgfrags->iov[niov].iov_len = (ddsrt_iov_len_t) padsize;
+      niov++;
+    }
+  }
+  xp->msgfrags->niov = niov;
+  xp->gso_nsegs++;
+  xp->gso_seg_niov = niov;
+  xp->msg_len.length = 0;
+}
+
 static int ddsi_xpack_mayaddmsg (const struct ddsi_xpack *xp, const struct ddsi_xmsg *m, const uint32_t flags)
 {
   const bool rexmit = xp->includes_rexmit || ddsi_xmsg_is_rexmit (m);
@@ -1437,7 +1753,14 @@ static int ddsi_xpack_mayaddmsg (const struct ddsi_xpack *xp, const struct ddsi_
 
   /* Check if max message size exceeded */
 
-  if (xp->msg_len.length + m->sz + payload_size > max_msg_size)
+  if (xp->msg_len.length + m->sz + payload_size > max_msg_size && !ddsi_xpack_may_add_segment (xp, m))
+  {
+    return 0;
+  }
+
+  /* All segments but the last have the same size, the retransmit limit
+     could make the last one larger */
+  if (xp->gso_nsegs > 0 && ddsi_xmsg_is_rexmit (m))
   {
     return 0;
   }
@@ -1553,6 +1876,25 @@ int ddsi_xpack_addmsg (struct ddsi_xpack *xp, struct ddsi_xmsg *m, const uint32_
     xp->last_src = &xp->hdr.guid_prefix;
     xp->last_dst = NULL;
   }
+  else if (niov == xp->gso_seg_niov)
+  {
+    /* Start of a new segment: a new RTPS message that shares the header
+       with the first, and hence may need an INFO_SRC */
+    xp->msgfrags->iov[niov].iov_base = (void*) &xp->hdr;
+    xp->msgfrags->iov[niov].iov_len = sizeof (xp->hdr);
+    sz = xp->msgfrags->iov[niov].iov_len;
+    niov++;
+    xp->last_src = &xp->hdr.guid_prefix;
+    xp->last_dst = NULL;
+    if (!ddsi_guid_prefix_eq (xp->last_src, &m->data->src.guid_prefix))
+    {
+      xp->msgfrags->iov[niov].iov_base = (void*) &m->data->src;
+      xp->msgfrags->iov[niov].iov_len = sizeof (m->data->src);
+      sz += sizeof (m->data->src);
+      xp->last_src = &m->data->src.guid_prefix;
+      niov++;
+    }
+  }
   else
   {
     xpo_niov = xp->msgfrags->niov;
@@ -1647,8 +1989,17 @@ int ddsi_xpack_addmsg (struct ddsi_xpack *xp, struct ddsi_xmsg *m, const uint32_
              (int) niov, sz, max_msg_size, (int) xpo_niov, xpo_sz);
     xp->msg_len.length = xpo_sz;
     xp->msgfrags->niov = xpo_niov;
-    ddsi_xpack_send (xp, false);
-    result = ddsi_xpack_addmsg (xp, m, flags); /* Retry on emptied xp */
+    if (ddsi_xpack_may_add_segment (xp, m))
+    {
+      GVTRACE (" => new segment\n");
+      ddsi_xpack_add_segment (xp);
+      (void) ddsi_xpack_addmsg (xp, m, flags); /* Retry in new segment */
+    }
+    else
+    {
+      ddsi_xpack_send (xp, false);
+      result = ddsi_xpack_addmsg (xp, m, flags); /* Retry on emptied xp */
+    }
   }
   else
   {
@@ -97,3 +97,24 @@ CU_Test(ddsi_bitset, empty)
   CU_ASSERT_EQ (bits[0], UINT32_C (0xaaaaaaaa));
   CU_ASSERT (!ddsi_bitset_isset (0, bits, 0));
 }
+
+CU_Test(ddsi_bitset, set_clear_range)
+{
+  for (uint32_t from = 0; from <= 96; from++)
+  {
+    for (uint32_t to = from; to <= 96; to++)
+    {
+      uint32_t bits[4] = { 0, 0, 0, UINT32_C (0xaaaaaaaa) };
+      ddsi_bitset_set_range (96, bits, from, to);
+      for (uint32_t i = 0; i < 96; i++)
+        CU_ASSERT_FATAL (!ddsi_bitset_isset (96, bits, i) == !(i >= from && i < to));
+      CU_ASSERT_EQ_FATAL (bits[3], UINT32_C (0xaaaaaaaa));
+
+      ddsi_bitset_one (96, bits);
+      ddsi_bitset_clear_range (96, bits, from, to);
+      for (uint32_t i = 0; i < 96; i++)
+        CU_ASSERT_FATAL (!ddsi_bitset_isset (96, bits, i) == (i >= from && i < to));
+      CU_ASSERT_EQ_FATAL (bits[3], UINT32_C (0xaaaaaaaa));
+    }
+  }
+}
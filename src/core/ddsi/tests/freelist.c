@@ -0,0 +1,180 @@
+// Copyright(c) 2026 ZettaScale Technology and others
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License v. 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License
+// v. 1.0 which is available at
+// http://www.eclipse.org/org/documents/edl-v10.php.
+//
+// SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
+
+#include <stddef.h>
+
+#include "CUnit/Test.h"
+#include "dds/ddsrt/atomics.h"
+#include "dds/ddsrt/heap.h"
+#include "dds/ddsrt/threads.h"
+#include "dds/ddsrt/time.h"
+#include "dds/ddsi/ddsi_freelist.h"
+#include "ddsi__thread.h"
+
+struct elem {
+  struct elem *next;
+  uint32_t id;
+};
+
+#define NELEMS 1000u
+
+static ddsrt_atomic_uint32_t nfreed;
+
+static void free_elem (void *velem)
+{
+  ddsrt_atomic_inc32 (&nfreed);
+  ddsrt_free (velem);
+}
+
+static void push_elems (struct ddsi_freelist *fl, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+  {
+    struct elem *e = ddsrt_malloc (sizeof (*e));
+    e->id = i;
+    if (!ddsi_freelist_push (fl, e))
+      free_elem (e);
+  }
+}
+
+static void setup (void)
+{
+  ddsi_thread_states_init ();
+  ddsrt_atomic_st32 (&nfreed, 0);
+}
+
+static void teardown (void)
+{
+  ddsi_thread_states_fini ();
+}
+
+CU_Test (ddsi_freelist, push_pop, .init = setup, .fini = teardown)
+{
+  struct ddsi_freelist fl;
+  ddsi_freelist_init (&fl, UINT32_MAX, offsetof (struct elem, next));
+  // this thread has a thread state, and so caches elements
+  (void) ddsi_lookup_thread_state ();
+  push_elems (&fl, NELEMS);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), 0);
+  // everything comes back exactly once, whether from the cache or the freelist itself
+  static bool seen[NELEMS];
+  struct elem *e;
+  uint32_t n = 0;
+  while ((e = ddsi_freelist_pop (&fl)) != NULL)
+  {
+    CU_ASSERT_FATAL (e->id < NELEMS && !seen[e->id]);
+    seen[e->id] = true;
+    n++;
+    free_elem (e);
+  }
+  CU_ASSERT_EQ (n, NELEMS);
+  ddsi_freelist_fini (&fl, free_elem);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), NELEMS);
+}
+
+CU_Test (ddsi_freelist, fini_purges_caches, .init = setup, .fini = teardown)
+{
+  // more freelists than cache slots, so that some get evicted from the cache
+  struct ddsi_freelist fls[DDSI_FREELIST_CACHE_NSLOTS + 2];
+  const uint32_t nfl = (uint32_t) (sizeof (fls) / sizeof (fls[0]));
+  (void) ddsi_lookup_thread_state ();
+  for (uint32_t i = 0; i < nfl; i++)
+    ddsi_freelist_init (&fls[i], UINT32_MAX, offsetof (struct elem, next));
+  for (uint32_t i = 0; i < nfl; i++)
+    push_elems (&fls[i], 3);
+  for (uint32_t i = 0; i < nfl; i++)
+    ddsi_freelist_fini (&fls[i], free_elem);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), 3 * nfl);
+}
+
+static uint32_t pusher_thread (void *varg)
+{
+  // lazily creates a thread state, so the elements end up in the cache
+  // until the thread state gets reaped when the thread terminates
+  struct ddsi_freelist *fl = varg;
+  (void) ddsi_lookup_thread_state ();
+  push_elems (fl, 5);
+  return 0;
+}
+
+CU_Test (ddsi_freelist, thread_exit, .init = setup, .fini = teardown)
+{
+  struct ddsi_freelist fl;
+  ddsi_freelist_init (&fl, UINT32_MAX, offsetof (struct elem, next));
+  ddsrt_threadattr_t tattr;
+  ddsrt_threadattr_init (&tattr);
+  ddsrt_thread_t tid;
+  dds_return_t rc = ddsrt_thread_create (&tid, "pusher", &tattr, pusher_thread, &fl);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  rc = ddsrt_thread_join (tid, NULL);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  // the exiting thread returned its cached elements to the freelist, reaped thread
+  // states have no cache attached
+  for (struct ddsi_thread_states_list *cur = ddsrt_atomic_ldvoidp (&thread_states.thread_states_head); cur; cur = cur->next)
+    for (uint32_t i = 0; i < DDSI_THREAD_STATE_BATCH; i++)
+      if (cur->thrst[i].state == DDSI_THREAD_STATE_ZERO)
+        CU_ASSERT_EQ (ddsrt_atomic_ldvoidp (&cur->thrst[i].freelist_cache), NULL);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), 0);
+  ddsi_freelist_fini (&fl, free_elem);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), 5);
+}
+
+struct churn_arg {
+  struct ddsi_freelist *fl_churn, *fl_purge;
+  ddsrt_atomic_uint32_t ready, stop;
+};
+
+static uint32_t churn_thread (void *varg)
+{
+  // leaves some elements of fl_purge in its cache, then keeps using its cache
+  // for fl_churn while fl_purge gets destroyed
+  struct churn_arg *arg = varg;
+  (void) ddsi_lookup_thread_state ();
+  push_elems (arg->fl_purge, 5);
+  push_elems (arg->fl_churn, 10);
+  ddsrt_atomic_st32 (&arg->ready, 1);
+  while (!ddsrt_atomic_ld32 (&arg->stop))
+  {
+    void *es[10];
+    uint32_t n = 0;
+    while (n < 10 && (es[n] = ddsi_freelist_pop (arg->fl_churn)) != NULL)
+      n++;
+    CU_ASSERT_EQ (n, 10);
+    while (n > 0)
+      CU_ASSERT (ddsi_freelist_push (arg->fl_churn, es[--n]));
+  }
+  return 0;
+}
+
+CU_Test (ddsi_freelist, purge_while_in_use, .init = setup, .fini = teardown)
+{
+  struct ddsi_freelist fl_churn, fl_purge;
+  struct churn_arg arg = { .fl_churn = &fl_churn, .fl_purge = &fl_purge };
+  ddsrt_atomic_st32 (&arg.ready, 0);
+  ddsrt_atomic_st32 (&arg.stop, 0);
+  ddsi_freelist_init (&fl_churn, UINT32_MAX, offsetof (struct elem, next));
+  ddsi_freelist_init (&fl_purge, UINT32_MAX, offsetof (struct elem, next));
+  ddsrt_threadattr_t tattr;
+  ddsrt_threadattr_init (&tattr);
+  ddsrt_thread_t tid;
+  dds_return_t rc = ddsrt_thread_create (&tid, "churn", &tattr, churn_thread, &arg);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  while (!ddsrt_atomic_ld32 (&arg.ready))
+    dds_sleepfor (DDS_MSECS (1));
+  // the elements cached by the other thread are freed by the time fini returns
+  ddsi_freelist_fini (&fl_purge, free_elem);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), 5);
+  dds_sleepfor (DDS_MSECS (10));
+  ddsrt_atomic_st32 (&arg.stop, 1);
+  rc = ddsrt_thread_join (tid, NULL);
+  CU_ASSERT_EQ_FATAL (rc, 0);
+  ddsi_freelist_fini (&fl_churn, free_elem);
+  CU_ASSERT_EQ (ddsrt_atomic_ld32 (&nfreed), 15);
+}
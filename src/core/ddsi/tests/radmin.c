@@ -14,7 +14,10 @@
 #include "dds/ddsi/ddsi_iid.h"
 #include "dds/ddsi/ddsi_domaingv.h"
 #include "dds/ddsi/ddsi_init.h"
+#include "dds/ddsrt/threads.h"
+#include "dds/ddsrt/heap.h"
 #include "ddsi__radmin.h"
+#include "ddsi__bitset.h"
 #include "ddsi__thread.h"
 #include "ddsi__misc.h"
 
@@ -159,3 +162,463 @@ CU_Test (ddsi_radmin, drop_gap_at_end, .init = setup, .fini = teardown)
   ddsi_reorder_free (reorder);
   ddsi_defrag_free (defrag);
 }
+
+#define WINDOW_MODEL_SIZE 20000u
+
+struct window_model {
+  bool present[WINDOW_MODEL_SIZE];
+  ddsi_seqno_t next_seq;
+};
+
+static uint32_t window_random (uint32_t *state)
+{
+  // xorshift32, good enough and reproducible
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+static void window_model_add (struct window_model *m, ddsi_seqno_t min, ddsi_seqno_t maxp1)
+{
+  for (ddsi_seqno_t s = min; s < maxp1; s++)
+    m->present[s] = true;
+  while (m->present[m->next_seq])
+    m->next_seq++;
+}
+
+static void window_release_chain (ddsi_reorder_result_t res, struct ddsi_rsample_chain *sc)
+{
+  if (res <= 0)
+    return;
+  while (sc->first)
+  {
+    struct ddsi_rsample_chain_elem *e = sc->first;
+    sc->first = e->next;
+    ddsi_fragchain_unref (e->fragchain);
+  }
+}
+
+static void window_insert (struct ddsi_defrag *defrag, struct ddsi_reorder *reorder, ddsi_seqno_t min, ddsi_seqno_t maxp1, bool gap)
+{
+  struct ddsi_rmsg *rmsg = ddsi_rmsg_new (rbpool);
+  CU_ASSERT_NEQ_FATAL (rmsg, NULL);
+  ddsi_rmsg_setsize (rmsg, 0);
+  struct ddsi_rsample_chain sc;
+  ddsi_reorder_result_t res;
+  int refc_adjust = 0;
+  if (gap)
+  {
+    struct ddsi_rdata *rdata = ddsi_rdata_newgap (rmsg);
+    res = ddsi_reorder_gap (&sc, reorder, rdata, min, maxp1, &refc_adjust);
+    ddsi_fragchain_adjust_refcount (rdata, refc_adjust);
+  }
+  else
+  {
+    struct ddsi_receiver_state *rst = ddsi_rmsg_alloc (rmsg, sizeof (*rst));
+    struct ddsi_rsample_info *si = ddsi_rmsg_alloc (rmsg, sizeof (*si));
+    CU_ASSERT_FATAL (rst != NULL && si != NULL);
+    memset (rst, 0, sizeof (*rst));
+    memset (si, 0, sizeof (*si));
+    si->rst = rst;
+    si->size = 1;
+    si->seq = min;
+    struct ddsi_rdata *rdata = ddsi_rdata_new (rmsg, 0, si->size, 0, 0, 0);
+    struct ddsi_rsample *rsample = ddsi_defrag_rsample (defrag, rdata, si);
+    CU_ASSERT_NEQ_FATAL (rsample, NULL);
+    struct ddsi_rdata *fragchain = ddsi_rsample_fragchain (rsample);
+    res = ddsi_reorder_rsample (&sc, reorder, rsample, &refc_adjust, 0);
+    ddsi_fragchain_adjust_refcount (fragchain, refc_adjust);
+  }
+  window_release_chain (res, &sc);
+  ddsi_rmsg_commit (rmsg);
+}
+
+static enum ddsi_reorder_nackmap_result window_model_nackmap (const struct window_model *m, ddsi_seqno_t base, ddsi_seqno_t maxseq, uint32_t maxsz, bool notail, uint32_t *numbits, bool *bits)
+{
+  // straightforward bit-by-bit reference with the intervals derived from the model
+  *numbits = (maxseq + 1 - base > maxsz) ? maxsz : (uint32_t) (maxseq + 1 - base);
+  if (*numbits == 0)
+    return DDSI_REORDER_NACKMAP_ACK;
+  const ddsi_seqno_t end = base + *numbits;
+  ddsi_seqno_t last_nacked_p1 = 0, i = base, ivmin = m->next_seq + 1;
+  for (uint32_t k = 0; k < *numbits; k++)
+    bits[k] = false;
+  while (i < end)
+  {
+    while (ivmin < WINDOW_MODEL_SIZE && !m->present[ivmin])
+      ivmin++;
+    if (ivmin == WINDOW_MODEL_SIZE)
+      break;
+    for (; i < end && i < ivmin; i++)
+      bits[i - base] = true;
+    last_nacked_p1 = i;
+    while (m->present[ivmin])
+      ivmin++;
+    i = ivmin;
+  }
+  if (!notail)
+  {
+    for (; i < end; i++)
+      bits[i - base] = true;
+    return DDSI_REORDER_NACKMAP_NACK;
+  }
+  else if (last_nacked_p1 == 0)
+  {
+    *numbits = 1;
+    bits[0] = true;
+    return DDSI_REORDER_NACKMAP_NACK;
+  }
+  else
+  {
+    *numbits = (uint32_t) (last_nacked_p1 - base);
+    return DDSI_REORDER_NACKMAP_NACK;
+  }
+}
+
+static void window_check (const struct window_model *m, const struct ddsi_reorder *reorder, uint32_t *rng)
+{
+  CU_ASSERT_EQ_FATAL (ddsi_reorder_next_seq (reorder), m->next_seq);
+  for (ddsi_seqno_t s = m->next_seq; s < m->next_seq + 400; s++)
+    CU_ASSERT_FATAL (!ddsi_reorder_wantsample (reorder, s) == m->present[s]);
+
+  for (int k = 0; k < 4; k++)
+  {
+    const ddsi_seqno_t base = m->next_seq - (window_random (rng) % 2) * (window_random (rng) % m->next_seq);
+    const ddsi_seqno_t maxseq = base - 1 + window_random (rng) % 400;
+    const uint32_t maxsz = 1 + window_random (rng) % 256;
+    const bool notail = (k % 2) != 0;
+    struct ddsi_sequence_number_set_header map;
+    uint32_t mapbits[8];
+    bool refbits[256];
+    uint32_t refnumbits;
+    enum ddsi_reorder_nackmap_result res = ddsi_reorder_nackmap (reorder, base, maxseq, &map, mapbits, maxsz, notail);
+    enum ddsi_reorder_nackmap_result refres = window_model_nackmap (m, base, maxseq, maxsz, notail, &refnumbits, refbits);
+    CU_ASSERT_EQ_FATAL (res, refres);
+    CU_ASSERT_EQ_FATAL (ddsi_from_seqno (map.bitmap_base), base);
+    CU_ASSERT_EQ_FATAL (map.numbits, refnumbits);
+    for (uint32_t i = 0; i < map.numbits; i++)
+      CU_ASSERT_FATAL (!ddsi_bitset_isset (map.numbits, mapbits, i) == !refbits[i]);
+    for (uint32_t i = map.numbits; i < 32 * ((map.numbits + 31) / 32); i++)
+      CU_ASSERT_FATAL (!(mapbits[i / 32] & (UINT32_C (1) << (31 - i % 32))));
+  }
+}
+
+CU_Test (ddsi_radmin, reorder_window, .init = setup, .fini = teardown)
+{
+  struct ddsi_defrag *defrag = ddsi_defrag_new (&gv.logconfig, DDSI_DEFRAG_DROP_LATEST, 1);
+  struct ddsi_reorder *reorder = ddsi_reorder_new (&gv.logconfig, DDSI_REORDER_MODE_NORMAL, WINDOW_MODEL_SIZE, false);
+  struct window_model *m = ddsrt_malloc (sizeof (*m));
+  memset (m, 0, sizeof (*m));
+  m->next_seq = 1;
+  uint32_t rng = 12345;
+  // random loss and reordering of samples and gaps alternating between a range of 400
+  // sequence numbers, so the window of the reorder admin sees all kinds of shifts and
+  // also gets filled from intervals stored beyond it, and a small range, so that the
+  // reorder admin regularly becomes empty
+  while (m->next_seq < WINDOW_MODEL_SIZE - 1000)
+  {
+    const uint32_t range = ((m->next_seq / 1000) % 2) ? 400 : 4;
+    const ddsi_seqno_t min = m->next_seq + (((window_random (&rng) % 4) == 0) ? 0 : window_random (&rng) % range);
+    const bool gap = (window_random (&rng) % 8) == 0;
+    const ddsi_seqno_t maxp1 = min + (gap ? 1 + window_random (&rng) % 5 : 1);
+    window_insert (defrag, reorder, min, maxp1, gap);
+    window_model_add (m, min, maxp1);
+    window_check (m, reorder, &rng);
+  }
+  ddsrt_free (m);
+  ddsi_reorder_free (reorder);
+  ddsi_defrag_free (defrag);
+}
+
+CU_Test (ddsi_radmin, rmsg_new_batch, .init = setup, .fini = teardown)
+{
+  struct ddsi_rmsg *rmsgs[4];
+  const uint32_t n = ddsi_rmsg_new_batch (rbpool, rmsgs, 4);
+  CU_ASSERT_FATAL (n >= 1 && n <= 4);
+
+  // every rmsg in the batch must be able to hold a maximum-size message without
+  // overlapping the next one, so fill the payloads completely
+  for (uint32_t i = 0; i < n; i++)
+  {
+    unsigned char *payload = DDSI_RMSG_PAYLOAD (rmsgs[i]);
+    memset (payload, (int) i + 1, gv.config.rmsg_chunk_size);
+    ddsi_rmsg_setsize (rmsgs[i], gv.config.rmsg_chunk_size);
+  }
+  // allocating additional data in an rmsg of the batch must not overwrite any of
+  // the other messages
+  for (uint32_t i = 0; i < n; i++)
+  {
+    void *p = ddsi_rmsg_alloc (rmsgs[i], 64);
+    CU_ASSERT_NEQ_FATAL (p, NULL);
+    memset (p, 0xff, 64);
+  }
+  for (uint32_t i = 0; i < n; i++)
+  {
+    const unsigned char *payload = DDSI_RMSG_PAYLOAD (rmsgs[i]);
+    uint32_t j;
+    for (j = 0; j < gv.config.rmsg_chunk_size && payload[j] == (unsigned char) (i + 1); j++)
+      ;
+    CU_ASSERT_EQ (j, gv.config.rmsg_chunk_size);
+  }
+  for (uint32_t i = 0; i < n; i++)
+    ddsi_rmsg_commit (rmsgs[i]);
+
+  // after committing the batch, a new one can be allocated
+  const uint32_t m = ddsi_rmsg_new_batch (rbpool, rmsgs, 2);
+  CU_ASSERT_FATAL (m >= 1 && m <= 2);
+  for (uint32_t i = 0; i < m; i++)
+  {
+    ddsi_rmsg_setsize (rmsgs[i], 0);
+    ddsi_rmsg_commit (rmsgs[i]);
+  }
+}
+
+static void hold_rbuf (struct ddsi_rbufpool *rbp, struct ddsi_reorder *reorder, ddsi_seqno_t seq)
+{
+  // a message that uses up most of an rbuf, kept alive by storing a gap in the
+  // reorder buffer, so that the next message requires a new rbuf
+  struct ddsi_rmsg *rmsg = ddsi_rmsg_new (rbp);
+  CU_ASSERT_NEQ_FATAL (rmsg, NULL);
+  ddsi_rmsg_setsize (rmsg, 4096 - 256);
+  insert_gap (reorder, rmsg, seq);
+  ddsi_rmsg_commit (rmsg);
+}
+
+CU_Test (ddsi_radmin, rbufpool_preallocated, .init = setup, .fini = teardown)
+{
+  struct ddsi_rbufpool *rbp = ddsi_rbufpool_new_preallocated (&gv.logconfig, 0, 4096, 65536, false);
+  CU_ASSERT_NEQ_FATAL (rbp, NULL);
+  struct ddsi_rbufpool_stats st;
+  ddsi_rbufpool_get_stats (rbp, &st);
+  CU_ASSERT_FATAL (st.nslots >= 2);
+  CU_ASSERT_EQ (st.inuse, 0);
+
+  // the initial rbuf comes from the heap, then all slots get used before it
+  // overflows to the heap again
+  struct ddsi_reorder *reorder = ddsi_reorder_new (&gv.logconfig, DDSI_REORDER_MODE_NORMAL, 1000, false);
+  ddsi_seqno_t seq = 2;
+  for (uint32_t i = 0; i < st.nslots + 3; i++, seq += 2)
+    hold_rbuf (rbp, reorder, seq);
+  ddsi_rbufpool_get_stats (rbp, &st);
+  CU_ASSERT_EQ (st.inuse, st.nslots);
+  CU_ASSERT_EQ (st.peak_inuse, st.nslots);
+  CU_ASSERT_EQ (st.recycled, 0);
+  CU_ASSERT_EQ (st.overflow, 2);
+
+  // dropping the references returns the slots to the pool
+  ddsi_reorder_free (reorder);
+  ddsi_rbufpool_get_stats (rbp, &st);
+  CU_ASSERT_EQ (st.inuse, 0);
+
+  // and new rbufs then come from the released slots
+  reorder = ddsi_reorder_new (&gv.logconfig, DDSI_REORDER_MODE_NORMAL, 1000, false);
+  for (uint32_t i = 0; i < 3; i++, seq += 2)
+    hold_rbuf (rbp, reorder, seq);
+  ddsi_rbufpool_get_stats (rbp, &st);
+  CU_ASSERT_EQ (st.inuse, 3);
+  CU_ASSERT_EQ (st.recycled, 3);
+  CU_ASSERT_EQ (st.overflow, 2);
+  ddsi_reorder_free (reorder);
+  ddsi_rbufpool_free (rbp);
+}
+
+static struct ddsi_rmsg *new_pinnable_rmsg (struct ddsi_rbufpool *rbp, uint32_t size, uint32_t pinsize, bool expect_pinned)
+{
+  struct ddsi_rmsg *rmsg = ddsi_rmsg_new (rbp);
+  CU_ASSERT_NEQ_FATAL (rmsg, NULL);
+  ddsi_rmsg_setsize (rmsg, size);
+  const bool pinned = ddsi_rmsg_pin (rmsg, pinsize);
+  CU_ASSERT_EQ_FATAL (pinned, expect_pinned);
+  ddsi_rmsg_commit (rmsg);
+  return pinned ? rmsg : NULL;
+}
+
+CU_Test (ddsi_radmin, rmsg_pin_limit, .init = setup, .fini = teardown)
+{
+  // rbufs of 8kB with room for two messages, the limit allows two of them to be
+  // kept alive by pinned messages, regardless of the number of messages in them
+  struct ddsi_rbufpool *rbp = ddsi_rbufpool_new (&gv.logconfig, 8192, 4096);
+  CU_ASSERT_NEQ_FATAL (rbp, NULL);
+  ddsi_rbufpool_set_pin_limits (rbp, 1000, 2 * 8192);
+  (void) new_pinnable_rmsg (rbp, 100, 999, false);
+  struct ddsi_rmsg *a = new_pinnable_rmsg (rbp, 100, 1000, true);
+  struct ddsi_rmsg *b = new_pinnable_rmsg (rbp, 4096, 1000, true);
+  struct ddsi_rmsg *c = new_pinnable_rmsg (rbp, 4096, 1000, true);
+  (void) new_pinnable_rmsg (rbp, 0, 1000, false);
+
+  // the first rbuf remains pinned until both messages in it are unpinned
+  ddsi_rmsg_unpin (a);
+  (void) new_pinnable_rmsg (rbp, 0, 1000, false);
+  ddsi_rmsg_unpin (b);
+  struct ddsi_rmsg *d = new_pinnable_rmsg (rbp, 0, 1000, true);
+  ddsi_rmsg_unpin (c);
+  ddsi_rmsg_unpin (d);
+  ddsi_rbufpool_free (rbp);
+}
+
+#define CONTIG_HDRSIZE 16u
+#define CONTIG_FRAGSIZE 1000u
+#define CONTIG_SIZE 9500u
+
+static struct ddsi_rsample *add_contig_fragment (struct ddsi_defrag *defrag, struct ddsi_rmsg *rmsg, const unsigned char *data, ddsi_seqno_t seq, uint32_t fragnum)
+{
+  const uint32_t min = fragnum * CONTIG_FRAGSIZE;
+  const uint32_t maxp1 = (min + CONTIG_FRAGSIZE < CONTIG_SIZE) ? min + CONTIG_FRAGSIZE : CONTIG_SIZE;
+  // a recognizable "submessage header" followed by the fragment
+  unsigned char *payload = DDSI_RMSG_PAYLOAD (rmsg);
+  memset (payload, (int) fragnum + 1, CONTIG_HDRSIZE);
+  memcpy (payload + CONTIG_HDRSIZE, data + min, maxp1 - min);
+  ddsi_rmsg_setsize (rmsg, CONTIG_HDRSIZE + maxp1 - min);
+  struct ddsi_receiver_state *rst = ddsi_rmsg_alloc (rmsg, sizeof (*rst));
+  CU_ASSERT_NEQ_FATAL (rst, NULL);
+  memset (rst, 0, sizeof (*rst));
+  struct ddsi_rsample_info *si = ddsi_rmsg_alloc (rmsg, sizeof (*si));
+  CU_ASSERT_NEQ_FATAL (si, NULL);
+  memset (si, 0, sizeof (*si));
+  si->rst = rst;
+  si->seq = seq;
+  si->size = CONTIG_SIZE;
+  si->fragsize = CONTIG_FRAGSIZE;
+  struct ddsi_rdata *rdata = ddsi_rdata_new (rmsg, min, maxp1, 0, CONTIG_HDRSIZE, 0);
+  CU_ASSERT_NEQ_FATAL (rdata, NULL);
+  return ddsi_defrag_rsample (defrag, rdata, si);
+}
+
+CU_Test (ddsi_radmin, defrag_contiguous, .init = setup, .fini = teardown)
+{
+  struct ddsi_defrag *defrag = ddsi_defrag_new (&gv.logconfig, DDSI_DEFRAG_DROP_LATEST, 4);
+  ddsi_defrag_set_contiguous_threshold (defrag, CONTIG_SIZE);
+  unsigned char data[CONTIG_SIZE];
+  for (uint32_t i = 0; i < CONTIG_SIZE; i++)
+    data[i] = (unsigned char) (i * 7);
+
+  // out-of-order, with duplicates and a gap that gets filled by a fragment
+  // extending an interval at the head
+  const uint32_t order[] = { 0, 5, 3, 4, 9, 1, 5, 2, 6, 8, 0, 7 };
+  const size_t n = sizeof (order) / sizeof (order[0]);
+  struct ddsi_rsample *rsample = NULL;
+  struct ddsi_rmsg *rmsg = NULL;
+  for (size_t i = 0; i < n; i++)
+  {
+    rmsg = ddsi_rmsg_new (rbpool);
+    CU_ASSERT_NEQ_FATAL (rmsg, NULL);
+    rsample = add_contig_fragment (defrag, rmsg, data, 1, order[i]);
+    if (i + 1 < n)
+    {
+      // nothing may be retained of the fragments that did not complete the
+      // sample: only the uncommitted bias may remain
+      CU_ASSERT_EQ_FATAL (rsample, NULL);
+      CU_ASSERT_EQ_FATAL (ddsrt_atomic_ld32 (&rmsg->refcount), 1u << 31);
+      ddsi_rmsg_commit (rmsg);
+    }
+  }
+  CU_ASSERT_NEQ_FATAL (rsample, NULL);
+
+  // the sample is a single rdata covering all of it in a message of its own, with
+  // the header of the first fragment, followed by the fragment that completed it
+  struct ddsi_rdata *fragchain = ddsi_rsample_fragchain (rsample);
+  CU_ASSERT_EQ_FATAL (fragchain->min, 0);
+  CU_ASSERT_EQ_FATAL (fragchain->maxp1, CONTIG_SIZE);
+  CU_ASSERT_NEQ_FATAL (fragchain->rmsg, rmsg);
+  const unsigned char *hdr = DDSI_RMSG_PAYLOADOFF (fragchain->rmsg, DDSI_RDATA_SUBMSG_OFF (fragchain));
+  CU_ASSERT_EQ_FATAL (DDSI_RDATA_PAYLOAD_OFF (fragchain) - DDSI_RDATA_SUBMSG_OFF (fragchain), CONTIG_HDRSIZE);
+  for (uint32_t i = 0; i < CONTIG_HDRSIZE; i++)
+    CU_ASSERT_EQ_FATAL (hdr[i], 1);
+  CU_ASSERT_EQ_FATAL (memcmp (DDSI_RMSG_PAYLOADOFF (fragchain->rmsg, DDSI_RDATA_PAYLOAD_OFF (fragchain)), data, CONTIG_SIZE), 0);
+  CU_ASSERT_NEQ_FATAL (fragchain->nextfrag, NULL);
+  CU_ASSERT_EQ_FATAL (fragchain->nextfrag->rmsg, rmsg);
+  CU_ASSERT_EQ_FATAL (fragchain->nextfrag->nextfrag, NULL);
+  ddsi_fragchain_adjust_refcount (fragchain, 0);
+  ddsi_rmsg_commit (rmsg);
+
+  // an incomplete one must be released when the defragmenter gets freed
+  rmsg = ddsi_rmsg_new (rbpool);
+  CU_ASSERT_NEQ_FATAL (rmsg, NULL);
+  rsample = add_contig_fragment (defrag, rmsg, data, 2, 0);
+  CU_ASSERT_EQ_FATAL (rsample, NULL);
+  ddsi_rmsg_commit (rmsg);
+
+  // fragments of samples of which the first fragment is not received first are
+  // handled in the usual manner
+  rmsg = ddsi_rmsg_new (rbpool);
+  CU_ASSERT_NEQ_FATAL (rmsg, NULL);
+  rsample = add_contig_fragment (defrag, rmsg, data, 3, 1);
+  CU_ASSERT_EQ_FATAL (rsample, NULL);
+  CU_ASSERT_NEQ_FATAL (ddsrt_atomic_ld32 (&rmsg->refcount), 1u << 31);
+  ddsi_rmsg_commit (rmsg);
+  ddsi_defrag_free (defrag);
+}
+
+#define DQUEUE_PRODUCERS 4
+#define DQUEUE_ITEMS 5000
+
+struct dqueue_item {
+  uint32_t producer;
+  uint32_t seq;
+};
+
+static struct dqueue_item dqueue_items[DQUEUE_PRODUCERS][DQUEUE_ITEMS];
+static uint32_t dqueue_next[DQUEUE_PRODUCERS];
+static uint32_t dqueue_out_of_order;
+
+static void dqueue_check_order (void *varg)
+{
+  // called on the dqueue thread only
+  const struct dqueue_item *item = varg;
+  if (item->seq != dqueue_next[item->producer])
+    dqueue_out_of_order++;
+  dqueue_next[item->producer] = item->seq + 1;
+}
+
+struct dqueue_producer_arg {
+  struct ddsi_dqueue *q;
+  uint32_t id;
+};
+
+static uint32_t dqueue_producer (void *varg)
+{
+  const struct dqueue_producer_arg *arg = varg;
+  struct ddsi_dqueue * const q = arg->q;
+  const uint32_t id = arg->id;
+  for (uint32_t i = 0; i < DQUEUE_ITEMS; i++)
+  {
+    dqueue_items[id][i] = (struct dqueue_item) { .producer = id, .seq = i };
+    ddsi_dqueue_enqueue_callback (q, dqueue_check_order, &dqueue_items[id][i]);
+    // also exercise waiting for the consumer to drain the queue
+    if (i % 1000 == 999)
+      ddsi_dqueue_wait_until_empty_if_full (q);
+  }
+  return 0;
+}
+
+CU_Test (ddsi_radmin, dqueue_multiple_producers, .init = setup, .fini = teardown)
+{
+  struct ddsi_dqueue *q = ddsi_dqueue_new ("test", &gv, 100, NULL, NULL);
+  CU_ASSERT_NEQ_FATAL (q, NULL);
+  CU_ASSERT_FATAL (ddsi_dqueue_start (q));
+  memset (dqueue_next, 0, sizeof (dqueue_next));
+  dqueue_out_of_order = 0;
+
+  ddsrt_thread_t tids[DQUEUE_PRODUCERS];
+  struct dqueue_producer_arg args[DQUEUE_PRODUCERS];
+  ddsrt_threadattr_t tattr;
+  ddsrt_threadattr_init (&tattr);
+  for (uint32_t i = 0; i < DQUEUE_PRODUCERS; i++)
+  {
+    args[i] = (struct dqueue_producer_arg) { .q = q, .id = i };
+    dds_return_t rc = ddsrt_thread_create (&tids[i], "dqprod", &tattr, dqueue_producer, &args[i]);
+    CU_ASSERT_EQ_FATAL (rc, 0);
+  }
+  for (int i = 0; i < DQUEUE_PRODUCERS; i++)
+  {
+    dds_return_t rc = ddsrt_thread_join (tids[i], NULL);
+    CU_ASSERT_EQ_FATAL (rc, 0);
+  }
+
+  // freeing the queue processes everything that is still enqueued
+  ddsi_dqueue_free (q);
+  CU_ASSERT_EQ (dqueue_out_of_order, 0);
+  for (int i = 0; i < DQUEUE_PRODUCERS; i++)
+    CU_ASSERT_EQ (dqueue_next[i], DQUEUE_ITEMS);
+}
@@ -317,7 +317,7 @@ static void receive_packet_init (ddsi_guid_t *rdguid, ddsi_guid_t *wrguid, bool
     assert (ret == DDS_RETCODE_OK);
     (void) ret;
   }
-  ddsi_new_reader (&rd, rdguid, NULL, pp, "Q", st, &ddsi_default_qos_reader, &rhc.c, NULL, NULL, NULL);
+  ddsi_new_reader (&rd, rdguid, NULL, pp, "Q", st, &ddsi_default_qos_reader, &rhc.c, NULL, NULL, NULL, NULL);
   assert (ddsi_entidx_lookup_reader_guid (gv.entity_index, rdguid));
   // reader keeps sertype alive, so we can safely drop a reference here
   // (akin to deleting the topic after creating the reader in the API)
@@ -372,7 +372,7 @@ static void receive_packet_init (ddsi_guid_t *rdguid, ddsi_guid_t *wrguid, bool
     ddsi_add_locator_to_addrset (&gv, wr_as, &loc, gv.xmit_conns_data);
     ddsi_add_locator_to_addrset (&gv, wr_as, &mcloc, gv.xmit_conns_data);
     //int ddsi_new_proxy_writer (struct ddsi_proxy_writer **proxy_writer, struct ddsi_domaingv *gv, const struct ddsi_guid *ppguid, const struct ddsi_guid *guid, struct ddsi_addrset *as, const ddsi_plist_t *plist, struct ddsi_dqueue *dqueue, struct ddsi_xeventq *evq, ddsrt_wctime_t timestamp, ddsi_seqno_t seq)
-    ddsi_new_proxy_writer (&pwr, &gv, &wrppguid, wrguid, wr_as, &plist_wr, gv.user_dqueue, gv.xevents, ddsrt_time_wallclock (), 1);
+    ddsi_new_proxy_writer (&pwr, &gv, &wrppguid, wrguid, wr_as, &plist_wr, gv.user_dqueues[0], gv.xevents, ddsrt_time_wallclock (), 1);
     ddsi_unref_addrset (wr_as);
   }
   ddsi_thread_state_asleep (ddsi_lookup_thread_state ());
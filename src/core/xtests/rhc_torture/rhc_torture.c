@@ -207,6 +207,23 @@ _Pragma("GCC diagnostic pop")
 #endif
 }
 
+static struct dds_rhc *mkrhc_qos (struct ddsi_domaingv *gv, const dds_qos_t *qos, uint32_t nshards, bool xchecks)
+{
+  struct dds_rhc *rhc;
+  dds_qos_t rqos;
+  ddsi_xqos_init_empty (&rqos);
+  ddsi_xqos_mergein_missing (&rqos, qos, ~(uint64_t)0);
+  ddsi_xqos_mergein_missing (&rqos, &ddsi_default_qos_reader, ~(uint64_t)0);
+  ddsi_thread_state_awake (ddsi_lookup_thread_state (), gv);
+  if (nshards > 1)
+    rhc = dds_rhc_sharded_new_xchecks (gv, mdtype, &rqos, nshards, xchecks);
+  else
+    rhc = dds_rhc_default_new_xchecks (gv, mdtype, &rqos, xchecks);
+  ddsi_thread_state_asleep (ddsi_lookup_thread_state ());
+  ddsi_xqos_fini (&rqos);
+  return rhc;
+}
+
 static struct dds_rhc *mkrhc (struct ddsi_domaingv *gv, dds_history_kind_t hk, int32_t hdepth, dds_destination_order_kind_t dok)
 {
   struct dds_rhc *rhc;
@@ -216,10 +233,7 @@ static struct dds_rhc *mkrhc (struct ddsi_domaingv *gv, dds_history_kind_t hk, i
   rqos.history.kind = hk;
   rqos.history.depth = hdepth;
   rqos.destination_order.kind = dok;
-  ddsi_xqos_mergein_missing (&rqos, &ddsi_default_qos_reader, ~(uint64_t)0);
-  ddsi_thread_state_awake_domain_ok (ddsi_lookup_thread_state ());
-  rhc = dds_rhc_default_new_xchecks (gv, mdtype, &rqos, true);
-  ddsi_thread_state_asleep (ddsi_lookup_thread_state ());
+  rhc = mkrhc_qos (gv, &rqos, 1, true);
   ddsi_xqos_fini (&rqos);
   return rhc;
 }
@@ -589,7 +603,7 @@ static struct ddsi_domaingv *get_gv (dds_entity_t e)
   return gv;
 }
 
-static void test_conditions (dds_entity_t pp, dds_entity_t tp, const int count, dds_entity_t (*create_cond) (dds_entity_t reader, uint32_t mask, dds_querycondition_filter_fn filter), dds_querycondition_filter_fn filter0, dds_querycondition_filter_fn filter1, bool print)
+static void test_conditions (dds_entity_t pp, dds_entity_t tp, const int count, dds_entity_t (*create_cond) (dds_entity_t reader, uint32_t mask, dds_querycondition_filter_fn filter), dds_querycondition_filter_fn filter0, dds_querycondition_filter_fn filter1, uint32_t nshards, bool print)
 {
   dds_qos_t *qos = dds_create_qos ();
   dds_qset_history (qos, DDS_HISTORY_KEEP_LAST, MAX_HIST_DEPTH);
@@ -598,8 +612,15 @@ static void test_conditions (dds_entity_t pp, dds_entity_t tp, const int count,
   dds_qset_deadline (qos, rand_deadline());
 #endif
   /* two identical readers because we need 63 conditions while we can currently only attach 32 a single reader */
-  dds_entity_t rd[] = { dds_create_reader (pp, tp, qos, NULL), dds_create_reader (pp, tp, qos, NULL) };
+  dds_entity_t rd[2];
   const size_t nrd = sizeof (rd) / sizeof (rd[0]);
+  for (size_t i = 0; i < nrd; i++)
+  {
+    if (nshards > 1)
+      rd[i] = dds_create_reader_rhc (pp, tp, qos, NULL, mkrhc_qos (get_gv (pp), qos, nshards, true));
+    else
+      rd[i] = dds_create_reader (pp, tp, qos, NULL);
+  }
   dds_delete_qos (qos);
   struct dds_rhc *rhc[sizeof (rd) / sizeof (rd[0])];
   for (size_t i = 0; i < sizeof (rd) / sizeof (rd[0]); i++)
@@ -858,6 +879,9 @@ static void test_conditions (dds_entity_t pp, dds_entity_t tp, const int count,
       }
       case 12: {
 #ifdef DDS_HAS_LIFESPAN
+        /* The shards of a sharded RHC are left to the lifespan events */
+        if (nshards > 1)
+          break;
         ddsi_thread_state_awake_domain_ok (ddsi_lookup_thread_state ());
         /* We can assume that rhc[k] is a dds_rhc_default at this point */
         for (size_t k = 0; k < nrd; k++)
@@ -868,6 +892,9 @@ static void test_conditions (dds_entity_t pp, dds_entity_t tp, const int count,
       }
       case 13: {
 #ifdef DDS_HAS_DEADLINE_MISSED
+        /* The shards of a sharded RHC are left to the deadline events */
+        if (nshards > 1)
+          break;
         ddsi_thread_state_awake_domain_ok (ddsi_lookup_thread_state ());
         /* We can assume that rhc[k] is a dds_rhc_default at this point */
         for (size_t k = 0; k < nrd; k++)
@@ -905,6 +932,242 @@ static void test_conditions (dds_entity_t pp, dds_entity_t tp, const int count,
     fwr (wr[i]);
 }
 
+/* Concurrent producers and consumers: the producers each store "nsamples" samples, spread
+   randomly over MT_N_KEYVALS instances, using their own writer.  The consumers randomly
+   take everything, read the unread samples or take the next instance, until the producers
+   are done and there is nothing left.  Every sample must be taken exactly once, and be
+   returned with sample state NOT_READ at most once. */
+#define MT_N_KEYVALS 1000
+#define MT_MAX_SAMPLES 64
+
+struct mt_shared {
+  struct ddsi_domaingv *gv;
+  struct dds_rhc *rhc;
+  uint32_t nsamples;
+  ddsrt_atomic_uint32_t producers_running;
+  ddsrt_atomic_uint32_t *taken;
+  ddsrt_atomic_uint32_t *notread;
+};
+
+struct mt_producer_arg {
+  struct mt_shared *sh;
+  struct ddsi_proxy_writer *wr;
+  int32_t id;
+  uint32_t seed;
+};
+
+struct mt_consumer_arg {
+  struct mt_shared *sh;
+  uint32_t seed;
+  uint32_t nops;
+  uint32_t ntaken;
+};
+
+static uint32_t mt_producer (void *varg)
+{
+  struct mt_producer_arg * const arg = varg;
+  struct mt_shared * const sh = arg->sh;
+  struct ddsi_thread_state * const thrst = ddsi_lookup_thread_state ();
+  struct ddsi_writer_info wr_info;
+  ddsrt_prng_t rng;
+  ddsrt_prng_init_simple (&rng, arg->seed);
+  wr_info.auto_dispose = false;
+  wr_info.guid = arg->wr->e.guid;
+  wr_info.iid = arg->wr->e.iid;
+  wr_info.ownership_strength = 0;
+#ifdef DDS_HAS_LIFESPAN
+  wr_info.lifespan_exp = DDSRT_MTIME_NEVER;
+#endif
+  for (uint32_t i = 0; i < sh->nsamples; i++)
+  {
+    RhcTypes_T d = { (int32_t) (ddsrt_prng_random (&rng) % MT_N_KEYVALS), "A", arg->id, (int32_t) i, "B" };
+    struct ddsi_serdata *sd;
+    if (ddsi_serdata_from_sample_err (&sd, mdtype, SDK_DATA, &d) != DDS_RETCODE_OK)
+      abort ();
+    sd->timestamp.v = dds_time ();
+    ddsi_thread_state_awake (thrst, sh->gv);
+    struct ddsi_tkmap_instance *tk = ddsi_tkmap_lookup_instance_ref (sh->gv->m_tkmap, sd);
+    dds_rhc_store (sh->rhc, &wr_info, sd, tk);
+    ddsi_tkmap_instance_unref (sh->gv->m_tkmap, tk);
+    ddsi_thread_state_asleep (thrst);
+    ddsi_serdata_unref (sd);
+  }
+  ddsrt_atomic_dec32 (&sh->producers_running);
+  return 0;
+}
+
+static dds_return_t mt_collect (void *varg, const dds_sample_info_t *si, const struct ddsi_sertype *st, struct ddsi_serdata *sd)
+{
+  struct mt_consumer_arg * const arg = varg;
+  (void) st;
+  if (si->valid_data)
+  {
+    RhcTypes_T d;
+    memset (&d, 0, sizeof (d));
+    if (!ddsi_serdata_to_sample (sd, &d, NULL, NULL))
+      abort ();
+    const uint32_t idx = (uint32_t) d.x * arg->sh->nsamples + (uint32_t) d.y;
+    if (si->sample_state == DDS_NOT_READ_SAMPLE_STATE && ddsrt_atomic_inc32_ov (&arg->sh->notread[idx]) != 0)
+    {
+      printf ("sample %"PRId32":%"PRId32" returned as not-read twice\n", d.x, d.y);
+      abort ();
+    }
+    ddsi_sertype_free_sample (sd->type, &d, DDS_FREE_CONTENTS);
+  }
+  return DDS_RETCODE_OK;
+}
+
+static dds_return_t mt_collect_take (void *varg, const dds_sample_info_t *si, const struct ddsi_sertype *st, struct ddsi_serdata *sd)
+{
+  struct mt_consumer_arg * const arg = varg;
+  if (si->valid_data)
+  {
+    RhcTypes_T d;
+    memset (&d, 0, sizeof (d));
+    if (!ddsi_serdata_to_sample (sd, &d, NULL, NULL))
+      abort ();
+    const uint32_t idx = (uint32_t) d.x * arg->sh->nsamples + (uint32_t) d.y;
+    if (ddsrt_atomic_inc32_ov (&arg->sh->taken[idx]) != 0)
+    {
+      printf ("sample %"PRId32":%"PRId32" taken twice\n", d.x, d.y);
+      abort ();
+    }
+    ddsi_sertype_free_sample (sd->type, &d, DDS_FREE_CONTENTS);
+    arg->ntaken++;
+  }
+  return mt_collect (varg, si, st, sd);
+}
+
+static uint32_t mt_consumer (void *varg)
+{
+  struct mt_consumer_arg * const arg = varg;
+  struct mt_shared * const sh = arg->sh;
+  struct ddsi_thread_state * const thrst = ddsi_lookup_thread_state ();
+  const uint32_t any_state = DDS_ANY_SAMPLE_STATE | DDS_ANY_VIEW_STATE | DDS_ANY_INSTANCE_STATE;
+  dds_instance_handle_t next_handle = 0;
+  ddsrt_prng_t rng;
+  ddsrt_prng_init_simple (&rng, arg->seed);
+  for (;;)
+  {
+    const bool producers_done = (ddsrt_atomic_ld32 (&sh->producers_running) == 0);
+    const uint32_t oper = producers_done ? 0 : ddsrt_prng_random (&rng) % 4;
+    int32_t n = 0;
+    ddsi_thread_state_awake (thrst, sh->gv);
+    switch (oper)
+    {
+      case 0: case 1:
+        n = dds_rhc_take (sh->rhc, MT_MAX_SAMPLES, any_state, 0, NULL, mt_collect_take, arg, false);
+        break;
+      case 2:
+        n = dds_rhc_read (sh->rhc, MT_MAX_SAMPLES, DDS_NOT_READ_SAMPLE_STATE | DDS_ANY_VIEW_STATE | DDS_ANY_INSTANCE_STATE, 0, NULL, mt_collect, arg, false);
+        break;
+      case 3: {
+        /* the instance handle isn't returned by the collector, but the instance handles of
+           the samples are all the same, so it suffices to look at the first one */
+        dds_sample_info_t si;
+        struct dds_read_collect_sample_arg rarg;
+        void *ptr = NULL;
+        dds_read_collect_sample_arg_init (&rarg, &ptr, &si, NULL, NULL);
+        if (dds_rhc_peek (sh->rhc, 1, any_state, next_handle, NULL, dds_read_collect_sample_refs, &rarg, true) == 1)
+        {
+          ddsi_serdata_unref (ptr);
+          if ((n = dds_rhc_take (sh->rhc, MT_MAX_SAMPLES, any_state, si.instance_handle, NULL, mt_collect_take, arg, false)) < 0)
+            n = 0; // taken by another consumer in the mean time
+          next_handle = si.instance_handle;
+        }
+        else
+        {
+          next_handle = 0;
+        }
+        break;
+      }
+    }
+    ddsi_thread_state_asleep (thrst);
+    if (n < 0)
+      abort ();
+    arg->nops++;
+    if (producers_done && n == 0)
+      break;
+  }
+  return 0;
+}
+
+static void test_concurrent (struct ddsi_domaingv *gv, uint32_t nsamples, uint32_t nproducers, uint32_t nconsumers, uint32_t nshards, bool xchecks)
+{
+  dds_qos_t rqos;
+  ddsi_xqos_init_empty (&rqos);
+  rqos.present |= DDSI_QP_HISTORY | DDSI_QP_DESTINATION_ORDER;
+  rqos.history.kind = DDS_HISTORY_KEEP_ALL;
+  rqos.history.depth = 1;
+  rqos.destination_order.kind = DDS_DESTINATIONORDER_BY_RECEPTION_TIMESTAMP;
+
+  struct mt_shared sh;
+  sh.gv = gv;
+  sh.rhc = mkrhc_qos (gv, &rqos, nshards, xchecks);
+  sh.nsamples = nsamples;
+  ddsrt_atomic_st32 (&sh.producers_running, nproducers);
+  sh.taken = ddsrt_malloc (nproducers * nsamples * sizeof (*sh.taken));
+  sh.notread = ddsrt_malloc (nproducers * nsamples * sizeof (*sh.notread));
+  for (uint32_t i = 0; i < nproducers * nsamples; i++)
+  {
+    ddsrt_atomic_st32 (&sh.taken[i], 0);
+    ddsrt_atomic_st32 (&sh.notread[i], 0);
+  }
+  ddsi_xqos_fini (&rqos);
+
+  struct mt_producer_arg *parg = ddsrt_malloc (nproducers * sizeof (*parg));
+  struct mt_consumer_arg *carg = ddsrt_malloc (nconsumers * sizeof (*carg));
+  ddsrt_thread_t *tids = ddsrt_malloc ((nproducers + nconsumers) * sizeof (*tids));
+  ddsrt_threadattr_t tattr;
+  ddsrt_threadattr_init (&tattr);
+  const dds_time_t tstart = dds_time ();
+  for (uint32_t i = 0; i < nconsumers; i++)
+  {
+    carg[i] = (struct mt_consumer_arg) { .sh = &sh, .seed = ddsrt_prng_random (&prng), .nops = 0, .ntaken = 0 };
+    if (ddsrt_thread_create (&tids[i], "consumer", &tattr, mt_consumer, &carg[i]) != 0)
+      abort ();
+  }
+  for (uint32_t i = 0; i < nproducers; i++)
+  {
+    parg[i] = (struct mt_producer_arg) { .sh = &sh, .wr = mkwr (0), .id = (int32_t) i, .seed = ddsrt_prng_random (&prng) };
+    if (ddsrt_thread_create (&tids[nconsumers + i], "producer", &tattr, mt_producer, &parg[i]) != 0)
+      abort ();
+  }
+  for (uint32_t i = 0; i < nproducers + nconsumers; i++)
+    (void) ddsrt_thread_join (tids[i], NULL);
+  const dds_time_t tend = dds_time ();
+
+  uint32_t ntaken = 0, nops = 0;
+  for (uint32_t i = 0; i < nconsumers; i++)
+  {
+    ntaken += carg[i].ntaken;
+    nops += carg[i].nops;
+  }
+  for (uint32_t i = 0; i < nproducers * nsamples; i++)
+  {
+    if (ddsrt_atomic_ld32 (&sh.taken[i]) != 1)
+    {
+      printf ("sample %"PRIu32":%"PRIu32" not taken\n", i / nsamples, i % nsamples);
+      abort ();
+    }
+  }
+  struct ddsi_rhc_state st;
+  sh.rhc->common.ops->rhc_ops.get_state (&sh.rhc->common.rhc, &st);
+  if (st.n_vsamples != 0 || st.n_invsamples != 0)
+    abort ();
+  printf ("%"PRIu32" shards: %"PRIu32" producers, %"PRIu32" consumers: %"PRIu32" samples in %.3fs (%.0f/s), %"PRIu32" read/take operations\n",
+          nshards, nproducers, nconsumers, ntaken, (double) (tend - tstart) / 1e9, (double) ntaken * 1e9 / (double) (tend - tstart), nops);
+
+  frhc (sh.rhc);
+  for (uint32_t i = 0; i < nproducers; i++)
+    fwr (parg[i].wr);
+  ddsrt_free (tids);
+  ddsrt_free (carg);
+  ddsrt_free (parg);
+  ddsrt_free (sh.notread);
+  ddsrt_free (sh.taken);
+}
+
 struct stacktracethread_arg {
   ddsrt_mtime_t when;
   dds_duration_t period;
@@ -945,6 +1208,7 @@ int main (int argc, char **argv)
   bool print = false;
   int xchecks = 1;
   int first = 0, count = 10000;
+  uint32_t nshards = 4, nproducers = 4, nconsumers = 2;
   struct stacktracethread_arg sttarg = { 0 };
   ddsrt_thread_t stttid;
   memset (&stttid, 0, sizeof (stttid));
@@ -976,8 +1240,19 @@ int main (int argc, char **argv)
     if (ddsrt_thread_create (&stttid, "stacktracethread", &tattr, stacktracethread, &sttarg) != 0)
       abort ();
   }
+  if (argc > 7)
+    nshards = (uint32_t) atoi (argv[7]);
+  if (argc > 8)
+    nproducers = (uint32_t) atoi (argv[8]);
+  if (argc > 9)
+    nconsumers = (uint32_t) atoi (argv[9]);
+  if (nshards < 1 || nproducers < 1 || nconsumers < 1)
+  {
+    printf ("shards, producers and consumers must be at least 1\n");
+    return 1;
+  }
 
-  printf ("%"PRId64" prng seed %u first %d count %d print %d xchecks %d\n", dds_time (), seed, first, count, print, xchecks);
+  printf ("%"PRId64" prng seed %u first %d count %d print %d xchecks %d shards %"PRIu32" producers %"PRIu32" consumers %"PRIu32"\n", dds_time (), seed, first, count, print, xchecks, nshards, nproducers, nconsumers);
   ddsrt_prng_init_simple (&prng, seed);
 
   if (xchecks != 0)
@@ -1155,13 +1430,23 @@ int main (int argc, char **argv)
       { dds_create_querycondition, qcpred_key, qcpred_attr2 },
       { dds_create_querycondition, qcpred_attr2, qcpred_attr3 }
     };
-    for (int zz = 0; zz < (int) (sizeof (zztab) / sizeof (zztab[0])); zz++)
+    const int nzz = (int) (sizeof (zztab) / sizeof (zztab[0]));
+    /* first with the default RHC, then with a sharded one */
+    for (int zz = 0; zz < 2 * nzz; zz++)
       if (zz + 2 >= first)
       {
         printf ("%"PRId64" ************* %d *************\n", dds_time (), zz + 2);
-        test_conditions (pp, tp, count, zztab[zz].create, zztab[zz].filter0, zztab[zz].filter1, print);
+        test_conditions (pp, tp, count, zztab[zz % nzz].create, zztab[zz % nzz].filter0, zztab[zz % nzz].filter1, (zz < nzz) ? 1 : nshards, print);
       }
   }
+
+  if (8 >= first)
+  {
+    printf ("%"PRId64" ************* 8 *************\n", dds_time ());
+    test_concurrent (get_gv (pp), (uint32_t) count, nproducers, nconsumers, 1, xchecks > 0);
+    if (nshards > 1)
+      test_concurrent (get_gv (pp), (uint32_t) count, nproducers, nconsumers, nshards, xchecks > 0);
+  }
   printf ("%"PRId64" cleaning up\n", dds_time ());
 
   ddsrt_cond_destroy (&wait_gc_cycle_cond);
@@ -62,6 +62,7 @@
 #include "dds/ddsi/ddsi_proxy_participant.h"
 #include "dds/ddsi/ddsi_proxy_endpoint.h"
 #include "dds/ddsi/ddsi_plist.h"
+#include "dds/ddsi/ddsi_content_filter.h"
 #include "dds/ddsi/ddsi_xmsg.h"
 #include "dds/ddsi/ddsi_guid.h"
 #include "dds/ddsi/ddsi_tkmap.h"
@@ -182,6 +183,8 @@ int main (int argc, char **argv)
   dds_get_type_name (1, ptr, 0);
   dds_set_topic_filter_and_arg (1, 0, ptr);
   dds_set_topic_filter_extended (1, ptr);
+  dds_set_topic_filter_members (1, 0, ptr);
+  dds_set_topic_filter_expression (1, ptr, 0, ptr2);
   dds_get_topic_filter_and_arg (1, ptr, ptr);
   dds_get_topic_filter_extended (1, ptr);
   dds_create_subscriber (1, ptr, ptr);
@@ -544,6 +547,9 @@ int main (int argc, char **argv)
   dds_stream_print_sample (ptr, ptr2, ptr3, 0);
 
   dds_stream_extract_key_from_data (ptr, ptr2, ptr3, ptr4);
+  dds_stream_find_member (ptr, 0);
+  dds_stream_find_member_by_index (ptr, 0, ptr2, ptr3);
+  dds_stream_extract_members (ptr, ptr2, 0, ptr3, ptr4);
   dds_stream_extract_key_from_key (ptr, ptr2, 0, ptr3, ptr4);
   dds_stream_extract_keyBE_from_data (ptr, ptr2, ptr3, ptr4);
   dds_stream_extract_keyBE_from_key (ptr, ptr2, 0, ptr3, ptr4);
@@ -810,6 +816,10 @@ int main (int argc, char **argv)
   ddsi_plist_init_empty (ptr);
   ddsi_plist_fini (ptr);
 
+  // ddsi/ddsi_content_filter.h
+  ddsi_content_filter_property_dup (ptr);
+  ddsi_content_filter_property_free (ptr);
+
   // ddsi/ddsi_xqos.h
   ddsi_xqos_delta (ptr, ptr2, 0);
 
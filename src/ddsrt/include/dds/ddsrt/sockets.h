@@ -244,6 +244,33 @@ ddsrt_sendmsg(
   size_t *sent)
 ddsrt_nonnull ((2));
 
+#if DDSRT_HAVE_MMSG
+/**
+ * @brief Send multiple messages in a single call
+ *
+ * - Behaves like @ref ddsrt_sendmsg for each element of 'msgs', but stops at the first
+ *   message that could not be sent. Only available if DDSRT_HAVE_MMSG is true.
+ *
+ * @param[in] sock the socket
+ * @param[in,out] msgs array of messages, on return msg_len gives the number of bytes sent
+ * @param[in] vlen number of entries in 'msgs'
+ * @param[in] flags flags for special options
+ * @param[out] nsent number of messages sent (> 0 if return == OK, undefined if return != OK)
+ * @return a DDS_RETCODE (OK, ERROR, and more), an error is only returned if the first
+ *   message could not be sent
+ *
+ * See @ref ddsrt_sendmsg
+ */
+dds_return_t
+ddsrt_sendmmsg(
+  ddsrt_socket_t sock,
+  ddsrt_mmsghdr_t *msgs,
+  size_t vlen,
+  int flags,
+  size_t *nsent)
+ddsrt_nonnull_all;
+#endif
+
 /**
  * @brief Receive data into a buffer
  *
@@ -296,6 +323,34 @@ ddsrt_recvmsg(
   size_t *rcvd)
 ddsrt_attribute_warn_unused_result ddsrt_nonnull_all;
 
+#if DDSRT_HAVE_MMSG
+/**
+ * @brief Receive multiple messages in a single call
+ *
+ * - Behaves like @ref ddsrt_recvmsg for each element of 'msgs', but stops as soon as
+ *   an element could not be filled. Only available if DDSRT_HAVE_MMSG is true.
+ * - The 'flags' are as for @ref ddsrt_recvmsg, with the addition of MSG_WAITFORONE
+ *   where supported (only block waiting for the first message).
+ *
+ * @param[in] sockext the socket
+ * @param[in,out] msgs array of messages, on return msg_len gives the number of bytes received
+ * @param[in] vlen number of entries in 'msgs'
+ * @param[in] flags flags for special options
+ * @param[out] nrcvd number of messages received (> 0 if return == OK, undefined if return != OK)
+ * @return a DDS_RETCODE (OK, ERROR, TRY_AGAIN, BAD_PARAMETER, NO_CONNECTION, INTERRUPTED, OUT_OF_RESOURCES, ILLEGAL_OPERATION)
+ *
+ * See @ref ddsrt_recvmsg
+ */
+dds_return_t
+ddsrt_recvmmsg(
+  const ddsrt_socket_ext_t *sockext,
+  ddsrt_mmsghdr_t *msgs,
+  size_t vlen,
+  int flags,
+  size_t *nrcvd)
+ddsrt_attribute_warn_unused_result ddsrt_nonnull_all;
+#endif
+
 /**
  * @brief Get options from the socket.
  *
@@ -97,6 +97,23 @@ typedef struct msghdr ddsrt_msghdr_t;
 # define DDSRT_MSGHDR_FLAGS 1
 #endif
 
+/* recvmmsg/sendmmsg are only used where the kernel provides them natively,
+   emulating them in a loop would only hide the cost of the extra syscalls */
+#if defined(__linux__) && !LWIP_SOCKET
+# define DDSRT_HAVE_MMSG 1
+#else
+# define DDSRT_HAVE_MMSG 0
+#endif
+
+#if DDSRT_HAVE_MMSG
+/* Layout-compatible with Linux' struct mmsghdr, which is only defined
+   by the system headers if _GNU_SOURCE is defined */
+typedef struct ddsrt_mmsghdr {
+  ddsrt_msghdr_t msg_hdr;
+  unsigned int msg_len;
+} ddsrt_mmsghdr_t;
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
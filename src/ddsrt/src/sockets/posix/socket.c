@@ -8,7 +8,13 @@
 //
 // SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // for recvmmsg, sendmmsg
+#endif
+
 #include <assert.h>
+#include <limits.h>
+#include <stddef.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -487,6 +493,32 @@ ddsrt_recvmsg(
   return recv_error_to_retcode(errno);
 }
 
+#if DDSRT_HAVE_MMSG
+DDSRT_STATIC_ASSERT (sizeof (ddsrt_mmsghdr_t) == sizeof (struct mmsghdr) &&
+                     offsetof (ddsrt_mmsghdr_t, msg_len) == offsetof (struct mmsghdr, msg_len));
+
+dds_return_t
+ddsrt_recvmmsg(
+  const ddsrt_socket_ext_t *sockext,
+  ddsrt_mmsghdr_t *msgs,
+  size_t vlen,
+  int flags,
+  size_t *nrcvd)
+{
+  int n;
+
+  assert(vlen > 0 && vlen <= UINT_MAX);
+  if ((n = recvmmsg(sockext->sock, (struct mmsghdr *) msgs, (unsigned) vlen, flags, NULL)) != -1) {
+    assert(n > 0);
+    *nrcvd = (size_t) n;
+    return DDS_RETCODE_OK;
+  }
+
+  *nrcvd = 0;
+  return recv_error_to_retcode(errno);
+}
+#endif
+
 static inline dds_return_t
 send_error_to_retcode(int errnum)
 {
@@ -570,6 +602,29 @@ ddsrt_sendmsg(
   return send_error_to_retcode(errno);
 }
 
+#if DDSRT_HAVE_MMSG
+dds_return_t
+ddsrt_sendmmsg(
+  ddsrt_socket_t sock,
+  ddsrt_mmsghdr_t *msgs,
+  size_t vlen,
+  int flags,
+  size_t *nsent)
+{
+  int n;
+
+  assert(vlen > 0 && vlen <= UINT_MAX);
+  if ((n = sendmmsg(sock, (struct mmsghdr *) msgs, (unsigned) vlen, flags)) != -1) {
+    assert(n > 0);
+    *nsent = (size_t) n;
+    return DDS_RETCODE_OK;
+  }
+
+  *nsent = 0;
+  return send_error_to_retcode(errno);
+}
+#endif
+
 dds_return_t
 ddsrt_select(
   int32_t nfds,
@@ -52,6 +52,7 @@ void gendef_pf_entity_naming_mode (FILE *fp, void *parent, struct cfgelem const
 void gendef_pf_random_seed (FILE *fp, void *parent, struct cfgelem const * const cfgelem);
 void gendef_pf_transport_selector (FILE *fp, void *parent, struct cfgelem const * const cfgelem);
 void gendef_pf_many_sockets_mode (FILE *fp, void *parent, struct cfgelem const * const cfgelem);
+void gendef_pf_socket_timestamps (FILE *fp, void *parent, struct cfgelem const * const cfgelem);
 void gendef_pf_standards_conformance (FILE *fp, void *parent, struct cfgelem const * const cfgelem);
 void gendef_pf_shm_loglevel (FILE *fp, void *parent, struct cfgelem const * const cfgelem);
 void gendef_pf_uint32_array (FILE *out, void *parent, struct cfgelem const * const cfgelem);
@@ -194,6 +194,9 @@ void gendef_pf_transport_selector (FILE *out, void *parent, struct cfgelem const
 void gendef_pf_many_sockets_mode (FILE *out, void *parent, struct cfgelem const * const cfgelem) {
   gendef_pf_int (out, parent, cfgelem);
 }
+void gendef_pf_socket_timestamps (FILE *out, void *parent, struct cfgelem const * const cfgelem) {
+  gendef_pf_int (out, parent, cfgelem);
+}
 void gendef_pf_standards_conformance (FILE *out, void *parent, struct cfgelem const * const cfgelem) {
   gendef_pf_int (out, parent, cfgelem);
 }